@@ -81,6 +81,7 @@ STRING (REGEX MATCH "GV_EXE" _matchExe "${GV_TARGET_TYPE}")
 STRING (REGEX MATCH "GV_CUDA_EXE" _matchCudaExe "${GV_TARGET_TYPE}")
 STRING (REGEX MATCH "GV_SHARED_LIB" _matchSharedLib "${GV_TARGET_TYPE}")
 STRING (REGEX MATCH "GV_CUDA_SHARED_LIB" _matchCudaSharedLib "${GV_TARGET_TYPE}")
+STRING (REGEX MATCH "GV_STATIC_LIB" _matchStaticLib "${GV_TARGET_TYPE}")
 
 if (_matchExe)
 	ADD_EXECUTABLE (${PROJECT_NAME} ${srcList} ${genList} ${resList})
@@ -100,6 +101,10 @@ if (_matchCudaSharedLib)
 	CUDA_ADD_LIBRARY (${PROJECT_NAME} SHARED ${srcList} ${genList} ${resList})
 endif (_matchCudaSharedLib)
 
+if (_matchStaticLib)
+	ADD_LIBRARY (${PROJECT_NAME} STATIC ${srcList} ${genList} ${resList})
+endif (_matchStaticLib)
+
 SET_TARGET_PROPERTIES (${PROJECT_NAME} PROPERTIES DEBUG_POSTFIX ".d")
 
 foreach (it ${projectLibList})
@@ -298,8 +303,13 @@ IF(_matchSharedLib)
 ENDIF(_matchSharedLib)
 
 IF(_matchStaticLib)
-    #FILE( MAKE_DIRECTORY ${RELEASE_DIR_LIB})
-    POST_BUILD_COPY( ${LIBRARY_PATH}/lib${PROJECT_NAME}.* ${RELEASE_BIN_DIR} )
+	if ( RELEASE_LIB_DIR )
+		# Static libraries are only needed to link executables
+		file( MAKE_DIRECTORY (${RELEASE_LIB_DIR}) )
+		POST_BUILD_COPY( ${LIBRARY_PATH}/lib${PROJECT_NAME}.* ${RELEASE_LIB_DIR} )
+	else ()
+		POST_BUILD_COPY( ${LIBRARY_PATH}/lib${PROJECT_NAME}.* ${RELEASE_BIN_DIR} )
+	endif ()
 ENDIF(_matchStaticLib)
 
 #ENDIF(NOT _matchExe AND RELEASE_DIR_LIB)
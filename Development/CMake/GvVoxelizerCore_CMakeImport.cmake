@@ -0,0 +1,41 @@
+#----------------------------------------------------------------
+# Import library
+#----------------------------------------------------------------
+	 
+MESSAGE (STATUS "IMPORT : GvVoxelizerCore library")
+
+#----------------------------------------------------------------
+# SET library PATH
+#----------------------------------------------------------------
+
+#----------------------------------------------------------------
+# Add INCLUDE library directories
+#----------------------------------------------------------------
+
+INCLUDE_DIRECTORIES (${GV_RELEASE}/Tools/GigaVoxelsVoxelizer/Inc)
+
+#----------------------------------------------------------------
+# Add LINK library directories
+#----------------------------------------------------------------
+
+LINK_DIRECTORIES (${GV_RELEASE}/Tools/GigaVoxelsVoxelizer/Lib)
+
+#----------------------------------------------------------------
+# Set LINK libraries if not defined by user
+#----------------------------------------------------------------
+
+IF ( "${gvvoxelizerLib}" STREQUAL "" )
+	SET (gvvoxelizerLib "GvVoxelizerCore")
+ENDIF ()
+
+#----------------------------------------------------------------
+# Add LINK libraries
+#----------------------------------------------------------------
+		
+FOREACH (it ${gvvoxelizerLib})
+	IF (WIN32)
+		LINK_LIBRARIES (optimized ${it} debug ${it}.d)
+	ELSE ()
+		LINK_LIBRARIES (optimized ${it} debug ${it}.d)
+	ENDIF ()
+ENDFOREACH (it)
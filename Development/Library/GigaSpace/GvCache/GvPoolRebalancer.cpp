@@ -0,0 +1,355 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvCache/GvPoolRebalancer.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvCache;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvPoolRebalancer::GvPoolRebalancer()
+:	_nodePoolMemorySize( 0 )
+,	_brickPoolMemorySize( 0 )
+,	_historySize( 120 )
+,	_minPoolRatio( 0.01f )
+,	_safetyMargin( 0.2f )
+,	_hysteresis( 0.1f )
+,	_history()
+,	_nextFrame( 0 )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvPoolRebalancer::~GvPoolRebalancer()
+{
+}
+
+/******************************************************************************
+ * Set the current memory size of the pools.
+ * The memory budget is their sum. It also resets the history.
+ *
+ * @param pNodePoolMemorySize node pool memory size (in bytes)
+ * @param pBrickPoolMemorySize brick pool memory size (in bytes)
+ ******************************************************************************/
+void GvPoolRebalancer::setPoolMemorySizes( size_t pNodePoolMemorySize, size_t pBrickPoolMemorySize )
+{
+	_nodePoolMemorySize = pNodePoolMemorySize;
+	_brickPoolMemorySize = pBrickPoolMemorySize;
+
+	reset();
+}
+
+/******************************************************************************
+ * Get the current node pool memory size
+ *
+ * @return the node pool memory size (in bytes)
+ ******************************************************************************/
+size_t GvPoolRebalancer::getNodePoolMemorySize() const
+{
+	return _nodePoolMemorySize;
+}
+
+/******************************************************************************
+ * Get the current brick pool memory size
+ *
+ * @return the brick pool memory size (in bytes)
+ ******************************************************************************/
+size_t GvPoolRebalancer::getBrickPoolMemorySize() const
+{
+	return _brickPoolMemorySize;
+}
+
+/******************************************************************************
+ * Get the memory budget shared by the pools
+ *
+ * @return the memory budget (in bytes)
+ ******************************************************************************/
+size_t GvPoolRebalancer::getMemoryBudget() const
+{
+	return _nodePoolMemorySize + _brickPoolMemorySize;
+}
+
+/******************************************************************************
+ * Set the number of frames of the sliding window
+ *
+ * @param pValue the number of frames
+ ******************************************************************************/
+void GvPoolRebalancer::setHistorySize( unsigned int pValue )
+{
+	_historySize = std::max( pValue, 1U );
+
+	reset();
+}
+
+/******************************************************************************
+ * Get the number of frames of the sliding window
+ *
+ * @return the number of frames
+ ******************************************************************************/
+unsigned int GvPoolRebalancer::getHistorySize() const
+{
+	return _historySize;
+}
+
+/******************************************************************************
+ * Set the minimum share of the budget kept by each pool
+ *
+ * @param pValue the minimum share in [ 0.0 ; 0.5 ]
+ ******************************************************************************/
+void GvPoolRebalancer::setMinPoolRatio( float pValue )
+{
+	_minPoolRatio = std::min( std::max( pValue, 0.0f ), 0.5f );
+}
+
+/******************************************************************************
+ * Get the minimum share of the budget kept by each pool
+ *
+ * @return the minimum share
+ ******************************************************************************/
+float GvPoolRebalancer::getMinPoolRatio() const
+{
+	return _minPoolRatio;
+}
+
+/******************************************************************************
+ * Set the safety margin added to the working sets
+ *
+ * @param pValue the safety margin (i.e. 0.2 for 20%)
+ ******************************************************************************/
+void GvPoolRebalancer::setSafetyMargin( float pValue )
+{
+	_safetyMargin = std::max( pValue, 0.0f );
+}
+
+/******************************************************************************
+ * Get the safety margin added to the working sets
+ *
+ * @return the safety margin
+ ******************************************************************************/
+float GvPoolRebalancer::getSafetyMargin() const
+{
+	return _safetyMargin;
+}
+
+/******************************************************************************
+ * Set the minimum relative change of the smallest pool for a new split to be recommended
+ *
+ * @param pValue the hysteresis in [ 0.0 ; 1.0 ]
+ ******************************************************************************/
+void GvPoolRebalancer::setHysteresis( float pValue )
+{
+	_hysteresis = std::min( std::max( pValue, 0.0f ), 1.0f );
+}
+
+/******************************************************************************
+ * Get the minimum relative change of the smallest pool for a new split to be recommended
+ *
+ * @return the hysteresis
+ ******************************************************************************/
+float GvPoolRebalancer::getHysteresis() const
+{
+	return _hysteresis;
+}
+
+/******************************************************************************
+ * Clear the history of frames
+ ******************************************************************************/
+void GvPoolRebalancer::reset()
+{
+	_history.clear();
+	_nextFrame = 0;
+}
+
+/******************************************************************************
+ * Add the cache statistics of a frame
+ *
+ * @param pStatistics the cache statistics
+ ******************************************************************************/
+void GvPoolRebalancer::addFrame( const FrameStatistics& pStatistics )
+{
+	if ( _history.size() < _historySize )
+	{
+		_history.push_back( pStatistics );
+	}
+	else
+	{
+		_history[ _nextFrame ] = pStatistics;
+	}
+	_nextFrame = ( _nextFrame + 1 ) % _historySize;
+}
+
+/******************************************************************************
+ * Get the number of frames in the history
+ *
+ * @return the number of frames
+ ******************************************************************************/
+unsigned int GvPoolRebalancer::getNbFrames() const
+{
+	return static_cast< unsigned int >( _history.size() );
+}
+
+/******************************************************************************
+ * Get the estimated demand of the node cache (working set, safety margin included)
+ *
+ * @return the number of nodes
+ ******************************************************************************/
+double GvPoolRebalancer::getNodeDemand() const
+{
+	return computeDemand( true );
+}
+
+/******************************************************************************
+ * Get the estimated demand of the brick cache (working set, safety margin included)
+ *
+ * @return the number of bricks
+ ******************************************************************************/
+double GvPoolRebalancer::getBrickDemand() const
+{
+	return computeDemand( false );
+}
+
+/******************************************************************************
+ * Estimate the demand of a cache over the history
+ *
+ * @param pIsNodeCache a flag telling wheter to use the node or the brick cache
+ *
+ * @return the demand (in number of elements)
+ ******************************************************************************/
+double GvPoolRebalancer::computeDemand( bool pIsNodeCache ) const
+{
+	unsigned int capacity = 0;
+	unsigned int workingSet = 0;
+	unsigned int nbOverflows = 0;
+	for ( size_t i = 0; i < _history.size(); i++ )
+	{
+		const FrameStatistics& frame = _history[ i ];
+		const unsigned int frameCapacity = pIsNodeCache ? frame._nodeCapacity : frame._brickCapacity;
+		const unsigned int frameNbUnused = pIsNodeCache ? frame._nbUnusedNodes : frame._nbUnusedBricks;
+		const bool hasExceededCapacity = pIsNodeCache ? frame._hasNodeCacheExceededCapacity : frame._hasBrickCacheExceededCapacity;
+
+		capacity = std::max( capacity, frameCapacity );
+		workingSet = std::max( workingSet, frameCapacity - std::min( frameNbUnused, frameCapacity ) );
+		if ( hasExceededCapacity )
+		{
+			nbOverflows++;
+		}
+	}
+
+	// Peak working set
+	double demand = static_cast< double >( workingSet ) * ( 1.0 + _safetyMargin );
+
+	// When the cache has overflowed, requests have been dropped : the real demand is above the capacity
+	if ( nbOverflows > 0 )
+	{
+		const double overflowRatio = static_cast< double >( nbOverflows ) / static_cast< double >( _history.size() );
+		demand = std::max( demand, static_cast< double >( capacity ) * ( 1.0 + _safetyMargin + overflowRatio ) );
+	}
+
+	return demand;
+}
+
+/******************************************************************************
+ * Compute the node/brick split of the memory budget that fits the estimated demands
+ *
+ * @param pNodePoolMemorySize the recommended node pool memory size (in bytes)
+ * @param pBrickPoolMemorySize the recommended brick pool memory size (in bytes)
+ *
+ * @return a flag telling wheter or not the new split should be applied
+ * (enough frames, demand known, and split different enough from the current one)
+ ******************************************************************************/
+bool GvPoolRebalancer::computeRecommendation( size_t& pNodePoolMemorySize, size_t& pBrickPoolMemorySize ) const
+{
+	pNodePoolMemorySize = _nodePoolMemorySize;
+	pBrickPoolMemorySize = _brickPoolMemorySize;
+
+	// Wait for a full window
+	if ( _history.empty() || _history.size() < _historySize )
+	{
+		return false;
+	}
+
+	// Memory cost of one element, deduced from the current pools
+	const FrameStatistics& lastFrame = _history[ ( _nextFrame + _historySize - 1 ) % _historySize ];
+	if ( lastFrame._nodeCapacity == 0 || lastFrame._brickCapacity == 0 )
+	{
+		return false;
+	}
+	const double nodeSize = static_cast< double >( _nodePoolMemorySize ) / static_cast< double >( lastFrame._nodeCapacity );
+	const double brickSize = static_cast< double >( _brickPoolMemorySize ) / static_cast< double >( lastFrame._brickCapacity );
+
+	// Demand of each pool (in bytes)
+	const double nodeDemand = computeDemand( true ) * nodeSize;
+	const double brickDemand = computeDemand( false ) * brickSize;
+	if ( nodeDemand + brickDemand <= 0.0 )
+	{
+		return false;
+	}
+
+	// Split the budget proportionally to the demands :
+	// - if both demands fit, the remaining memory is shared in the same proportions,
+	// - otherwise, both pools are short of memory in the same proportions.
+	const double budget = static_cast< double >( getMemoryBudget() );
+	const double minPoolMemorySize = budget * static_cast< double >( _minPoolRatio );
+	double nodePoolMemorySize = budget * nodeDemand / ( nodeDemand + brickDemand );
+	nodePoolMemorySize = std::min( std::max( nodePoolMemorySize, minPoolMemorySize ), budget - minPoolMemorySize );
+
+	pNodePoolMemorySize = static_cast< size_t >( nodePoolMemorySize );
+	pBrickPoolMemorySize = getMemoryBudget() - pNodePoolMemorySize;
+
+	// Hysteresis (relative to the smallest pool, which is the most affected by the move)
+	const double movedMemorySize = std::abs( nodePoolMemorySize - static_cast< double >( _nodePoolMemorySize ) );
+	const double smallestPoolMemorySize = static_cast< double >( std::min( _nodePoolMemorySize, _brickPoolMemorySize ) );
+
+	return ( movedMemorySize > 0.0 && movedMemorySize >= smallestPoolMemorySize * static_cast< double >( _hysteresis ) );
+}
@@ -0,0 +1,367 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_POOL_REBALANCER_H_
+#define _GV_POOL_REBALANCER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+
+// STL
+#include <cstddef>
+#include <vector>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvCache
+{
+
+/** 
+ * @class GvPoolRebalancer
+ *
+ * @brief The GvPoolRebalancer class estimates the working set of the node and brick
+ * caches and recommends a new node/brick split of a fixed memory budget.
+ *
+ * @ingroup GvCache
+ *
+ * Each frame, the user gives the capacity and the number of unused elements of both
+ * caches, and wheter or not they have exceeded their capacity. Over a sliding window
+ * of frames, the working set of a cache is its peak number of used elements.
+ * When a cache has exceeded its capacity, its real demand is unknown (requests have been
+ * dropped), so its demand is extrapolated from its capacity and the fraction of frames
+ * where it overflowed.
+ *
+ * The memory budget is then split proportionally to the demand of each pool (in bytes),
+ * with a minimum share per pool. A new split is only recommended when the window
+ * is full and when it changes the smallest pool enough (hysteresis), to avoid oscillations.
+ * The memory cost of one element is deduced from the pool memory sizes and capacities.
+ *
+ * This class only uses host data, it has no dependency on the device.
+ */
+class GIGASPACE_EXPORT GvPoolRebalancer
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Cache statistics of one frame
+	 */
+	struct FrameStatistics
+	{
+		/**
+		 * Number of elements of the node cache
+		 */
+		unsigned int _nodeCapacity;
+
+		/**
+		 * Number of elements of the brick cache
+		 */
+		unsigned int _brickCapacity;
+
+		/**
+		 * Number of unused nodes in the node cache
+		 */
+		unsigned int _nbUnusedNodes;
+
+		/**
+		 * Number of unused bricks in the brick cache
+		 */
+		unsigned int _nbUnusedBricks;
+
+		/**
+		 * Flag telling wheter or not the node cache has exceeded its capacity
+		 */
+		bool _hasNodeCacheExceededCapacity;
+
+		/**
+		 * Flag telling wheter or not the brick cache has exceeded its capacity
+		 */
+		bool _hasBrickCacheExceededCapacity;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvPoolRebalancer();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvPoolRebalancer();
+
+	/**
+	 * Set the current memory size of the pools.
+	 * The memory budget is their sum. It also resets the history.
+	 *
+	 * @param pNodePoolMemorySize node pool memory size (in bytes)
+	 * @param pBrickPoolMemorySize brick pool memory size (in bytes)
+	 */
+	void setPoolMemorySizes( size_t pNodePoolMemorySize, size_t pBrickPoolMemorySize );
+
+	/**
+	 * Get the current node pool memory size
+	 *
+	 * @return the node pool memory size (in bytes)
+	 */
+	size_t getNodePoolMemorySize() const;
+
+	/**
+	 * Get the current brick pool memory size
+	 *
+	 * @return the brick pool memory size (in bytes)
+	 */
+	size_t getBrickPoolMemorySize() const;
+
+	/**
+	 * Get the memory budget shared by the pools
+	 *
+	 * @return the memory budget (in bytes)
+	 */
+	size_t getMemoryBudget() const;
+
+	/**
+	 * Set the number of frames of the sliding window
+	 *
+	 * @param pValue the number of frames
+	 */
+	void setHistorySize( unsigned int pValue );
+
+	/**
+	 * Get the number of frames of the sliding window
+	 *
+	 * @return the number of frames
+	 */
+	unsigned int getHistorySize() const;
+
+	/**
+	 * Set the minimum share of the budget kept by each pool
+	 *
+	 * @param pValue the minimum share in [ 0.0 ; 0.5 ]
+	 */
+	void setMinPoolRatio( float pValue );
+
+	/**
+	 * Get the minimum share of the budget kept by each pool
+	 *
+	 * @return the minimum share
+	 */
+	float getMinPoolRatio() const;
+
+	/**
+	 * Set the safety margin added to the working sets
+	 *
+	 * @param pValue the safety margin (i.e. 0.2 for 20%)
+	 */
+	void setSafetyMargin( float pValue );
+
+	/**
+	 * Get the safety margin added to the working sets
+	 *
+	 * @return the safety margin
+	 */
+	float getSafetyMargin() const;
+
+	/**
+	 * Set the minimum relative change of the smallest pool for a new split to be recommended
+	 *
+	 * @param pValue the hysteresis in [ 0.0 ; 1.0 ]
+	 */
+	void setHysteresis( float pValue );
+
+	/**
+	 * Get the minimum relative change of the smallest pool for a new split to be recommended
+	 *
+	 * @return the hysteresis
+	 */
+	float getHysteresis() const;
+
+	/**
+	 * Clear the history of frames
+	 */
+	void reset();
+
+	/**
+	 * Add the cache statistics of a frame
+	 *
+	 * @param pStatistics the cache statistics
+	 */
+	void addFrame( const FrameStatistics& pStatistics );
+
+	/**
+	 * Get the number of frames in the history
+	 *
+	 * @return the number of frames
+	 */
+	unsigned int getNbFrames() const;
+
+	/**
+	 * Get the estimated demand of the node cache (working set, safety margin included)
+	 *
+	 * @return the number of nodes
+	 */
+	double getNodeDemand() const;
+
+	/**
+	 * Get the estimated demand of the brick cache (working set, safety margin included)
+	 *
+	 * @return the number of bricks
+	 */
+	double getBrickDemand() const;
+
+	/**
+	 * Compute the node/brick split of the memory budget that fits the estimated demands
+	 *
+	 * @param pNodePoolMemorySize the recommended node pool memory size (in bytes)
+	 * @param pBrickPoolMemorySize the recommended brick pool memory size (in bytes)
+	 *
+	 * @return a flag telling wheter or not the new split should be applied
+	 * (enough frames, demand known, and split different enough from the current one)
+	 */
+	bool computeRecommendation( size_t& pNodePoolMemorySize, size_t& pBrickPoolMemorySize ) const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Node pool memory size (in bytes)
+	 */
+	size_t _nodePoolMemorySize;
+
+	/**
+	 * Brick pool memory size (in bytes)
+	 */
+	size_t _brickPoolMemorySize;
+
+	/**
+	 * Number of frames of the sliding window
+	 */
+	unsigned int _historySize;
+
+	/**
+	 * Minimum share of the budget kept by each pool
+	 */
+	float _minPoolRatio;
+
+	/**
+	 * Safety margin added to the working sets
+	 */
+	float _safetyMargin;
+
+	/**
+	 * Minimum relative change of the smallest pool for a new split to be recommended
+	 */
+	float _hysteresis;
+
+	/**
+	 * History of frames (circular buffer)
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< FrameStatistics > _history;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Index of the next frame to write in the history
+	 */
+	unsigned int _nextFrame;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Estimate the demand of a cache over the history
+	 *
+	 * @param pIsNodeCache a flag telling wheter to use the node or the brick cache
+	 *
+	 * @return the demand (in number of elements)
+	 */
+	double computeDemand( bool pIsNodeCache ) const;
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvPoolRebalancer( const GvPoolRebalancer& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvPoolRebalancer& operator=( const GvPoolRebalancer& );
+
+};
+
+} // namespace GvCache
+
+#endif // !_GV_POOL_REBALANCER_H_
@@ -0,0 +1,414 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvCache/GvPoolRemapper.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Cuda
+#include <cuda_runtime.h>
+
+// GigaVoxels
+#include "GvStructure/GvVolumeTreeAddressType.h"
+
+// STL
+#include <cassert>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvCache;
+using namespace GvStructure;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Number of locked elements of a cache
+ */
+const unsigned int GvPoolRemapper::cNbLockedElements = 1/*null reference*/ + 1/*root node*/;
+
+/**
+ * Index of the root node tile
+ */
+static const unsigned int cRootNodeTileIndex = 1;
+
+/**
+ * Value of an element without new address
+ */
+static const unsigned int cInvalidIndex = 0xFFFFFFFF;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pNodeTileSize number of nodes in a node tile
+ * @param pBrickSize resolution of a brick, borders included
+ ******************************************************************************/
+GvPoolRemapper::GvPoolRemapper( unsigned int pNodeTileSize, unsigned int pBrickSize )
+:	_nodeTileSize( pNodeTileSize )
+,	_brickSize( pBrickSize )
+,	_childArray()
+,	_dataArray()
+,	_nodeTileList()
+,	_brickList()
+,	_nodeTileMappings()
+,	_brickMappings()
+{
+	assert( _nodeTileSize > 0 );
+	assert( _brickSize > 0 );
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvPoolRemapper::~GvPoolRemapper()
+{
+}
+
+/******************************************************************************
+ * Select the kept node tiles and bricks, give them new addresses,
+ * and build the new node pool and element lists.
+ *
+ * @param pChildArray child array of the previous node pool
+ * @param pDataArray data array of the previous node pool
+ * @param pNodeTileList element list of the previous node cache (packed node tile addresses, least recently used first)
+ * @param pBrickList element list of the previous brick cache (packed brick addresses, least recently used first)
+ * @param pBrickPoolResolution resolution of the previous brick pool (in bricks)
+ * @param pNewNbNodeTiles number of node tiles of the new node pool
+ * @param pNewBrickPoolResolution resolution of the new brick pool (in bricks)
+ ******************************************************************************/
+void GvPoolRemapper::remap( const std::vector< unsigned int >& pChildArray, const std::vector< unsigned int >& pDataArray,
+							const std::vector< unsigned int >& pNodeTileList, const std::vector< unsigned int >& pBrickList,
+							const uint3& pBrickPoolResolution,
+							unsigned int pNewNbNodeTiles, const uint3& pNewBrickPoolResolution )
+{
+	assert( pChildArray.size() == pDataArray.size() );
+	assert( pNewNbNodeTiles > cNbLockedElements );
+
+	const unsigned int nbNodeTiles = static_cast< unsigned int >( pChildArray.size() ) / _nodeTileSize;
+	const unsigned int nbBricks = pBrickPoolResolution.x * pBrickPoolResolution.y * pBrickPoolResolution.z;
+	const unsigned int newNbBricks = pNewBrickPoolResolution.x * pNewBrickPoolResolution.y * pNewBrickPoolResolution.z;
+	assert( newNbBricks > cNbLockedElements );
+
+	// [ 1 ] - Resident node tiles are the ones reachable from the root node tile
+	std::vector< unsigned char > isNodeTileResident;
+	findReachedNodeTiles( pChildArray, std::vector< unsigned char >( nbNodeTiles, 1 ), isNodeTileResident );
+
+	// [ 2 ] - Keep the most recently used resident node tiles
+	std::vector< unsigned char > isNodeTileKept( nbNodeTiles, 0 );
+	unsigned int nbKeptNodeTiles = 0;
+	for ( size_t i = pNodeTileList.size(); i > 0 && nbKeptNodeTiles < pNewNbNodeTiles - cNbLockedElements; i-- )
+	{
+		const unsigned int nodeTileIndex = VolTreeNodeAddress::unpackAddress( pNodeTileList[ i - 1 ] ).x;
+		if ( nodeTileIndex < nbNodeTiles && isNodeTileResident[ nodeTileIndex ] )
+		{
+			isNodeTileKept[ nodeTileIndex ] = 1;
+			nbKeptNodeTiles++;
+		}
+	}
+
+	// A node tile whose parent node tile is dropped can't be reached anymore
+	std::vector< unsigned char > isNodeTileReached;
+	findReachedNodeTiles( pChildArray, isNodeTileKept, isNodeTileReached );
+
+	// [ 3 ] - New node tile indices, in the order of the element list
+	std::vector< unsigned int > newNodeTileIndices( nbNodeTiles, cInvalidIndex );
+	_nodeTileMappings.clear();
+	_nodeTileMappings.push_back( ElementMapping( cRootNodeTileIndex, cRootNodeTileIndex ) );
+	newNodeTileIndices[ cRootNodeTileIndex ] = cRootNodeTileIndex;
+	unsigned int nbMappedNodeTiles = 0;
+	for ( size_t i = 0; i < pNodeTileList.size(); i++ )
+	{
+		const unsigned int nodeTileIndex = VolTreeNodeAddress::unpackAddress( pNodeTileList[ i ] ).x;
+		if ( nodeTileIndex < nbNodeTiles && nodeTileIndex != cRootNodeTileIndex && isNodeTileReached[ nodeTileIndex ] )
+		{
+			const unsigned int newNodeTileIndex = cNbLockedElements + nbMappedNodeTiles;
+			newNodeTileIndices[ nodeTileIndex ] = newNodeTileIndex;
+			_nodeTileMappings.push_back( ElementMapping( nodeTileIndex, newNodeTileIndex ) );
+			nbMappedNodeTiles++;
+		}
+	}
+
+	// [ 4 ] - Keep the most recently used bricks of mapped nodes
+	std::vector< unsigned int > brickNodes( nbBricks, cInvalidIndex );
+	for ( size_t i = 0; i < _nodeTileMappings.size(); i++ )
+	{
+		const unsigned int firstNode = _nodeTileMappings[ i ].first * _nodeTileSize;
+		for ( unsigned int node = firstNode; node < firstNode + _nodeTileSize; node++ )
+		{
+			const unsigned int brickAddress = pDataArray[ node ];
+			if ( ! VolTreeBrickAddress::isNull( brickAddress ) )
+			{
+				const unsigned int brickIndex = getBrickIndex( VolTreeBrickAddress::packAddress( getBrick( VolTreeBrickAddress::unpackAddress( brickAddress ) ) ), pBrickPoolResolution );
+				if ( brickIndex < nbBricks )
+				{
+					brickNodes[ brickIndex ] = node;
+				}
+			}
+		}
+	}
+	std::vector< unsigned char > isBrickKept( nbBricks, 0 );
+	unsigned int nbKeptBricks = 0;
+	for ( size_t i = pBrickList.size(); i > 0 && nbKeptBricks < newNbBricks - cNbLockedElements; i-- )
+	{
+		const unsigned int brickIndex = getBrickIndex( pBrickList[ i - 1 ], pBrickPoolResolution );
+		if ( brickIndex < nbBricks && brickNodes[ brickIndex ] != cInvalidIndex )
+		{
+			isBrickKept[ brickIndex ] = 1;
+			nbKeptBricks++;
+		}
+	}
+
+	// New brick addresses follow the initial order of the element list of a cache manager
+	std::vector< unsigned int > newBrickAddresses( newNbBricks );
+	uint3 position;
+	unsigned int index = 0;
+	for ( position.z = 0; position.z < pNewBrickPoolResolution.z; position.z++ )
+	for ( position.y = 0; position.y < pNewBrickPoolResolution.y; position.y++ )
+	for ( position.x = 0; position.x < pNewBrickPoolResolution.x; position.x++ )
+	{
+		newBrickAddresses[ index ] = VolTreeBrickAddress::packAddress( position );
+		index++;
+	}
+
+	// [ 5 ] - New brick addresses, in the order of the element list
+	std::vector< unsigned int > newBrickIndices( nbBricks, cInvalidIndex );
+	_brickMappings.clear();
+	for ( size_t i = 0; i < pBrickList.size(); i++ )
+	{
+		const unsigned int brickIndex = getBrickIndex( pBrickList[ i ], pBrickPoolResolution );
+		if ( brickIndex < nbBricks && isBrickKept[ brickIndex ] )
+		{
+			const unsigned int newBrickIndex = cNbLockedElements + static_cast< unsigned int >( _brickMappings.size() );
+			newBrickIndices[ brickIndex ] = newBrickIndex;
+			_brickMappings.push_back( ElementMapping( pBrickList[ i ], newBrickAddresses[ newBrickIndex ] ) );
+		}
+	}
+
+	// [ 6 ] - Copy mapped node tiles and remap their addresses (dropped elements are reset to 0, flags are kept)
+	_childArray.assign( pNewNbNodeTiles * _nodeTileSize, 0 );
+	_dataArray.assign( pNewNbNodeTiles * _nodeTileSize, 0 );
+	for ( size_t i = 0; i < _nodeTileMappings.size(); i++ )
+	{
+		const unsigned int firstNode = _nodeTileMappings[ i ].first * _nodeTileSize;
+		const unsigned int newFirstNode = _nodeTileMappings[ i ].second * _nodeTileSize;
+		for ( unsigned int offset = 0; offset < _nodeTileSize; offset++ )
+		{
+			// Child node tile
+			unsigned int childAddress = pChildArray[ firstNode + offset ];
+			if ( ! VolTreeNodeAddress::isNull( childAddress ) )
+			{
+				const unsigned int childNode = VolTreeNodeAddress::unpackAddress( childAddress ).x;
+				const unsigned int childNodeTileIndex = childNode / _nodeTileSize;
+				childAddress &= ~VolTreeNodeAddress::packedMask;
+				if ( childNodeTileIndex < nbNodeTiles && newNodeTileIndices[ childNodeTileIndex ] != cInvalidIndex )
+				{
+					childAddress |= VolTreeNodeAddress::packAddress( newNodeTileIndices[ childNodeTileIndex ] * _nodeTileSize + childNode % _nodeTileSize );
+				}
+			}
+			_childArray[ newFirstNode + offset ] = childAddress;
+
+			// Brick
+			unsigned int brickAddress = pDataArray[ firstNode + offset ];
+			if ( ! VolTreeBrickAddress::isNull( brickAddress ) )
+			{
+				const uint3 voxel = VolTreeBrickAddress::unpackAddress( brickAddress );
+				const uint3 brick = getBrick( voxel );
+				const unsigned int brickIndex = getBrickIndex( VolTreeBrickAddress::packAddress( brick ), pBrickPoolResolution );
+				brickAddress &= ~VolTreeBrickAddress::packedMask;
+				if ( brickIndex < nbBricks && newBrickIndices[ brickIndex ] != cInvalidIndex )
+				{
+					// Position of the voxel in its brick is kept (i.e. border)
+					const uint3 newBrick = VolTreeBrickAddress::unpackAddress( newBrickAddresses[ newBrickIndices[ brickIndex ] ] );
+					const uint3 newVoxel = make_uint3( newBrick.x * _brickSize + voxel.x % _brickSize,
+													newBrick.y * _brickSize + voxel.y % _brickSize,
+													newBrick.z * _brickSize + voxel.z % _brickSize );
+					brickAddress |= VolTreeBrickAddress::packAddress( newVoxel );
+				}
+			}
+			_dataArray[ newFirstNode + offset ] = brickAddress;
+		}
+	}
+
+	// [ 7 ] - New element lists : free elements first, then kept elements in their previous order
+	_nodeTileList.clear();
+	for ( unsigned int nodeTileIndex = cNbLockedElements + nbMappedNodeTiles; nodeTileIndex < pNewNbNodeTiles; nodeTileIndex++ )
+	{
+		_nodeTileList.push_back( VolTreeNodeAddress::packAddress( nodeTileIndex ) );
+	}
+	for ( unsigned int nodeTileIndex = cNbLockedElements; nodeTileIndex < cNbLockedElements + nbMappedNodeTiles; nodeTileIndex++ )
+	{
+		_nodeTileList.push_back( VolTreeNodeAddress::packAddress( nodeTileIndex ) );
+	}
+	const unsigned int nbMappedBricks = static_cast< unsigned int >( _brickMappings.size() );
+	_brickList.assign( newBrickAddresses.begin() + cNbLockedElements + nbMappedBricks, newBrickAddresses.end() );
+	_brickList.insert( _brickList.end(), newBrickAddresses.begin() + cNbLockedElements, newBrickAddresses.begin() + cNbLockedElements + nbMappedBricks );
+}
+
+/******************************************************************************
+ * Find the node tiles reachable from the root node tile
+ *
+ * @param pChildArray child array of the node pool
+ * @param pIsNodeTileAllowed flags telling wheter or not a node tile can be traversed
+ * @param pIsNodeTileReached resulting flags telling wheter or not a node tile is reached
+ ******************************************************************************/
+void GvPoolRemapper::findReachedNodeTiles( const std::vector< unsigned int >& pChildArray, const std::vector< unsigned char >& pIsNodeTileAllowed,
+										  std::vector< unsigned char >& pIsNodeTileReached ) const
+{
+	const unsigned int nbNodeTiles = static_cast< unsigned int >( pChildArray.size() ) / _nodeTileSize;
+	pIsNodeTileReached.assign( nbNodeTiles, 0 );
+	if ( nbNodeTiles <= cRootNodeTileIndex )
+	{
+		return;
+	}
+
+	// Breadth-first traversal from the root node tile
+	std::vector< unsigned int > nodeTiles;
+	nodeTiles.push_back( cRootNodeTileIndex );
+	pIsNodeTileReached[ cRootNodeTileIndex ] = 1;
+	for ( size_t i = 0; i < nodeTiles.size(); i++ )
+	{
+		const unsigned int firstNode = nodeTiles[ i ] * _nodeTileSize;
+		for ( unsigned int node = firstNode; node < firstNode + _nodeTileSize; node++ )
+		{
+			const unsigned int childAddress = pChildArray[ node ];
+			if ( ! VolTreeNodeAddress::isNull( childAddress ) )
+			{
+				const unsigned int childNodeTileIndex = VolTreeNodeAddress::unpackAddress( childAddress ).x / _nodeTileSize;
+				if ( childNodeTileIndex >= cNbLockedElements && childNodeTileIndex < nbNodeTiles
+					&& pIsNodeTileAllowed[ childNodeTileIndex ] && ! pIsNodeTileReached[ childNodeTileIndex ] )
+				{
+					pIsNodeTileReached[ childNodeTileIndex ] = 1;
+					nodeTiles.push_back( childNodeTileIndex );
+				}
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * Get the position of the brick containing a voxel
+ *
+ * @param pVoxel position of a voxel in the brick pool
+ *
+ * @return the position of the brick (in bricks)
+ ******************************************************************************/
+uint3 GvPoolRemapper::getBrick( const uint3& pVoxel ) const
+{
+	return make_uint3( pVoxel.x / _brickSize, pVoxel.y / _brickSize, pVoxel.z / _brickSize );
+}
+
+/******************************************************************************
+ * Get the linear index of a brick in a brick pool
+ *
+ * @param pPackedBrickAddress packed address of the brick (position in the pool, in bricks)
+ * @param pBrickPoolResolution resolution of the brick pool (in bricks)
+ *
+ * @return the index of the brick
+ ******************************************************************************/
+unsigned int GvPoolRemapper::getBrickIndex( unsigned int pPackedBrickAddress, const uint3& pBrickPoolResolution )
+{
+	const uint3 brick = VolTreeBrickAddress::unpackAddress( pPackedBrickAddress );
+	if ( brick.x >= pBrickPoolResolution.x || brick.y >= pBrickPoolResolution.y || brick.z >= pBrickPoolResolution.z )
+	{
+		return pBrickPoolResolution.x * pBrickPoolResolution.y * pBrickPoolResolution.z;
+	}
+
+	return brick.x + pBrickPoolResolution.x * ( brick.y + pBrickPoolResolution.y * brick.z );
+}
+
+/******************************************************************************
+ * Get the child array of the new node pool
+ *
+ * @return the child array
+ ******************************************************************************/
+const std::vector< unsigned int >& GvPoolRemapper::getChildArray() const
+{
+	return _childArray;
+}
+
+/******************************************************************************
+ * Get the data array of the new node pool
+ *
+ * @return the data array
+ ******************************************************************************/
+const std::vector< unsigned int >& GvPoolRemapper::getDataArray() const
+{
+	return _dataArray;
+}
+
+/******************************************************************************
+ * Get the element list of the new node cache
+ *
+ * @return the element list (packed node tile addresses, least recently used first)
+ ******************************************************************************/
+const std::vector< unsigned int >& GvPoolRemapper::getNodeTileList() const
+{
+	return _nodeTileList;
+}
+
+/******************************************************************************
+ * Get the element list of the new brick cache
+ *
+ * @return the element list (packed brick addresses, least recently used first)
+ ******************************************************************************/
+const std::vector< unsigned int >& GvPoolRemapper::getBrickList() const
+{
+	return _brickList;
+}
+
+/******************************************************************************
+ * Get the node tiles to copy (the root node tile, then kept node tiles)
+ *
+ * @return the list of (previous index, new index) of node tiles
+ ******************************************************************************/
+const std::vector< GvPoolRemapper::ElementMapping >& GvPoolRemapper::getNodeTileMappings() const
+{
+	return _nodeTileMappings;
+}
+
+/******************************************************************************
+ * Get the bricks to copy
+ *
+ * @return the list of (previous packed address, new packed address) of bricks (i.e. position of bricks in the pool, in bricks)
+ ******************************************************************************/
+const std::vector< GvPoolRemapper::ElementMapping >& GvPoolRemapper::getBrickMappings() const
+{
+	return _brickMappings;
+}
@@ -0,0 +1,301 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_POOL_REMAPPER_H_
+#define _GV_POOL_REMAPPER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+
+// Cuda
+#include <vector_types.h>
+
+// STL
+#include <vector>
+#include <utility>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvCache
+{
+
+/** 
+ * @class GvPoolRemapper
+ *
+ * @brief The GvPoolRemapper class computes the content of resized node and brick pools
+ * from the resident node tiles and bricks of the previous pools.
+ *
+ * @ingroup GvCache
+ *
+ * Input data are host copies of the node pool (child and data arrays) and of the
+ * element lists of the node and brick cache managers (least recently used first).
+ *
+ * Only node tiles reachable from the root node tile are resident. If they don't fit
+ * in the new pools, the most recently used ones are kept, and a node tile is kept only if its
+ * parent node tile is kept too. Bricks of kept nodes are selected the same way.
+ * Kept elements are given new addresses, in the order of the element lists, and the
+ * packed addresses of the node pool are remapped. Addresses of dropped elements are reset
+ * to 0 (flags are kept), as cache managers do when they recycle elements,
+ * so that their nodes request them again.
+ *
+ * The new element lists start with the free elements, followed by the kept ones
+ * in their previous order, so the least recently used elements are still recycled first.
+ *
+ * This class only uses host data, it has no dependency on the device.
+ */
+class GIGASPACE_EXPORT GvPoolRemapper
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Type definition of an element mapping (previous address, new address)
+	 */
+	typedef std::pair< unsigned int, unsigned int > ElementMapping;
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * In the GigaSpace engine, the first elements of a cache are locked :
+	 * - "null" reference (element address)
+	 * - root node tile in the data structure
+	 * (see GvCacheManager::_cNbLockedElements)
+	 */
+	static const unsigned int cNbLockedElements;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pNodeTileSize number of nodes in a node tile
+	 * @param pBrickSize resolution of a brick, borders included
+	 */
+	GvPoolRemapper( unsigned int pNodeTileSize, unsigned int pBrickSize );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvPoolRemapper();
+
+	/**
+	 * Select the kept node tiles and bricks, give them new addresses,
+	 * and build the new node pool and element lists.
+	 *
+	 * @param pChildArray child array of the previous node pool
+	 * @param pDataArray data array of the previous node pool
+	 * @param pNodeTileList element list of the previous node cache (packed node tile addresses, least recently used first)
+	 * @param pBrickList element list of the previous brick cache (packed brick addresses, least recently used first)
+	 * @param pBrickPoolResolution resolution of the previous brick pool (in bricks)
+	 * @param pNewNbNodeTiles number of node tiles of the new node pool
+	 * @param pNewBrickPoolResolution resolution of the new brick pool (in bricks)
+	 */
+	void remap( const std::vector< unsigned int >& pChildArray, const std::vector< unsigned int >& pDataArray,
+				const std::vector< unsigned int >& pNodeTileList, const std::vector< unsigned int >& pBrickList,
+				const uint3& pBrickPoolResolution,
+				unsigned int pNewNbNodeTiles, const uint3& pNewBrickPoolResolution );
+
+	/**
+	 * Get the child array of the new node pool
+	 *
+	 * @return the child array
+	 */
+	const std::vector< unsigned int >& getChildArray() const;
+
+	/**
+	 * Get the data array of the new node pool
+	 *
+	 * @return the data array
+	 */
+	const std::vector< unsigned int >& getDataArray() const;
+
+	/**
+	 * Get the element list of the new node cache
+	 *
+	 * @return the element list (packed node tile addresses, least recently used first)
+	 */
+	const std::vector< unsigned int >& getNodeTileList() const;
+
+	/**
+	 * Get the element list of the new brick cache
+	 *
+	 * @return the element list (packed brick addresses, least recently used first)
+	 */
+	const std::vector< unsigned int >& getBrickList() const;
+
+	/**
+	 * Get the node tiles to copy (the root node tile, then kept node tiles)
+	 *
+	 * @return the list of (previous index, new index) of node tiles
+	 */
+	const std::vector< ElementMapping >& getNodeTileMappings() const;
+
+	/**
+	 * Get the bricks to copy
+	 *
+	 * @return the list of (previous packed address, new packed address) of bricks (i.e. position of bricks in the pool, in bricks)
+	 */
+	const std::vector< ElementMapping >& getBrickMappings() const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Number of nodes in a node tile
+	 */
+	unsigned int _nodeTileSize;
+
+	/**
+	 * Resolution of a brick, borders included
+	 */
+	unsigned int _brickSize;
+
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	/**
+	 * Child array of the new node pool
+	 */
+	std::vector< unsigned int > _childArray;
+
+	/**
+	 * Data array of the new node pool
+	 */
+	std::vector< unsigned int > _dataArray;
+
+	/**
+	 * Element list of the new node cache
+	 */
+	std::vector< unsigned int > _nodeTileList;
+
+	/**
+	 * Element list of the new brick cache
+	 */
+	std::vector< unsigned int > _brickList;
+
+	/**
+	 * Node tiles to copy
+	 */
+	std::vector< ElementMapping > _nodeTileMappings;
+
+	/**
+	 * Bricks to copy
+	 */
+	std::vector< ElementMapping > _brickMappings;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Find the node tiles reachable from the root node tile
+	 *
+	 * @param pChildArray child array of the node pool
+	 * @param pIsNodeTileAllowed flags telling wheter or not a node tile can be traversed
+	 * @param pIsNodeTileReached resulting flags telling wheter or not a node tile is reached
+	 */
+	void findReachedNodeTiles( const std::vector< unsigned int >& pChildArray, const std::vector< unsigned char >& pIsNodeTileAllowed,
+								std::vector< unsigned char >& pIsNodeTileReached ) const;
+
+	/**
+	 * Get the position of the brick containing a voxel
+	 *
+	 * @param pVoxel position of a voxel in the brick pool
+	 *
+	 * @return the position of the brick (in bricks)
+	 */
+	uint3 getBrick( const uint3& pVoxel ) const;
+
+	/**
+	 * Get the linear index of a brick in a brick pool
+	 *
+	 * @param pPackedBrickAddress packed address of the brick (position in the pool, in bricks)
+	 * @param pBrickPoolResolution resolution of the brick pool (in bricks)
+	 *
+	 * @return the index of the brick
+	 */
+	static unsigned int getBrickIndex( unsigned int pPackedBrickAddress, const uint3& pBrickPoolResolution );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvPoolRemapper( const GvPoolRemapper& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvPoolRemapper& operator=( const GvPoolRemapper& );
+
+};
+
+} // namespace GvCache
+
+#endif
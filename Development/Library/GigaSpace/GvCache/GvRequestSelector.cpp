@@ -0,0 +1,259 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvCache/GvRequestSelector.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <algorithm>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvCache;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+namespace
+{
+
+/**
+ * Order of request indices by decreasing priority, then by increasing index
+ */
+struct HigherPriority
+{
+	/**
+	 * Priorities of requests
+	 */
+	const float* _priorities;
+
+	/**
+	 * Compare two request indices
+	 *
+	 * @param pIndex1 index of the first request
+	 * @param pIndex2 index of the second request
+	 *
+	 * @return a flag telling wheter or not the first request comes before the second one
+	 */
+	bool operator()( unsigned int pIndex1, unsigned int pIndex2 ) const
+	{
+		if ( _priorities[ pIndex1 ] != _priorities[ pIndex2 ] )
+		{
+			return _priorities[ pIndex1 ] > _priorities[ pIndex2 ];
+		}
+
+		return pIndex1 < pIndex2;
+	}
+};
+
+}
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvRequestSelector::GvRequestSelector()
+:	_budgets()
+,	_indices()
+,	_selectedIndices()
+,	_isSelected()
+,	_requests()
+,	_priorities()
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvRequestSelector::~GvRequestSelector()
+{
+}
+
+/******************************************************************************
+ * Set the max number of requests of a given type to select.
+ * Requests of a type without budget are never selected.
+ *
+ * @param pRequestFlag the bit mask of the type of request
+ * @param pMaxNbRequests the max number of requests
+ ******************************************************************************/
+void GvRequestSelector::setBudget( unsigned int pRequestFlag, unsigned int pMaxNbRequests )
+{
+	for ( size_t i = 0; i < _budgets.size(); i++ )
+	{
+		if ( _budgets[ i ]._requestFlag == pRequestFlag )
+		{
+			_budgets[ i ]._maxNbRequests = pMaxNbRequests;
+
+			return;
+		}
+	}
+
+	Budget budget;
+	budget._requestFlag = pRequestFlag;
+	budget._maxNbRequests = pMaxNbRequests;
+	_budgets.push_back( budget );
+}
+
+/******************************************************************************
+ * Get the max number of requests of a given type to select
+ *
+ * @param pRequestFlag the bit mask of the type of request
+ *
+ * @return the max number of requests (0 if the type has no budget)
+ ******************************************************************************/
+unsigned int GvRequestSelector::getBudget( unsigned int pRequestFlag ) const
+{
+	for ( size_t i = 0; i < _budgets.size(); i++ )
+	{
+		if ( _budgets[ i ]._requestFlag == pRequestFlag )
+		{
+			return _budgets[ i ]._maxNbRequests;
+		}
+	}
+
+	return 0;
+}
+
+/******************************************************************************
+ * Tell wheter or not the requests exceed the budget of at least one type
+ * (otherwise, all requests are handled and their order does not matter)
+ *
+ * @param pRequests the list of requests
+ * @param pNbRequests the number of requests
+ *
+ * @return a flag telling wheter or not the requests exceed the budget
+ ******************************************************************************/
+bool GvRequestSelector::isOverBudget( const unsigned int* pRequests, unsigned int pNbRequests ) const
+{
+	for ( size_t i = 0; i < _budgets.size(); i++ )
+	{
+		// Fast path : the whole list fits in the budget
+		if ( pNbRequests <= _budgets[ i ]._maxNbRequests )
+		{
+			continue;
+		}
+
+		unsigned int nbRequests = 0;
+		for ( unsigned int j = 0; j < pNbRequests; j++ )
+		{
+			if ( ( pRequests[ j ] & _budgets[ i ]._requestFlag ) && ++nbRequests > _budgets[ i ]._maxNbRequests )
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * Select the requests with the highest priorities within the budget of their type
+ * and move them at the front of the list.
+ *
+ * @param pRequests the list of requests (reordered in place)
+ * @param pPriorities the priorities of the requests (reordered in place)
+ * @param pNbRequests the number of requests
+ *
+ * @return the number of selected requests
+ ******************************************************************************/
+unsigned int GvRequestSelector::select( unsigned int* pRequests, float* pPriorities, unsigned int pNbRequests )
+{
+	HigherPriority higherPriority;
+	higherPriority._priorities = pPriorities;
+
+	_selectedIndices.clear();
+	_isSelected.assign( pNbRequests, 0 );
+
+	// Select the requests with the highest priorities of each type
+	for ( size_t i = 0; i < _budgets.size(); i++ )
+	{
+		_indices.clear();
+		for ( unsigned int j = 0; j < pNbRequests; j++ )
+		{
+			if ( ( pRequests[ j ] & _budgets[ i ]._requestFlag ) && ! _isSelected[ j ] )
+			{
+				_indices.push_back( j );
+			}
+		}
+
+		const size_t nbSelected = std::min( _indices.size(), static_cast< size_t >( _budgets[ i ]._maxNbRequests ) );
+		if ( nbSelected < _indices.size() )
+		{
+			std::nth_element( _indices.begin(), _indices.begin() + nbSelected, _indices.end(), higherPriority );
+		}
+		for ( size_t j = 0; j < nbSelected; j++ )
+		{
+			_selectedIndices.push_back( _indices[ j ] );
+			_isSelected[ _indices[ j ] ] = 1;
+		}
+	}
+
+	// Selected requests first, by decreasing priority
+	std::sort( _selectedIndices.begin(), _selectedIndices.end(), higherPriority );
+
+	_requests.resize( pNbRequests );
+	_priorities.resize( pNbRequests );
+	unsigned int nbRequests = 0;
+	for ( size_t i = 0; i < _selectedIndices.size(); i++ )
+	{
+		_requests[ nbRequests ] = pRequests[ _selectedIndices[ i ] ];
+		_priorities[ nbRequests ] = pPriorities[ _selectedIndices[ i ] ];
+		nbRequests++;
+	}
+
+	// Then other requests, in their initial order
+	for ( unsigned int i = 0; i < pNbRequests; i++ )
+	{
+		if ( ! _isSelected[ i ] )
+		{
+			_requests[ nbRequests ] = pRequests[ i ];
+			_priorities[ nbRequests ] = pPriorities[ i ];
+			nbRequests++;
+		}
+	}
+
+	if ( pNbRequests > 0 )
+	{
+		std::copy( _requests.begin(), _requests.begin() + pNbRequests, pRequests );
+		std::copy( _priorities.begin(), _priorities.begin() + pNbRequests, pPriorities );
+	}
+
+	return static_cast< unsigned int >( _selectedIndices.size() );
+}
@@ -0,0 +1,239 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_REQUEST_SELECTOR_H_
+#define _GV_REQUEST_SELECTOR_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+
+// STL
+#include <vector>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvCache
+{
+
+/** 
+ * @class GvRequestSelector
+ *
+ * @brief The GvRequestSelector class reorders a list of production requests
+ * so that the most important ones are handled first when the budget is exceeded.
+ *
+ * @ingroup GvCache
+ *
+ * Each request is a node address whose highest bits store its type (i.e. node subdivision
+ * or brick load/produce), and it has a priority (i.e. a screen-space error : the size of
+ * its voxels relative to the size of a pixel). A budget is given per type of request.
+ *
+ * For each type, the requests with the highest priorities within the budget are selected
+ * with a partial sort (linear selection, then sort of the selected requests only).
+ * Selected requests are moved at the front of the list, in decreasing order of priority
+ * whatever their type, and other requests follow in their initial order.
+ * Cache managers take the first requests of each type, so they get the selected ones,
+ * and a production time limit that truncates the list keeps the most important ones.
+ *
+ * Ties are broken by position in the list, so the selection is deterministic.
+ *
+ * This class only uses host data, it has no dependency on the device.
+ */
+class GIGASPACE_EXPORT GvRequestSelector
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvRequestSelector();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvRequestSelector();
+
+	/**
+	 * Set the max number of requests of a given type to select.
+	 * Requests of a type without budget are never selected.
+	 *
+	 * @param pRequestFlag the bit mask of the type of request
+	 * @param pMaxNbRequests the max number of requests
+	 */
+	void setBudget( unsigned int pRequestFlag, unsigned int pMaxNbRequests );
+
+	/**
+	 * Get the max number of requests of a given type to select
+	 *
+	 * @param pRequestFlag the bit mask of the type of request
+	 *
+	 * @return the max number of requests (0 if the type has no budget)
+	 */
+	unsigned int getBudget( unsigned int pRequestFlag ) const;
+
+	/**
+	 * Tell wheter or not the requests exceed the budget of at least one type
+	 * (otherwise, all requests are handled and their order does not matter)
+	 *
+	 * @param pRequests the list of requests
+	 * @param pNbRequests the number of requests
+	 *
+	 * @return a flag telling wheter or not the requests exceed the budget
+	 */
+	bool isOverBudget( const unsigned int* pRequests, unsigned int pNbRequests ) const;
+
+	/**
+	 * Select the requests with the highest priorities within the budget of their type
+	 * and move them at the front of the list.
+	 *
+	 * @param pRequests the list of requests (reordered in place)
+	 * @param pPriorities the priorities of the requests (reordered in place)
+	 * @param pNbRequests the number of requests
+	 *
+	 * @return the number of selected requests
+	 */
+	unsigned int select( unsigned int* pRequests, float* pPriorities, unsigned int pNbRequests );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Budget of a type of request
+	 */
+	struct Budget
+	{
+		/**
+		 * Bit mask of the type of request
+		 */
+		unsigned int _requestFlag;
+
+		/**
+		 * Max number of requests
+		 */
+		unsigned int _maxNbRequests;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Budget of each type of request
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< Budget > _budgets;
+
+	/**
+	 * Indices of requests (scratch buffer kept between calls)
+	 */
+	std::vector< unsigned int > _indices;
+
+	/**
+	 * Indices of selected requests (scratch buffer kept between calls)
+	 */
+	std::vector< unsigned int > _selectedIndices;
+
+	/**
+	 * Flags telling wheter or not a request is selected (scratch buffer kept between calls)
+	 */
+	std::vector< unsigned char > _isSelected;
+
+	/**
+	 * Reordered requests (scratch buffer kept between calls)
+	 */
+	std::vector< unsigned int > _requests;
+
+	/**
+	 * Reordered priorities (scratch buffer kept between calls)
+	 */
+	std::vector< float > _priorities;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/******************************** METHODS *********************************/
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvRequestSelector( const GvRequestSelector& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvRequestSelector& operator=( const GvRequestSelector& );
+
+};
+
+} // namespace GvCache
+
+#endif // !_GV_REQUEST_SELECTOR_H_
@@ -0,0 +1,255 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_MORTON_CODE_H_
+#define _GV_MORTON_CODE_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+#include "GvCore/GvLocalizationInfo.h"
+
+// Cuda
+#include <vector_types.h>
+#include <host_defines.h>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Host bit deposit/extract instructions (BMI2) are used when available
+ * (AVX2 is used as a hint on compilers not defining __BMI2__, every AVX2 processor has BMI2)
+ */
+#if defined( __BMI2__ ) || ( defined( _MSC_VER ) && defined( __AVX2__ ) )
+	#define GV_MORTON_CODE_USE_BMI2
+#endif
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvCore
+{
+
+/** 
+ * @class GvMortonCode
+ *
+ * @brief The GvMortonCode class provides a packed 64-bit encoding of the
+ * localization info of a node (localization code and localization depth).
+ *
+ * @ingroup GvCore
+ *
+ * The bits of the three axes of the localization code are interleaved (Morton order,
+ * X axis in the lowest bit), and the depth is folded in with a sentinel bit set just above
+ * the last bit of the code : with N bits per axis, the key is ( 1 << 3N ) | interleave( x, y, z ).
+ * Depth is retrieved from the position of the highest set bit.
+ *
+ * Keys are 8 bytes instead of 16 for a code/depth pair, and are directly sortable :
+ * shallower nodes come first, then nodes of the same depth follow a Z-order curve,
+ * so that sorted request lists give coherent accesses to bricks on disk.
+ *
+ * The encoding is limited to 21 bits per axis (i.e. a depth of 20 for an octree),
+ * and requires node tiles with the same power of two resolution along each axis (see isSupported()).
+ * The key 0 is invalid (it has no sentinel bit).
+ *
+ * Keys are only built for request lists (see PageTable::createMortonList()) : the page table
+ * keeps storing localization codes and depths unpacked, because GigaSpace data structures
+ * also use node tiles that can't be encoded (i.e. 3x3x3 tiles of the Menger sponge demos)
+ * and depths up to GvLocalizationInfo::maxDepth.
+ *
+ * @see GvLocalizationInfo GvLocalizationCode GvLocalizationDepth
+ */
+class GvMortonCode
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Type definition of the Morton key
+	 */
+	typedef unsigned long long ValueType;
+
+	/**
+	 * Max number of bits per axis
+	 */
+	enum
+	{
+		maxNbBits = 21
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Encode a localization code of a given number of bits per axis
+	 *
+	 * @param pCode the localization code
+	 * @param pNbBits the number of bits per axis of the code
+	 *
+	 * @return the Morton key (0 if the number of bits is greater than maxNbBits)
+	 */
+	__host__ __device__
+	static inline ValueType encode( uint3 pCode, uint pNbBits );
+
+	/**
+	 * Decode a Morton key
+	 *
+	 * @param pKey the Morton key (must be valid)
+	 * @param pNbBits the number of bits per axis of the code
+	 *
+	 * @return the localization code
+	 */
+	__host__ __device__
+	static inline uint3 decode( ValueType pKey, uint& pNbBits );
+
+	/**
+	 * Encode the localization info of a node, as found in request lists
+	 * (see PageTable::createLocalizationLists()) : a node of depth d
+	 * has a localization code of d + 1 levels.
+	 *
+	 * @param pCode the localization code of the node
+	 * @param pDepth the localization depth of the node
+	 *
+	 * @return the Morton key (0 if the node is too deep or if its node tile can't be encoded, see getMaxDepth() and isSupported())
+	 */
+	template< typename TNodeTileResolution >
+	__host__ __device__
+	static inline ValueType encodeNode( const GvLocalizationCode& pCode, const GvLocalizationDepth& pDepth );
+
+	/**
+	 * Decode the localization info of a node
+	 *
+	 * @param pKey the Morton key (must be valid)
+	 * @param pCode the localization code of the node
+	 * @param pDepth the localization depth of the node
+	 */
+	template< typename TNodeTileResolution >
+	__host__ __device__
+	static inline void decodeNode( ValueType pKey, GvLocalizationCode& pCode, GvLocalizationDepth& pDepth );
+
+	/**
+	 * Get the max depth of a node that can be encoded
+	 *
+	 * @return the max depth
+	 */
+	template< typename TNodeTileResolution >
+	__host__ __device__
+	static inline uint getMaxDepth();
+
+	/**
+	 * Tell wheter or not the localization info of nodes of a given node tile resolution can be encoded
+	 * (the resolution must be the same power of two along each axis)
+	 *
+	 * @return a flag telling wheter or not the node tile resolution is supported
+	 */
+	template< typename TNodeTileResolution >
+	__host__ __device__
+	static inline bool isSupported();
+
+	/**
+	 * Spread the 21 lowest bits of a value, so that two zero bits are inserted after each bit
+	 *
+	 * @param pValue the value
+	 *
+	 * @return the spread value
+	 */
+	__host__ __device__
+	static inline ValueType spreadBits( uint pValue );
+
+	/**
+	 * Gather every third bit of a value (inverse of spreadBits())
+	 *
+	 * @param pValue the value
+	 *
+	 * @return the gathered value
+	 */
+	__host__ __device__
+	static inline uint compactBits( ValueType pValue );
+
+	/**
+	 * Get the index of the highest set bit of a value
+	 *
+	 * @param pValue the value (must not be 0)
+	 *
+	 * @return the index of the highest set bit
+	 */
+	__host__ __device__
+	static inline uint getHighestBit( ValueType pValue );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+};
+
+} // namespace GvCore
+
+/**************************************************************************
+ ***************************** INLINE SECTION *****************************
+ **************************************************************************/
+
+#include "GvMortonCode.inl"
+
+#endif
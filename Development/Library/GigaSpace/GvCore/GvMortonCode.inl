@@ -0,0 +1,228 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// System
+#if ! defined( __CUDA_ARCH__ )
+	#if defined( GV_MORTON_CODE_USE_BMI2 )
+		#include <immintrin.h>
+	#endif
+	#if defined( _MSC_VER ) && defined( _M_X64 )
+		#include <intrin.h>
+	#endif
+#endif
+
+/******************************************************************************
+ ****************************** INLINE DEFINITION *****************************
+ ******************************************************************************/
+
+namespace GvCore
+{
+
+/******************************************************************************
+ * Encode a localization code of a given number of bits per axis
+ *
+ * @param pCode the localization code
+ * @param pNbBits the number of bits per axis of the code
+ *
+ * @return the Morton key (0 if the number of bits is greater than maxNbBits)
+ ******************************************************************************/
+__host__ __device__
+inline GvMortonCode::ValueType GvMortonCode::encode( uint3 pCode, uint pNbBits )
+{
+	if ( pNbBits > maxNbBits )
+	{
+		return 0ULL;
+	}
+
+	return ( 1ULL << ( 3 * pNbBits ) )
+		| spreadBits( pCode.x ) | ( spreadBits( pCode.y ) << 1 ) | ( spreadBits( pCode.z ) << 2 );
+}
+
+/******************************************************************************
+ * Decode a Morton key
+ *
+ * @param pKey the Morton key (must be valid)
+ * @param pNbBits the number of bits per axis of the code
+ *
+ * @return the localization code
+ ******************************************************************************/
+__host__ __device__
+inline uint3 GvMortonCode::decode( ValueType pKey, uint& pNbBits )
+{
+	// The sentinel bit gives the number of bits
+	pNbBits = getHighestBit( pKey ) / 3;
+	const ValueType code = pKey & ~( 1ULL << ( 3 * pNbBits ) );
+
+	return make_uint3( compactBits( code ), compactBits( code >> 1 ), compactBits( code >> 2 ) );
+}
+
+/******************************************************************************
+ * Encode the localization info of a node, as found in request lists
+ * (see PageTable::createLocalizationLists()) : a node of depth d
+ * has a localization code of d + 1 levels.
+ *
+ * @param pCode the localization code of the node
+ * @param pDepth the localization depth of the node
+ *
+ * @return the Morton key (0 if the node is too deep or if its node tile can't be encoded, see getMaxDepth() and isSupported())
+ ******************************************************************************/
+template< typename TNodeTileResolution >
+__host__ __device__
+inline GvMortonCode::ValueType GvMortonCode::encodeNode( const GvLocalizationCode& pCode, const GvLocalizationDepth& pDepth )
+{
+	if ( ! isSupported< TNodeTileResolution >() )
+	{
+		return 0ULL;
+	}
+
+	return encode( pCode.get(), ( pDepth.get() + 1 ) * TNodeTileResolution::xLog2 );
+}
+
+/******************************************************************************
+ * Decode the localization info of a node
+ *
+ * @param pKey the Morton key (must be valid)
+ * @param pCode the localization code of the node
+ * @param pDepth the localization depth of the node
+ ******************************************************************************/
+template< typename TNodeTileResolution >
+__host__ __device__
+inline void GvMortonCode::decodeNode( ValueType pKey, GvLocalizationCode& pCode, GvLocalizationDepth& pDepth )
+{
+	uint nbBits;
+	pCode.set( decode( pKey, nbBits ) );
+	pDepth.set( nbBits / TNodeTileResolution::xLog2 - 1 );
+}
+
+/******************************************************************************
+ * Get the max depth of a node that can be encoded
+ *
+ * @return the max depth
+ ******************************************************************************/
+template< typename TNodeTileResolution >
+__host__ __device__
+inline uint GvMortonCode::getMaxDepth()
+{
+	return maxNbBits / TNodeTileResolution::xLog2 - 1;
+}
+
+/******************************************************************************
+ * Tell wheter or not the localization info of nodes of a given node tile resolution can be encoded
+ * (the resolution must be the same power of two along each axis)
+ *
+ * @return a flag telling wheter or not the node tile resolution is supported
+ ******************************************************************************/
+template< typename TNodeTileResolution >
+__host__ __device__
+inline bool GvMortonCode::isSupported()
+{
+	return TNodeTileResolution::xIsPOT && TNodeTileResolution::x > 1
+		&& TNodeTileResolution::x == TNodeTileResolution::y && TNodeTileResolution::x == TNodeTileResolution::z;
+}
+
+/******************************************************************************
+ * Spread the 21 lowest bits of a value, so that two zero bits are inserted after each bit
+ *
+ * @param pValue the value
+ *
+ * @return the spread value
+ ******************************************************************************/
+__host__ __device__
+inline GvMortonCode::ValueType GvMortonCode::spreadBits( uint pValue )
+{
+#if ! defined( __CUDA_ARCH__ ) && defined( GV_MORTON_CODE_USE_BMI2 )
+	return _pdep_u64( pValue, 0x1249249249249249ULL );
+#else
+	ValueType value = pValue & 0x1FFFFFULL;
+	value = ( value | ( value << 32 ) ) & 0x001F00000000FFFFULL;
+	value = ( value | ( value << 16 ) ) & 0x001F0000FF0000FFULL;
+	value = ( value | ( value << 8 ) ) & 0x100F00F00F00F00FULL;
+	value = ( value | ( value << 4 ) ) & 0x10C30C30C30C30C3ULL;
+	value = ( value | ( value << 2 ) ) & 0x1249249249249249ULL;
+
+	return value;
+#endif
+}
+
+/******************************************************************************
+ * Gather every third bit of a value (inverse of spreadBits())
+ *
+ * @param pValue the value
+ *
+ * @return the gathered value
+ ******************************************************************************/
+__host__ __device__
+inline uint GvMortonCode::compactBits( ValueType pValue )
+{
+#if ! defined( __CUDA_ARCH__ ) && defined( GV_MORTON_CODE_USE_BMI2 )
+	return static_cast< uint >( _pext_u64( pValue, 0x1249249249249249ULL ) );
+#else
+	ValueType value = pValue & 0x1249249249249249ULL;
+	value = ( value ^ ( value >> 2 ) ) & 0x10C30C30C30C30C3ULL;
+	value = ( value ^ ( value >> 4 ) ) & 0x100F00F00F00F00FULL;
+	value = ( value ^ ( value >> 8 ) ) & 0x001F0000FF0000FFULL;
+	value = ( value ^ ( value >> 16 ) ) & 0x001F00000000FFFFULL;
+	value = ( value ^ ( value >> 32 ) ) & 0x1FFFFFULL;
+
+	return static_cast< uint >( value );
+#endif
+}
+
+/******************************************************************************
+ * Get the index of the highest set bit of a value
+ *
+ * @param pValue the value (must not be 0)
+ *
+ * @return the index of the highest set bit
+ ******************************************************************************/
+__host__ __device__
+inline uint GvMortonCode::getHighestBit( ValueType pValue )
+{
+#if defined( __CUDA_ARCH__ )
+	return 63 - __clzll( static_cast< long long >( pValue ) );
+#elif defined( __GNUC__ )
+	return 63 - __builtin_clzll( pValue );
+#elif defined( _MSC_VER ) && defined( _M_X64 )
+	unsigned long index;
+	_BitScanReverse64( &index, pValue );
+
+	return index;
+#else
+	uint index = 0;
+	while ( pValue >>= 1 )
+	{
+		index++;
+	}
+
+	return index;
+#endif
+}
+
+} // namespace GvCore
@@ -116,6 +116,20 @@ public:
 										thrust::device_vector< GvLocalizationInfo::CodeType >* pResLocCodeList,
 										thrust::device_vector< GvLocalizationInfo::DepthType >* pResLocDepthList );
 
+	/**
+	 * Create localization info list packed as 64-bit Morton keys
+	 *
+	 * Given a list of N nodes, it retrieves their localization info (code + depth) in one key per node
+	 * (see GvMortonCode) : this halves the size of the list to transfer to host, and the list can be sorted.
+	 * Nodes that can't be encoded (too deep, or node tiles not supported by GvMortonCode) get the invalid key 0.
+	 *
+	 * @param pNumElems number of elements to process (i.e. nodes)
+	 * @param pNodesAddressCompactList a list of nodes from which to retrieve localization info
+	 * @param pResMortonList the resulting Morton key array of all requested elements
+	 */
+	inline void createMortonList( uint pNumElems, uint* pNodesAddressCompactList,
+								thrust::device_vector< GvMortonCode::ValueType >* pResMortonList );
+
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
 	 **************************************************************************/
@@ -75,6 +75,35 @@ inline void PageTable< NodeTileRes, LocCodeArrayType, LocDepthArrayType >
 	GV_CHECK_CUDA_ERROR( "CreateLocalizationLists" );
 }
 
+/******************************************************************************
+ * Create localization info list packed as 64-bit Morton keys
+ *
+ * Given a list of N nodes, it retrieves their localization info (code + depth) in one key per node
+ * (see GvMortonCode) : this halves the size of the list to transfer to host, and the list can be sorted.
+ *
+ * @param pNumElems number of elements to process (i.e. nodes)
+ * @param pNodesAddressCompactList a list of nodes from which to retrieve localization info
+ * @param pResMortonList the resulting Morton key array of all requested elements
+ ******************************************************************************/
+template< typename NodeTileRes, typename LocCodeArrayType, typename LocDepthArrayType >
+inline void PageTable< NodeTileRes, LocCodeArrayType, LocDepthArrayType >
+::createMortonList( uint pNumElems, uint* pNodesAddressCompactList,
+					thrust::device_vector< GvMortonCode::ValueType >* pResMortonList )
+{
+	// Set kernel execution configuration
+	dim3 blockSize( 64, 1, 1 );
+	uint numBlocks = iDivUp( pNumElems, blockSize.x );
+	dim3 gridSize = dim3( std::min( numBlocks, 65535U ), iDivUp( numBlocks, 65535U ), 1 );
+
+	// Launch kernel
+	CreateMortonLists< NodeTileRes >
+			<<< gridSize, blockSize, 0 >>>( /*in*/pNumElems, /*in*/pNodesAddressCompactList,
+											/*in*/locCodeArray->getPointer(), /*in*/locDepthArray->getPointer(),
+											/*out*/thrust::raw_pointer_cast( &( *pResMortonList )[ 0 ] ) );
+
+	GV_CHECK_CUDA_ERROR( "CreateMortonLists" );
+}
+
 } // namespace GvCore
 
 /******************************************************************************
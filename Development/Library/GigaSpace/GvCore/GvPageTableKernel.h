@@ -38,6 +38,7 @@
 // GigaVoxels
 #include "GvCore/GvCoreConfig.h"
 #include "GvCore/GvLocalizationInfo.h"
+#include "GvCore/GvMortonCode.h"
 
 // TO DO : attention ce KERNEL n'est pas dans un namespace...
 /******************************************************************************
@@ -60,6 +61,24 @@ void CreateLocalizationLists( const uint pNbElements, const uint* pLoadAddressLi
 							 const GvCore::GvLocalizationInfo::CodeType* pLocCodeList, const GvCore::GvLocalizationInfo::DepthType* pLocDepthList,
 							 GvCore::GvLocalizationInfo::CodeType* pResLocCodeList, GvCore::GvLocalizationInfo::DepthType* pResLocDepthList );
 
+/******************************************************************************
+ * KERNEL : CreateMortonLists
+ *
+ * Extract localization informations associated with a list of given elements,
+ * packed as 64-bit Morton keys (see GvMortonCode).
+ *
+ * @param pNbElements number of elements to process
+ * @param pLoadAddressList List of input node addresses
+ * @param pLocCodeList List of localization code coming from the main page table of the data structure and referenced by cache managers (nodes and bricks)
+ * @param pLocDepthList List of localization depth coming from the main page table of the data structure and referenced by cache managers (nodes and bricks)
+ * @param pResMortonList Resulting output Morton key list
+ ******************************************************************************/
+template< class NodeTileRes >
+__global__
+void CreateMortonLists( const uint pNbElements, const uint* pLoadAddressList, 
+						const GvCore::GvLocalizationInfo::CodeType* pLocCodeList, const GvCore::GvLocalizationInfo::DepthType* pLocDepthList,
+						GvCore::GvMortonCode::ValueType* pResMortonList );
+
 /******************************************************************************
  ****************************** CLASS DEFINITION ******************************
  ******************************************************************************/
@@ -93,6 +93,48 @@ void CreateLocalizationLists( const uint pNbElements, const uint* pLoadAddressLi
 	}
 }
 
+/******************************************************************************
+ * KERNEL : CreateMortonLists
+ *
+ * Extract localization informations associated with a list of given elements,
+ * packed as 64-bit Morton keys (see GvMortonCode).
+ *
+ * @param pNbElements number of elements to process
+ * @param pLoadAddressList List of input node addresses
+ * @param pLocCodeList List of localization code coming from the main page table of the data structure and referenced by cache managers (nodes and bricks)
+ * @param pLocDepthList List of localization depth coming from the main page table of the data structure and referenced by cache managers (nodes and bricks)
+ * @param pResMortonList Resulting output Morton key list
+ ******************************************************************************/
+template< class NodeTileRes >
+__global__
+void CreateMortonLists( const uint pNbElements, const uint* pLoadAddressList, 
+						const GvCore::GvLocalizationInfo::CodeType* pLocCodeList, const GvCore::GvLocalizationInfo::DepthType* pLocDepthList,
+						GvCore::GvMortonCode::ValueType* pResMortonList )
+{
+	// Retrieve global indexes
+	const uint lineSize = __uimul( blockDim.x, gridDim.x );
+	const uint elem = threadIdx.x + __uimul( blockIdx.x, blockDim.x ) + __uimul( blockIdx.y, lineSize );
+
+	// Check bounds
+	if ( elem < pNbElements )
+	{
+		// Retrieve node address
+		const uint nodeAddressEnc = pLoadAddressList[ elem ];
+		const uint3 nodeAddress = GvStructure::GvNode::unpackNodeAddress( nodeAddressEnc );
+
+		// Retrieve its "node tile" address
+		const uint nodeTileAddress = nodeAddress.x / NodeTileRes::getNumElements();
+
+		// 3D offset of the node in the node tile
+		const uint linearOffset = nodeAddress.x - ( nodeTileAddress * NodeTileRes::getNumElements() );
+		const uint3 nodeOffset = NodeTileRes::toFloat3( linearOffset );
+
+		// Write packed localization info
+		const GvCore::GvLocalizationInfo::CodeType nodeLocCode = pLocCodeList[ nodeTileAddress ].addLevel< NodeTileRes >( nodeOffset );
+		pResMortonList[ elem ] = GvCore::GvMortonCode::encodeNode< NodeTileRes >( nodeLocCode, pLocDepthList[ nodeTileAddress ] );
+	}
+}
+
 /******************************************************************************
  ****************************** INLINE DEFINITION *****************************
  ******************************************************************************/
@@ -268,6 +310,14 @@ __device__
 __forceinline__ void PageTableBricksKernel< NodeTileRes, ChildAddressType, ChildKernelArrayType, DataAddressType, DataKernelArrayType, LocCodeArrayType, LocDepthArrayType >
 ::setPointerImpl( uint elemAddress, ElemAddressType elemPointer, uint flags )
 {
+	// If flags equals 3, it means that the brick has not been produced (ex : data not available yet).
+	// The node is left untouched, so that it still needs its brick and is requested again.
+	// The brick slot is not referenced, it will be recycled by the cache manager.
+	if ( flags == 3 )
+	{
+		return;
+	}
+
 	// XXX: Should be removed
 	ElemAddressType brickPointer = elemPointer + make_uint3( 1 ); // Warning: fixed border size !	=> QUESTION ??
 
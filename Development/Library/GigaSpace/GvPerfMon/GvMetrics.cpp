@@ -0,0 +1,416 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvPerfMon/GvMetrics.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <cstring>
+
+// System
+#include <cassert>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvPerfMon;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Flag to tell wheter or not metrics are collected
+ */
+bool GvMetrics::_isActivated = false;
+
+/**
+ * Unique instance
+ */
+GvMetrics* GvMetrics::_sInstance = NULL;
+
+/**
+ * Number of tries of a reader before giving up
+ */
+static const unsigned int cMaxNbReadTries = 64;
+
+/**
+ * Gauge names and descriptions (Prometheus)
+ */
+static const char* cGaugeNames[ GvMetrics::eNbGauges ][ 2 ] =
+{
+	{ "gigavoxels_renderer_elapsed_time_seconds", "Renderer time of the last frame." },
+	{ "gigavoxels_node_cache_usage_percent", "Usage of the node cache." },
+	{ "gigavoxels_brick_cache_usage_percent", "Usage of the brick cache." },
+	{ "gigavoxels_node_cache_capacity", "Capacity of the node cache." },
+	{ "gigavoxels_brick_cache_capacity", "Capacity of the brick cache." },
+	{ "gigavoxels_node_cache_unused", "Number of unused nodes in cache." },
+	{ "gigavoxels_brick_cache_unused", "Number of unused bricks in cache." },
+	{ "gigavoxels_tree_nodes", "Number of nodes of the data structure." },
+	{ "gigavoxels_tree_leaf_nodes", "Number of leaf nodes of the data structure." },
+	{ "gigavoxels_renderer_max_depth", "Max depth of the renderer." }
+};
+
+/**
+ * Histogram names and descriptions (Prometheus)
+ */
+static const char* cHistogramNames[ GvMetrics::eNbHistograms ][ 2 ] =
+{
+	{ "gigavoxels_frame_time_seconds", "Host time between the end of two frames." },
+	{ "gigavoxels_brick_loads_per_frame", "Number of brick load requests handled per frame." },
+	{ "gigavoxels_node_subdivisions_per_frame", "Number of node subdivision requests handled per frame." },
+	{ "gigavoxels_loader_io_latency_seconds", "Time to read one brick by data loaders." }
+};
+
+/**
+ * Default histogram bounds (milliseconds for times)
+ */
+static const double cFrameTimeBounds[] = { 1.0, 2.0, 4.0, 8.0, 16.0, 33.0, 50.0, 100.0, 200.0, 500.0, 1000.0 };
+static const double cRequestBounds[] = { 0.0, 1.0, 4.0, 16.0, 64.0, 256.0, 1024.0, 4096.0, 16384.0 };
+static const double cLoaderLatencyBounds[] = { 0.01, 0.05, 0.1, 0.5, 1.0, 5.0, 10.0, 50.0, 100.0, 500.0 };
+
+/**
+ * Memory barrier (the compiler and the CPU do not reorder memory accesses across it)
+ */
+#ifdef WIN32
+	#define GV_METRICS_MEMORY_BARRIER() MemoryBarrier()
+#else
+	#define GV_METRICS_MEMORY_BARRIER() __sync_synchronize()
+#endif
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/**
+ * Initialize a histogram
+ *
+ * @param pHistogram the histogram
+ * @param pBounds upper bounds of buckets
+ * @param pNbBounds number of bounds
+ */
+static void initializeHistogram( GvMetrics::Histogram& pHistogram, const double* pBounds, unsigned int pNbBounds )
+{
+	assert( pNbBounds <= GV_METRICS_MAX_NB_BUCKETS );
+
+	memset( &pHistogram, 0, sizeof( GvMetrics::Histogram ) );
+	pHistogram._nbBuckets = pNbBounds;
+	for ( unsigned int i = 0; i < pNbBounds; i++ )
+	{
+		pHistogram._bounds[ i ] = pBounds[ i ];
+	}
+}
+
+/**
+ * Tell whether or not a histogram records times
+ *
+ * @param pHistogram the histogram
+ *
+ * @return a flag telling whether or not the histogram records times
+ */
+static bool isTimeHistogram( unsigned int pHistogram )
+{
+	return pHistogram == GvMetrics::eFrameTime || pHistogram == GvMetrics::eLoaderLatency;
+}
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Get the unique instance
+ *
+ * Note : the first call must be done before any other thread uses the metrics.
+ *
+ * @return the metrics
+ ******************************************************************************/
+GvMetrics& GvMetrics::get()
+{
+	if ( _sInstance == NULL )
+	{
+		_sInstance = new GvMetrics();
+	}
+
+	return *_sInstance;
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvMetrics::GvMetrics()
+:	_lastSlot( 0 )
+,	_timer()
+,	_frameEvent()
+,	_hasFrameEvent( false )
+{
+	memset( &_current, 0, sizeof( Snapshot ) );
+	initializeHistogram( _current._histograms[ eFrameTime ], cFrameTimeBounds, sizeof( cFrameTimeBounds ) / sizeof( double ) );
+	initializeHistogram( _current._histograms[ eBrickLoadsPerFrame ], cRequestBounds, sizeof( cRequestBounds ) / sizeof( double ) );
+	initializeHistogram( _current._histograms[ eNodeSubdivisionsPerFrame ], cRequestBounds, sizeof( cRequestBounds ) / sizeof( double ) );
+	initializeHistogram( _current._histograms[ eLoaderLatency ], cLoaderLatencyBounds, sizeof( cLoaderLatencyBounds ) / sizeof( double ) );
+
+	_slots[ 0 ] = _current;
+	_slots[ 1 ] = _current;
+	_sequences[ 0 ] = 0;
+	_sequences[ 1 ] = 0;
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvMetrics::~GvMetrics()
+{
+}
+
+/******************************************************************************
+ * Set a gauge (render thread only)
+ *
+ * @param pGauge the gauge
+ * @param pValue the value
+ ******************************************************************************/
+void GvMetrics::setGauge( EGauge pGauge, double pValue )
+{
+	assert( pGauge < eNbGauges );
+
+	_current._gauges[ pGauge ] = pValue;
+}
+
+/******************************************************************************
+ * Add an observation to a histogram (render thread only)
+ *
+ * @param pHistogram the histogram
+ * @param pValue the value (in milliseconds for times)
+ ******************************************************************************/
+void GvMetrics::observe( EHistogram pHistogram, double pValue )
+{
+	assert( pHistogram < eNbHistograms );
+
+	Histogram& histogram = _current._histograms[ pHistogram ];
+
+	// Find the first bucket whose upper bound is greater or equal to the value
+	unsigned int bucket = 0;
+	while ( bucket < histogram._nbBuckets && pValue > histogram._bounds[ bucket ] )
+	{
+		bucket++;
+	}
+
+	histogram._counts[ bucket ]++;
+	histogram._sum += pValue;
+	histogram._count++;
+}
+
+/******************************************************************************
+ * Start timing an observation of a time histogram (render thread only)
+ *
+ * @param pEvent the timer event
+ ******************************************************************************/
+void GvMetrics::startTimer( GvPerformanceTimer::Event& pEvent ) const
+{
+	_timer.startEvent( pEvent );
+}
+
+/******************************************************************************
+ * Stop timing an observation and add it to a time histogram (render thread only)
+ *
+ * @param pHistogram the histogram
+ * @param pEvent the timer event
+ ******************************************************************************/
+void GvMetrics::stopTimer( EHistogram pHistogram, GvPerformanceTimer::Event& pEvent )
+{
+	_timer.stopEvent( pEvent );
+
+	observe( pHistogram, _timer.getEventDuration( pEvent ) );
+}
+
+/******************************************************************************
+ * Set the timing of a performance monitor event for the current frame (render thread only)
+ *
+ * @param pIndex index of the event
+ * @param pName name of the event (static string)
+ * @param pTime time of the event (in milliseconds)
+ * @param pNbCalls number of times the event occurred
+ ******************************************************************************/
+void GvMetrics::setEventTime( unsigned int pIndex, const char* pName, float pTime, unsigned int pNbCalls )
+{
+	if ( pIndex >= GV_METRICS_MAX_NB_EVENTS )
+	{
+		return;
+	}
+
+	Event& event = _current._events[ pIndex ];
+	event._name = pName;
+	event._time = pTime;
+	event._nbCalls = pNbCalls;
+	event._totalTime += pTime;
+
+	if ( pIndex >= _current._nbEvents )
+	{
+		_current._nbEvents = pIndex + 1;
+	}
+}
+
+/******************************************************************************
+ * End the current frame : record the frame time and publish all metrics (render thread only)
+ ******************************************************************************/
+void GvMetrics::endFrame()
+{
+	// Frame time (between the end of two frames)
+	if ( _hasFrameEvent )
+	{
+		_timer.stopEvent( _frameEvent );
+		observe( eFrameTime, _timer.getEventDuration( _frameEvent ) );
+	}
+	_timer.startEvent( _frameEvent );
+	_hasFrameEvent = true;
+
+	_current._nbFrames++;
+
+	// Publish in the slot that is not the last published one.
+	// Readers of this slot will see an odd or modified sequence number and retry.
+	const unsigned int slot = 1 - _lastSlot;
+	_sequences[ slot ]++;
+	GV_METRICS_MEMORY_BARRIER();
+	_slots[ slot ] = _current;
+	GV_METRICS_MEMORY_BARRIER();
+	_sequences[ slot ]++;
+	GV_METRICS_MEMORY_BARRIER();
+	_lastSlot = slot;
+}
+
+/******************************************************************************
+ * Get the last published metrics (any thread)
+ *
+ * @param pSnapshot the published metrics
+ *
+ * @return false if no consistent copy has been obtained (writer too fast)
+ ******************************************************************************/
+bool GvMetrics::getSnapshot( Snapshot& pSnapshot ) const
+{
+	for ( unsigned int i = 0; i < cMaxNbReadTries; i++ )
+	{
+		const unsigned int slot = _lastSlot;
+		GV_METRICS_MEMORY_BARRIER();
+		const unsigned int sequence = _sequences[ slot ];
+		if ( sequence & 1 )
+		{
+			// Slot is being written
+			continue;
+		}
+		GV_METRICS_MEMORY_BARRIER();
+		memcpy( &pSnapshot, &_slots[ slot ], sizeof( Snapshot ) );
+		GV_METRICS_MEMORY_BARRIER();
+		if ( _sequences[ slot ] == sequence )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * Write metrics in the Prometheus text format
+ *
+ * @param pSnapshot the metrics
+ * @param pStream the output stream
+ ******************************************************************************/
+void GvMetrics::writePrometheus( const Snapshot& pSnapshot, std::ostream& pStream )
+{
+	// Frames
+	pStream << "# HELP gigavoxels_frames_total Number of rendered frames." << std::endl;
+	pStream << "# TYPE gigavoxels_frames_total counter" << std::endl;
+	pStream << "gigavoxels_frames_total " << pSnapshot._nbFrames << std::endl;
+
+	// Gauges
+	for ( unsigned int i = 0; i < eNbGauges; i++ )
+	{
+		const double scale = ( i == eRendererElapsedTime ) ? 0.001 : 1.0;
+
+		pStream << "# HELP " << cGaugeNames[ i ][ 0 ] << " " << cGaugeNames[ i ][ 1 ] << std::endl;
+		pStream << "# TYPE " << cGaugeNames[ i ][ 0 ] << " gauge" << std::endl;
+		pStream << cGaugeNames[ i ][ 0 ] << " " << pSnapshot._gauges[ i ] * scale << std::endl;
+	}
+
+	// Histograms (buckets are cumulative in Prometheus)
+	for ( unsigned int i = 0; i < eNbHistograms; i++ )
+	{
+		const Histogram& histogram = pSnapshot._histograms[ i ];
+		const char* name = cHistogramNames[ i ][ 0 ];
+		const double scale = isTimeHistogram( i ) ? 0.001 : 1.0;
+
+		pStream << "# HELP " << name << " " << cHistogramNames[ i ][ 1 ] << std::endl;
+		pStream << "# TYPE " << name << " histogram" << std::endl;
+		unsigned long long count = 0;
+		for ( unsigned int bucket = 0; bucket < histogram._nbBuckets; bucket++ )
+		{
+			count += histogram._counts[ bucket ];
+			pStream << name << "_bucket{le=\"" << histogram._bounds[ bucket ] * scale << "\"} " << count << std::endl;
+		}
+		pStream << name << "_bucket{le=\"+Inf\"} " << histogram._count << std::endl;
+		pStream << name << "_sum " << histogram._sum * scale << std::endl;
+		pStream << name << "_count " << histogram._count << std::endl;
+	}
+
+	// Performance monitor events
+	if ( pSnapshot._nbEvents > 0 )
+	{
+		pStream << "# HELP gigavoxels_perfmon_event_seconds Time of performance monitor events during the last frame." << std::endl;
+		pStream << "# TYPE gigavoxels_perfmon_event_seconds gauge" << std::endl;
+		for ( unsigned int i = 0; i < pSnapshot._nbEvents; i++ )
+		{
+			const Event& event = pSnapshot._events[ i ];
+			if ( event._name != NULL )
+			{
+				pStream << "gigavoxels_perfmon_event_seconds{event=\"" << event._name << "\"} " << event._time * 0.001 << std::endl;
+			}
+		}
+		pStream << "# HELP gigavoxels_perfmon_event_calls Number of performance monitor events during the last frame." << std::endl;
+		pStream << "# TYPE gigavoxels_perfmon_event_calls gauge" << std::endl;
+		for ( unsigned int i = 0; i < pSnapshot._nbEvents; i++ )
+		{
+			const Event& event = pSnapshot._events[ i ];
+			if ( event._name != NULL )
+			{
+				pStream << "gigavoxels_perfmon_event_calls{event=\"" << event._name << "\"} " << event._nbCalls << std::endl;
+			}
+		}
+		pStream << "# HELP gigavoxels_perfmon_event_seconds_total Cumulated time of performance monitor events." << std::endl;
+		pStream << "# TYPE gigavoxels_perfmon_event_seconds_total counter" << std::endl;
+		for ( unsigned int i = 0; i < pSnapshot._nbEvents; i++ )
+		{
+			const Event& event = pSnapshot._events[ i ];
+			if ( event._name != NULL )
+			{
+				pStream << "gigavoxels_perfmon_event_seconds_total{event=\"" << event._name << "\"} " << event._totalTime * 0.001 << std::endl;
+			}
+		}
+	}
+}
@@ -0,0 +1,380 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_METRICS_H_
+#define _GV_METRICS_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+#include "GvPerfMon/GvPerformanceTimer.h"
+
+// STL
+#include <ostream>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Max number of buckets of a histogram (without the +Inf bucket)
+ */
+#define GV_METRICS_MAX_NB_BUCKETS 16
+
+/**
+ * Max number of performance monitor events
+ */
+#define GV_METRICS_MAX_NB_EVENTS 128
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvPerfMon
+{
+
+/** 
+ * @class GvMetrics
+ *
+ * @brief The GvMetrics class collects pipeline, cache and production counters
+ * and publishes them in the Prometheus text format.
+ *
+ * Collection is opt-in (see _isActivated) and is done by a single writer, the render thread :
+ * values are accumulated in a private snapshot and published at the end of each frame.
+ * Publication uses two slots protected by sequence numbers (seqlock), so the render thread
+ * never waits for a reader, and readers (e.g. the HTTP endpoint thread) retry if a slot
+ * has been modified during their copy.
+ *
+ * Times are given in milliseconds (as with the GigaVoxels timers) and exported in seconds.
+ */
+class GIGASPACE_EXPORT GvMetrics
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Gauges (last value of the frame)
+	 */
+	enum EGauge
+	{
+		eRendererElapsedTime = 0,
+		eNodeCacheUsage,
+		eBrickCacheUsage,
+		eNodeCacheCapacity,
+		eBrickCacheCapacity,
+		eCacheNbUnusedNodes,
+		eCacheNbUnusedBricks,
+		eNbTreeNodes,
+		eNbTreeLeafNodes,
+		eRendererMaxDepth,
+		eNbGauges
+	};
+
+	/**
+	 * Histograms
+	 */
+	enum EHistogram
+	{
+		eFrameTime = 0,
+		eBrickLoadsPerFrame,
+		eNodeSubdivisionsPerFrame,
+		eLoaderLatency,
+		eNbHistograms
+	};
+
+	/**
+	 * Histogram (buckets are not cumulative, the last one is the +Inf bucket)
+	 */
+	struct Histogram
+	{
+		/**
+		 * Number of buckets (without the +Inf bucket)
+		 */
+		unsigned int _nbBuckets;
+
+		/**
+		 * Upper bounds of buckets (in recorded unit, i.e. milliseconds for times)
+		 */
+		double _bounds[ GV_METRICS_MAX_NB_BUCKETS ];
+
+		/**
+		 * Number of observations in each bucket
+		 */
+		unsigned long long _counts[ GV_METRICS_MAX_NB_BUCKETS + 1 ];
+
+		/**
+		 * Sum of observations
+		 */
+		double _sum;
+
+		/**
+		 * Number of observations
+		 */
+		unsigned long long _count;
+	};
+
+	/**
+	 * Performance monitor event timing
+	 */
+	struct Event
+	{
+		/**
+		 * Event name (static string)
+		 */
+		const char* _name;
+
+		/**
+		 * Time of the event during the last frame (in milliseconds)
+		 */
+		float _time;
+
+		/**
+		 * Number of times the event occurred during the last frame
+		 */
+		unsigned int _nbCalls;
+
+		/**
+		 * Cumulated time of the event (in milliseconds)
+		 */
+		double _totalTime;
+	};
+
+	/**
+	 * Published state of all metrics
+	 */
+	struct Snapshot
+	{
+		/**
+		 * Number of published frames
+		 */
+		unsigned long long _nbFrames;
+
+		/**
+		 * Gauges
+		 */
+		double _gauges[ eNbGauges ];
+
+		/**
+		 * Histograms
+		 */
+		Histogram _histograms[ eNbHistograms ];
+
+		/**
+		 * Number of performance monitor events
+		 */
+		unsigned int _nbEvents;
+
+		/**
+		 * Performance monitor events
+		 */
+		Event _events[ GV_METRICS_MAX_NB_EVENTS ];
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Flag to tell wheter or not metrics are collected (deactivated by default)
+	 */
+	static bool _isActivated;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Get the unique instance
+	 *
+	 * @return the metrics
+	 */
+	static GvMetrics& get();
+
+	/**
+	 * Set a gauge (render thread only)
+	 *
+	 * @param pGauge the gauge
+	 * @param pValue the value
+	 */
+	void setGauge( EGauge pGauge, double pValue );
+
+	/**
+	 * Add an observation to a histogram (render thread only)
+	 *
+	 * @param pHistogram the histogram
+	 * @param pValue the value (in milliseconds for times)
+	 */
+	void observe( EHistogram pHistogram, double pValue );
+
+	/**
+	 * Start timing an observation of a time histogram (render thread only)
+	 *
+	 * @param pEvent the timer event
+	 */
+	void startTimer( GvPerformanceTimer::Event& pEvent ) const;
+
+	/**
+	 * Stop timing an observation and add it to a time histogram (render thread only)
+	 *
+	 * @param pHistogram the histogram
+	 * @param pEvent the timer event
+	 */
+	void stopTimer( EHistogram pHistogram, GvPerformanceTimer::Event& pEvent );
+
+	/**
+	 * Set the timing of a performance monitor event for the current frame (render thread only)
+	 *
+	 * @param pIndex index of the event
+	 * @param pName name of the event (static string)
+	 * @param pTime time of the event (in milliseconds)
+	 * @param pNbCalls number of times the event occurred
+	 */
+	void setEventTime( unsigned int pIndex, const char* pName, float pTime, unsigned int pNbCalls );
+
+	/**
+	 * End the current frame : record the frame time and publish all metrics (render thread only)
+	 */
+	void endFrame();
+
+	/**
+	 * Get the last published metrics (any thread)
+	 *
+	 * @param pSnapshot the published metrics
+	 *
+	 * @return false if no consistent copy has been obtained (writer too fast)
+	 */
+	bool getSnapshot( Snapshot& pSnapshot ) const;
+
+	/**
+	 * Write metrics in the Prometheus text format
+	 *
+	 * @param pSnapshot the metrics
+	 * @param pStream the output stream
+	 */
+	static void writePrometheus( const Snapshot& pSnapshot, std::ostream& pStream );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Unique instance
+	 */
+	static GvMetrics* _sInstance;
+
+	/**
+	 * Metrics of the render thread (not published yet)
+	 */
+	Snapshot _current;
+
+	/**
+	 * Published slots
+	 */
+	Snapshot _slots[ 2 ];
+
+	/**
+	 * Sequence numbers of published slots (odd while a slot is written)
+	 */
+	volatile unsigned int _sequences[ 2 ];
+
+	/**
+	 * Index of the last published slot
+	 */
+	volatile unsigned int _lastSlot;
+
+	/**
+	 * Host timer
+	 */
+	GvPerformanceTimer _timer;
+
+	/**
+	 * End of the previous frame
+	 */
+	GvPerformanceTimer::Event _frameEvent;
+
+	/**
+	 * Flag telling whether or not a frame has already ended
+	 */
+	bool _hasFrameEvent;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvMetrics();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvMetrics();
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvMetrics( const GvMetrics& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvMetrics& operator=( const GvMetrics& );
+
+};
+
+} // namespace GvPerfMon
+
+#endif // !_GV_METRICS_H_
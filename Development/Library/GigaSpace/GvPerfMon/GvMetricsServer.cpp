@@ -0,0 +1,342 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvPerfMon/GvMetricsServer.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvPerfMon/GvMetrics.h"
+
+// System
+#ifndef WIN32
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <arpa/inet.h>
+	#include <poll.h>
+	#include <unistd.h>
+	#include <cerrno>
+#endif
+
+// STL
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvPerfMon;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Timeout of the poll() loop (in milliseconds), used to check the stop flag
+ */
+static const int cPollTimeout = 200;
+
+/**
+ * Max size of an HTTP request header
+ */
+static const size_t cMaxRequestSize = 4096;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvMetricsServer::GvMetricsServer()
+:	_socket( -1 )
+,	_port( 0 )
+,	_stopRequested( false )
+,	_isRunning( false )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvMetricsServer::~GvMetricsServer()
+{
+	stop();
+}
+
+/******************************************************************************
+ * Start the server
+ *
+ * @param pPort the TCP port (0 to let the system choose one, see getPort())
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvMetricsServer::start( unsigned short pPort )
+{
+#ifndef WIN32
+	stop();
+
+	// Create the unique metrics instance before the server thread uses it
+	GvMetrics::get();
+
+	// Listen on the loopback interface only
+	_socket = socket( AF_INET, SOCK_STREAM, 0 );
+	if ( _socket < 0 )
+	{
+		std::cerr << "GvMetricsServer::start() : unable to create socket : " << strerror( errno ) << std::endl;
+		return false;
+	}
+	const int reuse = 1;
+	setsockopt( _socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof( reuse ) );
+
+	sockaddr_in address;
+	memset( &address, 0, sizeof( address ) );
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+	address.sin_port = htons( pPort );
+	if ( bind( _socket, reinterpret_cast< sockaddr* >( &address ), sizeof( address ) ) != 0 || listen( _socket, 8 ) != 0 )
+	{
+		std::cerr << "GvMetricsServer::start() : unable to listen on port " << pPort << " : " << strerror( errno ) << std::endl;
+		close( _socket );
+		_socket = -1;
+		return false;
+	}
+
+	// Retrieve the port chosen by the system
+	socklen_t addressLength = sizeof( address );
+	getsockname( _socket, reinterpret_cast< sockaddr* >( &address ), &addressLength );
+	_port = ntohs( address.sin_port );
+
+	// Start the server thread
+	_stopRequested = false;
+	if ( pthread_create( &_thread, NULL, &GvMetricsServer::threadEntry, this ) != 0 )
+	{
+		std::cerr << "GvMetricsServer::start() : unable to create the server thread" << std::endl;
+		close( _socket );
+		_socket = -1;
+		return false;
+	}
+	_isRunning = true;
+
+	// Start collecting metrics
+	GvMetrics::_isActivated = true;
+
+	std::cout << "GvMetricsServer : metrics available at http://127.0.0.1:" << _port << "/metrics" << std::endl;
+
+	return true;
+#else
+	std::cerr << "GvMetricsServer::start() : metrics server is not available on this platform" << std::endl;
+	return false;
+#endif
+}
+
+/******************************************************************************
+ * Stop the server and wait for its thread
+ ******************************************************************************/
+void GvMetricsServer::stop()
+{
+#ifndef WIN32
+	if ( _isRunning )
+	{
+		_stopRequested = true;
+		pthread_join( _thread, NULL );
+		_isRunning = false;
+	}
+	if ( _socket >= 0 )
+	{
+		close( _socket );
+		_socket = -1;
+	}
+#endif
+}
+
+/******************************************************************************
+ * Tell wheter or not the server is running
+ *
+ * @return a flag telling wheter or not the server is running
+ ******************************************************************************/
+bool GvMetricsServer::isRunning() const
+{
+	return _isRunning;
+}
+
+/******************************************************************************
+ * Get the TCP port the server listens to
+ *
+ * @return the TCP port
+ ******************************************************************************/
+unsigned short GvMetricsServer::getPort() const
+{
+	return _port;
+}
+
+/******************************************************************************
+ * Entry point of the server thread
+ *
+ * @param pServer the server
+ *
+ * @return NULL
+ ******************************************************************************/
+void* GvMetricsServer::threadEntry( void* pServer )
+{
+	static_cast< GvMetricsServer* >( pServer )->run();
+
+	return NULL;
+}
+
+/******************************************************************************
+ * Main loop of the server thread
+ ******************************************************************************/
+void GvMetricsServer::run()
+{
+#ifndef WIN32
+	while ( ! _stopRequested )
+	{
+		pollfd fileDescriptor;
+		fileDescriptor.fd = _socket;
+		fileDescriptor.events = POLLIN;
+		fileDescriptor.revents = 0;
+		const int result = poll( &fileDescriptor, 1, cPollTimeout );
+		if ( result < 0 && errno != EINTR )
+		{
+			std::cerr << "GvMetricsServer::run() : poll failed : " << strerror( errno ) << std::endl;
+			break;
+		}
+		if ( result <= 0 )
+		{
+			continue;
+		}
+
+		const int connection = accept( _socket, NULL, NULL );
+		if ( connection >= 0 )
+		{
+			handleConnection( connection );
+			close( connection );
+		}
+	}
+#endif
+}
+
+/******************************************************************************
+ * Answer one HTTP request
+ *
+ * @param pSocket the connected socket
+ ******************************************************************************/
+void GvMetricsServer::handleConnection( int pSocket )
+{
+#ifndef WIN32
+	// Read the request header (the body, if any, is ignored)
+	std::string request;
+	char buffer[ 512 ];
+	while ( request.find( "\r\n\r\n" ) == std::string::npos && request.size() < cMaxRequestSize )
+	{
+		pollfd fileDescriptor;
+		fileDescriptor.fd = pSocket;
+		fileDescriptor.events = POLLIN;
+		fileDescriptor.revents = 0;
+		if ( poll( &fileDescriptor, 1, cPollTimeout ) <= 0 )
+		{
+			// Slow or silent client
+			return;
+		}
+		const ssize_t size = recv( pSocket, buffer, sizeof( buffer ), 0 );
+		if ( size <= 0 )
+		{
+			return;
+		}
+		request.append( buffer, static_cast< size_t >( size ) );
+	}
+
+	// Request line : "<method> <path> HTTP/1.x"
+	std::istringstream requestLine( request.substr( 0, request.find( "\r\n" ) ) );
+	std::string method;
+	std::string path;
+	requestLine >> method >> path;
+
+	std::string status = "200 OK";
+	std::string contentType = "text/plain; version=0.0.4; charset=utf-8";
+	std::ostringstream body;
+	if ( method != "GET" )
+	{
+		status = "405 Method Not Allowed";
+		contentType = "text/plain";
+		body << "Method not allowed" << std::endl;
+	}
+	else if ( path != "/metrics" )
+	{
+		status = "404 Not Found";
+		contentType = "text/plain";
+		body << "Metrics are available at /metrics" << std::endl;
+	}
+	else
+	{
+		GvMetrics::Snapshot* snapshot = new GvMetrics::Snapshot();
+		if ( GvMetrics::get().getSnapshot( *snapshot ) )
+		{
+			GvMetrics::writePrometheus( *snapshot, body );
+		}
+		else
+		{
+			status = "503 Service Unavailable";
+			contentType = "text/plain";
+			body << "Metrics are being updated, retry later" << std::endl;
+		}
+		delete snapshot;
+	}
+
+	// Response
+	const std::string content = body.str();
+	std::ostringstream response;
+	response << "HTTP/1.0 " << status << "\r\n"
+		<< "Content-Type: " << contentType << "\r\n"
+		<< "Content-Length: " << content.size() << "\r\n"
+		<< "Connection: close\r\n"
+		<< "\r\n"
+		<< content;
+
+	const std::string data = response.str();
+	size_t offset = 0;
+	while ( offset < data.size() )
+	{
+		const ssize_t size = send( pSocket, data.c_str() + offset, data.size() - offset, MSG_NOSIGNAL );
+		if ( size <= 0 )
+		{
+			break;
+		}
+		offset += static_cast< size_t >( size );
+	}
+#endif
+}
@@ -0,0 +1,207 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_METRICS_SERVER_H_
+#define _GV_METRICS_SERVER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+
+// System
+#ifndef WIN32
+	#include <pthread.h>
+#endif
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvPerfMon
+{
+
+/**
+ * @class GvMetricsServer
+ *
+ * @brief The GvMetricsServer class provides an embedded HTTP endpoint
+ * publishing GvMetrics in the Prometheus text format.
+ *
+ * The server is bound to the loopback interface only (127.0.0.1) and answers
+ * "GET /metrics" requests from its own thread. It only reads published snapshots,
+ * so it never blocks the render thread.
+ *
+ * Starting the server activates metrics collection (see GvMetrics::_isActivated).
+ * Only available on POSIX systems (start() fails on other systems).
+ */
+class GIGASPACE_EXPORT GvMetricsServer
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvMetricsServer();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvMetricsServer();
+
+	/**
+	 * Start the server
+	 *
+	 * @param pPort the TCP port (0 to let the system choose one, see getPort())
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool start( unsigned short pPort );
+
+	/**
+	 * Stop the server and wait for its thread
+	 */
+	void stop();
+
+	/**
+	 * Tell wheter or not the server is running
+	 *
+	 * @return a flag telling wheter or not the server is running
+	 */
+	bool isRunning() const;
+
+	/**
+	 * Get the TCP port the server listens to
+	 *
+	 * @return the TCP port
+	 */
+	unsigned short getPort() const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Listening socket
+	 */
+	int _socket;
+
+	/**
+	 * TCP port
+	 */
+	unsigned short _port;
+
+	/**
+	 * Flag telling the thread to stop
+	 */
+	volatile bool _stopRequested;
+
+	/**
+	 * Flag telling wheter or not the server is running
+	 */
+	bool _isRunning;
+
+#ifndef WIN32
+	/**
+	 * Server thread
+	 */
+	pthread_t _thread;
+#endif
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Main loop of the server thread
+	 */
+	void run();
+
+	/**
+	 * Answer one HTTP request
+	 *
+	 * @param pSocket the connected socket
+	 */
+	void handleConnection( int pSocket );
+
+	/**
+	 * Entry point of the server thread
+	 *
+	 * @param pServer the server
+	 *
+	 * @return NULL
+	 */
+	static void* threadEntry( void* pServer );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvMetricsServer( const GvMetricsServer& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvMetricsServer& operator=( const GvMetricsServer& );
+
+};
+
+} // namespace GvPerfMon
+
+#endif // !_GV_METRICS_SERVER_H_
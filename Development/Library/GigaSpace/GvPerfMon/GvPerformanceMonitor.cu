@@ -32,6 +32,7 @@
 
 // GigaVoxels
 #include "GvCore/functional_ext.h"
+#include "GvPerfMon/GvMetrics.h"
 
 // STL
 #include <iostream>
@@ -337,6 +338,22 @@ void CUDAPerfMon::stopFrame()
 
 	cudaDeviceSynchronize();
 
+	// Publish event timings to the metrics endpoint (if activated)
+	if ( GvMetrics::_isActivated )
+	{
+		GvMetrics& metrics = GvMetrics::get();
+		for ( uint evt = 0; evt < NumApplicationEvents; ++evt )
+		{
+			float time = 0.0f;
+			for ( int ii = 0; ii <= frameCurrentInstance[ evt ] && ii < CUDAPERFMON_GPU_TIMER_MAX_INSTANCES; ++ii )
+			{
+				time += _deviceTimer.getEventDuration( _deviceEvents[ evt ][ ii ] );
+			}
+			const unsigned int nbCalls = ( frameCurrentInstance[ evt ] >= 0 ) ? static_cast< unsigned int >( frameCurrentInstance[ evt ] + 1 ) : 0;
+			metrics.setEventTime( evt, _eventNames[ evt ], time, nbCalls );
+		}
+	}
+
 	_frameStarted = false;
 }
 
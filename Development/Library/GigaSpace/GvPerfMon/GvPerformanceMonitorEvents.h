@@ -104,6 +104,7 @@ CUDAPM_DEFINE_EVENT( dataProduction_handleRequests )
 CUDAPM_DEFINE_EVENT( dataProduction_manageRequests )
 CUDAPM_DEFINE_EVENT( dataProduction_manageRequests_createMask ) // not used...
 CUDAPM_DEFINE_EVENT( dataProduction_manageRequests_elemsReduction )
+CUDAPM_DEFINE_EVENT( dataProduction_manageRequests_selectRequests )
 CUDAPM_DEFINE_EVENT( dataProduction_manageRequests_my_copy_if_0 ) // not used...
 CUDAPM_DEFINE_EVENT( dataProduction_manageRequests_my_copy_if_1 ) // not used...
 CUDAPM_DEFINE_EVENT( dataProduction_manageRequests_my_copy_if_2 ) // not used...
@@ -144,6 +144,11 @@ __forceinline__ void GvNodeVisitorKernel::visit(
 
 		// ---- Emit requests if needed (node subdivision or brick loading/producing) ----
 
+		// The priority of a request is its screen-space error : the size of the node voxels
+		// relative to the cone aperture (i.e. the pixel footprint at the sample distance).
+		// It is used to handle the most important requests first when the budget is exceeded.
+		const float requestPriority = voxelSizeTree / pConeAperture;
+
 		// Process requests based on traversal strategy (priority on bricks or nodes)
 		if ( priorityOnBrick )
 		{
@@ -151,11 +156,13 @@ __forceinline__ void GvNodeVisitorKernel::visit(
 			if ( ( pNode.isBrick() && !pNode.hasBrick() ) || !( pNode.isInitializated() ) )
 			{
 				pGpuCache.loadRequest( nodeAddress );
+				pGpuCache.setRequestPriority( nodeAddress, requestPriority );
 				pRequestEmitted = true;
 			}
 			else if ( !pNode.hasSubNodes() && descentSizeCriteria && !pNode.isTerminal() )
 			{
 				pGpuCache.subDivRequest( nodeAddress );
+				pGpuCache.setRequestPriority( nodeAddress, requestPriority );
 				pRequestEmitted = true;
 			}
 		}
@@ -166,12 +173,14 @@ __forceinline__ void GvNodeVisitorKernel::visit(
 				if ( ! pNode.hasSubNodes() )
 				{
 					pGpuCache.subDivRequest( nodeAddress );
+					pGpuCache.setRequestPriority( nodeAddress, requestPriority );
 					pRequestEmitted = true;
 				}
 			}
 			else if ( ( pNode.isBrick() && !pNode.hasBrick() ) || !( pNode.isInitializated() ) )
 			{
 				pGpuCache.loadRequest( nodeAddress );
+				pGpuCache.setRequestPriority( nodeAddress, requestPriority );
 				pRequestEmitted = true;
 			}
 		}
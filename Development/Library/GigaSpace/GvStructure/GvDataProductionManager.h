@@ -47,6 +47,7 @@
 // Thrust
 #include <thrust/device_vector.h>
 #include <thrust/copy.h>
+#include <thrust/fill.h>
 
 // GigaSpace
 #include "GvStructure/GvIDataProductionManager.h"
@@ -62,10 +63,13 @@
 #include "GvCore/GPUVoxelProducer.h"
 #include "GvCore/GvLocalizationInfo.h"
 #include "GvCache/GvCacheManager.h"
+#include "GvCache/GvRequestSelector.h"
+#include "GvCache/GvPoolRemapper.h"
 //#include "GvCache/GvNodeCacheManager.h"
 #include "GvPerfMon/GvPerformanceMonitor.h"
 #include "GvStructure/GvVolumeTreeAddressType.h"
 #include "GvStructure/GvDataProductionManagerKernel.h"
+#include "GvStructure/GvProductionInfoKernel.h"
 
 #if USE_CUDPP_LIBRARY
 	// cudpp
@@ -271,6 +275,90 @@ public:
 	 */
 	typedef GvCore::GvIProvider ProducerType;
 
+	/**
+	 * Type definition of the data type list of the data structure
+	 */
+	typedef typename TDataStructure::DataTypeList DataTypeList;
+
+	/**
+	 * Type definition of a host copy of the data pool
+	 */
+	typedef GvCore::GPUPoolHost< GvCore::Array3D, DataTypeList > HostDataPoolType;
+
+	/**
+	 * @struct HostCacheContent
+	 *
+	 * @brief The HostCacheContent struct provides a host copy of the content of the cache
+	 * (node pool, data pool and element lists of the cache managers).
+	 *
+	 * It is used to keep resident nodes and bricks when pools are reallocated
+	 * (see storeContent() and restoreContent()).
+	 */
+	struct HostCacheContent
+	{
+		/**
+		 * Child array of the node pool
+		 */
+		std::vector< uint > _childArray;
+
+		/**
+		 * Data array of the node pool
+		 */
+		std::vector< uint > _dataArray;
+
+		/**
+		 * Localization codes of node tiles
+		 */
+		std::vector< GvCore::GvLocalizationInfo::CodeType > _localizationCodes;
+
+		/**
+		 * Localization depths of node tiles
+		 */
+		std::vector< GvCore::GvLocalizationInfo::DepthType > _localizationDepths;
+
+		/**
+		 * Element list of the nodes cache manager
+		 */
+		std::vector< uint > _nodeTileList;
+
+		/**
+		 * Element list of the bricks cache manager
+		 */
+		std::vector< uint > _brickList;
+
+		/**
+		 * Resolution of the brick pool (in bricks)
+		 */
+		uint3 _brickPoolResolution;
+
+		/**
+		 * Data pool
+		 */
+		HostDataPoolType* _dataPool;
+
+		/**
+		 * Constructor
+		 */
+		HostCacheContent();
+
+		/**
+		 * Destructor
+		 */
+		~HostCacheContent();
+
+	private:
+
+		/**
+		 * Copy constructor forbidden.
+		 */
+		HostCacheContent( const HostCacheContent& );
+
+		/**
+		 * Copy operator forbidden.
+		 */
+		HostCacheContent& operator=( const HostCacheContent& );
+	};
+
 	/******************************* ATTRIBUTES *******************************/
 
 	/**
@@ -494,6 +582,91 @@ public:
 	 */
 	void setProductionTimeLimit( float pTime );
 
+	/**
+	 * Get the flag telling whether or not requests are handled by priority.
+	 *
+	 * @return the flag telling whether or not requests are handled by priority
+	 */
+	bool hasRequestPriorities() const;
+
+	/**
+	 * Set the flag telling whether or not requests are handled by priority.
+	 * When the number of requests exceeds the max number of node subdivisions
+	 * or brick loads, the requests with the highest screen-space error are handled first
+	 * (instead of the first ones in node pool order).
+	 *
+	 * @param pFlag the flag value
+	 */
+	void useRequestPriorities( bool pFlag );
+
+	/**
+	 * Invalidate only the nodes whose data has changed in the producer
+	 * (i.e. a time-varying dataset moving to another time step), instead of clearing the whole cache.
+	 * Their bricks are loaded again at next rendering passes, and nodes without subnodes are produced again.
+	 *
+	 * Nodes are given by their localization info packed as Morton keys (see GvCore::GvMortonCode::encodeNode()).
+	 *
+	 * @param pNodeKeys Morton keys of the nodes to invalidate (not necessarily sorted)
+	 */
+	void invalidateNodes( const std::vector< GvCore::GvMortonCode::ValueType >& pNodeKeys );
+
+	/**
+	 * Get the flag telling whether or not production info of nodes and bricks is recorded.
+	 *
+	 * @return the flag telling whether or not production info is recorded
+	 */
+	bool hasProductionInfo() const;
+
+	/**
+	 * Set the flag telling whether or not production info of nodes and bricks is recorded
+	 * (see GvProductionInfo). Producers record it with the device-side object returned
+	 * by getProductionInfoKernelObject().
+	 *
+	 * @param pFlag the flag value
+	 */
+	void useProductionInfo( bool pFlag );
+
+	/**
+	 * Get the device-side object used by producers to record production info
+	 *
+	 * @return the device-side object (its arrays are NULL when production info is not recorded)
+	 */
+	GvProductionInfoKernel getProductionInfoKernelObject() const;
+
+	/**
+	 * Invalidate only the nodes and bricks whose production depends on an edited parameter
+	 * (i.e. a transfer function, noise or clipping parameter), instead of clearing the whole cache.
+	 * Elements whose dependency tags contain one of the given tags and whose value range overlaps
+	 * the given range are produced again, everything else stays resident.
+	 *
+	 * When production info is not recorded, the whole cache is cleared.
+	 *
+	 * @param pMinValue min value of the range of values whose result has changed
+	 * @param pMaxValue max value of the range of values whose result has changed
+	 * @param pDependencyTags tags of the edited parameters
+	 */
+	void invalidateDependentData( float pMinValue, float pMaxValue, uint pDependencyTags = GV_PRODUCTION_INFO_ALL_DEPENDENCIES );
+
+	/**
+	 * Copy the content of the cache on the host (node pool, data pool and element lists),
+	 * before pools are reallocated with another size.
+	 *
+	 * @param pContent the resulting host copy
+	 */
+	void storeContent( HostCacheContent& pContent );
+
+	/**
+	 * Fill the cache with the content of a cache whose pools had another size.
+	 * Resident node tiles and bricks are copied, the most recently used ones first if they don't fit,
+	 * and their addresses are remapped in the node pool and in the element lists (see GvCache::GvPoolRemapper).
+	 * Dropped nodes and bricks are produced again at next rendering passes.
+	 *
+	 * The cache must be empty (i.e. just created), production info is not restored.
+	 *
+	 * @param pContent the host copy of the previous cache
+	 */
+	void restoreContent( const HostCacheContent& pContent );
+
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
 	 **************************************************************************/
@@ -502,6 +675,59 @@ protected:
 
 	/****************************** INNER TYPES *******************************/
 
+	/**
+	 * Functor used to copy each channel of the data pool on the host
+	 */
+	struct DataChannelStorer
+	{
+		/**
+		 * Data pool of the data structure
+		 */
+		typename TDataStructure::DataPoolType* _dataPool;
+
+		/**
+		 * Host copy of the data pool
+		 */
+		HostDataPoolType* _hostDataPool;
+
+		/**
+		 * Copy a channel
+		 *
+		 * @param Loki::Int2Type< TChannelIndex > index of the channel (i.e. color, normal, etc...)
+		 */
+		template< int TChannelIndex >
+		inline void run( Loki::Int2Type< TChannelIndex > );
+	};
+
+	/**
+	 * Functor used to copy the kept bricks of each channel of a host copy in the data pool
+	 */
+	struct DataChannelRestorer
+	{
+		/**
+		 * Host copy of the previous data pool
+		 */
+		HostDataPoolType* _hostDataPool;
+
+		/**
+		 * Data pool of the data structure
+		 */
+		typename TDataStructure::DataPoolType* _dataPool;
+
+		/**
+		 * Bricks to copy (previous and new packed addresses)
+		 */
+		const std::vector< GvCache::GvPoolRemapper::ElementMapping >* _brickMappings;
+
+		/**
+		 * Copy the kept bricks of a channel
+		 *
+		 * @param Loki::Int2Type< TChannelIndex > index of the channel (i.e. color, normal, etc...)
+		 */
+		template< int TChannelIndex >
+		inline void run( Loki::Int2Type< TChannelIndex > );
+	};
+
 	/******************************* ATTRIBUTES *******************************/
 
 	///**
@@ -650,8 +876,58 @@ protected:
 	 */
 	bool _lastProductionTimed;
 
+	/**
+	 * Flag indicating whether or not requests are handled by priority
+	 */
+	bool _hasRequestPriorities;
+
+	/**
+	 * Priority buffer array (allocated when requests are handled by priority)
+	 *
+	 * Buffer used to store the priority of the requests of the update buffer
+	 */
+	GvCore::Array3DGPULinear< uint >* _requestPriorityArray;
+
+	/**
+	 * Priority buffer compact list
+	 *
+	 * Buffer resulting from the "_requestPriorityArray stream compaction",
+	 * with priorities in the same order as requests in "_updateBufferCompactList"
+	 */
+	thrust::device_vector< uint >* _requestPriorityCompactList;
+
+	/**
+	 * Selector of the requests with the highest priorities
+	 */
+	GvCache::GvRequestSelector _requestSelector;
+
+	/**
+	 * Host copy of the compacted requests
+	 */
+	std::vector< uint > _requests;
+
+	/**
+	 * Host copy of the priorities of the compacted requests
+	 */
+	std::vector< float > _requestPriorities;
+
+	/**
+	 * Production info of nodes (allocated when production info is recorded)
+	 */
+	thrust::device_vector< GvProductionInfo >* _nodeProductionInfos;
+
+	/**
+	 * Production info of bricks (allocated when production info is recorded)
+	 */
+	thrust::device_vector< GvProductionInfo >* _brickProductionInfos;
+
 	/******************************** METHODS *********************************/
 
+	/**
+	 * Reset production info : elements depend on all parameters and all values
+	 */
+	void resetProductionInfo();
+
 	/**
 	 * Update time stamps
 	 */
@@ -664,6 +940,14 @@ protected:
 	 */
 	virtual uint manageUpdates();
 
+	/**
+	 * This method moves the requests with the highest priorities within the budget
+	 * at the front of the compacted list of requests (if the budget is exceeded).
+	 *
+	 * @param pNbRequests the number of requests in the compacted list (of any kind)
+	 */
+	virtual void selectRequests( uint pNbRequests );
+
 	/**
 	 * This method handle the subdivisions requests.
 	 *
@@ -49,6 +49,11 @@
 
 // System
 #include <cassert>
+#include <cfloat>
+
+// STL
+#include <algorithm>
+#include <cstring>
 
 /******************************************************************************
  ****************************** INLINE DEFINITION *****************************
@@ -88,6 +93,14 @@ GvDataProductionManager< TDataStructure >
 ,	_totalBrickProductionTime( 0.f )
 ,	_totalProducedBricks( 0u )
 ,	_totalProducedNodes( 0u )
+,	_hasRequestPriorities( false )
+,	_requestPriorityArray( NULL )
+,	_requestPriorityCompactList( NULL )
+,	_requestSelector()
+,	_requests()
+,	_requestPriorities()
+,	_nodeProductionInfos( NULL )
+,	_brickProductionInfos( NULL )
 {
 	// Reference on a data structure
 	_dataStructure = pDataStructure;
@@ -129,6 +142,7 @@ GvDataProductionManager< TDataStructure >
 
 	// Device-side cache manager initialization
 	_dataProductionManagerKernel._updateBufferArray = this->_updateBufferArray->getDeviceArray();
+	_dataProductionManagerKernel._hasRequestPriorities = false;
 	_dataProductionManagerKernel._nodeCacheManager = this->_nodesCacheManager->getKernelObject();
 	_dataProductionManagerKernel._brickCacheManager = this->_bricksCacheManager->getKernelObject();
 
@@ -183,6 +197,10 @@ GvDataProductionManager< TDataStructure >
 
 	delete _updateBufferArray;
 	delete _updateBufferCompactList;
+	delete _requestPriorityArray;
+	delete _requestPriorityCompactList;
+	delete _nodeProductionInfos;
+	delete _brickProductionInfos;
 
 #if USE_CUDPP_LIBRARY
 	GV_CUDA_SAFE_CALL( cudaFree( _d_nbValidRequests ) );
@@ -214,6 +232,16 @@ void GvDataProductionManager< TDataStructure >
 	_updateBufferArray->fillAsync( 0 );	// TO DO : with a kernel instead of cudaMemSet(), copy engine could overlap
 #endif
 
+	// Clear request priorities
+	if ( _hasRequestPriorities )
+	{
+#ifndef GS_USE_OPTIMIZED_NON_BLOCKING_ASYNCHRONOUS_CALLS_PIPELINE_DATAPRODUCTIONMANAGER
+		_requestPriorityArray->fill( 0 );
+#else
+		_requestPriorityArray->fillAsync( 0 );
+#endif
+	}
+
 	// Number of requests cache has handled
 	//_nbNodeSubdivisionRequests = 0;
 	//_nbBrickLoadRequests = 0;
@@ -334,6 +362,12 @@ uint GvDataProductionManager< TDataStructure >
 
 		// [ 1 ] - Handle the "subdivide nodes" requests
 
+		// Handle the most important requests first when the budget is exceeded
+		if ( _hasRequestPriorities )
+		{
+			selectRequests( nbRequests );
+		}
+
 		// Limit production according to the time limit.
 		// First, do as if all the requests were node subdivisions
 		if ( _lastProductionTimed )
@@ -443,6 +477,12 @@ void GvDataProductionManager< TDataStructure >
 	_bricksCacheManager->clearCache();
 	_bricksCacheManager->_totalNumLoads = 0;
 	_bricksCacheManager->_lastNumLoads = 0;
+
+	// Reset production info
+	if ( _nodeProductionInfos != NULL )
+	{
+		resetProductionInfo();
+	}
 }
 
 /******************************************************************************
@@ -667,6 +707,60 @@ uint GvDataProductionManager< TDataStructure >
 	return nbElements;
 }
 
+/******************************************************************************
+ * This method moves the requests with the highest priorities within the budget
+ * at the front of the compacted list of requests (if the budget is exceeded).
+ *
+ * Requests are compacted on device, and selected on host (see GvRequestSelector) :
+ * only the requests of the frame are transferred, and only when the budget is exceeded.
+ *
+ * @param pNbRequests the number of requests in the compacted list (of any kind)
+ ******************************************************************************/
+template< typename TDataStructure >
+void GvDataProductionManager< TDataStructure >
+::selectRequests( uint pNbRequests )
+{
+	if ( pNbRequests == 0 )
+	{
+		return;
+	}
+
+	CUDAPM_START_EVENT( dataProduction_manageRequests_selectRequests );
+
+	// Retrieve requests
+	_requests.resize( pNbRequests );
+	GV_CUDA_SAFE_CALL( cudaMemcpy( &_requests[ 0 ], thrust::raw_pointer_cast( &(*_updateBufferCompactList)[ 0 ] ), pNbRequests * sizeof( uint ), cudaMemcpyDeviceToHost ) );
+
+	// Check budget (there is nothing to do if all requests are handled)
+	_requestSelector.setBudget( DataProductionManagerKernelType::VTC_REQUEST_SUBDIV, _maxNbNodeSubdivisions );
+	_requestSelector.setBudget( DataProductionManagerKernelType::VTC_REQUEST_LOAD, _maxNbBrickLoads );
+	if ( _requestSelector.isOverBudget( &_requests[ 0 ], pNbRequests ) )
+	{
+		// Compact priorities the same way as requests (same elements of the update buffer)
+		uint totalNbElements = _nodePoolRes.x * _nodePoolRes.y * _nodePoolRes.z;
+		if ( _nodesCacheManager->_totalNumLoads < _nodesCacheManager->getNumElements() )
+		{
+			totalNbElements = ( _nodesCacheManager->_totalNumLoads ) * NodeTileRes::getNumElements();
+		}
+		thrust::copy_if(
+			/*first input*/thrust::device_ptr< uint >( _requestPriorityArray->getPointer( 0 ) ),
+			/*last input*/thrust::device_ptr< uint >( _requestPriorityArray->getPointer( 0 ) ) + totalNbElements,
+			/*stencil*/thrust::device_ptr< uint >( _updateBufferArray->getPointer( 0 ) ),
+			/*output*/_requestPriorityCompactList->begin(), /*predicate*/GvCore::not_equal_to_zero< uint >() );
+		GV_CHECK_CUDA_ERROR( "selectRequests" );
+
+		// Retrieve priorities (stored as float bits)
+		_requestPriorities.resize( pNbRequests );
+		GV_CUDA_SAFE_CALL( cudaMemcpy( &_requestPriorities[ 0 ], thrust::raw_pointer_cast( &(*_requestPriorityCompactList)[ 0 ] ), pNbRequests * sizeof( float ), cudaMemcpyDeviceToHost ) );
+
+		// Move the selected requests at the front of the list
+		_requestSelector.select( &_requests[ 0 ], &_requestPriorities[ 0 ], pNbRequests );
+		GV_CUDA_SAFE_CALL( cudaMemcpy( thrust::raw_pointer_cast( &(*_updateBufferCompactList)[ 0 ] ), &_requests[ 0 ], pNbRequests * sizeof( uint ), cudaMemcpyHostToDevice ) );
+	}
+
+	CUDAPM_STOP_EVENT( dataProduction_manageRequests_selectRequests );
+}
+
 /******************************************************************************
  * This method handle the subdivisions requests.
  *
@@ -1028,5 +1122,397 @@ void GvDataProductionManager< TDataStructure >::setProductionTimeLimit( float pT
 	_productionTimeLimit = pTime;
 }
 
+/******************************************************************************
+ * Get the flag telling whether or not requests are handled by priority.
+ *
+ * @return the flag telling whether or not requests are handled by priority
+ ******************************************************************************/
+template< typename TDataStructure >
+bool GvDataProductionManager< TDataStructure >::hasRequestPriorities() const
+{
+	return _hasRequestPriorities;
+}
+
+/******************************************************************************
+ * Set the flag telling whether or not requests are handled by priority.
+ * When the number of requests exceeds the max number of node subdivisions
+ * or brick loads, the requests with the highest screen-space error are handled first
+ * (instead of the first ones in node pool order).
+ *
+ * @param pFlag the flag value
+ ******************************************************************************/
+template< typename TDataStructure >
+void GvDataProductionManager< TDataStructure >::useRequestPriorities( bool pFlag )
+{
+	// Priority buffers are only allocated when used
+	if ( pFlag && _requestPriorityArray == NULL )
+	{
+		_requestPriorityArray = new GvCore::Array3DGPULinear< uint >( _nodePoolRes );
+		_requestPriorityArray->fill( 0 );
+		_requestPriorityCompactList = new thrust::device_vector< uint >( _nodePoolRes.x * _nodePoolRes.y * _nodePoolRes.z );
+
+		_dataProductionManagerKernel._requestPriorityArray = _requestPriorityArray->getDeviceArray();
+	}
+
+	_hasRequestPriorities = pFlag;
+	_dataProductionManagerKernel._hasRequestPriorities = pFlag;
+}
+
+/******************************************************************************
+ * Invalidate only the nodes whose data has changed in the producer
+ * (i.e. a time-varying dataset moving to another time step), instead of clearing the whole cache.
+ * Their bricks are loaded again at next rendering passes, and nodes without subnodes are produced again.
+ *
+ * Nodes are given by their localization info packed as Morton keys (see GvCore::GvMortonCode::encodeNode()).
+ *
+ * @param pNodeKeys Morton keys of the nodes to invalidate (not necessarily sorted)
+ ******************************************************************************/
+template< typename TDataStructure >
+void GvDataProductionManager< TDataStructure >
+::invalidateNodes( const std::vector< GvCore::GvMortonCode::ValueType >& pNodeKeys )
+{
+	if ( pNodeKeys.empty() )
+	{
+		return;
+	}
+
+	// Keys are inserted in a spatial hash (with its CPU implementation) to be found in O(1) in the kernel.
+	// Number of slots : power of two, with a load factor under 0.5
+	uint capacity = 1;
+	while ( capacity < 2 * pNodeKeys.size() )
+	{
+		capacity <<= 1;
+	}
+	std::vector< GvCore::GvMortonCode::ValueType > keys( capacity, GV_SPATIAL_HASH_EMPTY_KEY );
+	std::vector< uint > values( capacity, GV_SPATIAL_HASH_INVALID_VALUE );
+	GvSpatialHashKernel< NodeTileRes > invalidatedNodes;
+	invalidatedNodes._keys = &keys[ 0 ];
+	invalidatedNodes._values = &values[ 0 ];
+	invalidatedNodes._capacityMask = capacity - 1;
+	for ( size_t i = 0; i < pNodeKeys.size(); i++ )
+	{
+		// Keys of nodes that can't be encoded are 0 (see GvCore::GvMortonCode::encodeNode())
+		if ( pNodeKeys[ i ] != GV_SPATIAL_HASH_EMPTY_KEY && pNodeKeys[ i ] != GV_SPATIAL_HASH_DELETED_KEY )
+		{
+			invalidatedNodes.insert( pNodeKeys[ i ], static_cast< uint >( i ) );
+		}
+	}
+	thrust::device_vector< GvCore::GvMortonCode::ValueType > d_keys( keys.begin(), keys.end() );
+	thrust::device_vector< uint > d_values( values.begin(), values.end() );
+	invalidatedNodes._keys = thrust::raw_pointer_cast( &d_keys[ 0 ] );
+	invalidatedNodes._values = thrust::raw_pointer_cast( &d_values[ 0 ] );
+
+	// Only the node tiles that have been produced are processed
+	const uint nbNodes = std::min( _nodesCacheManager->_totalNumLoads, _nodesCacheManager->getNumElements() ) * NodeTileRes::getNumElements();
+
+	// Set kernel execution configuration
+	dim3 blockSize( 64, 1, 1 );
+	uint numBlocks = iDivUp( nbNodes, blockSize.x );
+	dim3 gridSize = dim3( std::min( numBlocks, 65535U ), iDivUp( numBlocks, 65535U ), 1 );
+
+	// Launch kernel
+	GvKernel_InvalidateNodes< NodeTileRes, BrickFullRes >
+		<<< gridSize, blockSize, 0 >>>( /*modified*/_dataStructure->volumeTreeKernel, /*modified*/_bricksCacheManager->getKernelObject(),
+										/*in*/_dataStructure->_localizationCodeArray->getPointer(), /*in*/_dataStructure->_localizationDepthArray->getPointer(),
+										/*in*/nbNodes, /*in*/invalidatedNodes );
+
+	GV_CHECK_CUDA_ERROR( "GvKernel_InvalidateNodes" );
+}
+
+/******************************************************************************
+ * Get the flag telling whether or not production info of nodes and bricks is recorded.
+ *
+ * @return the flag telling whether or not production info is recorded
+ ******************************************************************************/
+template< typename TDataStructure >
+bool GvDataProductionManager< TDataStructure >::hasProductionInfo() const
+{
+	return _nodeProductionInfos != NULL;
+}
+
+/******************************************************************************
+ * Set the flag telling whether or not production info of nodes and bricks is recorded
+ * (see GvProductionInfo). Producers record it with the device-side object returned
+ * by getProductionInfoKernelObject().
+ *
+ * @param pFlag the flag value
+ ******************************************************************************/
+template< typename TDataStructure >
+void GvDataProductionManager< TDataStructure >::useProductionInfo( bool pFlag )
+{
+	if ( pFlag && _nodeProductionInfos == NULL )
+	{
+		// Elements already in cache have not recorded their info
+		const uint3 brickCacheRes = _brickPoolRes / BrickFullRes::get();
+		_nodeProductionInfos = new thrust::device_vector< GvProductionInfo >( _nodePoolRes.x * _nodePoolRes.y * _nodePoolRes.z );
+		_brickProductionInfos = new thrust::device_vector< GvProductionInfo >( brickCacheRes.x * brickCacheRes.y * brickCacheRes.z );
+		resetProductionInfo();
+	}
+	else if ( ! pFlag )
+	{
+		delete _nodeProductionInfos;
+		_nodeProductionInfos = NULL;
+		delete _brickProductionInfos;
+		_brickProductionInfos = NULL;
+	}
+}
+
+/******************************************************************************
+ * Get the device-side object used by producers to record production info
+ *
+ * @return the device-side object (its arrays are NULL when production info is not recorded)
+ ******************************************************************************/
+template< typename TDataStructure >
+GvProductionInfoKernel GvDataProductionManager< TDataStructure >::getProductionInfoKernelObject() const
+{
+	GvProductionInfoKernel productionInfo;
+	productionInfo._nodeInfos = NULL;
+	productionInfo._brickInfos = NULL;
+	productionInfo._brickFullRes = BrickFullRes::get();
+	productionInfo._brickCacheRes = _brickPoolRes / BrickFullRes::get();
+	if ( _nodeProductionInfos != NULL )
+	{
+		productionInfo._nodeInfos = thrust::raw_pointer_cast( &( *_nodeProductionInfos )[ 0 ] );
+		productionInfo._brickInfos = thrust::raw_pointer_cast( &( *_brickProductionInfos )[ 0 ] );
+	}
+
+	return productionInfo;
+}
+
+/******************************************************************************
+ * Invalidate only the nodes and bricks whose production depends on an edited parameter
+ * (i.e. a transfer function, noise or clipping parameter), instead of clearing the whole cache.
+ * Elements whose dependency tags contain one of the given tags and whose value range overlaps
+ * the given range are produced again, everything else stays resident.
+ *
+ * When production info is not recorded, the whole cache is cleared.
+ *
+ * @param pMinValue min value of the range of values whose result has changed
+ * @param pMaxValue max value of the range of values whose result has changed
+ * @param pDependencyTags tags of the edited parameters
+ ******************************************************************************/
+template< typename TDataStructure >
+void GvDataProductionManager< TDataStructure >
+::invalidateDependentData( float pMinValue, float pMaxValue, uint pDependencyTags )
+{
+	if ( _nodeProductionInfos == NULL )
+	{
+		clearCache();
+
+		return;
+	}
+
+	// Only the node tiles that have been produced are processed
+	const uint nbNodes = std::min( _nodesCacheManager->_totalNumLoads, _nodesCacheManager->getNumElements() ) * NodeTileRes::getNumElements();
+
+	// Set kernel execution configuration
+	dim3 blockSize( 64, 1, 1 );
+	uint numBlocks = iDivUp( nbNodes, blockSize.x );
+	dim3 gridSize = dim3( std::min( numBlocks, 65535U ), iDivUp( numBlocks, 65535U ), 1 );
+
+	// Launch kernel
+	GvKernel_InvalidateDependentNodes< NodeTileRes, BrickFullRes >
+		<<< gridSize, blockSize, 0 >>>( /*modified*/_dataStructure->volumeTreeKernel, /*modified*/_bricksCacheManager->getKernelObject(),
+										/*in*/getProductionInfoKernelObject(), /*in*/nbNodes,
+										/*in*/pMinValue, /*in*/pMaxValue, /*in*/pDependencyTags );
+
+	GV_CHECK_CUDA_ERROR( "GvKernel_InvalidateDependentNodes" );
+}
+
+/******************************************************************************
+ * Copy the content of the cache on the host (node pool, data pool and element lists),
+ * before pools are reallocated with another size.
+ *
+ * @param pContent the resulting host copy
+ ******************************************************************************/
+template< typename TDataStructure >
+void GvDataProductionManager< TDataStructure >
+::storeContent( HostCacheContent& pContent )
+{
+	// Node pool
+	const uint nbNodes = _nodePoolRes.x * _nodePoolRes.y * _nodePoolRes.z;
+	pContent._childArray.resize( nbNodes );
+	pContent._dataArray.resize( nbNodes );
+	GV_CUDA_SAFE_CALL( cudaMemcpy( &pContent._childArray[ 0 ], _dataStructure->_childArray->getPointer(), nbNodes * sizeof( uint ), cudaMemcpyDeviceToHost ) );
+	GV_CUDA_SAFE_CALL( cudaMemcpy( &pContent._dataArray[ 0 ], _dataStructure->_dataArray->getPointer(), nbNodes * sizeof( uint ), cudaMemcpyDeviceToHost ) );
+
+	// Localization info of node tiles
+	const uint nbNodeTiles = nbNodes / NodeTileRes::getNumElements();
+	pContent._localizationCodes.resize( nbNodeTiles );
+	pContent._localizationDepths.resize( nbNodeTiles );
+	GV_CUDA_SAFE_CALL( cudaMemcpy( &pContent._localizationCodes[ 0 ], _dataStructure->_localizationCodeArray->getPointer(),
+									nbNodeTiles * sizeof( GvCore::GvLocalizationInfo::CodeType ), cudaMemcpyDeviceToHost ) );
+	GV_CUDA_SAFE_CALL( cudaMemcpy( &pContent._localizationDepths[ 0 ], _dataStructure->_localizationDepthArray->getPointer(),
+									nbNodeTiles * sizeof( GvCore::GvLocalizationInfo::DepthType ), cudaMemcpyDeviceToHost ) );
+
+	// Element lists of the cache managers (least recently used elements first)
+	const thrust::device_vector< uint >* nodeTileList = _nodesCacheManager->getElementList();
+	pContent._nodeTileList.resize( nodeTileList->size() );
+	thrust::copy( nodeTileList->begin(), nodeTileList->end(), pContent._nodeTileList.begin() );
+	const thrust::device_vector< uint >* brickList = _bricksCacheManager->getElementList();
+	pContent._brickList.resize( brickList->size() );
+	thrust::copy( brickList->begin(), brickList->end(), pContent._brickList.begin() );
+
+	// Data pool
+	pContent._brickPoolResolution = _brickPoolRes / BrickFullRes::get();
+	delete pContent._dataPool;
+	pContent._dataPool = new HostDataPoolType( _brickPoolRes, GvCore::Array3D< uint >::StandardHeapMemory );
+	DataChannelStorer dataChannelStorer;
+	dataChannelStorer._dataPool = _dataStructure->_dataPool;
+	dataChannelStorer._hostDataPool = pContent._dataPool;
+	GvCore::StaticLoop< DataChannelStorer, Loki::TL::Length< DataTypeList >::value - 1 >::go( dataChannelStorer );
+}
+
+/******************************************************************************
+ * Fill the cache with the content of a cache whose pools had another size.
+ * Resident node tiles and bricks are copied, the most recently used ones first if they don't fit,
+ * and their addresses are remapped in the node pool and in the element lists (see GvCache::GvPoolRemapper).
+ * Dropped nodes and bricks are produced again at next rendering passes.
+ *
+ * The cache must be empty (i.e. just created), production info is not restored.
+ *
+ * @param pContent the host copy of the previous cache
+ ******************************************************************************/
+template< typename TDataStructure >
+void GvDataProductionManager< TDataStructure >
+::restoreContent( const HostCacheContent& pContent )
+{
+	assert( pContent._dataPool != NULL );
+	if ( pContent._dataPool == NULL )
+	{
+		return;
+	}
+
+	// Select kept node tiles and bricks, and remap their addresses
+	const uint nbNodes = _nodePoolRes.x * _nodePoolRes.y * _nodePoolRes.z;
+	const uint nbNodeTiles = nbNodes / NodeTileRes::getNumElements();
+	GvCache::GvPoolRemapper poolRemapper( NodeTileRes::getNumElements(), BrickFullRes::get().x );
+	poolRemapper.remap( pContent._childArray, pContent._dataArray, pContent._nodeTileList, pContent._brickList,
+						pContent._brickPoolResolution, nbNodeTiles, _brickPoolRes / BrickFullRes::get() );
+	const std::vector< GvCache::GvPoolRemapper::ElementMapping >& nodeTileMappings = poolRemapper.getNodeTileMappings();
+	const std::vector< GvCache::GvPoolRemapper::ElementMapping >& brickMappings = poolRemapper.getBrickMappings();
+
+	// Node pool
+	GV_CUDA_SAFE_CALL( cudaMemcpy( _dataStructure->_childArray->getPointer(), &poolRemapper.getChildArray()[ 0 ], nbNodes * sizeof( uint ), cudaMemcpyHostToDevice ) );
+	GV_CUDA_SAFE_CALL( cudaMemcpy( _dataStructure->_dataArray->getPointer(), &poolRemapper.getDataArray()[ 0 ], nbNodes * sizeof( uint ), cudaMemcpyHostToDevice ) );
+
+	// Localization info of node tiles
+	std::vector< GvCore::GvLocalizationInfo::CodeType > localizationCodes( nbNodeTiles );
+	std::vector< GvCore::GvLocalizationInfo::DepthType > localizationDepths( nbNodeTiles );
+	for ( size_t i = 0; i < nodeTileMappings.size(); i++ )
+	{
+		localizationCodes[ nodeTileMappings[ i ].second ] = pContent._localizationCodes[ nodeTileMappings[ i ].first ];
+		localizationDepths[ nodeTileMappings[ i ].second ] = pContent._localizationDepths[ nodeTileMappings[ i ].first ];
+	}
+	GV_CUDA_SAFE_CALL( cudaMemcpy( _dataStructure->_localizationCodeArray->getPointer(), &localizationCodes[ 0 ],
+									nbNodeTiles * sizeof( GvCore::GvLocalizationInfo::CodeType ), cudaMemcpyHostToDevice ) );
+	GV_CUDA_SAFE_CALL( cudaMemcpy( _dataStructure->_localizationDepthArray->getPointer(), &localizationDepths[ 0 ],
+									nbNodeTiles * sizeof( GvCore::GvLocalizationInfo::DepthType ), cudaMemcpyHostToDevice ) );
+
+	// Element lists of the cache managers (time stamps stay at 0 : elements are sorted again at next rendering pass)
+	assert( poolRemapper.getNodeTileList().size() == _nodesCacheManager->getElementList()->size() );
+	assert( poolRemapper.getBrickList().size() == _bricksCacheManager->getElementList()->size() );
+	thrust::copy( poolRemapper.getNodeTileList().begin(), poolRemapper.getNodeTileList().end(), _nodesCacheManager->getElementList()->begin() );
+	thrust::copy( poolRemapper.getBrickList().begin(), poolRemapper.getBrickList().end(), _bricksCacheManager->getElementList()->begin() );
+	_nodesCacheManager->_totalNumLoads = GvCache::GvPoolRemapper::cNbLockedElements + static_cast< uint >( nodeTileMappings.size() ) - 1/*root node tile*/;
+	_nodesCacheManager->_lastNumLoads = 0;
+	_bricksCacheManager->_totalNumLoads = static_cast< uint >( brickMappings.size() );
+	_bricksCacheManager->_lastNumLoads = 0;
+
+	// Data pool
+	DataChannelRestorer dataChannelRestorer;
+	dataChannelRestorer._hostDataPool = pContent._dataPool;
+	dataChannelRestorer._dataPool = _dataStructure->_dataPool;
+	dataChannelRestorer._brickMappings = &brickMappings;
+	GvCore::StaticLoop< DataChannelRestorer, Loki::TL::Length< DataTypeList >::value - 1 >::go( dataChannelRestorer );
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+template< typename TDataStructure >
+GvDataProductionManager< TDataStructure >::HostCacheContent
+::HostCacheContent()
+:	_childArray()
+,	_dataArray()
+,	_localizationCodes()
+,	_localizationDepths()
+,	_nodeTileList()
+,	_brickList()
+,	_brickPoolResolution( make_uint3( 0, 0, 0 ) )
+,	_dataPool( NULL )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+template< typename TDataStructure >
+GvDataProductionManager< TDataStructure >::HostCacheContent
+::~HostCacheContent()
+{
+	delete _dataPool;
+}
+
+/******************************************************************************
+ * Copy a channel
+ *
+ * @param Loki::Int2Type< TChannelIndex > index of the channel (i.e. color, normal, etc...)
+ ******************************************************************************/
+template< typename TDataStructure >
+template< int TChannelIndex >
+inline void GvDataProductionManager< TDataStructure >::DataChannelStorer
+::run( Loki::Int2Type< TChannelIndex > )
+{
+	memcpyArray( _hostDataPool->getChannel( Loki::Int2Type< TChannelIndex >() ), _dataPool->getChannel( Loki::Int2Type< TChannelIndex >() ) );
+}
+
+/******************************************************************************
+ * Copy the kept bricks of a channel
+ *
+ * @param Loki::Int2Type< TChannelIndex > index of the channel (i.e. color, normal, etc...)
+ ******************************************************************************/
+template< typename TDataStructure >
+template< int TChannelIndex >
+inline void GvDataProductionManager< TDataStructure >::DataChannelRestorer
+::run( Loki::Int2Type< TChannelIndex > )
+{
+	// Type definition of the channel's data type at given channel index.
+	typedef typename GvCore::DataChannelType< DataTypeList, TChannelIndex >::Result ChannelType;
+
+	GvCore::Array3DGPUTex< ChannelType >* channel = _dataPool->getChannel( Loki::Int2Type< TChannelIndex >() );
+	const GvCore::Array3D< ChannelType >* hostChannel = _hostDataPool->getChannel( Loki::Int2Type< TChannelIndex >() );
+
+	// Gather kept bricks in a host array with the resolution of the new pool, then copy it on the device at once
+	GvCore::Array3D< ChannelType > newHostChannel( channel->getResolution(), GvCore::Array3D< ChannelType >::StandardHeapMemory );
+	const uint3 brickResolution = BrickFullRes::get();
+	for ( size_t i = 0; i < _brickMappings->size(); i++ )
+	{
+		const uint3 brick = VolTreeBrickAddress::unpackAddress( ( *_brickMappings )[ i ].first ) * brickResolution;
+		const uint3 newBrick = VolTreeBrickAddress::unpackAddress( ( *_brickMappings )[ i ].second ) * brickResolution;
+		for ( uint z = 0; z < brickResolution.z; z++ )
+		for ( uint y = 0; y < brickResolution.y; y++ )
+		{
+			memcpy( newHostChannel.getPointer( newBrick + make_uint3( 0, y, z ) ), hostChannel->getPointer( brick + make_uint3( 0, y, z ) ), brickResolution.x * sizeof( ChannelType ) );
+		}
+	}
+	memcpyArray( channel, make_uint3( 0, 0, 0 ), channel->getResolution(), newHostChannel.getPointer() );
+}
+
+/******************************************************************************
+ * Reset production info : elements depend on all parameters and all values
+ ******************************************************************************/
+template< typename TDataStructure >
+void GvDataProductionManager< TDataStructure >::resetProductionInfo()
+{
+	GvProductionInfo info;
+	info._minValue = -FLT_MAX;
+	info._maxValue = FLT_MAX;
+	info._dependencyTags = GV_PRODUCTION_INFO_ALL_DEPENDENCIES;
+
+	thrust::fill( _nodeProductionInfos->begin(), _nodeProductionInfos->end(), info );
+	thrust::fill( _brickProductionInfos->begin(), _brickProductionInfos->end(), info );
+}
+
 } // namespace GvStructure
 
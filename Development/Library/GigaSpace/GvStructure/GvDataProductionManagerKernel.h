@@ -45,7 +45,10 @@
 #include "GvCore/Array3DKernelLinear.h"
 #include "GvCore/StaticRes3D.h"
 #include "GvCore/GvLocalizationInfo.h"
+#include "GvCore/GvMortonCode.h"
 #include "GvCache/GvCacheManagerKernel.h"
+#include "GvStructure/GvProductionInfoKernel.h"
+#include "GvStructure/GvSpatialHashKernel.h"
 #include "GvStructure/GvVolumeTree.h"
 
 /******************************************************************************
@@ -104,6 +107,18 @@ struct GvDataProductionManagerKernel
 	 */
 	GvCore::Array3DKernelLinear< uint > _updateBufferArray;
 
+	/**
+	 * Buffer used to store the priority of requests (same layout as the update buffer).
+	 * Priorities are positive floats stored as their bits, so that the max of all emitted
+	 * priorities of a node is kept with an integer atomic max.
+	 */
+	GvCore::Array3DKernelLinear< uint > _requestPriorityArray;
+
+	/**
+	 * Flag telling wheter or not priorities of requests are stored
+	 */
+	bool _hasRequestPriorities;
+
 	/**
 	 * Node cache manager
 	 *
@@ -136,6 +151,16 @@ struct GvDataProductionManagerKernel
 	__device__
 	__forceinline__ void loadRequest( uint nodeAddressEnc );
 
+	/**
+	 * Update the priority of the request emitted for a given node.
+	 * The highest priority emitted during the frame is kept.
+	 *
+	 * @param nodeAddressEnc the encoded node address
+	 * @param pPriority the priority of the request (i.e. a screen-space error, positive)
+	 */
+	__device__
+	__forceinline__ void setRequestPriority( uint nodeAddressEnc, float pPriority );
+
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
 	 **************************************************************************/
@@ -208,6 +233,66 @@ void UpdateBrickUsage( uint numElems, uint* lruElemAddressList, GPUCacheType gpu
 __global__
 void GvKernel_PreProcessRequests( const uint* pRequests, unsigned int* pIsValidMasks, const uint pNbElements );
 
+/******************************************************************************
+ * KERNEL GvKernel_InvalidateNodes
+ *
+ * This kernel invalidates the nodes whose localization info is in a spatial hash of Morton keys
+ * (i.e. nodes whose data has changed in the producer), without touching the other ones :
+ * - the brick of a node is unmapped (and its cache slot is flagged as the least recently used one),
+ * so that a load request is emitted for it at next rendering pass,
+ * - a node without subnodes is reset to uninitialized, so that it is produced again.
+ * Subnodes are kept, changed subnodes have their own keys.
+ *
+ * @param pDataStructure data structure
+ * @param pBrickCacheManager bricks cache manager
+ * @param pLocCodeList localization codes of the node tiles
+ * @param pLocDepthList localization depths of the node tiles
+ * @param pNbNodes number of nodes to process (in the node pool)
+ * @param pInvalidatedNodes spatial hash of the Morton keys of the nodes to invalidate
+ ******************************************************************************/
+template< class NodeTileRes, class BrickFullRes, typename VolTreeKernelType, typename BrickCacheManagerKernelType >
+__global__
+void GvKernel_InvalidateNodes( VolTreeKernelType pDataStructure, BrickCacheManagerKernelType pBrickCacheManager,
+							const GvCore::GvLocalizationInfo::CodeType* pLocCodeList, const GvCore::GvLocalizationInfo::DepthType* pLocDepthList,
+							const uint pNbNodes, const GvSpatialHashKernel< NodeTileRes > pInvalidatedNodes );
+
+/******************************************************************************
+ * KERNEL GvKernel_InvalidateDependentNodes
+ *
+ * This kernel invalidates the nodes whose production info, or the one of their brick,
+ * depends on a change of parameters (see GvProductionInfo::dependsOn()), without touching the other ones.
+ * Nodes are invalidated as in GvKernel_InvalidateNodes.
+ *
+ * @param pDataStructure data structure
+ * @param pBrickCacheManager bricks cache manager
+ * @param pProductionInfo production info of nodes and bricks
+ * @param pNbNodes number of nodes to process (in the node pool)
+ * @param pMinValue min value of the changed range
+ * @param pMaxValue max value of the changed range
+ * @param pDependencyTags tags of the changed parameters
+ ******************************************************************************/
+template< class NodeTileRes, class BrickFullRes, typename VolTreeKernelType, typename BrickCacheManagerKernelType >
+__global__
+void GvKernel_InvalidateDependentNodes( VolTreeKernelType pDataStructure, BrickCacheManagerKernelType pBrickCacheManager,
+									const GvProductionInfoKernel pProductionInfo, const uint pNbNodes,
+									const float pMinValue, const float pMaxValue, const uint pDependencyTags );
+
+/******************************************************************************
+ * Invalidate a node of the node pool :
+ * - the brick of the node is unmapped (and its cache slot is flagged as the least recently used one),
+ * so that a load request is emitted for it at next rendering pass,
+ * - a node without subnodes is reset to uninitialized, so that it is produced again.
+ * Subnodes are kept.
+ *
+ * @param pDataStructure data structure
+ * @param pBrickCacheManager bricks cache manager
+ * @param pNode the node (it must be initialized)
+ * @param pNodeAddress address of the node in the node pool
+ ******************************************************************************/
+template< class BrickFullRes, typename VolTreeKernelType, typename BrickCacheManagerKernelType >
+__device__
+inline void invalidateNode( VolTreeKernelType& pDataStructure, BrickCacheManagerKernelType& pBrickCacheManager, GvStructure::GvNode& pNode, uint pNodeAddress );
+
 ///******************************************************************************
 // * ...
 // ******************************************************************************/
@@ -72,6 +72,28 @@ __forceinline__ void GvDataProductionManagerKernel< NodeTileRes, BrickFullRes, N
 	_updateBufferArray.set( nodeAddress, ( nodeAddressEnc & 0x3FFFFFFF ) | VTC_REQUEST_LOAD );
 }
 
+/******************************************************************************
+ * Update the priority of the request emitted for a given node.
+ * The highest priority emitted during the frame is kept.
+ *
+ * @param nodeAddressEnc the encoded node address
+ * @param pPriority the priority of the request (i.e. a screen-space error, positive)
+ ******************************************************************************/
+template< class NodeTileRes, class BrickFullRes, class NodeAddressType, class BrickAddressType >
+__device__
+__forceinline__ void GvDataProductionManagerKernel< NodeTileRes, BrickFullRes, NodeAddressType, BrickAddressType >
+::setRequestPriority( uint nodeAddressEnc, float pPriority )
+{
+	if ( _hasRequestPriorities )
+	{
+		// Retrieve 3D node address (the buffer is linear, like the node pool)
+		const uint3 nodeAddress = NodeAddressType::unpackAddress( nodeAddressEnc );
+
+		// Bits of positive floats are ordered like the floats
+		atomicMax( _requestPriorityArray.getPointer( nodeAddress.x ), __float_as_uint( fmaxf( pPriority, 0.0f ) ) );
+	}
+}
+
 } // namespace GvStructure
 
 /******************************************************************************
@@ -169,4 +191,150 @@ void GvKernel_PreProcessRequests( const uint* pRequests, unsigned int* pIsValidM
 	}
 }
 
+/******************************************************************************
+ * KERNEL GvKernel_InvalidateNodes
+ *
+ * This kernel invalidates the nodes whose localization info is in a spatial hash of Morton keys
+ * (i.e. nodes whose data has changed in the producer), without touching the other ones :
+ * - the brick of a node is unmapped (and its cache slot is flagged as the least recently used one),
+ * so that a load request is emitted for it at next rendering pass,
+ * - a node without subnodes is reset to uninitialized, so that it is produced again.
+ * Subnodes are kept, changed subnodes have their own keys.
+ *
+ * @param pDataStructure data structure
+ * @param pBrickCacheManager bricks cache manager
+ * @param pLocCodeList localization codes of the node tiles
+ * @param pLocDepthList localization depths of the node tiles
+ * @param pNbNodes number of nodes to process (in the node pool)
+ * @param pInvalidatedNodes spatial hash of the Morton keys of the nodes to invalidate
+ ******************************************************************************/
+template< class NodeTileRes, class BrickFullRes, typename VolTreeKernelType, typename BrickCacheManagerKernelType >
+__global__
+// __launch_bounds__( maxThreadsPerBlock, minBlocksPerMultiprocessor )
+void GvKernel_InvalidateNodes( VolTreeKernelType pDataStructure, BrickCacheManagerKernelType pBrickCacheManager,
+							const GvCore::GvLocalizationInfo::CodeType* pLocCodeList, const GvCore::GvLocalizationInfo::DepthType* pLocDepthList,
+							const uint pNbNodes, const GvSpatialHashKernel< NodeTileRes > pInvalidatedNodes )
+{
+	// Retrieve global data index
+	const uint lineSize = __uimul( blockDim.x, gridDim.x );
+	const uint index = threadIdx.x + __uimul( blockIdx.x, blockDim.x ) + __uimul( blockIdx.y, lineSize );
+
+	// Check bounds (the first node tile is not used, the root node tile is the second one)
+	if ( index < NodeTileRes::getNumElements() || index >= pNbNodes )
+	{
+		return;
+	}
+
+	// Retrieve the Morton key of the node from the localization info of its node tile
+	const uint nodeTileAddress = index / NodeTileRes::getNumElements();
+	const uint3 nodeOffset = NodeTileRes::toFloat3( index - nodeTileAddress * NodeTileRes::getNumElements() );
+	const GvCore::GvLocalizationInfo::CodeType nodeLocCode = pLocCodeList[ nodeTileAddress ].addLevel< NodeTileRes >( nodeOffset );
+	const GvCore::GvMortonCode::ValueType key = GvCore::GvMortonCode::encodeNode< NodeTileRes >( nodeLocCode, pLocDepthList[ nodeTileAddress ] );
+
+	if ( pInvalidatedNodes.find( key ) == GV_SPATIAL_HASH_INVALID_VALUE )
+	{
+		return;
+	}
+
+	GvStructure::GvNode node;
+	pDataStructure.fetchNode( node, index );
+	if ( ! node.isInitializated() )
+	{
+		return;
+	}
+
+	invalidateNode< BrickFullRes >( pDataStructure, pBrickCacheManager, node, index );
+}
+
+/******************************************************************************
+ * KERNEL GvKernel_InvalidateDependentNodes
+ *
+ * This kernel invalidates the nodes whose production info, or the one of their brick,
+ * depends on a change of parameters (see GvProductionInfo::dependsOn()), without touching the other ones.
+ * Nodes are invalidated as in GvKernel_InvalidateNodes.
+ *
+ * @param pDataStructure data structure
+ * @param pBrickCacheManager bricks cache manager
+ * @param pProductionInfo production info of nodes and bricks
+ * @param pNbNodes number of nodes to process (in the node pool)
+ * @param pMinValue min value of the changed range
+ * @param pMaxValue max value of the changed range
+ * @param pDependencyTags tags of the changed parameters
+ ******************************************************************************/
+template< class NodeTileRes, class BrickFullRes, typename VolTreeKernelType, typename BrickCacheManagerKernelType >
+__global__
+// __launch_bounds__( maxThreadsPerBlock, minBlocksPerMultiprocessor )
+void GvKernel_InvalidateDependentNodes( VolTreeKernelType pDataStructure, BrickCacheManagerKernelType pBrickCacheManager,
+									const GvProductionInfoKernel pProductionInfo, const uint pNbNodes,
+									const float pMinValue, const float pMaxValue, const uint pDependencyTags )
+{
+	// Retrieve global data index
+	const uint lineSize = __uimul( blockDim.x, gridDim.x );
+	const uint index = threadIdx.x + __uimul( blockIdx.x, blockDim.x ) + __uimul( blockIdx.y, lineSize );
+
+	// Check bounds (the first node tile is not used, the root node tile is the second one)
+	if ( index < NodeTileRes::getNumElements() || index >= pNbNodes )
+	{
+		return;
+	}
+
+	GvStructure::GvNode node;
+	pDataStructure.fetchNode( node, index );
+	if ( ! node.isInitializated() )
+	{
+		return;
+	}
+
+	// The type of the node, or the content of its brick, may depend on the change
+	bool isDependent = pProductionInfo._nodeInfos[ index ].dependsOn( pMinValue, pMaxValue, pDependencyTags );
+	if ( ! isDependent && node.hasBrick() )
+	{
+		const uint brickIndex = pProductionInfo.getBrickIndex( GvStructure::GvNode::unpackBrickAddress( node.brickAddress ) );
+		isDependent = pProductionInfo._brickInfos[ brickIndex ].dependsOn( pMinValue, pMaxValue, pDependencyTags );
+	}
+
+	if ( isDependent )
+	{
+		invalidateNode< BrickFullRes >( pDataStructure, pBrickCacheManager, node, index );
+	}
+}
+
+/******************************************************************************
+ * Invalidate a node of the node pool :
+ * - the brick of the node is unmapped (and its cache slot is flagged as the least recently used one),
+ * so that a load request is emitted for it at next rendering pass,
+ * - a node without subnodes is reset to uninitialized, so that it is produced again.
+ * Subnodes are kept.
+ *
+ * @param pDataStructure data structure
+ * @param pBrickCacheManager bricks cache manager
+ * @param pNode the node (it must be initialized)
+ * @param pNodeAddress address of the node in the node pool
+ ******************************************************************************/
+template< class BrickFullRes, typename VolTreeKernelType, typename BrickCacheManagerKernelType >
+__device__
+inline void invalidateNode( VolTreeKernelType& pDataStructure, BrickCacheManagerKernelType& pBrickCacheManager, GvStructure::GvNode& pNode, uint pNodeAddress )
+{
+	// Flag the brick cache slot as the least recently used one
+	if ( pNode.hasBrick() )
+	{
+		const uint3 brickCacheSlot = GvStructure::GvNode::unpackBrickAddress( pNode.brickAddress ) / BrickFullRes::get();
+		pBrickCacheManager._timeStampArray.set( brickCacheSlot, 1 );
+	}
+
+	if ( pNode.hasSubNodes() )
+	{
+		// Keep subnodes, only the brick is loaded again
+		pNode.childAddress |= 0x40000000;
+		pNode.brickAddress = 0;
+	}
+	else
+	{
+		// Reset the node to uninitialized
+		pNode.childAddress = 0;
+		pNode.brickAddress = 0;
+	}
+	pDataStructure.setNode( pNode, pNodeAddress );
+}
+
 } // namespace GvStructure
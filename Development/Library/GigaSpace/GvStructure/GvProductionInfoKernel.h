@@ -0,0 +1,216 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_PRODUCTION_INFO_KERNEL_H_
+#define _GV_PRODUCTION_INFO_KERNEL_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+
+// Cuda
+#include <vector_types.h>
+#include <vector_functions.h>
+#include <host_defines.h>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Dependency tags of elements whose production info has not been recorded
+ * (they depend on all parameters)
+ */
+#define GV_PRODUCTION_INFO_ALL_DEPENDENCIES	0xFFFFFFFFU
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvStructure
+{
+
+/** 
+ * @struct GvProductionInfo
+ *
+ * @brief The GvProductionInfo struct provides what the production of an element
+ * (node or brick) has depended on.
+ *
+ * - a value range : the range of the scalar values the producer has used to produce the element
+ * (i.e. densities mapped by a transfer function, distances tested against a threshold, depths, etc...),
+ * - dependency tags : a bit mask of the parameters of the producer the element depends on
+ * (their meaning is given by the producer).
+ *
+ * When a parameter is edited, only the elements whose tags contain the parameter and whose value range
+ * overlaps the range of values whose result has changed have to be produced again
+ * (see GvDataProductionManager::invalidateDependentData()).
+ */
+struct GvProductionInfo
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Value range
+	 */
+	float _minValue;
+	float _maxValue;
+
+	/**
+	 * Dependency tags
+	 */
+	uint _dependencyTags;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Tell wheter or not the element depends on a change of parameters
+	 *
+	 * @param pMinValue min value of the changed range
+	 * @param pMaxValue max value of the changed range
+	 * @param pDependencyTags tags of the changed parameters
+	 *
+	 * @return a flag telling wheter or not the element depends on the change
+	 */
+	__host__ __device__
+	inline bool dependsOn( float pMinValue, float pMaxValue, uint pDependencyTags ) const;
+
+};
+
+/** 
+ * @struct GvProductionInfoKernel
+ *
+ * @brief The GvProductionInfoKernel struct provides the device-side interface
+ * used by producers to record the production info of nodes and bricks
+ * (see GvDataProductionManager::useProductionInfo()).
+ *
+ * Production info is stored per node (indexed by the address of the node in the node pool)
+ * and per brick (indexed by the slot of the brick in the data pool). When it is enabled,
+ * a producer has to record it for every node and every brick it produces : cache slots are reused,
+ * and the info of a slot is the one of the last element produced in it.
+ * The info of elements never recorded depends on all parameters and all values.
+ */
+struct GvProductionInfoKernel
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Production info of nodes (NULL when production info is not used)
+	 */
+	GvProductionInfo* _nodeInfos;
+
+	/**
+	 * Production info of bricks (NULL when production info is not used)
+	 */
+	GvProductionInfo* _brickInfos;
+
+	/**
+	 * Brick resolution (with borders)
+	 */
+	uint3 _brickFullRes;
+
+	/**
+	 * Number of brick slots in the data pool along each axis
+	 */
+	uint3 _brickCacheRes;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Tell wheter or not production info is recorded
+	 *
+	 * @return a flag telling wheter or not production info is recorded
+	 */
+	__host__ __device__
+	inline bool isEnabled() const;
+
+	/**
+	 * Get the index of the brick slot of a brick
+	 *
+	 * @param pBrickAddress address of the brick in the data pool (in voxels, i.e. newElemAddress of the producer)
+	 *
+	 * @return the index of the brick slot
+	 */
+	__host__ __device__
+	inline uint getBrickIndex( const uint3& pBrickAddress ) const;
+
+	/**
+	 * Record the production info of a node
+	 *
+	 * @param pNodeAddress address of the node in the node pool
+	 * @param pMinValue min value used to produce the node
+	 * @param pMaxValue max value used to produce the node
+	 * @param pDependencyTags tags of the parameters used to produce the node
+	 */
+	__device__
+	inline void setNodeInfo( uint pNodeAddress, float pMinValue, float pMaxValue, uint pDependencyTags ) const;
+
+	/**
+	 * Record the production info of a brick
+	 *
+	 * @param pBrickAddress address of the brick in the data pool (in voxels, i.e. newElemAddress of the producer)
+	 * @param pMinValue min value used to produce the brick
+	 * @param pMaxValue max value used to produce the brick
+	 * @param pDependencyTags tags of the parameters used to produce the brick
+	 */
+	__device__
+	inline void setBrickInfo( const uint3& pBrickAddress, float pMinValue, float pMaxValue, uint pDependencyTags ) const;
+
+};
+
+}
+
+/**************************************************************************
+ ***************************** INLINE SECTION *****************************
+ **************************************************************************/
+
+#include "GvProductionInfoKernel.inl"
+
+#endif
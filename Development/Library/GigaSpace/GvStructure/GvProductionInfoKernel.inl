@@ -0,0 +1,121 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** INLINE DEFINITION *****************************
+ ******************************************************************************/
+
+namespace GvStructure
+{
+
+/******************************************************************************
+ * Tell wheter or not the element depends on a change of parameters
+ *
+ * @param pMinValue min value of the changed range
+ * @param pMaxValue max value of the changed range
+ * @param pDependencyTags tags of the changed parameters
+ *
+ * @return a flag telling wheter or not the element depends on the change
+ ******************************************************************************/
+__host__ __device__
+inline bool GvProductionInfo::dependsOn( float pMinValue, float pMaxValue, uint pDependencyTags ) const
+{
+	return ( _dependencyTags & pDependencyTags ) != 0 && _minValue <= pMaxValue && pMinValue <= _maxValue;
+}
+
+/******************************************************************************
+ * Tell wheter or not production info is recorded
+ *
+ * @return a flag telling wheter or not production info is recorded
+ ******************************************************************************/
+__host__ __device__
+inline bool GvProductionInfoKernel::isEnabled() const
+{
+	return _nodeInfos != NULL;
+}
+
+/******************************************************************************
+ * Get the index of the brick slot of a brick
+ *
+ * @param pBrickAddress address of the brick in the data pool (in voxels, i.e. newElemAddress of the producer)
+ *
+ * @return the index of the brick slot
+ ******************************************************************************/
+__host__ __device__
+inline uint GvProductionInfoKernel::getBrickIndex( const uint3& pBrickAddress ) const
+{
+	const uint3 brickSlot = make_uint3( pBrickAddress.x / _brickFullRes.x, pBrickAddress.y / _brickFullRes.y, pBrickAddress.z / _brickFullRes.z );
+
+	return brickSlot.x + _brickCacheRes.x * ( brickSlot.y + _brickCacheRes.y * brickSlot.z );
+}
+
+/******************************************************************************
+ * Record the production info of a node
+ *
+ * @param pNodeAddress address of the node in the node pool
+ * @param pMinValue min value used to produce the node
+ * @param pMaxValue max value used to produce the node
+ * @param pDependencyTags tags of the parameters used to produce the node
+ ******************************************************************************/
+__device__
+inline void GvProductionInfoKernel::setNodeInfo( uint pNodeAddress, float pMinValue, float pMaxValue, uint pDependencyTags ) const
+{
+	if ( _nodeInfos != NULL )
+	{
+		GvProductionInfo info;
+		info._minValue = pMinValue;
+		info._maxValue = pMaxValue;
+		info._dependencyTags = pDependencyTags;
+		_nodeInfos[ pNodeAddress ] = info;
+	}
+}
+
+/******************************************************************************
+ * Record the production info of a brick
+ *
+ * @param pBrickAddress address of the brick in the data pool (in voxels, i.e. newElemAddress of the producer)
+ * @param pMinValue min value used to produce the brick
+ * @param pMaxValue max value used to produce the brick
+ * @param pDependencyTags tags of the parameters used to produce the brick
+ ******************************************************************************/
+__device__
+inline void GvProductionInfoKernel::setBrickInfo( const uint3& pBrickAddress, float pMinValue, float pMaxValue, uint pDependencyTags ) const
+{
+	if ( _brickInfos != NULL )
+	{
+		GvProductionInfo info;
+		info._minValue = pMinValue;
+		info._maxValue = pMaxValue;
+		info._dependencyTags = pDependencyTags;
+		_brickInfos[ getBrickIndex( pBrickAddress ) ] = info;
+	}
+}
+
+} // namespace GvStructure
@@ -0,0 +1,288 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_SPATIAL_HASH_H_
+#define _GV_SPATIAL_HASH_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+
+// Cuda
+#include <vector_types.h>
+
+// Cuda SDK
+#include <helper_math.h>
+
+// GigaVoxels
+#include "GvStructure/GvIDataStructure.h"
+#include "GvStructure/GvSpatialHashKernel.h"
+#include "GvCore/StaticRes3D.h"
+#include "GvCore/Array3D.h"
+#include "GvCore/Array3DGPULinear.h"
+#include "GvCore/Array3DGPUTex.h"
+#include "GvCore/GPUPool.h"
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvStructure
+{
+
+/** 
+ * @struct GvSpatialHash
+ *
+ * @brief The GvSpatialHash struct provides a sparse data structure
+ * based on a spatial hash instead of a N-Tree.
+ *
+ * Bricks are stored in a data pool, exactly as in GvVolumeTree, but there is no node pool :
+ * nodes of all levels of resolution are keys of a hash table (their Morton key,
+ * see GvCore::GvMortonCode::encodeNode()) mapping to the address of their brick.
+ * Lookups are O(1) per level instead of a descent from the root, and memory only
+ * grows with the number of bricks, which suits very sparse scenes.
+ *
+ * Node keys are the ones of the request lists, so producers written for GvVolumeTree
+ * (same data type list and brick resolution) can fill the data pool unchanged,
+ * the cache only has to insert/erase the keys of the bricks it loads/evicts.
+ *
+ * The table has twice as many slots as the data pool has bricks (rounded up to
+ * a power of two), so the load factor stays under 0.5.
+ *
+ * @param DataTList Data type list provided by the user
+ * @param NodeTileRes Node tile resolution
+ * @param BrickRes Brick resolution
+ * @param BorderSize Brick border size
+ */
+template
+<
+	class DataTList, class NodeTileRes, class BrickRes, uint BorderSize
+>
+struct GvSpatialHash : public GvIDataStructure
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Type definition of the spatial hash on GPU side
+	 */
+	typedef GvSpatialHashKernel< NodeTileRes > KernelType;
+
+	/**
+	 * Type definition of keys
+	 */
+	typedef typename KernelType::KeyType KeyType;
+
+	/**
+	 * Type definition for the node tile resolution
+	 */
+	typedef NodeTileRes NodeTileResolution;
+
+	/**
+	 * Type definition for the brick resolution
+	 */
+	typedef BrickRes BrickResolution;
+
+	/**
+	 * Enumeration to define the brick border size
+	 */
+	enum
+	{
+		BrickBorderSize = BorderSize
+	};
+
+	/**
+	 * Defines the total size of a brick
+	 */
+	typedef GvCore::StaticRes1D< BrickResolution::x + 2 * BrickBorderSize > FullBrickResolution;
+
+	/**
+	 * Defines the data type list
+	 */
+	typedef DataTList DataTypeList;
+
+	/**
+	 * Type definition of the data pool type
+	 */
+	typedef GvCore::GPUPoolHost< GvCore::Array3DGPUTex, DataTList > DataPoolType;
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Brick pool (i.e data pool)
+	 * It is implemented as an Array3DGPUTex, i.e a 3D texture
+	 * There is one 3D texture for each element in the data type list DataTList defined by the user
+	 */
+	DataPoolType* _dataPool;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor.
+	 *
+	 * @param bricksCacheRes Cache size used to store bricks
+	 * @param graphicsInteroperability Flag used for graphics interoperability
+	 */
+	GvSpatialHash( const uint3& bricksCacheRes, uint graphicsInteroperability = 0 );
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~GvSpatialHash();
+
+	/**
+	 * Clear the spatial hash (all keys are removed)
+	 */
+	void clear();
+
+	/**
+	 * Rebuild the table without its erased slots.
+	 * Insertions reuse erased slots, but lookups still have to probe them :
+	 * this shortens probe sequences when many bricks have been evicted.
+	 *
+	 * @return the number of keys in the table
+	 */
+	uint rehash();
+
+	/**
+	 * Get the spatial hash on GPU side
+	 *
+	 * @return the spatial hash on GPU side
+	 */
+	const KernelType& getKernelObject() const;
+
+	/**
+	 * Get the number of slots of the table
+	 *
+	 * @return the number of slots
+	 */
+	uint getCapacity() const;
+
+	/**
+	 * Get the number of bricks of the data pool
+	 *
+	 * @return the number of bricks
+	 */
+	uint getNbBricks() const;
+
+	/**
+	 * This method is called to serialize an object
+	 *
+	 * @param pStream the stream where to write
+	 */
+	virtual void write( std::ostream& pStream ) const;
+
+	/**
+	 * This method is called deserialize an object
+	 *
+	 * @param pStream the stream from which to read
+	 */
+	virtual void read( std::istream& pStream );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Key array
+	 */
+	GvCore::Array3DGPULinear< KeyType >* _keyArray;
+
+	/**
+	 * Value array (brick addresses)
+	 */
+	GvCore::Array3DGPULinear< uint >* _valueArray;
+
+	/**
+	 * Spatial hash on GPU side
+	 */
+	KernelType _kernelObject;
+
+	/**
+	 * Number of bricks of the data pool
+	 */
+	uint _nbBricks;
+
+	/******************************** METHODS *********************************/
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvSpatialHash( const GvSpatialHash& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvSpatialHash& operator=( const GvSpatialHash& );
+
+};
+
+} // namespace GvStructure
+
+/**************************************************************************
+ ***************************** INLINE SECTION *****************************
+ **************************************************************************/
+
+#include "GvSpatialHash.inl"
+
+#endif
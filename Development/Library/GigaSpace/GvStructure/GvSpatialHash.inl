@@ -0,0 +1,274 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvError.h"
+#include "GvCore/vector_types_ext.h"
+
+// STL
+#include <iostream>
+
+/******************************************************************************
+ ****************************** INLINE DEFINITION *****************************
+ ******************************************************************************/
+
+namespace GvStructure
+{
+
+/******************************************************************************
+ * Constructor.
+ *
+ * @param bricksCacheRes Cache size used to store bricks
+ * @param graphicsInteroperability Flag used for graphics interoperability
+ ******************************************************************************/
+template< class DataTList, class NodeTileRes, class BrickRes, uint BorderSize >
+GvSpatialHash< DataTList, NodeTileRes, BrickRes, BorderSize >
+::GvSpatialHash( const uint3& bricksCacheRes, uint graphicsInteroperability )
+:	GvIDataStructure()
+,	_dataPool( NULL )
+,	_keyArray( NULL )
+,	_valueArray( NULL )
+,	_nbBricks( 0 )
+{
+	// Number of bricks that fit in the data pool
+	const uint3 nbBricks = bricksCacheRes / FullBrickResolution::get();
+	_nbBricks = nbBricks.x * nbBricks.y * nbBricks.z;
+
+	// Number of slots : power of two, with a load factor under 0.5
+	uint capacity = 1;
+	while ( capacity < 2 * _nbBricks )
+	{
+		capacity <<= 1;
+	}
+
+	// LOG info
+	std::cout << "\nData Structure ( Spatial Hash )" << std::endl;
+	std::cout << "- bricks cache resolution : " << bricksCacheRes << std::endl;
+	std::cout << "- number of slots : " << capacity << std::endl;
+
+	// Data pool initialization
+	_dataPool = new DataPoolType( bricksCacheRes, graphicsInteroperability );
+
+	// Hash table initialization
+	_keyArray = new GvCore::Array3DGPULinear< KeyType >( make_uint3( capacity, 1, 1 ) );
+	_valueArray = new GvCore::Array3DGPULinear< uint >( make_uint3( capacity, 1, 1 ) );
+
+	_kernelObject._keys = _keyArray->getPointer();
+	_kernelObject._values = _valueArray->getPointer();
+	_kernelObject._capacityMask = capacity - 1;
+
+	clear();
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+template< class DataTList, class NodeTileRes, class BrickRes, uint BorderSize >
+GvSpatialHash< DataTList, NodeTileRes, BrickRes, BorderSize >
+::~GvSpatialHash()
+{
+	delete _dataPool;
+
+	delete _keyArray;
+	delete _valueArray;
+}
+
+/******************************************************************************
+ * Clear the spatial hash (all keys are removed)
+ ******************************************************************************/
+template< class DataTList, class NodeTileRes, class BrickRes, uint BorderSize >
+void GvSpatialHash< DataTList, NodeTileRes, BrickRes, BorderSize >
+::clear()
+{
+	// Empty keys are 0, invalid values are 0xFFFFFFFF
+	_keyArray->fill( 0 );
+	_valueArray->fill( 0xFF );
+}
+
+/******************************************************************************
+ * Rebuild the table without its erased slots.
+ * Insertions reuse erased slots, but lookups still have to probe them :
+ * this shortens probe sequences when many bricks have been evicted.
+ *
+ * @return the number of keys in the table
+ ******************************************************************************/
+template< class DataTList, class NodeTileRes, class BrickRes, uint BorderSize >
+uint GvSpatialHash< DataTList, NodeTileRes, BrickRes, BorderSize >
+::rehash()
+{
+	const uint3 resolution = _keyArray->getResolution();
+
+	// Download the current table
+	GvCore::Array3D< KeyType >* keys = new GvCore::Array3D< KeyType >( resolution, GvCore::Array3D< KeyType >::StandardHeapMemory );
+	GvCore::Array3D< uint >* values = new GvCore::Array3D< uint >( resolution, GvCore::Array3D< uint >::StandardHeapMemory );
+	memcpyArray( keys, _keyArray );
+	memcpyArray( values, _valueArray );
+
+	// Insert its keys in a new table, with the CPU implementation
+	GvCore::Array3D< KeyType >* newKeys = new GvCore::Array3D< KeyType >( resolution, GvCore::Array3D< KeyType >::StandardHeapMemory );
+	GvCore::Array3D< uint >* newValues = new GvCore::Array3D< uint >( resolution, GvCore::Array3D< uint >::StandardHeapMemory );
+	KernelType table = _kernelObject;
+	table._keys = newKeys->getPointer();
+	table._values = newValues->getPointer();
+
+	const size_t nbSlots = keys->getNumElements();
+	for ( size_t i = 0; i < nbSlots; i++ )
+	{
+		newKeys->get( i ) = GV_SPATIAL_HASH_EMPTY_KEY;
+		newValues->get( i ) = GV_SPATIAL_HASH_INVALID_VALUE;
+	}
+
+	uint nbKeys = 0;
+	for ( size_t i = 0; i < nbSlots; i++ )
+	{
+		const KeyType key = keys->get( i );
+		if ( key != GV_SPATIAL_HASH_EMPTY_KEY && key != GV_SPATIAL_HASH_DELETED_KEY )
+		{
+			table.insert( key, values->get( i ) );
+			nbKeys++;
+		}
+	}
+
+	// Upload the new table
+	memcpyArray( _keyArray, newKeys->getPointer() );
+	memcpyArray( _valueArray, newValues->getPointer() );
+
+	delete keys;
+	delete values;
+	delete newKeys;
+	delete newValues;
+
+	return nbKeys;
+}
+
+/******************************************************************************
+ * Get the spatial hash on GPU side
+ *
+ * @return the spatial hash on GPU side
+ ******************************************************************************/
+template< class DataTList, class NodeTileRes, class BrickRes, uint BorderSize >
+inline const typename GvSpatialHash< DataTList, NodeTileRes, BrickRes, BorderSize >::KernelType& GvSpatialHash< DataTList, NodeTileRes, BrickRes, BorderSize >
+::getKernelObject() const
+{
+	return _kernelObject;
+}
+
+/******************************************************************************
+ * Get the number of slots of the table
+ *
+ * @return the number of slots
+ ******************************************************************************/
+template< class DataTList, class NodeTileRes, class BrickRes, uint BorderSize >
+inline uint GvSpatialHash< DataTList, NodeTileRes, BrickRes, BorderSize >
+::getCapacity() const
+{
+	return _kernelObject._capacityMask + 1;
+}
+
+/******************************************************************************
+ * Get the number of bricks of the data pool
+ *
+ * @return the number of bricks
+ ******************************************************************************/
+template< class DataTList, class NodeTileRes, class BrickRes, uint BorderSize >
+inline uint GvSpatialHash< DataTList, NodeTileRes, BrickRes, BorderSize >
+::getNbBricks() const
+{
+	return _nbBricks;
+}
+
+/******************************************************************************
+ * This method is called to serialize an object
+ *
+ * Only the table is written : as for GvVolumeTree, the data pool is not serialized.
+ *
+ * @param pStream the stream where to write
+ ******************************************************************************/
+template< class DataTList, class NodeTileRes, class BrickRes, uint BorderSize >
+inline void GvSpatialHash< DataTList, NodeTileRes, BrickRes, BorderSize >
+::write( std::ostream& pStream ) const
+{
+	const uint capacity = getCapacity();
+	pStream.write( reinterpret_cast< const char* >( &capacity ), sizeof( uint ) );
+
+	// - keys
+	GvCore::Array3D< KeyType >* keys = new GvCore::Array3D< KeyType >( _keyArray->getResolution(), GvCore::Array3D< KeyType >::StandardHeapMemory );
+	memcpyArray( keys, _keyArray );
+	pStream.write( reinterpret_cast< const char* >( keys->getPointer() ), sizeof( KeyType ) * keys->getNumElements() );
+	delete keys;
+
+	// - values
+	GvCore::Array3D< uint >* values = new GvCore::Array3D< uint >( _valueArray->getResolution(), GvCore::Array3D< uint >::StandardHeapMemory );
+	memcpyArray( values, _valueArray );
+	pStream.write( reinterpret_cast< const char* >( values->getPointer() ), sizeof( uint ) * values->getNumElements() );
+	delete values;
+}
+
+/******************************************************************************
+ * This method is called deserialize an object
+ *
+ * @param pStream the stream from which to read
+ ******************************************************************************/
+template< class DataTList, class NodeTileRes, class BrickRes, uint BorderSize >
+inline void GvSpatialHash< DataTList, NodeTileRes, BrickRes, BorderSize >
+::read( std::istream& pStream )
+{
+	uint capacity = 0;
+	pStream.read( reinterpret_cast< char* >( &capacity ), sizeof( uint ) );
+	if ( ! pStream || capacity != getCapacity() )
+	{
+		std::cerr << "GvSpatialHash::read : the table has " << capacity << " slots instead of " << getCapacity() << std::endl;
+
+		return;
+	}
+
+	// - keys
+	GvCore::Array3D< KeyType >* keys = new GvCore::Array3D< KeyType >( _keyArray->getResolution(), GvCore::Array3D< KeyType >::StandardHeapMemory );
+	pStream.read( reinterpret_cast< char* >( keys->getPointer() ), sizeof( KeyType ) * keys->getNumElements() );
+
+	// - values
+	GvCore::Array3D< uint >* values = new GvCore::Array3D< uint >( _valueArray->getResolution(), GvCore::Array3D< uint >::StandardHeapMemory );
+	pStream.read( reinterpret_cast< char* >( values->getPointer() ), sizeof( uint ) * values->getNumElements() );
+
+	if ( pStream )
+	{
+		memcpyArray( _keyArray, keys->getPointer() );
+		memcpyArray( _valueArray, values->getPointer() );
+	}
+	else
+	{
+		std::cerr << "GvSpatialHash::read : unexpected end of stream" << std::endl;
+	}
+
+	delete keys;
+	delete values;
+}
+
+} // namespace GvStructure
@@ -0,0 +1,252 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_SPATIAL_HASH_KERNEL_H_
+#define _GV_SPATIAL_HASH_KERNEL_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+#include "GvCore/GvMortonCode.h"
+
+// Cuda
+#include <vector_types.h>
+#include <host_defines.h>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Special keys of the spatial hash
+ *
+ * - EMPTY : the slot has never been used (it ends a probe sequence)
+ * - DELETED : the slot has been erased (tombstone, probing goes on)
+ *
+ * Neither of them can be a node key (see GvCore::GvMortonCode::encodeNode()).
+ */
+#define GV_SPATIAL_HASH_EMPTY_KEY		0ULL
+#define GV_SPATIAL_HASH_DELETED_KEY		1ULL
+
+/**
+ * Value of a slot whose value is not available (missing key, or key being inserted)
+ */
+#define GV_SPATIAL_HASH_INVALID_VALUE	0xFFFFFFFFU
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvStructure
+{
+
+/** 
+ * @struct GvSpatialHashKernel
+ *
+ * @brief The GvSpatialHashKernel struct provides the device-side interface
+ * of a spatial hash data structure (see GvSpatialHash).
+ *
+ * Nodes of all levels of resolution live in one open-addressing hash table
+ * (linear probing) : a node is identified by its Morton key (level and position,
+ * see GvCore::GvMortonCode::encodeNode()) and maps to the address of its brick
+ * in the data pool. There is no node pool and no pointer chasing : a lookup at
+ * a given level is O(1), whatever the depth.
+ *
+ * Insertion is lock-free (a 64-bits compare-and-swap on the key slot), so producers
+ * of a same pass can insert concurrently. Erased slots become tombstones that insert()
+ * reuses. A key can't be inserted twice by concurrent inserts, as long as no erase()
+ * runs in the same pass (an erased slot could then be claimed by one insert
+ * after another one has gone past it) : insert and erase in separate kernel launches.
+ *
+ * All methods are __host__ __device__ : called on host memory, the same code is
+ * the CPU reference implementation of the structure. A table filled on host can be
+ * uploaded and searched on device, as the set of nodes to invalidate
+ * (see GvDataProductionManager::invalidateNodes()).
+ *
+ * @param NodeTileRes Node tile resolution (used to build node keys)
+ */
+template< class NodeTileRes >
+struct GvSpatialHashKernel
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Type definition of keys
+	 */
+	typedef GvCore::GvMortonCode::ValueType KeyType;
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Key array (one key per slot)
+	 */
+	KeyType* _keys;
+
+	/**
+	 * Value array (one brick address per slot)
+	 */
+	uint* _values;
+
+	/**
+	 * Number of slots minus one (the number of slots is a power of two)
+	 */
+	uint _capacityMask;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Get the slot where the probe sequence of a key starts
+	 *
+	 * @param pKey the key
+	 *
+	 * @return the hash of the key
+	 */
+	__host__ __device__
+	static inline uint hash( KeyType pKey );
+
+	/**
+	 * Atomically replace the key of a slot if it is equal to a given value
+	 *
+	 * @param pAddress the address of the key slot
+	 * @param pCompare the expected key
+	 * @param pKey the new key
+	 *
+	 * @return the key of the slot before the operation
+	 */
+	__host__ __device__
+	static inline KeyType compareAndSwap( KeyType* pAddress, KeyType pCompare, KeyType pKey );
+
+	/**
+	 * Get the key of the node of a given depth containing a position
+	 *
+	 * @param pPosition the position in normalized space [ 0.0 ; 1.0 ]
+	 * @param pDepth the depth of the node (must not exceed GvCore::GvMortonCode::getMaxDepth())
+	 *
+	 * @return the key of the node
+	 */
+	__host__ __device__
+	static inline KeyType getKey( float3 pPosition, uint pDepth );
+
+	/**
+	 * Find the value associated to a key
+	 *
+	 * @param pKey the key
+	 *
+	 * @return the value, or GV_SPATIAL_HASH_INVALID_VALUE if the key is not in the table
+	 */
+	__host__ __device__
+	inline uint find( KeyType pKey ) const;
+
+	/**
+	 * Insert a key if it is not already in the table
+	 *
+	 * The key is stored in the first free slot (empty or erased) of its probe sequence.
+	 *
+	 * @param pKey the key
+	 * @param pValue the value to associate to the key
+	 *
+	 * @return true if the key has been inserted, false if it was already
+	 * in the table (its value is unchanged) or if the table is full
+	 */
+	__host__ __device__
+	inline bool insert( KeyType pKey, uint pValue );
+
+	/**
+	 * Erase a key
+	 *
+	 * @param pKey the key
+	 *
+	 * @return the value that was associated to the key, or GV_SPATIAL_HASH_INVALID_VALUE
+	 * if the key was not in the table
+	 */
+	__host__ __device__
+	inline uint erase( KeyType pKey );
+
+	/**
+	 * Find the deepest node containing a position
+	 *
+	 * Levels are probed from the coarsest one, and the search stops at the first missing level.
+	 *
+	 * @param pPosition the position in normalized space [ 0.0 ; 1.0 ]
+	 * @param pMaxDepth the max depth to look for
+	 * @param pDepth the depth of the node found
+	 *
+	 * @return the value of the node, or GV_SPATIAL_HASH_INVALID_VALUE if no node contains the position
+	 */
+	__host__ __device__
+	inline uint findDeepest( float3 pPosition, uint pMaxDepth, uint& pDepth ) const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+};
+
+} // namespace GvStructure
+
+/**************************************************************************
+ ***************************** INLINE SECTION *****************************
+ **************************************************************************/
+
+#include "GvSpatialHashKernel.inl"
+
+#endif
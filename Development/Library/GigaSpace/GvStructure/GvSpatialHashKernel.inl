@@ -0,0 +1,305 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// System
+#if ! defined( __CUDA_ARCH__ ) && defined( _MSC_VER )
+	#include <intrin.h>
+#endif
+
+/******************************************************************************
+ ****************************** INLINE DEFINITION *****************************
+ ******************************************************************************/
+
+namespace GvStructure
+{
+
+/******************************************************************************
+ * Get the slot where the probe sequence of a key starts
+ *
+ * @param pKey the key
+ *
+ * @return the hash of the key
+ ******************************************************************************/
+template< class NodeTileRes >
+__host__ __device__
+inline uint GvSpatialHashKernel< NodeTileRes >::hash( KeyType pKey )
+{
+	// 64-bits finalizer (keys of neighbour nodes only differ in their lowest bits)
+	pKey ^= pKey >> 33;
+	pKey *= 0xff51afd7ed558ccdULL;
+	pKey ^= pKey >> 33;
+	pKey *= 0xc4ceb9fe1a85ec53ULL;
+	pKey ^= pKey >> 33;
+
+	return static_cast< uint >( pKey );
+}
+
+/******************************************************************************
+ * Atomically replace the key of a slot if it is equal to a given value
+ *
+ * @param pAddress the address of the key slot
+ * @param pCompare the expected key
+ * @param pKey the new key
+ *
+ * @return the key of the slot before the operation
+ ******************************************************************************/
+template< class NodeTileRes >
+__host__ __device__
+inline typename GvSpatialHashKernel< NodeTileRes >::KeyType GvSpatialHashKernel< NodeTileRes >
+::compareAndSwap( KeyType* pAddress, KeyType pCompare, KeyType pKey )
+{
+#if defined( __CUDA_ARCH__ )
+	return atomicCAS( pAddress, pCompare, pKey );
+#elif defined( _MSC_VER )
+	return static_cast< KeyType >( _InterlockedCompareExchange64( reinterpret_cast< volatile __int64* >( pAddress ), static_cast< __int64 >( pKey ), static_cast< __int64 >( pCompare ) ) );
+#else
+	return __sync_val_compare_and_swap( pAddress, pCompare, pKey );
+#endif
+}
+
+/******************************************************************************
+ * Get the key of the node of a given depth containing a position
+ *
+ * @param pPosition the position in normalized space [ 0.0 ; 1.0 ]
+ * @param pDepth the depth of the node (must not exceed GvCore::GvMortonCode::getMaxDepth())
+ *
+ * @return the key of the node
+ ******************************************************************************/
+template< class NodeTileRes >
+__host__ __device__
+inline typename GvSpatialHashKernel< NodeTileRes >::KeyType GvSpatialHashKernel< NodeTileRes >
+::getKey( float3 pPosition, uint pDepth )
+{
+	// A node of depth d has a localization code of d + 1 levels
+	const uint nbBits = ( pDepth + 1 ) * NodeTileRes::xLog2;
+	const float resolution = static_cast< float >( 1U << nbBits );
+	const uint maxCode = ( 1U << nbBits ) - 1;
+
+	// Positions outside the unit cube are clamped to the border nodes
+	const float x = pPosition.x > 0.0f ? pPosition.x * resolution : 0.0f;
+	const float y = pPosition.y > 0.0f ? pPosition.y * resolution : 0.0f;
+	const float z = pPosition.z > 0.0f ? pPosition.z * resolution : 0.0f;
+
+	uint3 code;
+	code.x = x < static_cast< float >( maxCode ) ? static_cast< uint >( x ) : maxCode;
+	code.y = y < static_cast< float >( maxCode ) ? static_cast< uint >( y ) : maxCode;
+	code.z = z < static_cast< float >( maxCode ) ? static_cast< uint >( z ) : maxCode;
+
+	return GvCore::GvMortonCode::encode( code, nbBits );
+}
+
+/******************************************************************************
+ * Find the value associated to a key
+ *
+ * @param pKey the key
+ *
+ * @return the value, or GV_SPATIAL_HASH_INVALID_VALUE if the key is not in the table
+ ******************************************************************************/
+template< class NodeTileRes >
+__host__ __device__
+inline uint GvSpatialHashKernel< NodeTileRes >::find( KeyType pKey ) const
+{
+	// Slots may be modified concurrently by insert() and erase()
+	const volatile KeyType* keys = _keys;
+	const volatile uint* values = _values;
+
+	uint slot = hash( pKey ) & _capacityMask;
+	for ( uint i = 0; i <= _capacityMask; i++ )
+	{
+		const KeyType key = keys[ slot ];
+		if ( key == pKey )
+		{
+			// Note : the value is still invalid if the key is being inserted
+			return values[ slot ];
+		}
+		if ( key == GV_SPATIAL_HASH_EMPTY_KEY )
+		{
+			break;
+		}
+
+		slot = ( slot + 1 ) & _capacityMask;
+	}
+
+	return GV_SPATIAL_HASH_INVALID_VALUE;
+}
+
+/******************************************************************************
+ * Insert a key if it is not already in the table
+ *
+ * The key is stored in the first free slot (empty or erased) of its probe sequence,
+ * once the whole sequence has been searched for it.
+ *
+ * @param pKey the key
+ * @param pValue the value to associate to the key
+ *
+ * @return true if the key has been inserted, false if it was already
+ * in the table (its value is unchanged) or if the table is full
+ ******************************************************************************/
+template< class NodeTileRes >
+__host__ __device__
+inline bool GvSpatialHashKernel< NodeTileRes >::insert( KeyType pKey, uint pValue )
+{
+	// Slots may be modified concurrently by insert()
+	const volatile KeyType* keys = _keys;
+
+	const uint start = hash( pKey ) & _capacityMask;
+
+	// Search the key up to the end of its probe sequence,
+	// and remember the first free slot
+	uint firstFree = _capacityMask + 1;
+	uint slot = start;
+	for ( uint i = 0; i <= _capacityMask; i++ )
+	{
+		const KeyType key = keys[ slot ];
+		if ( key == pKey )
+		{
+			return false;
+		}
+		if ( ( key == GV_SPATIAL_HASH_EMPTY_KEY || key == GV_SPATIAL_HASH_DELETED_KEY ) && firstFree > _capacityMask )
+		{
+			firstFree = i;
+		}
+		if ( key == GV_SPATIAL_HASH_EMPTY_KEY )
+		{
+			break;
+		}
+
+		slot = ( slot + 1 ) & _capacityMask;
+	}
+
+	// Claim the first free slot. Concurrent inserts of a same key all try to claim
+	// the same slots in the same order, so only one of them succeeds.
+	slot = ( start + firstFree ) & _capacityMask;
+	for ( uint i = firstFree; i <= _capacityMask; i++ )
+	{
+		KeyType key = keys[ slot ];
+		if ( key == GV_SPATIAL_HASH_EMPTY_KEY || key == GV_SPATIAL_HASH_DELETED_KEY )
+		{
+			const KeyType previousKey = compareAndSwap( &_keys[ slot ], key, pKey );
+			if ( previousKey == key )
+			{
+				// Publish the value once the slot is owned
+				_values[ slot ] = pValue;
+#if defined( __CUDA_ARCH__ )
+				__threadfence();
+#endif
+				return true;
+			}
+
+			key = previousKey;
+		}
+		if ( key == pKey )
+		{
+			return false;
+		}
+
+		slot = ( slot + 1 ) & _capacityMask;
+	}
+
+	// The table is full
+	return false;
+}
+
+/******************************************************************************
+ * Erase a key
+ *
+ * @param pKey the key
+ *
+ * @return the value that was associated to the key, or GV_SPATIAL_HASH_INVALID_VALUE
+ * if the key was not in the table
+ ******************************************************************************/
+template< class NodeTileRes >
+__host__ __device__
+inline uint GvSpatialHashKernel< NodeTileRes >::erase( KeyType pKey )
+{
+	const volatile KeyType* keys = _keys;
+
+	uint slot = hash( pKey ) & _capacityMask;
+	for ( uint i = 0; i <= _capacityMask; i++ )
+	{
+		const KeyType key = keys[ slot ];
+		if ( key == pKey )
+		{
+			// Only one of concurrent erase() calls wins
+			if ( compareAndSwap( &_keys[ slot ], pKey, GV_SPATIAL_HASH_DELETED_KEY ) != pKey )
+			{
+				break;
+			}
+
+			const uint value = _values[ slot ];
+			_values[ slot ] = GV_SPATIAL_HASH_INVALID_VALUE;
+
+			return value;
+		}
+		if ( key == GV_SPATIAL_HASH_EMPTY_KEY )
+		{
+			break;
+		}
+
+		slot = ( slot + 1 ) & _capacityMask;
+	}
+
+	return GV_SPATIAL_HASH_INVALID_VALUE;
+}
+
+/******************************************************************************
+ * Find the deepest node containing a position
+ *
+ * Levels are probed from the coarsest one, and the search stops at the first missing level.
+ *
+ * @param pPosition the position in normalized space [ 0.0 ; 1.0 ]
+ * @param pMaxDepth the max depth to look for
+ * @param pDepth the depth of the node found
+ *
+ * @return the value of the node, or GV_SPATIAL_HASH_INVALID_VALUE if no node contains the position
+ ******************************************************************************/
+template< class NodeTileRes >
+__host__ __device__
+inline uint GvSpatialHashKernel< NodeTileRes >::findDeepest( float3 pPosition, uint pMaxDepth, uint& pDepth ) const
+{
+	uint result = GV_SPATIAL_HASH_INVALID_VALUE;
+	pDepth = 0;
+
+	for ( uint depth = 0; depth <= pMaxDepth; depth++ )
+	{
+		const uint value = find( getKey( pPosition, depth ) );
+		if ( value == GV_SPATIAL_HASH_INVALID_VALUE )
+		{
+			break;
+		}
+
+		result = value;
+		pDepth = depth;
+	}
+
+	return result;
+}
+
+} // namespace GvStructure
@@ -198,6 +198,9 @@ struct GvVolumeTree : public GvIDataStructure
 	/**
 	 * Localization code array
 	 *
+	 * Codes and depths are not packed in 64-bit Morton keys here (see GvCore::GvMortonCode) :
+	 * keys can't hold all node tile resolutions and depths, they are only built for request lists.
+	 *
 	 * @todo The creation of the localization arrays should be moved in the Cache Management System, not in the data structure (this is cache implementation details/features)
 	 */
 	GvCore::Array3DGPULinear< GvCore::GvLocalizationInfo::CodeType >* _localizationCodeArray;
@@ -110,6 +110,11 @@ struct GvBrickLoaderChannelInitializer
 	 */
 	unsigned int _level;
 
+	/**
+	 * 3D node indexed position
+	 */
+	uint3 _blockPosition;
+
 	/**
 	 * Reference on a data pool
 	 */
@@ -129,11 +134,12 @@ struct GvBrickLoaderChannelInitializer
 	 * @param pIndexValue Index value
 	 * @param pBlockMemSize Block memory size
 	 * @param pLevel level of resolution
+	 * @param pBlockPosition 3D node indexed position
 	 * @param pDataPool reference on a data pool
 	 * @param pOffsetInPool offset in the referenced data pool
 	 */
 	inline GvBrickLoaderChannelInitializer( GvDataLoader< TDataTypeList >* pCaller,
-											unsigned int pIndexValue, unsigned int pBlockMemSize, unsigned int pLevel,
+											unsigned int pIndexValue, unsigned int pBlockMemSize, unsigned int pLevel, const uint3& pBlockPosition,
 											GvCore::GPUPoolHost< GvCore::Array3D, TDataTypeList >* pDataPool, size_t pOffsetInPool );
 
 	/**
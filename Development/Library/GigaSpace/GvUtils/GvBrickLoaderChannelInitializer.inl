@@ -46,18 +46,20 @@ namespace GvUtils
  * @param pIndexValue Index value
  * @param pBlockMemSize Block memory size
  * @param pLevel level of resolution
+ * @param pBlockPosition 3D node indexed position
  * @param pDataPool reference on a data pool
  * @param pOffsetInPool offset in the referenced data pool
  ******************************************************************************/
 template< typename TDataTypeList >
 inline GvBrickLoaderChannelInitializer< TDataTypeList >
 ::GvBrickLoaderChannelInitializer( GvDataLoader< TDataTypeList >* pCaller,
-									unsigned int pIndexValue, unsigned int pBlockMemSize, unsigned int pLevel,
+									unsigned int pIndexValue, unsigned int pBlockMemSize, unsigned int pLevel, const uint3& pBlockPosition,
 									GvCore::GPUPoolHost< GvCore::Array3D, TDataTypeList >* pDataPool, size_t pOffsetInPool )
 :	_caller( pCaller )
 ,	_indexValue( pIndexValue )
 ,	_blockMemorySize( pBlockMemSize )
 ,	_level( pLevel )
+,	_blockPosition( pBlockPosition )
 ,	_dataPool( pDataPool )
 ,	_offsetInPool( pOffsetInPool )
 {
@@ -80,7 +82,15 @@ inline void GvBrickLoaderChannelInitializer< TDataTypeList >
 	GvCore::Array3D< ChannelType >* dataArray = _dataPool->template getChannel< TChannelIndex >();
 
 	// Ask the referenced brick producer to read a brick
-	_caller->template readBrick< ChannelType >( TChannelIndex, _indexValue, _blockMemorySize, _level, dataArray, _offsetInPool );
+	// (borders of bricks stored without borders are reconstructed from neighbor bricks)
+	if ( _caller->isBorderless() )
+	{
+		_caller->template readBorderlessBrick< ChannelType >( TChannelIndex, _indexValue, _level, _blockPosition, dataArray, _offsetInPool );
+	}
+	else
+	{
+		_caller->template readBrick< ChannelType >( TChannelIndex, _indexValue, _blockMemorySize, _level, dataArray, _offsetInPool );
+	}
 }
 
 } // namespace GvUtils
@@ -0,0 +1,397 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#include "GvUtils/GvBrickServerClient.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// System
+#ifndef WIN32
+	#include <sys/mman.h>
+	#include <sys/socket.h>
+	#include <sys/un.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <cerrno>
+#endif
+
+// STL
+#include <cstring>
+#include <iostream>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvUtils;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Number of attempts and delay between attempts (in microseconds)
+ * when the server has no slot available
+ */
+static const unsigned int cNbAcquireRetries = 100;
+static const unsigned int cAcquireRetryDelay = 1000;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvBrickServerClient::GvBrickServerClient()
+:	_socket( -1 )
+,	_sharedMemory( NULL )
+,	_sharedMemorySize( 0 )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvBrickServerClient::~GvBrickServerClient()
+{
+	disconnect();
+}
+
+/******************************************************************************
+ * Connect to a brick server and map its shared memory
+ *
+ * @param pSocketPath path of the Unix socket of the server
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvBrickServerClient::connect( const std::string& pSocketPath )
+{
+#ifndef WIN32
+	disconnect();
+
+	// Connect to the server
+	sockaddr_un address;
+	memset( &address, 0, sizeof( address ) );
+	address.sun_family = AF_UNIX;
+	if ( pSocketPath.size() >= sizeof( address.sun_path ) )
+	{
+		std::cerr << "GvBrickServerClient::connect() : socket path too long : " << pSocketPath << std::endl;
+		return false;
+	}
+	strncpy( address.sun_path, pSocketPath.c_str(), sizeof( address.sun_path ) - 1 );
+
+	_socket = socket( AF_UNIX, SOCK_STREAM, 0 );
+	if ( _socket < 0 || ::connect( _socket, reinterpret_cast< sockaddr* >( &address ), sizeof( address ) ) != 0 )
+	{
+		std::cerr << "GvBrickServerClient::connect() : unable to connect to " << pSocketPath << " : " << strerror( errno ) << std::endl;
+		disconnect();
+		return false;
+	}
+
+	// Retrieve the shared memory
+	GvBrickServerProtocol::Request request;
+	memset( &request, 0, sizeof( request ) );
+	request._command = GvBrickServerProtocol::eHello;
+	GvBrickServerProtocol::Response response;
+	if ( ! sendRequest( request, response ) || response._status != GvBrickServerProtocol::eOk )
+	{
+		std::cerr << "GvBrickServerClient::connect() : handshake failed" << std::endl;
+		disconnect();
+		return false;
+	}
+	response._sharedMemoryName[ GV_BRICK_SERVER_NAME_SIZE - 1 ] = '\0';
+
+	// Map the shared memory (read-only)
+	int sharedMemoryFile = shm_open( response._sharedMemoryName, O_RDONLY, 0 );
+	if ( sharedMemoryFile < 0 )
+	{
+		std::cerr << "GvBrickServerClient::connect() : unable to open shared memory " << response._sharedMemoryName << " : " << strerror( errno ) << std::endl;
+		disconnect();
+		return false;
+	}
+	void* sharedMemory = mmap( NULL, static_cast< size_t >( response._sharedMemorySize ), PROT_READ, MAP_SHARED, sharedMemoryFile, 0 );
+	close( sharedMemoryFile );
+	if ( sharedMemory == MAP_FAILED )
+	{
+		std::cerr << "GvBrickServerClient::connect() : unable to map shared memory : " << strerror( errno ) << std::endl;
+		disconnect();
+		return false;
+	}
+	_sharedMemory = sharedMemory;
+	_sharedMemorySize = static_cast< size_t >( response._sharedMemorySize );
+
+	// Check the protocol
+	const GvBrickServerProtocol::Header* header = getHeader();
+	if ( header->_magic != GV_BRICK_SERVER_MAGIC || header->_version != GV_BRICK_SERVER_VERSION )
+	{
+		std::cerr << "GvBrickServerClient::connect() : incompatible brick server" << std::endl;
+		disconnect();
+		return false;
+	}
+
+	return true;
+#else
+	std::cerr << "GvBrickServerClient::connect() : brick server is not available on this platform" << std::endl;
+	return false;
+#endif
+}
+
+/******************************************************************************
+ * Disconnect from the brick server.
+ * References on acquired bricks are released by the server.
+ ******************************************************************************/
+void GvBrickServerClient::disconnect()
+{
+#ifndef WIN32
+	if ( _sharedMemory != NULL )
+	{
+		munmap( _sharedMemory, _sharedMemorySize );
+		_sharedMemory = NULL;
+		_sharedMemorySize = 0;
+	}
+	if ( _socket >= 0 )
+	{
+		close( _socket );
+		_socket = -1;
+	}
+#endif
+}
+
+/******************************************************************************
+ * Tell wheter or not the client is connected
+ *
+ * @return a flag telling wheter or not the client is connected
+ ******************************************************************************/
+bool GvBrickServerClient::isConnected() const
+{
+	return _sharedMemory != NULL;
+}
+
+/******************************************************************************
+ * Retrieve the shared memory header (dataset description and statistics)
+ *
+ * @return the header (NULL if not connected)
+ ******************************************************************************/
+const GvBrickServerProtocol::Header* GvBrickServerClient::getHeader() const
+{
+	return static_cast< const GvBrickServerProtocol::Header* >( _sharedMemory );
+}
+
+/******************************************************************************
+ * Retrieve a node
+ *
+ * @param pLevel level of resolution
+ * @param pX x position of the node in the node grid of the level
+ * @param pY y position of the node in the node grid of the level
+ * @param pZ z position of the node in the node grid of the level
+ *
+ * @return the node encoded information (0 if out of bounds)
+ ******************************************************************************/
+unsigned int GvBrickServerClient::getNode( unsigned int pLevel, unsigned int pX, unsigned int pY, unsigned int pZ ) const
+{
+	const GvBrickServerProtocol::Header* header = getHeader();
+	if ( header == NULL || pLevel >= header->_nbLevels )
+	{
+		return 0;
+	}
+
+	const size_t gridSize = header->_nodeGridSize[ pLevel ];
+	if ( pX >= gridSize || pY >= gridSize || pZ >= gridSize )
+	{
+		return 0;
+	}
+
+	return GvBrickServerProtocol::getNodes( _sharedMemory, pLevel )[ pX + gridSize * ( pY + gridSize * pZ ) ];
+}
+
+/******************************************************************************
+ * Retrieve a node summary
+ *
+ * @param pLevel level of resolution
+ * @param pX x position of the node in the node grid of the level
+ * @param pY y position of the node in the node grid of the level
+ * @param pZ z position of the node in the node grid of the level
+ * @param pChannel data channel index
+ * @param pSummary the resulting node summary
+ *
+ * @return a flag telling wheter or not a summary is available for that node
+ ******************************************************************************/
+bool GvBrickServerClient::getSummary( unsigned int pLevel, unsigned int pX, unsigned int pY, unsigned int pZ, unsigned int pChannel, GvVoxelizer::GvNodeSummary& pSummary ) const
+{
+	const GvBrickServerProtocol::Header* header = getHeader();
+	if ( header == NULL || pLevel >= header->_nbLevels || pChannel >= header->_nbChannels || header->_summariesOffset[ pLevel ] == 0 )
+	{
+		return false;
+	}
+
+	const size_t gridSize = header->_nodeGridSize[ pLevel ];
+	if ( pX >= gridSize || pY >= gridSize || pZ >= gridSize )
+	{
+		return false;
+	}
+
+	// Summaries are stored in the same order as nodes, with one summary per channel
+	const GvVoxelizer::GvNodeSummary* summaries = reinterpret_cast< const GvVoxelizer::GvNodeSummary* >( static_cast< const char* >( _sharedMemory ) + header->_summariesOffset[ pLevel ] );
+	pSummary = summaries[ ( pX + gridSize * ( pY + gridSize * pZ ) ) * header->_nbChannels + pChannel ];
+
+	return true;
+}
+
+/******************************************************************************
+ * Acquire the brick of a node.
+ * The server loads the brick in a slot if it is not already in its cache.
+ * If all slots are referenced, the request is retried for a short time.
+ *
+ * @param pLevel level of resolution
+ * @param pNodeInfo node encoded information (holding the brick address)
+ *
+ * @return the slot index (GV_BRICK_SERVER_INVALID_SLOT on error)
+ ******************************************************************************/
+unsigned int GvBrickServerClient::acquireBrick( unsigned int pLevel, unsigned int pNodeInfo )
+{
+	GvBrickServerProtocol::Request request;
+	memset( &request, 0, sizeof( request ) );
+	request._command = GvBrickServerProtocol::eAcquire;
+	request._level = pLevel;
+	request._nodeInfo = pNodeInfo;
+
+	// Retry while all slots of the server are referenced by other clients
+	GvBrickServerProtocol::Response response;
+	for ( unsigned int i = 0; i < cNbAcquireRetries; i++ )
+	{
+		if ( ! sendRequest( request, response ) )
+		{
+			return GV_BRICK_SERVER_INVALID_SLOT;
+		}
+		if ( response._status != GvBrickServerProtocol::eBusy )
+		{
+			break;
+		}
+#ifndef WIN32
+		usleep( cAcquireRetryDelay );
+#endif
+	}
+
+	return ( response._status == GvBrickServerProtocol::eOk ) ? response._slot : GV_BRICK_SERVER_INVALID_SLOT;
+}
+
+/******************************************************************************
+ * Retrieve the data of a channel of an acquired brick
+ *
+ * @param pSlot slot index
+ * @param pChannel channel index
+ *
+ * @return the brick data
+ ******************************************************************************/
+const void* GvBrickServerClient::getBrickData( unsigned int pSlot, unsigned int pChannel ) const
+{
+	return GvBrickServerProtocol::getBrickData( _sharedMemory, pSlot, pChannel );
+}
+
+/******************************************************************************
+ * Release an acquired brick
+ *
+ * @param pSlot slot index
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvBrickServerClient::releaseBrick( unsigned int pSlot )
+{
+	GvBrickServerProtocol::Request request;
+	memset( &request, 0, sizeof( request ) );
+	request._command = GvBrickServerProtocol::eRelease;
+	request._slot = pSlot;
+
+	GvBrickServerProtocol::Response response;
+	return sendRequest( request, response ) && response._status == GvBrickServerProtocol::eOk;
+}
+
+/******************************************************************************
+ * Send a request and wait for the response
+ *
+ * @param pRequest the request
+ * @param pResponse the response
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvBrickServerClient::sendRequest( const GvBrickServerProtocol::Request& pRequest, GvBrickServerProtocol::Response& pResponse )
+{
+#ifndef WIN32
+	if ( _socket < 0 )
+	{
+		return false;
+	}
+
+	// Send the request
+	const char* request = reinterpret_cast< const char* >( &pRequest );
+	size_t size = 0;
+	while ( size < sizeof( pRequest ) )
+	{
+		const ssize_t result = send( _socket, request + size, sizeof( pRequest ) - size, MSG_NOSIGNAL );
+		if ( result <= 0 )
+		{
+			if ( result < 0 && errno == EINTR )
+			{
+				continue;
+			}
+			std::cerr << "GvBrickServerClient::sendRequest() : connection lost" << std::endl;
+			return false;
+		}
+		size += static_cast< size_t >( result );
+	}
+
+	// Wait for the response
+	char* response = reinterpret_cast< char* >( &pResponse );
+	size = 0;
+	while ( size < sizeof( pResponse ) )
+	{
+		const ssize_t result = recv( _socket, response + size, sizeof( pResponse ) - size, 0 );
+		if ( result <= 0 )
+		{
+			if ( result < 0 && errno == EINTR )
+			{
+				continue;
+			}
+			std::cerr << "GvBrickServerClient::sendRequest() : connection lost" << std::endl;
+			return false;
+		}
+		size += static_cast< size_t >( result );
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
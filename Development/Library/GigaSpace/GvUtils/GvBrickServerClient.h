@@ -0,0 +1,242 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#ifndef _GV_BRICK_SERVER_CLIENT_H_
+#define _GV_BRICK_SERVER_CLIENT_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+#include "GvUtils/GvBrickServerProtocol.h"
+#include "GvVoxelizer/GvNodeSummary.h"
+
+// STL
+#include <string>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvUtils
+{
+
+/**
+ * @class GvBrickServerClient
+ *
+ * @brief The GvBrickServerClient class provides a connection to a local brick server
+ * (see GvBrickServerProtocol).
+ *
+ * The shared memory of the server is mapped read-only : nodes and summaries are read
+ * directly, and bricks are read from their slot between acquireBrick() and releaseBrick().
+ *
+ * A client is not thread-safe : use one client per thread.
+ * Only available on POSIX systems (connect() fails on other systems).
+ */
+class GIGASPACE_EXPORT GvBrickServerClient
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvBrickServerClient();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvBrickServerClient();
+
+	/**
+	 * Connect to a brick server and map its shared memory
+	 *
+	 * @param pSocketPath path of the Unix socket of the server
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool connect( const std::string& pSocketPath );
+
+	/**
+	 * Disconnect from the brick server.
+	 * References on acquired bricks are released by the server.
+	 */
+	void disconnect();
+
+	/**
+	 * Tell wheter or not the client is connected
+	 *
+	 * @return a flag telling wheter or not the client is connected
+	 */
+	bool isConnected() const;
+
+	/**
+	 * Retrieve the shared memory header (dataset description and statistics)
+	 *
+	 * @return the header (NULL if not connected)
+	 */
+	const GvBrickServerProtocol::Header* getHeader() const;
+
+	/**
+	 * Retrieve a node
+	 *
+	 * @param pLevel level of resolution
+	 * @param pX x position of the node in the node grid of the level
+	 * @param pY y position of the node in the node grid of the level
+	 * @param pZ z position of the node in the node grid of the level
+	 *
+	 * @return the node encoded information (0 if out of bounds)
+	 */
+	unsigned int getNode( unsigned int pLevel, unsigned int pX, unsigned int pY, unsigned int pZ ) const;
+
+	/**
+	 * Retrieve a node summary
+	 *
+	 * @param pLevel level of resolution
+	 * @param pX x position of the node in the node grid of the level
+	 * @param pY y position of the node in the node grid of the level
+	 * @param pZ z position of the node in the node grid of the level
+	 * @param pChannel data channel index
+	 * @param pSummary the resulting node summary
+	 *
+	 * @return a flag telling wheter or not a summary is available for that node
+	 */
+	bool getSummary( unsigned int pLevel, unsigned int pX, unsigned int pY, unsigned int pZ, unsigned int pChannel, GvVoxelizer::GvNodeSummary& pSummary ) const;
+
+	/**
+	 * Acquire the brick of a node.
+	 * The server loads the brick in a slot if it is not already in its cache.
+	 * If all slots are referenced, the request is retried for a short time.
+	 *
+	 * @param pLevel level of resolution
+	 * @param pNodeInfo node encoded information (holding the brick address)
+	 *
+	 * @return the slot index (GV_BRICK_SERVER_INVALID_SLOT on error)
+	 */
+	unsigned int acquireBrick( unsigned int pLevel, unsigned int pNodeInfo );
+
+	/**
+	 * Retrieve the data of a channel of an acquired brick
+	 *
+	 * @param pSlot slot index
+	 * @param pChannel channel index
+	 *
+	 * @return the brick data
+	 */
+	const void* getBrickData( unsigned int pSlot, unsigned int pChannel ) const;
+
+	/**
+	 * Release an acquired brick
+	 *
+	 * @param pSlot slot index
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool releaseBrick( unsigned int pSlot );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Unix socket (-1 if not connected)
+	 */
+	int _socket;
+
+	/**
+	 * Mapped shared memory
+	 */
+	void* _sharedMemory;
+
+	/**
+	 * Size of the mapped shared memory
+	 */
+	size_t _sharedMemorySize;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Send a request and wait for the response
+	 *
+	 * @param pRequest the request
+	 * @param pResponse the response
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool sendRequest( const GvBrickServerProtocol::Request& pRequest, GvBrickServerProtocol::Response& pResponse );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvBrickServerClient( const GvBrickServerClient& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvBrickServerClient& operator=( const GvBrickServerClient& );
+
+};
+
+} // namespace GvUtils
+
+#endif
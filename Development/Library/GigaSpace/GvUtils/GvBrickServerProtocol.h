@@ -0,0 +1,366 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#ifndef _GV_BRICK_SERVER_PROTOCOL_H_
+#define _GV_BRICK_SERVER_PROTOCOL_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <cstddef>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Brick server shared memory identification ("GVBS") and protocol version
+ */
+#define GV_BRICK_SERVER_MAGIC				0x53425647U
+#define GV_BRICK_SERVER_VERSION				1U
+
+/**
+ * Brick server limits
+ */
+#define GV_BRICK_SERVER_MAX_CHANNELS		8
+#define GV_BRICK_SERVER_MAX_LEVELS			16
+#define GV_BRICK_SERVER_NAME_SIZE			64
+
+/**
+ * Invalid slot index
+ */
+#define GV_BRICK_SERVER_INVALID_SLOT		0xFFFFFFFFU
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvUtils
+{
+
+/**
+ * @class GvBrickServerProtocol
+ *
+ * @brief The GvBrickServerProtocol class describes the protocol between the brick server
+ * (Tools/GvBrickServer) and its clients (GvBrickServerClient).
+ *
+ * The server owns a dataset on disk and a POSIX shared memory segment that all clients
+ * map read-only. The segment contains :
+ * - a header (dataset description, layout and statistics),
+ * - the table of brick slots,
+ * - the nodes of all levels of resolution (and node summaries, if any),
+ * - the brick slots data (all channels of a brick are stored contiguously in a slot).
+ *
+ * Clients send fixed size requests on a Unix socket. Bricks are never sent on the socket :
+ * the server answers with the index of the slot holding the brick in shared memory.
+ * An acquired slot is reference counted and can't be evicted until it is released.
+ * The server is the only writer of the shared memory.
+ */
+class GvBrickServerProtocol
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Request commands
+	 */
+	enum Command
+	{
+		eHello,
+		eAcquire,
+		eRelease
+	};
+
+	/**
+	 * Response status
+	 */
+	enum Status
+	{
+		eOk,
+		eBusy,
+		eError
+	};
+
+	/**
+	 * Slot states
+	 */
+	enum SlotState
+	{
+		eFreeSlot,
+		eReadySlot
+	};
+
+	/**
+	 * Shared memory header
+	 */
+	struct Header
+	{
+		/**
+		 * Magic number and protocol version
+		 */
+		unsigned int _magic;
+		unsigned int _version;
+
+		/**
+		 * Brick resolution (without borders) and border size
+		 */
+		unsigned int _brickResolution;
+		unsigned int _borderSize;
+
+		/**
+		 * Number of levels of resolution and number of channels
+		 */
+		unsigned int _nbLevels;
+		unsigned int _nbChannels;
+
+		/**
+		 * Size of a voxel of each channel (in bytes)
+		 */
+		unsigned int _voxelSize[ GV_BRICK_SERVER_MAX_CHANNELS ];
+
+		/**
+		 * Number of voxels of a brick (with borders)
+		 */
+		unsigned int _brickNbVoxels;
+
+		/**
+		 * Size of a slot (all channels, in bytes) and number of slots
+		 */
+		unsigned int _slotSize;
+		unsigned int _nbSlots;
+
+		/**
+		 * Number of nodes in each dimension at each level
+		 */
+		unsigned int _nodeGridSize[ GV_BRICK_SERVER_MAX_LEVELS ];
+
+		/**
+		 * Offsets (in bytes from the beginning of the shared memory)
+		 * of the slot table, of the nodes and summaries of each level (0 if no summary),
+		 * and of the slots data
+		 */
+		unsigned long long _slotsOffset;
+		unsigned long long _nodesOffset[ GV_BRICK_SERVER_MAX_LEVELS ];
+		unsigned long long _summariesOffset[ GV_BRICK_SERVER_MAX_LEVELS ];
+		unsigned long long _dataOffset;
+
+		/**
+		 * Total size of the shared memory (in bytes)
+		 */
+		unsigned long long _totalSize;
+
+		/**
+		 * Statistics (updated by the server)
+		 */
+		unsigned long long _nbAcquires;
+		unsigned long long _nbHits;
+		unsigned long long _nbMisses;
+		unsigned long long _nbEvictions;
+	};
+
+	/**
+	 * Brick slot
+	 */
+	struct Slot
+	{
+		/**
+		 * Level of resolution and brick address (in the brick files) of the brick
+		 */
+		unsigned int _level;
+		unsigned int _brickAddress;
+
+		/**
+		 * Number of references held by clients
+		 */
+		unsigned int _refCount;
+
+		/**
+		 * Slot state
+		 */
+		unsigned int _state;
+
+		/**
+		 * Time of last use (used for LRU eviction)
+		 */
+		unsigned long long _lastUse;
+	};
+
+	/**
+	 * Client request
+	 */
+	struct Request
+	{
+		/**
+		 * Command
+		 */
+		unsigned int _command;
+
+		/**
+		 * Level of resolution (eAcquire)
+		 */
+		unsigned int _level;
+
+		/**
+		 * Encoded node information holding the brick address (eAcquire)
+		 */
+		unsigned int _nodeInfo;
+
+		/**
+		 * Slot index (eRelease)
+		 */
+		unsigned int _slot;
+	};
+
+	/**
+	 * Server response
+	 */
+	struct Response
+	{
+		/**
+		 * Status
+		 */
+		unsigned int _status;
+
+		/**
+		 * Slot index (eAcquire)
+		 */
+		unsigned int _slot;
+
+		/**
+		 * Shared memory name and size (eHello)
+		 */
+		char _sharedMemoryName[ GV_BRICK_SERVER_NAME_SIZE ];
+		unsigned long long _sharedMemorySize;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Retrieve a slot in shared memory
+	 *
+	 * @param pSharedMemory the shared memory
+	 * @param pSlot slot index
+	 *
+	 * @return the slot
+	 */
+	static inline const Slot* getSlot( const void* pSharedMemory, unsigned int pSlot )
+	{
+		const Header* header = static_cast< const Header* >( pSharedMemory );
+		return reinterpret_cast< const Slot* >( static_cast< const char* >( pSharedMemory ) + header->_slotsOffset ) + pSlot;
+	}
+
+	/**
+	 * Retrieve the nodes of a level of resolution in shared memory
+	 *
+	 * @param pSharedMemory the shared memory
+	 * @param pLevel level of resolution
+	 *
+	 * @return the nodes of the level (X axis first, then Y axis, then Z axis)
+	 */
+	static inline const unsigned int* getNodes( const void* pSharedMemory, unsigned int pLevel )
+	{
+		const Header* header = static_cast< const Header* >( pSharedMemory );
+		return reinterpret_cast< const unsigned int* >( static_cast< const char* >( pSharedMemory ) + header->_nodesOffset[ pLevel ] );
+	}
+
+	/**
+	 * Retrieve the offset of a channel in a slot
+	 *
+	 * @param pHeader the shared memory header
+	 * @param pChannel channel index
+	 *
+	 * @return the offset of the channel (in bytes)
+	 */
+	static inline size_t getChannelOffset( const Header* pHeader, unsigned int pChannel )
+	{
+		size_t offset = 0;
+		for ( unsigned int i = 0; i < pChannel; i++ )
+		{
+			offset += static_cast< size_t >( pHeader->_voxelSize[ i ] ) * pHeader->_brickNbVoxels;
+		}
+
+		return offset;
+	}
+
+	/**
+	 * Retrieve the data of a channel of a slot in shared memory
+	 *
+	 * @param pSharedMemory the shared memory
+	 * @param pSlot slot index
+	 * @param pChannel channel index
+	 *
+	 * @return the brick data of the channel
+	 */
+	static inline const void* getBrickData( const void* pSharedMemory, unsigned int pSlot, unsigned int pChannel )
+	{
+		const Header* header = static_cast< const Header* >( pSharedMemory );
+		return static_cast< const char* >( pSharedMemory ) + header->_dataOffset + static_cast< size_t >( pSlot ) * header->_slotSize + getChannelOffset( header, pChannel );
+	}
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+};
+
+} // namespace GvUtils
+
+#endif
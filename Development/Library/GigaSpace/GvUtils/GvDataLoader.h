@@ -33,6 +33,8 @@
 
 // STL
 #include <vector>
+#include <map>
+#include <deque>
 
 // System
 #include <string>
@@ -45,6 +47,9 @@
 #include "GvCore/vector_types_ext.h"
 #include "GvUtils/GvIDataLoader.h"
 #include "GvUtils/GvFileNameBuilder.h"
+#include "GvStructure/GvVolumeTreeAddressType.h"
+#include "GvVoxelizer/GvNodeSummary.h"
+#include "GvVoxelizer/GvDataContainer.h"
 
 /******************************************************************************
  ************************* DEFINE AND CONSTANT SECTION ************************
@@ -69,6 +74,12 @@ const char * brickLevel = "Level";
 const char * levelId = "id";
 const char * levelFilename = "filename";
 
+/**
+ * Maximum number of stored bricks kept in memory to reconstruct the borders
+ * of bricks of borderless datasets (when the cache mechanism is not used)
+ */
+#define GV_DATA_LOADER_STORED_BRICK_CACHE_SIZE 512
+
 
 
 
@@ -80,6 +91,11 @@ const char * levelFilename = "filename";
  ******************************** CLASS USED **********************************
  ******************************************************************************/
 
+namespace GvUtils
+{
+	class GvTransferFunction;
+}
+
 /******************************************************************************
  ****************************** CLASS DEFINITION ******************************
  ******************************************************************************/
@@ -118,7 +134,7 @@ public:
 	/**
 	 * Constructor
 	 *
-	 * @param pName filename
+	 * @param pName filename of the XML file describing the dataset, or of a container file (".gvc")
 	 * @param pDataSize volume resolution
 	 * @param pBlocksize brick resolution
 	 * @param pBordersize brick broder size
@@ -167,6 +183,34 @@ public:
 	 */
 	virtual uint getRegionInfoNew( const float3& pPosition, const float3& pSize );
 
+	/**
+	 * Retrieve the summary (min/max, occupancy, homogeneity) of the node
+	 * located in a region of space, for a given data channel.
+	 *
+	 * Summaries are read from the ".summary" files generated alongside the ".nodes" files.
+	 *
+	 * @param pPosition position of a region of space
+	 * @param pSize size of a region of space
+	 * @param pChannel data channel index
+	 * @param pSummary the resulting node summary
+	 *
+	 * @return a flag telling wheter or not a summary is available for that region
+	 */
+	virtual bool getRegionSummary( const float3& pPosition, const float3& pSize, unsigned int pChannel, GvVoxelizer::GvNodeSummary& pSummary );
+
+	/**
+	 * Set the transfer function used to classify regions.
+	 *
+	 * When set, regions whose summary range maps to transparent values
+	 * are reported as empty by getRegionInfoNew(), so no brick is produced.
+	 *
+	 * @param pTransferFunction the transfer function (NULL to disable classification)
+	 * @param pChannel data channel index used to fetch the transfer function
+	 * @param pComponent component of the data channel used to fetch the transfer function
+	 * @param pOpacityThreshold opacity under which a value is considered transparent
+	 */
+	void setTransferFunction( const GvTransferFunction* pTransferFunction, unsigned int pChannel = 0, unsigned int pComponent = 0, float pOpacityThreshold = 0.f );
+
 	/**
 	 * Retrieve the resolution at a given level (i.e. the number of voxels in each dimension)
 	 *
@@ -196,6 +240,30 @@ public:
 	template< typename TChannelType >
 	inline void readBrick( int pChannel, unsigned int pIndexVal, unsigned int pBlockMemSize, unsigned int pLevel, GvCore::Array3D< TChannelType >* pData, size_t pOffsetInPool );
 
+	/**
+	 * Tell wheter or not bricks are stored without borders in files.
+	 * Borders are then reconstructed at load time (see readBorderlessBrick()).
+	 *
+	 * @return a flag telling wheter or not bricks are stored without borders
+	 */
+	inline bool isBorderless() const;
+
+	/**
+	 * Read a brick stored without borders and reconstruct its borders
+	 * from the interior voxels of its neighbor bricks (26 neighbors).
+	 * Borders facing empty nodes or the volume bounds are set to 0,
+	 * as done by the voxelizer when borders are stored.
+	 *
+	 * @param pChannel channel index (i.e. color, normal, density, etc...)
+	 * @param pIndexVal associated node encoded address of the node in which the brick resides
+	 * @param pLevel mipmap level
+	 * @param pBlockPos the 3D node indexed position
+	 * @param pData data array corresponding to given channel index in the data pool (i.e. bricks of voxels)
+	 * @param pOffsetInPool offset in the data pool
+	 */
+	template< typename TChannelType >
+	inline void readBorderlessBrick( int pChannel, unsigned int pIndexVal, unsigned int pLevel, const uint3& pBlockPos, GvCore::Array3D< TChannelType >* pData, size_t pOffsetInPool );
+
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
 	 **************************************************************************/
@@ -221,6 +289,11 @@ protected:
 	 */
 	int _borderSize;
 
+	/**
+	 * Border size of the bricks stored in files (0 for borderless datasets)
+	 */
+	int _storedBorderSize;
+
 	/**
 	 * Number of mipmap levels
 	 */
@@ -265,6 +338,52 @@ protected:
 	 */
 	size_t _numChannels;
 
+	/**
+	 * Buffer containing all read node summaries (always used, except for container files without cache mechanism).
+	 *
+	 * For each mipmap level, summaries are stored in the same order as nodes,
+	 * with one summary per channel. A level without summary file is empty.
+	 */
+	std::vector< std::vector< GvVoxelizer::GvNodeSummary > > _summaryCache;
+
+	/**
+	 * Container file of the dataset (NULL if the dataset is made of separate files)
+	 */
+	GvVoxelizer::GvDataContainer* _container;
+
+	/**
+	 * Flag telling wheter or not the node and brick caches point to the mapped container file
+	 * (instead of allocated buffers)
+	 */
+	bool _isCacheMapped;
+
+	/**
+	 * Stored bricks (without borders) recently read to reconstruct borders, when the cache mechanism is not used.
+	 * Bricks are indexed by level, channel and brick index, and evicted in read order.
+	 */
+	std::map< unsigned long long, std::vector< unsigned char > > _storedBrickCache;
+	std::deque< unsigned long long > _storedBrickCacheOrder;
+
+	/**
+	 * Transfer function used to classify regions (NULL if not used)
+	 */
+	const GvTransferFunction* _transferFunction;
+
+	/**
+	 * Data channel index used to fetch the transfer function
+	 */
+	unsigned int _transferFunctionChannel;
+
+	/**
+	 * Component of the data channel used to fetch the transfer function
+	 */
+	unsigned int _transferFunctionComponent;
+
+	/**
+	 * Opacity under which a value is considered transparent
+	 */
+	float _opacityThreshold;
+
 	/******************************** METHODS *********************************/
 
 	/**
@@ -316,6 +435,24 @@ protected:
 	 */
 	int parseXMLFile( const char* pFilename , uint & resolution);
 
+	/**
+	 * Open the container file of a dataset
+	 *
+	 * @param pFilename the filename of the container file
+	 * @param pResolution the resulting volume resolution
+	 *
+	 * @return 0 if it succeeds, -1 otherwise
+	 */
+	int openContainerFile( const char* pFilename, uint& pResolution );
+
+	/**
+	 * Fill the node, brick and summary caches from the container file.
+	 * When the container can be memory mapped, node and brick data is used in place.
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool readContainerCache();
+
 
 	/**
 	 * Retrieve the node encoded address given a mipmap level and a 3D node indexed position
@@ -327,6 +464,27 @@ protected:
 	 */
 	unsigned int getBlockIndex( int level, const uint3& bpos ) const;
 
+	/**
+	 * Retrieve the node summary given a mipmap level, a 3D node indexed position and a channel
+	 *
+	 * @param pLevel mipmap level
+	 * @param pBlockPos the 3D node indexed position
+	 * @param pChannel data channel index
+	 * @param pSummary the resulting node summary
+	 *
+	 * @return a flag telling wheter or not a summary is available for that node
+	 */
+	bool getBlockSummary( int pLevel, const uint3& pBlockPos, unsigned int pChannel, GvVoxelizer::GvNodeSummary& pSummary ) const;
+
+	/**
+	 * Retrieve the node summary filename at a given mipmap level
+	 *
+	 * @param pLevel mipmap level
+	 *
+	 * @return the node summary filename
+	 */
+	std::string getSummaryFileName( int pLevel ) const;
+
 	/**
 	 * Load a brick given a mipmap level, a 3D node indexed position,
 	 * the data pool and an offset in the data pool.
@@ -340,6 +498,19 @@ protected:
 	 */
 	bool loadBrick( int pLevel, const uint3& pBlockPos, GvCore::GPUPoolHost< GvCore::Array3D, TDataTypeList >* pDataPool, size_t pOffsetInPool );
 
+	/**
+	 * Retrieve the data of a stored brick (without borders), either from the cache of bricks,
+	 * from the cache of stored bricks, or from the brick files.
+	 *
+	 * @param pChannel channel index
+	 * @param pLevel mipmap level
+	 * @param pBrickIndex index of the brick in the brick file
+	 * @param pBrickByteSize size of a stored brick (in bytes)
+	 *
+	 * @return the brick data (NULL if it can't be read)
+	 */
+	const unsigned char* getStoredBrick( unsigned int pChannel, unsigned int pLevel, unsigned int pBrickIndex, size_t pBrickByteSize );
+
 	/**************************************************************************
 	 ***************************** PRIVATE SECTION ****************************
 	 **************************************************************************/
@@ -31,6 +31,9 @@
 // GigaVoxels
 #include "GvUtils/GvBrickLoaderChannelInitializer.h"
 #include "GvCore/GvError.h"
+#include "GvUtils/GvTransferFunction.h"
+#include "GvVoxelizer/GvDataStructureSummaryGenerator.h"
+#include "GvPerfMon/GvMetrics.h"
 
 // TinyXML
 #include <tinyxml.h>
@@ -56,8 +59,21 @@ template< typename TDataTypeList >
 GvDataLoader< TDataTypeList >
 ::GvDataLoader( const std::string& pName, const uint3& pBlocksize, int pBordersize, bool pUseCache )
 {
+	this->_container = NULL;
+	this->_isCacheMapped = false;
+	this->_storedBorderSize = -1;
+
+	// Retrieve the dataset description, either from its container file or from its XML file
 	uint resolution = 0;
-	int parse = this->parseXMLFile( pName.c_str(), resolution );
+	int parse = 0;
+	if ( GvVoxelizer::GvDataContainer::isContainerFileName( pName ) )
+	{
+		parse = this->openContainerFile( pName.c_str(), resolution );
+	}
+	else
+	{
+		parse = this->parseXMLFile( pName.c_str(), resolution );
+	}
 	assert( parse == 0 );
 
 	this->_bricksRes.x = pBlocksize.x;
@@ -69,8 +85,24 @@ GvDataLoader< TDataTypeList >
 	this->_volumeRes = make_uint3( resolution );//TO CHANGE
 	printf( "%d\n", _volumeRes.x );
 	this->_borderSize = pBordersize;
+
+	// Bricks are stored with the borders of the data pool, or without borders (they are then reconstructed at load time)
+	if ( this->_storedBorderSize < 0 )
+	{
+		this->_storedBorderSize = this->_borderSize;
+	}
+	else if ( this->_storedBorderSize != 0 && this->_storedBorderSize != this->_borderSize )
+	{
+		std::cerr << "GvDataLoader::GvDataLoader : bricks are stored with a border size of " << this->_storedBorderSize
+					<< " instead of " << this->_borderSize << std::endl;
+		this->_storedBorderSize = this->_borderSize;
+	}
 	this->_mipMapOrder = 2;
 	this->_useCache = pUseCache;
+	this->_transferFunction = NULL;
+	this->_transferFunctionChannel = 0;
+	this->_transferFunctionComponent = 0;
+	this->_opacityThreshold = 0.f;
 
 	// Compute number of mipmaps levels
 	int dataResMin = mincc( this->_volumeRes.x, mincc( this->_volumeRes.y, this->_volumeRes.z ) );
@@ -88,9 +120,25 @@ GvDataLoader< TDataTypeList >
 	// Build the list of all filenames that producer will have to load (nodes and bricks).
 	//this->makeFilesNames( pName.c_str() );
 
+	// Node summaries (they are optional) are always read in memory :
+	// they are looked up for each requested region, even when nodes and bricks are read from files on demand.
+	if ( this->_container == NULL )
+	{
+		for ( int level = 0; level < _numMipMapLevels; level++ )
+		{
+			_summaryCache.push_back( std::vector< GvVoxelizer::GvNodeSummary >() );
+			GvVoxelizer::GvDataStructureSummaryGenerator::readSummaryFile( getSummaryFileName( level ), _summaryCache.back() );
+		}
+	}
+
 	// If cache mechanismn is required, read all files (nodes and bricks),
 	// and store data in associated buffers.
-	if ( this->_useCache )
+	if ( this->_useCache && this->_container != NULL )
+	{
+		// Container : node and brick sections are used in place when the file can be mapped
+		this->_useCache = readContainerCache();
+	}
+	else if ( this->_useCache )
 	{
 		// Iterate through mipmap levels
 
@@ -243,6 +291,13 @@ template< typename TDataTypeList >
 GvDataLoader< TDataTypeList >
 ::~GvDataLoader()
 {
+	// Caches pointing to the mapped container file are released with the container
+	if ( _isCacheMapped )
+	{
+		_blockCache.clear();
+		_blockIndexCache.clear();
+	}
+
 	// Free memory of bricks data
 	for	( size_t i = 0; i < _blockCache.size(); i++ )
 	{
@@ -265,6 +320,9 @@ GvDataLoader< TDataTypeList >
 			delete [] _blockIndexCache[ i ];
 		}
 	}
+
+	// Close the container file
+	delete _container;
 }
 
 /******************************************************************************
@@ -410,6 +468,7 @@ int GvDataLoader< TDataTypeList >
 							} else if ( strcmp(attrib->Name(),brickDataBorderSize)==0)
 							{
 								//printf("Border size : %s\n",attrib->Value());
+								_storedBorderSize = atoi(attrib->Value());
 							} else
 							{
 								//printf("XML WARNING Unknown attribute: %s\n",attrib->Value());
@@ -519,6 +578,212 @@ int GvDataLoader< TDataTypeList >
 	return 0;
 }
 
+/******************************************************************************
+ * Retrieve the data of a stored brick (without borders), either from the cache of bricks,
+ * from the cache of stored bricks, or from the brick files.
+ *
+ * @param pChannel channel index
+ * @param pLevel mipmap level
+ * @param pBrickIndex index of the brick in the brick file
+ * @param pBrickByteSize size of a stored brick (in bytes)
+ *
+ * @return the brick data (NULL if it can't be read)
+ ******************************************************************************/
+template< typename TDataTypeList >
+const unsigned char* GvDataLoader< TDataTypeList >
+::getStoredBrick( unsigned int pChannel, unsigned int pLevel, unsigned int pBrickIndex, size_t pBrickByteSize )
+{
+	const unsigned long long offset = static_cast< unsigned long long >( pBrickIndex ) * pBrickByteSize;
+
+	// Cache mechanism : all bricks are in memory
+	if ( _useCache )
+	{
+		const unsigned char* bricks = _blockCache[ pLevel * _numChannels + pChannel ];
+
+		return ( bricks != NULL ) ? bricks + offset : NULL;
+	}
+
+	// Bricks of a request batch share most of their neighbors : recently read bricks are kept
+	const unsigned long long key = ( ( static_cast< unsigned long long >( pLevel ) * _numChannels + pChannel ) << 32 ) | pBrickIndex;
+	std::map< unsigned long long, std::vector< unsigned char > >::iterator brickIt = _storedBrickCache.find( key );
+	if ( brickIt != _storedBrickCache.end() )
+	{
+		return &brickIt->second[ 0 ];
+	}
+
+	// Evict the oldest read brick
+	if ( _storedBrickCacheOrder.size() >= GV_DATA_LOADER_STORED_BRICK_CACHE_SIZE )
+	{
+		_storedBrickCache.erase( _storedBrickCacheOrder.front() );
+		_storedBrickCacheOrder.pop_front();
+	}
+
+	std::vector< unsigned char > brick( pBrickByteSize );
+	bool isRead = false;
+	if ( _container != NULL )
+	{
+		const GvVoxelizer::GvDataContainer::Section* brickSection = _container->findSection( GvVoxelizer::GvDataContainer::eBrickSection, pLevel, pChannel );
+		isRead = ( brickSection != NULL ) && _container->read( *brickSection, offset, &brick[ 0 ], pBrickByteSize );
+	}
+	else
+	{
+		FILE* file = fopen( _filesNames[ pLevel * ( _numChannels + 1 ) + pChannel + 1 ].c_str(), "rb" );
+		if ( file )
+		{
+#ifdef WIN32
+			_fseeki64( file, (__int64)offset, SEEK_SET );
+#else
+			fseeko( file, (off_t)offset, SEEK_SET );
+#endif
+			isRead = ( fread( &brick[ 0 ], 1, pBrickByteSize, file ) == pBrickByteSize );
+			fclose( file );
+		}
+	}
+	if ( ! isRead )
+	{
+		std::cerr << "GvDataLoader::getStoredBrick : unable to read brick " << pBrickIndex << " at level " << pLevel << " for channel " << pChannel << std::endl;
+		return NULL;
+	}
+
+	_storedBrickCacheOrder.push_back( key );
+	std::vector< unsigned char >& cachedBrick = _storedBrickCache[ key ];
+	cachedBrick.swap( brick );
+
+	return &cachedBrick[ 0 ];
+}
+
+/******************************************************************************
+ * Open the container file of a dataset
+ *
+ * @param pFilename the filename of the container file
+ * @param pResolution the resulting volume resolution
+ *
+ * @return 0 if it succeeds, -1 otherwise
+ ******************************************************************************/
+template< typename TDataTypeList >
+int GvDataLoader< TDataTypeList >
+::openContainerFile( const char* pFilename, uint& pResolution )
+{
+	_container = new GvVoxelizer::GvDataContainer();
+	if ( ! _container->open( pFilename ) )
+	{
+		delete _container;
+		_container = NULL;
+
+		return -1;
+	}
+
+	if ( _container->getNbLevels() == 0 || _container->getChannels().size() != static_cast< size_t >( Loki::TL::Length< TDataTypeList >::value ) )
+	{
+		std::cerr << "GvDataLoader::openContainerFile : " << pFilename << " has " << _container->getChannels().size()
+					<< " channels and " << _container->getNbLevels() << " levels" << std::endl;
+		delete _container;
+		_container = NULL;
+
+		return -1;
+	}
+
+	printf( "Loading model %s\n", _container->getName().c_str() );
+
+	// Same resolution as the one described by the XML file
+	pResolution = _container->getBrickResolution() * ( 1 << ( _container->getNbLevels() - 1 ) );
+	_storedBorderSize = static_cast< int >( _container->getBorderSize() );
+
+	return 0;
+}
+
+/******************************************************************************
+ * Fill the node, brick and summary caches from the container file.
+ * When the container can be memory mapped, node and brick data is used in place.
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+template< typename TDataTypeList >
+bool GvDataLoader< TDataTypeList >
+::readContainerCache()
+{
+	// Host mapped memory is required to fetch data from the device : container data is copied
+#if USE_GPUFETCHDATA
+	_isCacheMapped = false;
+#else
+	_isCacheMapped = _container->map();
+#endif
+	const unsigned char* mappedData = _container->getMappedData();
+
+	// Iterate through mipmap levels
+	for ( int level = 0; level < _numMipMapLevels; level++ )
+	{
+		// Read node summaries at current mipmap level (they are optional)
+		_summaryCache.push_back( std::vector< GvVoxelizer::GvNodeSummary >() );
+		const GvVoxelizer::GvDataContainer::Section* summarySection = _container->findSection( GvVoxelizer::GvDataContainer::eSummarySection, level );
+		if ( summarySection != NULL && summarySection->_size % sizeof( GvVoxelizer::GvNodeSummary ) == 0 && summarySection->_size > 0 )
+		{
+			_summaryCache.back().resize( static_cast< size_t >( summarySection->_size / sizeof( GvVoxelizer::GvNodeSummary ) ) );
+			if ( ! _container->read( *summarySection, 0, &_summaryCache.back()[ 0 ], static_cast< size_t >( summarySection->_size ) ) )
+			{
+				_summaryCache.back().clear();
+			}
+		}
+
+		// Nodes
+		const GvVoxelizer::GvDataContainer::Section* nodeSection = _container->findSection( GvVoxelizer::GvDataContainer::eNodeSection, level );
+		const unsigned long long expectedSize = ( 1ULL << ( 3 * level ) ) * sizeof( unsigned int );
+		if ( nodeSection == NULL || nodeSection->_size != expectedSize )
+		{
+			std::cerr << "GvDataLoader::readContainerCache : invalid node section at level " << level << std::endl;
+			return false;
+		}
+		if ( _isCacheMapped )
+		{
+			// Sections are page aligned, node data can be used in place (read-only)
+			_blockIndexCache.push_back( reinterpret_cast< unsigned int* >( const_cast< unsigned char* >( mappedData + nodeSection->_offset ) ) );
+		}
+		else
+		{
+			unsigned int* tmpCache = new unsigned int[ static_cast< size_t >( nodeSection->_size / sizeof( unsigned int ) ) ];
+			_blockIndexCache.push_back( tmpCache );
+			if ( ! _container->read( *nodeSection, 0, tmpCache, static_cast< size_t >( nodeSection->_size ) ) )
+			{
+				std::cerr << "GvDataLoader::readContainerCache : unable to read the node section at level " << level << std::endl;
+				return false;
+			}
+		}
+
+		// Bricks of each channel
+		for ( size_t channel = 0; channel < _numChannels; channel++ )
+		{
+			const GvVoxelizer::GvDataContainer::Section* brickSection = _container->findSection( GvVoxelizer::GvDataContainer::eBrickSection, level, static_cast< unsigned int >( channel ) );
+			if ( brickSection == NULL )
+			{
+				std::cerr << "GvDataLoader::readContainerCache : missing brick section at level " << level << " for channel " << channel << std::endl;
+				return false;
+			}
+			if ( _isCacheMapped )
+			{
+				_blockCache.push_back( const_cast< unsigned char* >( mappedData + brickSection->_offset ) );
+			}
+			else
+			{
+				unsigned char* tmpCache;
+#if USE_GPUFETCHDATA
+				cudaHostAlloc( (void**)&tmpCache, static_cast< size_t >( brickSection->_size ), cudaHostAllocMapped | cudaHostAllocWriteCombined );
+#else
+				tmpCache = new unsigned char[ static_cast< size_t >( brickSection->_size ) ];
+#endif
+				GV_CHECK_CUDA_ERROR( "GvDataLoader::readContainerCache: cache alloc" );
+				_blockCache.push_back( tmpCache );
+				if ( ! _container->read( *brickSection, 0, tmpCache, static_cast< size_t >( brickSection->_size ) ) )
+				{
+					std::cerr << "GvDataLoader::readContainerCache : unable to read the brick section at level " << level << " for channel " << channel << std::endl;
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
 /******************************************************************************
  * Retrieve the node encoded address given a mipmap level and a 3D node indexed position
  *
@@ -553,6 +818,19 @@ unsigned int GvDataLoader< TDataTypeList >
 		// Get the node address
 		indexValue = _blockIndexCache[ pLevel ][ indexPos ];
 	}
+	else if ( _container != NULL )
+	{
+		// Nodes are stored in increasing order from X axis first, then Y axis, then Z axis.
+		const unsigned long long indexPos = ( static_cast< unsigned long long >( pBlockPos.x ) + static_cast< unsigned long long >( pBlockPos.y ) * blocksInLevel.x
+											+ static_cast< unsigned long long >( pBlockPos.z ) * blocksInLevel.x * blocksInLevel.y ) * sizeof( unsigned int );
+
+		// Read the requested node address in the node section of the level
+		const GvVoxelizer::GvDataContainer::Section* nodeSection = _container->findSection( GvVoxelizer::GvDataContainer::eNodeSection, pLevel );
+		if ( nodeSection == NULL || ! _container->read( *nodeSection, indexPos, &indexValue, sizeof( unsigned int ) ) )
+		{
+			std::cerr << "GvDataLoader<T>::getBlockIndex() : unable to read node at level " << pLevel << " in the container" << std::endl;
+		}
+	}
 	else
 	{
 		// Compute the index of the node in the buffer of nodes, given its position
@@ -629,7 +907,7 @@ bool GvDataLoader< TDataTypeList >
 	if ( indexVal & GV_VTBA_BRICK_FLAG )
 	{
 		// Use a channel initializer to read the brick
-		GvBrickLoaderChannelInitializer< TDataTypeList > channelInitializer( this, indexVal, blockMemSize, pLevel, pDataPool, pOffsetInPool );
+		GvBrickLoaderChannelInitializer< TDataTypeList > channelInitializer( this, indexVal, blockMemSize, pLevel, pBlockPos, pDataPool, pOffsetInPool );
 		GvCore::StaticLoop< GvBrickLoaderChannelInitializer< TDataTypeList >, Loki::TL::Length< TDataTypeList >::value - 1 >::go( channelInitializer );
 
 		return true;
@@ -668,7 +946,18 @@ GvDataLoader< TDataTypeList >::VPRegionInfo GvDataLoader< TDataTypeList >
 	if ( level >= 0 && level < _numMipMapLevels )
 	{
 		// Try to load brick given localization parameters
-		if ( loadBrick( level, blockCoords, pBrickPool, pOffsetInPool ) )
+		// (its latency is recorded when the metrics endpoint is activated)
+		GvPerfMon::GvPerformanceTimer::Event loadEvent;
+		if ( GvPerfMon::GvMetrics::_isActivated )
+		{
+			GvPerfMon::GvMetrics::get().startTimer( loadEvent );
+		}
+		const bool isBrickLoaded = loadBrick( level, blockCoords, pBrickPool, pOffsetInPool );
+		if ( GvPerfMon::GvMetrics::_isActivated )
+		{
+			GvPerfMon::GvMetrics::get().stopTimer( GvPerfMon::GvMetrics::eLoaderLatency, loadEvent );
+		}
+		if ( isBrickLoaded )
 		{
 			return GvDataLoader< TDataTypeList >::VP_UNKNOWN_REGION;
 		}
@@ -772,11 +1061,161 @@ uint GvDataLoader< TDataTypeList >
 		// Retrieve the node encoded address given a mipmap level and a 3D node indexed position
 		// Apply a mask on the two first bits to retrieve node information
 		// (the other 30 bits are for x,y,z address).
-		return ( getBlockIndex( level, blockPosition ) & 0xC0000000 );
+		uint nodeInfo = ( getBlockIndex( level, blockPosition ) & 0xC0000000 );
+
+		// Use node summaries, if any, to classify the region without loading its brick
+		if ( nodeInfo & GV_VTBA_BRICK_FLAG )
+		{
+			GvVoxelizer::GvNodeSummary summary;
+
+			// Regions mapped to transparent values by the transfer function are empty
+			if ( _transferFunction != NULL && getBlockSummary( level, blockPosition, _transferFunctionChannel, summary ) )
+			{
+				if ( _transferFunction->isTransparent( summary._min[ _transferFunctionComponent ], summary._max[ _transferFunctionComponent ], _opacityThreshold ) )
+				{
+					return 0;
+				}
+			}
+
+			// Regions whose whole subtree is homogeneous on all channels are terminal
+			bool isHomogeneous = true;
+			for ( unsigned int channel = 0; channel < _numChannels && isHomogeneous; channel++ )
+			{
+				isHomogeneous = getBlockSummary( level, blockPosition, channel, summary ) && ( summary._flags & GV_NODE_SUMMARY_HOMOGENEOUS_FLAG );
+			}
+			if ( isHomogeneous )
+			{
+				nodeInfo |= GV_VTBA_TERMINAL_FLAG;
+			}
+		}
+
+		return nodeInfo;
 	}
 	return 0;
 }
 
+/******************************************************************************
+ * Retrieve the summary (min/max, occupancy, homogeneity) of the node
+ * located in a region of space, for a given data channel.
+ *
+ * Summaries are read from the ".summary" files generated alongside the ".nodes" files.
+ *
+ * @param pPosition position of a region of space
+ * @param pSize size of a region of space
+ * @param pChannel data channel index
+ * @param pSummary the resulting node summary
+ *
+ * @return a flag telling wheter or not a summary is available for that region
+ ******************************************************************************/
+template< typename TDataTypeList >
+bool GvDataLoader< TDataTypeList >
+::getRegionSummary( const float3& pPosition, const float3& pSize, unsigned int pChannel, GvVoxelizer::GvNodeSummary& pSummary )
+{
+	// Retrieve the level of resolution associated to a given size of a region of space.
+	int level =	getDataLevel( pSize, _bricksRes );
+
+	// Check mipmap level bounds
+	if ( level >= 0 && level < _numMipMapLevels )
+	{
+		return getBlockSummary( level, getBlockCoords( level, pPosition ), pChannel, pSummary );
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * Set the transfer function used to classify regions.
+ *
+ * When set, regions whose summary range maps to transparent values
+ * are reported as empty by getRegionInfoNew(), so no brick is produced.
+ *
+ * @param pTransferFunction the transfer function (NULL to disable classification)
+ * @param pChannel data channel index used to fetch the transfer function
+ * @param pComponent component of the data channel used to fetch the transfer function
+ * @param pOpacityThreshold opacity under which a value is considered transparent
+ ******************************************************************************/
+template< typename TDataTypeList >
+void GvDataLoader< TDataTypeList >
+::setTransferFunction( const GvTransferFunction* pTransferFunction, unsigned int pChannel, unsigned int pComponent, float pOpacityThreshold )
+{
+	assert( pChannel < _numChannels );
+	assert( pComponent < 4 );
+
+	_transferFunction = pTransferFunction;
+	_transferFunctionChannel = pChannel;
+	_transferFunctionComponent = pComponent;
+	_opacityThreshold = pOpacityThreshold;
+}
+
+/******************************************************************************
+ * Retrieve the node summary given a mipmap level, a 3D node indexed position and a channel
+ *
+ * @param pLevel mipmap level
+ * @param pBlockPos the 3D node indexed position
+ * @param pChannel data channel index
+ * @param pSummary the resulting node summary
+ *
+ * @return a flag telling wheter or not a summary is available for that node
+ ******************************************************************************/
+template< typename TDataTypeList >
+bool GvDataLoader< TDataTypeList >
+::getBlockSummary( int pLevel, const uint3& pBlockPos, unsigned int pChannel, GvVoxelizer::GvNodeSummary& pSummary ) const
+{
+	if ( pChannel >= _numChannels )
+	{
+		return false;
+	}
+
+	// Number of nodes at given level
+	uint3 blocksInLevel = getLevelRes( pLevel ) / this->_bricksRes;
+
+	// Summaries are stored in the same order as nodes, with one summary per channel
+	size_t summaryIndex = ( static_cast< size_t >( pBlockPos.x ) + static_cast< size_t >( pBlockPos.y ) * blocksInLevel.x + static_cast< size_t >( pBlockPos.z ) * blocksInLevel.x * blocksInLevel.y ) * _numChannels + pChannel;
+
+	// Summaries are in memory when the cache mechanism is used, or when the dataset is made of separate files
+	if ( _useCache || _container == NULL )
+	{
+		if ( static_cast< size_t >( pLevel ) >= _summaryCache.size() || summaryIndex >= _summaryCache[ pLevel ].size() )
+		{
+			return false;
+		}
+		pSummary = _summaryCache[ pLevel ][ summaryIndex ];
+
+		return true;
+	}
+
+	// Container : summary sections are optional
+	const GvVoxelizer::GvDataContainer::Section* summarySection = _container->findSection( GvVoxelizer::GvDataContainer::eSummarySection, pLevel );
+
+	return summarySection != NULL && _container->read( *summarySection, static_cast< unsigned long long >( summaryIndex ) * sizeof( GvVoxelizer::GvNodeSummary ), &pSummary, sizeof( GvVoxelizer::GvNodeSummary ) );
+}
+
+/******************************************************************************
+ * Retrieve the node summary filename at a given mipmap level
+ *
+ * @param pLevel mipmap level
+ *
+ * @return the node summary filename
+ ******************************************************************************/
+template< typename TDataTypeList >
+std::string GvDataLoader< TDataTypeList >
+::getSummaryFileName( int pLevel ) const
+{
+	// Summary file is stored alongside the node file, with ".summary" extension
+	std::string fileName = this->_filesNames[ ( _numChannels + 1 ) * pLevel ];
+	std::string::size_type extensionPosition = fileName.rfind( ".nodes" );
+	if ( extensionPosition != std::string::npos )
+	{
+		fileName.replace( extensionPosition, std::string( ".nodes" ).size(), ".summary" );
+	}
+	else
+	{
+		fileName += ".summary";
+	}
+
+	return fileName;
+}
+
 /******************************************************************************
  * Retrieve the resolution at a given level (i.e. the number of voxels in each dimension)
  *
@@ -836,6 +1275,15 @@ inline void GvDataLoader< TDataTypeList >
 					pBlockMemSize * sizeof( TChannelType ) /* number of bytes*/ );
 		}
 	}
+	else if ( _container != NULL )
+	{
+		// Read the brick in the brick section of the level and channel
+		const GvVoxelizer::GvDataContainer::Section* brickSection = _container->findSection( GvVoxelizer::GvDataContainer::eBrickSection, pLevel, pChannel );
+		if ( brickSection != NULL )
+		{
+			_container->read( *brickSection, filePos, pData->getPointer( pOffsetInPool ), pBlockMemSize * sizeof( TChannelType ) );
+		}
+	}
 	else
 	{
 		// Open brick file
@@ -857,6 +1305,98 @@ inline void GvDataLoader< TDataTypeList >
 	}
 }
 
+/******************************************************************************
+ * Tell wheter or not bricks are stored without borders in files.
+ * Borders are then reconstructed at load time (see readBorderlessBrick()).
+ *
+ * @return a flag telling wheter or not bricks are stored without borders
+ ******************************************************************************/
+template< typename TDataTypeList >
+inline bool GvDataLoader< TDataTypeList >
+::isBorderless() const
+{
+	return ( _storedBorderSize == 0 && _borderSize > 0 );
+}
+
+/******************************************************************************
+ * Read a brick stored without borders and reconstruct its borders
+ * from the interior voxels of its neighbor bricks (26 neighbors).
+ * Borders facing empty nodes or the volume bounds are set to 0,
+ * as done by the voxelizer when borders are stored.
+ *
+ * @param pChannel channel index (i.e. color, normal, density, etc...)
+ * @param pIndexVal associated node encoded address of the node in which the brick resides
+ * @param pLevel mipmap level
+ * @param pBlockPos the 3D node indexed position
+ * @param pData data array corresponding to given channel index in the data pool (i.e. bricks of voxels)
+ * @param pOffsetInPool offset in the data pool
+ ******************************************************************************/
+template< typename TDataTypeList >
+template< typename TChannelType >
+inline void GvDataLoader< TDataTypeList >
+::readBorderlessBrick( int pChannel, unsigned int pIndexVal, unsigned int pLevel, const uint3& pBlockPos, GvCore::Array3D< TChannelType >* pData, size_t pOffsetInPool )
+{
+	const int border = _borderSize;
+	const uint3 trueBlocksRes = this->_bricksRes + make_uint3( 2 * border );
+	const uint3 blocksInLevel = getLevelRes( pLevel ) / this->_bricksRes;
+	const size_t storedBrickByteSize = static_cast< size_t >( _bricksRes.x ) * _bricksRes.y * _bricksRes.z * sizeof( TChannelType );
+
+	// Borders facing empty nodes and the volume bounds are empty
+	TChannelType* brick = pData->getPointer( pOffsetInPool );
+	memset( brick, 0, static_cast< size_t >( trueBlocksRes.x ) * trueBlocksRes.y * trueBlocksRes.z * sizeof( TChannelType ) );
+
+	// Gather the interior of the brick, then the face, edge and corner slabs of its neighbors
+	for ( int k = -1; k <= 1; k++ )
+	for ( int j = -1; j <= 1; j++ )
+	for ( int i = -1; i <= 1; i++ )
+	{
+		const int neighborPos[ 3 ] = { static_cast< int >( pBlockPos.x ) + i, static_cast< int >( pBlockPos.y ) + j, static_cast< int >( pBlockPos.z ) + k };
+		if ( neighborPos[ 0 ] < 0 || neighborPos[ 0 ] >= static_cast< int >( blocksInLevel.x )
+			|| neighborPos[ 1 ] < 0 || neighborPos[ 1 ] >= static_cast< int >( blocksInLevel.y )
+			|| neighborPos[ 2 ] < 0 || neighborPos[ 2 ] >= static_cast< int >( blocksInLevel.z ) )
+		{
+			continue;
+		}
+
+		// Retrieve the neighbor brick (the brick itself for the center slab)
+		const unsigned int neighborIndexVal = ( i == 0 && j == 0 && k == 0 ) ? pIndexVal : getBlockIndex( pLevel, make_uint3( neighborPos[ 0 ], neighborPos[ 1 ], neighborPos[ 2 ] ) );
+		if ( ! ( neighborIndexVal & GV_VTBA_BRICK_FLAG ) )
+		{
+			continue;
+		}
+		const TChannelType* neighborBrick = reinterpret_cast< const TChannelType* >( getStoredBrick( pChannel, pLevel, neighborIndexVal & 0x3FFFFFFFU, storedBrickByteSize ) );
+		if ( neighborBrick == NULL )
+		{
+			continue;
+		}
+
+		// Slab of the neighbor brick copied in the brick, on each axis :
+		// - the last voxels of the previous neighbor go to the lower border,
+		// - the interior voxels go to the interior,
+		// - the first voxels of the next neighbor go to the upper border.
+		const int offset[ 3 ] = { i, j, k };
+		const unsigned int resolution[ 3 ] = { _bricksRes.x, _bricksRes.y, _bricksRes.z };
+		unsigned int source[ 3 ];
+		unsigned int destination[ 3 ];
+		unsigned int size[ 3 ];
+		for ( unsigned int axis = 0; axis < 3; axis++ )
+		{
+			source[ axis ] = ( offset[ axis ] < 0 ) ? resolution[ axis ] - border : 0;
+			destination[ axis ] = ( offset[ axis ] < 0 ) ? 0 : ( ( offset[ axis ] == 0 ) ? border : border + resolution[ axis ] );
+			size[ axis ] = ( offset[ axis ] == 0 ) ? resolution[ axis ] : border;
+		}
+
+		// Copy rows of voxels
+		for ( unsigned int z = 0; z < size[ 2 ]; z++ )
+		for ( unsigned int y = 0; y < size[ 1 ]; y++ )
+		{
+			memcpy( brick + destination[ 0 ] + trueBlocksRes.x * ( ( destination[ 1 ] + y ) + trueBlocksRes.y * ( destination[ 2 ] + z ) ),
+					neighborBrick + source[ 0 ] + resolution[ 0 ] * ( ( source[ 1 ] + y ) + resolution[ 1 ] * ( source[ 2 ] + z ) ),
+					size[ 0 ] * sizeof( TChannelType ) );
+		}
+	}
+}
+
 /******************************************************************************
  * Retrieve the indexed coordinates of a block (i.e. a node) in the blocks grid
  * associated to a given position of a region of space at a given level of resolution.
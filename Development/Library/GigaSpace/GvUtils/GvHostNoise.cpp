@@ -0,0 +1,535 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#include "GvUtils/GvHostNoise.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvUtils/GvNoisePermutationTable.h"
+
+// STL
+#include <cmath>
+
+// SIMD
+#if defined( __AVX2__ )
+	#define GV_HOST_NOISE_USE_AVX2
+	#include <immintrin.h>
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define GV_HOST_NOISE_USE_SSE2
+	#include <emmintrin.h>
+#endif
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvUtils;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+namespace
+{
+
+/**
+ * Perlin noise permutation table (repeated twice to avoid index wrapping),
+ * same as GvNoiseKernel's one.
+ */
+const int gs_hostPermutationTable[ 512 ] =
+{
+	GV_NOISE_PERMUTATION_TABLE,
+	// Repeat
+	GV_NOISE_PERMUTATION_TABLE
+};
+
+/******************************************************************************
+ * Fade function (same as GvNoiseKernel::fade())
+ ******************************************************************************/
+inline float fade( float t )
+{
+	return t * t * t * ( t * ( t * 6.f - 15.f ) + 10.f );
+}
+
+/******************************************************************************
+ * Linear interpolation (same as CUDA helper lerp())
+ ******************************************************************************/
+inline float lerp( float a, float b, float t )
+{
+	return a + t * ( b - a );
+}
+
+/******************************************************************************
+ * Grad function (same as GvNoiseKernel::grad())
+ ******************************************************************************/
+inline float grad( int hash, float x, float y, float z )
+{
+	const int h = hash & 15;
+	const bool c1 = h < 8;
+	const bool c2 = h < 4;
+	const bool c3 = h == 12 || h == 14;
+	const bool c4 = ( h & 1 ) == 0;
+	const bool c5 = ( h & 2 ) == 0;
+	const float u = c1 ? x : y;
+	const float v = c2 ? y : c3 ? x : z;
+	return ( c4 ? u : -u ) + ( c5 ? v : -v );
+}
+
+#if defined( GV_HOST_NOISE_USE_AVX2 ) || defined( GV_HOST_NOISE_USE_SSE2 )
+
+/******************************************************************************
+ * SIMD primitives.
+ *
+ * Each primitive does exactly the same floating point operation as its scalar
+ * counterpart, so that SIMD and scalar paths give the same results.
+ ******************************************************************************/
+
+#if defined( GV_HOST_NOISE_USE_AVX2 )
+
+typedef __m256 SIMDFloat;
+typedef __m256i SIMDInt;
+const unsigned int cSIMDWidth = 8;
+
+inline SIMDFloat simdSet( float a ) { return _mm256_set1_ps( a ); }
+inline SIMDFloat simdAdd( SIMDFloat a, SIMDFloat b ) { return _mm256_add_ps( a, b ); }
+inline SIMDFloat simdSub( SIMDFloat a, SIMDFloat b ) { return _mm256_sub_ps( a, b ); }
+inline SIMDFloat simdMul( SIMDFloat a, SIMDFloat b ) { return _mm256_mul_ps( a, b ); }
+inline SIMDFloat simdXor( SIMDFloat a, SIMDFloat b ) { return _mm256_xor_ps( a, b ); }
+inline SIMDFloat simdAndNot( SIMDFloat a, SIMDFloat b ) { return _mm256_andnot_ps( a, b ); }
+inline SIMDFloat simdFloor( SIMDFloat a ) { return _mm256_floor_ps( a ); }
+inline SIMDInt simdToInt( SIMDFloat a ) { return _mm256_cvttps_epi32( a ); }
+inline SIMDInt simdSetInt( int a ) { return _mm256_set1_epi32( a ); }
+inline SIMDInt simdAddInt( SIMDInt a, SIMDInt b ) { return _mm256_add_epi32( a, b ); }
+inline SIMDInt simdAndInt( SIMDInt a, SIMDInt b ) { return _mm256_and_si256( a, b ); }
+inline SIMDInt simdOrInt( SIMDInt a, SIMDInt b ) { return _mm256_or_si256( a, b ); }
+inline SIMDInt simdLessInt( SIMDInt a, SIMDInt b ) { return _mm256_cmpgt_epi32( b, a ); }
+inline SIMDInt simdEqualInt( SIMDInt a, SIMDInt b ) { return _mm256_cmpeq_epi32( a, b ); }
+inline SIMDFloat simdSelect( SIMDInt pMask, SIMDFloat a, SIMDFloat b ) { return _mm256_blendv_ps( b, a, _mm256_castsi256_ps( pMask ) ); }
+inline void simdStore( float* p, SIMDFloat a ) { _mm256_storeu_ps( p, a ); }
+
+inline SIMDFloat simdIndices( unsigned int pFirst )
+{
+	return _mm256_cvtepi32_ps( _mm256_add_epi32( _mm256_set1_epi32( static_cast< int >( pFirst ) ), _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 ) ) );
+}
+
+inline SIMDInt simdLookup( SIMDInt pIndex )
+{
+	return _mm256_i32gather_epi32( gs_hostPermutationTable, pIndex, 4 );
+}
+
+#else
+
+typedef __m128 SIMDFloat;
+typedef __m128i SIMDInt;
+const unsigned int cSIMDWidth = 4;
+
+inline SIMDFloat simdSet( float a ) { return _mm_set1_ps( a ); }
+inline SIMDFloat simdAdd( SIMDFloat a, SIMDFloat b ) { return _mm_add_ps( a, b ); }
+inline SIMDFloat simdSub( SIMDFloat a, SIMDFloat b ) { return _mm_sub_ps( a, b ); }
+inline SIMDFloat simdMul( SIMDFloat a, SIMDFloat b ) { return _mm_mul_ps( a, b ); }
+inline SIMDFloat simdXor( SIMDFloat a, SIMDFloat b ) { return _mm_xor_ps( a, b ); }
+inline SIMDFloat simdAndNot( SIMDFloat a, SIMDFloat b ) { return _mm_andnot_ps( a, b ); }
+inline SIMDInt simdToInt( SIMDFloat a ) { return _mm_cvttps_epi32( a ); }
+inline SIMDInt simdSetInt( int a ) { return _mm_set1_epi32( a ); }
+inline SIMDInt simdAddInt( SIMDInt a, SIMDInt b ) { return _mm_add_epi32( a, b ); }
+inline SIMDInt simdAndInt( SIMDInt a, SIMDInt b ) { return _mm_and_si128( a, b ); }
+inline SIMDInt simdOrInt( SIMDInt a, SIMDInt b ) { return _mm_or_si128( a, b ); }
+inline SIMDInt simdLessInt( SIMDInt a, SIMDInt b ) { return _mm_cmplt_epi32( a, b ); }
+inline SIMDInt simdEqualInt( SIMDInt a, SIMDInt b ) { return _mm_cmpeq_epi32( a, b ); }
+inline void simdStore( float* p, SIMDFloat a ) { _mm_storeu_ps( p, a ); }
+
+inline SIMDFloat simdSelect( SIMDInt pMask, SIMDFloat a, SIMDFloat b )
+{
+	const SIMDFloat mask = _mm_castsi128_ps( pMask );
+	return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+}
+
+inline SIMDFloat simdFloor( SIMDFloat a )
+{
+	// SSE2 has no floor instruction : truncate, then correct negative values.
+	// The sign of the input is restored so that floor( -0 ) = -0, as floorf().
+	const SIMDFloat truncated = _mm_cvtepi32_ps( _mm_cvttps_epi32( a ) );
+	const SIMDFloat result = _mm_sub_ps( truncated, _mm_and_ps( _mm_cmpgt_ps( truncated, a ), _mm_set1_ps( 1.f ) ) );
+	return _mm_or_ps( result, _mm_and_ps( a, _mm_set1_ps( -0.f ) ) );
+}
+
+inline SIMDFloat simdIndices( unsigned int pFirst )
+{
+	return _mm_cvtepi32_ps( _mm_add_epi32( _mm_set1_epi32( static_cast< int >( pFirst ) ), _mm_setr_epi32( 0, 1, 2, 3 ) ) );
+}
+
+inline SIMDInt simdLookup( SIMDInt pIndex )
+{
+	// SSE2 has no gather instruction
+	int index[ 4 ];
+	_mm_storeu_si128( reinterpret_cast< __m128i* >( index ), pIndex );
+	return _mm_setr_epi32( gs_hostPermutationTable[ index[ 0 ] ], gs_hostPermutationTable[ index[ 1 ] ],
+						gs_hostPermutationTable[ index[ 2 ] ], gs_hostPermutationTable[ index[ 3 ] ] );
+}
+
+#endif
+
+/******************************************************************************
+ * SIMD fade function
+ ******************************************************************************/
+inline SIMDFloat simdFade( SIMDFloat t )
+{
+	const SIMDFloat t3 = simdMul( simdMul( t, t ), t );
+	return simdMul( t3, simdAdd( simdMul( t, simdSub( simdMul( t, simdSet( 6.f ) ), simdSet( 15.f ) ) ), simdSet( 10.f ) ) );
+}
+
+/******************************************************************************
+ * SIMD linear interpolation
+ ******************************************************************************/
+inline SIMDFloat simdLerp( SIMDFloat a, SIMDFloat b, SIMDFloat t )
+{
+	return simdAdd( a, simdMul( t, simdSub( b, a ) ) );
+}
+
+/******************************************************************************
+ * SIMD grad function
+ ******************************************************************************/
+inline SIMDFloat simdGrad( SIMDInt pHash, SIMDFloat x, SIMDFloat y, SIMDFloat z )
+{
+	const SIMDInt zero = simdSetInt( 0 );
+	const SIMDInt h = simdAndInt( pHash, simdSetInt( 15 ) );
+	const SIMDInt c1 = simdLessInt( h, simdSetInt( 8 ) );
+	const SIMDInt c2 = simdLessInt( h, simdSetInt( 4 ) );
+	const SIMDInt c3 = simdOrInt( simdEqualInt( h, simdSetInt( 12 ) ), simdEqualInt( h, simdSetInt( 14 ) ) );
+	const SIMDInt c4 = simdEqualInt( simdAndInt( h, simdSetInt( 1 ) ), zero );
+	const SIMDInt c5 = simdEqualInt( simdAndInt( h, simdSetInt( 2 ) ), zero );
+	const SIMDFloat u = simdSelect( c1, x, y );
+	const SIMDFloat v = simdSelect( c2, y, simdSelect( c3, x, z ) );
+	const SIMDFloat signMask = simdSet( -0.f );
+	return simdAdd( simdSelect( c4, u, simdXor( u, signMask ) ), simdSelect( c5, v, simdXor( v, signMask ) ) );
+}
+
+/******************************************************************************
+ * SIMD Perlin noise (same as GvHostNoise::getValue())
+ ******************************************************************************/
+inline SIMDFloat simdNoise( SIMDFloat x, SIMDFloat y, SIMDFloat z )
+{
+	const SIMDInt mask = simdSetInt( 255 );
+	const SIMDInt one = simdSetInt( 1 );
+
+	const SIMDFloat floorX = simdFloor( x );
+	const SIMDFloat floorY = simdFloor( y );
+	const SIMDFloat floorZ = simdFloor( z );
+	const SIMDInt X = simdAndInt( simdToInt( floorX ), mask );
+	const SIMDInt Y = simdAndInt( simdToInt( floorY ), mask );
+	const SIMDInt Z = simdAndInt( simdToInt( floorZ ), mask );
+
+	x = simdSub( x, floorX );
+	y = simdSub( y, floorY );
+	z = simdSub( z, floorZ );
+
+	const SIMDFloat u = simdFade( x );
+	const SIMDFloat v = simdFade( y );
+	const SIMDFloat w = simdFade( z );
+
+	const SIMDInt A = simdAddInt( simdLookup( X ), Y );
+	const SIMDInt AA = simdAddInt( simdLookup( A ), Z );
+	const SIMDInt AB = simdAddInt( simdLookup( simdAddInt( A, one ) ), Z );
+	const SIMDInt B = simdAddInt( simdLookup( simdAddInt( X, one ) ), Y );
+	const SIMDInt BA = simdAddInt( simdLookup( B ), Z );
+	const SIMDInt BB = simdAddInt( simdLookup( simdAddInt( B, one ) ), Z );
+
+	const SIMDFloat oneF = simdSet( 1.f );
+	const SIMDFloat x1 = simdSub( x, oneF );
+	const SIMDFloat y1 = simdSub( y, oneF );
+	const SIMDFloat z1 = simdSub( z, oneF );
+
+	return simdLerp(
+			simdLerp(
+				simdLerp( simdGrad( simdLookup( AA ), x, y, z ),
+						  simdGrad( simdLookup( BA ), x1, y, z ),
+						  u ),
+				simdLerp( simdGrad( simdLookup( AB ), x, y1, z ),
+						  simdGrad( simdLookup( BB ), x1, y1, z ),
+						  u ),
+				v ),
+			simdLerp(
+				simdLerp( simdGrad( simdLookup( simdAddInt( AA, one ) ), x, y, z1 ),
+						  simdGrad( simdLookup( simdAddInt( BA, one ) ), x1, y, z1 ),
+						  u ),
+				simdLerp( simdGrad( simdLookup( simdAddInt( AB, one ) ), x, y1, z1 ),
+						  simdGrad( simdLookup( simdAddInt( BB, one ) ), x1, y1, z1 ),
+						  u ),
+				v ),
+			w );
+}
+
+#else
+
+const unsigned int cSIMDWidth = 1;
+
+#endif
+
+}
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Compute the Perlin noise given a 3D position
+ *
+ * @param pX x coordinate position
+ * @param pY y coordinate position
+ * @param pZ z coordinate position
+ *
+ * @return the noise at given position
+ ******************************************************************************/
+float GvHostNoise::getValue( float pX, float pY, float pZ )
+{
+	const float floorX = floorf( pX );
+	const float floorY = floorf( pY );
+	const float floorZ = floorf( pZ );
+	const int X = static_cast< int >( floorX ) & 255;
+	const int Y = static_cast< int >( floorY ) & 255;
+	const int Z = static_cast< int >( floorZ ) & 255;
+
+	const float x = pX - floorX;
+	const float y = pY - floorY;
+	const float z = pZ - floorZ;
+
+	const float u = fade( x );
+	const float v = fade( y );
+	const float w = fade( z );
+
+	const int* p = gs_hostPermutationTable;
+	const int A = p[ X ] + Y, AA = p[ A ] + Z, AB = p[ A + 1 ] + Z;
+	const int B = p[ X + 1 ] + Y, BA = p[ B ] + Z, BB = p[ B + 1 ] + Z;
+
+	return lerp(
+			lerp(
+				lerp( grad( p[ AA ], x, y, z ),
+					  grad( p[ BA ], x - 1, y, z ),
+					  u ),
+				lerp( grad( p[ AB ], x, y - 1, z ),
+					  grad( p[ BB ], x - 1, y - 1, z ),
+					  u ),
+				v ),
+			lerp(
+				lerp( grad( p[ AA + 1 ], x, y, z - 1 ),
+					  grad( p[ BA + 1 ], x - 1, y, z - 1 ),
+					  u ),
+				lerp( grad( p[ AB + 1 ], x, y - 1, z - 1 ),
+					  grad( p[ BB + 1 ], x - 1, y - 1, z - 1 ),
+					  u ),
+				v ),
+			w );
+}
+
+/******************************************************************************
+ * Compute the Perlin noise along a row of points.
+ * Point i is located at ( pX + i * pStep, pY, pZ ).
+ *
+ * @param pX x coordinate of the first point
+ * @param pY y coordinate of the row
+ * @param pZ z coordinate of the row
+ * @param pStep distance between two points
+ * @param pNbPoints number of points
+ * @param pValues the resulting noise values (pNbPoints values)
+ ******************************************************************************/
+void GvHostNoise::getRow( float pX, float pY, float pZ, float pStep, unsigned int pNbPoints, float* pValues )
+{
+	unsigned int i = 0;
+
+#if defined( GV_HOST_NOISE_USE_AVX2 ) || defined( GV_HOST_NOISE_USE_SSE2 )
+	const SIMDFloat x0 = simdSet( pX );
+	const SIMDFloat y = simdSet( pY );
+	const SIMDFloat z = simdSet( pZ );
+	const SIMDFloat step = simdSet( pStep );
+	for ( ; i + cSIMDWidth <= pNbPoints; i += cSIMDWidth )
+	{
+		const SIMDFloat x = simdAdd( x0, simdMul( simdIndices( i ), step ) );
+		simdStore( pValues + i, simdNoise( x, y, z ) );
+	}
+#endif
+
+	// Remaining points
+	for ( ; i < pNbPoints; i++ )
+	{
+		pValues[ i ] = getValue( pX + static_cast< float >( i ) * pStep, pY, pZ );
+	}
+}
+
+/******************************************************************************
+ * Compute the fractal sum of Perlin noise given a 3D position
+ *
+ * @param pX x coordinate position
+ * @param pY y coordinate position
+ * @param pZ z coordinate position
+ * @param pFirstFrequency frequency of the first octave
+ * @param pMaxFrequency octaves are added while their frequency is lower than this value
+ * @param pStrength strength of the noise
+ *
+ * @return the fractal sum at given position
+ ******************************************************************************/
+float GvHostNoise::getFractalSum( float pX, float pY, float pZ, float pFirstFrequency, float pMaxFrequency, float pStrength )
+{
+	float result = 0.f;
+	for ( float frequency = pFirstFrequency; frequency < pMaxFrequency; frequency *= 2.f )
+	{
+		result += pStrength / frequency * getValue( frequency * pX, frequency * pY, frequency * pZ );
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * Compute the turbulence (fractal sum of absolute Perlin noise) given a 3D position
+ *
+ * @param pX x coordinate position
+ * @param pY y coordinate position
+ * @param pZ z coordinate position
+ * @param pFirstFrequency frequency of the first octave
+ * @param pMaxFrequency octaves are added while their frequency is lower than this value
+ * @param pStrength strength of the noise
+ *
+ * @return the turbulence at given position
+ ******************************************************************************/
+float GvHostNoise::getTurbulence( float pX, float pY, float pZ, float pFirstFrequency, float pMaxFrequency, float pStrength )
+{
+	float result = 0.f;
+	for ( float frequency = pFirstFrequency; frequency < pMaxFrequency; frequency *= 2.f )
+	{
+		result += pStrength / frequency * fabsf( getValue( frequency * pX, frequency * pY, frequency * pZ ) );
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * Compute the fractal sum of Perlin noise along a row of points.
+ * Point i is located at ( pX + i * pStep, pY, pZ ).
+ *
+ * @param pX x coordinate of the first point
+ * @param pY y coordinate of the row
+ * @param pZ z coordinate of the row
+ * @param pStep distance between two points
+ * @param pNbPoints number of points
+ * @param pFirstFrequency frequency of the first octave
+ * @param pMaxFrequency octaves are added while their frequency is lower than this value
+ * @param pStrength strength of the noise
+ * @param pValues the resulting values (pNbPoints values)
+ ******************************************************************************/
+void GvHostNoise::getFractalSumRow( float pX, float pY, float pZ, float pStep, unsigned int pNbPoints,
+								float pFirstFrequency, float pMaxFrequency, float pStrength, float* pValues )
+{
+	sumOctavesRow( pX, pY, pZ, pStep, pNbPoints, pFirstFrequency, pMaxFrequency, pStrength, false, pValues );
+}
+
+/******************************************************************************
+ * Compute the turbulence (fractal sum of absolute Perlin noise) along a row of points.
+ * Point i is located at ( pX + i * pStep, pY, pZ ).
+ *
+ * @param pX x coordinate of the first point
+ * @param pY y coordinate of the row
+ * @param pZ z coordinate of the row
+ * @param pStep distance between two points
+ * @param pNbPoints number of points
+ * @param pFirstFrequency frequency of the first octave
+ * @param pMaxFrequency octaves are added while their frequency is lower than this value
+ * @param pStrength strength of the noise
+ * @param pValues the resulting values (pNbPoints values)
+ ******************************************************************************/
+void GvHostNoise::getTurbulenceRow( float pX, float pY, float pZ, float pStep, unsigned int pNbPoints,
+								float pFirstFrequency, float pMaxFrequency, float pStrength, float* pValues )
+{
+	sumOctavesRow( pX, pY, pZ, pStep, pNbPoints, pFirstFrequency, pMaxFrequency, pStrength, true, pValues );
+}
+
+/******************************************************************************
+ * Retrieve the number of points evaluated at a time by row methods
+ *
+ * @return 8 with AVX2, 4 with SSE2, 1 otherwise
+ ******************************************************************************/
+unsigned int GvHostNoise::getSIMDWidth()
+{
+	return cSIMDWidth;
+}
+
+/******************************************************************************
+ * Compute the sum of octaves along a row of points
+ *
+ * @param pX x coordinate of the first point
+ * @param pY y coordinate of the row
+ * @param pZ z coordinate of the row
+ * @param pStep distance between two points
+ * @param pNbPoints number of points
+ * @param pFirstFrequency frequency of the first octave
+ * @param pMaxFrequency octaves are added while their frequency is lower than this value
+ * @param pStrength strength of the noise
+ * @param pAbsolute flag telling wheter or not absolute noise values are summed (turbulence)
+ * @param pValues the resulting values (pNbPoints values)
+ ******************************************************************************/
+void GvHostNoise::sumOctavesRow( float pX, float pY, float pZ, float pStep, unsigned int pNbPoints,
+								float pFirstFrequency, float pMaxFrequency, float pStrength, bool pAbsolute, float* pValues )
+{
+	unsigned int i = 0;
+
+#if defined( GV_HOST_NOISE_USE_AVX2 ) || defined( GV_HOST_NOISE_USE_SSE2 )
+	const SIMDFloat x0 = simdSet( pX );
+	const SIMDFloat step = simdSet( pStep );
+	const SIMDFloat signMask = simdSet( -0.f );
+	for ( ; i + cSIMDWidth <= pNbPoints; i += cSIMDWidth )
+	{
+		const SIMDFloat x = simdAdd( x0, simdMul( simdIndices( i ), step ) );
+
+		SIMDFloat result = simdSet( 0.f );
+		for ( float frequency = pFirstFrequency; frequency < pMaxFrequency; frequency *= 2.f )
+		{
+			const SIMDFloat f = simdSet( frequency );
+			SIMDFloat noise = simdNoise( simdMul( f, x ), simdSet( frequency * pY ), simdSet( frequency * pZ ) );
+			if ( pAbsolute )
+			{
+				noise = simdAndNot( signMask, noise );
+			}
+			result = simdAdd( result, simdMul( simdSet( pStrength / frequency ), noise ) );
+		}
+		simdStore( pValues + i, result );
+	}
+#endif
+
+	// Remaining points
+	for ( ; i < pNbPoints; i++ )
+	{
+		const float x = pX + static_cast< float >( i ) * pStep;
+		pValues[ i ] = pAbsolute ? getTurbulence( x, pY, pZ, pFirstFrequency, pMaxFrequency, pStrength )
+								 : getFractalSum( x, pY, pZ, pFirstFrequency, pMaxFrequency, pStrength );
+	}
+}
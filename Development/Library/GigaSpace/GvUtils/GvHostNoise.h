@@ -0,0 +1,229 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#ifndef _GV_HOST_NOISE_H_
+#define _GV_HOST_NOISE_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvUtils
+{
+
+/**
+ * @class GvHostNoise
+ *
+ * @brief The GvHostNoise class provides an implementation
+ * of a perlin noise on the host.
+ *
+ * It uses the same permutation table and gradients as GvNoiseKernel::getValue(),
+ * so that host producers (i.e. procedural bricks precomputed offline) generate
+ * the same values as device producers. Operations are done in the same order
+ * as on the device : results are bit-compatible as long as neither compiler contracts
+ * multiply-adds (nvcc -fmad=false, host -ffp-contract=off), and differ by a few ulps otherwise.
+ *
+ * Row methods evaluate points along the X axis (i.e. a row of a brick) several points at a time
+ * with AVX2 (8 points) or SSE2 (4 points) when available at compile time (see GV_USE_AVX2 CMake option).
+ * Each point of a row gives exactly the same value as the scalar method.
+ *
+ * Fractal sum and turbulence follow the ProceduralTechnics/Noise demos :
+ * octaves are summed from a first frequency while the frequency is lower than a max frequency,
+ * doubling the frequency each time, each octave being weighted by ( strength / frequency ).
+ */
+class GIGASPACE_EXPORT GvHostNoise
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Compute the Perlin noise given a 3D position
+	 *
+	 * @param pX x coordinate position
+	 * @param pY y coordinate position
+	 * @param pZ z coordinate position
+	 *
+	 * @return the noise at given position
+	 */
+	static float getValue( float pX, float pY, float pZ );
+
+	/**
+	 * Compute the Perlin noise along a row of points.
+	 * Point i is located at ( pX + i * pStep, pY, pZ ).
+	 *
+	 * @param pX x coordinate of the first point
+	 * @param pY y coordinate of the row
+	 * @param pZ z coordinate of the row
+	 * @param pStep distance between two points
+	 * @param pNbPoints number of points
+	 * @param pValues the resulting noise values (pNbPoints values)
+	 */
+	static void getRow( float pX, float pY, float pZ, float pStep, unsigned int pNbPoints, float* pValues );
+
+	/**
+	 * Compute the fractal sum of Perlin noise given a 3D position
+	 *
+	 * @param pX x coordinate position
+	 * @param pY y coordinate position
+	 * @param pZ z coordinate position
+	 * @param pFirstFrequency frequency of the first octave
+	 * @param pMaxFrequency octaves are added while their frequency is lower than this value
+	 * @param pStrength strength of the noise
+	 *
+	 * @return the fractal sum at given position
+	 */
+	static float getFractalSum( float pX, float pY, float pZ, float pFirstFrequency, float pMaxFrequency, float pStrength = 1.f );
+
+	/**
+	 * Compute the turbulence (fractal sum of absolute Perlin noise) given a 3D position
+	 *
+	 * @param pX x coordinate position
+	 * @param pY y coordinate position
+	 * @param pZ z coordinate position
+	 * @param pFirstFrequency frequency of the first octave
+	 * @param pMaxFrequency octaves are added while their frequency is lower than this value
+	 * @param pStrength strength of the noise
+	 *
+	 * @return the turbulence at given position
+	 */
+	static float getTurbulence( float pX, float pY, float pZ, float pFirstFrequency, float pMaxFrequency, float pStrength = 1.f );
+
+	/**
+	 * Compute the fractal sum of Perlin noise along a row of points.
+	 * Point i is located at ( pX + i * pStep, pY, pZ ).
+	 *
+	 * @param pX x coordinate of the first point
+	 * @param pY y coordinate of the row
+	 * @param pZ z coordinate of the row
+	 * @param pStep distance between two points
+	 * @param pNbPoints number of points
+	 * @param pFirstFrequency frequency of the first octave
+	 * @param pMaxFrequency octaves are added while their frequency is lower than this value
+	 * @param pStrength strength of the noise
+	 * @param pValues the resulting values (pNbPoints values)
+	 */
+	static void getFractalSumRow( float pX, float pY, float pZ, float pStep, unsigned int pNbPoints,
+								float pFirstFrequency, float pMaxFrequency, float pStrength, float* pValues );
+
+	/**
+	 * Compute the turbulence (fractal sum of absolute Perlin noise) along a row of points.
+	 * Point i is located at ( pX + i * pStep, pY, pZ ).
+	 *
+	 * @param pX x coordinate of the first point
+	 * @param pY y coordinate of the row
+	 * @param pZ z coordinate of the row
+	 * @param pStep distance between two points
+	 * @param pNbPoints number of points
+	 * @param pFirstFrequency frequency of the first octave
+	 * @param pMaxFrequency octaves are added while their frequency is lower than this value
+	 * @param pStrength strength of the noise
+	 * @param pValues the resulting values (pNbPoints values)
+	 */
+	static void getTurbulenceRow( float pX, float pY, float pZ, float pStep, unsigned int pNbPoints,
+								float pFirstFrequency, float pMaxFrequency, float pStrength, float* pValues );
+
+	/**
+	 * Retrieve the number of points evaluated at a time by row methods
+	 *
+	 * @return 8 with AVX2, 4 with SSE2, 1 otherwise
+	 */
+	static unsigned int getSIMDWidth();
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Compute the sum of octaves along a row of points
+	 *
+	 * @param pX x coordinate of the first point
+	 * @param pY y coordinate of the row
+	 * @param pZ z coordinate of the row
+	 * @param pStep distance between two points
+	 * @param pNbPoints number of points
+	 * @param pFirstFrequency frequency of the first octave
+	 * @param pMaxFrequency octaves are added while their frequency is lower than this value
+	 * @param pStrength strength of the noise
+	 * @param pAbsolute flag telling wheter or not absolute noise values are summed (turbulence)
+	 * @param pValues the resulting values (pNbPoints values)
+	 */
+	static void sumOctavesRow( float pX, float pY, float pZ, float pStep, unsigned int pNbPoints,
+								float pFirstFrequency, float pMaxFrequency, float pStrength, bool pAbsolute, float* pValues );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor forbidden (only static methods).
+	 */
+	GvHostNoise();
+
+};
+
+} // namespace GvUtils
+
+#endif
@@ -34,6 +34,7 @@
 // GigaVoxels
 #include "GvCore/GvCoreConfig.h"
 #include "GvCore/Array3D.h"
+#include "GvVoxelizer/GvNodeSummary.h"
 
 /******************************************************************************
  ************************* DEFINE AND CONSTANT SECTION ************************
@@ -75,12 +76,16 @@ public:
 
 	/**
 	 * Enumeration of different types of a region.
+	 * VP_UNAVAILABLE_REGION is only returned by getRegion() : the region holds data,
+	 * but its brick could not be retrieved, so nothing has been written in the pool.
+	 * The producer must not mark it as produced, so that it is requested again.
 	 */
 	enum VPRegionInfo
 	{
 		VP_CONST_REGION,
 		VP_NON_CONST_REGION,
-		VP_UNKNOWN_REGION
+		VP_UNKNOWN_REGION,
+		VP_UNAVAILABLE_REGION
 	};
 
 	/******************************* ATTRIBUTES *******************************/
@@ -129,6 +134,21 @@ public:
 	 */
 	inline virtual uint getRegionInfoNew( const float3& pPosition, const float3& pSize );
 
+	/**
+	 * Retrieve the summary (min/max, occupancy, homogeneity) of the node
+	 * located in a region of space, for a given data channel.
+	 *
+	 * Default implementation provides no summary.
+	 *
+	 * @param pPosition position of a region of space
+	 * @param pSize size of a region of space
+	 * @param pChannel data channel index
+	 * @param pSummary the resulting node summary
+	 *
+	 * @return a flag telling wheter or not a summary is available for that region
+	 */
+	inline virtual bool getRegionSummary( const float3& pPosition, const float3& pSize, unsigned int pChannel, GvVoxelizer::GvNodeSummary& pSummary );
+
 	/**
 	 * Provides the size of the smallest features the producer can generate.
 	 *
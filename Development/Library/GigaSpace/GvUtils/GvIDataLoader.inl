@@ -96,6 +96,26 @@ inline uint GvIDataLoader< TDataTypeList >
 	return 0;
 }
 
+/******************************************************************************
+ * Retrieve the summary (min/max, occupancy, homogeneity) of the node
+ * located in a region of space, for a given data channel.
+ *
+ * Default implementation provides no summary.
+ *
+ * @param pPosition position of a region of space
+ * @param pSize size of a region of space
+ * @param pChannel data channel index
+ * @param pSummary the resulting node summary
+ *
+ * @return a flag telling wheter or not a summary is available for that region
+ ******************************************************************************/
+template< typename TDataTypeList >
+inline bool GvIDataLoader< TDataTypeList >
+::getRegionSummary( const float3& pPosition, const float3& pSize, unsigned int pChannel, GvVoxelizer::GvNodeSummary& pSummary )
+{
+	return false;
+}
+
 /******************************************************************************
  * Provides the size of the smallest features the producer can generate.
  *
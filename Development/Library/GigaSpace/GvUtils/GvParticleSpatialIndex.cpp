@@ -0,0 +1,655 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvUtils/GvParticleSpatialIndex.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvError.h"
+
+// Cuda
+#include <cuda_runtime.h>
+
+// STL
+#include <iostream>
+#include <algorithm>
+
+// System
+#include <cstring>
+#ifndef WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvUtils;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Min number of particles sorted by a thread
+ */
+static const unsigned int cMinNbParticlesPerThread = 16384;
+
+/**
+ * Max number of unmodified particles between two ranges of modified particles uploaded at once
+ */
+static const unsigned int cMaxUploadGap = 1024;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+namespace
+{
+
+/******************************************************************************
+ * Get the cell coordinate of a particle coordinate
+ *
+ * @param pValue the particle coordinate
+ * @param pResolution the number of cells along an axis
+ *
+ * @return the cell coordinate
+ ******************************************************************************/
+inline unsigned int getCellCoordinate( float pValue, unsigned int pResolution )
+{
+	// Particles outside the unit cube are put in the border cells
+	const float value = pValue * static_cast< float >( pResolution );
+	if ( ! ( value > 0.f ) )
+	{
+		return 0;
+	}
+
+	return ( value < static_cast< float >( pResolution ) ) ? static_cast< unsigned int >( value ) : pResolution - 1;
+}
+
+/******************************************************************************
+ * Sort ranges and merge the ones that overlap or are close
+ *
+ * @param pRanges the ranges ( first, end )
+ * @param pMaxGap max distance between two ranges to merge them
+ ******************************************************************************/
+void mergeRanges( std::vector< std::pair< unsigned int, unsigned int > >& pRanges, unsigned int pMaxGap )
+{
+	if ( pRanges.empty() )
+	{
+		return;
+	}
+
+	std::sort( pRanges.begin(), pRanges.end() );
+
+	size_t nbRanges = 1;
+	for ( size_t i = 1; i < pRanges.size(); i++ )
+	{
+		std::pair< unsigned int, unsigned int >& lastRange = pRanges[ nbRanges - 1 ];
+		if ( pRanges[ i ].first <= lastRange.second + pMaxGap )
+		{
+			lastRange.second = std::max( lastRange.second, pRanges[ i ].second );
+		}
+		else
+		{
+			pRanges[ nbRanges ] = pRanges[ i ];
+			nbRanges++;
+		}
+	}
+	pRanges.resize( nbRanges );
+}
+
+}
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pDepth depth of the grid (i.e. 2^depth cells along each axis)
+ ******************************************************************************/
+GvParticleSpatialIndex::GvParticleSpatialIndex( unsigned int pDepth )
+:	_depth( std::min( pDepth, static_cast< unsigned int >( maxDepth ) ) )
+,	_nbThreads( 1 )
+,	_particles()
+,	_cellCodes()
+,	_sortedParticles()
+,	_sortedIndices()
+,	_ranks()
+,	_cellStarts()
+,	_histograms()
+,	_maxRadius( 0.f )
+,	_deviceCapacity( 0 )
+,	_nbUploadedParticles( 0 )
+,	_firstChangedCell( 0 )
+,	_endChangedCell( 0 )
+{
+	_kernelObject._particles = NULL;
+	_kernelObject._cellStarts = NULL;
+	_kernelObject._nbParticles = 0;
+	_kernelObject._depth = _depth;
+	_kernelObject._maxRadius = 0.f;
+
+#ifndef WIN32
+	const long nbProcessors = sysconf( _SC_NPROCESSORS_ONLN );
+	_nbThreads = ( nbProcessors > 0 ) ? static_cast< unsigned int >( nbProcessors ) : 1;
+#endif
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvParticleSpatialIndex::~GvParticleSpatialIndex()
+{
+	// Free device memory
+	if ( _kernelObject._particles != NULL )
+	{
+		GV_CUDA_SAFE_CALL( cudaFree( _kernelObject._particles ) );
+	}
+	if ( _kernelObject._cellStarts != NULL )
+	{
+		GV_CUDA_SAFE_CALL( cudaFree( _kernelObject._cellStarts ) );
+	}
+}
+
+/******************************************************************************
+ * Get the depth of the grid
+ *
+ * @return the depth of the grid
+ ******************************************************************************/
+unsigned int GvParticleSpatialIndex::getDepth() const
+{
+	return _depth;
+}
+
+/******************************************************************************
+ * Get the number of particles
+ *
+ * @return the number of particles
+ ******************************************************************************/
+unsigned int GvParticleSpatialIndex::getNbParticles() const
+{
+	return static_cast< unsigned int >( _particles.size() );
+}
+
+/******************************************************************************
+ * Get the max radius of the particles
+ *
+ * @return the max radius of the particles
+ ******************************************************************************/
+float GvParticleSpatialIndex::getMaxRadius() const
+{
+	return _maxRadius;
+}
+
+/******************************************************************************
+ * Set the number of threads used to sort the particles
+ *
+ * @param pValue the number of threads
+ ******************************************************************************/
+void GvParticleSpatialIndex::setNbThreads( unsigned int pValue )
+{
+	_nbThreads = std::max( pValue, 1U );
+}
+
+/******************************************************************************
+ * Get the particles, sorted by the Morton code of their cell
+ *
+ * @return the sorted particles
+ ******************************************************************************/
+const std::vector< float4 >& GvParticleSpatialIndex::getSortedParticles() const
+{
+	return _sortedParticles;
+}
+
+/******************************************************************************
+ * Get the index of the first particle of each cell, followed by the number of particles
+ *
+ * @return the cell starts
+ ******************************************************************************/
+const std::vector< unsigned int >& GvParticleSpatialIndex::getCellStarts() const
+{
+	return _cellStarts;
+}
+
+/******************************************************************************
+ * Get the associated device-side object
+ *
+ * @return the associated device-side object
+ ******************************************************************************/
+const GvParticleSpatialIndexKernel& GvParticleSpatialIndex::getKernelObject() const
+{
+	return _kernelObject;
+}
+
+/******************************************************************************
+ * Get the number of particles uploaded by the last update
+ *
+ * @return the number of uploaded particles
+ ******************************************************************************/
+unsigned int GvParticleSpatialIndex::getNbUploadedParticles() const
+{
+	return _nbUploadedParticles;
+}
+
+/******************************************************************************
+ * Get the range of the cells whose particles have changed during the last build or update
+ * (all cells after a build). Data produced from particles of other cells is still valid.
+ *
+ * @param pFirstCell the Morton code of the first changed cell
+ * @param pLastCell the Morton code of the last changed cell
+ *
+ * @return a flag telling wheter or not particles have changed
+ ******************************************************************************/
+bool GvParticleSpatialIndex::getChangedCells( unsigned int& pFirstCell, unsigned int& pLastCell ) const
+{
+	if ( _endChangedCell <= _firstChangedCell )
+	{
+		return false;
+	}
+
+	pFirstCell = _firstChangedCell;
+	pLastCell = _endChangedCell - 1;
+
+	return true;
+}
+
+/******************************************************************************
+ * Build the index of particles, and update device memory
+ *
+ * @param pParticles the particles (position in the unit cube and radius)
+ * @param pNbParticles the number of particles
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvParticleSpatialIndex::build( const float4* pParticles, unsigned int pNbParticles )
+{
+	const unsigned int nbCells = 1U << ( 3 * _depth );
+
+	_particles.assign( pParticles, pParticles + pNbParticles );
+	_cellCodes.resize( pNbParticles );
+	_sortedParticles.resize( pNbParticles );
+	_sortedIndices.resize( pNbParticles );
+	_ranks.resize( pNbParticles );
+	_cellStarts.assign( nbCells + 1, 0 );
+
+	_maxRadius = 0.f;
+	for ( unsigned int i = 0; i < pNbParticles; i++ )
+	{
+		_maxRadius = std::max( _maxRadius, pParticles[ i ].w );
+	}
+
+	// Split particles between threads
+	const unsigned int nbTasks = std::max( 1U, std::min( _nbThreads, pNbParticles / cMinNbParticlesPerThread ) );
+	_histograms.assign( static_cast< size_t >( nbTasks ) * nbCells, 0 );
+	std::vector< Task > tasks( nbTasks );
+	for ( unsigned int i = 0; i < nbTasks; i++ )
+	{
+		tasks[ i ]._index = this;
+		tasks[ i ]._first = static_cast< unsigned int >( static_cast< unsigned long long >( pNbParticles ) * i / nbTasks );
+		tasks[ i ]._end = static_cast< unsigned int >( static_cast< unsigned long long >( pNbParticles ) * ( i + 1 ) / nbTasks );
+		tasks[ i ]._histogram = &_histograms[ static_cast< size_t >( i ) * nbCells ];
+		tasks[ i ]._isScattering = false;
+	}
+
+	// Count the particles of each cell
+	runTasks( tasks );
+
+	// Cell starts, and first particle of each task in each cell
+	// (particles of a cell are in the order of their index)
+	unsigned int offset = 0;
+	for ( unsigned int cell = 0; cell < nbCells; cell++ )
+	{
+		_cellStarts[ cell ] = offset;
+		for ( unsigned int i = 0; i < nbTasks; i++ )
+		{
+			const unsigned int count = tasks[ i ]._histogram[ cell ];
+			tasks[ i ]._histogram[ cell ] = offset;
+			offset += count;
+		}
+	}
+	_cellStarts[ nbCells ] = offset;
+
+	// Scatter the particles
+	for ( unsigned int i = 0; i < nbTasks; i++ )
+	{
+		tasks[ i ]._isScattering = true;
+	}
+	runTasks( tasks );
+
+	// Allocate device memory
+	if ( _kernelObject._particles == NULL || pNbParticles > _deviceCapacity )
+	{
+		if ( _kernelObject._particles != NULL )
+		{
+			GV_CUDA_SAFE_CALL( cudaFree( _kernelObject._particles ) );
+			_kernelObject._particles = NULL;
+		}
+		_deviceCapacity = std::max( pNbParticles, 1U );
+		if ( cudaMalloc( &_kernelObject._particles, _deviceCapacity * sizeof( float4 ) ) != cudaSuccess )
+		{
+			std::cerr << "GvParticleSpatialIndex::build() : unable to allocate device memory for " << pNbParticles << " particles" << std::endl;
+			_kernelObject._particles = NULL;
+			_deviceCapacity = 0;
+
+			return false;
+		}
+	}
+	if ( _kernelObject._cellStarts == NULL )
+	{
+		if ( cudaMalloc( &_kernelObject._cellStarts, ( nbCells + 1 ) * sizeof( unsigned int ) ) != cudaSuccess )
+		{
+			std::cerr << "GvParticleSpatialIndex::build() : unable to allocate device memory for " << nbCells << " cells" << std::endl;
+			_kernelObject._cellStarts = NULL;
+
+			return false;
+		}
+	}
+	_kernelObject._nbParticles = pNbParticles;
+	_kernelObject._maxRadius = _maxRadius;
+
+	_nbUploadedParticles = 0;
+	_firstChangedCell = 0;
+	_endChangedCell = nbCells;
+
+	return updateDeviceMemory( 0, pNbParticles, 0, nbCells + 1 );
+}
+
+/******************************************************************************
+ * Update the index after particles have moved, and update device memory.
+ *
+ * Particles are compared to the ones the index has been built from :
+ * only the cells of the moved particles are sorted again.
+ * The index is built again when the number of particles has changed.
+ *
+ * @param pParticles the particles (position in the unit cube and radius)
+ * @param pNbParticles the number of particles
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvParticleSpatialIndex::update( const float4* pParticles, unsigned int pNbParticles )
+{
+	if ( _kernelObject._particles == NULL || _kernelObject._cellStarts == NULL || pNbParticles != _particles.size() )
+	{
+		return build( pParticles, pNbParticles );
+	}
+
+	// Ranges ( first, end ) of the particles that have changed without leaving their cell,
+	// and of the cells between the one a particle has left and the one it has entered
+	std::vector< std::pair< unsigned int, unsigned int > > particleRanges;
+	std::vector< std::pair< unsigned int, unsigned int > > cellRanges;
+
+	_firstChangedCell = 1U << ( 3 * _depth );
+	_endChangedCell = 0;
+
+	bool isMaxRadiusDecreased = false;
+	for ( unsigned int i = 0; i < pNbParticles; i++ )
+	{
+		const float4& particle = pParticles[ i ];
+		float4& previousParticle = _particles[ i ];
+		if ( memcmp( &particle, &previousParticle, sizeof( float4 ) ) == 0 )
+		{
+			continue;
+		}
+
+		if ( particle.w >= _maxRadius )
+		{
+			_maxRadius = particle.w;
+		}
+		else if ( previousParticle.w == _maxRadius )
+		{
+			isMaxRadiusDecreased = true;
+		}
+		previousParticle = particle;
+
+		const unsigned int cellCode = getCellCode( particle );
+		_firstChangedCell = std::min( _firstChangedCell, std::min( cellCode, _cellCodes[ i ] ) );
+		_endChangedCell = std::max( _endChangedCell, std::max( cellCode, _cellCodes[ i ] ) + 1 );
+		if ( cellCode == _cellCodes[ i ] )
+		{
+			const unsigned int rank = _ranks[ i ];
+			_sortedParticles[ rank ] = particle;
+			particleRanges.push_back( std::make_pair( rank, rank + 1 ) );
+		}
+		else
+		{
+			cellRanges.push_back( std::make_pair( std::min( cellCode, _cellCodes[ i ] ), std::max( cellCode, _cellCodes[ i ] ) + 1 ) );
+			_cellCodes[ i ] = cellCode;
+		}
+	}
+
+	if ( isMaxRadiusDecreased )
+	{
+		_maxRadius = 0.f;
+		for ( unsigned int i = 0; i < pNbParticles; i++ )
+		{
+			_maxRadius = std::max( _maxRadius, _particles[ i ].w );
+		}
+	}
+	_kernelObject._maxRadius = _maxRadius;
+
+	_nbUploadedParticles = 0;
+
+	// Sort again the cells between the ones particles have left and entered.
+	// Once overlapping ranges are merged, the moved particles stay in the range of their cells :
+	// the start of the first cell and the end of the last cell are not modified.
+	bool result = true;
+	mergeRanges( cellRanges, 0 );
+	for ( size_t i = 0; i < cellRanges.size(); i++ )
+	{
+		sortCells( cellRanges[ i ].first, cellRanges[ i ].second - 1 );
+
+		particleRanges.push_back( std::make_pair( _cellStarts[ cellRanges[ i ].first ], _cellStarts[ cellRanges[ i ].second ] ) );
+		result = updateDeviceMemory( 0, 0, cellRanges[ i ].first + 1, cellRanges[ i ].second ) && result;
+	}
+
+	// Upload the modified particles (close ranges are uploaded at once)
+	mergeRanges( particleRanges, cMaxUploadGap );
+	for ( size_t i = 0; i < particleRanges.size(); i++ )
+	{
+		result = updateDeviceMemory( particleRanges[ i ].first, particleRanges[ i ].second, 0, 0 ) && result;
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * Get the cell of a particle
+ *
+ * @param pParticle the particle
+ *
+ * @return the Morton code of the cell
+ ******************************************************************************/
+unsigned int GvParticleSpatialIndex::getCellCode( const float4& pParticle ) const
+{
+	const unsigned int resolution = 1U << _depth;
+	const uint3 cell = make_uint3( getCellCoordinate( pParticle.x, resolution ),
+									getCellCoordinate( pParticle.y, resolution ),
+									getCellCoordinate( pParticle.z, resolution ) );
+
+	return GvParticleSpatialIndexKernel::getCellCode( cell );
+}
+
+/******************************************************************************
+ * Count or scatter the particles of a task
+ *
+ * @param pTask the task
+ ******************************************************************************/
+void GvParticleSpatialIndex::sortParticles( const Task& pTask )
+{
+	if ( ! pTask._isScattering )
+	{
+		for ( unsigned int i = pTask._first; i < pTask._end; i++ )
+		{
+			const unsigned int cellCode = getCellCode( _particles[ i ] );
+			_cellCodes[ i ] = cellCode;
+			pTask._histogram[ cellCode ]++;
+		}
+	}
+	else
+	{
+		for ( unsigned int i = pTask._first; i < pTask._end; i++ )
+		{
+			const unsigned int rank = pTask._histogram[ _cellCodes[ i ] ]++;
+			_sortedParticles[ rank ] = _particles[ i ];
+			_sortedIndices[ rank ] = i;
+			_ranks[ i ] = rank;
+		}
+	}
+}
+
+/******************************************************************************
+ * Sort again the particles of a range of cells
+ *
+ * @param pFirstCell first cell
+ * @param pLastCell last cell
+ ******************************************************************************/
+void GvParticleSpatialIndex::sortCells( unsigned int pFirstCell, unsigned int pLastCell )
+{
+	const unsigned int firstParticle = _cellStarts[ pFirstCell ];
+	const unsigned int endParticle = _cellStarts[ pLastCell + 1 ];
+
+	// Particles of the cells (the ones that have moved stay in the range), in the order of their index
+	std::vector< unsigned int > indices( _sortedIndices.begin() + firstParticle, _sortedIndices.begin() + endParticle );
+	std::sort( indices.begin(), indices.end() );
+
+	// Count the particles of each cell, and compute the cell starts
+	const unsigned int nbCells = pLastCell - pFirstCell + 1;
+	std::vector< unsigned int > cellStarts( nbCells + 1, 0 );
+	for ( size_t i = 0; i < indices.size(); i++ )
+	{
+		cellStarts[ _cellCodes[ indices[ i ] ] - pFirstCell + 1 ]++;
+	}
+	cellStarts[ 0 ] = firstParticle;
+	for ( unsigned int i = 1; i <= nbCells; i++ )
+	{
+		cellStarts[ i ] += cellStarts[ i - 1 ];
+	}
+	std::copy( cellStarts.begin() + 1, cellStarts.end() - 1, _cellStarts.begin() + pFirstCell + 1 );
+
+	// Scatter the particles
+	for ( size_t i = 0; i < indices.size(); i++ )
+	{
+		const unsigned int index = indices[ i ];
+		const unsigned int rank = cellStarts[ _cellCodes[ index ] - pFirstCell ]++;
+		_sortedParticles[ rank ] = _particles[ index ];
+		_sortedIndices[ rank ] = index;
+		_ranks[ index ] = rank;
+	}
+}
+
+/******************************************************************************
+ * Upload a range of sorted particles and a range of cell starts in device memory
+ *
+ * @param pFirstParticle first particle
+ * @param pEndParticle end of the particles
+ * @param pFirstCell first cell start
+ * @param pEndCell end of the cell starts
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvParticleSpatialIndex::updateDeviceMemory( unsigned int pFirstParticle, unsigned int pEndParticle, unsigned int pFirstCell, unsigned int pEndCell )
+{
+	if ( pEndParticle > pFirstParticle )
+	{
+		GV_CUDA_SAFE_CALL( cudaMemcpy( _kernelObject._particles + pFirstParticle, &_sortedParticles[ pFirstParticle ],
+										( pEndParticle - pFirstParticle ) * sizeof( float4 ), cudaMemcpyHostToDevice ) );
+
+		_nbUploadedParticles += pEndParticle - pFirstParticle;
+	}
+	if ( pEndCell > pFirstCell )
+	{
+		GV_CUDA_SAFE_CALL( cudaMemcpy( _kernelObject._cellStarts + pFirstCell, &_cellStarts[ pFirstCell ],
+										( pEndCell - pFirstCell ) * sizeof( unsigned int ), cudaMemcpyHostToDevice ) );
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Run tasks, one thread per task
+ *
+ * @param pTasks the tasks
+ ******************************************************************************/
+void GvParticleSpatialIndex::runTasks( std::vector< Task >& pTasks )
+{
+#ifndef WIN32
+	std::vector< pthread_t > threads( pTasks.size() );
+	std::vector< bool > isThreadCreated( pTasks.size(), false );
+	for ( size_t i = 1; i < pTasks.size(); i++ )
+	{
+		isThreadCreated[ i ] = ( pthread_create( &threads[ i ], NULL, runTask, &pTasks[ i ] ) == 0 );
+		if ( ! isThreadCreated[ i ] )
+		{
+			runTask( &pTasks[ i ] );
+		}
+	}
+
+	// The first task is run by the calling thread
+	if ( ! pTasks.empty() )
+	{
+		runTask( &pTasks[ 0 ] );
+	}
+
+	for ( size_t i = 1; i < pTasks.size(); i++ )
+	{
+		if ( isThreadCreated[ i ] )
+		{
+			pthread_join( threads[ i ], NULL );
+		}
+	}
+#else
+	for ( size_t i = 0; i < pTasks.size(); i++ )
+	{
+		runTask( &pTasks[ i ] );
+	}
+#endif
+}
+
+/******************************************************************************
+ * Thread entry point of a task
+ *
+ * @param pTask the task
+ *
+ * @return NULL
+ ******************************************************************************/
+void* GvParticleSpatialIndex::runTask( void* pTask )
+{
+	Task* task = static_cast< Task* >( pTask );
+	task->_index->sortParticles( *task );
+
+	return NULL;
+}
@@ -0,0 +1,428 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_PARTICLE_SPATIAL_INDEX_H_
+#define _GV_PARTICLE_SPATIAL_INDEX_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+#include "GvUtils/GvParticleSpatialIndexKernel.h"
+
+// Cuda
+#include <vector_types.h>
+
+// STL
+#include <vector>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvUtils
+{
+
+/**
+ * @class GvParticleSpatialIndex
+ *
+ * @brief The GvParticleSpatialIndex class provides a spatial index of particles,
+ * built on host and used on device by particle-based producers (see GvParticleSpatialIndexKernel).
+ *
+ * Particles are sorted by the Morton code of their cell with a counting sort :
+ * threads count the particles of their part of the particles in each cell,
+ * then scatter them at the cell starts. Sorted particles and cell starts are uploaded once.
+ *
+ * When particles move, only the cells between the lowest and the highest cell
+ * that particles have left or entered are sorted again, and only the modified particles
+ * and cell starts are uploaded. The order of the particles is the same as if the index
+ * had been built again (particles of a cell are in the order of their index).
+ */
+class GIGASPACE_EXPORT GvParticleSpatialIndex
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Max depth of the grid
+	 */
+	enum
+	{
+		maxDepth = 8
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pDepth depth of the grid (i.e. 2^depth cells along each axis)
+	 */
+	GvParticleSpatialIndex( unsigned int pDepth = 5 );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvParticleSpatialIndex();
+
+	/**
+	 * Get the depth of the grid
+	 *
+	 * @return the depth of the grid
+	 */
+	unsigned int getDepth() const;
+
+	/**
+	 * Get the number of particles
+	 *
+	 * @return the number of particles
+	 */
+	unsigned int getNbParticles() const;
+
+	/**
+	 * Get the max radius of the particles
+	 *
+	 * @return the max radius of the particles
+	 */
+	float getMaxRadius() const;
+
+	/**
+	 * Set the number of threads used to sort the particles
+	 *
+	 * @param pValue the number of threads
+	 */
+	void setNbThreads( unsigned int pValue );
+
+	/**
+	 * Get the particles, sorted by the Morton code of their cell
+	 *
+	 * @return the sorted particles
+	 */
+	const std::vector< float4 >& getSortedParticles() const;
+
+	/**
+	 * Get the index of the first particle of each cell, followed by the number of particles
+	 *
+	 * @return the cell starts
+	 */
+	const std::vector< unsigned int >& getCellStarts() const;
+
+	/**
+	 * Get the associated device-side object
+	 *
+	 * @return the associated device-side object
+	 */
+	const GvParticleSpatialIndexKernel& getKernelObject() const;
+
+	/**
+	 * Build the index of particles, and update device memory
+	 *
+	 * @param pParticles the particles (position in the unit cube and radius)
+	 * @param pNbParticles the number of particles
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool build( const float4* pParticles, unsigned int pNbParticles );
+
+	/**
+	 * Update the index after particles have moved, and update device memory.
+	 *
+	 * Particles are compared to the ones the index has been built from :
+	 * only the cells of the moved particles are sorted again.
+	 * The index is built again when the number of particles has changed.
+	 *
+	 * @param pParticles the particles (position in the unit cube and radius)
+	 * @param pNbParticles the number of particles
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool update( const float4* pParticles, unsigned int pNbParticles );
+
+	/**
+	 * Get the number of particles uploaded by the last update
+	 *
+	 * @return the number of uploaded particles
+	 */
+	unsigned int getNbUploadedParticles() const;
+
+	/**
+	 * Get the range of the cells whose particles have changed during the last build or update
+	 * (all cells after a build). Data produced from particles of other cells is still valid.
+	 *
+	 * @param pFirstCell the Morton code of the first changed cell
+	 * @param pLastCell the Morton code of the last changed cell
+	 *
+	 * @return a flag telling wheter or not particles have changed
+	 */
+	bool getChangedCells( unsigned int& pFirstCell, unsigned int& pLastCell ) const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Particles sorted by a thread
+	 */
+	struct Task
+	{
+		/**
+		 * The spatial index
+		 */
+		GvParticleSpatialIndex* _index;
+
+		/**
+		 * First particle and end of the particles of the task
+		 */
+		unsigned int _first;
+		unsigned int _end;
+
+		/**
+		 * Histogram of the task (number of particles per cell, then index of the next particle of each cell)
+		 */
+		unsigned int* _histogram;
+
+		/**
+		 * Flag telling wheter the task counts or scatters its particles
+		 */
+		bool _isScattering;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Depth of the grid
+	 */
+	unsigned int _depth;
+
+	/**
+	 * Number of threads used to sort the particles
+	 */
+	unsigned int _nbThreads;
+
+	/**
+	 * Particles the index has been built from (in their order)
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< float4 > _particles;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Cell of each particle
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< unsigned int > _cellCodes;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Sorted particles, and index of each sorted particle
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< float4 > _sortedParticles;
+	std::vector< unsigned int > _sortedIndices;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Position of each particle in the sorted particles
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< unsigned int > _ranks;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Index of the first particle of each cell, followed by the number of particles
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< unsigned int > _cellStarts;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Histograms of the tasks
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< unsigned int > _histograms;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Max radius of the particles
+	 */
+	float _maxRadius;
+
+	/**
+	 * Number of particles the device memory has been allocated for
+	 */
+	unsigned int _deviceCapacity;
+
+	/**
+	 * Number of particles uploaded by the last update
+	 */
+	unsigned int _nbUploadedParticles;
+
+	/**
+	 * Range ( first, end ) of the cells whose particles have changed during the last build or update
+	 */
+	unsigned int _firstChangedCell;
+	unsigned int _endChangedCell;
+
+	/**
+	 * Associated device-side object (sorted particles and cell starts in device memory)
+	 */
+	GvParticleSpatialIndexKernel _kernelObject;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Get the cell of a particle
+	 *
+	 * @param pParticle the particle
+	 *
+	 * @return the Morton code of the cell
+	 */
+	unsigned int getCellCode( const float4& pParticle ) const;
+
+	/**
+	 * Count or scatter the particles of a task
+	 *
+	 * @param pTask the task
+	 */
+	void sortParticles( const Task& pTask );
+
+	/**
+	 * Sort again the particles of a range of cells
+	 *
+	 * @param pFirstCell first cell
+	 * @param pLastCell last cell
+	 */
+	void sortCells( unsigned int pFirstCell, unsigned int pLastCell );
+
+	/**
+	 * Upload a range of sorted particles and a range of cell starts in device memory
+	 *
+	 * @param pFirstParticle first particle
+	 * @param pEndParticle end of the particles
+	 * @param pFirstCell first cell start
+	 * @param pEndCell end of the cell starts
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool updateDeviceMemory( unsigned int pFirstParticle, unsigned int pEndParticle, unsigned int pFirstCell, unsigned int pEndCell );
+
+	/**
+	 * Run tasks, one thread per task
+	 *
+	 * @param pTasks the tasks
+	 */
+	static void runTasks( std::vector< Task >& pTasks );
+
+	/**
+	 * Thread entry point of a task
+	 *
+	 * @param pTask the task
+	 *
+	 * @return NULL
+	 */
+	static void* runTask( void* pTask );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvParticleSpatialIndex( const GvParticleSpatialIndex& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvParticleSpatialIndex& operator=( const GvParticleSpatialIndex& );
+
+};
+
+} // namespace GvUtils
+
+#endif
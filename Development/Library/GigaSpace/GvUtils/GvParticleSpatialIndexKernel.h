@@ -0,0 +1,183 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_PARTICLE_SPATIAL_INDEX_KERNEL_H_
+#define _GV_PARTICLE_SPATIAL_INDEX_KERNEL_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+#include "GvCore/GvMortonCode.h"
+
+// Cuda
+#include <vector_types.h>
+#include <vector_functions.h>
+#include <host_defines.h>
+
+// System
+#include <cmath>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvUtils
+{
+
+/**
+ * @struct GvParticleSpatialIndexKernel
+ *
+ * @brief The GvParticleSpatialIndexKernel struct provides the device-side interface
+ * of a particle spatial index (see GvParticleSpatialIndex).
+ *
+ * Particles (position and radius) lie in the unit cube, which is divided in a regular grid
+ * of 2^depth cells along each axis. Particles are sorted by the Morton code of their cell,
+ * so that the particles of a cell, and of any node of the octree of the grid above it,
+ * are contiguous. The first particle of each cell of the grid is stored : the particles
+ * of a node of a given level are given by the cell starts of its first descendant cell
+ * and of its next sibling.
+ *
+ * Producers retrieve the ranges of the particles that may intersect a region of space
+ * (see getCandidateRanges()), instead of testing all particles.
+ */
+struct GvParticleSpatialIndexKernel
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Particles (position and radius), sorted by the Morton code of their cell
+	 */
+	float4* _particles;
+
+	/**
+	 * Index of the first particle of each cell (in Morton order), followed by the number of particles
+	 */
+	uint* _cellStarts;
+
+	/**
+	 * Number of particles
+	 */
+	uint _nbParticles;
+
+	/**
+	 * Depth of the grid (i.e. 2^depth cells along each axis)
+	 */
+	uint _depth;
+
+	/**
+	 * Max radius of the particles
+	 */
+	float _maxRadius;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Get the Morton code of a cell
+	 *
+	 * @param pCell the cell coordinates
+	 *
+	 * @return the Morton code of the cell
+	 */
+	__host__ __device__
+	static inline uint getCellCode( const uint3& pCell );
+
+	/**
+	 * Get the range of the particles of a node of the octree of the grid
+	 *
+	 * @param pNode the node coordinates at its level
+	 * @param pLevel the node level (must not be greater than the depth of the grid)
+	 * @param pFirst the index of the first particle of the node
+	 *
+	 * @return the number of particles of the node
+	 */
+	__device__
+	inline uint getNodeRange( const uint3& pNode, uint pLevel, uint& pFirst ) const;
+
+	/**
+	 * Get the ranges of the particles whose cell overlaps a box.
+	 *
+	 * The box is covered by at most 2 nodes along each axis, at the deepest level
+	 * where nodes are not smaller than the box. The box has to be enlarged by the max radius
+	 * of the particles to retrieve all the particles that may intersect it.
+	 *
+	 * @param pBoxMin min corner of the box
+	 * @param pBoxMax max corner of the box
+	 * @param pRanges the ranges ( index of the first particle, number of particles ) of the particles
+	 *
+	 * @return the number of ranges
+	 */
+	__device__
+	inline uint getCandidateRanges( float3 pBoxMin, float3 pBoxMax, uint2 pRanges[ 8 ] ) const;
+
+	/**
+	 * Get the range of the Morton codes of the cells overlapping a box (clipped by the unit cube).
+	 *
+	 * The Morton code grows along each axis : the cells of the box lie between the cell
+	 * of its min corner and the cell of its max corner. Data produced from the particles of a box
+	 * only has to be produced again when particles of this range have changed
+	 * (see GvParticleSpatialIndex::getChangedCells()).
+	 *
+	 * @param pBoxMin min corner of the box
+	 * @param pBoxMax max corner of the box
+	 *
+	 * @return the Morton codes of the first and the last cell
+	 */
+	__host__ __device__
+	inline uint2 getCellRange( const float3& pBoxMin, const float3& pBoxMax ) const;
+
+};
+
+} // namespace GvUtils
+
+/**************************************************************************
+ ***************************** INLINE SECTION *****************************
+ **************************************************************************/
+
+#include "GvParticleSpatialIndexKernel.inl"
+
+#endif
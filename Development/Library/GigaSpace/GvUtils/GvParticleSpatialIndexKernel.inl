@@ -0,0 +1,174 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** INLINE DEFINITION *****************************
+ ******************************************************************************/
+
+namespace GvUtils
+{
+
+/******************************************************************************
+ * Get the Morton code of a cell
+ *
+ * @param pCell the cell coordinates
+ *
+ * @return the Morton code of the cell
+ ******************************************************************************/
+__host__ __device__
+inline uint GvParticleSpatialIndexKernel::getCellCode( const uint3& pCell )
+{
+	return static_cast< uint >( GvCore::GvMortonCode::spreadBits( pCell.x )
+								| ( GvCore::GvMortonCode::spreadBits( pCell.y ) << 1 )
+								| ( GvCore::GvMortonCode::spreadBits( pCell.z ) << 2 ) );
+}
+
+/******************************************************************************
+ * Get the range of the particles of a node of the octree of the grid
+ *
+ * @param pNode the node coordinates at its level
+ * @param pLevel the node level (must not be greater than the depth of the grid)
+ * @param pFirst the index of the first particle of the node
+ *
+ * @return the number of particles of the node
+ ******************************************************************************/
+__device__
+inline uint GvParticleSpatialIndexKernel::getNodeRange( const uint3& pNode, uint pLevel, uint& pFirst ) const
+{
+	// Cells of a node are contiguous in Morton order
+	const uint shift = 3 * ( _depth - pLevel );
+	const uint firstCell = getCellCode( pNode ) << shift;
+	const uint endCell = firstCell + ( 1U << shift );
+
+	pFirst = _cellStarts[ firstCell ];
+
+	return _cellStarts[ endCell ] - pFirst;
+}
+
+/******************************************************************************
+ * Get the ranges of the particles whose cell overlaps a box.
+ *
+ * The box is covered by at most 2 nodes along each axis, at the deepest level
+ * where nodes are not smaller than the box. The box has to be enlarged by the max radius
+ * of the particles to retrieve all the particles that may intersect it.
+ *
+ * @param pBoxMin min corner of the box
+ * @param pBoxMax max corner of the box
+ * @param pRanges the ranges ( index of the first particle, number of particles ) of the particles
+ *
+ * @return the number of ranges
+ ******************************************************************************/
+__device__
+inline uint GvParticleSpatialIndexKernel::getCandidateRanges( float3 pBoxMin, float3 pBoxMax, uint2 pRanges[ 8 ] ) const
+{
+	// Clip the box by the unit cube
+	pBoxMin = make_float3( fmaxf( pBoxMin.x, 0.f ), fmaxf( pBoxMin.y, 0.f ), fmaxf( pBoxMin.z, 0.f ) );
+	pBoxMax = make_float3( fminf( pBoxMax.x, 1.f ), fminf( pBoxMax.y, 1.f ), fminf( pBoxMax.z, 1.f ) );
+	if ( _nbParticles == 0 || pBoxMin.x > pBoxMax.x || pBoxMin.y > pBoxMax.y || pBoxMin.z > pBoxMax.z )
+	{
+		return 0;
+	}
+
+	// Deepest level where nodes are not smaller than the box
+	const float extent = fmaxf( pBoxMax.x - pBoxMin.x, fmaxf( pBoxMax.y - pBoxMin.y, pBoxMax.z - pBoxMin.z ) );
+	uint level = _depth;
+	while ( level > 0 && extent * static_cast< float >( 1U << level ) > 1.f )
+	{
+		level--;
+	}
+
+	// Nodes covering the box
+	const float resolution = static_cast< float >( 1U << level );
+	const float maxNode = resolution - 1.f;
+	const uint3 firstNode = make_uint3( static_cast< uint >( fminf( pBoxMin.x * resolution, maxNode ) ),
+										static_cast< uint >( fminf( pBoxMin.y * resolution, maxNode ) ),
+										static_cast< uint >( fminf( pBoxMin.z * resolution, maxNode ) ) );
+	const uint3 lastNode = make_uint3( static_cast< uint >( fminf( pBoxMax.x * resolution, maxNode ) ),
+										static_cast< uint >( fminf( pBoxMax.y * resolution, maxNode ) ),
+										static_cast< uint >( fminf( pBoxMax.z * resolution, maxNode ) ) );
+
+	// Retrieve the ranges of the nodes, and merge contiguous ones
+	uint nbRanges = 0;
+	for ( uint z = firstNode.z; z <= lastNode.z; z++ )
+	{
+		for ( uint y = firstNode.y; y <= lastNode.y; y++ )
+		{
+			for ( uint x = firstNode.x; x <= lastNode.x; x++ )
+			{
+				uint first;
+				const uint count = getNodeRange( make_uint3( x, y, z ), level, first );
+				if ( count > 0 )
+				{
+					if ( nbRanges > 0 && pRanges[ nbRanges - 1 ].x + pRanges[ nbRanges - 1 ].y == first )
+					{
+						pRanges[ nbRanges - 1 ].y += count;
+					}
+					else
+					{
+						pRanges[ nbRanges ] = make_uint2( first, count );
+						nbRanges++;
+					}
+				}
+			}
+		}
+	}
+
+	return nbRanges;
+}
+
+/******************************************************************************
+ * Get the range of the Morton codes of the cells overlapping a box (clipped by the unit cube).
+ *
+ * The Morton code grows along each axis : the cells of the box lie between the cell
+ * of its min corner and the cell of its max corner. Data produced from the particles of a box
+ * only has to be produced again when particles of this range have changed
+ * (see GvParticleSpatialIndex::getChangedCells()).
+ *
+ * @param pBoxMin min corner of the box
+ * @param pBoxMax max corner of the box
+ *
+ * @return the Morton codes of the first and the last cell
+ ******************************************************************************/
+__host__ __device__
+inline uint2 GvParticleSpatialIndexKernel::getCellRange( const float3& pBoxMin, const float3& pBoxMax ) const
+{
+	const float resolution = static_cast< float >( 1U << _depth );
+	const float maxCell = resolution - 1.f;
+	const uint3 firstCell = make_uint3( static_cast< uint >( fminf( fmaxf( pBoxMin.x * resolution, 0.f ), maxCell ) ),
+										static_cast< uint >( fminf( fmaxf( pBoxMin.y * resolution, 0.f ), maxCell ) ),
+										static_cast< uint >( fminf( fmaxf( pBoxMin.z * resolution, 0.f ), maxCell ) ) );
+	const uint3 lastCell = make_uint3( static_cast< uint >( fminf( fmaxf( pBoxMax.x * resolution, 0.f ), maxCell ) ),
+										static_cast< uint >( fminf( fmaxf( pBoxMax.y * resolution, 0.f ), maxCell ) ),
+										static_cast< uint >( fminf( fmaxf( pBoxMax.z * resolution, 0.f ), maxCell ) ) );
+
+	return make_uint2( getCellCode( firstCell ), getCellCode( lastCell ) );
+}
+
+} // namespace GvUtils
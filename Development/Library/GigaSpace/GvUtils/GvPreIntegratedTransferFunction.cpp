@@ -0,0 +1,480 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvUtils/GvPreIntegratedTransferFunction.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvError.h"
+
+// Cuda
+#include <cuda_runtime.h>
+
+// STL
+#include <iostream>
+#include <algorithm>
+
+// System
+#include <cmath>
+#ifndef WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+// SIMD
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define GV_PRE_INTEGRATED_TRANSFER_FUNCTION_USE_SSE2
+	#include <emmintrin.h>
+#endif
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvUtils;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Max opacity of transfer function entries (fully opaque entries would have an infinite extinction)
+ */
+static const float cMaxOpacity = 0.99999f;
+
+/**
+ * Min number of table entries computed by a thread
+ */
+static const unsigned int cMinNbEntriesPerThread = 16384;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+namespace
+{
+
+/******************************************************************************
+ * Integrate a ray segment.
+ *
+ * The SIMD path does exactly the same floating point operations as the scalar path,
+ * so that both give the same results.
+ *
+ * @param pFront prefix sums at the first transfer function entry of the segment
+ * @param pBack prefix sums after the last transfer function entry of the segment
+ * @param pExtinctionScale length of the segment divided by its number of transfer function entries
+ * @param pEntry the table entry
+ ******************************************************************************/
+inline void integrateSegment( const double* pFront, const double* pBack, float pExtinctionScale, float4& pEntry )
+{
+	// Integral of the extinction over the segment, and resulting opacity
+	const float extinction = static_cast< float >( pBack[ 3 ] - pFront[ 3 ] );
+	const float alpha = 1.f - expf( -extinction * pExtinctionScale );
+
+	// Color is the extinction weighted mean of the colors, premultiplied by opacity
+	const float scale = ( extinction > 0.f ) ? alpha / extinction : 0.f;
+
+#if defined( GV_PRE_INTEGRATED_TRANSFER_FUNCTION_USE_SSE2 )
+	const __m128d integralRG = _mm_sub_pd( _mm_loadu_pd( pBack ), _mm_loadu_pd( pFront ) );
+	const __m128d integralBA = _mm_sub_pd( _mm_loadu_pd( pBack + 2 ), _mm_loadu_pd( pFront + 2 ) );
+	const __m128 integral = _mm_movelh_ps( _mm_cvtpd_ps( integralRG ), _mm_cvtpd_ps( integralBA ) );
+	_mm_storeu_ps( &pEntry.x, _mm_mul_ps( integral, _mm_set1_ps( scale ) ) );
+#else
+	pEntry.x = static_cast< float >( pBack[ 0 ] - pFront[ 0 ] ) * scale;
+	pEntry.y = static_cast< float >( pBack[ 1 ] - pFront[ 1 ] ) * scale;
+	pEntry.z = static_cast< float >( pBack[ 2 ] - pFront[ 2 ] ) * scale;
+#endif
+	pEntry.w = alpha;
+}
+
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvPreIntegratedTransferFunction::GvPreIntegratedTransferFunction()
+:	_filename()
+,	_data( NULL )
+,	_resolution( 0 )
+,	_dataArray( NULL )
+,	_transferFunction()
+,	_integrals()
+,	_segmentLength( 1.f )
+,	_nbThreads( 1 )
+{
+#ifndef WIN32
+	const long nbProcessors = sysconf( _SC_NPROCESSORS_ONLN );
+	_nbThreads = ( nbProcessors > 0 ) ? static_cast< unsigned int >( nbProcessors ) : 1;
+#endif
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvPreIntegratedTransferFunction::~GvPreIntegratedTransferFunction()
+{
+	// Free host memory
+	delete [] _data;
+
+	// Free device memory
+	GV_CUDA_SAFE_CALL( cudaFreeArray( _dataArray ) );
+}
+
+/******************************************************************************
+ * Get the filename
+ *
+ * @return the filename
+ ******************************************************************************/
+const std::string& GvPreIntegratedTransferFunction::getFilename() const
+{
+	return _filename;
+}
+
+/******************************************************************************
+ * Set the filename
+ *
+ * @param pName the filename
+ ******************************************************************************/
+void GvPreIntegratedTransferFunction::setFilename( const std::string& pName )
+{
+	_filename = pName;
+}
+
+/******************************************************************************
+ * Get the resolution
+ *
+ * @return the resolution
+ ******************************************************************************/
+unsigned int GvPreIntegratedTransferFunction::getResolution() const
+{
+	return _resolution;
+}
+
+/******************************************************************************
+ * Create the transfer function
+ *
+ * @param pResolution the dimension of the transfer function
+ ******************************************************************************/
+bool GvPreIntegratedTransferFunction::create( unsigned int pResolution )
+{
+	bool result = false;
+
+	_resolution = pResolution;
+
+	// Allocate data in host memory.
+	// The table of a fully transparent transfer function is made of zeros.
+	const float4 zero = { 0.f, 0.f, 0.f, 0.f };
+	delete [] _data;
+	_data = new float4[ _resolution * _resolution ];
+	std::fill( _data, _data + _resolution * _resolution, zero );
+	_transferFunction.assign( _resolution, zero );
+	_integrals.assign( 4 * ( _resolution + 1 ), 0.0 );
+
+	// Allocate CUDA array in device memory
+	if ( _dataArray != NULL )
+	{
+		GV_CUDA_SAFE_CALL( cudaFreeArray( _dataArray ) );
+		_dataArray = NULL;
+	}
+	_channelFormatDesc = cudaCreateChannelDesc< float4 >();
+	GV_CUDA_SAFE_CALL( cudaMallocArray( &_dataArray, &_channelFormatDesc, _resolution, _resolution ) );
+
+	result = true;
+
+	return result;
+}
+
+/******************************************************************************
+ * Update device memory
+ ******************************************************************************/
+void GvPreIntegratedTransferFunction::updateDeviceMemory()
+{
+	// Copy to device memory some data located at address _data in host memory
+	cudaMemcpyToArray( _dataArray, 0, 0, _data, _resolution * _resolution * sizeof( float4 ), cudaMemcpyHostToDevice );
+}
+
+/******************************************************************************
+ * Bind the internal data to a specified texture
+ * that can be used to fetch data on device.
+ *
+ * @param pTexRefName name of the texture reference to bind
+ * @param pNormalizedAccess indicates whether texture reads are normalized or not
+ * @param pFilterMode type of texture filter mode
+ * @param pAddressMode type of texture access mode
+ ******************************************************************************/
+void GvPreIntegratedTransferFunction::bindToTextureReference( const void* pSymbol, const char* pTexRefName, bool pNormalizedAccess, cudaTextureFilterMode pFilterMode, cudaTextureAddressMode pAddressMode )
+{
+	std::cout << "bindToTextureReference : " << pTexRefName << std::endl;
+
+	textureReference* texRefPtr;
+	GV_CUDA_SAFE_CALL( cudaGetTextureReference( (const textureReference **)&texRefPtr, pSymbol ) );
+
+	texRefPtr->normalized = pNormalizedAccess; // Access with normalized texture coordinates
+	texRefPtr->filterMode = pFilterMode;
+	texRefPtr->addressMode[ 0 ] = pAddressMode; // Wrap texture coordinates
+	texRefPtr->addressMode[ 1 ] = pAddressMode;
+	texRefPtr->addressMode[ 2 ] = pAddressMode;
+
+	// Bind array to 2D texture
+	GV_CUDA_SAFE_CALL( cudaBindTextureToArray( (const textureReference *)texRefPtr, _dataArray, &_channelFormatDesc ) );
+}
+
+/******************************************************************************
+ * Set the number of threads used to compute the table
+ *
+ * @param pValue the number of threads
+ ******************************************************************************/
+void GvPreIntegratedTransferFunction::setNbThreads( unsigned int pValue )
+{
+	_nbThreads = std::max( pValue, 1U );
+}
+
+/******************************************************************************
+ * Get the length of the ray segments
+ *
+ * @return the length of the ray segments
+ ******************************************************************************/
+float GvPreIntegratedTransferFunction::getSegmentLength() const
+{
+	return _segmentLength;
+}
+
+/******************************************************************************
+ * Compute the whole pre-integrated table from a transfer function, and update device memory.
+ *
+ * The opacities of the transfer function are given for a ray segment of unit length.
+ *
+ * @param pTransferFunction the transfer function (its resolution is the one of the table)
+ * @param pSegmentLength the length of the ray segments (i.e. the sampling step of the renderer)
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvPreIntegratedTransferFunction::build( const float4* pTransferFunction, float pSegmentLength )
+{
+	if ( _data == NULL || _resolution == 0 )
+	{
+		std::cerr << "GvPreIntegratedTransferFunction::build : the table has not been created" << std::endl;
+		return false;
+	}
+	if ( ! ( pSegmentLength > 0.f ) )
+	{
+		std::cerr << "GvPreIntegratedTransferFunction::build : invalid segment length " << pSegmentLength << std::endl;
+		return false;
+	}
+
+	_transferFunction.assign( pTransferFunction, pTransferFunction + _resolution );
+	_segmentLength = pSegmentLength;
+
+	computeIntegrals( 0 );
+	computeTable( 0, _resolution - 1 );
+
+	updateDeviceMemory();
+
+	return true;
+}
+
+/******************************************************************************
+ * Compute the pre-integrated table again after an edition of the transfer function, and update device memory.
+ *
+ * Only the entries whose scalar range overlaps the modified transfer function entries are computed.
+ *
+ * @param pTransferFunction the edited transfer function (its resolution is the one of the table)
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvPreIntegratedTransferFunction::update( const float4* pTransferFunction )
+{
+	if ( _data == NULL || _resolution == 0 )
+	{
+		std::cerr << "GvPreIntegratedTransferFunction::update : the table has not been created" << std::endl;
+		return false;
+	}
+
+	// Retrieve the range of modified entries
+	unsigned int first = _resolution;
+	unsigned int last = 0;
+	for ( unsigned int i = 0; i < _resolution; i++ )
+	{
+		const float4& previous = _transferFunction[ i ];
+		const float4& current = pTransferFunction[ i ];
+		if ( previous.x != current.x || previous.y != current.y || previous.z != current.z || previous.w != current.w )
+		{
+			first = std::min( first, i );
+			last = i;
+		}
+	}
+	if ( first == _resolution )
+	{
+		return true;
+	}
+
+	std::copy( pTransferFunction + first, pTransferFunction + last + 1, _transferFunction.begin() + first );
+
+	computeIntegrals( first );
+	computeTable( first, last );
+
+	updateDeviceMemory();
+
+	return true;
+}
+
+/******************************************************************************
+ * Compute the prefix sums of the transfer function
+ *
+ * @param pFirst first transfer function entry whose prefix sums are not up to date
+ ******************************************************************************/
+void GvPreIntegratedTransferFunction::computeIntegrals( unsigned int pFirst )
+{
+	// Sums are done in double precision : entries of the table are differences of sums
+	for ( unsigned int i = pFirst; i < _resolution; i++ )
+	{
+		const float4& value = _transferFunction[ i ];
+		const float opacity = std::min( std::max( value.w, 0.f ), cMaxOpacity );
+		const double extinction = -log( 1.0 - static_cast< double >( opacity ) );
+
+		const double* integral = &_integrals[ 4 * i ];
+		double* nextIntegral = &_integrals[ 4 * ( i + 1 ) ];
+		nextIntegral[ 0 ] = integral[ 0 ] + extinction * value.x;
+		nextIntegral[ 1 ] = integral[ 1 ] + extinction * value.y;
+		nextIntegral[ 2 ] = integral[ 2 ] + extinction * value.z;
+		nextIntegral[ 3 ] = integral[ 3 ] + extinction;
+	}
+}
+
+/******************************************************************************
+ * Compute the entries of the table whose scalar range overlaps [ pFirst ; pLast ]
+ *
+ * @param pFirst first modified transfer function entry
+ * @param pLast last modified transfer function entry
+ ******************************************************************************/
+void GvPreIntegratedTransferFunction::computeTable( unsigned int pFirst, unsigned int pLast )
+{
+	// The table is symmetric : entries ( i, j ) with i <= pLast and j >= max( i, pFirst ) are computed,
+	// and mirrored. Rows are interleaved between threads to balance their work.
+	const unsigned int nbRows = pLast + 1;
+	const size_t nbEntries = static_cast< size_t >( nbRows ) * ( _resolution - pFirst );
+	const unsigned int nbTasks = static_cast< unsigned int >( std::max( std::min( std::min( static_cast< size_t >( _nbThreads ), nbEntries / cMinNbEntriesPerThread ), static_cast< size_t >( nbRows ) ), static_cast< size_t >( 1 ) ) );
+
+	std::vector< Task > tasks( nbTasks );
+	for ( unsigned int i = 0; i < nbTasks; i++ )
+	{
+		tasks[ i ]._transferFunction = this;
+		tasks[ i ]._firstRow = i;
+		tasks[ i ]._rowStep = nbTasks;
+		tasks[ i ]._lastRow = pLast;
+		tasks[ i ]._firstColumn = pFirst;
+	}
+	runTasks( tasks );
+}
+
+/******************************************************************************
+ * Compute some rows of the table (and the mirrored columns)
+ *
+ * @param pTask the rows to compute
+ ******************************************************************************/
+void GvPreIntegratedTransferFunction::computeRows( const Task& pTask )
+{
+	for ( unsigned int i = pTask._firstRow; i <= pTask._lastRow; i += pTask._rowStep )
+	{
+		const double* front = &_integrals[ 4 * i ];
+		float4* row = _data + static_cast< size_t >( i ) * _resolution;
+
+		for ( unsigned int j = std::max( i, pTask._firstColumn ); j < _resolution; j++ )
+		{
+			// Segment from entry i to entry j (both included)
+			const float extinctionScale = _segmentLength / static_cast< float >( j - i + 1 );
+			integrateSegment( front, &_integrals[ 4 * ( j + 1 ) ], extinctionScale, row[ j ] );
+
+			_data[ static_cast< size_t >( j ) * _resolution + i ] = row[ j ];
+		}
+	}
+}
+
+/******************************************************************************
+ * Run tasks, one thread per task
+ *
+ * @param pTasks the tasks
+ ******************************************************************************/
+void GvPreIntegratedTransferFunction::runTasks( std::vector< Task >& pTasks )
+{
+#ifndef WIN32
+	std::vector< pthread_t > threads( pTasks.size() );
+	std::vector< bool > isThreadCreated( pTasks.size(), false );
+	for ( size_t i = 1; i < pTasks.size(); i++ )
+	{
+		isThreadCreated[ i ] = ( pthread_create( &threads[ i ], NULL, runTask, &pTasks[ i ] ) == 0 );
+		if ( ! isThreadCreated[ i ] )
+		{
+			runTask( &pTasks[ i ] );
+		}
+	}
+
+	// The first task is run by the calling thread
+	if ( ! pTasks.empty() )
+	{
+		runTask( &pTasks[ 0 ] );
+	}
+
+	for ( size_t i = 1; i < pTasks.size(); i++ )
+	{
+		if ( isThreadCreated[ i ] )
+		{
+			pthread_join( threads[ i ], NULL );
+		}
+	}
+#else
+	for ( size_t i = 0; i < pTasks.size(); i++ )
+	{
+		runTask( &pTasks[ i ] );
+	}
+#endif
+}
+
+/******************************************************************************
+ * Thread entry point of a task
+ *
+ * @param pTask the task
+ *
+ * @return NULL
+ ******************************************************************************/
+void* GvPreIntegratedTransferFunction::runTask( void* pTask )
+{
+	Task* task = static_cast< Task* >( pTask );
+	task->_transferFunction->computeRows( *task );
+
+	return NULL;
+}
@@ -44,6 +44,7 @@
 
 // STL
 #include <string>
+#include <vector>
 
 /******************************************************************************
  ************************* DEFINE AND CONSTANT SECTION ************************
@@ -73,6 +74,14 @@ namespace GvUtils
  * Transfer function is a mathematical tool used tu map an input to an output.
  * In computer graphics, a volume renderer can use it to map a sampled density
  * value to an RGBA value.
+ *
+ * The pre-integrated table is a 2D table indexed by the scalar values at the front
+ * and at the back of a ray segment. Entry ( sf, sb ) stores the color (premultiplied
+ * by opacity) and the opacity of the segment, the transfer function being integrated
+ * between sf and sb. The table is computed from a 1D transfer function with prefix sums
+ * of the extinction and of the extinction weighted colors, so that each entry costs O(1)
+ * and the whole table O(n^2). When the transfer function is edited, only the entries
+ * whose scalar range overlaps the modified entries are computed again.
  */
 class GIGASPACE_EXPORT GvPreIntegratedTransferFunction
 {
@@ -162,18 +171,87 @@ public:
 	 */
 	void bindToTextureReference( const void* pSymbol, const char* pTexRefName, bool pNormalizedAccess, cudaTextureFilterMode pFilterMode, cudaTextureAddressMode pAddressMode );
 
+	/**
+	 * Set the number of threads used to compute the table
+	 *
+	 * @param pValue the number of threads
+	 */
+	void setNbThreads( unsigned int pValue );
+
+	/**
+	 * Get the length of the ray segments
+	 *
+	 * @return the length of the ray segments
+	 */
+	float getSegmentLength() const;
+
+	/**
+	 * Compute the whole pre-integrated table from a transfer function, and update device memory.
+	 *
+	 * The opacities of the transfer function are given for a ray segment of unit length.
+	 *
+	 * @param pTransferFunction the transfer function (its resolution is the one of the table)
+	 * @param pSegmentLength the length of the ray segments (i.e. the sampling step of the renderer)
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool build( const float4* pTransferFunction, float pSegmentLength = 1.f );
+
+	/**
+	 * Compute the pre-integrated table again after an edition of the transfer function, and update device memory.
+	 *
+	 * Only the entries whose scalar range overlaps the modified transfer function entries are computed.
+	 *
+	 * @param pTransferFunction the edited transfer function (its resolution is the one of the table)
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool update( const float4* pTransferFunction );
+
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
 	 **************************************************************************/
 
 protected:
 
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Rows of the table computed by a thread
+	 */
+	struct Task
+	{
+		/**
+		 * The pre-integrated transfer function
+		 */
+		GvPreIntegratedTransferFunction* _transferFunction;
+
+		/**
+		 * First row, number of rows between two rows of the task, and last row
+		 */
+		unsigned int _firstRow;
+		unsigned int _rowStep;
+		unsigned int _lastRow;
+
+		/**
+		 * First column to compute
+		 */
+		unsigned int _firstColumn;
+	};
+
 	/******************************* ATTRIBUTES *******************************/
 
 	/**
 	 * Transfer function file name
 	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
 	std::string _filename;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
 	
 	/**
 	 * Transfer function data
@@ -194,9 +272,82 @@ protected:
 	 * Channel format descriptor
 	 */
 	cudaChannelFormatDesc _channelFormatDesc;
+
+	/**
+	 * Transfer function the table has been computed from
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< float4 > _transferFunction;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Prefix sums of the transfer function : for each entry, sums of the extinction weighted
+	 * colors ( r, g, b ) and of the extinction of the previous entries
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< double > _integrals;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Length of the ray segments
+	 */
+	float _segmentLength;
+
+	/**
+	 * Number of threads used to compute the table
+	 */
+	unsigned int _nbThreads;
 	
 	/******************************** METHODS *********************************/
 
+	/**
+	 * Compute the prefix sums of the transfer function
+	 *
+	 * @param pFirst first transfer function entry whose prefix sums are not up to date
+	 */
+	void computeIntegrals( unsigned int pFirst );
+
+	/**
+	 * Compute the entries of the table whose scalar range overlaps [ pFirst ; pLast ]
+	 *
+	 * @param pFirst first modified transfer function entry
+	 * @param pLast last modified transfer function entry
+	 */
+	void computeTable( unsigned int pFirst, unsigned int pLast );
+
+	/**
+	 * Compute some rows of the table (and the mirrored columns)
+	 *
+	 * @param pTask the rows to compute
+	 */
+	void computeRows( const Task& pTask );
+
+	/**
+	 * Run tasks, one thread per task
+	 *
+	 * @param pTasks the tasks
+	 */
+	static void runTasks( std::vector< Task >& pTasks );
+
+	/**
+	 * Thread entry point of a task
+	 *
+	 * @param pTask the task
+	 *
+	 * @return NULL
+	 */
+	static void* runTask( void* pTask );
+
 	/**************************************************************************
 	 ***************************** PRIVATE SECTION ****************************
 	 **************************************************************************/
@@ -0,0 +1,348 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#ifndef _GV_SHARED_BRICK_LOADER_H_
+#define _GV_SHARED_BRICK_LOADER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+#include "GvCore/Array3D.h"
+#include "GvCore/vector_types_ext.h"
+#include "GvUtils/GvIDataLoader.h"
+#include "GvUtils/GvBrickServerClient.h"
+#include "GvVoxelizer/GvNodeSummary.h"
+
+// Loki
+#include <loki/Typelist.h>
+
+// STL
+#include <string>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+// GigaVoxels
+namespace GvCore
+{
+	template
+	<
+		template< typename > class THostArray, class TList
+	>
+	class GPUPoolHost;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvUtils
+{
+
+/**
+ * @class GvSharedBrickLoader
+ *
+ * @brief The GvSharedBrickLoader class provides a data loader reading
+ * nodes and bricks from a local brick server (Tools/GvBrickServer).
+ *
+ * It is a drop-in replacement of GvDataLoader : several viewers attached to
+ * the same server share one host cache of bricks instead of each reading
+ * and caching the dataset files.
+ *
+ * Nodes and summaries are read directly in the shared memory of the server.
+ * Bricks are acquired, copied from their shared memory slot to the brick pool, then released.
+ *
+ * A fallback loader (i.e. a GvDataLoader on the dataset files) can be given :
+ * it produces the bricks that can't be acquired from the server (all its slots are referenced,
+ * or the connection is lost), and all regions if the loader is not connected.
+ * Without fallback loader, these bricks are left unproduced and an error is reported.
+ *
+ * Note : a loader holds one connection, so it must be used by one thread at a time.
+ */
+template< typename TDataTypeList >
+class GvSharedBrickLoader : public GvIDataLoader< TDataTypeList >
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Typedef of inherited enum
+	 */
+	typedef typename GvIDataLoader< TDataTypeList >::VPRegionInfo VPRegionInfo;
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pSocketPath path of the Unix socket of the brick server
+	 */
+	GvSharedBrickLoader( const std::string& pSocketPath );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvSharedBrickLoader();
+
+	/**
+	 * Tell wheter or not the loader is connected to the brick server
+	 *
+	 * @return a flag telling wheter or not the loader is connected
+	 */
+	bool isConnected() const;
+
+	/**
+	 * Set the loader used when bricks can't be acquired from the brick server.
+	 * The loader takes ownership of it.
+	 *
+	 * @param pLoader the fallback loader (NULL to remove it)
+	 */
+	void setFallbackLoader( GvIDataLoader< TDataTypeList >* pLoader );
+
+	/**
+	 * Get the brick resolution of the dataset of the brick server
+	 *
+	 * @return the brick resolution (without borders, 0 if not connected)
+	 */
+	uint3 getBrickResolution() const;
+
+	/**
+	 * Get the brick border size of the dataset of the brick server
+	 *
+	 * @return the brick border size
+	 */
+	unsigned int getBorderSize() const;
+
+	/**
+	 * Helper function used to determine the type of regions in the data structure.
+	 * The data structure is made of regions containing data, empty or constant regions.
+	 *
+	 * Retrieve the node and associated brick located in this region of space,
+	 * and depending of its type, if it contains data, load it.
+	 *
+	 * @param pPosition position of a region of space
+	 * @param pSize size of a region of space
+	 * @param pBrickPool data cache pool. This is where all data reside for each channel (color, normal, etc...)
+	 * @param pOffsetInPool offset in the brick pool
+	 *
+	 * @return the type of the region (.i.e returns constantness information for that region)
+	 */
+	virtual VPRegionInfo getRegion( const float3& pPosition, const float3& pSize, GvCore::GPUPoolHost< GvCore::Array3D, TDataTypeList >* pBrickPool, size_t pOffsetInPool );
+
+	/**
+	 * Provides constantness information about a region.
+	 *
+	 * @param pPosition position of a region of space
+	 * @param pSize size of a region of space
+	 *
+	 * @return the type of the region (.i.e returns constantness information for that region)
+	 */
+	virtual VPRegionInfo getRegionInfo( const float3& pPosition, const float3& pSize );
+
+	/**
+	 * Retrieve the node located in a region of space,
+	 * and get its information (i.e. address containing its data type region).
+	 *
+	 * @param pPosition position of a region of space
+	 * @param pSize size of a region of space
+	 *
+	 * @return the node encoded information
+	 */
+	virtual uint getRegionInfoNew( const float3& pPosition, const float3& pSize );
+
+	/**
+	 * Retrieve the summary (min/max, occupancy, homogeneity) of the node
+	 * located in a region of space, for a given data channel.
+	 *
+	 * @param pPosition position of a region of space
+	 * @param pSize size of a region of space
+	 * @param pChannel data channel index
+	 * @param pSummary the resulting node summary
+	 *
+	 * @return a flag telling wheter or not a summary is available for that region
+	 */
+	virtual bool getRegionSummary( const float3& pPosition, const float3& pSize, unsigned int pChannel, GvVoxelizer::GvNodeSummary& pSummary );
+
+	/**
+	 * Provides the size of the smallest features the producer can generate.
+	 *
+	 * @return the size of the smallest features the producer can generate.
+	 */
+	virtual float3 getFeaturesSize() const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * @struct ChannelCopier
+	 *
+	 * @brief The ChannelCopier struct provides a functor copying each channel
+	 * of a brick from its shared memory slot to the brick pool.
+	 */
+	struct ChannelCopier
+	{
+		/**
+		 * Brick server client
+		 */
+		const GvBrickServerClient* _client;
+
+		/**
+		 * Slot index
+		 */
+		unsigned int _slot;
+
+		/**
+		 * Reference on a data pool and offset in the data pool
+		 */
+		GvCore::GPUPoolHost< GvCore::Array3D, TDataTypeList >* _dataPool;
+		size_t _offsetInPool;
+
+		/**
+		 * Copy a channel of the brick
+		 *
+		 * @param Loki::Int2Type< TChannelIndex > index of the channel (i.e. color, normal, etc...)
+		 */
+		template< int TChannelIndex >
+		inline void run( Loki::Int2Type< TChannelIndex > );
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Brick server client
+	 */
+	GvBrickServerClient _client;
+
+	/**
+	 * Brick resolution (without borders)
+	 */
+	uint3 _bricksRes;
+
+	/**
+	 * Brick border size
+	 */
+	unsigned int _borderSize;
+
+	/**
+	 * Number of levels of resolution
+	 */
+	int _numMipMapLevels;
+
+	/**
+	 * Loader used when bricks can't be acquired from the brick server (owned, may be NULL)
+	 */
+	GvIDataLoader< TDataTypeList >* _fallbackLoader;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Retrieve the level of resolution associated to a given size of a region of space.
+	 *
+	 * @param pSize size of a region of space
+	 *
+	 * @return the corresponding level (-1 if out of bounds)
+	 */
+	inline int getDataLevel( const float3& pSize ) const;
+
+	/**
+	 * Retrieve the indexed coordinates of a block (i.e. a node) in the blocks grid
+	 * associated to a given position of a region of space at a given level of resolution.
+	 *
+	 * @param pLevel level of resolution
+	 * @param pPosition position of a region of space
+	 *
+	 * @return the associated indexed coordinates
+	 */
+	inline uint3 getBlockCoords( int pLevel, const float3& pPosition ) const;
+
+	/**
+	 * Retrieve the node encoded address located in a region of space
+	 *
+	 * @param pPosition position of a region of space
+	 * @param pSize size of a region of space
+	 * @param pLevel the resulting level of resolution (-1 if out of bounds)
+	 *
+	 * @return the node encoded address
+	 */
+	inline unsigned int getNode( const float3& pPosition, const float3& pSize, int& pLevel ) const;
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvSharedBrickLoader( const GvSharedBrickLoader& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvSharedBrickLoader& operator=( const GvSharedBrickLoader& );
+
+};
+
+} // namespace GvUtils
+
+/**************************************************************************
+ ***************************** INLINE SECTION *****************************
+ **************************************************************************/
+
+#include "GvSharedBrickLoader.inl"
+
+#endif
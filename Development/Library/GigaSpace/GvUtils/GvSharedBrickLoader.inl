@@ -0,0 +1,440 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GPUPool.h"
+#include "GvCore/DataTypeList.h"
+#include "GvStructure/GvVolumeTreeAddressType.h"
+#include "GvPerfMon/GvMetrics.h"
+
+// STL
+#include <cstring>
+#include <cassert>
+#include <iostream>
+
+/******************************************************************************
+ ****************************** INLINE DEFINITION *****************************
+ ******************************************************************************/
+
+namespace GvUtils
+{
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pSocketPath path of the Unix socket of the brick server
+ ******************************************************************************/
+template< typename TDataTypeList >
+GvSharedBrickLoader< TDataTypeList >
+::GvSharedBrickLoader( const std::string& pSocketPath )
+:	GvIDataLoader< TDataTypeList >()
+,	_client()
+,	_bricksRes( make_uint3( 0 ) )
+,	_borderSize( 0 )
+,	_numMipMapLevels( 0 )
+,	_fallbackLoader( NULL )
+{
+	if ( _client.connect( pSocketPath ) )
+	{
+		const GvBrickServerProtocol::Header* header = _client.getHeader();
+
+		// Check the data types of the channels
+		if ( header->_nbChannels != static_cast< unsigned int >( Loki::TL::Length< TDataTypeList >::value ) )
+		{
+			std::cerr << "GvSharedBrickLoader::GvSharedBrickLoader() : number of channels mismatch with the brick server" << std::endl;
+			_client.disconnect();
+
+			return;
+		}
+
+		_bricksRes = make_uint3( header->_brickResolution );
+		_borderSize = header->_borderSize;
+		_numMipMapLevels = static_cast< int >( header->_nbLevels );
+	}
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+template< typename TDataTypeList >
+GvSharedBrickLoader< TDataTypeList >
+::~GvSharedBrickLoader()
+{
+	_client.disconnect();
+
+	delete _fallbackLoader;
+}
+
+/******************************************************************************
+ * Tell wheter or not the loader is connected to the brick server
+ *
+ * @return a flag telling wheter or not the loader is connected
+ ******************************************************************************/
+template< typename TDataTypeList >
+bool GvSharedBrickLoader< TDataTypeList >
+::isConnected() const
+{
+	return _client.isConnected();
+}
+
+/******************************************************************************
+ * Set the loader used when bricks can't be acquired from the brick server.
+ * The loader takes ownership of it.
+ *
+ * @param pLoader the fallback loader (NULL to remove it)
+ ******************************************************************************/
+template< typename TDataTypeList >
+void GvSharedBrickLoader< TDataTypeList >
+::setFallbackLoader( GvIDataLoader< TDataTypeList >* pLoader )
+{
+	if ( pLoader != _fallbackLoader )
+	{
+		delete _fallbackLoader;
+		_fallbackLoader = pLoader;
+	}
+}
+
+/******************************************************************************
+ * Get the brick resolution of the dataset of the brick server
+ *
+ * @return the brick resolution (without borders, 0 if not connected)
+ ******************************************************************************/
+template< typename TDataTypeList >
+uint3 GvSharedBrickLoader< TDataTypeList >
+::getBrickResolution() const
+{
+	return _bricksRes;
+}
+
+/******************************************************************************
+ * Get the brick border size of the dataset of the brick server
+ *
+ * @return the brick border size
+ ******************************************************************************/
+template< typename TDataTypeList >
+unsigned int GvSharedBrickLoader< TDataTypeList >
+::getBorderSize() const
+{
+	return _borderSize;
+}
+
+/******************************************************************************
+ * Helper function used to determine the type of regions in the data structure.
+ * The data structure is made of regions containing data, empty or constant regions.
+ *
+ * Retrieve the node and associated brick located in this region of space,
+ * and depending of its type, if it contains data, load it.
+ *
+ * @param pPosition position of a region of space
+ * @param pSize size of a region of space
+ * @param pBrickPool data cache pool. This is where all data reside for each channel (color, normal, etc...)
+ * @param pOffsetInPool offset in the brick pool
+ *
+ * @return the type of the region (.i.e returns constantness information for that region)
+ ******************************************************************************/
+template< typename TDataTypeList >
+typename GvSharedBrickLoader< TDataTypeList >::VPRegionInfo GvSharedBrickLoader< TDataTypeList >
+::getRegion( const float3& pPosition, const float3& pSize, GvCore::GPUPoolHost< GvCore::Array3D, TDataTypeList >* pBrickPool, size_t pOffsetInPool )
+{
+	// Without connection, all regions are read from the dataset files
+	if ( _fallbackLoader != NULL && ! _client.isConnected() )
+	{
+		return _fallbackLoader->getRegion( pPosition, pSize, pBrickPool, pOffsetInPool );
+	}
+
+	int level;
+	unsigned int nodeInfo = getNode( pPosition, pSize, level );
+
+	// Test if node contains a brick
+	if ( level >= 0 && ( nodeInfo & GV_VTBA_BRICK_FLAG ) )
+	{
+		// Ask the server to load the brick in a shared memory slot
+		// (its latency is recorded when the metrics endpoint is activated)
+		GvPerfMon::GvPerformanceTimer::Event loadEvent;
+		if ( GvPerfMon::GvMetrics::_isActivated )
+		{
+			GvPerfMon::GvMetrics::get().startTimer( loadEvent );
+		}
+		unsigned int slot = _client.acquireBrick( static_cast< unsigned int >( level ), nodeInfo );
+		if ( GvPerfMon::GvMetrics::_isActivated )
+		{
+			GvPerfMon::GvMetrics::get().stopTimer( GvPerfMon::GvMetrics::eLoaderLatency, loadEvent );
+		}
+		if ( slot != GV_BRICK_SERVER_INVALID_SLOT )
+		{
+			// Copy all channels to the brick pool
+			ChannelCopier channelCopier;
+			channelCopier._client = &_client;
+			channelCopier._slot = slot;
+			channelCopier._dataPool = pBrickPool;
+			channelCopier._offsetInPool = pOffsetInPool;
+			GvCore::StaticLoop< ChannelCopier, Loki::TL::Length< TDataTypeList >::value - 1 >::go( channelCopier );
+
+			// Let the server evict the slot
+			_client.releaseBrick( slot );
+
+			return GvSharedBrickLoader< TDataTypeList >::VP_UNKNOWN_REGION;
+		}
+
+		// The brick exists but the server can't provide it : read it from the dataset files
+		if ( _fallbackLoader != NULL )
+		{
+			return _fallbackLoader->getRegion( pPosition, pSize, pBrickPool, pOffsetInPool );
+		}
+
+		// Without fallback, the brick is not produced : acquireBrick() has already retried while the server was busy,
+		// so the region is reported as unavailable, and the producer leaves its node unproduced to request it again later
+		std::cerr << "GvSharedBrickLoader::getRegion() : unable to acquire brick from the brick server" << std::endl;
+
+		return GvSharedBrickLoader< TDataTypeList >::VP_UNAVAILABLE_REGION;
+	}
+
+	return GvSharedBrickLoader< TDataTypeList >::VP_CONST_REGION;
+}
+
+/******************************************************************************
+ * Provides constantness information about a region.
+ *
+ * @param pPosition position of a region of space
+ * @param pSize size of a region of space
+ *
+ * @return the type of the region (.i.e returns constantness information for that region)
+ ******************************************************************************/
+template< typename TDataTypeList >
+typename GvSharedBrickLoader< TDataTypeList >::VPRegionInfo GvSharedBrickLoader< TDataTypeList >
+::getRegionInfo( const float3& pPosition, const float3& pSize )
+{
+	if ( _fallbackLoader != NULL && ! _client.isConnected() )
+	{
+		return _fallbackLoader->getRegionInfo( pPosition, pSize );
+	}
+
+	int level;
+	unsigned int nodeInfo = getNode( pPosition, pSize, level );
+
+	// If there is a brick
+	if ( nodeInfo & GV_VTBA_BRICK_FLAG )
+	{
+		// If we are on a terminal node
+		if ( nodeInfo & GV_VTBA_TERMINAL_FLAG )
+		{
+			return GvSharedBrickLoader< TDataTypeList >::VP_UNKNOWN_REGION;
+		}
+
+		return GvSharedBrickLoader< TDataTypeList >::VP_NON_CONST_REGION;
+	}
+
+	return GvSharedBrickLoader< TDataTypeList >::VP_CONST_REGION;
+}
+
+/******************************************************************************
+ * Retrieve the node located in a region of space,
+ * and get its information (i.e. address containing its data type region).
+ *
+ * @param pPosition position of a region of space
+ * @param pSize size of a region of space
+ *
+ * @return the node encoded information
+ ******************************************************************************/
+template< typename TDataTypeList >
+uint GvSharedBrickLoader< TDataTypeList >
+::getRegionInfoNew( const float3& pPosition, const float3& pSize )
+{
+	if ( _fallbackLoader != NULL && ! _client.isConnected() )
+	{
+		return _fallbackLoader->getRegionInfoNew( pPosition, pSize );
+	}
+
+	int level;
+	uint nodeInfo = ( getNode( pPosition, pSize, level ) & 0xC0000000 );
+
+	// Regions whose whole subtree is homogeneous on all channels are terminal
+	if ( nodeInfo & GV_VTBA_BRICK_FLAG )
+	{
+		const uint3 blockPosition = getBlockCoords( level, pPosition );
+		const unsigned int nbChannels = _client.getHeader()->_nbChannels;
+
+		GvVoxelizer::GvNodeSummary summary;
+		bool isHomogeneous = true;
+		for ( unsigned int channel = 0; channel < nbChannels && isHomogeneous; channel++ )
+		{
+			isHomogeneous = _client.getSummary( level, blockPosition.x, blockPosition.y, blockPosition.z, channel, summary ) && ( summary._flags & GV_NODE_SUMMARY_HOMOGENEOUS_FLAG );
+		}
+		if ( isHomogeneous )
+		{
+			nodeInfo |= GV_VTBA_TERMINAL_FLAG;
+		}
+	}
+
+	return nodeInfo;
+}
+
+/******************************************************************************
+ * Retrieve the summary (min/max, occupancy, homogeneity) of the node
+ * located in a region of space, for a given data channel.
+ *
+ * @param pPosition position of a region of space
+ * @param pSize size of a region of space
+ * @param pChannel data channel index
+ * @param pSummary the resulting node summary
+ *
+ * @return a flag telling wheter or not a summary is available for that region
+ ******************************************************************************/
+template< typename TDataTypeList >
+bool GvSharedBrickLoader< TDataTypeList >
+::getRegionSummary( const float3& pPosition, const float3& pSize, unsigned int pChannel, GvVoxelizer::GvNodeSummary& pSummary )
+{
+	if ( _fallbackLoader != NULL && ! _client.isConnected() )
+	{
+		return _fallbackLoader->getRegionSummary( pPosition, pSize, pChannel, pSummary );
+	}
+
+	const int level = getDataLevel( pSize );
+	if ( level < 0 )
+	{
+		return false;
+	}
+
+	const uint3 blockPosition = getBlockCoords( level, pPosition );
+
+	return _client.getSummary( level, blockPosition.x, blockPosition.y, blockPosition.z, pChannel, pSummary );
+}
+
+/******************************************************************************
+ * Provides the size of the smallest features the producer can generate.
+ *
+ * @return the size of the smallest features the producer can generate
+ ******************************************************************************/
+template< typename TDataTypeList >
+float3 GvSharedBrickLoader< TDataTypeList >
+::getFeaturesSize() const
+{
+	if ( _fallbackLoader != NULL && ! _client.isConnected() )
+	{
+		return _fallbackLoader->getFeaturesSize();
+	}
+
+	if ( _numMipMapLevels == 0 )
+	{
+		return make_float3( 0.f );
+	}
+
+	// Resolution of the finest level
+	return make_float3( 1.0f ) / make_float3( _bricksRes * ( 1 << ( _numMipMapLevels - 1 ) ) );
+}
+
+/******************************************************************************
+ * Retrieve the level of resolution associated to a given size of a region of space.
+ *
+ * @param pSize size of a region of space
+ *
+ * @return the corresponding level (-1 if out of bounds)
+ ******************************************************************************/
+template< typename TDataTypeList >
+inline int GvSharedBrickLoader< TDataTypeList >
+::getDataLevel( const float3& pSize ) const
+{
+	// Compute the node resolution (i.e. number of nodes in each dimension)
+	uint3 numNodes = make_uint3( 1.0f / pSize );
+	int level = static_cast< int >( log( static_cast< float >( numNodes.x ) ) / log( 2.0f ) );
+
+	return ( level >= 0 && level < _numMipMapLevels ) ? level : -1;
+}
+
+/******************************************************************************
+ * Retrieve the indexed coordinates of a block (i.e. a node) in the blocks grid
+ * associated to a given position of a region of space at a given level of resolution.
+ *
+ * @param pLevel level of resolution
+ * @param pPosition position of a region of space
+ *
+ * @return the associated indexed coordinates
+ ******************************************************************************/
+template< typename TDataTypeList >
+inline uint3 GvSharedBrickLoader< TDataTypeList >
+::getBlockCoords( int pLevel, const float3& pPosition ) const
+{
+	// Same computation as GvDataLoader (suppose mipMapOrder==2)
+	uint3 levelResolution = _bricksRes * ( 1 << pLevel );
+
+	return make_uint3( make_float3( levelResolution ) * pPosition ) / _bricksRes;
+}
+
+/******************************************************************************
+ * Retrieve the node encoded address located in a region of space
+ *
+ * @param pPosition position of a region of space
+ * @param pSize size of a region of space
+ * @param pLevel the resulting level of resolution (-1 if out of bounds)
+ *
+ * @return the node encoded address
+ ******************************************************************************/
+template< typename TDataTypeList >
+inline unsigned int GvSharedBrickLoader< TDataTypeList >
+::getNode( const float3& pPosition, const float3& pSize, int& pLevel ) const
+{
+	pLevel = getDataLevel( pSize );
+	if ( pLevel < 0 )
+	{
+		return 0;
+	}
+
+	const uint3 blockPosition = getBlockCoords( pLevel, pPosition );
+
+	return _client.getNode( pLevel, blockPosition.x, blockPosition.y, blockPosition.z );
+}
+
+/******************************************************************************
+ * Copy a channel of the brick
+ *
+ * @param Loki::Int2Type< TChannelIndex > index of the channel (i.e. color, normal, etc...)
+ ******************************************************************************/
+template< typename TDataTypeList >
+template< int TChannelIndex >
+inline void GvSharedBrickLoader< TDataTypeList >::ChannelCopier
+::run( Loki::Int2Type< TChannelIndex > )
+{
+	// Type definition of the channel's data type at given channel index.
+	typedef typename Loki::TL::TypeAt< TDataTypeList, TChannelIndex >::Result ChannelType;
+
+	const GvBrickServerProtocol::Header* header = _client->getHeader();
+	assert( header->_voxelSize[ TChannelIndex ] == sizeof( ChannelType ) );
+
+	// Retrieve the data array associated to the data pool at given channel index.
+	GvCore::Array3D< ChannelType >* dataArray = _dataPool->template getChannel< TChannelIndex >();
+
+	// Copy data from the shared memory slot to the channel array of the data pool
+	memcpy( dataArray->getPointer( _offsetInPool )/* destination */,
+			_client->getBrickData( _slot, TChannelIndex )/* source */,
+			static_cast< size_t >( header->_brickNbVoxels ) * sizeof( ChannelType )/* number of bytes */ );
+}
+
+} // namespace GvUtils
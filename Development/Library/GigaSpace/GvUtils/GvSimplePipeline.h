@@ -172,6 +172,19 @@ public:
 	 */
 	virtual void finalize();
 
+	/**
+	 * Reallocate the node and brick pools with other sizes.
+	 * Resident nodes and bricks are kept (the most recently used ones if they don't fit),
+	 * so that data don't have to be produced again.
+	 *
+	 * Renderers reference the data structure and the cache : they are deleted,
+	 * and the caller has to add new ones.
+	 *
+	 * @param pNodePoolMemorySize Node pool memory size
+	 * @param pBrickPoolMemorySize Brick pool memory size
+	 */
+	virtual void resizePools( size_t pNodePoolMemorySize, size_t pBrickPoolMemorySize );
+
 	/**
 	 * Launch the main GigaSpace flow sequence
 	 */
@@ -345,6 +358,11 @@ protected:
 	 */
 	size_t _brickPoolMemorySize;
 
+	/**
+	 * Flag telling wheter or not graphics library interoperability is used by the pools
+	 */
+	bool _useGraphicsLibraryInteroperability;
+
 	/**
 	 * Producer
 	 */
@@ -54,6 +54,7 @@ inline GvSimplePipeline< TProducerType, TShaderType, TDataStructureType, TCacheT
 ,	_renderer( NULL )
 ,	_nodePoolMemorySize( 0 )
 ,	_brickPoolMemorySize( 0 )
+,	_useGraphicsLibraryInteroperability( false )
 ,	_producer( NULL )
 ,	_shader( NULL )
 ,	_clearRequested( false )
@@ -110,6 +111,7 @@ inline void GvSimplePipeline< TProducerType, TShaderType, TDataStructureType, TC
 	std::cout << "Brick pool resolution : " << brickPoolResolution << std::endl;
 
 	// Retrieve the requested graphics library interoperability mode
+	_useGraphicsLibraryInteroperability = pUseGraphicsLibraryInteroperability;
 	const unsigned int useGraphicsLibraryInteroperability = pUseGraphicsLibraryInteroperability ? 1 : 0;
 
 	// Data structure
@@ -146,6 +148,66 @@ inline void GvSimplePipeline< TProducerType, TShaderType, TDataStructureType, TC
 	delete _shader;
 }
 
+/******************************************************************************
+ * Reallocate the node and brick pools with other sizes.
+ * Resident nodes and bricks are kept (the most recently used ones if they don't fit),
+ * so that data don't have to be produced again.
+ *
+ * Renderers reference the data structure and the cache : they are deleted,
+ * and the caller has to add new ones.
+ *
+ * @param pNodePoolMemorySize Node pool memory size
+ * @param pBrickPoolMemorySize Brick pool memory size
+ ******************************************************************************/
+template< typename TProducerType, typename TShaderType, typename TDataStructureType, typename TCacheType >
+inline void GvSimplePipeline< TProducerType, TShaderType, TDataStructureType, TCacheType >
+::resizePools( size_t pNodePoolMemorySize, size_t pBrickPoolMemorySize )
+{
+	assert( pNodePoolMemorySize > 0 );
+	assert( pBrickPoolMemorySize > 0 );
+	assert( _cache != NULL );
+
+	// Copy the content of the cache on the host
+	typename CacheType::HostCacheContent content;
+	_cache->storeContent( content );
+
+	// Free memory
+	for ( size_t i = 0; i < _renderers.size(); i++ )
+	{
+		delete _renderers[ i ];
+	}
+	_renderers.clear();
+	_renderer = NULL;
+	delete _cache;
+	delete _dataStructure;
+
+	// Store global memory size of the pools
+	_nodePoolMemorySize = pNodePoolMemorySize;
+	_brickPoolMemorySize = pBrickPoolMemorySize;
+
+	// Compute the resolution of the pools
+	uint3 nodePoolResolution;
+	uint3 brickPoolResolution;
+	computePoolResolution( nodePoolResolution, brickPoolResolution );
+
+	std::cout << "\nNode pool resolution : " << nodePoolResolution << std::endl;
+	std::cout << "Brick pool resolution : " << brickPoolResolution << std::endl;
+
+	// Data structure and cache
+	const unsigned int useGraphicsLibraryInteroperability = _useGraphicsLibraryInteroperability ? 1 : 0;
+	_dataStructure = new DataStructureType( nodePoolResolution, brickPoolResolution, useGraphicsLibraryInteroperability );
+	assert( _dataStructure != NULL );
+	_cache = new CacheType( _dataStructure, nodePoolResolution, brickPoolResolution, useGraphicsLibraryInteroperability );
+	assert( _cache != NULL );
+
+	// Initialize the producer with the new data structure
+	_producer->initialize( _dataStructure, _cache );
+	_cache->addProducer( _producer );
+
+	// Copy resident nodes and bricks in the new pools
+	_cache->restoreContent( content );
+}
+
 /******************************************************************************
  * Launch the main GigaSpace flow sequence
  ******************************************************************************/
@@ -0,0 +1,318 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#ifndef _GV_TIME_SERIES_DATA_LOADER_H_
+#define _GV_TIME_SERIES_DATA_LOADER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <vector>
+#include <string>
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+#include "GvCore/Array3D.h"
+#include "GvCore/TypeHelpers.h"
+#include "GvCore/DataTypeList.h"
+#include "GvCore/vector_types_ext.h"
+#include "GvCore/GvMortonCode.h"
+#include "GvUtils/GvIDataLoader.h"
+#include "GvStructure/GvVolumeTreeAddressType.h"
+#include "GvVoxelizer/GvTimeSeries.h"
+
+// Loki
+#include <loki/Typelist.h>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+// GigaVoxels
+namespace GvCore
+{
+	template
+	<
+		template< typename > class THostArray, class TList
+	>
+	class GPUPoolHost;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvUtils
+{
+
+/**
+ * @class GvTimeSeriesDataLoader
+ *
+ * @brief The GvTimeSeriesDataLoader class provides a data loader
+ * for time-varying datasets stored in a time series file (see GvVoxelizer::GvTimeSeries).
+ *
+ * Regions are served from the current time step, held in memory.
+ * The next time steps are decoded in the background, so that moving to the next step
+ * only applies its deltas. Moving to a step gives the Morton keys of the nodes that have changed :
+ * they are meant to be given to the data production manager, so that only their bricks
+ * are produced again (see GvStructure::GvDataProductionManager::invalidateNodes()) :
+ *
+ *     std::vector< GvCore::GvMortonCode::ValueType > changedNodes;
+ *     if ( loader->setStep( step, changedNodes ) )
+ *     {
+ *         pipeline->editCache()->invalidateNodes( changedNodes );
+ *     }
+ *
+ * Keys match the ones of a data structure with 2x2x2 node tiles (see GvVoxelizer::GvTimeSeries::NodeTileResolution).
+ */
+template< typename TDataTypeList >
+class GvTimeSeriesDataLoader : public GvIDataLoader< TDataTypeList >
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Type definition of the parent class
+	 */
+	typedef GvIDataLoader< TDataTypeList > ParentClassType;
+
+	/**
+	 * Type definition of region info
+	 */
+	typedef typename ParentClassType::VPRegionInfo VPRegionInfo;
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pFileName time series filename
+	 * @param pBlocksize brick resolution
+	 * @param pBordersize brick border size
+	 * @param pNbPrefetchedSteps number of time steps decoded in advance
+	 */
+	GvTimeSeriesDataLoader( const std::string& pFileName, const uint3& pBlocksize, int pBordersize, unsigned int pNbPrefetchedSteps = 2 );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvTimeSeriesDataLoader();
+
+	/**
+	 * Helper function used to determine the type of regions in the data structure.
+	 * The data structure is made of regions containing data, empty or constant regions.
+	 *
+	 * Retrieve the node and associated brick located in this region of space,
+	 * and depending of its type, if it contains data, load it.
+	 *
+	 * @param pPosition position of a region of space
+	 * @param pSize size of a region of space
+	 * @param pBrickPool data cache pool. This is where all data reside for each channel (color, normal, etc...)
+	 * @param pOffsetInPool offset in the brick pool
+	 *
+	 * @return the type of the region (.i.e returns constantness information for that region)
+	 */
+	virtual VPRegionInfo getRegion( const float3& pPosition, const float3& pSize, GvCore::GPUPoolHost< GvCore::Array3D, TDataTypeList >* pBrickPool, size_t pOffsetInPool );
+
+	/**
+	 * Provides constantness information about a region.
+	 *
+	 * @param pPosition position of a region of space
+	 * @param pSize size of a region of space
+	 *
+	 * @return the type of the region (.i.e returns constantness information for that region)
+	 */
+	virtual VPRegionInfo getRegionInfo( const float3& pPosition, const float3& pSize );
+
+	/**
+	 * Retrieve the node located in a region of space,
+	 * and get its information (i.e. address containing its data type region).
+	 *
+	 * @param pPosition position of a region of space
+	 * @param pSize size of a region of space
+	 *
+	 * @return the node encoded information
+	 */
+	virtual uint getRegionInfoNew( const float3& pPosition, const float3& pSize );
+
+	/**
+	 * Provides the size of the smallest features the producer can generate.
+	 *
+	 * @return the size of the smallest features the producer can generate
+	 */
+	virtual float3 getFeaturesSize() const;
+
+	/**
+	 * Get the number of time steps
+	 *
+	 * @return the number of time steps
+	 */
+	unsigned int getNbSteps() const;
+
+	/**
+	 * Get the current time step
+	 *
+	 * @return the current time step
+	 */
+	unsigned int getStep() const;
+
+	/**
+	 * Move to a time step
+	 *
+	 * @param pStep the time step
+	 * @param pChangedNodes the Morton keys of the nodes that have changed (they are appended to the list)
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool setStep( unsigned int pStep, std::vector< GvCore::GvMortonCode::ValueType >& pChangedNodes );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Functor used to copy a brick of each channel in the data pool
+	 */
+	struct BrickCopier
+	{
+		/**
+		 * Time series
+		 */
+		const GvVoxelizer::GvTimeSeries* _timeSeries;
+
+		/**
+		 * Level of resolution
+		 */
+		unsigned int _level;
+
+		/**
+		 * Brick index
+		 */
+		unsigned int _brickIndex;
+
+		/**
+		 * Data pool
+		 */
+		GvCore::GPUPoolHost< GvCore::Array3D, TDataTypeList >* _dataPool;
+
+		/**
+		 * Offset in the data pool
+		 */
+		size_t _offsetInPool;
+
+		/**
+		 * Copy the brick of a channel
+		 *
+		 * @param Loki::Int2Type< TChannelIndex > index of the channel (i.e. color, normal, etc...)
+		 */
+		template< int TChannelIndex >
+		inline void run( Loki::Int2Type< TChannelIndex > );
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Time series
+	 */
+	GvVoxelizer::GvTimeSeries _timeSeries;
+
+	/**
+	 * Brick resolution (without borders)
+	 */
+	uint3 _bricksRes;
+
+	/**
+	 * Brick border size
+	 */
+	int _borderSize;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Retrieve the node located in a region of space
+	 *
+	 * @param pPosition position of a region of space
+	 * @param pSize size of a region of space
+	 * @param pLevel the level of resolution of the region
+	 *
+	 * @return the node (encoded as in ".nodes" files), 0 if the region is out of the levels
+	 */
+	unsigned int getNode( const float3& pPosition, const float3& pSize, unsigned int& pLevel ) const;
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvTimeSeriesDataLoader( const GvTimeSeriesDataLoader& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvTimeSeriesDataLoader& operator=( const GvTimeSeriesDataLoader& );
+
+};
+
+} // namespace GvUtils
+
+/**************************************************************************
+ ***************************** INLINE SECTION *****************************
+ **************************************************************************/
+
+#include "GvTimeSeriesDataLoader.inl"
+
+#endif
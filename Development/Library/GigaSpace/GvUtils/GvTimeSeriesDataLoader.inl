@@ -0,0 +1,271 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+/******************************************************************************
+ ****************************** INLINE DEFINITION *****************************
+ ******************************************************************************/
+
+namespace GvUtils
+{
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pFileName time series filename
+ * @param pBlocksize brick resolution
+ * @param pBordersize brick border size
+ * @param pNbPrefetchedSteps number of time steps decoded in advance
+ ******************************************************************************/
+template< typename TDataTypeList >
+GvTimeSeriesDataLoader< TDataTypeList >
+::GvTimeSeriesDataLoader( const std::string& pFileName, const uint3& pBlocksize, int pBordersize, unsigned int pNbPrefetchedSteps )
+:	_timeSeries()
+,	_bricksRes( pBlocksize )
+,	_borderSize( pBordersize )
+{
+	if ( _timeSeries.open( pFileName, pNbPrefetchedSteps ) )
+	{
+		// Bricks must have the resolution of the data pool
+		if ( _timeSeries.getBrickResolution() != pBlocksize.x || static_cast< int >( _timeSeries.getBorderSize() ) != pBordersize ||
+			_timeSeries.getChannels().size() != static_cast< size_t >( Loki::TL::Length< TDataTypeList >::value ) )
+		{
+			std::cerr << "GvTimeSeriesDataLoader::GvTimeSeriesDataLoader() : " << pFileName << " has bricks of resolution " << _timeSeries.getBrickResolution()
+						<< ", border size " << _timeSeries.getBorderSize() << " and " << _timeSeries.getChannels().size() << " channels, that do not match the data pool" << std::endl;
+			_timeSeries.close();
+		}
+	}
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+template< typename TDataTypeList >
+GvTimeSeriesDataLoader< TDataTypeList >
+::~GvTimeSeriesDataLoader()
+{
+}
+
+/******************************************************************************
+ * Helper function used to determine the type of regions in the data structure.
+ * The data structure is made of regions containing data, empty or constant regions.
+ *
+ * Retrieve the node and associated brick located in this region of space,
+ * and depending of its type, if it contains data, load it.
+ *
+ * @param pPosition position of a region of space
+ * @param pSize size of a region of space
+ * @param pBrickPool data cache pool. This is where all data reside for each channel (color, normal, etc...)
+ * @param pOffsetInPool offset in the brick pool
+ *
+ * @return the type of the region (.i.e returns constantness information for that region)
+ ******************************************************************************/
+template< typename TDataTypeList >
+typename GvTimeSeriesDataLoader< TDataTypeList >::VPRegionInfo GvTimeSeriesDataLoader< TDataTypeList >
+::getRegion( const float3& pPosition, const float3& pSize, GvCore::GPUPoolHost< GvCore::Array3D, TDataTypeList >* pBrickPool, size_t pOffsetInPool )
+{
+	unsigned int level;
+	const unsigned int node = getNode( pPosition, pSize, level );
+
+	// Test if node contains a brick
+	if ( node & GV_VTBA_BRICK_FLAG )
+	{
+		BrickCopier brickCopier;
+		brickCopier._timeSeries = &_timeSeries;
+		brickCopier._level = level;
+		brickCopier._brickIndex = node & 0x3FFFFFFFU;
+		brickCopier._dataPool = pBrickPool;
+		brickCopier._offsetInPool = pOffsetInPool;
+		GvCore::StaticLoop< BrickCopier, Loki::TL::Length< TDataTypeList >::value - 1 >::go( brickCopier );
+
+		return ParentClassType::VP_UNKNOWN_REGION;
+	}
+
+	return ParentClassType::VP_CONST_REGION;
+}
+
+/******************************************************************************
+ * Provides constantness information about a region.
+ *
+ * @param pPosition position of a region of space
+ * @param pSize size of a region of space
+ *
+ * @return the type of the region (.i.e returns constantness information for that region)
+ ******************************************************************************/
+template< typename TDataTypeList >
+typename GvTimeSeriesDataLoader< TDataTypeList >::VPRegionInfo GvTimeSeriesDataLoader< TDataTypeList >
+::getRegionInfo( const float3& pPosition, const float3& pSize )
+{
+	unsigned int level;
+	const unsigned int node = getNode( pPosition, pSize, level );
+
+	if ( node & GV_VTBA_BRICK_FLAG )
+	{
+		return ( node & GV_VTBA_TERMINAL_FLAG ) ? ParentClassType::VP_UNKNOWN_REGION : ParentClassType::VP_NON_CONST_REGION;
+	}
+
+	return ParentClassType::VP_CONST_REGION;
+}
+
+/******************************************************************************
+ * Retrieve the node located in a region of space,
+ * and get its information (i.e. address containing its data type region).
+ *
+ * @param pPosition position of a region of space
+ * @param pSize size of a region of space
+ *
+ * @return the node encoded information
+ ******************************************************************************/
+template< typename TDataTypeList >
+uint GvTimeSeriesDataLoader< TDataTypeList >
+::getRegionInfoNew( const float3& pPosition, const float3& pSize )
+{
+	unsigned int level;
+
+	// Apply a mask on the two first bits to retrieve node information
+	return getNode( pPosition, pSize, level ) & ( GV_VTBA_BRICK_FLAG | GV_VTBA_TERMINAL_FLAG );
+}
+
+/******************************************************************************
+ * Provides the size of the smallest features the producer can generate.
+ *
+ * @return the size of the smallest features the producer can generate
+ ******************************************************************************/
+template< typename TDataTypeList >
+float3 GvTimeSeriesDataLoader< TDataTypeList >
+::getFeaturesSize() const
+{
+	const unsigned int nbLevels = std::max( _timeSeries.getNbLevels(), 1U );
+
+	return make_float3( 1.0f ) / make_float3( _bricksRes * ( 1 << ( nbLevels - 1 ) ) );
+}
+
+/******************************************************************************
+ * Get the number of time steps
+ *
+ * @return the number of time steps
+ ******************************************************************************/
+template< typename TDataTypeList >
+unsigned int GvTimeSeriesDataLoader< TDataTypeList >
+::getNbSteps() const
+{
+	return _timeSeries.getNbSteps();
+}
+
+/******************************************************************************
+ * Get the current time step
+ *
+ * @return the current time step
+ ******************************************************************************/
+template< typename TDataTypeList >
+unsigned int GvTimeSeriesDataLoader< TDataTypeList >
+::getStep() const
+{
+	return _timeSeries.getStep();
+}
+
+/******************************************************************************
+ * Move to a time step
+ *
+ * @param pStep the time step
+ * @param pChangedNodes the Morton keys of the nodes that have changed (they are appended to the list)
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+template< typename TDataTypeList >
+bool GvTimeSeriesDataLoader< TDataTypeList >
+::setStep( unsigned int pStep, std::vector< GvCore::GvMortonCode::ValueType >& pChangedNodes )
+{
+	return _timeSeries.setStep( pStep, pChangedNodes );
+}
+
+/******************************************************************************
+ * Retrieve the node located in a region of space
+ *
+ * @param pPosition position of a region of space
+ * @param pSize size of a region of space
+ * @param pLevel the level of resolution of the region
+ *
+ * @return the node (encoded as in ".nodes" files), 0 if the region is out of the levels
+ ******************************************************************************/
+template< typename TDataTypeList >
+unsigned int GvTimeSeriesDataLoader< TDataTypeList >
+::getNode( const float3& pPosition, const float3& pSize, unsigned int& pLevel ) const
+{
+	// Retrieve the level of resolution associated to the size of the region (i.e. the number of nodes in each dimension)
+	const unsigned int levelResolution = static_cast< unsigned int >( 1.0f / pSize.x + 0.5f );
+	pLevel = 0;
+	while ( ( 1U << ( pLevel + 1 ) ) <= levelResolution )
+	{
+		pLevel++;
+	}
+	if ( pLevel >= _timeSeries.getNbLevels() )
+	{
+		return 0;
+	}
+
+	// Nodes are stored X axis first, then Y axis, then Z axis
+	const uint3 nodePosition = make_uint3( make_float3( static_cast< float >( 1 << pLevel ) ) * pPosition );
+	const size_t nodeResolution = static_cast< size_t >( 1 ) << pLevel;
+	const size_t nodeIndex = nodePosition.x + nodePosition.y * nodeResolution + nodePosition.z * nodeResolution * nodeResolution;
+
+	return _timeSeries.getNode( pLevel, nodeIndex );
+}
+
+/******************************************************************************
+ * Copy the brick of a channel
+ *
+ * @param Loki::Int2Type< TChannelIndex > index of the channel (i.e. color, normal, etc...)
+ ******************************************************************************/
+template< typename TDataTypeList >
+template< int TChannelIndex >
+inline void GvTimeSeriesDataLoader< TDataTypeList >::BrickCopier
+::run( Loki::Int2Type< TChannelIndex > )
+{
+	// Type definition of the channel's data type at given channel index.
+	typedef typename Loki::TL::TypeAt< TDataTypeList, TChannelIndex >::Result ChannelType;
+
+	const unsigned char* brick = _timeSeries->getBrick( _level, TChannelIndex, _brickIndex );
+	if ( brick != NULL )
+	{
+		// Copy data from the current time step to the channel array of the data pool
+		const size_t brickResolution = _timeSeries->getBrickResolution() + 2 * _timeSeries->getBorderSize();
+		const size_t size = std::min( _timeSeries->getBrickSize( TChannelIndex ), brickResolution * brickResolution * brickResolution * sizeof( ChannelType ) );
+		GvCore::Array3D< ChannelType >* dataArray = _dataPool->template getChannel< TChannelIndex >();
+		memcpy( dataArray->getPointer( _offsetInPool ), brick, size );
+	}
+}
+
+} // namespace GvUtils
@@ -38,6 +38,10 @@
 
 // STL
 #include <iostream>
+#include <algorithm>
+
+// System
+#include <cmath>
 
 /******************************************************************************
  ****************************** NAMESPACE SECTION *****************************
@@ -173,3 +177,42 @@ void GvTransferFunction::bindToTextureReference( const void* pSymbol, const char
 	// Bind array to 3D texture
 	GV_CUDA_SAFE_CALL( cudaBindTextureToArray( (const textureReference *)texRefPtr, _dataArray, &_channelFormatDesc ) );
 }
+
+/******************************************************************************
+ * Tell wheter or not a range of values is fully transparent.
+ *
+ * All transfer function entries covering the normalized range [ pMin ; pMax ]
+ * are checked on host, so the test is conservative.
+ *
+ * @param pMin min normalized value of the range
+ * @param pMax max normalized value of the range
+ * @param pOpacityThreshold opacity under which an entry is considered transparent
+ *
+ * @return a flag telling wheter or not the range is fully transparent
+ ******************************************************************************/
+bool GvTransferFunction::isTransparent( float pMin, float pMax, float pOpacityThreshold ) const
+{
+	if ( _data == NULL || _resolution == 0 )
+	{
+		return false;
+	}
+
+	// Clamp the range in [ 0.0 ; 1.0 ]
+	const float minValue = std::min( std::max( pMin, 0.f ), 1.f );
+	const float maxValue = std::min( std::max( pMax, 0.f ), 1.f );
+
+	// Retrieve all entries that can be fetched with linear filtering
+	const float scale = static_cast< float >( _resolution - 1 );
+	const unsigned int first = static_cast< unsigned int >( floorf( minValue * scale ) );
+	const unsigned int last = static_cast< unsigned int >( ceilf( maxValue * scale ) );
+
+	for ( unsigned int i = first; i <= last && i < _resolution; i++ )
+	{
+		if ( _data[ i ].w > pOpacityThreshold )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -158,6 +158,20 @@ public:
 	 */
 	void bindToTextureReference( const void* pSymbol, const char* pTexRefName, bool pNormalizedAccess, cudaTextureFilterMode pFilterMode, cudaTextureAddressMode pAddressMode );
 
+	/**
+	 * Tell wheter or not a range of values is fully transparent.
+	 *
+	 * All transfer function entries covering the normalized range [ pMin ; pMax ]
+	 * are checked on host, so the test is conservative.
+	 *
+	 * @param pMin min normalized value of the range
+	 * @param pMax max normalized value of the range
+	 * @param pOpacityThreshold opacity under which an entry is considered transparent
+	 *
+	 * @return a flag telling wheter or not the range is fully transparent
+	 */
+	bool isTransparent( float pMin, float pMax, float pOpacityThreshold ) const;
+
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
 	 **************************************************************************/
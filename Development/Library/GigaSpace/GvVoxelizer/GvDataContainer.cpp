@@ -0,0 +1,569 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvVoxelizer/GvDataContainer.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <iostream>
+#include <cstring>
+
+// System
+#ifndef WIN32
+	#include <sys/mman.h>
+	#include <sys/types.h>
+#endif
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GvVoxelizer
+using namespace GvVoxelizer;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Size of the buffer used to copy files in a container (in bytes)
+ */
+static const size_t cCopyBufferSize = 1 << 20;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvDataContainer::GvDataContainer()
+:	_file( NULL )
+,	_fileSize( 0 )
+,	_mappedData( NULL )
+,	_name()
+,	_brickResolution( 0 )
+,	_borderSize( 0 )
+,	_nbLevels( 0 )
+,	_channels()
+,	_sections()
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvDataContainer::~GvDataContainer()
+{
+	close();
+}
+
+/******************************************************************************
+ * Open a container file and read its header block
+ *
+ * @param pFileName the container file name
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvDataContainer::open( const std::string& pFileName )
+{
+	close();
+
+	_file = fopen( pFileName.c_str(), "rb" );
+	if ( _file == NULL )
+	{
+		std::cerr << "GvDataContainer::open() : unable to open " << pFileName << std::endl;
+		return false;
+	}
+
+	// Retrieve the file size
+#ifdef WIN32
+	_fseeki64( _file, 0, SEEK_END );
+	_fileSize = static_cast< unsigned long long >( _ftelli64( _file ) );
+#else
+	fseeko( _file, 0, SEEK_END );
+	_fileSize = static_cast< unsigned long long >( ftello( _file ) );
+#endif
+
+	// Read the header block : its first page holds the whole header block of usual datasets
+	std::vector< unsigned char > headerBlock( GV_DATA_CONTAINER_PAGE_SIZE, 0 );
+	size_t headerBlockSize = static_cast< size_t >( _fileSize < GV_DATA_CONTAINER_PAGE_SIZE ? _fileSize : GV_DATA_CONTAINER_PAGE_SIZE );
+	bool isValid = ( headerBlockSize >= sizeof( FileHeader ) ) && seek( _file, 0 ) && ( fread( &headerBlock[ 0 ], 1, headerBlockSize, _file ) == headerBlockSize );
+	if ( isValid )
+	{
+		// Large header block (i.e. a lot of levels or channels) : read the remaining pages
+		FileHeader header;
+		memcpy( &header, &headerBlock[ 0 ], sizeof( FileHeader ) );
+		if ( memcmp( header._magic, GV_DATA_CONTAINER_MAGIC, sizeof( GV_DATA_CONTAINER_MAGIC ) ) == 0 &&
+			header._headerBlockSize > headerBlockSize && header._headerBlockSize <= _fileSize )
+		{
+			headerBlock.resize( header._headerBlockSize );
+			isValid = ( fread( &headerBlock[ headerBlockSize ], 1, header._headerBlockSize - headerBlockSize, _file ) == header._headerBlockSize - headerBlockSize );
+			headerBlockSize = header._headerBlockSize;
+		}
+	}
+	if ( ! isValid || ! parseHeaderBlock( &headerBlock[ 0 ], headerBlockSize ) )
+	{
+		std::cerr << "GvDataContainer::open() : invalid container file " << pFileName << std::endl;
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Close the container (and unmap it if it has been mapped)
+ ******************************************************************************/
+void GvDataContainer::close()
+{
+#ifndef WIN32
+	if ( _mappedData != NULL )
+	{
+		munmap( _mappedData, static_cast< size_t >( _fileSize ) );
+	}
+#endif
+	_mappedData = NULL;
+
+	if ( _file != NULL )
+	{
+		fclose( _file );
+		_file = NULL;
+	}
+
+	_fileSize = 0;
+	_name.clear();
+	_brickResolution = 0;
+	_borderSize = 0;
+	_nbLevels = 0;
+	_channels.clear();
+	_sections.clear();
+}
+
+/******************************************************************************
+ * Tell wheter or not the container is open
+ *
+ * @return a flag telling wheter or not the container is open
+ ******************************************************************************/
+bool GvDataContainer::isOpen() const
+{
+	return ( _file != NULL );
+}
+
+/******************************************************************************
+ * Get the dataset name
+ *
+ * @return the dataset name
+ ******************************************************************************/
+const std::string& GvDataContainer::getName() const
+{
+	return _name;
+}
+
+/******************************************************************************
+ * Get the brick resolution (without borders)
+ *
+ * @return the brick resolution
+ ******************************************************************************/
+unsigned int GvDataContainer::getBrickResolution() const
+{
+	return _brickResolution;
+}
+
+/******************************************************************************
+ * Get the brick border size
+ *
+ * @return the brick border size
+ ******************************************************************************/
+unsigned int GvDataContainer::getBorderSize() const
+{
+	return _borderSize;
+}
+
+/******************************************************************************
+ * Get the number of levels of resolution
+ *
+ * @return the number of levels of resolution
+ ******************************************************************************/
+unsigned int GvDataContainer::getNbLevels() const
+{
+	return _nbLevels;
+}
+
+/******************************************************************************
+ * Get the data channels
+ *
+ * @return the data channels
+ ******************************************************************************/
+const std::vector< GvDataContainer::Channel >& GvDataContainer::getChannels() const
+{
+	return _channels;
+}
+
+/******************************************************************************
+ * Get the sections
+ *
+ * @return the sections
+ ******************************************************************************/
+const std::vector< GvDataContainer::Section >& GvDataContainer::getSections() const
+{
+	return _sections;
+}
+
+/******************************************************************************
+ * Find a section
+ *
+ * @param pType section type
+ * @param pLevel level of resolution
+ * @param pChannel channel index (brick sections only)
+ *
+ * @return the section, or NULL if the container has no such section
+ ******************************************************************************/
+const GvDataContainer::Section* GvDataContainer::findSection( ESectionType pType, unsigned int pLevel, unsigned int pChannel ) const
+{
+	for ( size_t i = 0; i < _sections.size(); i++ )
+	{
+		const Section& section = _sections[ i ];
+		if ( section._type == pType && section._level == pLevel && ( pType != eBrickSection || section._channel == pChannel ) )
+		{
+			return &section;
+		}
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ * Read data of a section
+ *
+ * @param pSection the section
+ * @param pOffset offset in the section (in bytes)
+ * @param pData the buffer in which data is read
+ * @param pSize number of bytes to read
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvDataContainer::read( const Section& pSection, unsigned long long pOffset, void* pData, size_t pSize ) const
+{
+	if ( _file == NULL || pOffset + pSize > pSection._size )
+	{
+		return false;
+	}
+
+	// Mapped container : no system call
+	if ( _mappedData != NULL )
+	{
+		memcpy( pData, _mappedData + pSection._offset + pOffset, pSize );
+		return true;
+	}
+
+	return seek( _file, pSection._offset + pOffset ) && ( fread( pData, 1, pSize, _file ) == pSize );
+}
+
+/******************************************************************************
+ * Map the whole container file in memory (read-only).
+ * Sections are then available at getMappedData() + section offset.
+ *
+ * @return a flag telling wheter or not it succeeds (mapping is not available on all platforms)
+ ******************************************************************************/
+bool GvDataContainer::map()
+{
+	if ( _mappedData != NULL )
+	{
+		return true;
+	}
+	if ( _file == NULL )
+	{
+		return false;
+	}
+
+#ifndef WIN32
+	void* mappedData = mmap( NULL, static_cast< size_t >( _fileSize ), PROT_READ, MAP_SHARED, fileno( _file ), 0 );
+	if ( mappedData == MAP_FAILED )
+	{
+		std::cerr << "GvDataContainer::map() : unable to map the container file" << std::endl;
+		return false;
+	}
+	_mappedData = static_cast< unsigned char* >( mappedData );
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+/******************************************************************************
+ * Get the mapped container file
+ *
+ * @return the mapped container file, or NULL if the container is not mapped
+ ******************************************************************************/
+const unsigned char* GvDataContainer::getMappedData() const
+{
+	return _mappedData;
+}
+
+/******************************************************************************
+ * Tell wheter or not a file name is the one of a container file (".gvc" extension)
+ *
+ * @param pFileName a file name
+ *
+ * @return a flag telling wheter or not the file name is the one of a container file
+ ******************************************************************************/
+bool GvDataContainer::isContainerFileName( const std::string& pFileName )
+{
+	const std::string extension = ".gvc";
+
+	return pFileName.size() > extension.size() && pFileName.compare( pFileName.size() - extension.size(), extension.size(), extension ) == 0;
+}
+
+/******************************************************************************
+ * Write a container file
+ *
+ * @param pFileName the container file name
+ * @param pName the dataset name
+ * @param pBrickResolution brick resolution (without borders)
+ * @param pBorderSize brick border size
+ * @param pNbLevels number of levels of resolution
+ * @param pChannels data channels
+ * @param pFiles files to store in the container (their content is copied)
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvDataContainer::write( const std::string& pFileName, const std::string& pName,
+							unsigned int pBrickResolution, unsigned int pBorderSize, unsigned int pNbLevels,
+							const std::vector< Channel >& pChannels, const std::vector< SectionFile >& pFiles )
+{
+	const unsigned long long pageSize = GV_DATA_CONTAINER_PAGE_SIZE;
+
+	if ( pName.size() >= GV_DATA_CONTAINER_NAME_SIZE )
+	{
+		std::cerr << "GvDataContainer::write() : dataset name is too long : " << pName << std::endl;
+		return false;
+	}
+	for ( size_t i = 0; i < pChannels.size(); i++ )
+	{
+		if ( pChannels[ i ]._name.size() >= GV_DATA_CONTAINER_CHANNEL_NAME_SIZE || pChannels[ i ]._typeName.size() >= GV_DATA_CONTAINER_CHANNEL_NAME_SIZE )
+		{
+			std::cerr << "GvDataContainer::write() : channel name is too long : " << pChannels[ i ]._name << std::endl;
+			return false;
+		}
+	}
+
+	// Header block layout
+	const size_t headerSize = sizeof( FileHeader ) + pChannels.size() * sizeof( ChannelEntry ) + pFiles.size() * sizeof( SectionEntry );
+	const unsigned long long headerBlockSize = ( ( headerSize + pageSize - 1 ) / pageSize ) * pageSize;
+	std::vector< unsigned char > headerBlock( static_cast< size_t >( headerBlockSize ), 0 );
+
+	FileHeader* header = reinterpret_cast< FileHeader* >( &headerBlock[ 0 ] );
+	memcpy( header->_magic, GV_DATA_CONTAINER_MAGIC, sizeof( GV_DATA_CONTAINER_MAGIC ) );
+	header->_version = GV_DATA_CONTAINER_VERSION;
+	header->_pageSize = GV_DATA_CONTAINER_PAGE_SIZE;
+	header->_headerBlockSize = static_cast< unsigned int >( headerBlockSize );
+	header->_brickResolution = pBrickResolution;
+	header->_borderSize = pBorderSize;
+	header->_nbLevels = pNbLevels;
+	header->_nbChannels = static_cast< unsigned int >( pChannels.size() );
+	header->_nbSections = static_cast< unsigned int >( pFiles.size() );
+	strcpy( header->_name, pName.c_str() );
+
+	ChannelEntry* channelEntries = reinterpret_cast< ChannelEntry* >( &headerBlock[ sizeof( FileHeader ) ] );
+	for ( size_t i = 0; i < pChannels.size(); i++ )
+	{
+		strcpy( channelEntries[ i ]._name, pChannels[ i ]._name.c_str() );
+		strcpy( channelEntries[ i ]._typeName, pChannels[ i ]._typeName.c_str() );
+	}
+
+	// Sections follow each other, each one starting on a page boundary
+	std::vector< SectionEntry > sectionEntries( pFiles.size() );
+	unsigned long long offset = headerBlockSize;
+	for ( size_t i = 0; i < pFiles.size(); i++ )
+	{
+		FILE* file = fopen( pFiles[ i ]._fileName.c_str(), "rb" );
+		if ( file == NULL )
+		{
+			std::cerr << "GvDataContainer::write() : unable to open " << pFiles[ i ]._fileName << std::endl;
+			return false;
+		}
+#ifdef WIN32
+		_fseeki64( file, 0, SEEK_END );
+		const unsigned long long size = static_cast< unsigned long long >( _ftelli64( file ) );
+#else
+		fseeko( file, 0, SEEK_END );
+		const unsigned long long size = static_cast< unsigned long long >( ftello( file ) );
+#endif
+		fclose( file );
+
+		memset( &sectionEntries[ i ], 0, sizeof( SectionEntry ) );
+		sectionEntries[ i ]._type = static_cast< unsigned int >( pFiles[ i ]._type );
+		sectionEntries[ i ]._level = pFiles[ i ]._level;
+		sectionEntries[ i ]._channel = pFiles[ i ]._channel;
+		sectionEntries[ i ]._offset = offset;
+		sectionEntries[ i ]._size = size;
+
+		offset += ( ( size + pageSize - 1 ) / pageSize ) * pageSize;
+	}
+	if ( ! sectionEntries.empty() )
+	{
+		memcpy( &headerBlock[ sizeof( FileHeader ) + pChannels.size() * sizeof( ChannelEntry ) ], &sectionEntries[ 0 ], sectionEntries.size() * sizeof( SectionEntry ) );
+	}
+
+	// Write the container
+	FILE* containerFile = fopen( pFileName.c_str(), "wb" );
+	if ( containerFile == NULL )
+	{
+		std::cerr << "GvDataContainer::write() : unable to write " << pFileName << std::endl;
+		return false;
+	}
+
+	bool isSucceeded = ( fwrite( &headerBlock[ 0 ], 1, headerBlock.size(), containerFile ) == headerBlock.size() );
+
+	std::vector< unsigned char > buffer( cCopyBufferSize );
+	unsigned long long position = headerBlockSize;
+	for ( size_t i = 0; i < pFiles.size() && isSucceeded; i++ )
+	{
+		// Padding up to the section page boundary
+		memset( &buffer[ 0 ], 0, static_cast< size_t >( pageSize ) );
+		const size_t paddingSize = static_cast< size_t >( sectionEntries[ i ]._offset - position );
+		isSucceeded = ( fwrite( &buffer[ 0 ], 1, paddingSize, containerFile ) == paddingSize );
+
+		// Section content
+		FILE* file = fopen( pFiles[ i ]._fileName.c_str(), "rb" );
+		isSucceeded = isSucceeded && ( file != NULL );
+		unsigned long long remainingSize = sectionEntries[ i ]._size;
+		while ( isSucceeded && remainingSize > 0 )
+		{
+			const size_t size = static_cast< size_t >( remainingSize < cCopyBufferSize ? remainingSize : cCopyBufferSize );
+			isSucceeded = ( fread( &buffer[ 0 ], 1, size, file ) == size ) && ( fwrite( &buffer[ 0 ], 1, size, containerFile ) == size );
+			remainingSize -= size;
+		}
+		if ( file != NULL )
+		{
+			fclose( file );
+		}
+
+		position = sectionEntries[ i ]._offset + sectionEntries[ i ]._size;
+	}
+
+	if ( fclose( containerFile ) != 0 )
+	{
+		isSucceeded = false;
+	}
+	if ( ! isSucceeded )
+	{
+		std::cerr << "GvDataContainer::write() : unable to write " << pFileName << std::endl;
+	}
+
+	return isSucceeded;
+}
+
+/******************************************************************************
+ * Parse the header block of a container file
+ *
+ * @param pHeaderBlock the header block
+ * @param pSize size of the header block (in bytes)
+ *
+ * @return a flag telling wheter or not the header block is valid
+ ******************************************************************************/
+bool GvDataContainer::parseHeaderBlock( const unsigned char* pHeaderBlock, size_t pSize )
+{
+	FileHeader header;
+	memcpy( &header, pHeaderBlock, sizeof( FileHeader ) );
+	if ( memcmp( header._magic, GV_DATA_CONTAINER_MAGIC, sizeof( GV_DATA_CONTAINER_MAGIC ) ) != 0 || header._version != GV_DATA_CONTAINER_VERSION )
+	{
+		return false;
+	}
+	if ( sizeof( FileHeader ) + header._nbChannels * sizeof( ChannelEntry ) + header._nbSections * sizeof( SectionEntry ) > pSize )
+	{
+		return false;
+	}
+
+	header._name[ GV_DATA_CONTAINER_NAME_SIZE - 1 ] = '\0';
+	_name = header._name;
+	_brickResolution = header._brickResolution;
+	_borderSize = header._borderSize;
+	_nbLevels = header._nbLevels;
+
+	// Channels
+	const unsigned char* entry = pHeaderBlock + sizeof( FileHeader );
+	_channels.resize( header._nbChannels );
+	for ( unsigned int i = 0; i < header._nbChannels; i++ )
+	{
+		ChannelEntry channelEntry;
+		memcpy( &channelEntry, entry, sizeof( ChannelEntry ) );
+		channelEntry._name[ GV_DATA_CONTAINER_CHANNEL_NAME_SIZE - 1 ] = '\0';
+		channelEntry._typeName[ GV_DATA_CONTAINER_CHANNEL_NAME_SIZE - 1 ] = '\0';
+		_channels[ i ]._name = channelEntry._name;
+		_channels[ i ]._typeName = channelEntry._typeName;
+		entry += sizeof( ChannelEntry );
+	}
+
+	// Sections
+	_sections.resize( header._nbSections );
+	for ( unsigned int i = 0; i < header._nbSections; i++ )
+	{
+		SectionEntry sectionEntry;
+		memcpy( &sectionEntry, entry, sizeof( SectionEntry ) );
+		if ( sectionEntry._type > eSummarySection || sectionEntry._offset + sectionEntry._size > _fileSize )
+		{
+			return false;
+		}
+		_sections[ i ]._type = static_cast< ESectionType >( sectionEntry._type );
+		_sections[ i ]._level = sectionEntry._level;
+		_sections[ i ]._channel = sectionEntry._channel;
+		_sections[ i ]._offset = sectionEntry._offset;
+		_sections[ i ]._size = sectionEntry._size;
+		entry += sizeof( SectionEntry );
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Move the file position of a file stream (64 bits offset)
+ *
+ * @param pFile the file stream
+ * @param pOffset the offset from the beginning of the file (in bytes)
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvDataContainer::seek( FILE* pFile, unsigned long long pOffset )
+{
+#ifdef WIN32
+	return ( _fseeki64( pFile, static_cast< __int64 >( pOffset ), SEEK_SET ) == 0 );
+#else
+	return ( fseeko( pFile, static_cast< off_t >( pOffset ), SEEK_SET ) == 0 );
+#endif
+}
@@ -0,0 +1,474 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_DATA_CONTAINER_H_
+#define _GV_DATA_CONTAINER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+
+// STL
+#include <vector>
+#include <string>
+
+// System
+#include <cstdio>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Container file identification
+ */
+#define GV_DATA_CONTAINER_MAGIC			"GVDCONT"
+#define GV_DATA_CONTAINER_VERSION		1
+
+/**
+ * Alignment of the header block and of the sections in a container file (in bytes)
+ */
+#define GV_DATA_CONTAINER_PAGE_SIZE		4096
+
+/**
+ * Size of the names stored in a container file (terminating null character included)
+ */
+#define GV_DATA_CONTAINER_NAME_SIZE		64
+#define GV_DATA_CONTAINER_CHANNEL_NAME_SIZE	32
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvVoxelizer
+{
+
+/** 
+ * @class GvDataContainer
+ *
+ * @brief The GvDataContainer class provides access to a GigaVoxels dataset
+ * stored in a single container file (".gvc").
+ *
+ * A dataset is usually made of an XML file and one ".nodes" file, one ".bricks"
+ * file per channel and an optional ".summary" file per level of resolution.
+ * A container holds the same data in one file :
+ * - a header block : file header, channel descriptions and section table,
+ * - one section per original file, with the same content.
+ *
+ * The header block and all sections start on a page boundary
+ * (GV_DATA_CONTAINER_PAGE_SIZE), so that sections can be memory mapped
+ * and used in place. Opening a container is one open plus one read of the header block.
+ *
+ * All values are stored with the native endianness.
+ *
+ * Note : reads share the same file stream, a container must not be read from several threads.
+ */
+class GIGASPACE_EXPORT GvDataContainer
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Section types (i.e. original file types)
+	 */
+	enum ESectionType
+	{
+		eNodeSection,
+		eBrickSection,
+		eSummarySection
+	};
+
+	/**
+	 * Data channel description
+	 */
+	struct Channel
+	{
+		/**
+		 * Name and type name (i.e. "uchar4", "float", etc...)
+		 */
+		std::string _name;
+		std::string _typeName;
+	};
+
+	/**
+	 * Section description
+	 */
+	struct Section
+	{
+		/**
+		 * Section type
+		 */
+		ESectionType _type;
+
+		/**
+		 * Level of resolution
+		 */
+		unsigned int _level;
+
+		/**
+		 * Channel index (brick sections only)
+		 */
+		unsigned int _channel;
+
+		/**
+		 * Section offset in the container file (in bytes)
+		 */
+		unsigned long long _offset;
+
+		/**
+		 * Section size (in bytes)
+		 */
+		unsigned long long _size;
+	};
+
+	/**
+	 * Description of a file to store in a container
+	 */
+	struct SectionFile
+	{
+		/**
+		 * Section type
+		 */
+		ESectionType _type;
+
+		/**
+		 * Level of resolution
+		 */
+		unsigned int _level;
+
+		/**
+		 * Channel index (brick sections only)
+		 */
+		unsigned int _channel;
+
+		/**
+		 * File name
+		 */
+		std::string _fileName;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvDataContainer();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvDataContainer();
+
+	/**
+	 * Open a container file and read its header block
+	 *
+	 * @param pFileName the container file name
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool open( const std::string& pFileName );
+
+	/**
+	 * Close the container (and unmap it if it has been mapped)
+	 */
+	void close();
+
+	/**
+	 * Tell wheter or not the container is open
+	 *
+	 * @return a flag telling wheter or not the container is open
+	 */
+	bool isOpen() const;
+
+	/**
+	 * Get the dataset name
+	 *
+	 * @return the dataset name
+	 */
+	const std::string& getName() const;
+
+	/**
+	 * Get the brick resolution (without borders)
+	 *
+	 * @return the brick resolution
+	 */
+	unsigned int getBrickResolution() const;
+
+	/**
+	 * Get the brick border size
+	 *
+	 * @return the brick border size
+	 */
+	unsigned int getBorderSize() const;
+
+	/**
+	 * Get the number of levels of resolution
+	 *
+	 * @return the number of levels of resolution
+	 */
+	unsigned int getNbLevels() const;
+
+	/**
+	 * Get the data channels
+	 *
+	 * @return the data channels
+	 */
+	const std::vector< Channel >& getChannels() const;
+
+	/**
+	 * Get the sections
+	 *
+	 * @return the sections
+	 */
+	const std::vector< Section >& getSections() const;
+
+	/**
+	 * Find a section
+	 *
+	 * @param pType section type
+	 * @param pLevel level of resolution
+	 * @param pChannel channel index (brick sections only)
+	 *
+	 * @return the section, or NULL if the container has no such section
+	 */
+	const Section* findSection( ESectionType pType, unsigned int pLevel, unsigned int pChannel = 0 ) const;
+
+	/**
+	 * Read data of a section
+	 *
+	 * @param pSection the section
+	 * @param pOffset offset in the section (in bytes)
+	 * @param pData the buffer in which data is read
+	 * @param pSize number of bytes to read
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool read( const Section& pSection, unsigned long long pOffset, void* pData, size_t pSize ) const;
+
+	/**
+	 * Map the whole container file in memory (read-only).
+	 * Sections are then available at getMappedData() + section offset.
+	 *
+	 * @return a flag telling wheter or not it succeeds (mapping is not available on all platforms)
+	 */
+	bool map();
+
+	/**
+	 * Get the mapped container file
+	 *
+	 * @return the mapped container file, or NULL if the container is not mapped
+	 */
+	const unsigned char* getMappedData() const;
+
+	/**
+	 * Tell wheter or not a file name is the one of a container file (".gvc" extension)
+	 *
+	 * @param pFileName a file name
+	 *
+	 * @return a flag telling wheter or not the file name is the one of a container file
+	 */
+	static bool isContainerFileName( const std::string& pFileName );
+
+	/**
+	 * Write a container file
+	 *
+	 * @param pFileName the container file name
+	 * @param pName the dataset name
+	 * @param pBrickResolution brick resolution (without borders)
+	 * @param pBorderSize brick border size
+	 * @param pNbLevels number of levels of resolution
+	 * @param pChannels data channels
+	 * @param pFiles files to store in the container (their content is copied)
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	static bool write( const std::string& pFileName, const std::string& pName,
+					unsigned int pBrickResolution, unsigned int pBorderSize, unsigned int pNbLevels,
+					const std::vector< Channel >& pChannels, const std::vector< SectionFile >& pFiles );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * File header, as stored at the beginning of a container file.
+	 * It is followed by the channel and section entries, in the same header block.
+	 * Its size is 128 bytes, so that section entries are 8 bytes aligned.
+	 */
+	struct FileHeader
+	{
+		char _magic[ 8 ];
+		unsigned int _version;
+		unsigned int _pageSize;
+		unsigned int _headerBlockSize;
+		unsigned int _brickResolution;
+		unsigned int _borderSize;
+		unsigned int _nbLevels;
+		unsigned int _nbChannels;
+		unsigned int _nbSections;
+		unsigned int _reserved[ 6 ];
+		char _name[ GV_DATA_CONTAINER_NAME_SIZE ];
+	};
+
+	/**
+	 * Channel entry, as stored in the header block
+	 */
+	struct ChannelEntry
+	{
+		char _name[ GV_DATA_CONTAINER_CHANNEL_NAME_SIZE ];
+		char _typeName[ GV_DATA_CONTAINER_CHANNEL_NAME_SIZE ];
+	};
+
+	/**
+	 * Section entry, as stored in the header block
+	 */
+	struct SectionEntry
+	{
+		unsigned int _type;
+		unsigned int _level;
+		unsigned int _channel;
+		unsigned int _reserved;
+		unsigned long long _offset;
+		unsigned long long _size;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Container file
+	 */
+	FILE* _file;
+
+	/**
+	 * Container file size (in bytes)
+	 */
+	unsigned long long _fileSize;
+
+	/**
+	 * Mapped container file (NULL if not mapped)
+	 */
+	unsigned char* _mappedData;
+
+	/**
+	 * Dataset name
+	 */
+	std::string _name;
+
+	/**
+	 * Brick resolution (without borders)
+	 */
+	unsigned int _brickResolution;
+
+	/**
+	 * Brick border size
+	 */
+	unsigned int _borderSize;
+
+	/**
+	 * Number of levels of resolution
+	 */
+	unsigned int _nbLevels;
+
+	/**
+	 * Data channels
+	 */
+	std::vector< Channel > _channels;
+
+	/**
+	 * Sections
+	 */
+	std::vector< Section > _sections;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Parse the header block of a container file
+	 *
+	 * @param pHeaderBlock the header block
+	 * @param pSize size of the header block (in bytes)
+	 *
+	 * @return a flag telling wheter or not the header block is valid
+	 */
+	bool parseHeaderBlock( const unsigned char* pHeaderBlock, size_t pSize );
+
+	/**
+	 * Move the file position of a file stream (64 bits offset)
+	 *
+	 * @param pFile the file stream
+	 * @param pOffset the offset from the beginning of the file (in bytes)
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	static bool seek( FILE* pFile, unsigned long long pOffset );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvDataContainer( const GvDataContainer& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvDataContainer& operator=( const GvDataContainer& );
+
+};
+
+}
+
+#endif
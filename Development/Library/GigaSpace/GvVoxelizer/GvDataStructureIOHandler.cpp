@@ -459,6 +459,15 @@ void GvDataStructureIOHandler::saveNodeandBrick()
 		fwrite( &_nodeBuffer, sizeof(unsigned int), 1, _nodeFile );
 		fflush( _nodeFile );
 
+		// An empty node has no brick : its offset would point to the first brick of the file,
+		// so read-only accesses to empty nodes (getNode(), getBrick(), etc...) must not write anything.
+		if ( isEmpty( _nodeBuffer ) )
+		{
+			_isBufferLoaded = false;
+
+			return;
+		}
+
 		// Retrieve the brick offset in brick file
 		unsigned int brickOffset = getBrickOffset( _nodeBuffer );
 		// Iterate through data channels
@@ -491,130 +500,140 @@ void GvDataStructureIOHandler::computeBorders()
 	// Iterate trough data ytpes
 	for ( unsigned int c = 0; c < _dataTypes.size(); ++c )
 	{
-		// Create two brick buffers
-		void* brick = GvDataTypeHandler::allocateVoxels( _dataTypes[ c ], _brickSize );
-		void* brick2 = GvDataTypeHandler::allocateVoxels( _dataTypes[ c ], _brickSize );
+		computeBorders( c );
+	}
+}
 
-		// Iterate trough nodes of the data structure
-		for ( unsigned int k = 0; k < _nodeGridSize; ++k )
-		for ( unsigned int j = 0; j < _nodeGridSize; ++j )
-		{
-			// LOG message
-			std::cout << "computeBorders - Node : [ " << "x" << " / " << j << " / " << k << " ] - " << _nodeGridSize << " - channel [ " << c << " / " << _dataTypes.size() << " ]" << std::endl;
-		
-		for ( unsigned int i = 0; i < _nodeGridSize; ++i )
+/******************************************************************************
+ * Fill all brick borders of a data channel of the data strucuture with data.
+ *
+ * @param pDataChannel data channel index
+ ******************************************************************************/
+void GvDataStructureIOHandler::computeBorders( unsigned int pDataChannel )
+{
+	// Create two brick buffers
+	void* brick = GvDataTypeHandler::allocateVoxels( _dataTypes[ pDataChannel ], _brickSize );
+	void* brick2 = GvDataTypeHandler::allocateVoxels( _dataTypes[ pDataChannel ], _brickSize );
+
+	// Iterate trough nodes of the data structure
+	for ( unsigned int k = 0; k < _nodeGridSize; ++k )
+	for ( unsigned int j = 0; j < _nodeGridSize; ++j )
+	{
+		// LOG message
+		std::cout << "computeBorders - Node : [ " << "x" << " / " << j << " / " << k << " ] - " << _nodeGridSize << " - channel [ " << pDataChannel << " / " << _dataTypes.size() << " ]" << std::endl;
+	
+	for ( unsigned int i = 0; i < _nodeGridSize; ++i )
+	{
+		// Store current node position
+		unsigned int nodePos[ 3 ];
+		nodePos[ 0 ] = i;
+		nodePos[ 1 ] = j;
+		nodePos[ 2 ] = k;
+
+		// Retrieve the associated node info
+		unsigned int node = getNode( nodePos );
+
+		// If node is empty, there is nothing to do, so go to next node
+		if ( isEmpty( node ) )
 		{
-			// Store current node position
-			unsigned int nodePos[ 3 ];
-			nodePos[ 0 ] = i;
-			nodePos[ 1 ] = j;
-			nodePos[ 2 ] = k;
+			continue;
+		}
 
-			// Retrieve the associated node info
-			unsigned int node = getNode( nodePos );
+		// Retrieve the associated brick data
+		getBrick( nodePos, brick, pDataChannel );
 
-			// If node is empty, there is nothing to do, so go to next node
-			if ( isEmpty( node ) )
+		// Iterate through each neighbor nodes (in 3D, there are 26 neighbors)
+		for ( int k2 =- 1; k2 <= 1; ++k2 )
+		for ( int j2 =- 1; j2 <= 1; ++j2 )
+		for ( int i2 =- 1; i2 <= 1; ++i2 )
+		{
+			// Check the current neighbor node position.
+			// If it is outside the data structure bounds,
+			// there is nothing to do, so go to next neighbor node.
+			if ( i + i2 < 0 || i + i2 >= _nodeGridSize ||
+				j + j2 < 0 || j + j2 >= _nodeGridSize ||
+				k + k2 < 0 || k + k2 >= _nodeGridSize )
 			{
 				continue;
 			}
 
-			// Retrieve the associated brick data
-			getBrick( nodePos, brick, c );
-
-			// Iterate through each neighbor nodes (in 3D, there are 26 neighbors)
-			for ( int k2 =- 1; k2 <= 1; ++k2 )
-			for ( int j2 =- 1; j2 <= 1; ++j2 )
-			for ( int i2 =- 1; i2 <= 1; ++i2 )
-			{
-				// Check the current neighbor node position.
-				// If it is outside the data structure bounds,
-				// there is nothing to do, so go to next neighbor node.
-				if ( i + i2 < 0 || i + i2 >= _nodeGridSize ||
-					j + j2 < 0 || j + j2 >= _nodeGridSize ||
-					k + k2 < 0 || k + k2 >= _nodeGridSize )
-				{
-					continue;
-				}
-
-				// Store current neighbor node position
-				unsigned int nodePos2[ 3 ];
-				nodePos2[ 0 ] = i + i2;
-				nodePos2[ 1 ] = j + j2;
-				nodePos2[ 2 ] = k + k2;
+			// Store current neighbor node position
+			unsigned int nodePos2[ 3 ];
+			nodePos2[ 0 ] = i + i2;
+			nodePos2[ 1 ] = j + j2;
+			nodePos2[ 2 ] = k + k2;
 
-				// Retrieve the associated neighbor node info
-				unsigned int node2 = getNode( nodePos2 );
+			// Retrieve the associated neighbor node info
+			unsigned int node2 = getNode( nodePos2 );
 
-				// If node is empty :
-				// there is nothing to do, so go to next neighbor node
-				if ( isEmpty( node2 ) )
-				{
-					continue;
-				}
+			// If node is empty :
+			// there is nothing to do, so go to next neighbor node
+			if ( isEmpty( node2 ) )
+			{
+				continue;
+			}
 
-				// Retrieve the associated neighbor brick data
-				getBrick( nodePos2, brick2, c );
+			// Retrieve the associated neighbor brick data
+			getBrick( nodePos2, brick2, pDataChannel );
 
-				// In this part, the goal is to copy voxel data from original brick to voxel data
-				// of the current neighbor brick if it is on a border.
-				// For this, we use a flag telling that data has been modified in the neighbor brick.
-				bool modified = false;
+			// In this part, the goal is to copy voxel data from original brick to voxel data
+			// of the current neighbor brick if it is on a border.
+			// For this, we use a flag telling that data has been modified in the neighbor brick.
+			bool modified = false;
 
-				// Iterate through voxels of the brick
-				for ( unsigned int z = 1; z < _brickWidth + 1; ++z )
-				for ( unsigned int y = 1; y < _brickWidth + 1; ++y )
-				for ( unsigned int x = 1; x < _brickWidth + 1; ++x )
-				{
-					// Store the voxel position of the neighbor brick
-					int x2 = (-i2) * (_brickWidth) + x;
-					int y2 = (-j2) * (_brickWidth) + y;
-					int z2 = (-k2) * (_brickWidth) + z;
-
-						// Check if ( HYPOTHESIS_1 && HYPOTHESIS_2 ) is true.
-						// If yes, it means that this voxel is in the border of the neighbor brick
-						// and we have to copy voxel data of the current brick
-						// to the voxel of the neighbor brick
-						if ( /*HYPOTHESIS_1*/( x2==0 || x2==_brickWidth+1 || 
-							y2==0 || y2==_brickWidth+1 || 
-							z2==0 || z2==_brickWidth+1 )
-							&& /*HYPOTHESIS_2*/ ( x2 >= 0 && x2 <= static_cast< int >( _brickWidth ) + 1 
-							&& y2 >= 0 && y2 <= static_cast< int >( _brickWidth ) + 1 
-							&& z2 >= 0 && z2 <= static_cast< int >( _brickWidth ) + 1 ) )
+			// Iterate through voxels of the brick
+			for ( unsigned int z = 1; z < _brickWidth + 1; ++z )
+			for ( unsigned int y = 1; y < _brickWidth + 1; ++y )
+			for ( unsigned int x = 1; x < _brickWidth + 1; ++x )
+			{
+				// Store the voxel position of the neighbor brick
+				int x2 = (-i2) * (_brickWidth) + x;
+				int y2 = (-j2) * (_brickWidth) + y;
+				int z2 = (-k2) * (_brickWidth) + z;
+
+					// Check if ( HYPOTHESIS_1 && HYPOTHESIS_2 ) is true.
+					// If yes, it means that this voxel is in the border of the neighbor brick
+					// and we have to copy voxel data of the current brick
+					// to the voxel of the neighbor brick
+					if ( /*HYPOTHESIS_1*/( x2==0 || x2==_brickWidth+1 || 
+						y2==0 || y2==_brickWidth+1 || 
+						z2==0 || z2==_brickWidth+1 )
+						&& /*HYPOTHESIS_2*/ ( x2 >= 0 && x2 <= static_cast< int >( _brickWidth ) + 1 
+						&& y2 >= 0 && y2 <= static_cast< int >( _brickWidth ) + 1 
+						&& z2 >= 0 && z2 <= static_cast< int >( _brickWidth ) + 1 ) )
+					{
+						// Copy voxel data from original brick to "border" voxel of current neighbor brick
+
+						/*for( unsigned int d = 0; d < components[ c ]; ++d )
 						{
-							// Copy voxel data from original brick to "border" voxel of current neighbor brick
-
-							/*for( unsigned int d = 0; d < components[ c ]; ++d )
-							{
-								brick2[(x2 + (brickWidth+2)*(y2 + (brickWidth+2)*z2))*components[c] + d] =
-									brick[(x + (brickWidth+2)*(y + (brickWidth+2)*z))*components[c] + d];
-							}*/
-							memcpy(
-									/*destination*/GvDataTypeHandler::getAddress( _dataTypes[ c ], brick2, x2 + ( _brickWidth + 2 ) * ( y2 + ( _brickWidth + 2 ) * z2 ) ),
-									/*source*/GvDataTypeHandler::getAddress( _dataTypes[ c ], brick , x  + ( _brickWidth + 2 ) * ( y  + ( _brickWidth + 2 ) * z ) ),
-									/*size*/GvDataTypeHandler::canalByteSize( _dataTypes[ c ] )
-							);
-
-							// Update the flag telling that data has been modified in the neighbor brick.
-							modified = true;
-						}
-				}
+							brick2[(x2 + (brickWidth+2)*(y2 + (brickWidth+2)*z2))*components[c] + d] =
+								brick[(x + (brickWidth+2)*(y + (brickWidth+2)*z))*components[c] + d];
+						}*/
+						memcpy(
+								/*destination*/GvDataTypeHandler::getAddress( _dataTypes[ pDataChannel ], brick2, x2 + ( _brickWidth + 2 ) * ( y2 + ( _brickWidth + 2 ) * z2 ) ),
+								/*source*/GvDataTypeHandler::getAddress( _dataTypes[ pDataChannel ], brick , x  + ( _brickWidth + 2 ) * ( y  + ( _brickWidth + 2 ) * z ) ),
+								/*size*/GvDataTypeHandler::canalByteSize( _dataTypes[ pDataChannel ] )
+						);
+
+						// Update the flag telling that data has been modified in the neighbor brick.
+						modified = true;
+					}
+			}
 
-				// If the brick data has been modified, copy the data to the neighbor brick buffer
-				if ( modified )
-				{
-					setBrick( nodePos2, brick2, c );
-				}
+			// If the brick data has been modified, copy the data to the neighbor brick buffer
+			if ( modified )
+			{
+				setBrick( nodePos2, brick2, pDataChannel );
 			}
 		}
-		}
+	}
+	}
 
-		// Free memory of the two brick data buffers
+	// Free memory of the two brick data buffers
                 operator delete( brick );
                 operator delete( brick2 );
 //		delete [] brick;
 //		delete [] brick2;
-	}
 }
 
 /******************************************************************************
@@ -749,6 +768,37 @@ string GvDataStructureIOHandler::getFileNameBrick( const string& pName, unsigned
 	return oss.str();
 }
 
+/******************************************************************************
+ * Retrieve the node summary file name.
+ * An example of GigaVoxels node summary file could be : "fux_BR8_B1_L0.summary"
+ * where "fux" is the name, "8" is the brick width BR, "1" is the brick border size B,
+ * "0" is the level of resolution L and "summary" is the file extension.
+ *
+ * @param pName name of the data file
+ * @param pLevel data structure level of resolution
+ * @param pBrickWidth width of bricks
+ *
+ * @return the node summary file name in GigaVoxels format.
+ ******************************************************************************/
+string GvDataStructureIOHandler::getFileNameSummary( const std::string& pName, unsigned int pLevel, unsigned int pBrickWidth )
+{
+	std::ostringstream oss;
+
+	oss << pName << "_BR" << pBrickWidth << "_B1_L" << pLevel << ".summary";
+
+	return oss.str();
+}
+
+/******************************************************************************
+ * Get the list of data types associated to the data structure channels
+ *
+ * @return the list of data types
+ ******************************************************************************/
+const vector< GvDataTypeHandler::VoxelDataType >& GvDataStructureIOHandler::getDataTypes() const
+{
+	return _dataTypes;
+}
+
 /******************************************************************************
  * Tell wheter or not a node is empty given its node info.
  *
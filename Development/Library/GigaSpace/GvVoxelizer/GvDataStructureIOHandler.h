@@ -255,6 +255,13 @@ public:
 	 */
 	void computeBorders();
 
+	/**
+	 * Fill all brick borders of a data channel of the data strucuture with data.
+	 *
+	 * @param pDataChannel data channel index
+	 */
+	void computeBorders( unsigned int pDataChannel );
+
 	/**
 	 * Tell wheter or not a node is empty given its node info.
 	 *
@@ -263,7 +270,28 @@ public:
 	 * @return a flag telling wheter or not a node is empty
 	 */
 	static bool isEmpty( unsigned int pNode );
-	
+
+	/**
+	 * Get the list of data types associated to the data structure channels
+	 *
+	 * @return the list of data types
+	 */
+	const std::vector< GvDataTypeHandler::VoxelDataType >& getDataTypes() const;
+
+	/**
+	 * Retrieve the node summary file name.
+	 * An example of GigaVoxels node summary file could be : "fux_BR8_B1_L0.summary"
+	 * where "fux" is the name, "8" is the brick width BR, "1" is the brick border size B,
+	 * "0" is the level of resolution L and "summary" is the file extension.
+	 *
+	 * @param pName name of the data file
+	 * @param pLevel data structure level of resolution
+	 * @param pBrickWidth width of bricks
+	 *
+	 * @return the node summary file name in GigaVoxels format.
+	 */
+	static std::string getFileNameSummary( const std::string& pName, unsigned int pLevel, unsigned int pBrickWidth );
+
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
 	 **************************************************************************/
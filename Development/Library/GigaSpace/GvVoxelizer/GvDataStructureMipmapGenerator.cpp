@@ -33,6 +33,7 @@
 // GigaVoxels
 #include "GvVoxelizer/GvDataTypeHandler.h"
 #include "GvVoxelizer/GvDataStructureIOHandler.h"
+#include "GvVoxelizer/GvDataStructureSummaryGenerator.h"
 
 // STL
 #include <vector>
@@ -110,6 +111,13 @@ bool GvDataStructureMipmapGenerator::generateMipmapPyramid( const std::string& p
 	GvDataStructureIOHandler* dataStructureIOHandlerUP = new GvDataStructureIOHandler( filename, levelOfResolution, brickWidth, dataTypes, false );
 	GvDataStructureIOHandler* dataStructureIOHandlerDOWN = NULL;
 
+	// Node summaries are generated along the pyramid, from the finest level,
+	// so that min/max values and homogeneity are propagated over subtrees.
+	std::vector< GvNodeSummary > summariesUP;
+	std::vector< GvNodeSummary > summariesDOWN;
+	GvDataStructureSummaryGenerator::generateSummaries( *dataStructureIOHandlerUP, NULL, summariesUP );
+	GvDataStructureSummaryGenerator::writeSummaryFile( GvDataStructureIOHandler::getFileNameSummary( filename, levelOfResolution, brickWidth ), summariesUP );
+
 	// Iterate through levels of resolution
 	for ( int level = levelOfResolution - 1; level >= 0; level-- )
 	{
@@ -215,6 +223,11 @@ bool GvDataStructureMipmapGenerator::generateMipmapPyramid( const std::string& p
 
 		// Generate the border data of the coarser scene
 		dataStructureIOHandlerDOWN->computeBorders();
+
+		// Generate the node summaries of the coarser scene
+		GvDataStructureSummaryGenerator::generateSummaries( *dataStructureIOHandlerDOWN, &summariesUP, summariesDOWN );
+		GvDataStructureSummaryGenerator::writeSummaryFile( GvDataStructureIOHandler::getFileNameSummary( filename, level, brickWidth ), summariesDOWN );
+		summariesUP.swap( summariesDOWN );
 		
 		// Destroy the coarser data handler (due to memory consumption considerations)
 		delete dataStructureIOHandlerUP;
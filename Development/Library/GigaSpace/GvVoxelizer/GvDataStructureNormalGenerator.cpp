@@ -0,0 +1,806 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvVoxelizer/GvDataStructureNormalGenerator.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvVoxelizer/GvDataStructureIOHandler.h"
+
+// STL
+#include <iostream>
+#include <algorithm>
+
+// System
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#ifndef WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+// SIMD
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define GV_DATA_STRUCTURE_NORMAL_GENERATOR_USE_SSE2
+	#include <emmintrin.h>
+#endif
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GvVoxelizer
+using namespace GvVoxelizer;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Component of the uchar4 data channel holding the density
+ */
+static const unsigned int cDensityComponent = 3;
+
+/**
+ * Max number of bricks read before their normals are computed
+ */
+static const unsigned int cMaxNbBricksPerBatch = 1024;
+
+/**
+ * Min number of bricks processed by a thread
+ */
+static const unsigned int cMinNbBricksPerThread = 16;
+
+/**
+ * Max number of taps of a gradient operator along an axis
+ */
+static const unsigned int cMaxNbTaps = 9;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+namespace
+{
+
+/******************************************************************************
+ * Quantize an octahedral coordinate in [-1;1] on 16 bits
+ *
+ * @param pValue the octahedral coordinate
+ *
+ * @return the quantized coordinate
+ ******************************************************************************/
+inline unsigned short quantizeOctahedral( float pValue )
+{
+	return static_cast< unsigned short >( static_cast< int >( pValue * 32767.5f + 32768.f ) );
+}
+
+/******************************************************************************
+ * Sign of a value (1 for zero)
+ *
+ * @param pValue the value
+ *
+ * @return -1 or 1
+ ******************************************************************************/
+inline float signNotNull( float pValue )
+{
+	return ( pValue < 0.f ) ? -1.f : 1.f;
+}
+
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvDataStructureNormalGenerator::GvDataStructureNormalGenerator()
+:	_gradientOperator( eCentralDifference )
+,	_normalEncoding( eOctahedral )
+,	_nbThreads( 1 )
+,	_isSIMDUsed( true )
+,	_brickWidth( 0 )
+,	_nodeGridSize( 0 )
+,	_densityBricks()
+,	_normalBricks()
+,	_nodePositions()
+,	_scratch()
+{
+#ifndef WIN32
+	const long nbProcessors = sysconf( _SC_NPROCESSORS_ONLN );
+	_nbThreads = ( nbProcessors > 0 ) ? static_cast< unsigned int >( nbProcessors ) : 1;
+#endif
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvDataStructureNormalGenerator::~GvDataStructureNormalGenerator()
+{
+}
+
+/******************************************************************************
+ * Get the gradient operator
+ *
+ * @return the gradient operator
+ ******************************************************************************/
+GvDataStructureNormalGenerator::GradientOperator GvDataStructureNormalGenerator::getGradientOperator() const
+{
+	return _gradientOperator;
+}
+
+/******************************************************************************
+ * Set the gradient operator
+ *
+ * @param pValue the gradient operator
+ ******************************************************************************/
+void GvDataStructureNormalGenerator::setGradientOperator( GradientOperator pValue )
+{
+	_gradientOperator = pValue;
+}
+
+/******************************************************************************
+ * Get the encoding of the normal channel
+ *
+ * @return the encoding of the normal channel
+ ******************************************************************************/
+GvDataStructureNormalGenerator::NormalEncoding GvDataStructureNormalGenerator::getNormalEncoding() const
+{
+	return _normalEncoding;
+}
+
+/******************************************************************************
+ * Set the encoding of the normal channel
+ *
+ * @param pValue the encoding of the normal channel
+ ******************************************************************************/
+void GvDataStructureNormalGenerator::setNormalEncoding( NormalEncoding pValue )
+{
+	_normalEncoding = pValue;
+}
+
+/******************************************************************************
+ * Set the number of threads used to compute the normals
+ *
+ * @param pValue the number of threads
+ ******************************************************************************/
+void GvDataStructureNormalGenerator::setNbThreads( unsigned int pValue )
+{
+	_nbThreads = std::max( pValue, 1U );
+}
+
+/******************************************************************************
+ * Tell wheter or not normals are computed four voxels at a time with SSE2.
+ * The scalar path gives the same results : it is the fallback, and the reference of the SSE2 path.
+ *
+ * @param pFlag the flag telling wheter or not SSE2 is used (when available)
+ ******************************************************************************/
+void GvDataStructureNormalGenerator::useSIMD( bool pFlag )
+{
+	_isSIMDUsed = pFlag;
+}
+
+/******************************************************************************
+ * Tell wheter or not the SSE2 path is available (it depends on the compiler settings)
+ *
+ * @return a flag telling wheter or not the SSE2 path is available
+ ******************************************************************************/
+bool GvDataStructureNormalGenerator::isSIMDAvailable()
+{
+#if defined( GV_DATA_STRUCTURE_NORMAL_GENERATOR_USE_SSE2 )
+	return true;
+#else
+	return false;
+#endif
+}
+
+/******************************************************************************
+ * Get the data type of a normal channel encoding
+ *
+ * @param pEncoding the normal channel encoding (must not be eNoNormal)
+ *
+ * @return the data type of the normal channel
+ ******************************************************************************/
+GvDataTypeHandler::VoxelDataType GvDataStructureNormalGenerator::getNormalDataType( NormalEncoding pEncoding )
+{
+	return ( pEncoding == eHalf4 ) ? GvDataTypeHandler::gvHALF4 : GvDataTypeHandler::gvUSHORT2;
+}
+
+/******************************************************************************
+ * Generate the normal channel (channel 1) of all levels of resolution of a data structure
+ *
+ * @param pFilename 3D model file name
+ * @param pDataResolution Data resolution
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvDataStructureNormalGenerator::generateNormals( const std::string& pFileName, unsigned int pDataResolution )
+{
+	if ( _normalEncoding == eNoNormal )
+	{
+		std::cerr << "GvDataStructureNormalGenerator::generateNormals() : no normal encoding" << std::endl;
+
+		return false;
+	}
+
+	unsigned int levelOfResolution = static_cast< unsigned int >( log( static_cast< float >( pDataResolution / 8 ) ) / log( static_cast< float >( 2 ) ) );
+	unsigned int brickWidth = 8; // TO DO : template differents size
+
+	// Density channel and normal channel
+	std::vector< GvDataTypeHandler::VoxelDataType > dataTypes;
+	dataTypes.push_back( GvDataTypeHandler::gvUCHAR4 );
+	dataTypes.push_back( getNormalDataType( _normalEncoding ) );
+
+	// Iterate through levels of resolution
+	for ( int level = levelOfResolution; level >= 0; level-- )
+	{
+		// LOG info
+		std::cout << "GvDataStructureNormalGenerator::generateNormals : level : " << level << std::endl;
+
+		// Existing files are used : only the normal channel file is created
+		GvDataStructureIOHandler* dataStructureIOHandler = new GvDataStructureIOHandler( pFileName, level, brickWidth, dataTypes, false );
+		const bool result = generateNormals( *dataStructureIOHandler, 1 );
+		delete dataStructureIOHandler;
+
+		if ( ! result )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Generate the normal channel of a level of resolution of a data structure.
+ * Borders of the density channel must be up to date.
+ *
+ * @param pIOHandler the data structure level (its channel 0 is the uchar4 density channel)
+ * @param pDataChannel the normal channel index (its data type must match the normal encoding)
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvDataStructureNormalGenerator::generateNormals( GvDataStructureIOHandler& pIOHandler, unsigned int pDataChannel )
+{
+	const std::vector< GvDataTypeHandler::VoxelDataType >& dataTypes = pIOHandler.getDataTypes();
+	if ( _normalEncoding == eNoNormal || pDataChannel == 0 || pDataChannel >= dataTypes.size()
+		|| dataTypes[ 0 ] != GvDataTypeHandler::gvUCHAR4 || dataTypes[ pDataChannel ] != getNormalDataType( _normalEncoding ) )
+	{
+		std::cerr << "GvDataStructureNormalGenerator::generateNormals() : invalid data channels" << std::endl;
+
+		return false;
+	}
+
+	_brickWidth = pIOHandler._brickWidth;
+	_nodeGridSize = pIOHandler._nodeGridSize;
+
+	// Allocate the batch and the scratch memory of the tasks (densities of a brick, then gradients of its voxels)
+	const unsigned int nbVoxels = _brickWidth * _brickWidth * _brickWidth;
+	_densityBricks.resize( static_cast< size_t >( cMaxNbBricksPerBatch ) * pIOHandler._brickSize * GvDataTypeHandler::canalByteSize( dataTypes[ 0 ] ) );
+	_normalBricks.resize( static_cast< size_t >( cMaxNbBricksPerBatch ) * pIOHandler._brickSize * GvDataTypeHandler::canalByteSize( dataTypes[ pDataChannel ] ) );
+	_nodePositions.clear();
+	_scratch.resize( static_cast< size_t >( _nbThreads ) * ( pIOHandler._brickSize + 3 * nbVoxels ) );
+
+	// Iterate through nodes of the structure : bricks are read by batches, whose normals are computed by several threads
+	unsigned int nodePos[ 3 ];
+	for ( nodePos[ 2 ] = 0; nodePos[ 2 ] < _nodeGridSize; nodePos[ 2 ]++ )
+	for ( nodePos[ 1 ] = 0; nodePos[ 1 ] < _nodeGridSize; nodePos[ 1 ]++ )
+	for ( nodePos[ 0 ] = 0; nodePos[ 0 ] < _nodeGridSize; nodePos[ 0 ]++ )
+	{
+		// If node is empty, go to next node
+		if ( GvDataStructureIOHandler::isEmpty( pIOHandler.getNode( nodePos ) ) )
+		{
+			continue;
+		}
+
+		const size_t brick = _nodePositions.size() / 3;
+		pIOHandler.getBrick( nodePos, &_densityBricks[ brick * pIOHandler._brickSize * GvDataTypeHandler::canalByteSize( dataTypes[ 0 ] ) ], 0 );
+		_nodePositions.insert( _nodePositions.end(), nodePos, nodePos + 3 );
+
+		if ( brick + 1 == cMaxNbBricksPerBatch )
+		{
+			processBatch( pIOHandler, pDataChannel );
+		}
+	}
+	processBatch( pIOHandler, pDataChannel );
+
+	// Fill the borders of the normal bricks with the normals of their neighbors
+	pIOHandler.computeBorders( pDataChannel );
+
+	return true;
+}
+
+/******************************************************************************
+ * Compute the normals of the bricks of the batch, and write them in the data structure
+ *
+ * @param pIOHandler the data structure level
+ * @param pDataChannel the normal channel index
+ ******************************************************************************/
+void GvDataStructureNormalGenerator::processBatch( GvDataStructureIOHandler& pIOHandler, unsigned int pDataChannel )
+{
+	const unsigned int nbBricks = static_cast< unsigned int >( _nodePositions.size() / 3 );
+	if ( nbBricks == 0 )
+	{
+		return;
+	}
+
+	// Bricks are shared between threads
+	const unsigned int nbTasks = std::max( std::min( _nbThreads, nbBricks / cMinNbBricksPerThread ), 1U );
+	const size_t scratchSize = _scratch.size() / _nbThreads;
+
+	std::vector< Task > tasks( nbTasks );
+	for ( unsigned int i = 0; i < nbTasks; i++ )
+	{
+		tasks[ i ]._generator = this;
+		tasks[ i ]._first = static_cast< unsigned int >( static_cast< size_t >( nbBricks ) * i / nbTasks );
+		tasks[ i ]._end = static_cast< unsigned int >( static_cast< size_t >( nbBricks ) * ( i + 1 ) / nbTasks );
+		tasks[ i ]._scratch = &_scratch[ i * scratchSize ];
+	}
+	runTasks( tasks );
+
+	// Write the normal bricks
+	const size_t normalBrickSize = pIOHandler._brickSize * GvDataTypeHandler::canalByteSize( pIOHandler.getDataTypes()[ pDataChannel ] );
+	for ( unsigned int i = 0; i < nbBricks; i++ )
+	{
+		pIOHandler.setBrick( &_nodePositions[ 3 * i ], &_normalBricks[ i * normalBrickSize ], pDataChannel );
+	}
+
+	_nodePositions.clear();
+}
+
+/******************************************************************************
+ * Compute the normals of the bricks of a task
+ *
+ * @param pTask the task
+ ******************************************************************************/
+void GvDataStructureNormalGenerator::computeNormals( const Task& pTask )
+{
+	const size_t brickSize = ( _brickWidth + 2 ) * ( _brickWidth + 2 ) * ( _brickWidth + 2 );
+	const size_t densityBrickSize = brickSize * GvDataTypeHandler::canalByteSize( GvDataTypeHandler::gvUCHAR4 );
+	const size_t normalBrickSize = brickSize * GvDataTypeHandler::canalByteSize( getNormalDataType( _normalEncoding ) );
+
+	for ( unsigned int i = pTask._first; i < pTask._end; i++ )
+	{
+		computeBrickNormals( &_densityBricks[ i * densityBrickSize ], &_nodePositions[ 3 * i ], pTask._scratch, &_normalBricks[ i * normalBrickSize ] );
+	}
+}
+
+/******************************************************************************
+ * Compute the normals of a brick
+ *
+ * @param pDensityBrick the density brick (uchar4, with borders)
+ * @param pNodePos the node position of the brick
+ * @param pScratch scratch memory
+ * @param pNormalBrick the normal brick (with borders)
+ ******************************************************************************/
+void GvDataStructureNormalGenerator::computeBrickNormals( const unsigned char* pDensityBrick, const unsigned int pNodePos[ 3 ], float* pScratch, unsigned char* pNormalBrick ) const
+{
+	const int width = static_cast< int >( _brickWidth );
+	const int size = width + 2;
+	const int strides[ 3 ] = { 1, size, size * size };
+	const unsigned int brickSize = static_cast< unsigned int >( size * size * size );
+	const unsigned int nbVoxels = _brickWidth * _brickWidth * _brickWidth;
+
+	float* densities = pScratch;
+	float* gradients[ 3 ] = { pScratch + brickSize, pScratch + brickSize + nbVoxels, pScratch + brickSize + 2 * nbVoxels };
+
+	// Densities in [ 0 ; 1 ]
+	for ( unsigned int i = 0; i < brickSize; i++ )
+	{
+		densities[ i ] = static_cast< float >( pDensityBrick[ 4 * i + cDensityComponent ] ) * ( 1.f / 255.f );
+	}
+
+	// The volume is clamped at its bounds : the borders of the bricks on the bounds hold no data.
+	// Axes are clamped one after the other, so that edges and corners are clamped too.
+	for ( unsigned int axis = 0; axis < 3; axis++ )
+	{
+		const bool isFirst = ( pNodePos[ axis ] == 0 );
+		const bool isLast = ( pNodePos[ axis ] + 1 == _nodeGridSize );
+		if ( ! isFirst && ! isLast )
+		{
+			continue;
+		}
+		for ( unsigned int i = 0; i < brickSize; i++ )
+		{
+			const int coordinate = ( static_cast< int >( i ) / strides[ axis ] ) % size;
+			if ( isFirst && coordinate == 0 )
+			{
+				densities[ i ] = densities[ i + strides[ axis ] ];
+			}
+			else if ( isLast && coordinate == size - 1 )
+			{
+				densities[ i ] = densities[ i - strides[ axis ] ];
+			}
+		}
+	}
+
+	// Taps of the gradient operator along each axis : offset of the pair of neighbors, and weight of their difference.
+	// The Sobel operator smoothes the differences with [ 1 2 1 ] along the two other axes.
+	int tapOffsets[ 3 ][ cMaxNbTaps ];
+	float tapWeights[ cMaxNbTaps ];
+	unsigned int nbTaps = 0;
+	if ( _gradientOperator == eSobel )
+	{
+		for ( int b = -1; b <= 1; b++ )
+		{
+			for ( int a = -1; a <= 1; a++ )
+			{
+				tapOffsets[ 0 ][ nbTaps ] = a * strides[ 1 ] + b * strides[ 2 ];
+				tapOffsets[ 1 ][ nbTaps ] = a * strides[ 0 ] + b * strides[ 2 ];
+				tapOffsets[ 2 ][ nbTaps ] = a * strides[ 0 ] + b * strides[ 1 ];
+				tapWeights[ nbTaps ] = static_cast< float >( ( 2 - abs( a ) ) * ( 2 - abs( b ) ) ) / 32.f;
+				nbTaps++;
+			}
+		}
+	}
+	else
+	{
+		tapOffsets[ 0 ][ 0 ] = 0;
+		tapOffsets[ 1 ][ 0 ] = 0;
+		tapOffsets[ 2 ][ 0 ] = 0;
+		tapWeights[ 0 ] = 0.5f;
+		nbTaps = 1;
+	}
+
+	// Gradients of the voxels of the brick, along rows of voxels
+	for ( int z = 0; z < width; z++ )
+	{
+		for ( int y = 0; y < width; y++ )
+		{
+			const float* row = densities + 1 + strides[ 1 ] * ( y + 1 ) + strides[ 2 ] * ( z + 1 );
+			const unsigned int rowIndex = static_cast< unsigned int >( width * ( y + width * z ) );
+
+			int x = 0;
+#if defined( GV_DATA_STRUCTURE_NORMAL_GENERATOR_USE_SSE2 )
+			for ( ; _isSIMDUsed && x + 4 <= width; x += 4 )
+			{
+				for ( unsigned int axis = 0; axis < 3; axis++ )
+				{
+					__m128 gradient = _mm_setzero_ps();
+					for ( unsigned int t = 0; t < nbTaps; t++ )
+					{
+						const float* neighbors = row + x + tapOffsets[ axis ][ t ];
+						const __m128 difference = _mm_sub_ps( _mm_loadu_ps( neighbors + strides[ axis ] ), _mm_loadu_ps( neighbors - strides[ axis ] ) );
+						gradient = _mm_add_ps( gradient, _mm_mul_ps( _mm_set1_ps( tapWeights[ t ] ), difference ) );
+					}
+					_mm_storeu_ps( gradients[ axis ] + rowIndex + x, gradient );
+				}
+			}
+#endif
+			for ( ; x < width; x++ )
+			{
+				for ( unsigned int axis = 0; axis < 3; axis++ )
+				{
+					float gradient = 0.f;
+					for ( unsigned int t = 0; t < nbTaps; t++ )
+					{
+						const float* neighbors = row + x + tapOffsets[ axis ][ t ];
+						gradient = gradient + tapWeights[ t ] * ( neighbors[ strides[ axis ] ] - neighbors[ -strides[ axis ] ] );
+					}
+					gradients[ axis ][ rowIndex + x ] = gradient;
+				}
+			}
+		}
+	}
+
+	// Encode the normals (opposite of the gradients) of the voxels of the brick
+	unsigned short* normals = reinterpret_cast< unsigned short* >( pNormalBrick );
+	const unsigned int nbComponents = ( _normalEncoding == eHalf4 ) ? 4 : 2;
+	unsigned int v = 0;
+#if defined( GV_DATA_STRUCTURE_NORMAL_GENERATOR_USE_SSE2 )
+	const __m128 signMask = _mm_set1_ps( -0.f );
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps( 1.f );
+	for ( ; _isSIMDUsed && v + 4 <= nbVoxels; v += 4 )
+	{
+		const __m128 gx = _mm_loadu_ps( gradients[ 0 ] + v );
+		const __m128 gy = _mm_loadu_ps( gradients[ 1 ] + v );
+		const __m128 gz = _mm_loadu_ps( gradients[ 2 ] + v );
+
+		float values[ 4 ][ 4 ];
+		if ( _normalEncoding == eHalf4 )
+		{
+			// Normal and gradient magnitude
+			const __m128 magnitude = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( gx, gx ), _mm_mul_ps( gy, gy ) ), _mm_mul_ps( gz, gz ) ) );
+			const __m128 scale = _mm_and_ps( _mm_div_ps( one, magnitude ), _mm_cmpgt_ps( magnitude, zero ) );
+			_mm_storeu_ps( values[ 0 ], _mm_mul_ps( _mm_xor_ps( gx, signMask ), scale ) );
+			_mm_storeu_ps( values[ 1 ], _mm_mul_ps( _mm_xor_ps( gy, signMask ), scale ) );
+			_mm_storeu_ps( values[ 2 ], _mm_mul_ps( _mm_xor_ps( gz, signMask ), scale ) );
+			_mm_storeu_ps( values[ 3 ], magnitude );
+		}
+		else
+		{
+			// Projection on the octahedron
+			const __m128 l1 = _mm_add_ps( _mm_add_ps( _mm_andnot_ps( signMask, gx ), _mm_andnot_ps( signMask, gy ) ), _mm_andnot_ps( signMask, gz ) );
+			const __m128 scale = _mm_and_ps( _mm_div_ps( one, l1 ), _mm_cmpgt_ps( l1, zero ) );
+			__m128 px = _mm_mul_ps( _mm_xor_ps( gx, signMask ), scale );
+			__m128 py = _mm_mul_ps( _mm_xor_ps( gy, signMask ), scale );
+			const __m128 pz = _mm_mul_ps( _mm_xor_ps( gz, signMask ), scale );
+
+			// The lower half is folded over the upper one
+			const __m128 isLower = _mm_cmplt_ps( pz, zero );
+			const __m128 signX = _mm_or_ps( _mm_and_ps( _mm_cmplt_ps( px, zero ), signMask ), one );
+			const __m128 signY = _mm_or_ps( _mm_and_ps( _mm_cmplt_ps( py, zero ), signMask ), one );
+			const __m128 foldedX = _mm_mul_ps( _mm_sub_ps( one, _mm_andnot_ps( signMask, py ) ), signX );
+			const __m128 foldedY = _mm_mul_ps( _mm_sub_ps( one, _mm_andnot_ps( signMask, px ) ), signY );
+			px = _mm_or_ps( _mm_and_ps( isLower, foldedX ), _mm_andnot_ps( isLower, px ) );
+			py = _mm_or_ps( _mm_and_ps( isLower, foldedY ), _mm_andnot_ps( isLower, py ) );
+
+			// Quantization
+			const __m128 quantizationScale = _mm_set1_ps( 32767.5f );
+			const __m128 quantizationBias = _mm_set1_ps( 32768.f );
+			_mm_storeu_ps( values[ 0 ], _mm_add_ps( _mm_mul_ps( px, quantizationScale ), quantizationBias ) );
+			_mm_storeu_ps( values[ 1 ], _mm_add_ps( _mm_mul_ps( py, quantizationScale ), quantizationBias ) );
+		}
+
+		for ( unsigned int i = 0; i < 4; i++ )
+		{
+			const unsigned int voxel = v + i;
+			const unsigned int x = voxel % _brickWidth;
+			const unsigned int y = ( voxel / _brickWidth ) % _brickWidth;
+			const unsigned int z = voxel / ( _brickWidth * _brickWidth );
+			unsigned short* normal = normals + nbComponents * ( ( x + 1 ) + strides[ 1 ] * ( y + 1 ) + strides[ 2 ] * ( z + 1 ) );
+			if ( _normalEncoding == eHalf4 )
+			{
+				normal[ 0 ] = floatToHalf( values[ 0 ][ i ] );
+				normal[ 1 ] = floatToHalf( values[ 1 ][ i ] );
+				normal[ 2 ] = floatToHalf( values[ 2 ][ i ] );
+				normal[ 3 ] = floatToHalf( values[ 3 ][ i ] );
+			}
+			else
+			{
+				normal[ 0 ] = static_cast< unsigned short >( static_cast< int >( values[ 0 ][ i ] ) );
+				normal[ 1 ] = static_cast< unsigned short >( static_cast< int >( values[ 1 ][ i ] ) );
+			}
+		}
+	}
+#endif
+	for ( ; v < nbVoxels; v++ )
+	{
+		const unsigned int x = v % _brickWidth;
+		const unsigned int y = ( v / _brickWidth ) % _brickWidth;
+		const unsigned int z = v / ( _brickWidth * _brickWidth );
+		unsigned short* normal = normals + nbComponents * ( ( x + 1 ) + strides[ 1 ] * ( y + 1 ) + strides[ 2 ] * ( z + 1 ) );
+		const float direction[ 3 ] = { -gradients[ 0 ][ v ], -gradients[ 1 ][ v ], -gradients[ 2 ][ v ] };
+		if ( _normalEncoding == eHalf4 )
+		{
+			const float magnitude = sqrtf( direction[ 0 ] * direction[ 0 ] + direction[ 1 ] * direction[ 1 ] + direction[ 2 ] * direction[ 2 ] );
+			const float scale = ( magnitude > 0.f ) ? 1.f / magnitude : 0.f;
+			normal[ 0 ] = floatToHalf( direction[ 0 ] * scale );
+			normal[ 1 ] = floatToHalf( direction[ 1 ] * scale );
+			normal[ 2 ] = floatToHalf( direction[ 2 ] * scale );
+			normal[ 3 ] = floatToHalf( magnitude );
+		}
+		else
+		{
+			encodeOctahedral( direction, normal );
+		}
+	}
+
+	// Borders are filled with the nearest voxel of the brick.
+	// Those facing a non-empty neighbor brick are then overwritten by its normals (see GvDataStructureIOHandler::computeBorders()).
+	for ( int z = 0; z < size; z++ )
+	{
+		for ( int y = 0; y < size; y++ )
+		{
+			for ( int x = 0; x < size; x++ )
+			{
+				const int nearestX = std::min( std::max( x, 1 ), width );
+				const int nearestY = std::min( std::max( y, 1 ), width );
+				const int nearestZ = std::min( std::max( z, 1 ), width );
+				if ( nearestX != x || nearestY != y || nearestZ != z )
+				{
+					memcpy( normals + nbComponents * ( x + strides[ 1 ] * y + strides[ 2 ] * z ),
+							normals + nbComponents * ( nearestX + strides[ 1 ] * nearestY + strides[ 2 ] * nearestZ ),
+							nbComponents * sizeof( unsigned short ) );
+				}
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * Encode a normal in octahedral coordinates.
+ * The normal is projected on the octahedron |x|+|y|+|z|=1, the lower half is folded
+ * over the upper one, and the coordinates in [-1;1] are quantized on 16 bits.
+ * A null normal is encoded as ( 0, 0, 1 ).
+ *
+ * @param pNormal the normal
+ * @param pResult the octahedral coordinates
+ ******************************************************************************/
+void GvDataStructureNormalGenerator::encodeOctahedral( const float pNormal[ 3 ], unsigned short pResult[ 2 ] )
+{
+	// Projection on the octahedron
+	const float l1 = fabsf( pNormal[ 0 ] ) + fabsf( pNormal[ 1 ] ) + fabsf( pNormal[ 2 ] );
+	const float scale = ( l1 > 0.f ) ? 1.f / l1 : 0.f;
+	float x = pNormal[ 0 ] * scale;
+	float y = pNormal[ 1 ] * scale;
+	const float z = pNormal[ 2 ] * scale;
+
+	// The lower half is folded over the upper one
+	if ( z < 0.f )
+	{
+		const float foldedX = ( 1.f - fabsf( y ) ) * signNotNull( x );
+		const float foldedY = ( 1.f - fabsf( x ) ) * signNotNull( y );
+		x = foldedX;
+		y = foldedY;
+	}
+
+	pResult[ 0 ] = quantizeOctahedral( x );
+	pResult[ 1 ] = quantizeOctahedral( y );
+}
+
+/******************************************************************************
+ * Decode a normal from octahedral coordinates.
+ * In a shader, with ( u, v ) the coordinates in [-1;1] : n = ( u, v, 1 - |u| - |v| ),
+ * then if n.z < 0, n.xy = ( 1 - |n.yx| ) * sign( n.xy ), and n is normalized.
+ *
+ * @param pValue the octahedral coordinates
+ * @param pResult the normal
+ ******************************************************************************/
+void GvDataStructureNormalGenerator::decodeOctahedral( const unsigned short pValue[ 2 ], float pResult[ 3 ] )
+{
+	float x = static_cast< float >( pValue[ 0 ] ) / 32767.5f - 1.f;
+	float y = static_cast< float >( pValue[ 1 ] ) / 32767.5f - 1.f;
+	const float z = 1.f - fabsf( x ) - fabsf( y );
+
+	// Unfold the lower half
+	if ( z < 0.f )
+	{
+		const float unfoldedX = ( 1.f - fabsf( y ) ) * signNotNull( x );
+		const float unfoldedY = ( 1.f - fabsf( x ) ) * signNotNull( y );
+		x = unfoldedX;
+		y = unfoldedY;
+	}
+
+	const float norm = sqrtf( x * x + y * y + z * z );
+	pResult[ 0 ] = x / norm;
+	pResult[ 1 ] = y / norm;
+	pResult[ 2 ] = z / norm;
+}
+
+/******************************************************************************
+ * Convert a float to a half float (rounded to nearest even)
+ *
+ * @param pValue the float
+ *
+ * @return the bits of the half float
+ ******************************************************************************/
+unsigned short GvDataStructureNormalGenerator::floatToHalf( float pValue )
+{
+	unsigned int bits;
+	memcpy( &bits, &pValue, sizeof( float ) );
+
+	const unsigned int sign = ( bits >> 16 ) & 0x8000;
+	const int exponent = static_cast< int >( ( bits >> 23 ) & 0xff ) - 127 + 15;
+	unsigned int mantissa = bits & 0x7fffff;
+
+	// Infinity and NaN
+	if ( ( ( bits >> 23 ) & 0xff ) == 0xff )
+	{
+		return static_cast< unsigned short >( sign | 0x7c00 | ( mantissa ? 0x200 : 0 ) );
+	}
+
+	// Overflow
+	if ( exponent >= 31 )
+	{
+		return static_cast< unsigned short >( sign | 0x7c00 );
+	}
+
+	// Denormalized half floats, and underflow
+	if ( exponent <= 0 )
+	{
+		if ( exponent < -10 )
+		{
+			return static_cast< unsigned short >( sign );
+		}
+		mantissa |= 0x800000;
+		const unsigned int shift = static_cast< unsigned int >( 14 - exponent );
+		unsigned int half = mantissa >> shift;
+		const unsigned int remainder = mantissa & ( ( 1U << shift ) - 1 );
+		const unsigned int halfway = 1U << ( shift - 1 );
+		if ( remainder > halfway || ( remainder == halfway && ( half & 1 ) ) )
+		{
+			half++;
+		}
+
+		return static_cast< unsigned short >( sign | half );
+	}
+
+	// Normalized half floats (a carry of the rounding goes to the exponent)
+	unsigned int half = ( static_cast< unsigned int >( exponent ) << 10 ) | ( mantissa >> 13 );
+	const unsigned int remainder = mantissa & 0x1fff;
+	if ( remainder > 0x1000 || ( remainder == 0x1000 && ( half & 1 ) ) )
+	{
+		half++;
+	}
+
+	return static_cast< unsigned short >( sign | half );
+}
+
+/******************************************************************************
+ * Run tasks, one thread per task
+ *
+ * @param pTasks the tasks
+ ******************************************************************************/
+void GvDataStructureNormalGenerator::runTasks( std::vector< Task >& pTasks )
+{
+#ifndef WIN32
+	std::vector< pthread_t > threads( pTasks.size() );
+	std::vector< bool > isThreadCreated( pTasks.size(), false );
+	for ( size_t i = 1; i < pTasks.size(); i++ )
+	{
+		isThreadCreated[ i ] = ( pthread_create( &threads[ i ], NULL, runTask, &pTasks[ i ] ) == 0 );
+		if ( ! isThreadCreated[ i ] )
+		{
+			runTask( &pTasks[ i ] );
+		}
+	}
+
+	// The first task is run by the calling thread
+	if ( ! pTasks.empty() )
+	{
+		runTask( &pTasks[ 0 ] );
+	}
+
+	for ( size_t i = 1; i < pTasks.size(); i++ )
+	{
+		if ( isThreadCreated[ i ] )
+		{
+			pthread_join( threads[ i ], NULL );
+		}
+	}
+#else
+	for ( size_t i = 0; i < pTasks.size(); i++ )
+	{
+		runTask( &pTasks[ i ] );
+	}
+#endif
+}
+
+/******************************************************************************
+ * Thread entry point of a task
+ *
+ * @param pTask the task
+ *
+ * @return NULL
+ ******************************************************************************/
+void* GvDataStructureNormalGenerator::runTask( void* pTask )
+{
+	Task* task = static_cast< Task* >( pTask );
+	task->_generator->computeNormals( *task );
+
+	return NULL;
+}
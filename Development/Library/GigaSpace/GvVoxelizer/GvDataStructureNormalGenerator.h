@@ -0,0 +1,412 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_DATA_STRUCTURE_NORMAL_GENERATOR_H_
+#define _GV_DATA_STRUCTURE_NORMAL_GENERATOR_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+#include "GvVoxelizer/GvDataTypeHandler.h"
+
+// STL
+#include <vector>
+#include <string>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+namespace GvVoxelizer
+{
+	class GvDataStructureIOHandler;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvVoxelizer
+{
+
+/** 
+ * @class GvDataStructureNormalGenerator
+ *
+ * @brief The GvDataStructureNormalGenerator class provides methods to precompute
+ * the normals of a scalar volume in an additional data channel.
+ *
+ * Normals are the opposite of the normalized gradient of the density (alpha component
+ * of the uchar4 data channel 0), computed with central differences or with a Sobel operator.
+ * Shaders then fetch one normal instead of sampling six neighbors of each sample.
+ *
+ * Normals are computed brick by brick : the borders of the density bricks provide
+ * the neighbors of the voxels of the brick, and the borders of the normal bricks
+ * are then filled with the normals of their neighbor bricks. The volume is clamped
+ * at its bounds. Bricks are processed by several threads, and gradients are computed
+ * four voxels at a time with SSE2 when available.
+ *
+ * The normal channel is stored either as octahedral coordinates in a ushort2 (see encodeOctahedral()),
+ * or as a half4 holding the normal and the gradient magnitude.
+ */
+class GIGASPACE_EXPORT GvDataStructureNormalGenerator
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Enumeration of gradient operators
+	 */
+	enum GradientOperator
+	{
+		eCentralDifference,
+		eSobel
+	};
+
+	/**
+	 * Enumeration of normal channel encodings
+	 */
+	enum NormalEncoding
+	{
+		eNoNormal,
+		eOctahedral,
+		eHalf4
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvDataStructureNormalGenerator();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvDataStructureNormalGenerator();
+
+	/**
+	 * Get the gradient operator
+	 *
+	 * @return the gradient operator
+	 */
+	GradientOperator getGradientOperator() const;
+
+	/**
+	 * Set the gradient operator
+	 *
+	 * @param pValue the gradient operator
+	 */
+	void setGradientOperator( GradientOperator pValue );
+
+	/**
+	 * Get the encoding of the normal channel
+	 *
+	 * @return the encoding of the normal channel
+	 */
+	NormalEncoding getNormalEncoding() const;
+
+	/**
+	 * Set the encoding of the normal channel
+	 *
+	 * @param pValue the encoding of the normal channel
+	 */
+	void setNormalEncoding( NormalEncoding pValue );
+
+	/**
+	 * Set the number of threads used to compute the normals
+	 *
+	 * @param pValue the number of threads
+	 */
+	void setNbThreads( unsigned int pValue );
+
+	/**
+	 * Tell wheter or not normals are computed four voxels at a time with SSE2.
+	 * The scalar path gives the same results : it is the fallback, and the reference of the SSE2 path.
+	 *
+	 * @param pFlag the flag telling wheter or not SSE2 is used (when available)
+	 */
+	void useSIMD( bool pFlag );
+
+	/**
+	 * Tell wheter or not the SSE2 path is available (it depends on the compiler settings)
+	 *
+	 * @return a flag telling wheter or not the SSE2 path is available
+	 */
+	static bool isSIMDAvailable();
+
+	/**
+	 * Generate the normal channel (channel 1) of all levels of resolution of a data structure
+	 *
+	 * @param pFilename 3D model file name
+	 * @param pDataResolution Data resolution
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool generateNormals( const std::string& pFileName, unsigned int pDataResolution );
+
+	/**
+	 * Generate the normal channel of a level of resolution of a data structure.
+	 * Borders of the density channel must be up to date.
+	 *
+	 * @param pIOHandler the data structure level (its channel 0 is the uchar4 density channel)
+	 * @param pDataChannel the normal channel index (its data type must match the normal encoding)
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool generateNormals( GvDataStructureIOHandler& pIOHandler, unsigned int pDataChannel );
+
+	/**
+	 * Get the data type of a normal channel encoding
+	 *
+	 * @param pEncoding the normal channel encoding (must not be eNoNormal)
+	 *
+	 * @return the data type of the normal channel
+	 */
+	static GvDataTypeHandler::VoxelDataType getNormalDataType( NormalEncoding pEncoding );
+
+	/**
+	 * Encode a normal in octahedral coordinates.
+	 * The normal is projected on the octahedron |x|+|y|+|z|=1, the lower half is folded
+	 * over the upper one, and the coordinates in [-1;1] are quantized on 16 bits.
+	 * A null normal is encoded as ( 0, 0, 1 ).
+	 *
+	 * @param pNormal the normal
+	 * @param pResult the octahedral coordinates
+	 */
+	static void encodeOctahedral( const float pNormal[ 3 ], unsigned short pResult[ 2 ] );
+
+	/**
+	 * Decode a normal from octahedral coordinates.
+	 * In a shader, with ( u, v ) the coordinates in [-1;1] : n = ( u, v, 1 - |u| - |v| ),
+	 * then if n.z < 0, n.xy = ( 1 - |n.yx| ) * sign( n.xy ), and n is normalized.
+	 *
+	 * @param pValue the octahedral coordinates
+	 * @param pResult the normal
+	 */
+	static void decodeOctahedral( const unsigned short pValue[ 2 ], float pResult[ 3 ] );
+
+	/**
+	 * Convert a float to a half float (rounded to nearest even)
+	 *
+	 * @param pValue the float
+	 *
+	 * @return the bits of the half float
+	 */
+	static unsigned short floatToHalf( float pValue );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Bricks processed by a thread
+	 */
+	struct Task
+	{
+		/**
+		 * The normal generator
+		 */
+		GvDataStructureNormalGenerator* _generator;
+
+		/**
+		 * First brick and end of the bricks of the task
+		 */
+		unsigned int _first;
+		unsigned int _end;
+
+		/**
+		 * Scratch memory of the task (densities and gradients of a brick)
+		 */
+		float* _scratch;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Gradient operator
+	 */
+	GradientOperator _gradientOperator;
+
+	/**
+	 * Encoding of the normal channel
+	 */
+	NormalEncoding _normalEncoding;
+
+	/**
+	 * Number of threads used to compute the normals
+	 */
+	unsigned int _nbThreads;
+
+	/**
+	 * Flag telling wheter or not SSE2 is used (when available)
+	 */
+	bool _isSIMDUsed;
+
+	/**
+	 * Brick width and node grid size of the level being processed
+	 */
+	unsigned int _brickWidth;
+	unsigned int _nodeGridSize;
+
+	/**
+	 * Density bricks of the batch being processed (uchar4 data channel, with borders)
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< unsigned char > _densityBricks;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Normal bricks of the batch being processed (with borders)
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< unsigned char > _normalBricks;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Node positions of the bricks of the batch being processed
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< unsigned int > _nodePositions;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Scratch memory of the tasks
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< float > _scratch;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Compute the normals of the bricks of the batch, and write them in the data structure
+	 *
+	 * @param pIOHandler the data structure level
+	 * @param pDataChannel the normal channel index
+	 */
+	void processBatch( GvDataStructureIOHandler& pIOHandler, unsigned int pDataChannel );
+
+	/**
+	 * Compute the normals of the bricks of a task
+	 *
+	 * @param pTask the task
+	 */
+	void computeNormals( const Task& pTask );
+
+	/**
+	 * Compute the normals of a brick
+	 *
+	 * @param pDensityBrick the density brick (uchar4, with borders)
+	 * @param pNodePos the node position of the brick
+	 * @param pScratch scratch memory
+	 * @param pNormalBrick the normal brick (with borders)
+	 */
+	void computeBrickNormals( const unsigned char* pDensityBrick, const unsigned int pNodePos[ 3 ], float* pScratch, unsigned char* pNormalBrick ) const;
+
+	/**
+	 * Run tasks, one thread per task
+	 *
+	 * @param pTasks the tasks
+	 */
+	static void runTasks( std::vector< Task >& pTasks );
+
+	/**
+	 * Thread entry point of a task
+	 *
+	 * @param pTask the task
+	 *
+	 * @return NULL
+	 */
+	static void* runTask( void* pTask );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvDataStructureNormalGenerator( const GvDataStructureNormalGenerator& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvDataStructureNormalGenerator& operator=( const GvDataStructureNormalGenerator& );
+
+};
+
+}
+
+#endif
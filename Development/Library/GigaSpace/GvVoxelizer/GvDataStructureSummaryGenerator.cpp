@@ -0,0 +1,354 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvVoxelizer/GvDataStructureSummaryGenerator.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvVoxelizer/GvDataTypeHandler.h"
+#include "GvVoxelizer/GvDataStructureIOHandler.h"
+
+// STL
+#include <iostream>
+
+// System
+#include <cstdio>
+#include <cfloat>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GvVoxelizer
+using namespace GvVoxelizer;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Compute the node summaries of a data structure level.
+ *
+ * Note : borders of bricks must not be taken into account, only interior voxels are scanned.
+ *
+ * @param pIOHandler data structure handler of the level to process
+ * @param pFinerSummaries node summaries of the finer level (NULL at the finest level)
+ * @param pSummaries the resulting node summaries
+ *
+ * @return a flag telling wheter or not the process has succeeded
+ ******************************************************************************/
+bool GvDataStructureSummaryGenerator::generateSummaries( GvDataStructureIOHandler& pIOHandler, const std::vector< GvNodeSummary >* pFinerSummaries, std::vector< GvNodeSummary >& pSummaries )
+{
+	const vector< GvDataTypeHandler::VoxelDataType >& dataTypes = pIOHandler.getDataTypes();
+	const unsigned int nbChannels = static_cast< unsigned int >( dataTypes.size() );
+	const unsigned int nodeGridSize = pIOHandler._nodeGridSize;
+	const unsigned int nbNodes = nodeGridSize * nodeGridSize * nodeGridSize;
+
+	// Check parameters
+	if ( pFinerSummaries != NULL && pFinerSummaries->size() != static_cast< size_t >( 8 * nbNodes * nbChannels ) )
+	{
+		std::cout << "GvDataStructureSummaryGenerator::generateSummaries : finer summaries do not match the data structure" << std::endl;
+
+		return false;
+	}
+
+	pSummaries.resize( nbNodes * nbChannels );
+
+	// Allocate one brick buffer per data channel
+	vector< void* > brickBuffers( nbChannels );
+	for ( unsigned int c = 0; c < nbChannels; c++ )
+	{
+		brickBuffers[ c ] = GvDataTypeHandler::allocateVoxels( dataTypes[ c ], pIOHandler._brickSize );
+	}
+
+	// Iterate through nodes of the structure
+	unsigned int nodePos[ 3 ];
+	for ( nodePos[ 2 ] = 0; nodePos[ 2 ] < nodeGridSize; nodePos[ 2 ]++ )
+	for ( nodePos[ 1 ] = 0; nodePos[ 1 ] < nodeGridSize; nodePos[ 1 ]++ )
+	for ( nodePos[ 0 ] = 0; nodePos[ 0 ] < nodeGridSize; nodePos[ 0 ]++ )
+	{
+		const unsigned int nodeIndex = nodePos[ 0 ] + nodeGridSize * ( nodePos[ 1 ] + nodeGridSize * nodePos[ 2 ] );
+		const bool isEmptyNode = GvDataStructureIOHandler::isEmpty( pIOHandler.getNode( nodePos ) );
+
+		for ( unsigned int c = 0; c < nbChannels; c++ )
+		{
+			GvNodeSummary& summary = pSummaries[ nodeIndex * nbChannels + c ];
+
+			// An empty node has no brick, so its whole subtree is empty
+			if ( isEmptyNode )
+			{
+				for ( unsigned int i = 0; i < 4; i++ )
+				{
+					summary._min[ i ] = 0.f;
+					summary._max[ i ] = 0.f;
+				}
+				summary._occupancy = 0.f;
+				summary._flags = GV_NODE_SUMMARY_EMPTY_FLAG | GV_NODE_SUMMARY_HOMOGENEOUS_FLAG;
+
+				continue;
+			}
+
+			// Summary of the node brick
+			computeBrickSummary( pIOHandler, nodePos, c, brickBuffers[ c ], summary );
+
+			// At finest level, a node is homogeneous if its brick is constant
+			if ( pFinerSummaries == NULL )
+			{
+				if ( summary._flags & GV_NODE_SUMMARY_CONSTANT_FLAG )
+				{
+					summary._flags |= GV_NODE_SUMMARY_HOMOGENEOUS_FLAG;
+				}
+
+				continue;
+			}
+
+			// Otherwise, merge the ranges of the 8 children and check their homogeneity.
+			// Empty children are not merged : they will never be produced,
+			// and the averaged brick of the node already accounts for them.
+			const float brickValue[ 4 ] = { summary._min[ 0 ], summary._min[ 1 ], summary._min[ 2 ], summary._min[ 3 ] };
+			bool isHomogeneous = ( summary._flags & GV_NODE_SUMMARY_CONSTANT_FLAG ) != 0;
+			const unsigned int finerNodeGridSize = 2 * nodeGridSize;
+			for ( unsigned int z = 0; z < 2; z++ )
+			for ( unsigned int y = 0; y < 2; y++ )
+			for ( unsigned int x = 0; x < 2; x++ )
+			{
+				const unsigned int childIndex = ( 2 * nodePos[ 0 ] + x ) + finerNodeGridSize * ( ( 2 * nodePos[ 1 ] + y ) + finerNodeGridSize * ( 2 * nodePos[ 2 ] + z ) );
+				const GvNodeSummary& childSummary = ( *pFinerSummaries )[ childIndex * nbChannels + c ];
+
+				if ( childSummary._flags & GV_NODE_SUMMARY_EMPTY_FLAG )
+				{
+					for ( unsigned int i = 0; i < 4; i++ )
+					{
+						isHomogeneous = isHomogeneous && ( brickValue[ i ] == 0.f );
+					}
+
+					continue;
+				}
+
+				isHomogeneous = isHomogeneous && ( childSummary._flags & GV_NODE_SUMMARY_HOMOGENEOUS_FLAG );
+				for ( unsigned int i = 0; i < 4; i++ )
+				{
+					isHomogeneous = isHomogeneous && ( childSummary._min[ i ] == brickValue[ i ] ) && ( childSummary._max[ i ] == brickValue[ i ] );
+
+					if ( childSummary._min[ i ] < summary._min[ i ] )
+					{
+						summary._min[ i ] = childSummary._min[ i ];
+					}
+					if ( childSummary._max[ i ] > summary._max[ i ] )
+					{
+						summary._max[ i ] = childSummary._max[ i ];
+					}
+				}
+			}
+
+			if ( isHomogeneous )
+			{
+				summary._flags |= GV_NODE_SUMMARY_HOMOGENEOUS_FLAG;
+			}
+		}
+	}
+
+	// Free memory
+	for ( unsigned int c = 0; c < nbChannels; c++ )
+	{
+		operator delete( brickBuffers[ c ] );
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Compute the summary of a brick (interior voxels only)
+ *
+ * @param pIOHandler data structure handler
+ * @param pNodePos node position
+ * @param pDataChannel data channel index
+ * @param pBrickData a buffer large enough to store a brick of the data channel
+ * @param pSummary the resulting summary
+ ******************************************************************************/
+void GvDataStructureSummaryGenerator::computeBrickSummary( GvDataStructureIOHandler& pIOHandler, unsigned int pNodePos[ 3 ], unsigned int pDataChannel, void* pBrickData, GvNodeSummary& pSummary )
+{
+	const GvDataTypeHandler::VoxelDataType dataType = pIOHandler.getDataTypes()[ pDataChannel ];
+	const unsigned int brickWidth = pIOHandler._brickWidth;
+	const unsigned int brickWidthWithBorder = brickWidth + 2;
+
+	// Retrieve brick data
+	pIOHandler.getBrick( pNodePos, pBrickData, pDataChannel );
+
+	for ( unsigned int i = 0; i < 4; i++ )
+	{
+		pSummary._min[ i ] = FLT_MAX;
+		pSummary._max[ i ] = -FLT_MAX;
+	}
+
+	// Iterate through interior voxels of the brick (border is skipped)
+	unsigned int nbOccupiedVoxels = 0;
+	for ( unsigned int z = 1; z <= brickWidth; z++ )
+	for ( unsigned int y = 1; y <= brickWidth; y++ )
+	for ( unsigned int x = 1; x <= brickWidth; x++ )
+	{
+		const unsigned int voxelIndex = x + brickWidthWithBorder * ( y + brickWidthWithBorder * z );
+
+		// Retrieve normalized voxel value
+		float value[ 4 ] = { 0.f, 0.f, 0.f, 0.f };
+		switch ( dataType )
+		{
+			case GvDataTypeHandler::gvUCHAR:
+				value[ 0 ] = static_cast< float >( static_cast< unsigned char* >( pBrickData )[ voxelIndex ] ) / 255.f;
+				break;
+
+			case GvDataTypeHandler::gvUCHAR4:
+				for ( unsigned int i = 0; i < 4; i++ )
+				{
+					value[ i ] = static_cast< float >( static_cast< unsigned char* >( pBrickData )[ 4 * voxelIndex + i ] ) / 255.f;
+				}
+				break;
+
+			case GvDataTypeHandler::gvUSHORT:
+				value[ 0 ] = static_cast< float >( static_cast< unsigned short* >( pBrickData )[ voxelIndex ] ) / 65535.f;
+				break;
+
+			case GvDataTypeHandler::gvFLOAT:
+				value[ 0 ] = static_cast< float* >( pBrickData )[ voxelIndex ];
+				break;
+
+			case GvDataTypeHandler::gvFLOAT4:
+				for ( unsigned int i = 0; i < 4; i++ )
+				{
+					value[ i ] = static_cast< float* >( pBrickData )[ 4 * voxelIndex + i ];
+				}
+				break;
+
+			default:
+				// TO DO
+				// Handle error
+				break;
+		}
+
+		bool isOccupied = false;
+		for ( unsigned int i = 0; i < 4; i++ )
+		{
+			if ( value[ i ] < pSummary._min[ i ] )
+			{
+				pSummary._min[ i ] = value[ i ];
+			}
+			if ( value[ i ] > pSummary._max[ i ] )
+			{
+				pSummary._max[ i ] = value[ i ];
+			}
+			isOccupied = isOccupied || ( value[ i ] != 0.f );
+		}
+		if ( isOccupied )
+		{
+			nbOccupiedVoxels++;
+		}
+	}
+
+	pSummary._occupancy = static_cast< float >( nbOccupiedVoxels ) / static_cast< float >( brickWidth * brickWidth * brickWidth );
+	pSummary._flags = GV_NODE_SUMMARY_CONSTANT_FLAG;
+	for ( unsigned int i = 0; i < 4; i++ )
+	{
+		if ( pSummary._min[ i ] != pSummary._max[ i ] )
+		{
+			pSummary._flags = 0;
+		}
+	}
+}
+
+/******************************************************************************
+ * Write node summaries in a file
+ *
+ * @param pFileName summary file name
+ * @param pSummaries node summaries
+ *
+ * @return a flag telling wheter or not the process has succeeded
+ ******************************************************************************/
+bool GvDataStructureSummaryGenerator::writeSummaryFile( const std::string& pFileName, const std::vector< GvNodeSummary >& pSummaries )
+{
+	FILE* file = fopen( pFileName.c_str(), "wb" );
+	if ( file == NULL )
+	{
+		std::cout << "GvDataStructureSummaryGenerator::writeSummaryFile : unable to open file " << pFileName << std::endl;
+
+		return false;
+	}
+
+	size_t nbElements = 0;
+	if ( ! pSummaries.empty() )
+	{
+		nbElements = fwrite( &pSummaries[ 0 ], sizeof( GvNodeSummary ), pSummaries.size(), file );
+	}
+	fclose( file );
+
+	return ( nbElements == pSummaries.size() );
+}
+
+/******************************************************************************
+ * Read node summaries from a file
+ *
+ * @param pFileName summary file name
+ * @param pSummaries the resulting node summaries
+ *
+ * @return a flag telling wheter or not the process has succeeded
+ ******************************************************************************/
+bool GvDataStructureSummaryGenerator::readSummaryFile( const std::string& pFileName, std::vector< GvNodeSummary >& pSummaries )
+{
+	FILE* file = fopen( pFileName.c_str(), "rb" );
+	if ( file == NULL )
+	{
+		return false;
+	}
+
+	// Retrieve the number of summaries from the file size
+	fseek( file, 0, SEEK_END );
+	long fileSize = ftell( file );
+	fseek( file, 0, SEEK_SET );
+
+	pSummaries.resize( static_cast< size_t >( fileSize ) / sizeof( GvNodeSummary ) );
+
+	size_t nbElements = 0;
+	if ( ! pSummaries.empty() )
+	{
+		nbElements = fread( &pSummaries[ 0 ], sizeof( GvNodeSummary ), pSummaries.size(), file );
+	}
+	fclose( file );
+
+	return ( nbElements == pSummaries.size() );
+}
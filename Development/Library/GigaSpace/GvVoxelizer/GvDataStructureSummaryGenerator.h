@@ -0,0 +1,175 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_DATA_STRUCTURE_SUMMARY_GENERATOR_H_
+#define _GV_DATA_STRUCTURE_SUMMARY_GENERATOR_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+#include "GvVoxelizer/GvNodeSummary.h"
+
+// STL
+#include <vector>
+#include <string>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+namespace GvVoxelizer
+{
+	class GvDataStructureIOHandler;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvVoxelizer
+{
+
+/** 
+ * @class GvDataStructureSummaryGenerator
+ *
+ * @brief The GvDataStructureSummaryGenerator class provides methods to compute
+ * per-node summaries (min/max, occupancy, homogeneity) of a data structure level.
+ *
+ * Summaries are computed level by level, from the finest to the coarsest one.
+ * The summaries of the finer level are used to propagate min/max values
+ * and homogeneity over the whole subtree of each node.
+ *
+ * Summaries of a level are stored as an array indexed by :
+ * ( x + nodeGridSize * ( y + nodeGridSize * z ) ) * nbChannels + channel
+ */
+class GIGASPACE_EXPORT GvDataStructureSummaryGenerator
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Compute the node summaries of a data structure level.
+	 *
+	 * Note : borders of bricks must not be taken into account, only interior voxels are scanned.
+	 *
+	 * @param pIOHandler data structure handler of the level to process
+	 * @param pFinerSummaries node summaries of the finer level (NULL at the finest level)
+	 * @param pSummaries the resulting node summaries
+	 *
+	 * @return a flag telling wheter or not the process has succeeded
+	 */
+	static bool generateSummaries( GvDataStructureIOHandler& pIOHandler, const std::vector< GvNodeSummary >* pFinerSummaries, std::vector< GvNodeSummary >& pSummaries );
+
+	/**
+	 * Write node summaries in a file
+	 *
+	 * @param pFileName summary file name
+	 * @param pSummaries node summaries
+	 *
+	 * @return a flag telling wheter or not the process has succeeded
+	 */
+	static bool writeSummaryFile( const std::string& pFileName, const std::vector< GvNodeSummary >& pSummaries );
+
+	/**
+	 * Read node summaries from a file
+	 *
+	 * @param pFileName summary file name
+	 * @param pSummaries the resulting node summaries
+	 *
+	 * @return a flag telling wheter or not the process has succeeded
+	 */
+	static bool readSummaryFile( const std::string& pFileName, std::vector< GvNodeSummary >& pSummaries );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Compute the summary of a brick (interior voxels only)
+	 *
+	 * @param pIOHandler data structure handler
+	 * @param pNodePos node position
+	 * @param pDataChannel data channel index
+	 * @param pBrickData a buffer large enough to store a brick of the data channel
+	 * @param pSummary the resulting summary
+	 */
+	static void computeBrickSummary( GvDataStructureIOHandler& pIOHandler, unsigned int pNodePos[ 3 ], unsigned int pDataChannel, void* pBrickData, GvNodeSummary& pSummary );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor forbidden.
+	 */
+	GvDataStructureSummaryGenerator();
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvDataStructureSummaryGenerator( const GvDataStructureSummaryGenerator& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvDataStructureSummaryGenerator& operator=( const GvDataStructureSummaryGenerator& );
+
+};
+
+}
+
+#endif
@@ -77,6 +77,15 @@ unsigned int GvDataTypeHandler::canalByteSize( VoxelDataType pDataType )
 			result = sizeof( unsigned short );
 			break;
 
+		case gvUSHORT2:
+			result = 2 * sizeof( unsigned short );
+			break;
+
+		case gvHALF4:
+			// Half floats are stored as their 16 bits
+			result = 4 * sizeof( unsigned short );
+			break;
+
 		case gvFLOAT:
 			result = sizeof( float );
 			break;
@@ -133,6 +142,12 @@ void* GvDataTypeHandler::allocateVoxels( VoxelDataType pDataType, unsigned int p
 				case gvUSHORT:
                         result = operator new( sizeof(unsigned short) * pNbElements );
                         break;
+				case gvUSHORT2:
+                        result = operator new( sizeof(unsigned short) * 2 * pNbElements );
+                        break;
+				case gvHALF4:
+                        result = operator new( sizeof(unsigned short) * 4 * pNbElements );
+                        break;
 
                 case gvFLOAT:
                         result = operator new( sizeof(float) * pNbElements );
@@ -181,6 +196,14 @@ void* GvDataTypeHandler::getAddress( VoxelDataType pDataType, void* pDataBuffer,
 			result = &( static_cast< unsigned short* >( pDataBuffer )[ pElementPosition ] );
 			break;
 
+		case gvUSHORT2:
+			result = &( static_cast< unsigned short* >( pDataBuffer )[ 2 * pElementPosition ] );
+			break;
+
+		case gvHALF4:
+			result = &( static_cast< unsigned short* >( pDataBuffer )[ 4 * pElementPosition ] );
+			break;
+
 		case gvFLOAT:
 			result = &(static_cast< float* >( pDataBuffer )[ pElementPosition ]);
 			break;
@@ -224,6 +247,14 @@ std::string GvDataTypeHandler::getTypeName( VoxelDataType pDataType )
 			result = std::string( "ushort" );
 			break;
 
+		case gvUSHORT2:
+			result = std::string( "ushort2" );
+			break;
+
+		case gvHALF4:
+			result = std::string( "half4" );
+			break;
+
 		case gvFLOAT:
 			result = std::string( "float" );
 			break;
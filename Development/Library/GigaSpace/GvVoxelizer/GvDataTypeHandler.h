@@ -83,6 +83,8 @@ public:
 		gvUCHAR,
 		gvUCHAR4,
 		gvUSHORT,
+		gvUSHORT2,
+		gvHALF4,
 		gvFLOAT,
 		gvFLOAT4
 	}
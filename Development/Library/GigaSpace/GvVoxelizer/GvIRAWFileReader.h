@@ -35,6 +35,7 @@
 #include "GvCore/GvCoreConfig.h"
 #include "GvVoxelizer/GvDataStructureIOHandler.h"
 #include "GvVoxelizer/GvDataTypeHandler.h"
+#include "GvVoxelizer/GvDataStructureNormalGenerator.h"
 
 // STL
 #include <string>
@@ -138,6 +139,26 @@ public:
 	 */
 	void setMode( Mode pMode );
 
+	/**
+	 * Encoding of the normal channel (no normal channel by default)
+	 */
+	GvDataStructureNormalGenerator::NormalEncoding getNormalEncoding() const;
+
+	/**
+	 * Encoding of the normal channel (no normal channel by default)
+	 */
+	void setNormalEncoding( GvDataStructureNormalGenerator::NormalEncoding pValue );
+
+	/**
+	 * Gradient operator used to compute normals
+	 */
+	GvDataStructureNormalGenerator::GradientOperator getGradientOperator() const;
+
+	/**
+	 * Gradient operator used to compute normals
+	 */
+	void setGradientOperator( GvDataStructureNormalGenerator::GradientOperator pValue );
+
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
 	 **************************************************************************/
@@ -168,6 +189,16 @@ protected:
 	 */
 	Mode _mode;
 
+	/**
+	 * Encoding of the normal channel
+	 */
+	GvDataStructureNormalGenerator::NormalEncoding _normalEncoding;
+
+	/**
+	 * Gradient operator used to compute normals
+	 */
+	GvDataStructureNormalGenerator::GradientOperator _gradientOperator;
+
 	/**
 	 * File/stream handler.
 	 * It ios used to read and/ or write to GigaVoxels files (internal format).
@@ -188,6 +219,13 @@ protected:
 	 */
 	virtual bool generateMipmapPyramid();
 
+	/**
+	 * Generate the normal channel of all levels of resolution.
+	 * Normals are computed from the gradient of the density,
+	 * so that shaders do not have to sample the neighbors of each sample.
+	 */
+	virtual bool generateNormals();
+
 	/**************************************************************************
 	 ***************************** PRIVATE SECTION ****************************
 	 **************************************************************************/
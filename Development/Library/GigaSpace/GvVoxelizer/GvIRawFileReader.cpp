@@ -65,6 +65,8 @@ GvIRAWFileReader::GvIRAWFileReader()
 :	_filename()
 ,	_dataResolution( 0 )
 ,	_mode( eUndefinedMode )
+,	_normalEncoding( GvDataStructureNormalGenerator::eNoNormal )
+,	_gradientOperator( GvDataStructureNormalGenerator::eCentralDifference )
 ,	_dataStructureIOHandler( NULL )
 {
 }
@@ -83,15 +85,24 @@ bool GvIRAWFileReader::read()
 {
 	bool result = false;
 
-	std::cout << "- [step 1 / 3] - Read data and write vowels..." << std::endl;
+	// The normal channel is an optional step
+	const unsigned int nbSteps = ( _normalEncoding != GvDataStructureNormalGenerator::eNoNormal ) ? 4 : 3;
+
+	std::cout << "- [step 1 / " << nbSteps << "] - Read data and write vowels..." << std::endl;
 	result = readData();	// TO DO : add a boolean return value
 
-	std::cout << "- [step 2 / 3] - Update borders..." << std::endl;
+	std::cout << "- [step 2 / " << nbSteps << "] - Update borders..." << std::endl;
 	_dataStructureIOHandler->computeBorders();	// TO DO : add a boolean return value
 
-	std::cout << "- [step 3 / 3] - Mipmap pyramid generation..." << std::endl;
+	std::cout << "- [step 3 / " << nbSteps << "] - Mipmap pyramid generation..." << std::endl;
 	result = generateMipmapPyramid();
 
+	if ( nbSteps == 4 )
+	{
+		std::cout << "- [step 4 / " << nbSteps << "] - Normal channel generation..." << std::endl;
+		result = generateNormals();
+	}
+
 	return result;
 }
 
@@ -113,6 +124,20 @@ bool GvIRAWFileReader::generateMipmapPyramid()
 	return GvDataStructureMipmapGenerator::generateMipmapPyramid( getFilename(), getDataResolution() );
 }
 
+/******************************************************************************
+ * Generate the normal channel of all levels of resolution.
+ * Normals are computed from the gradient of the density,
+ * so that shaders do not have to sample the neighbors of each sample.
+ ******************************************************************************/
+bool GvIRAWFileReader::generateNormals()
+{
+	GvDataStructureNormalGenerator normalGenerator;
+	normalGenerator.setNormalEncoding( _normalEncoding );
+	normalGenerator.setGradientOperator( _gradientOperator );
+
+	return normalGenerator.generateNormals( getFilename(), getDataResolution() );
+}
+
 /******************************************************************************
 	 * 3D model file name
  ******************************************************************************/
@@ -160,3 +185,35 @@ void GvIRAWFileReader::setMode( Mode pMode )
 {
 	_mode = pMode;
 }
+
+/******************************************************************************
+	 * Encoding of the normal channel (no normal channel by default)
+ ******************************************************************************/
+GvDataStructureNormalGenerator::NormalEncoding GvIRAWFileReader::getNormalEncoding() const
+{
+	return _normalEncoding;
+}
+
+/******************************************************************************
+	 * Encoding of the normal channel (no normal channel by default)
+ ******************************************************************************/
+void GvIRAWFileReader::setNormalEncoding( GvDataStructureNormalGenerator::NormalEncoding pValue )
+{
+	_normalEncoding = pValue;
+}
+
+/******************************************************************************
+	 * Gradient operator used to compute normals
+ ******************************************************************************/
+GvDataStructureNormalGenerator::GradientOperator GvIRAWFileReader::getGradientOperator() const
+{
+	return _gradientOperator;
+}
+
+/******************************************************************************
+	 * Gradient operator used to compute normals
+ ******************************************************************************/
+void GvIRAWFileReader::setGradientOperator( GvDataStructureNormalGenerator::GradientOperator pValue )
+{
+	_gradientOperator = pValue;
+}
@@ -0,0 +1,110 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GV_NODE_SUMMARY_H_
+#define _GV_NODE_SUMMARY_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Node summary flags
+ *
+ * - EMPTY : the node has no brick (all its subtree is empty)
+ * - CONSTANT : all interior voxels of the node brick have the same value
+ * - HOMOGENEOUS : the node and all its subtree have the same value,
+ *   so the node can be made terminal without any loss
+ */
+#define GV_NODE_SUMMARY_EMPTY_FLAG			0x00000001U
+#define GV_NODE_SUMMARY_CONSTANT_FLAG		0x00000002U
+#define GV_NODE_SUMMARY_HOMOGENEOUS_FLAG	0x00000004U
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvVoxelizer
+{
+
+/**
+ * @struct GvNodeSummary
+ *
+ * @brief The GvNodeSummary struct provides a summary of the data
+ * contained in a node of the data structure for one data channel.
+ *
+ * Summaries are written by the voxelizer and the mipmap generator in a ".summary"
+ * file per level of resolution, alongside the ".nodes" file. Nodes are stored
+ * in the same order as in the ".nodes" file (X axis first, then Y axis, then Z axis),
+ * and each node has one summary per data channel.
+ *
+ * It lets producers classify a region (empty, terminal) without reading its brick.
+ *
+ * Note : values are normalized in [ 0.0 ; 1.0 ] for integer data types (uchar, ushort).
+ * Unused components (i.e. for one-component types) are set to 0.
+ */
+struct GvNodeSummary
+{
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Min value of each component over the whole subtree of the node
+	 */
+	float _min[ 4 ];
+
+	/**
+	 * Max value of each component over the whole subtree of the node
+	 */
+	float _max[ 4 ];
+
+	/**
+	 * Fraction of non-zero interior voxels in the node brick
+	 */
+	float _occupancy;
+
+	/**
+	 * Summary flags (empty, constant, homogeneous)
+	 */
+	unsigned int _flags;
+
+};
+
+}
+
+#endif
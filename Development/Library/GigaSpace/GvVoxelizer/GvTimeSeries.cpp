@@ -0,0 +1,937 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#include "GvVoxelizer/GvTimeSeries.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvVoxelizer/GvDataTypeHandler.h"
+
+// STL
+#include <iostream>
+#include <cstring>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GvVoxelizer
+using namespace GvVoxelizer;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Flag of nodes having a brick (see ".nodes" files)
+ */
+static const unsigned int cBrickFlag = 0x40000000U;
+
+/**
+ * Mask of the brick index of nodes
+ */
+static const unsigned int cBrickIndexMask = 0x3FFFFFFFU;
+
+/**
+ * Minimum number of zeros ending a run of literal bytes in zero-run encoded buffers
+ */
+static const size_t cMinZeroRun = 4;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Move the file position of a file stream (64 bits offset)
+ *
+ * @param pFile the file stream
+ * @param pOffset the offset from the beginning of the file (in bytes)
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+static bool seekFile( FILE* pFile, unsigned long long pOffset )
+{
+#ifdef WIN32
+	return ( _fseeki64( pFile, static_cast< __int64 >( pOffset ), SEEK_SET ) == 0 );
+#else
+	return ( fseeko( pFile, static_cast< off_t >( pOffset ), SEEK_SET ) == 0 );
+#endif
+}
+
+/******************************************************************************
+ * Append a varint to a buffer (7 bits per byte, lowest bits first)
+ *
+ * @param pValue the value
+ * @param pOutput the buffer
+ ******************************************************************************/
+static void writeVarint( unsigned long long pValue, std::vector< unsigned char >& pOutput )
+{
+	while ( pValue >= 0x80 )
+	{
+		pOutput.push_back( static_cast< unsigned char >( pValue | 0x80 ) );
+		pValue >>= 7;
+	}
+	pOutput.push_back( static_cast< unsigned char >( pValue ) );
+}
+
+/******************************************************************************
+ * Read a varint from a buffer
+ *
+ * @param pInput the buffer
+ * @param pSize size of the buffer (in bytes)
+ * @param pPosition position in the buffer (it is moved after the varint)
+ * @param pValue the value
+ *
+ * @return a flag telling wheter or not the varint is valid
+ ******************************************************************************/
+static bool readVarint( const unsigned char* pInput, size_t pSize, size_t& pPosition, unsigned long long& pValue )
+{
+	pValue = 0;
+	for ( unsigned int shift = 0; shift < 64 && pPosition < pSize; shift += 7 )
+	{
+		const unsigned char byte = pInput[ pPosition++ ];
+		pValue |= static_cast< unsigned long long >( byte & 0x7F ) << shift;
+		if ( ( byte & 0x80 ) == 0 )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvTimeSeries::GvTimeSeries()
+:	_file( NULL )
+,	_prefetchFile( NULL )
+,	_brickResolution( 0 )
+,	_borderSize( 0 )
+,	_nbLevels( 0 )
+,	_channels()
+,	_brickSizes()
+,	_steps()
+,	_step( 0 )
+,	_levels()
+,	_nbPrefetchedSteps( 0 )
+,	_prefetchedSteps()
+,	_stopRequested( false )
+,	_isPrefetching( false )
+,	_prefetchingStep( 0 )
+{
+#ifndef WIN32
+	pthread_mutex_init( &_mutex, NULL );
+	pthread_cond_init( &_condition, NULL );
+#endif
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvTimeSeries::~GvTimeSeries()
+{
+	close();
+
+#ifndef WIN32
+	pthread_cond_destroy( &_condition );
+	pthread_mutex_destroy( &_mutex );
+#endif
+}
+
+/******************************************************************************
+ * Open a time series file, decode its first time step
+ * and start prefetching the next ones.
+ *
+ * @param pFileName the time series file name
+ * @param pNbPrefetchedSteps number of time steps decoded in advance (0 to disable prefetching)
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvTimeSeries::open( const std::string& pFileName, unsigned int pNbPrefetchedSteps )
+{
+	close();
+
+	_file = fopen( pFileName.c_str(), "rb" );
+	if ( _file == NULL )
+	{
+		cerr << "GvTimeSeries::open() : unable to open " << pFileName << endl;
+		return false;
+	}
+
+	// Read the file header and the channel entries
+	FileHeader header;
+	bool isValid = ( fread( &header, sizeof( FileHeader ), 1, _file ) == 1 ) &&
+					( memcmp( header._magic, GV_TIME_SERIES_MAGIC, sizeof( GV_TIME_SERIES_MAGIC ) ) == 0 ) &&
+					( header._version == GV_TIME_SERIES_VERSION ) && ( header._nbSteps > 0 ) && ( header._nbLevels > 0 );
+	for ( unsigned int i = 0; isValid && i < header._nbChannels; i++ )
+	{
+		ChannelEntry entry;
+		isValid = ( fread( &entry, sizeof( ChannelEntry ), 1, _file ) == 1 );
+		if ( isValid )
+		{
+			entry._name[ GV_DATA_CONTAINER_CHANNEL_NAME_SIZE - 1 ] = '\0';
+			entry._typeName[ GV_DATA_CONTAINER_CHANNEL_NAME_SIZE - 1 ] = '\0';
+
+			GvDataContainer::Channel channel;
+			channel._name = entry._name;
+			channel._typeName = entry._typeName;
+			_channels.push_back( channel );
+
+			// Size of a brick of the channel (borders included)
+			const size_t brickResolution = header._brickResolution + 2 * header._borderSize;
+			_brickSizes.push_back( brickResolution * brickResolution * brickResolution * getTypeSize( channel._typeName ) );
+			isValid = ( _brickSizes.back() > 0 );
+		}
+	}
+
+	// Read the step table
+	if ( isValid )
+	{
+		_steps.resize( header._nbSteps );
+		isValid = seekFile( _file, header._stepTableOffset ) && ( fread( &_steps[ 0 ], sizeof( StepEntry ), _steps.size(), _file ) == _steps.size() ) && _steps[ 0 ]._isKeyframe;
+	}
+	if ( ! isValid )
+	{
+		cerr << "GvTimeSeries::open() : invalid time series file " << pFileName << endl;
+		close();
+		return false;
+	}
+
+	// Changed nodes of all levels must have a Morton key
+	const unsigned int maxNbLevels = GvCore::GvMortonCode::getMaxDepth< NodeTileResolution >() + 1;
+	if ( header._nbLevels > maxNbLevels )
+	{
+		cerr << "GvTimeSeries::open() : " << pFileName << " has " << header._nbLevels << " levels, at most " << maxNbLevels << " levels can be streamed" << endl;
+		close();
+		return false;
+	}
+	_brickResolution = header._brickResolution;
+	_borderSize = header._borderSize;
+	_nbLevels = header._nbLevels;
+
+	// Decode the first time step
+	DecodedStep* firstStep = decodeStep( _file, 0 );
+	if ( firstStep == NULL )
+	{
+		close();
+		return false;
+	}
+	std::vector< GvCore::GvMortonCode::ValueType > changedNodes;
+	applyStep( *firstStep, changedNodes );
+	delete firstStep;
+	_step = 0;
+
+	// Start the prefetch thread, with its own file stream
+	_nbPrefetchedSteps = pNbPrefetchedSteps;
+	_prefetchingStep = static_cast< unsigned int >( _steps.size() );
+#ifndef WIN32
+	if ( _nbPrefetchedSteps > 0 && _steps.size() > 1 )
+	{
+		_prefetchFile = fopen( pFileName.c_str(), "rb" );
+		_stopRequested = false;
+		if ( _prefetchFile != NULL && pthread_create( &_thread, NULL, &GvTimeSeries::threadEntry, this ) == 0 )
+		{
+			_isPrefetching = true;
+		}
+		else
+		{
+			cerr << "GvTimeSeries::open() : unable to create the prefetch thread, time steps are decoded when they are used" << endl;
+		}
+	}
+#endif
+
+	return true;
+}
+
+/******************************************************************************
+ * Stop prefetching and close the time series
+ ******************************************************************************/
+void GvTimeSeries::close()
+{
+#ifndef WIN32
+	if ( _isPrefetching )
+	{
+		pthread_mutex_lock( &_mutex );
+		_stopRequested = true;
+		pthread_cond_broadcast( &_condition );
+		pthread_mutex_unlock( &_mutex );
+
+		pthread_join( _thread, NULL );
+		_isPrefetching = false;
+	}
+#endif
+
+	for ( std::map< unsigned int, DecodedStep* >::iterator it = _prefetchedSteps.begin(); it != _prefetchedSteps.end(); ++it )
+	{
+		delete it->second;
+	}
+	_prefetchedSteps.clear();
+
+	if ( _prefetchFile != NULL )
+	{
+		fclose( _prefetchFile );
+		_prefetchFile = NULL;
+	}
+	if ( _file != NULL )
+	{
+		fclose( _file );
+		_file = NULL;
+	}
+
+	_brickResolution = 0;
+	_borderSize = 0;
+	_nbLevels = 0;
+	_channels.clear();
+	_brickSizes.clear();
+	_steps.clear();
+	_step = 0;
+	_levels.clear();
+}
+
+/******************************************************************************
+ * Tell wheter or not the time series is open
+ *
+ * @return a flag telling wheter or not the time series is open
+ ******************************************************************************/
+bool GvTimeSeries::isOpen() const
+{
+	return ( _file != NULL );
+}
+
+/******************************************************************************
+ * Get the brick resolution (without borders)
+ *
+ * @return the brick resolution
+ ******************************************************************************/
+unsigned int GvTimeSeries::getBrickResolution() const
+{
+	return _brickResolution;
+}
+
+/******************************************************************************
+ * Get the brick border size
+ *
+ * @return the brick border size
+ ******************************************************************************/
+unsigned int GvTimeSeries::getBorderSize() const
+{
+	return _borderSize;
+}
+
+/******************************************************************************
+ * Get the number of levels of resolution
+ *
+ * @return the number of levels of resolution
+ ******************************************************************************/
+unsigned int GvTimeSeries::getNbLevels() const
+{
+	return _nbLevels;
+}
+
+/******************************************************************************
+ * Get the data channels
+ *
+ * @return the data channels
+ ******************************************************************************/
+const std::vector< GvDataContainer::Channel >& GvTimeSeries::getChannels() const
+{
+	return _channels;
+}
+
+/******************************************************************************
+ * Get the number of time steps
+ *
+ * @return the number of time steps
+ ******************************************************************************/
+unsigned int GvTimeSeries::getNbSteps() const
+{
+	return static_cast< unsigned int >( _steps.size() );
+}
+
+/******************************************************************************
+ * Get the current time step
+ *
+ * @return the current time step
+ ******************************************************************************/
+unsigned int GvTimeSeries::getStep() const
+{
+	return _step;
+}
+
+/******************************************************************************
+ * Move to a time step.
+ * Moving to the next step applies its deltas, other moves restart from the closest keyframe.
+ *
+ * @param pStep the time step
+ * @param pChangedNodes the Morton keys of the nodes that have changed (they are appended to the list) :
+ * a node of level L at position P in the node grid has the key of the node of localization depth L
+ * and localization code P, i.e. GvCore::GvMortonCode::encodeNode< NodeTileResolution >( P, L )
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvTimeSeries::setStep( unsigned int pStep, std::vector< GvCore::GvMortonCode::ValueType >& pChangedNodes )
+{
+	if ( ! isOpen() || pStep >= _steps.size() )
+	{
+		return false;
+	}
+	if ( pStep == _step )
+	{
+		return true;
+	}
+
+	// Start from the last keyframe before the step, unless moving forward without crossing a keyframe
+	unsigned int firstStep = pStep;
+	while ( firstStep > 0 && ! _steps[ firstStep ]._isKeyframe && firstStep > _step + 1 )
+	{
+		firstStep--;
+	}
+	if ( pStep < _step && ! _steps[ firstStep ]._isKeyframe )
+	{
+		while ( ! _steps[ firstStep ]._isKeyframe )
+		{
+			firstStep--;
+		}
+	}
+
+	// Apply the steps
+	bool result = true;
+	for ( unsigned int step = firstStep; step <= pStep && result; step++ )
+	{
+		DecodedStep* decodedStep = acquireStep( step );
+		result = ( decodedStep != NULL );
+		if ( result )
+		{
+			applyStep( *decodedStep, pChangedNodes );
+			delete decodedStep;
+
+			// Let the prefetch thread move on
+#ifndef WIN32
+			pthread_mutex_lock( &_mutex );
+#endif
+			_step = step;
+			for ( std::map< unsigned int, DecodedStep* >::iterator it = _prefetchedSteps.begin(); it != _prefetchedSteps.end(); )
+			{
+				if ( it->first <= _step || it->first > _step + _nbPrefetchedSteps )
+				{
+					delete it->second;
+					_prefetchedSteps.erase( it++ );
+				}
+				else
+				{
+					++it;
+				}
+			}
+#ifndef WIN32
+			pthread_cond_broadcast( &_condition );
+			pthread_mutex_unlock( &_mutex );
+#endif
+		}
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * Get a node of the current time step
+ *
+ * @param pLevel level of resolution
+ * @param pNodeIndex index of the node in the node grid of the level
+ *
+ * @return the node (encoded as in ".nodes" files), 0 if out of bounds
+ ******************************************************************************/
+unsigned int GvTimeSeries::getNode( unsigned int pLevel, size_t pNodeIndex ) const
+{
+	if ( pLevel >= _levels.size() || pNodeIndex >= _levels[ pLevel ]._nodes.size() )
+	{
+		return 0;
+	}
+
+	return _levels[ pLevel ]._nodes[ pNodeIndex ];
+}
+
+/******************************************************************************
+ * Get a brick of the current time step
+ *
+ * @param pLevel level of resolution
+ * @param pChannel channel index
+ * @param pBrickIndex brick index (i.e. the last 30 bits of its node)
+ *
+ * @return the brick, or NULL if out of bounds
+ ******************************************************************************/
+const unsigned char* GvTimeSeries::getBrick( unsigned int pLevel, unsigned int pChannel, unsigned int pBrickIndex ) const
+{
+	if ( pLevel >= _levels.size() || pChannel >= _brickSizes.size() )
+	{
+		return NULL;
+	}
+
+	const std::vector< unsigned char >& bricks = _levels[ pLevel ]._bricks[ pChannel ];
+	const size_t offset = static_cast< size_t >( pBrickIndex ) * _brickSizes[ pChannel ];
+	if ( offset + _brickSizes[ pChannel ] > bricks.size() )
+	{
+		return NULL;
+	}
+
+	return &bricks[ offset ];
+}
+
+/******************************************************************************
+ * Get the size of a brick of a channel (borders included)
+ *
+ * @param pChannel channel index
+ *
+ * @return the size of a brick (in bytes)
+ ******************************************************************************/
+size_t GvTimeSeries::getBrickSize( unsigned int pChannel ) const
+{
+	return ( pChannel < _brickSizes.size() ) ? _brickSizes[ pChannel ] : 0;
+}
+
+/******************************************************************************
+ * Get the size of a voxel of a given data type
+ *
+ * @param pTypeName the data type name (i.e. "uchar4", "float", etc...)
+ *
+ * @return the size of a voxel (in bytes), 0 if the type is unknown
+ ******************************************************************************/
+unsigned int GvTimeSeries::getTypeSize( const std::string& pTypeName )
+{
+	for ( int type = GvDataTypeHandler::gvUCHAR; type <= GvDataTypeHandler::gvFLOAT4; type++ )
+	{
+		if ( GvDataTypeHandler::getTypeName( static_cast< GvDataTypeHandler::VoxelDataType >( type ) ) == pTypeName )
+		{
+			return GvDataTypeHandler::canalByteSize( static_cast< GvDataTypeHandler::VoxelDataType >( type ) );
+		}
+	}
+
+	return 0;
+}
+
+/******************************************************************************
+ * Zero-run encode a buffer : the output is a sequence of
+ * ( number of zeros, number of literal bytes, literal bytes ), counts are stored as varints.
+ *
+ * @param pData the buffer
+ * @param pSize size of the buffer (in bytes)
+ * @param pOutput the encoded buffer (data is appended)
+ ******************************************************************************/
+void GvTimeSeries::encodeZeroRuns( const unsigned char* pData, size_t pSize, std::vector< unsigned char >& pOutput )
+{
+	size_t position = 0;
+	while ( position < pSize )
+	{
+		// Run of zeros
+		const size_t zeroStart = position;
+		while ( position < pSize && pData[ position ] == 0 )
+		{
+			position++;
+		}
+		writeVarint( position - zeroStart, pOutput );
+
+		// Run of literal bytes, ended by enough zeros (or by the end of the buffer)
+		const size_t literalStart = position;
+		size_t nbZeros = 0;
+		while ( position < pSize && nbZeros < cMinZeroRun )
+		{
+			nbZeros = ( pData[ position ] == 0 ) ? nbZeros + 1 : 0;
+			position++;
+		}
+		if ( nbZeros == cMinZeroRun || ( position == pSize && nbZeros > 0 ) )
+		{
+			position -= nbZeros;
+		}
+		writeVarint( position - literalStart, pOutput );
+		pOutput.insert( pOutput.end(), pData + literalStart, pData + position );
+	}
+}
+
+/******************************************************************************
+ * Decode a zero-run encoded buffer
+ *
+ * @param pInput the encoded buffer
+ * @param pInputSize size of the encoded buffer (in bytes)
+ * @param pOutput the decoded buffer
+ * @param pOutputSize size of the decoded buffer (in bytes)
+ *
+ * @return a flag telling wheter or not the encoded buffer is valid
+ ******************************************************************************/
+bool GvTimeSeries::decodeZeroRuns( const unsigned char* pInput, size_t pInputSize, unsigned char* pOutput, size_t pOutputSize )
+{
+	size_t inputPosition = 0;
+	size_t outputPosition = 0;
+	while ( outputPosition < pOutputSize )
+	{
+		unsigned long long nbZeros;
+		unsigned long long nbLiterals;
+		if ( ! readVarint( pInput, pInputSize, inputPosition, nbZeros ) || ! readVarint( pInput, pInputSize, inputPosition, nbLiterals ) ||
+			nbZeros > pOutputSize - outputPosition || nbLiterals > pOutputSize - outputPosition - nbZeros || nbLiterals > pInputSize - inputPosition )
+		{
+			return false;
+		}
+
+		memset( pOutput + outputPosition, 0, static_cast< size_t >( nbZeros ) );
+		outputPosition += static_cast< size_t >( nbZeros );
+		memcpy( pOutput + outputPosition, pInput + inputPosition, static_cast< size_t >( nbLiterals ) );
+		outputPosition += static_cast< size_t >( nbLiterals );
+		inputPosition += static_cast< size_t >( nbLiterals );
+	}
+
+	return ( inputPosition == pInputSize );
+}
+
+/******************************************************************************
+ * Read and decode the record of a time step
+ *
+ * @param pFile the file stream
+ * @param pStep the time step
+ *
+ * @return the decoded step, or NULL if an error occurs
+ ******************************************************************************/
+GvTimeSeries::DecodedStep* GvTimeSeries::decodeStep( FILE* pFile, unsigned int pStep ) const
+{
+	const StepEntry& entry = _steps[ pStep ];
+
+	// Read the whole record
+	std::vector< unsigned char > record( static_cast< size_t >( entry._size ) );
+	if ( record.empty() || ! seekFile( pFile, entry._offset ) || fread( &record[ 0 ], 1, record.size(), pFile ) != record.size() )
+	{
+		cerr << "GvTimeSeries::decodeStep() : unable to read time step " << pStep << endl;
+		return NULL;
+	}
+
+	DecodedStep* decodedStep = new DecodedStep();
+	decodedStep->_isKeyframe = ( entry._isKeyframe != 0 );
+	decodedStep->_nbBricks.resize( _nbLevels );
+	decodedStep->_levels.resize( _nbLevels );
+
+	// Each level holds : number of bricks, number of nodes, nodes (or changed nodes), then bricks of each channel
+	size_t position = 0;
+	bool isValid = true;
+	for ( unsigned int level = 0; isValid && level < _nbLevels; level++ )
+	{
+		Level& decodedLevel = decodedStep->_levels[ level ];
+
+		unsigned int counts[ 2 ];
+		isValid = ( position + sizeof( counts ) <= record.size() );
+		if ( ! isValid )
+		{
+			break;
+		}
+		memcpy( counts, &record[ position ], sizeof( counts ) );
+		position += sizeof( counts );
+		decodedStep->_nbBricks[ level ] = counts[ 0 ];
+
+		// Keyframes hold the whole node grid, other steps hold ( node index, node ) pairs
+		const size_t nbNodeValues = decodedStep->_isKeyframe ? counts[ 1 ] : 2 * static_cast< size_t >( counts[ 1 ] );
+		isValid = ( position + nbNodeValues * sizeof( unsigned int ) <= record.size() );
+		if ( ! isValid )
+		{
+			break;
+		}
+		decodedLevel._nodes.resize( nbNodeValues );
+		if ( nbNodeValues > 0 )
+		{
+			memcpy( &decodedLevel._nodes[ 0 ], &record[ position ], nbNodeValues * sizeof( unsigned int ) );
+		}
+		position += nbNodeValues * sizeof( unsigned int );
+
+		// Number of bricks stored in the record
+		size_t nbStoredBricks = counts[ 0 ];
+		if ( ! decodedStep->_isKeyframe )
+		{
+			nbStoredBricks = 0;
+			for ( size_t i = 1; i < nbNodeValues; i += 2 )
+			{
+				nbStoredBricks += ( decodedLevel._nodes[ i ] & cBrickFlag ) ? 1 : 0;
+			}
+		}
+
+		// Bricks of each channel
+		decodedLevel._bricks.resize( _channels.size() );
+		for ( size_t channel = 0; isValid && channel < _channels.size(); channel++ )
+		{
+			unsigned long long encodedSize;
+			isValid = ( position + sizeof( encodedSize ) <= record.size() );
+			if ( isValid )
+			{
+				memcpy( &encodedSize, &record[ position ], sizeof( encodedSize ) );
+				position += sizeof( encodedSize );
+				isValid = ( encodedSize <= record.size() - position );
+			}
+			if ( isValid )
+			{
+				std::vector< unsigned char >& bricks = decodedLevel._bricks[ channel ];
+				bricks.resize( nbStoredBricks * _brickSizes[ channel ] );
+				isValid = bricks.empty() || decodeZeroRuns( &record[ position ], static_cast< size_t >( encodedSize ), &bricks[ 0 ], bricks.size() );
+				position += static_cast< size_t >( encodedSize );
+			}
+		}
+	}
+	if ( ! isValid )
+	{
+		cerr << "GvTimeSeries::decodeStep() : invalid record of time step " << pStep << endl;
+		delete decodedStep;
+		return NULL;
+	}
+
+	return decodedStep;
+}
+
+/******************************************************************************
+ * Apply a decoded time step to the current levels
+ *
+ * @param pDecodedStep the decoded step
+ * @param pChangedNodes the Morton keys of the nodes that have changed (they are appended to the list)
+ ******************************************************************************/
+void GvTimeSeries::applyStep( const DecodedStep& pDecodedStep, std::vector< GvCore::GvMortonCode::ValueType >& pChangedNodes )
+{
+	_levels.resize( _nbLevels );
+	for ( unsigned int level = 0; level < _nbLevels; level++ )
+	{
+		Level& currentLevel = _levels[ level ];
+		const Level& decodedLevel = pDecodedStep._levels[ level ];
+
+		if ( pDecodedStep._isKeyframe )
+		{
+			// Bricks are renumbered by keyframes : nodes are compared with their bricks
+			const bool isFirstStep = currentLevel._nodes.empty();
+			for ( size_t i = 0; ! isFirstStep && i < decodedLevel._nodes.size() && i < currentLevel._nodes.size(); i++ )
+			{
+				const unsigned int currentNode = currentLevel._nodes[ i ];
+				const unsigned int node = decodedLevel._nodes[ i ];
+				bool isChanged = ( ( currentNode & ~cBrickIndexMask ) != ( node & ~cBrickIndexMask ) );
+				if ( ! isChanged && ( node & cBrickFlag ) )
+				{
+					for ( size_t channel = 0; ! isChanged && channel < _brickSizes.size(); channel++ )
+					{
+						const size_t size = _brickSizes[ channel ];
+						const size_t currentOffset = static_cast< size_t >( currentNode & cBrickIndexMask ) * size;
+						const size_t offset = static_cast< size_t >( node & cBrickIndexMask ) * size;
+						isChanged = ( currentOffset + size > currentLevel._bricks[ channel ].size() ) || ( offset + size > decodedLevel._bricks[ channel ].size() ) ||
+									( memcmp( &currentLevel._bricks[ channel ][ currentOffset ], &decodedLevel._bricks[ channel ][ offset ], size ) != 0 );
+					}
+				}
+				else if ( ! isChanged )
+				{
+					isChanged = ( currentNode != node );
+				}
+				if ( isChanged )
+				{
+					pChangedNodes.push_back( getNodeKey( level, i ) );
+				}
+			}
+
+			currentLevel = decodedLevel;
+		}
+		else
+		{
+			// New bricks are appended
+			currentLevel._bricks.resize( _brickSizes.size() );
+			for ( size_t channel = 0; channel < _brickSizes.size(); channel++ )
+			{
+				const size_t size = static_cast< size_t >( pDecodedStep._nbBricks[ level ] ) * _brickSizes[ channel ];
+				if ( currentLevel._bricks[ channel ].size() < size )
+				{
+					currentLevel._bricks[ channel ].resize( size, 0 );
+				}
+			}
+
+			// Changed nodes, with their bricks XORed with the previous ones
+			size_t brickPosition = 0;
+			for ( size_t i = 0; i + 1 < decodedLevel._nodes.size(); i += 2 )
+			{
+				const unsigned int nodeIndex = decodedLevel._nodes[ i ];
+				const unsigned int node = decodedLevel._nodes[ i + 1 ];
+				if ( nodeIndex >= currentLevel._nodes.size() )
+				{
+					continue;
+				}
+				currentLevel._nodes[ nodeIndex ] = node;
+				if ( node & cBrickFlag )
+				{
+					for ( size_t channel = 0; channel < _brickSizes.size(); channel++ )
+					{
+						const size_t size = _brickSizes[ channel ];
+						const size_t offset = static_cast< size_t >( node & cBrickIndexMask ) * size;
+						if ( offset + size <= currentLevel._bricks[ channel ].size() )
+						{
+							unsigned char* brick = &currentLevel._bricks[ channel ][ offset ];
+							const unsigned char* delta = &decodedLevel._bricks[ channel ][ brickPosition * size ];
+							for ( size_t j = 0; j < size; j++ )
+							{
+								brick[ j ] ^= delta[ j ];
+							}
+						}
+					}
+					brickPosition++;
+				}
+				pChangedNodes.push_back( getNodeKey( level, nodeIndex ) );
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * Retrieve a decoded time step, from the prefetched steps if it is available
+ *
+ * @param pStep the time step
+ *
+ * @return the decoded step, or NULL if an error occurs
+ ******************************************************************************/
+GvTimeSeries::DecodedStep* GvTimeSeries::acquireStep( unsigned int pStep )
+{
+	DecodedStep* decodedStep = NULL;
+
+#ifndef WIN32
+	pthread_mutex_lock( &_mutex );
+
+	// Wait for the step if it is being decoded
+	while ( _isPrefetching && _prefetchingStep == pStep )
+	{
+		pthread_cond_wait( &_condition, &_mutex );
+	}
+	std::map< unsigned int, DecodedStep* >::iterator it = _prefetchedSteps.find( pStep );
+	if ( it != _prefetchedSteps.end() )
+	{
+		decodedStep = it->second;
+		_prefetchedSteps.erase( it );
+	}
+
+	pthread_mutex_unlock( &_mutex );
+#endif
+
+	// Decode the step if it has not been prefetched
+	if ( decodedStep == NULL )
+	{
+		decodedStep = decodeStep( _file, pStep );
+	}
+
+	return decodedStep;
+}
+
+/******************************************************************************
+ * Get the Morton key of a node, as computed on device from its localization info
+ * (the level is the localization depth, and the position in the node grid is the localization code)
+ *
+ * @param pLevel level of resolution
+ * @param pNodeIndex index of the node in the node grid of the level
+ *
+ * @return the Morton key
+ ******************************************************************************/
+GvCore::GvMortonCode::ValueType GvTimeSeries::getNodeKey( unsigned int pLevel, size_t pNodeIndex )
+{
+	const size_t levelResolution = static_cast< size_t >( 1 ) << pLevel;
+
+	uint3 position;
+	position.x = static_cast< unsigned int >( pNodeIndex % levelResolution );
+	position.y = static_cast< unsigned int >( ( pNodeIndex / levelResolution ) % levelResolution );
+	position.z = static_cast< unsigned int >( pNodeIndex / ( levelResolution * levelResolution ) );
+
+	GvCore::GvLocalizationCode localizationCode;
+	localizationCode.set( position );
+	GvCore::GvLocalizationDepth localizationDepth;
+	localizationDepth.set( pLevel );
+
+	return GvCore::GvMortonCode::encodeNode< NodeTileResolution >( localizationCode, localizationDepth );
+}
+
+/******************************************************************************
+ * Entry point of the prefetch thread
+ *
+ * @param pTimeSeries the time series
+ *
+ * @return NULL
+ ******************************************************************************/
+void* GvTimeSeries::threadEntry( void* pTimeSeries )
+{
+	static_cast< GvTimeSeries* >( pTimeSeries )->run();
+
+	return NULL;
+}
+
+/******************************************************************************
+ * Main loop of the prefetch thread
+ ******************************************************************************/
+void GvTimeSeries::run()
+{
+#ifndef WIN32
+	const unsigned int nbSteps = static_cast< unsigned int >( _steps.size() );
+
+	pthread_mutex_lock( &_mutex );
+	while ( ! _stopRequested )
+	{
+		// Find the next step to decode
+		unsigned int step = _step + 1;
+		while ( step < nbSteps && step <= _step + _nbPrefetchedSteps && _prefetchedSteps.find( step ) != _prefetchedSteps.end() )
+		{
+			step++;
+		}
+		if ( step >= nbSteps || step > _step + _nbPrefetchedSteps )
+		{
+			pthread_cond_wait( &_condition, &_mutex );
+			continue;
+		}
+
+		// Decode it without holding the mutex
+		_prefetchingStep = step;
+		pthread_mutex_unlock( &_mutex );
+		DecodedStep* decodedStep = decodeStep( _prefetchFile, step );
+		pthread_mutex_lock( &_mutex );
+		_prefetchingStep = nbSteps;
+
+		// The current step may have moved in the meantime
+		if ( decodedStep != NULL && step > _step && step <= _step + _nbPrefetchedSteps )
+		{
+			_prefetchedSteps[ step ] = decodedStep;
+		}
+		else
+		{
+			delete decodedStep;
+		}
+		pthread_cond_broadcast( &_condition );
+
+		// Errors are reported when the step is decoded again by the main thread
+		if ( decodedStep == NULL )
+		{
+			break;
+		}
+	}
+	pthread_mutex_unlock( &_mutex );
+#endif
+}
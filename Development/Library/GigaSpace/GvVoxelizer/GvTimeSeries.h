@@ -0,0 +1,521 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#ifndef _GV_TIME_SERIES_H_
+#define _GV_TIME_SERIES_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+#include "GvCore/GvMortonCode.h"
+#include "GvCore/StaticRes3D.h"
+#include "GvVoxelizer/GvDataContainer.h"
+
+// STL
+#include <vector>
+#include <map>
+#include <string>
+
+// System
+#include <cstdio>
+#ifndef WIN32
+	#include <pthread.h>
+#endif
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Time series file identification
+ */
+#define GV_TIME_SERIES_MAGIC			"GVTSERI"
+#define GV_TIME_SERIES_VERSION			1
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvVoxelizer
+{
+
+/**
+ * @class GvTimeSeries
+ *
+ * @brief The GvTimeSeries class provides access to a time-varying GigaVoxels
+ * dataset stored in a time series file (".gvts", see GvTimeSeriesWriter).
+ *
+ * A time series holds the same levels of resolution as a dataset (one dense node grid
+ * per level, nodes encoded as in ".nodes" files) for each time step :
+ * - keyframe steps store all nodes and bricks of each level,
+ * - other steps only store the nodes that have changed since the previous step.
+ * Changed bricks keep their brick index (new bricks are appended), and are stored
+ * XORed with their previous content and zero-run encoded : voxels that did not change are zeros.
+ * Unchanged nodes and bricks are implicit references to the previous step.
+ *
+ * File layout :
+ * - file header, followed by channel entries,
+ * - one record per time step (see GvTimeSeriesWriter::writeStep()),
+ * - step table (offset of the table is in the file header).
+ *
+ * The current time step is decoded in memory. The next time steps are read and decoded
+ * by a background thread, so that moving to the next step only applies the decoded deltas.
+ * Moving to a step returns the Morton keys of the nodes that have changed
+ * (see GvStructure::GvDataProductionManager::invalidateNodes()), as they are computed
+ * on device for a data structure with 2x2x2 node tiles : levels of a time series are octree levels.
+ *
+ * All values are stored with the native endianness.
+ *
+ * Note : prefetching is not available on WIN32, steps are then decoded when they are used.
+ */
+class GIGASPACE_EXPORT GvTimeSeries
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Type definition of the node tile resolution of the data structures using the Morton keys of changed nodes
+	 */
+	typedef GvCore::StaticRes1D< 2 > NodeTileResolution;
+
+	/**
+	 * Level of resolution of a time step
+	 */
+	struct Level
+	{
+		/**
+		 * Node grid (X axis first, then Y axis, then Z axis), nodes are encoded as in ".nodes" files
+		 */
+		std::vector< unsigned int > _nodes;
+
+		/**
+		 * Bricks of each channel, indexed by the brick index of the nodes
+		 */
+		std::vector< std::vector< unsigned char > > _bricks;
+	};
+
+	/**
+	 * File header, as stored at the beginning of a time series file.
+	 * It is followed by the channel entries.
+	 */
+	struct FileHeader
+	{
+		char _magic[ 8 ];
+		unsigned int _version;
+		unsigned int _brickResolution;
+		unsigned int _borderSize;
+		unsigned int _nbLevels;
+		unsigned int _nbChannels;
+		unsigned int _nbSteps;
+		unsigned int _keyframeInterval;
+		unsigned int _reserved;
+		unsigned long long _stepTableOffset;
+	};
+
+	/**
+	 * Channel entry, as stored after the file header
+	 */
+	struct ChannelEntry
+	{
+		char _name[ GV_DATA_CONTAINER_CHANNEL_NAME_SIZE ];
+		char _typeName[ GV_DATA_CONTAINER_CHANNEL_NAME_SIZE ];
+	};
+
+	/**
+	 * Step entry, as stored in the step table
+	 */
+	struct StepEntry
+	{
+		unsigned int _isKeyframe;
+		unsigned int _reserved;
+		unsigned long long _offset;
+		unsigned long long _size;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvTimeSeries();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvTimeSeries();
+
+	/**
+	 * Open a time series file, decode its first time step
+	 * and start prefetching the next ones.
+	 *
+	 * @param pFileName the time series file name
+	 * @param pNbPrefetchedSteps number of time steps decoded in advance (0 to disable prefetching)
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool open( const std::string& pFileName, unsigned int pNbPrefetchedSteps = 2 );
+
+	/**
+	 * Stop prefetching and close the time series
+	 */
+	void close();
+
+	/**
+	 * Tell wheter or not the time series is open
+	 *
+	 * @return a flag telling wheter or not the time series is open
+	 */
+	bool isOpen() const;
+
+	/**
+	 * Get the brick resolution (without borders)
+	 *
+	 * @return the brick resolution
+	 */
+	unsigned int getBrickResolution() const;
+
+	/**
+	 * Get the brick border size
+	 *
+	 * @return the brick border size
+	 */
+	unsigned int getBorderSize() const;
+
+	/**
+	 * Get the number of levels of resolution
+	 *
+	 * @return the number of levels of resolution
+	 */
+	unsigned int getNbLevels() const;
+
+	/**
+	 * Get the data channels
+	 *
+	 * @return the data channels
+	 */
+	const std::vector< GvDataContainer::Channel >& getChannels() const;
+
+	/**
+	 * Get the number of time steps
+	 *
+	 * @return the number of time steps
+	 */
+	unsigned int getNbSteps() const;
+
+	/**
+	 * Get the current time step
+	 *
+	 * @return the current time step
+	 */
+	unsigned int getStep() const;
+
+	/**
+	 * Move to a time step.
+	 * Moving to the next step applies its deltas, other moves restart from the closest keyframe.
+	 *
+	 * @param pStep the time step
+	 * @param pChangedNodes the Morton keys of the nodes that have changed (they are appended to the list) :
+	 * a node of level L at position P in the node grid has the key of the node of localization depth L
+	 * and localization code P, i.e. GvCore::GvMortonCode::encodeNode< NodeTileResolution >( P, L )
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool setStep( unsigned int pStep, std::vector< GvCore::GvMortonCode::ValueType >& pChangedNodes );
+
+	/**
+	 * Get a node of the current time step
+	 *
+	 * @param pLevel level of resolution
+	 * @param pNodeIndex index of the node in the node grid of the level
+	 *
+	 * @return the node (encoded as in ".nodes" files), 0 if out of bounds
+	 */
+	unsigned int getNode( unsigned int pLevel, size_t pNodeIndex ) const;
+
+	/**
+	 * Get a brick of the current time step
+	 *
+	 * @param pLevel level of resolution
+	 * @param pChannel channel index
+	 * @param pBrickIndex brick index (i.e. the last 30 bits of its node)
+	 *
+	 * @return the brick, or NULL if out of bounds
+	 */
+	const unsigned char* getBrick( unsigned int pLevel, unsigned int pChannel, unsigned int pBrickIndex ) const;
+
+	/**
+	 * Get the size of a brick of a channel (borders included)
+	 *
+	 * @param pChannel channel index
+	 *
+	 * @return the size of a brick (in bytes)
+	 */
+	size_t getBrickSize( unsigned int pChannel ) const;
+
+	/**
+	 * Get the size of a voxel of a given data type
+	 *
+	 * @param pTypeName the data type name (i.e. "uchar4", "float", etc...)
+	 *
+	 * @return the size of a voxel (in bytes), 0 if the type is unknown
+	 */
+	static unsigned int getTypeSize( const std::string& pTypeName );
+
+	/**
+	 * Zero-run encode a buffer : the output is a sequence of
+	 * ( number of zeros, number of literal bytes, literal bytes ), counts are stored as varints.
+	 *
+	 * @param pData the buffer
+	 * @param pSize size of the buffer (in bytes)
+	 * @param pOutput the encoded buffer (data is appended)
+	 */
+	static void encodeZeroRuns( const unsigned char* pData, size_t pSize, std::vector< unsigned char >& pOutput );
+
+	/**
+	 * Decode a zero-run encoded buffer
+	 *
+	 * @param pInput the encoded buffer
+	 * @param pInputSize size of the encoded buffer (in bytes)
+	 * @param pOutput the decoded buffer
+	 * @param pOutputSize size of the decoded buffer (in bytes)
+	 *
+	 * @return a flag telling wheter or not the encoded buffer is valid
+	 */
+	static bool decodeZeroRuns( const unsigned char* pInput, size_t pInputSize, unsigned char* pOutput, size_t pOutputSize );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Decoded record of a time step.
+	 * Keyframes hold the whole levels, other steps hold the changed nodes
+	 * ( node index, node ) and the XORed content of their bricks, in the same order.
+	 */
+	struct DecodedStep
+	{
+		bool _isKeyframe;
+		std::vector< unsigned int > _nbBricks;
+		std::vector< Level > _levels;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Time series file (used to decode steps that have not been prefetched)
+	 */
+	FILE* _file;
+
+	/**
+	 * Time series file used by the prefetch thread
+	 */
+	FILE* _prefetchFile;
+
+	/**
+	 * Brick resolution (without borders)
+	 */
+	unsigned int _brickResolution;
+
+	/**
+	 * Brick border size
+	 */
+	unsigned int _borderSize;
+
+	/**
+	 * Number of levels of resolution
+	 */
+	unsigned int _nbLevels;
+
+	/**
+	 * Data channels
+	 */
+	std::vector< GvDataContainer::Channel > _channels;
+
+	/**
+	 * Size of a brick of each channel (in bytes)
+	 */
+	std::vector< size_t > _brickSizes;
+
+	/**
+	 * Step table
+	 */
+	std::vector< StepEntry > _steps;
+
+	/**
+	 * Current time step
+	 */
+	unsigned int _step;
+
+	/**
+	 * Levels of the current time step
+	 */
+	std::vector< Level > _levels;
+
+	/**
+	 * Number of time steps decoded in advance
+	 */
+	unsigned int _nbPrefetchedSteps;
+
+	/**
+	 * Prefetched steps (guarded by the mutex)
+	 */
+	std::map< unsigned int, DecodedStep* > _prefetchedSteps;
+
+	/**
+	 * Flag telling the prefetch thread to stop
+	 */
+	bool _stopRequested;
+
+	/**
+	 * Flag telling wheter or not the prefetch thread is running
+	 */
+	bool _isPrefetching;
+
+	/**
+	 * Time step being decoded by the prefetch thread (equal to the number of steps if none)
+	 */
+	unsigned int _prefetchingStep;
+
+#ifndef WIN32
+	/**
+	 * Prefetch thread
+	 */
+	pthread_t _thread;
+
+	/**
+	 * Mutex guarding the prefetched steps and the current time step
+	 */
+	pthread_mutex_t _mutex;
+
+	/**
+	 * Condition signaled when the current time step changes
+	 */
+	pthread_cond_t _condition;
+#endif
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Read and decode the record of a time step
+	 *
+	 * @param pFile the file stream
+	 * @param pStep the time step
+	 *
+	 * @return the decoded step, or NULL if an error occurs
+	 */
+	DecodedStep* decodeStep( FILE* pFile, unsigned int pStep ) const;
+
+	/**
+	 * Apply a decoded time step to the current levels
+	 *
+	 * @param pDecodedStep the decoded step
+	 * @param pChangedNodes the Morton keys of the nodes that have changed (they are appended to the list)
+	 */
+	void applyStep( const DecodedStep& pDecodedStep, std::vector< GvCore::GvMortonCode::ValueType >& pChangedNodes );
+
+	/**
+	 * Retrieve a decoded time step, from the prefetched steps if it is available
+	 *
+	 * @param pStep the time step
+	 *
+	 * @return the decoded step, or NULL if an error occurs
+	 */
+	DecodedStep* acquireStep( unsigned int pStep );
+
+	/**
+	 * Get the Morton key of a node, as computed on device from its localization info
+	 * (the level is the localization depth, and the position in the node grid is the localization code)
+	 *
+	 * @param pLevel level of resolution
+	 * @param pNodeIndex index of the node in the node grid of the level
+	 *
+	 * @return the Morton key
+	 */
+	static GvCore::GvMortonCode::ValueType getNodeKey( unsigned int pLevel, size_t pNodeIndex );
+
+	/**
+	 * Main loop of the prefetch thread
+	 */
+	void run();
+
+	/**
+	 * Entry point of the prefetch thread
+	 *
+	 * @param pTimeSeries the time series
+	 *
+	 * @return NULL
+	 */
+	static void* threadEntry( void* pTimeSeries );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvTimeSeries( const GvTimeSeries& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvTimeSeries& operator=( const GvTimeSeries& );
+
+};
+
+}
+
+#endif
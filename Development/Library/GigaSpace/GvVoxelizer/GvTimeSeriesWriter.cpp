@@ -0,0 +1,397 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#include "GvVoxelizer/GvTimeSeriesWriter.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <iostream>
+#include <cstring>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GvVoxelizer
+using namespace GvVoxelizer;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Flag of nodes having a brick (see ".nodes" files)
+ */
+static const unsigned int cBrickFlag = 0x40000000U;
+
+/**
+ * Mask of the brick index of nodes
+ */
+static const unsigned int cBrickIndexMask = 0x3FFFFFFFU;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvTimeSeriesWriter::GvTimeSeriesWriter()
+:	_file( NULL )
+,	_offset( 0 )
+,	_brickSizes()
+,	_steps()
+,	_levels()
+,	_nbChangedNodes( 0 )
+{
+	memset( &_header, 0, sizeof( GvTimeSeries::FileHeader ) );
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvTimeSeriesWriter::~GvTimeSeriesWriter()
+{
+	close();
+}
+
+/******************************************************************************
+ * Create a time series file
+ *
+ * @param pFileName the time series file name
+ * @param pBrickResolution brick resolution (without borders)
+ * @param pBorderSize brick border size
+ * @param pNbLevels number of levels of resolution
+ * @param pChannels data channels
+ * @param pKeyframeInterval number of time steps between two keyframes
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvTimeSeriesWriter::open( const std::string& pFileName, unsigned int pBrickResolution, unsigned int pBorderSize, unsigned int pNbLevels,
+							const std::vector< GvDataContainer::Channel >& pChannels, unsigned int pKeyframeInterval )
+{
+	close();
+
+	// Size of a brick of each channel (borders included)
+	_brickSizes.clear();
+	const size_t brickResolution = pBrickResolution + 2 * pBorderSize;
+	for ( size_t i = 0; i < pChannels.size(); i++ )
+	{
+		_brickSizes.push_back( brickResolution * brickResolution * brickResolution * GvTimeSeries::getTypeSize( pChannels[ i ]._typeName ) );
+		if ( _brickSizes.back() == 0 )
+		{
+			cerr << "GvTimeSeriesWriter::open() : unknown data type " << pChannels[ i ]._typeName << endl;
+			return false;
+		}
+	}
+
+	_file = fopen( pFileName.c_str(), "wb" );
+	if ( _file == NULL )
+	{
+		cerr << "GvTimeSeriesWriter::open() : unable to create " << pFileName << endl;
+		return false;
+	}
+
+	// Write the file header (it is written again with the step table offset when closing) and the channel entries
+	memset( &_header, 0, sizeof( GvTimeSeries::FileHeader ) );
+	memcpy( _header._magic, GV_TIME_SERIES_MAGIC, sizeof( GV_TIME_SERIES_MAGIC ) );
+	_header._version = GV_TIME_SERIES_VERSION;
+	_header._brickResolution = pBrickResolution;
+	_header._borderSize = pBorderSize;
+	_header._nbLevels = pNbLevels;
+	_header._nbChannels = static_cast< unsigned int >( pChannels.size() );
+	_header._keyframeInterval = ( pKeyframeInterval > 0 ) ? pKeyframeInterval : 1;
+	bool isOk = ( fwrite( &_header, sizeof( GvTimeSeries::FileHeader ), 1, _file ) == 1 );
+	for ( size_t i = 0; isOk && i < pChannels.size(); i++ )
+	{
+		GvTimeSeries::ChannelEntry entry;
+		memset( &entry, 0, sizeof( GvTimeSeries::ChannelEntry ) );
+		strncpy( entry._name, pChannels[ i ]._name.c_str(), GV_DATA_CONTAINER_CHANNEL_NAME_SIZE - 1 );
+		strncpy( entry._typeName, pChannels[ i ]._typeName.c_str(), GV_DATA_CONTAINER_CHANNEL_NAME_SIZE - 1 );
+		isOk = ( fwrite( &entry, sizeof( GvTimeSeries::ChannelEntry ), 1, _file ) == 1 );
+	}
+	if ( ! isOk )
+	{
+		cerr << "GvTimeSeriesWriter::open() : unable to write " << pFileName << endl;
+		fclose( _file );
+		_file = NULL;
+		return false;
+	}
+	_offset = sizeof( GvTimeSeries::FileHeader ) + pChannels.size() * sizeof( GvTimeSeries::ChannelEntry );
+
+	return true;
+}
+
+/******************************************************************************
+ * Write the next time step
+ *
+ * @param pLevels the levels of the time step (with bricks indexed by their nodes)
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvTimeSeriesWriter::writeStep( const std::vector< GvTimeSeries::Level >& pLevels )
+{
+	if ( _file == NULL )
+	{
+		return false;
+	}
+
+	// Check the levels : dense node grids, and one brick buffer per channel
+	bool isValid = ( pLevels.size() == _header._nbLevels );
+	for ( size_t level = 0; isValid && level < pLevels.size(); level++ )
+	{
+		isValid = ( pLevels[ level ]._nodes.size() == ( static_cast< size_t >( 1 ) << ( 3 * level ) ) ) && ( pLevels[ level ]._bricks.size() == _brickSizes.size() );
+		for ( size_t i = 0; isValid && i < pLevels[ level ]._nodes.size(); i++ )
+		{
+			const unsigned int node = pLevels[ level ]._nodes[ i ];
+			for ( size_t channel = 0; isValid && ( node & cBrickFlag ) && channel < _brickSizes.size(); channel++ )
+			{
+				isValid = ( static_cast< size_t >( ( node & cBrickIndexMask ) + 1 ) * _brickSizes[ channel ] <= pLevels[ level ]._bricks[ channel ].size() );
+			}
+		}
+	}
+	if ( ! isValid )
+	{
+		cerr << "GvTimeSeriesWriter::writeStep() : invalid levels for time step " << _steps.size() << endl;
+		return false;
+	}
+
+	GvTimeSeries::StepEntry entry;
+	entry._isKeyframe = ( _steps.size() % _header._keyframeInterval == 0 ) ? 1 : 0;
+	entry._reserved = 0;
+	entry._offset = _offset;
+
+	std::vector< unsigned char > record;
+	_nbChangedNodes = 0;
+	if ( entry._isKeyframe )
+	{
+		// Keyframe : levels are stored as they are
+		for ( size_t level = 0; level < pLevels.size(); level++ )
+		{
+			const GvTimeSeries::Level& inputLevel = pLevels[ level ];
+
+			unsigned int counts[ 2 ];
+			counts[ 0 ] = _brickSizes.empty() ? 0 : static_cast< unsigned int >( inputLevel._bricks[ 0 ].size() / _brickSizes[ 0 ] );
+			counts[ 1 ] = static_cast< unsigned int >( inputLevel._nodes.size() );
+			appendData( counts, sizeof( counts ), record );
+			appendData( &inputLevel._nodes[ 0 ], inputLevel._nodes.size() * sizeof( unsigned int ), record );
+			for ( size_t channel = 0; channel < _brickSizes.size(); channel++ )
+			{
+				std::vector< unsigned char > bricks( inputLevel._bricks[ channel ].begin(), inputLevel._bricks[ channel ].begin() + counts[ 0 ] * _brickSizes[ channel ] );
+				appendBricks( bricks, record );
+			}
+			_nbChangedNodes += counts[ 1 ];
+		}
+		_levels = pLevels;
+	}
+	else
+	{
+		// Delta : only changed nodes are stored
+		for ( size_t level = 0; level < pLevels.size(); level++ )
+		{
+			const GvTimeSeries::Level& inputLevel = pLevels[ level ];
+			GvTimeSeries::Level& currentLevel = _levels[ level ];
+			unsigned int nbBricks = _brickSizes.empty() ? 0 : static_cast< unsigned int >( currentLevel._bricks[ 0 ].size() / _brickSizes[ 0 ] );
+
+			std::vector< unsigned int > changedNodes;
+			std::vector< std::vector< unsigned char > > deltas( _brickSizes.size() );
+			for ( size_t i = 0; i < inputLevel._nodes.size(); i++ )
+			{
+				const unsigned int inputNode = inputLevel._nodes[ i ];
+				const unsigned int currentNode = currentLevel._nodes[ i ];
+				unsigned int node = inputNode;
+				if ( inputNode & cBrickFlag )
+				{
+					// Reuse the brick index of the previous step, or append a new brick
+					bool isChanged = ( ( inputNode & ~cBrickIndexMask ) != ( currentNode & ~cBrickIndexMask ) );
+					unsigned int brickIndex = currentNode & cBrickIndexMask;
+					if ( ! ( currentNode & cBrickFlag ) )
+					{
+						brickIndex = nbBricks++;
+						for ( size_t channel = 0; channel < _brickSizes.size(); channel++ )
+						{
+							currentLevel._bricks[ channel ].resize( static_cast< size_t >( nbBricks ) * _brickSizes[ channel ], 0 );
+						}
+						isChanged = true;
+					}
+					for ( size_t channel = 0; ! isChanged && channel < _brickSizes.size(); channel++ )
+					{
+						const size_t size = _brickSizes[ channel ];
+						isChanged = ( memcmp( &inputLevel._bricks[ channel ][ ( inputNode & cBrickIndexMask ) * size ], &currentLevel._bricks[ channel ][ brickIndex * size ], size ) != 0 );
+					}
+					if ( ! isChanged )
+					{
+						continue;
+					}
+					node = ( inputNode & ~cBrickIndexMask ) | brickIndex;
+
+					// Store the brick XORed with the previous one, and update it
+					for ( size_t channel = 0; channel < _brickSizes.size(); channel++ )
+					{
+						const size_t size = _brickSizes[ channel ];
+						const unsigned char* inputBrick = &inputLevel._bricks[ channel ][ ( inputNode & cBrickIndexMask ) * size ];
+						unsigned char* currentBrick = &currentLevel._bricks[ channel ][ brickIndex * size ];
+						std::vector< unsigned char >& delta = deltas[ channel ];
+						for ( size_t j = 0; j < size; j++ )
+						{
+							delta.push_back( inputBrick[ j ] ^ currentBrick[ j ] );
+						}
+						memcpy( currentBrick, inputBrick, size );
+					}
+				}
+				else if ( inputNode == currentNode )
+				{
+					continue;
+				}
+
+				currentLevel._nodes[ i ] = node;
+				changedNodes.push_back( static_cast< unsigned int >( i ) );
+				changedNodes.push_back( node );
+			}
+
+			unsigned int counts[ 2 ];
+			counts[ 0 ] = nbBricks;
+			counts[ 1 ] = static_cast< unsigned int >( changedNodes.size() / 2 );
+			appendData( counts, sizeof( counts ), record );
+			if ( ! changedNodes.empty() )
+			{
+				appendData( &changedNodes[ 0 ], changedNodes.size() * sizeof( unsigned int ), record );
+			}
+			for ( size_t channel = 0; channel < _brickSizes.size(); channel++ )
+			{
+				appendBricks( deltas[ channel ], record );
+			}
+			_nbChangedNodes += counts[ 1 ];
+		}
+	}
+
+	// Write the record
+	entry._size = record.size();
+	if ( fwrite( &record[ 0 ], 1, record.size(), _file ) != record.size() )
+	{
+		cerr << "GvTimeSeriesWriter::writeStep() : unable to write time step " << _steps.size() << endl;
+		return false;
+	}
+	_offset += entry._size;
+	_steps.push_back( entry );
+
+	return true;
+}
+
+/******************************************************************************
+ * Write the step table and close the file
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvTimeSeriesWriter::close()
+{
+	if ( _file == NULL )
+	{
+		return false;
+	}
+
+	// Step table is written after the records, then the header is updated
+	_header._nbSteps = static_cast< unsigned int >( _steps.size() );
+	_header._stepTableOffset = _offset;
+	bool isOk = _steps.empty() || ( fwrite( &_steps[ 0 ], sizeof( GvTimeSeries::StepEntry ), _steps.size(), _file ) == _steps.size() );
+	isOk = isOk && ( fseek( _file, 0, SEEK_SET ) == 0 ) && ( fwrite( &_header, sizeof( GvTimeSeries::FileHeader ), 1, _file ) == 1 );
+	isOk = ( fclose( _file ) == 0 ) && isOk;
+	_file = NULL;
+	if ( ! isOk )
+	{
+		cerr << "GvTimeSeriesWriter::close() : unable to write the step table" << endl;
+	}
+
+	_offset = 0;
+	_steps.clear();
+	_levels.clear();
+
+	return isOk;
+}
+
+/******************************************************************************
+ * Get the number of nodes that have changed in the last written time step
+ * (all nodes for a keyframe)
+ *
+ * @return the number of changed nodes
+ ******************************************************************************/
+unsigned int GvTimeSeriesWriter::getNbChangedNodes() const
+{
+	return _nbChangedNodes;
+}
+
+/******************************************************************************
+ * Get the size of the last written time step record
+ *
+ * @return the size of the record (in bytes)
+ ******************************************************************************/
+unsigned long long GvTimeSeriesWriter::getStepSize() const
+{
+	return _steps.empty() ? 0 : _steps.back()._size;
+}
+
+/******************************************************************************
+ * Append the encoded bricks of a channel to a record
+ *
+ * @param pBricks the bricks
+ * @param pRecord the record
+ ******************************************************************************/
+void GvTimeSeriesWriter::appendBricks( const std::vector< unsigned char >& pBricks, std::vector< unsigned char >& pRecord )
+{
+	std::vector< unsigned char > encodedBricks;
+	if ( ! pBricks.empty() )
+	{
+		GvTimeSeries::encodeZeroRuns( &pBricks[ 0 ], pBricks.size(), encodedBricks );
+	}
+
+	const unsigned long long encodedSize = encodedBricks.size();
+	appendData( &encodedSize, sizeof( encodedSize ), pRecord );
+	pRecord.insert( pRecord.end(), encodedBricks.begin(), encodedBricks.end() );
+}
+
+/******************************************************************************
+ * Append data to a record
+ *
+ * @param pData the data
+ * @param pSize size of the data (in bytes)
+ * @param pRecord the record
+ ******************************************************************************/
+void GvTimeSeriesWriter::appendData( const void* pData, size_t pSize, std::vector< unsigned char >& pRecord )
+{
+	const unsigned char* data = static_cast< const unsigned char* >( pData );
+	pRecord.insert( pRecord.end(), data, data + pSize );
+}
@@ -0,0 +1,243 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#ifndef _GV_TIME_SERIES_WRITER_H_
+#define _GV_TIME_SERIES_WRITER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include "GvCore/GvCoreConfig.h"
+#include "GvVoxelizer/GvTimeSeries.h"
+
+// STL
+#include <vector>
+#include <string>
+
+// System
+#include <cstdio>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvVoxelizer
+{
+
+/**
+ * @class GvTimeSeriesWriter
+ *
+ * @brief The GvTimeSeriesWriter class writes a time-varying GigaVoxels dataset
+ * in a time series file (".gvts", see GvTimeSeries), one time step after the other.
+ *
+ * Each time step is given as the levels of a regular dataset (content of its ".nodes"
+ * and ".bricks" files). Every "keyframe interval" steps, the whole levels are stored.
+ * Other steps only store the nodes that differ from the previous step :
+ * - a node whose brick has changed keeps the brick index it had in the previous step,
+ * - a node that gets a brick is given a new brick index (bricks are appended),
+ * - bricks are stored XORed with their previous content and zero-run encoded.
+ *
+ * Record of a time step, for each level :
+ * - number of bricks and number of nodes (unsigned int),
+ * - keyframes : the node grid, other steps : the ( node index, node ) pairs of changed nodes,
+ * - for each channel : size of the encoded bricks (unsigned long long) and encoded bricks
+ * (keyframes : all bricks, other steps : bricks of changed nodes, in the same order).
+ */
+class GIGASPACE_EXPORT GvTimeSeriesWriter
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvTimeSeriesWriter();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvTimeSeriesWriter();
+
+	/**
+	 * Create a time series file
+	 *
+	 * @param pFileName the time series file name
+	 * @param pBrickResolution brick resolution (without borders)
+	 * @param pBorderSize brick border size
+	 * @param pNbLevels number of levels of resolution
+	 * @param pChannels data channels
+	 * @param pKeyframeInterval number of time steps between two keyframes
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool open( const std::string& pFileName, unsigned int pBrickResolution, unsigned int pBorderSize, unsigned int pNbLevels,
+				const std::vector< GvDataContainer::Channel >& pChannels, unsigned int pKeyframeInterval );
+
+	/**
+	 * Write the next time step
+	 *
+	 * @param pLevels the levels of the time step (with bricks indexed by their nodes)
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool writeStep( const std::vector< GvTimeSeries::Level >& pLevels );
+
+	/**
+	 * Write the step table and close the file
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool close();
+
+	/**
+	 * Get the number of nodes that have changed in the last written time step
+	 * (all nodes for a keyframe)
+	 *
+	 * @return the number of changed nodes
+	 */
+	unsigned int getNbChangedNodes() const;
+
+	/**
+	 * Get the size of the last written time step record
+	 *
+	 * @return the size of the record (in bytes)
+	 */
+	unsigned long long getStepSize() const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Time series file
+	 */
+	FILE* _file;
+
+	/**
+	 * Current offset in the file (in bytes)
+	 */
+	unsigned long long _offset;
+
+	/**
+	 * File header
+	 */
+	GvTimeSeries::FileHeader _header;
+
+	/**
+	 * Size of a brick of each channel (in bytes)
+	 */
+	std::vector< size_t > _brickSizes;
+
+	/**
+	 * Step table
+	 */
+	std::vector< GvTimeSeries::StepEntry > _steps;
+
+	/**
+	 * Levels of the last written time step, as they are decoded by readers
+	 */
+	std::vector< GvTimeSeries::Level > _levels;
+
+	/**
+	 * Number of nodes that have changed in the last written time step
+	 */
+	unsigned int _nbChangedNodes;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Append the encoded bricks of a channel to a record
+	 *
+	 * @param pBricks the bricks
+	 * @param pRecord the record
+	 */
+	static void appendBricks( const std::vector< unsigned char >& pBricks, std::vector< unsigned char >& pRecord );
+
+	/**
+	 * Append data to a record
+	 *
+	 * @param pData the data
+	 * @param pSize size of the data (in bytes)
+	 * @param pRecord the record
+	 */
+	static void appendData( const void* pData, size_t pSize, std::vector< unsigned char >& pRecord );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvTimeSeriesWriter( const GvTimeSeriesWriter& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvTimeSeriesWriter& operator=( const GvTimeSeriesWriter& );
+
+};
+
+}
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#ifndef _GV_BENCHMARK_CASE_H_
+#define _GV_BENCHMARK_CASE_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <string>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+/** 
+ * @class GvBenchmarkCase
+ *
+ * @brief The GvBenchmarkCase class provides the interface of a host benchmark.
+ *
+ * A case is prepared once per ( size, number of threads ) configuration with setUp(),
+ * then run() is timed for each iteration. postRun() is called after each timed run
+ * to clean intermediate data, and tearDown() after the last iteration.
+ *
+ * The "size" is the resolution of the synthetic dataset (number of voxels in each dimension).
+ */
+class GvBenchmarkCase
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Type definition of a task run by a worker thread
+	 *
+	 * @param pData user data
+	 * @param pThreadIndex index of the thread
+	 * @param pNbThreads number of threads
+	 */
+	typedef void (*Task)( void* pData, unsigned int pThreadIndex, unsigned int pNbThreads );
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pName name of the benchmark (used in reports)
+	 * @param pIsMultiThreaded flag telling wheter or not the case uses several threads
+	 */
+	GvBenchmarkCase( const std::string& pName, bool pIsMultiThreaded );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvBenchmarkCase();
+
+	/**
+	 * Get the name of the benchmark
+	 *
+	 * @return the name of the benchmark
+	 */
+	const std::string& getName() const;
+
+	/**
+	 * Tell wheter or not the case uses several threads.
+	 * Single-threaded cases are only run once per size.
+	 *
+	 * @return a flag telling wheter or not the case uses several threads
+	 */
+	bool isMultiThreaded() const;
+
+	/**
+	 * Prepare the benchmark (not timed)
+	 *
+	 * @param pWorkingDirectory directory where synthetic datasets are written
+	 * @param pSize resolution of the synthetic dataset
+	 * @param pNbThreads number of threads
+	 *
+	 * @return a flag telling wheter or not the case can be run
+	 */
+	virtual bool setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads ) = 0;
+
+	/**
+	 * Run the benchmark (timed)
+	 *
+	 * @return the number of processed items (voxels, bricks, lookups, etc...)
+	 */
+	virtual double run() = 0;
+
+	/**
+	 * Clean intermediate data after a timed run (not timed)
+	 */
+	virtual void postRun();
+
+	/**
+	 * Clean data after the last iteration (not timed)
+	 */
+	virtual void tearDown();
+
+	/**
+	 * Launch a task on several threads and wait for their completion
+	 *
+	 * @param pTask the task
+	 * @param pData user data passed to the task
+	 * @param pNbThreads number of threads
+	 */
+	static void runParallel( Task pTask, void* pData, unsigned int pNbThreads );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Name of the benchmark
+	 */
+	std::string _name;
+
+	/**
+	 * Flag telling wheter or not the case uses several threads
+	 */
+	bool _isMultiThreaded;
+
+	/**
+	 * Number of threads of the current configuration
+	 */
+	unsigned int _nbThreads;
+
+	/******************************** METHODS *********************************/
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvBenchmarkCase( const GvBenchmarkCase& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvBenchmarkCase& operator=( const GvBenchmarkCase& );
+
+};
+
+#endif
@@ -0,0 +1,520 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#ifndef _GV_BENCHMARK_CASES_H_
+#define _GV_BENCHMARK_CASES_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvBenchmarkCase.h"
+
+// STL
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+class GvSyntheticDataset;
+
+namespace GvVoxelizer
+{
+	class GvDataStructureIOHandler;
+}
+
+namespace Gvx
+{
+	class GvxVoxelizerEngine;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+/** 
+ * @class GvIOHandlerSetVoxelBenchmark
+ *
+ * @brief Time the writing of the finest level of a synthetic dataset
+ * with GvDataStructureIOHandler::setVoxel() (files creation included).
+ *
+ * Items are written voxels.
+ */
+class GvIOHandlerSetVoxelBenchmark : public GvBenchmarkCase
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvIOHandlerSetVoxelBenchmark();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvIOHandlerSetVoxelBenchmark();
+
+	/**
+	 * Prepare the benchmark (not timed)
+	 *
+	 * @param pWorkingDirectory directory where synthetic datasets are written
+	 * @param pSize resolution of the synthetic dataset
+	 * @param pNbThreads number of threads
+	 *
+	 * @return a flag telling wheter or not the case can be run
+	 */
+	virtual bool setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads );
+
+	/**
+	 * Run the benchmark (timed)
+	 *
+	 * @return the number of processed items
+	 */
+	virtual double run();
+
+	/**
+	 * Clean data after the last iteration (not timed)
+	 */
+	virtual void tearDown();
+
+protected:
+
+	/**
+	 * Synthetic dataset
+	 */
+	GvSyntheticDataset* _dataset;
+
+};
+
+/** 
+ * @class GvIOHandlerGetVoxelBenchmark
+ *
+ * @brief Time the reading of all voxels of the finest level
+ * with GvDataStructureIOHandler::getVoxel(), node by node.
+ *
+ * Items are read voxels.
+ */
+class GvIOHandlerGetVoxelBenchmark : public GvBenchmarkCase
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvIOHandlerGetVoxelBenchmark();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvIOHandlerGetVoxelBenchmark();
+
+	/**
+	 * Prepare the benchmark (not timed)
+	 *
+	 * @param pWorkingDirectory directory where synthetic datasets are written
+	 * @param pSize resolution of the synthetic dataset
+	 * @param pNbThreads number of threads
+	 *
+	 * @return a flag telling wheter or not the case can be run
+	 */
+	virtual bool setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads );
+
+	/**
+	 * Run the benchmark (timed)
+	 *
+	 * @return the number of processed items
+	 */
+	virtual double run();
+
+	/**
+	 * Clean data after the last iteration (not timed)
+	 */
+	virtual void tearDown();
+
+protected:
+
+	/**
+	 * Synthetic dataset
+	 */
+	GvSyntheticDataset* _dataset;
+
+	/**
+	 * Data structure handler of the finest level
+	 */
+	GvVoxelizer::GvDataStructureIOHandler* _ioHandler;
+
+	/**
+	 * Checksum of read data (prevents the compiler from removing reads)
+	 */
+	unsigned int _checksum;
+
+};
+
+/** 
+ * @class GvBordersBenchmark
+ *
+ * @brief Time GvDataStructureIOHandler::computeBorders() on the finest level.
+ *
+ * Items are nodes of the level.
+ */
+class GvBordersBenchmark : public GvBenchmarkCase
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvBordersBenchmark();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvBordersBenchmark();
+
+	/**
+	 * Prepare the benchmark (not timed)
+	 *
+	 * @param pWorkingDirectory directory where synthetic datasets are written
+	 * @param pSize resolution of the synthetic dataset
+	 * @param pNbThreads number of threads
+	 *
+	 * @return a flag telling wheter or not the case can be run
+	 */
+	virtual bool setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads );
+
+	/**
+	 * Run the benchmark (timed)
+	 *
+	 * @return the number of processed items
+	 */
+	virtual double run();
+
+	/**
+	 * Clean data after the last iteration (not timed)
+	 */
+	virtual void tearDown();
+
+protected:
+
+	/**
+	 * Synthetic dataset
+	 */
+	GvSyntheticDataset* _dataset;
+
+};
+
+/** 
+ * @class GvMipmapBenchmark
+ *
+ * @brief Time GvDataStructureMipmapGenerator::generateMipmapPyramid()
+ * (coarser levels, their borders and node summaries).
+ *
+ * Items are voxels of the finest level.
+ */
+class GvMipmapBenchmark : public GvBenchmarkCase
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvMipmapBenchmark();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvMipmapBenchmark();
+
+	/**
+	 * Prepare the benchmark (not timed)
+	 *
+	 * @param pWorkingDirectory directory where synthetic datasets are written
+	 * @param pSize resolution of the synthetic dataset
+	 * @param pNbThreads number of threads
+	 *
+	 * @return a flag telling wheter or not the case can be run
+	 */
+	virtual bool setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads );
+
+	/**
+	 * Run the benchmark (timed)
+	 *
+	 * @return the number of processed items
+	 */
+	virtual double run();
+
+	/**
+	 * Clean data after the last iteration (not timed)
+	 */
+	virtual void tearDown();
+
+protected:
+
+	/**
+	 * Synthetic dataset
+	 */
+	GvSyntheticDataset* _dataset;
+
+};
+
+/** 
+ * @class GvTriangleVoxelizationBenchmark
+ *
+ * @brief Time the triangle voxelization of the voxelizer tool engine
+ * (Gvx::GvxVoxelizerEngine::voxelizeTriangle()) on a tesselated sphere.
+ *
+ * The number of triangles grows with the dataset resolution.
+ * Borders and mipmap of the voxelizer engine are not timed.
+ *
+ * Items are triangles.
+ */
+class GvTriangleVoxelizationBenchmark : public GvBenchmarkCase
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvTriangleVoxelizationBenchmark();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvTriangleVoxelizationBenchmark();
+
+	/**
+	 * Prepare the benchmark (not timed)
+	 *
+	 * @param pWorkingDirectory directory where synthetic datasets are written
+	 * @param pSize resolution of the synthetic dataset
+	 * @param pNbThreads number of threads
+	 *
+	 * @return a flag telling wheter or not the case can be run
+	 */
+	virtual bool setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads );
+
+	/**
+	 * Run the benchmark (timed)
+	 *
+	 * @return the number of processed items
+	 */
+	virtual double run();
+
+	/**
+	 * Clean intermediate data after a timed run (not timed)
+	 */
+	virtual void postRun();
+
+protected:
+
+	/**
+	 * Name of the generated files
+	 */
+	std::string _name;
+
+	/**
+	 * Finest level of resolution
+	 */
+	unsigned int _level;
+
+	/**
+	 * Triangle list (9 floats per triangle)
+	 */
+	std::vector< float > _vertices;
+
+	/**
+	 * Voxelizer engine of the current run
+	 */
+	Gvx::GvxVoxelizerEngine* _engine;
+
+};
+
+/** 
+ * @class GvRLECompressionBenchmark
+ *
+ * @brief Time the host-side RLE compression of the RLECompression test
+ * (RLECompressor::compressionPrefixSum()) on voxels of the synthetic dataset.
+ *
+ * Blocks are split in contiguous ranges, one per thread.
+ *
+ * Items are compressed elements.
+ */
+class GvRLECompressionBenchmark : public GvBenchmarkCase
+{
+
+public:
+
+	/**
+	 * Constructor
+	 *
+	 * @param pName name of the benchmark
+	 */
+	GvRLECompressionBenchmark( const std::string& pName = "rle_compression" );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvRLECompressionBenchmark();
+
+	/**
+	 * Prepare the benchmark (not timed)
+	 *
+	 * @param pWorkingDirectory directory where synthetic datasets are written
+	 * @param pSize resolution of the synthetic dataset
+	 * @param pNbThreads number of threads
+	 *
+	 * @return a flag telling wheter or not the case can be run
+	 */
+	virtual bool setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads );
+
+	/**
+	 * Run the benchmark (timed)
+	 *
+	 * @return the number of processed items
+	 */
+	virtual double run();
+
+	/**
+	 * Clean data after the last iteration (not timed)
+	 */
+	virtual void tearDown();
+
+	/**
+	 * Retrieve the range of blocks processed by a thread
+	 *
+	 * @param pThreadIndex index of the thread
+	 * @param pNbThreads number of threads
+	 * @param pFirstBlock first block of the range
+	 * @param pLastBlock block after the last one of the range
+	 */
+	void getBlockRange( unsigned int pThreadIndex, unsigned int pNbThreads, unsigned int& pFirstBlock, unsigned int& pLastBlock ) const;
+
+	/**
+	 * Compress the blocks of a thread
+	 *
+	 * @param pThreadIndex index of the thread
+	 * @param pNbThreads number of threads
+	 */
+	void compress( unsigned int pThreadIndex, unsigned int pNbThreads );
+
+	/**
+	 * Decompress the blocks of a thread
+	 *
+	 * @param pThreadIndex index of the thread
+	 * @param pNbThreads number of threads
+	 */
+	void decompress( unsigned int pThreadIndex, unsigned int pNbThreads );
+
+protected:
+
+	/**
+	 * Number of compression blocks
+	 */
+	unsigned int _nbBlocks;
+
+	/**
+	 * Input data
+	 */
+	std::vector< unsigned int > _input;
+
+	/**
+	 * Compressed data (see RLECompressor::compressionPrefixSum())
+	 */
+	std::vector< unsigned int > _blocksEnds;
+	std::vector< unsigned int > _plateausValues;
+	std::vector< unsigned char > _plateausStarts;
+
+	/**
+	 * Decompressed data
+	 */
+	std::vector< unsigned int > _output;
+
+};
+
+/** 
+ * @class GvRLEDecompressionBenchmark
+ *
+ * @brief Time a host-side decompression of the data written by the RLE compression.
+ * The round-trip is checked during set up.
+ *
+ * Items are decompressed elements.
+ */
+class GvRLEDecompressionBenchmark : public GvRLECompressionBenchmark
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvRLEDecompressionBenchmark();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvRLEDecompressionBenchmark();
+
+	/**
+	 * Prepare the benchmark (not timed)
+	 *
+	 * @param pWorkingDirectory directory where synthetic datasets are written
+	 * @param pSize resolution of the synthetic dataset
+	 * @param pNbThreads number of threads
+	 *
+	 * @return a flag telling wheter or not the case can be run
+	 */
+	virtual bool setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads );
+
+	/**
+	 * Run the benchmark (timed)
+	 *
+	 * @return the number of processed items
+	 */
+	virtual double run();
+
+};
+
+#endif
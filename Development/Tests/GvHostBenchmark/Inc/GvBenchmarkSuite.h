@@ -0,0 +1,228 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#ifndef _GV_BENCHMARK_SUITE_H_
+#define _GV_BENCHMARK_SUITE_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+class GvBenchmarkCase;
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+/** 
+ * @class GvBenchmarkSuite
+ *
+ * @brief The GvBenchmarkSuite class runs a list of host benchmarks
+ * for several sizes and thread counts, and reports timings in a JSON file.
+ *
+ * The JSON report is meant to be archived per commit to track regressions.
+ */
+class GvBenchmarkSuite
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Timing result of one benchmark configuration
+	 */
+	struct Result
+	{
+		/**
+		 * Benchmark name
+		 */
+		std::string _name;
+
+		/**
+		 * Resolution of the synthetic dataset
+		 */
+		unsigned int _size;
+
+		/**
+		 * Number of threads
+		 */
+		unsigned int _nbThreads;
+
+		/**
+		 * Number of timed iterations
+		 */
+		unsigned int _nbIterations;
+
+		/**
+		 * Min, mean and max time of an iteration (in milliseconds)
+		 */
+		float _minTime;
+		float _meanTime;
+		float _maxTime;
+
+		/**
+		 * Number of items processed by one iteration
+		 */
+		double _nbItems;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pWorkingDirectory directory where synthetic datasets are written
+	 */
+	GvBenchmarkSuite( const std::string& pWorkingDirectory );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvBenchmarkSuite();
+
+	/**
+	 * Add a benchmark to the suite (the suite takes ownership)
+	 *
+	 * @param pCase the benchmark
+	 */
+	void addCase( GvBenchmarkCase* pCase );
+
+	/**
+	 * Run all benchmarks
+	 *
+	 * @param pSizes list of synthetic dataset resolutions
+	 * @param pThreads list of thread counts (only used by multi-threaded benchmarks)
+	 * @param pNbIterations number of timed iterations per configuration
+	 * @param pFilter if not empty, only benchmarks whose name contains this string are run
+	 *
+	 * @return a flag telling wheter or not all benchmarks have succeeded
+	 */
+	bool run( const std::vector< unsigned int >& pSizes, const std::vector< unsigned int >& pThreads, unsigned int pNbIterations, const std::string& pFilter );
+
+	/**
+	 * Get the results
+	 *
+	 * @return the results
+	 */
+	const std::vector< Result >& getResults() const;
+
+	/**
+	 * Write the results in a JSON file
+	 *
+	 * @param pFileName the JSON file name
+	 * @param pTag a user tag identifying the run (i.e. a commit id)
+	 *
+	 * @return a flag telling wheter or not the file has been written
+	 */
+	bool writeJSON( const std::string& pFileName, const std::string& pTag ) const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Directory where synthetic datasets are written
+	 */
+	std::string _workingDirectory;
+
+	/**
+	 * List of benchmarks
+	 */
+	std::vector< GvBenchmarkCase* > _cases;
+
+	/**
+	 * List of results
+	 */
+	std::vector< Result > _results;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Run one benchmark configuration
+	 *
+	 * @param pCase the benchmark
+	 * @param pSize resolution of the synthetic dataset
+	 * @param pNbThreads number of threads
+	 * @param pNbIterations number of timed iterations
+	 *
+	 * @return a flag telling wheter or not the benchmark has succeeded
+	 */
+	bool runCase( GvBenchmarkCase* pCase, unsigned int pSize, unsigned int pNbThreads, unsigned int pNbIterations );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvBenchmarkSuite( const GvBenchmarkSuite& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvBenchmarkSuite& operator=( const GvBenchmarkSuite& );
+
+};
+
+#endif
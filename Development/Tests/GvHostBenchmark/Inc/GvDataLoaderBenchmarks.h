@@ -0,0 +1,219 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#ifndef _GV_DATA_LOADER_BENCHMARKS_H_
+#define _GV_DATA_LOADER_BENCHMARKS_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvBenchmarkCase.h"
+
+// Cuda
+#include <vector_types.h>
+
+// Loki
+#include <loki/Typelist.h>
+
+// STL
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/**
+ * Data type list of the synthetic dataset
+ */
+typedef Loki::TL::MakeTypelist< uchar4 >::Result GvBenchmarkDataTypeList;
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+class GvSyntheticDataset;
+
+namespace GvUtils
+{
+	template< typename TDataTypeList >
+	class GvDataLoader;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+/** 
+ * @class GvDataLoaderLoadBenchmark
+ *
+ * @brief Time the opening of a dataset by GvUtils::GvDataLoader
+ * (XML descriptor parsing and file names generation).
+ *
+ * The loader is used without its cache : the cache mode allocates
+ * page-locked memory with the CUDA runtime, which requires a device.
+ *
+ * Items are opened datasets.
+ */
+class GvDataLoaderLoadBenchmark : public GvBenchmarkCase
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvDataLoaderLoadBenchmark();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvDataLoaderLoadBenchmark();
+
+	/**
+	 * Prepare the benchmark (not timed)
+	 *
+	 * @param pWorkingDirectory directory where temporary files are written
+	 * @param pSize resolution of the dataset
+	 * @param pNbThreads number of threads
+	 *
+	 * @return a flag telling wheter or not the case can be run
+	 */
+	virtual bool setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads );
+
+	/**
+	 * Run the benchmark (timed)
+	 *
+	 * @return the number of processed items
+	 */
+	virtual double run();
+
+	/**
+	 * Clean data after the last iteration (not timed)
+	 */
+	virtual void tearDown();
+
+protected:
+
+	/**
+	 * Synthetic dataset
+	 */
+	GvSyntheticDataset* _dataset;
+
+};
+
+/** 
+ * @class GvDataLoaderLookupBenchmark
+ *
+ * @brief Time the node lookups of GvUtils::GvDataLoader::getRegionInfoNew()
+ * over all nodes of all levels of resolution of the synthetic dataset.
+ *
+ * Without cache, each lookup opens its own files, so lookups can be
+ * run concurrently. Nodes of a level are split in contiguous ranges, one per thread.
+ *
+ * Items are node lookups.
+ */
+class GvDataLoaderLookupBenchmark : public GvBenchmarkCase
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvDataLoaderLookupBenchmark();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvDataLoaderLookupBenchmark();
+
+	/**
+	 * Prepare the benchmark (not timed)
+	 *
+	 * @param pWorkingDirectory directory where temporary files are written
+	 * @param pSize resolution of the dataset
+	 * @param pNbThreads number of threads
+	 *
+	 * @return a flag telling wheter or not the case can be run
+	 */
+	virtual bool setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads );
+
+	/**
+	 * Run the benchmark (timed)
+	 *
+	 * @return the number of processed items
+	 */
+	virtual double run();
+
+	/**
+	 * Clean data after the last iteration (not timed)
+	 */
+	virtual void tearDown();
+
+	/**
+	 * Look up the nodes of a thread at the current level
+	 *
+	 * @param pThreadIndex index of the thread
+	 * @param pNbThreads number of threads
+	 */
+	void lookup( unsigned int pThreadIndex, unsigned int pNbThreads );
+
+protected:
+
+	/**
+	 * Synthetic dataset
+	 */
+	GvSyntheticDataset* _dataset;
+
+	/**
+	 * Data loader
+	 */
+	GvUtils::GvDataLoader< GvBenchmarkDataTypeList >* _dataLoader;
+
+	/**
+	 * Number of nodes in each dimension at the current level
+	 */
+	unsigned int _nodeGridSize;
+
+	/**
+	 * Number of non-empty nodes found (one counter per thread)
+	 */
+	std::vector< unsigned int > _nbNonEmptyNodes;
+
+};
+
+#endif
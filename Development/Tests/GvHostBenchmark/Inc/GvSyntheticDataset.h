@@ -0,0 +1,247 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#ifndef _GV_SYNTHETIC_DATASET_H_
+#define _GV_SYNTHETIC_DATASET_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+namespace GvVoxelizer
+{
+	class GvDataStructureIOHandler;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+/** 
+ * @class GvSyntheticDataset
+ *
+ * @brief The GvSyntheticDataset class generates deterministic GigaVoxels datasets
+ * (nodes, bricks, summaries and XML descriptor) used by host benchmarks.
+ *
+ * The volume is a sphere shell with hashed colors around a constant core,
+ * so that it contains empty, constant and heterogeneous nodes.
+ * Data is stored as uchar4 with 8^3 bricks, as expected by the mipmap generator.
+ */
+class GvSyntheticDataset
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pWorkingDirectory directory where files are written
+	 * @param pResolution number of voxels in each dimension at the finest level (power of two, at least 8)
+	 * @param pSeed seed of the color hash
+	 */
+	GvSyntheticDataset( const std::string& pWorkingDirectory, unsigned int pResolution, unsigned int pSeed = 0 );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvSyntheticDataset();
+
+	/**
+	 * Get the dataset name (path included, without extension)
+	 *
+	 * @return the dataset name
+	 */
+	const std::string& getName() const;
+
+	/**
+	 * Get the XML descriptor file name
+	 *
+	 * @return the XML descriptor file name
+	 */
+	std::string getDescriptorFileName() const;
+
+	/**
+	 * Get the number of voxels in each dimension at the finest level
+	 *
+	 * @return the resolution
+	 */
+	unsigned int getResolution() const;
+
+	/**
+	 * Get the finest level of resolution of the data structure
+	 *
+	 * @return the finest level
+	 */
+	unsigned int getLevel() const;
+
+	/**
+	 * Get the brick width
+	 *
+	 * @return the brick width
+	 */
+	unsigned int getBrickWidth() const;
+
+	/**
+	 * Get the value of a voxel at the finest level
+	 *
+	 * @param pX x voxel position
+	 * @param pY y voxel position
+	 * @param pZ z voxel position
+	 * @param pVoxelData the voxel value (uchar4)
+	 *
+	 * @return a flag telling wheter or not the voxel is not empty
+	 */
+	bool getVoxel( unsigned int pX, unsigned int pY, unsigned int pZ, unsigned char pVoxelData[ 4 ] ) const;
+
+	/**
+	 * Write all non-empty voxels in the finest level
+	 *
+	 * @param pIOHandler data structure handler of the finest level
+	 *
+	 * @return the number of written voxels
+	 */
+	unsigned int fill( GvVoxelizer::GvDataStructureIOHandler& pIOHandler ) const;
+
+	/**
+	 * Write the finest level (voxels only, no border)
+	 *
+	 * @return the number of written voxels
+	 */
+	unsigned int writeFinestLevel() const;
+
+	/**
+	 * Generate the whole dataset : finest level, borders, mipmap pyramid and XML descriptor
+	 *
+	 * @return a flag telling wheter or not the process has succeeded
+	 */
+	bool generate() const;
+
+	/**
+	 * Write the XML descriptor read by GvUtils::GvDataLoader
+	 *
+	 * @return a flag telling wheter or not the process has succeeded
+	 */
+	bool writeDescriptor() const;
+
+	/**
+	 * Generate a triangulated sphere in [ 0.0 ; 1.0 ]^3
+	 *
+	 * @param pNbSlices number of slices (around Z axis)
+	 * @param pNbStacks number of stacks (along Z axis)
+	 * @param pVertices the resulting triangle list (9 floats per triangle)
+	 */
+	static void generateSphereMesh( unsigned int pNbSlices, unsigned int pNbStacks, std::vector< float >& pVertices );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Dataset name (path included, without extension)
+	 */
+	std::string _name;
+
+	/**
+	 * Number of voxels in each dimension at the finest level
+	 */
+	unsigned int _resolution;
+
+	/**
+	 * Finest level of resolution
+	 */
+	unsigned int _level;
+
+	/**
+	 * Seed of the color hash
+	 */
+	unsigned int _seed;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Integer hash used to generate deterministic colors
+	 *
+	 * @param pValue the value to hash
+	 *
+	 * @return the hashed value
+	 */
+	static unsigned int hash( unsigned int pValue );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvSyntheticDataset( const GvSyntheticDataset& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvSyntheticDataset& operator=( const GvSyntheticDataset& );
+
+};
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvBenchmarkCase.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <vector>
+
+// System
+#include <pthread.h>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/**
+ * Arguments of a worker thread
+ */
+struct GvBenchmarkThreadArguments
+{
+	GvBenchmarkCase::Task _task;
+	void* _data;
+	unsigned int _threadIndex;
+	unsigned int _nbThreads;
+};
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Worker thread entry point
+ *
+ * @param pArguments thread arguments
+ ******************************************************************************/
+static void* runTask( void* pArguments )
+{
+	GvBenchmarkThreadArguments* arguments = static_cast< GvBenchmarkThreadArguments* >( pArguments );
+	arguments->_task( arguments->_data, arguments->_threadIndex, arguments->_nbThreads );
+
+	return NULL;
+}
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pName name of the benchmark (used in reports)
+ * @param pIsMultiThreaded flag telling wheter or not the case uses several threads
+ ******************************************************************************/
+GvBenchmarkCase::GvBenchmarkCase( const std::string& pName, bool pIsMultiThreaded )
+:	_name( pName )
+,	_isMultiThreaded( pIsMultiThreaded )
+,	_nbThreads( 1 )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvBenchmarkCase::~GvBenchmarkCase()
+{
+}
+
+/******************************************************************************
+ * Get the name of the benchmark
+ *
+ * @return the name of the benchmark
+ ******************************************************************************/
+const std::string& GvBenchmarkCase::getName() const
+{
+	return _name;
+}
+
+/******************************************************************************
+ * Tell wheter or not the case uses several threads.
+ * Single-threaded cases are only run once per size.
+ *
+ * @return a flag telling wheter or not the case uses several threads
+ ******************************************************************************/
+bool GvBenchmarkCase::isMultiThreaded() const
+{
+	return _isMultiThreaded;
+}
+
+/******************************************************************************
+ * Clean intermediate data after a timed run (not timed)
+ ******************************************************************************/
+void GvBenchmarkCase::postRun()
+{
+}
+
+/******************************************************************************
+ * Clean data after the last iteration (not timed)
+ ******************************************************************************/
+void GvBenchmarkCase::tearDown()
+{
+}
+
+/******************************************************************************
+ * Launch a task on several threads and wait for their completion
+ *
+ * @param pTask the task
+ * @param pData user data passed to the task
+ * @param pNbThreads number of threads
+ ******************************************************************************/
+void GvBenchmarkCase::runParallel( Task pTask, void* pData, unsigned int pNbThreads )
+{
+	// Single thread : no need to spawn threads
+	if ( pNbThreads <= 1 )
+	{
+		pTask( pData, 0, 1 );
+
+		return;
+	}
+
+	std::vector< pthread_t > threads( pNbThreads );
+	std::vector< GvBenchmarkThreadArguments > arguments( pNbThreads );
+	for ( unsigned int i = 0; i < pNbThreads; i++ )
+	{
+		arguments[ i ]._task = pTask;
+		arguments[ i ]._data = pData;
+		arguments[ i ]._threadIndex = i;
+		arguments[ i ]._nbThreads = pNbThreads;
+	}
+
+	// The calling thread handles the first part of the work
+	for ( unsigned int i = 1; i < pNbThreads; i++ )
+	{
+		pthread_create( &threads[ i ], NULL, runTask, &arguments[ i ] );
+	}
+	runTask( &arguments[ 0 ] );
+	for ( unsigned int i = 1; i < pNbThreads; i++ )
+	{
+		pthread_join( threads[ i ], NULL );
+	}
+}
@@ -0,0 +1,627 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvBenchmarkCases.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvSyntheticDataset.h"
+
+// GigaVoxels
+#include <GvVoxelizer/GvDataTypeHandler.h>
+#include <GvVoxelizer/GvDataStructureIOHandler.h>
+#include <GvVoxelizer/GvDataStructureMipmapGenerator.h>
+
+// Voxelizer tool
+#include "GvxVoxelizerEngine.h"
+
+// RLE compression test
+#include <climits>
+#include "RLECompressor.h"
+#include "macros.h"
+
+// STL
+#include <iostream>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvVoxelizer;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * RLE compression task
+ *
+ * @param pData the benchmark
+ * @param pThreadIndex index of the thread
+ * @param pNbThreads number of threads
+ ******************************************************************************/
+static void compressionTask( void* pData, unsigned int pThreadIndex, unsigned int pNbThreads )
+{
+	static_cast< GvRLECompressionBenchmark* >( pData )->compress( pThreadIndex, pNbThreads );
+}
+
+/******************************************************************************
+ * RLE decompression task
+ *
+ * @param pData the benchmark
+ * @param pThreadIndex index of the thread
+ * @param pNbThreads number of threads
+ ******************************************************************************/
+static void decompressionTask( void* pData, unsigned int pThreadIndex, unsigned int pNbThreads )
+{
+	static_cast< GvRLECompressionBenchmark* >( pData )->decompress( pThreadIndex, pNbThreads );
+}
+
+/******************************************************************************
+ ***************************** SET VOXEL BENCHMARK ****************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvIOHandlerSetVoxelBenchmark::GvIOHandlerSetVoxelBenchmark()
+:	GvBenchmarkCase( "io_handler_set_voxel", false )
+,	_dataset( NULL )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvIOHandlerSetVoxelBenchmark::~GvIOHandlerSetVoxelBenchmark()
+{
+	tearDown();
+}
+
+/******************************************************************************
+ * Prepare the benchmark (not timed)
+ ******************************************************************************/
+bool GvIOHandlerSetVoxelBenchmark::setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads )
+{
+	_dataset = new GvSyntheticDataset( pWorkingDirectory, pSize );
+
+	return true;
+}
+
+/******************************************************************************
+ * Run the benchmark (timed)
+ ******************************************************************************/
+double GvIOHandlerSetVoxelBenchmark::run()
+{
+	return static_cast< double >( _dataset->writeFinestLevel() );
+}
+
+/******************************************************************************
+ * Clean data after the last iteration (not timed)
+ ******************************************************************************/
+void GvIOHandlerSetVoxelBenchmark::tearDown()
+{
+	delete _dataset;
+	_dataset = NULL;
+}
+
+/******************************************************************************
+ ***************************** GET VOXEL BENCHMARK ****************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvIOHandlerGetVoxelBenchmark::GvIOHandlerGetVoxelBenchmark()
+:	GvBenchmarkCase( "io_handler_get_voxel", false )
+,	_dataset( NULL )
+,	_ioHandler( NULL )
+,	_checksum( 0 )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvIOHandlerGetVoxelBenchmark::~GvIOHandlerGetVoxelBenchmark()
+{
+	tearDown();
+}
+
+/******************************************************************************
+ * Prepare the benchmark (not timed)
+ ******************************************************************************/
+bool GvIOHandlerGetVoxelBenchmark::setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads )
+{
+	_dataset = new GvSyntheticDataset( pWorkingDirectory, pSize );
+	_dataset->writeFinestLevel();
+
+	std::vector< GvDataTypeHandler::VoxelDataType > dataTypes;
+	dataTypes.push_back( GvDataTypeHandler::gvUCHAR4 );
+	_ioHandler = new GvDataStructureIOHandler( _dataset->getName(), _dataset->getLevel(), _dataset->getBrickWidth(), dataTypes, false );
+
+	return true;
+}
+
+/******************************************************************************
+ * Run the benchmark (timed)
+ ******************************************************************************/
+double GvIOHandlerGetVoxelBenchmark::run()
+{
+	const unsigned int brickWidth = _dataset->getBrickWidth();
+	const unsigned int nodeGridSize = _dataset->getResolution() / brickWidth;
+
+	// Iterate node by node to benefit from the handler brick cache
+	unsigned int voxelPos[ 3 ];
+	unsigned char voxelData[ 4 ];
+	for ( unsigned int nz = 0; nz < nodeGridSize; nz++ )
+	for ( unsigned int ny = 0; ny < nodeGridSize; ny++ )
+	for ( unsigned int nx = 0; nx < nodeGridSize; nx++ )
+	{
+		for ( voxelPos[ 2 ] = nz * brickWidth; voxelPos[ 2 ] < ( nz + 1 ) * brickWidth; voxelPos[ 2 ]++ )
+		for ( voxelPos[ 1 ] = ny * brickWidth; voxelPos[ 1 ] < ( ny + 1 ) * brickWidth; voxelPos[ 1 ]++ )
+		for ( voxelPos[ 0 ] = nx * brickWidth; voxelPos[ 0 ] < ( nx + 1 ) * brickWidth; voxelPos[ 0 ]++ )
+		{
+			_ioHandler->getVoxel( voxelPos, voxelData, 0 );
+			_checksum += voxelData[ 0 ] + voxelData[ 3 ];
+		}
+	}
+
+	const double resolution = static_cast< double >( _dataset->getResolution() );
+
+	return resolution * resolution * resolution;
+}
+
+/******************************************************************************
+ * Clean data after the last iteration (not timed)
+ ******************************************************************************/
+void GvIOHandlerGetVoxelBenchmark::tearDown()
+{
+	delete _ioHandler;
+	_ioHandler = NULL;
+	delete _dataset;
+	_dataset = NULL;
+}
+
+/******************************************************************************
+ ****************************** BORDERS BENCHMARK *****************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvBordersBenchmark::GvBordersBenchmark()
+:	GvBenchmarkCase( "compute_borders", false )
+,	_dataset( NULL )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvBordersBenchmark::~GvBordersBenchmark()
+{
+	tearDown();
+}
+
+/******************************************************************************
+ * Prepare the benchmark (not timed)
+ ******************************************************************************/
+bool GvBordersBenchmark::setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads )
+{
+	_dataset = new GvSyntheticDataset( pWorkingDirectory, pSize );
+	_dataset->writeFinestLevel();
+
+	return true;
+}
+
+/******************************************************************************
+ * Run the benchmark (timed)
+ ******************************************************************************/
+double GvBordersBenchmark::run()
+{
+	std::vector< GvDataTypeHandler::VoxelDataType > dataTypes;
+	dataTypes.push_back( GvDataTypeHandler::gvUCHAR4 );
+
+	GvDataStructureIOHandler ioHandler( _dataset->getName(), _dataset->getLevel(), _dataset->getBrickWidth(), dataTypes, false );
+	ioHandler.computeBorders();
+
+	const double nodeGridSize = static_cast< double >( ioHandler._nodeGridSize );
+
+	return nodeGridSize * nodeGridSize * nodeGridSize;
+}
+
+/******************************************************************************
+ * Clean data after the last iteration (not timed)
+ ******************************************************************************/
+void GvBordersBenchmark::tearDown()
+{
+	delete _dataset;
+	_dataset = NULL;
+}
+
+/******************************************************************************
+ ****************************** MIPMAP BENCHMARK ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvMipmapBenchmark::GvMipmapBenchmark()
+:	GvBenchmarkCase( "mipmap_pyramid", false )
+,	_dataset( NULL )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvMipmapBenchmark::~GvMipmapBenchmark()
+{
+	tearDown();
+}
+
+/******************************************************************************
+ * Prepare the benchmark (not timed)
+ ******************************************************************************/
+bool GvMipmapBenchmark::setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads )
+{
+	_dataset = new GvSyntheticDataset( pWorkingDirectory, pSize );
+	_dataset->writeFinestLevel();
+
+	std::vector< GvDataTypeHandler::VoxelDataType > dataTypes;
+	dataTypes.push_back( GvDataTypeHandler::gvUCHAR4 );
+
+	GvDataStructureIOHandler ioHandler( _dataset->getName(), _dataset->getLevel(), _dataset->getBrickWidth(), dataTypes, false );
+	ioHandler.computeBorders();
+
+	return true;
+}
+
+/******************************************************************************
+ * Run the benchmark (timed)
+ ******************************************************************************/
+double GvMipmapBenchmark::run()
+{
+	GvDataStructureMipmapGenerator::generateMipmapPyramid( _dataset->getName(), _dataset->getResolution() );
+
+	const double resolution = static_cast< double >( _dataset->getResolution() );
+
+	return resolution * resolution * resolution;
+}
+
+/******************************************************************************
+ * Clean data after the last iteration (not timed)
+ ******************************************************************************/
+void GvMipmapBenchmark::tearDown()
+{
+	delete _dataset;
+	_dataset = NULL;
+}
+
+/******************************************************************************
+ ************************ TRIANGLE VOXELIZATION BENCHMARK *********************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvTriangleVoxelizationBenchmark::GvTriangleVoxelizationBenchmark()
+:	GvBenchmarkCase( "triangle_voxelization", false )
+,	_level( 0 )
+,	_engine( NULL )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvTriangleVoxelizationBenchmark::~GvTriangleVoxelizationBenchmark()
+{
+	postRun();
+}
+
+/******************************************************************************
+ * Prepare the benchmark (not timed)
+ ******************************************************************************/
+bool GvTriangleVoxelizationBenchmark::setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads )
+{
+	GvSyntheticDataset dataset( pWorkingDirectory, pSize );
+	_name = dataset.getName() + "_mesh";
+	_level = dataset.getLevel();
+
+	// The number of triangles grows with the resolution, so that triangles keep a similar size in voxels
+	GvSyntheticDataset::generateSphereMesh( pSize, pSize / 2, _vertices );
+
+	return ! _vertices.empty();
+}
+
+/******************************************************************************
+ * Run the benchmark (timed)
+ ******************************************************************************/
+double GvTriangleVoxelizationBenchmark::run()
+{
+	_engine = new Gvx::GvxVoxelizerEngine();
+	_engine->_useTexture = false;
+	_engine->setNormals( false );
+	_engine->setFilterType( 0 );
+	_engine->setNbFilterApplications( 0 );
+	_engine->init( _level, 8, _name, Gvx::GvxDataTypeHandler::gvUCHAR4 );
+
+	const size_t nbTriangles = _vertices.size() / 9;
+	for ( size_t i = 0; i < nbTriangles; i++ )
+	{
+		const float* triangle = &_vertices[ 9 * i ];
+		for ( unsigned int v = 0; v < 3; v++ )
+		{
+			_engine->setVertex( triangle[ 3 * v ], triangle[ 3 * v + 1 ], triangle[ 3 * v + 2 ] );
+			_engine->setColor( triangle[ 3 * v ], triangle[ 3 * v + 1 ], triangle[ 3 * v + 2 ] );
+		}
+		_engine->voxelizeTriangle();
+	}
+
+	return static_cast< double >( nbTriangles );
+}
+
+/******************************************************************************
+ * Clean intermediate data after a timed run (not timed)
+ ******************************************************************************/
+void GvTriangleVoxelizationBenchmark::postRun()
+{
+	if ( _engine != NULL )
+	{
+		// Flush and release the engine files (borders and mipmap are written here)
+		_engine->end();
+		delete _engine;
+		_engine = NULL;
+	}
+}
+
+/******************************************************************************
+ ************************** RLE COMPRESSION BENCHMARK *************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pName name of the benchmark
+ ******************************************************************************/
+GvRLECompressionBenchmark::GvRLECompressionBenchmark( const std::string& pName )
+:	GvBenchmarkCase( pName, true )
+,	_nbBlocks( 0 )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvRLECompressionBenchmark::~GvRLECompressionBenchmark()
+{
+}
+
+/******************************************************************************
+ * Prepare the benchmark (not timed)
+ ******************************************************************************/
+bool GvRLECompressionBenchmark::setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads )
+{
+	_nbThreads = pNbThreads;
+
+	// Voxels of the synthetic dataset, in scanline order, packed in 32 bits
+	GvSyntheticDataset dataset( pWorkingDirectory, pSize );
+	_nbBlocks = ( pSize * pSize * pSize ) / BRICK_SIZE;
+	_input.resize( _nbBlocks * BRICK_SIZE );
+	unsigned char voxelData[ 4 ];
+	for ( size_t i = 0; i < _input.size(); i++ )
+	{
+		const unsigned int x = static_cast< unsigned int >( i % pSize );
+		const unsigned int y = static_cast< unsigned int >( ( i / pSize ) % pSize );
+		const unsigned int z = static_cast< unsigned int >( i / ( pSize * pSize ) );
+		dataset.getVoxel( x, y, z, voxelData );
+		_input[ i ] = voxelData[ 0 ] | ( voxelData[ 1 ] << 8 ) | ( voxelData[ 2 ] << 16 ) | ( voxelData[ 3 ] << 24 );
+	}
+
+	_blocksEnds.resize( _nbBlocks );
+	_plateausValues.resize( _input.size() );
+	_plateausStarts.resize( _input.size() );
+	_output.resize( _input.size() );
+
+	return _nbBlocks > 0;
+}
+
+/******************************************************************************
+ * Run the benchmark (timed)
+ ******************************************************************************/
+double GvRLECompressionBenchmark::run()
+{
+	runParallel( compressionTask, this, _nbThreads );
+
+	return static_cast< double >( _input.size() );
+}
+
+/******************************************************************************
+ * Clean data after the last iteration (not timed)
+ ******************************************************************************/
+void GvRLECompressionBenchmark::tearDown()
+{
+	_input.clear();
+	_blocksEnds.clear();
+	_plateausValues.clear();
+	_plateausStarts.clear();
+	_output.clear();
+}
+
+/******************************************************************************
+ * Retrieve the range of blocks processed by a thread
+ *
+ * @param pThreadIndex index of the thread
+ * @param pNbThreads number of threads
+ * @param pFirstBlock first block of the range
+ * @param pLastBlock block after the last one of the range
+ ******************************************************************************/
+void GvRLECompressionBenchmark::getBlockRange( unsigned int pThreadIndex, unsigned int pNbThreads, unsigned int& pFirstBlock, unsigned int& pLastBlock ) const
+{
+	pFirstBlock = static_cast< unsigned int >( ( static_cast< unsigned long long >( _nbBlocks ) * pThreadIndex ) / pNbThreads );
+	pLastBlock = static_cast< unsigned int >( ( static_cast< unsigned long long >( _nbBlocks ) * ( pThreadIndex + 1 ) ) / pNbThreads );
+}
+
+/******************************************************************************
+ * Compress the blocks of a thread.
+ * Each range is compressed independently, so block ends are relative to the range.
+ *
+ * @param pThreadIndex index of the thread
+ * @param pNbThreads number of threads
+ ******************************************************************************/
+void GvRLECompressionBenchmark::compress( unsigned int pThreadIndex, unsigned int pNbThreads )
+{
+	unsigned int firstBlock;
+	unsigned int lastBlock;
+	getBlockRange( pThreadIndex, pNbThreads, firstBlock, lastBlock );
+	if ( firstBlock == lastBlock )
+	{
+		return;
+	}
+
+	const size_t offset = static_cast< size_t >( firstBlock ) * BRICK_SIZE;
+
+	RLECompressor compressor;
+	compressor.compressionPrefixSum( &_input[ offset ], lastBlock - firstBlock, &_blocksEnds[ firstBlock ], &_plateausValues[ offset ], &_plateausStarts[ offset ] );
+}
+
+/******************************************************************************
+ * Decompress the blocks of a thread
+ *
+ * @param pThreadIndex index of the thread
+ * @param pNbThreads number of threads
+ ******************************************************************************/
+void GvRLECompressionBenchmark::decompress( unsigned int pThreadIndex, unsigned int pNbThreads )
+{
+	unsigned int firstBlock;
+	unsigned int lastBlock;
+	getBlockRange( pThreadIndex, pNbThreads, firstBlock, lastBlock );
+
+	const size_t offset = static_cast< size_t >( firstBlock ) * BRICK_SIZE;
+	const unsigned int* values = &_plateausValues[ 0 ] + offset;
+	const unsigned char* starts = &_plateausStarts[ 0 ] + offset;
+
+	for ( unsigned int block = firstBlock; block < lastBlock; block++ )
+	{
+		const unsigned int blockStart = ( block > firstBlock ) ? _blocksEnds[ block - 1 ] : 0;
+		const unsigned int nbElements = _blocksEnds[ block ] - blockStart;
+		unsigned int* output = &_output[ static_cast< size_t >( block ) * BRICK_SIZE ];
+
+		// Blocks with too many plateaus are stored without compression
+		if ( nbElements >= MAX_COMPRESSED_BRICK_SIZE )
+		{
+			for ( unsigned int i = 0; i < BRICK_SIZE; i++ )
+			{
+				output[ i ] = values[ blockStart + i ];
+			}
+
+			continue;
+		}
+
+		// Expand plateaus
+		for ( unsigned int p = 0; p < nbElements; p++ )
+		{
+			const unsigned int plateauEnd = ( p + 1 < nbElements ) ? starts[ blockStart + p + 1 ] : BRICK_SIZE;
+			for ( unsigned int i = starts[ blockStart + p ]; i < plateauEnd; i++ )
+			{
+				output[ i ] = values[ blockStart + p ];
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ ************************* RLE DECOMPRESSION BENCHMARK ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvRLEDecompressionBenchmark::GvRLEDecompressionBenchmark()
+:	GvRLECompressionBenchmark( "rle_decompression" )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvRLEDecompressionBenchmark::~GvRLEDecompressionBenchmark()
+{
+}
+
+/******************************************************************************
+ * Prepare the benchmark (not timed)
+ ******************************************************************************/
+bool GvRLEDecompressionBenchmark::setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads )
+{
+	if ( ! GvRLECompressionBenchmark::setUp( pWorkingDirectory, pSize, pNbThreads ) )
+	{
+		return false;
+	}
+
+	// Compress data, then check the round-trip
+	runParallel( compressionTask, this, _nbThreads );
+	runParallel( decompressionTask, this, _nbThreads );
+	if ( _output != _input )
+	{
+		std::cerr << "GvRLEDecompressionBenchmark::setUp : RLE round-trip failed" << std::endl;
+
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Run the benchmark (timed)
+ ******************************************************************************/
+double GvRLEDecompressionBenchmark::run()
+{
+	runParallel( decompressionTask, this, _nbThreads );
+
+	return static_cast< double >( _output.size() );
+}
@@ -0,0 +1,273 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvBenchmarkSuite.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvBenchmarkCase.h"
+
+// GigaVoxels
+#include <GvPerfMon/GvPerformanceTimer.h>
+
+// STL
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+// System
+#include <cassert>
+#include <ctime>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pWorkingDirectory directory where synthetic datasets are written
+ ******************************************************************************/
+GvBenchmarkSuite::GvBenchmarkSuite( const std::string& pWorkingDirectory )
+:	_workingDirectory( pWorkingDirectory )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvBenchmarkSuite::~GvBenchmarkSuite()
+{
+	for ( size_t i = 0; i < _cases.size(); i++ )
+	{
+		delete _cases[ i ];
+	}
+}
+
+/******************************************************************************
+ * Add a benchmark to the suite (the suite takes ownership)
+ *
+ * @param pCase the benchmark
+ ******************************************************************************/
+void GvBenchmarkSuite::addCase( GvBenchmarkCase* pCase )
+{
+	assert( pCase != NULL );
+
+	_cases.push_back( pCase );
+}
+
+/******************************************************************************
+ * Run all benchmarks
+ *
+ * @param pSizes list of synthetic dataset resolutions
+ * @param pThreads list of thread counts (only used by multi-threaded benchmarks)
+ * @param pNbIterations number of timed iterations per configuration
+ * @param pFilter if not empty, only benchmarks whose name contains this string are run
+ *
+ * @return a flag telling wheter or not all benchmarks have succeeded
+ ******************************************************************************/
+bool GvBenchmarkSuite::run( const std::vector< unsigned int >& pSizes, const std::vector< unsigned int >& pThreads, unsigned int pNbIterations, const std::string& pFilter )
+{
+	bool result = true;
+
+	for ( size_t c = 0; c < _cases.size(); c++ )
+	{
+		GvBenchmarkCase* benchmarkCase = _cases[ c ];
+		if ( ! pFilter.empty() && benchmarkCase->getName().find( pFilter ) == std::string::npos )
+		{
+			continue;
+		}
+
+		for ( size_t s = 0; s < pSizes.size(); s++ )
+		{
+			// Single-threaded benchmarks are only run once per size
+			if ( ! benchmarkCase->isMultiThreaded() )
+			{
+				result = runCase( benchmarkCase, pSizes[ s ], 1, pNbIterations ) && result;
+
+				continue;
+			}
+
+			for ( size_t t = 0; t < pThreads.size(); t++ )
+			{
+				result = runCase( benchmarkCase, pSizes[ s ], pThreads[ t ], pNbIterations ) && result;
+			}
+		}
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * Run one benchmark configuration
+ *
+ * @param pCase the benchmark
+ * @param pSize resolution of the synthetic dataset
+ * @param pNbThreads number of threads
+ * @param pNbIterations number of timed iterations
+ *
+ * @return a flag telling wheter or not the benchmark has succeeded
+ ******************************************************************************/
+bool GvBenchmarkSuite::runCase( GvBenchmarkCase* pCase, unsigned int pSize, unsigned int pNbThreads, unsigned int pNbIterations )
+{
+	if ( ! pCase->setUp( _workingDirectory, pSize, pNbThreads ) )
+	{
+		std::cerr << "GvBenchmarkSuite::runCase : unable to set up " << pCase->getName() << " [ size " << pSize << " ]" << std::endl;
+		pCase->tearDown();
+
+		return false;
+	}
+
+	GvPerfMon::GvPerformanceTimer timer;
+
+	Result result;
+	result._name = pCase->getName();
+	result._size = pSize;
+	result._nbThreads = pNbThreads;
+	result._nbIterations = pNbIterations;
+	result._minTime = 0.f;
+	result._meanTime = 0.f;
+	result._maxTime = 0.f;
+	result._nbItems = 0.0;
+
+	for ( unsigned int i = 0; i < pNbIterations; i++ )
+	{
+		GvPerfMon::GvPerformanceTimer::Event event = timer.createEvent();
+		timer.startEvent( event );
+		result._nbItems = pCase->run();
+		timer.stopEvent( event );
+		pCase->postRun();
+
+		const float time = timer.getEventDuration( event );
+		result._minTime = ( i == 0 ) ? time : std::min( result._minTime, time );
+		result._maxTime = ( i == 0 ) ? time : std::max( result._maxTime, time );
+		result._meanTime += time;
+	}
+	if ( pNbIterations > 0 )
+	{
+		result._meanTime /= static_cast< float >( pNbIterations );
+	}
+
+	pCase->tearDown();
+
+	_results.push_back( result );
+
+	// LOG info
+	std::cout << result._name << " [ size " << pSize << " - threads " << pNbThreads << " ] : "
+		<< result._meanTime << " ms (min " << result._minTime << " ms - max " << result._maxTime << " ms) - "
+		<< result._nbItems << " items" << std::endl;
+
+	return true;
+}
+
+/******************************************************************************
+ * Get the results
+ *
+ * @return the results
+ ******************************************************************************/
+const std::vector< GvBenchmarkSuite::Result >& GvBenchmarkSuite::getResults() const
+{
+	return _results;
+}
+
+/******************************************************************************
+ * Write the results in a JSON file
+ *
+ * @param pFileName the JSON file name
+ * @param pTag a user tag identifying the run (i.e. a commit id)
+ *
+ * @return a flag telling wheter or not the file has been written
+ ******************************************************************************/
+bool GvBenchmarkSuite::writeJSON( const std::string& pFileName, const std::string& pTag ) const
+{
+	std::ofstream file( pFileName.c_str() );
+	if ( ! file.is_open() )
+	{
+		std::cerr << "GvBenchmarkSuite::writeJSON : unable to open file " << pFileName << std::endl;
+
+		return false;
+	}
+
+	// Escape the user tag (only quotes and backslashes are expected)
+	std::string tag;
+	for ( size_t i = 0; i < pTag.size(); i++ )
+	{
+		if ( pTag[ i ] == '"' || pTag[ i ] == '\\' )
+		{
+			tag += '\\';
+		}
+		tag += pTag[ i ];
+	}
+
+	file << "{" << std::endl;
+	file << "\t\"suite\": \"GvHostBenchmark\"," << std::endl;
+	file << "\t\"tag\": \"" << tag << "\"," << std::endl;
+	file << "\t\"timestamp\": " << static_cast< long >( time( NULL ) ) << "," << std::endl;
+	file << "\t\"results\": [" << std::endl;
+	for ( size_t i = 0; i < _results.size(); i++ )
+	{
+		const Result& result = _results[ i ];
+		const double itemsPerSecond = ( result._meanTime > 0.f ) ? ( result._nbItems * 1000.0 / result._meanTime ) : 0.0;
+
+		file << "\t\t{ "
+			<< "\"name\": \"" << result._name << "\", "
+			<< "\"size\": " << result._size << ", "
+			<< "\"threads\": " << result._nbThreads << ", "
+			<< "\"iterations\": " << result._nbIterations << ", "
+			<< "\"min_ms\": " << result._minTime << ", "
+			<< "\"mean_ms\": " << result._meanTime << ", "
+			<< "\"max_ms\": " << result._maxTime << ", "
+			<< "\"items\": " << result._nbItems << ", "
+			<< "\"items_per_second\": " << itemsPerSecond
+			<< " }" << ( ( i + 1 < _results.size() ) ? "," : "" ) << std::endl;
+	}
+	file << "\t]" << std::endl;
+	file << "}" << std::endl;
+
+	return true;
+}
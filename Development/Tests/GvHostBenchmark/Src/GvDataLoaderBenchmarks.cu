@@ -0,0 +1,227 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvDataLoaderBenchmarks.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvSyntheticDataset.h"
+
+// GigaVoxels
+#include <GvCore/vector_types_ext.h>
+#include <GvUtils/GvDataLoader.h>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvUtils;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Node lookup task
+ *
+ * @param pData the benchmark
+ * @param pThreadIndex index of the thread
+ * @param pNbThreads number of threads
+ ******************************************************************************/
+static void lookupTask( void* pData, unsigned int pThreadIndex, unsigned int pNbThreads )
+{
+	static_cast< GvDataLoaderLookupBenchmark* >( pData )->lookup( pThreadIndex, pNbThreads );
+}
+
+/******************************************************************************
+ ************************** DATA LOADER LOAD BENCHMARK ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvDataLoaderLoadBenchmark::GvDataLoaderLoadBenchmark()
+:	GvBenchmarkCase( "data_loader_load", false )
+,	_dataset( NULL )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvDataLoaderLoadBenchmark::~GvDataLoaderLoadBenchmark()
+{
+	tearDown();
+}
+
+/******************************************************************************
+ * Prepare the benchmark (not timed)
+ ******************************************************************************/
+bool GvDataLoaderLoadBenchmark::setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads )
+{
+	_dataset = new GvSyntheticDataset( pWorkingDirectory, pSize );
+
+	return _dataset->generate();
+}
+
+/******************************************************************************
+ * Run the benchmark (timed)
+ ******************************************************************************/
+double GvDataLoaderLoadBenchmark::run()
+{
+	GvDataLoader< GvBenchmarkDataTypeList >* dataLoader = new GvDataLoader< GvBenchmarkDataTypeList >( _dataset->getDescriptorFileName(), make_uint3( _dataset->getBrickWidth() ), 1, false );
+	delete dataLoader;
+
+	return 1.0;
+}
+
+/******************************************************************************
+ * Clean data after the last iteration (not timed)
+ ******************************************************************************/
+void GvDataLoaderLoadBenchmark::tearDown()
+{
+	delete _dataset;
+	_dataset = NULL;
+}
+
+/******************************************************************************
+ ************************* DATA LOADER LOOKUP BENCHMARK ***********************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvDataLoaderLookupBenchmark::GvDataLoaderLookupBenchmark()
+:	GvBenchmarkCase( "data_loader_lookup", true )
+,	_dataset( NULL )
+,	_dataLoader( NULL )
+,	_nodeGridSize( 0 )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvDataLoaderLookupBenchmark::~GvDataLoaderLookupBenchmark()
+{
+	tearDown();
+}
+
+/******************************************************************************
+ * Prepare the benchmark (not timed)
+ ******************************************************************************/
+bool GvDataLoaderLookupBenchmark::setUp( const std::string& pWorkingDirectory, unsigned int pSize, unsigned int pNbThreads )
+{
+	_nbThreads = pNbThreads;
+	_nbNonEmptyNodes.resize( pNbThreads );
+
+	_dataset = new GvSyntheticDataset( pWorkingDirectory, pSize );
+	if ( ! _dataset->generate() )
+	{
+		return false;
+	}
+	_dataLoader = new GvDataLoader< GvBenchmarkDataTypeList >( _dataset->getDescriptorFileName(), make_uint3( _dataset->getBrickWidth() ), 1, false );
+
+	return true;
+}
+
+/******************************************************************************
+ * Run the benchmark (timed)
+ ******************************************************************************/
+double GvDataLoaderLookupBenchmark::run()
+{
+	double nbLookups = 0.0;
+
+	for ( unsigned int level = 0; level <= _dataset->getLevel(); level++ )
+	{
+		_nodeGridSize = 1 << level;
+		runParallel( lookupTask, this, _nbThreads );
+
+		nbLookups += static_cast< double >( _nodeGridSize ) * _nodeGridSize * _nodeGridSize;
+	}
+
+	return nbLookups;
+}
+
+/******************************************************************************
+ * Clean data after the last iteration (not timed)
+ ******************************************************************************/
+void GvDataLoaderLookupBenchmark::tearDown()
+{
+	delete _dataLoader;
+	_dataLoader = NULL;
+	delete _dataset;
+	_dataset = NULL;
+}
+
+/******************************************************************************
+ * Look up the nodes of a thread at the current level
+ *
+ * @param pThreadIndex index of the thread
+ * @param pNbThreads number of threads
+ ******************************************************************************/
+void GvDataLoaderLookupBenchmark::lookup( unsigned int pThreadIndex, unsigned int pNbThreads )
+{
+	const unsigned int nbNodes = _nodeGridSize * _nodeGridSize * _nodeGridSize;
+	const unsigned int firstNode = static_cast< unsigned int >( ( static_cast< unsigned long long >( nbNodes ) * pThreadIndex ) / pNbThreads );
+	const unsigned int lastNode = static_cast< unsigned int >( ( static_cast< unsigned long long >( nbNodes ) * ( pThreadIndex + 1 ) ) / pNbThreads );
+
+	const float nodeSize = 1.0f / static_cast< float >( _nodeGridSize );
+	const float3 regionSize = make_float3( nodeSize );
+
+	unsigned int nbNonEmptyNodes = 0;
+	for ( unsigned int node = firstNode; node < lastNode; node++ )
+	{
+		const unsigned int x = node % _nodeGridSize;
+		const unsigned int y = ( node / _nodeGridSize ) % _nodeGridSize;
+		const unsigned int z = node / ( _nodeGridSize * _nodeGridSize );
+		const float3 regionPosition = make_float3( x * nodeSize, y * nodeSize, z * nodeSize );
+
+		if ( _dataLoader->getRegionInfoNew( regionPosition, regionSize ) != 0 )
+		{
+			nbNonEmptyNodes++;
+		}
+	}
+
+	// Keep the result alive
+	_nbNonEmptyNodes[ pThreadIndex ] = nbNonEmptyNodes;
+}
@@ -0,0 +1,404 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvSyntheticDataset.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include <GvVoxelizer/GvDataTypeHandler.h>
+#include <GvVoxelizer/GvDataStructureIOHandler.h>
+#include <GvVoxelizer/GvDataStructureMipmapGenerator.h>
+
+// TinyXML
+#include <tinyxml.h>
+
+// STL
+#include <sstream>
+#include <iostream>
+
+// System
+#include <cmath>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvVoxelizer;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Brick width (imposed by the mipmap generator)
+ */
+static const unsigned int cBrickWidth = 8;
+
+/**
+ * Sphere shell and core radii (in normalized space)
+ */
+static const float cCoreRadius = 0.15f;
+static const float cShellInnerRadius = 0.30f;
+static const float cShellOuterRadius = 0.45f;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pWorkingDirectory directory where files are written
+ * @param pResolution number of voxels in each dimension at the finest level (power of two, at least 8)
+ * @param pSeed seed of the color hash
+ ******************************************************************************/
+GvSyntheticDataset::GvSyntheticDataset( const std::string& pWorkingDirectory, unsigned int pResolution, unsigned int pSeed )
+:	_resolution( pResolution )
+,	_level( 0 )
+,	_seed( pSeed )
+{
+	std::ostringstream name;
+	name << pWorkingDirectory << "/synthetic_R" << pResolution;
+	_name = name.str();
+
+	// Finest level of resolution given the brick width
+	while ( ( cBrickWidth << _level ) < _resolution )
+	{
+		_level++;
+	}
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvSyntheticDataset::~GvSyntheticDataset()
+{
+}
+
+/******************************************************************************
+ * Get the dataset name (path included, without extension)
+ *
+ * @return the dataset name
+ ******************************************************************************/
+const std::string& GvSyntheticDataset::getName() const
+{
+	return _name;
+}
+
+/******************************************************************************
+ * Get the XML descriptor file name
+ *
+ * @return the XML descriptor file name
+ ******************************************************************************/
+std::string GvSyntheticDataset::getDescriptorFileName() const
+{
+	return _name + ".xml";
+}
+
+/******************************************************************************
+ * Get the number of voxels in each dimension at the finest level
+ *
+ * @return the resolution
+ ******************************************************************************/
+unsigned int GvSyntheticDataset::getResolution() const
+{
+	return _resolution;
+}
+
+/******************************************************************************
+ * Get the finest level of resolution of the data structure
+ *
+ * @return the finest level
+ ******************************************************************************/
+unsigned int GvSyntheticDataset::getLevel() const
+{
+	return _level;
+}
+
+/******************************************************************************
+ * Get the brick width
+ *
+ * @return the brick width
+ ******************************************************************************/
+unsigned int GvSyntheticDataset::getBrickWidth() const
+{
+	return cBrickWidth;
+}
+
+/******************************************************************************
+ * Integer hash used to generate deterministic colors
+ *
+ * @param pValue the value to hash
+ *
+ * @return the hashed value
+ ******************************************************************************/
+unsigned int GvSyntheticDataset::hash( unsigned int pValue )
+{
+	pValue ^= pValue >> 16;
+	pValue *= 0x7feb352dU;
+	pValue ^= pValue >> 15;
+	pValue *= 0x846ca68bU;
+	pValue ^= pValue >> 16;
+
+	return pValue;
+}
+
+/******************************************************************************
+ * Get the value of a voxel at the finest level
+ *
+ * @param pX x voxel position
+ * @param pY y voxel position
+ * @param pZ z voxel position
+ * @param pVoxelData the voxel value (uchar4)
+ *
+ * @return a flag telling wheter or not the voxel is not empty
+ ******************************************************************************/
+bool GvSyntheticDataset::getVoxel( unsigned int pX, unsigned int pY, unsigned int pZ, unsigned char pVoxelData[ 4 ] ) const
+{
+	// Distance to the center of the volume (in normalized space)
+	const float invResolution = 1.f / static_cast< float >( _resolution );
+	const float x = ( static_cast< float >( pX ) + 0.5f ) * invResolution - 0.5f;
+	const float y = ( static_cast< float >( pY ) + 0.5f ) * invResolution - 0.5f;
+	const float z = ( static_cast< float >( pZ ) + 0.5f ) * invResolution - 0.5f;
+	const float distance = sqrtf( x * x + y * y + z * z );
+
+	// Constant core
+	if ( distance < cCoreRadius )
+	{
+		pVoxelData[ 0 ] = 200;
+		pVoxelData[ 1 ] = 120;
+		pVoxelData[ 2 ] = 60;
+		pVoxelData[ 3 ] = 255;
+
+		return true;
+	}
+
+	// Heterogeneous shell
+	if ( distance >= cShellInnerRadius && distance < cShellOuterRadius )
+	{
+		const unsigned int value = hash( _seed ^ hash( pX + _resolution * ( pY + _resolution * pZ ) ) );
+		pVoxelData[ 0 ] = static_cast< unsigned char >( value & 0xff );
+		pVoxelData[ 1 ] = static_cast< unsigned char >( ( value >> 8 ) & 0xff );
+		pVoxelData[ 2 ] = static_cast< unsigned char >( ( value >> 16 ) & 0xff );
+		pVoxelData[ 3 ] = 255;
+
+		return true;
+	}
+
+	// Empty space
+	pVoxelData[ 0 ] = 0;
+	pVoxelData[ 1 ] = 0;
+	pVoxelData[ 2 ] = 0;
+	pVoxelData[ 3 ] = 0;
+
+	return false;
+}
+
+/******************************************************************************
+ * Write all non-empty voxels in the finest level
+ *
+ * @param pIOHandler data structure handler of the finest level
+ *
+ * @return the number of written voxels
+ ******************************************************************************/
+unsigned int GvSyntheticDataset::fill( GvDataStructureIOHandler& pIOHandler ) const
+{
+	unsigned int nbVoxels = 0;
+
+	// Iterate node by node to benefit from the handler brick cache
+	const unsigned int nodeGridSize = _resolution / cBrickWidth;
+	unsigned int voxelPos[ 3 ];
+	unsigned char voxelData[ 4 ];
+	for ( unsigned int nz = 0; nz < nodeGridSize; nz++ )
+	for ( unsigned int ny = 0; ny < nodeGridSize; ny++ )
+	for ( unsigned int nx = 0; nx < nodeGridSize; nx++ )
+	{
+		for ( voxelPos[ 2 ] = nz * cBrickWidth; voxelPos[ 2 ] < ( nz + 1 ) * cBrickWidth; voxelPos[ 2 ]++ )
+		for ( voxelPos[ 1 ] = ny * cBrickWidth; voxelPos[ 1 ] < ( ny + 1 ) * cBrickWidth; voxelPos[ 1 ]++ )
+		for ( voxelPos[ 0 ] = nx * cBrickWidth; voxelPos[ 0 ] < ( nx + 1 ) * cBrickWidth; voxelPos[ 0 ]++ )
+		{
+			if ( getVoxel( voxelPos[ 0 ], voxelPos[ 1 ], voxelPos[ 2 ], voxelData ) )
+			{
+				pIOHandler.setVoxel( voxelPos, voxelData, 0 );
+				nbVoxels++;
+			}
+		}
+	}
+
+	return nbVoxels;
+}
+
+/******************************************************************************
+ * Write the finest level (voxels only, no border)
+ *
+ * @return the number of written voxels
+ ******************************************************************************/
+unsigned int GvSyntheticDataset::writeFinestLevel() const
+{
+	std::vector< GvDataTypeHandler::VoxelDataType > dataTypes;
+	dataTypes.push_back( GvDataTypeHandler::gvUCHAR4 );
+
+	GvDataStructureIOHandler ioHandler( _name, _level, cBrickWidth, dataTypes, true );
+
+	return fill( ioHandler );
+}
+
+/******************************************************************************
+ * Generate the whole dataset : finest level, borders, mipmap pyramid and XML descriptor
+ *
+ * @return a flag telling wheter or not the process has succeeded
+ ******************************************************************************/
+bool GvSyntheticDataset::generate() const
+{
+	writeFinestLevel();
+
+	// Borders of the finest level
+	{
+		std::vector< GvDataTypeHandler::VoxelDataType > dataTypes;
+		dataTypes.push_back( GvDataTypeHandler::gvUCHAR4 );
+
+		GvDataStructureIOHandler ioHandler( _name, _level, cBrickWidth, dataTypes, false );
+		ioHandler.computeBorders();
+	}
+
+	// Coarser levels
+	if ( ! GvDataStructureMipmapGenerator::generateMipmapPyramid( _name, _resolution ) )
+	{
+		return false;
+	}
+
+	return writeDescriptor();
+}
+
+/******************************************************************************
+ * Write the XML descriptor read by GvUtils::GvDataLoader
+ *
+ * @return a flag telling wheter or not the process has succeeded
+ ******************************************************************************/
+bool GvSyntheticDataset::writeDescriptor() const
+{
+	// Files are referenced relatively to the descriptor
+	const std::string baseName = _name.substr( _name.find_last_of( "\\/" ) + 1 );
+	const unsigned int nbLevels = _level + 1;
+
+	TiXmlDocument document;
+	TiXmlElement* root = new TiXmlElement( "Model" );
+	root->SetAttribute( "name", baseName.c_str() );
+	root->SetAttribute( "directory", "." );
+	root->SetAttribute( "nbLevels", nbLevels );
+
+	// Nodes
+	TiXmlElement* nodeTree = new TiXmlElement( "NodeTree" );
+	for ( unsigned int k = 0; k < nbLevels; k++ )
+	{
+		TiXmlElement* level = new TiXmlElement( "Level" );
+		level->SetAttribute( "id", k );
+		std::ostringstream fileName;
+		fileName << baseName << "_BR" << cBrickWidth << "_B1_L" << k << ".nodes";
+		level->SetAttribute( "filename", fileName.str().c_str() );
+		nodeTree->LinkEndChild( level );
+	}
+	root->LinkEndChild( nodeTree );
+
+	// Bricks
+	TiXmlElement* brickData = new TiXmlElement( "BrickData" );
+	brickData->SetAttribute( "brickResolution", cBrickWidth );
+	brickData->SetAttribute( "borderSize", 1 );
+	TiXmlElement* channel = new TiXmlElement( "Channel" );
+	channel->SetAttribute( "id", 0 );
+	channel->SetAttribute( "name", "color" );
+	channel->SetAttribute( "type", "uchar4" );
+	for ( unsigned int k = 0; k < nbLevels; k++ )
+	{
+		TiXmlElement* level = new TiXmlElement( "Level" );
+		level->SetAttribute( "id", k );
+		std::ostringstream fileName;
+		fileName << baseName << "_BR" << cBrickWidth << "_B1_L" << k << "_C0_" << GvDataTypeHandler::getTypeName( GvDataTypeHandler::gvUCHAR4 ) << ".bricks";
+		level->SetAttribute( "filename", fileName.str().c_str() );
+		channel->LinkEndChild( level );
+	}
+	brickData->LinkEndChild( channel );
+	root->LinkEndChild( brickData );
+
+	document.LinkEndChild( root );
+
+	return document.SaveFile( getDescriptorFileName().c_str() );
+}
+
+/******************************************************************************
+ * Generate a triangulated sphere in [ 0.0 ; 1.0 ]^3
+ *
+ * @param pNbSlices number of slices (around Z axis)
+ * @param pNbStacks number of stacks (along Z axis)
+ * @param pVertices the resulting triangle list (9 floats per triangle)
+ ******************************************************************************/
+void GvSyntheticDataset::generateSphereMesh( unsigned int pNbSlices, unsigned int pNbStacks, std::vector< float >& pVertices )
+{
+	const float pi = 3.14159265358979f;
+	const float radius = 0.5f * ( cShellInnerRadius + cShellOuterRadius );
+
+	pVertices.clear();
+	pVertices.reserve( static_cast< size_t >( pNbSlices ) * pNbStacks * 2 * 9 );
+
+	for ( unsigned int j = 0; j < pNbStacks; j++ )
+	for ( unsigned int i = 0; i < pNbSlices; i++ )
+	{
+		// Quad corners in spherical coordinates
+		float corners[ 4 ][ 3 ];
+		for ( unsigned int c = 0; c < 4; c++ )
+		{
+			const float theta = 2.f * pi * static_cast< float >( i + ( c & 1 ) ) / static_cast< float >( pNbSlices );
+			const float phi = pi * static_cast< float >( j + ( c >> 1 ) ) / static_cast< float >( pNbStacks );
+			corners[ c ][ 0 ] = 0.5f + radius * sinf( phi ) * cosf( theta );
+			corners[ c ][ 1 ] = 0.5f + radius * sinf( phi ) * sinf( theta );
+			corners[ c ][ 2 ] = 0.5f + radius * cosf( phi );
+		}
+
+		// Two triangles per quad
+		const unsigned int indices[ 6 ] = { 0, 1, 3, 0, 3, 2 };
+		for ( unsigned int k = 0; k < 6; k++ )
+		{
+			pVertices.push_back( corners[ indices[ k ] ][ 0 ] );
+			pVertices.push_back( corners[ indices[ k ] ][ 1 ] );
+			pVertices.push_back( corners[ indices[ k ] ][ 2 ] );
+		}
+	}
+}
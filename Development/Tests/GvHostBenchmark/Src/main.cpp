@@ -0,0 +1,218 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvBenchmarkSuite.h"
+#include "GvBenchmarkCases.h"
+#include "GvDataLoaderBenchmarks.h"
+
+// STL
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Print command line usage
+ *
+ * @param pProgramName name of the program
+ ******************************************************************************/
+static void printUsage( const char* pProgramName )
+{
+	std::cout << "Usage : " << pProgramName << " [options]" << std::endl;
+	std::cout << "  --output <file>        JSON report file (default : GvHostBenchmark.json)" << std::endl;
+	std::cout << "  --dir <directory>      directory of temporary datasets (default : .)" << std::endl;
+	std::cout << "  --sizes <list>         comma separated resolutions (default : 32,64,128)" << std::endl;
+	std::cout << "  --threads <list>       comma separated numbers of threads (default : 1,2,4)" << std::endl;
+	std::cout << "  --iterations <n>       number of timed iterations (default : 3)" << std::endl;
+	std::cout << "  --filter <text>        only run benchmarks whose name contains text" << std::endl;
+	std::cout << "  --tag <text>           tag stored in the report (i.e. commit or machine name)" << std::endl;
+}
+
+/******************************************************************************
+ * Parse a comma separated list of unsigned integers
+ *
+ * @param pText the text to parse
+ * @param pValues the resulting list
+ *
+ * @return a flag telling wheter or not the list is valid
+ ******************************************************************************/
+static bool parseList( const std::string& pText, std::vector< unsigned int >& pValues )
+{
+	pValues.clear();
+
+	std::istringstream stream( pText );
+	std::string item;
+	while ( std::getline( stream, item, ',' ) )
+	{
+		const unsigned int value = static_cast< unsigned int >( atoi( item.c_str() ) );
+		if ( value == 0 )
+		{
+			return false;
+		}
+		pValues.push_back( value );
+	}
+
+	return ! pValues.empty();
+}
+
+/******************************************************************************
+ * Main entry program
+ *
+ * @param pArgc number of arguments
+ * @param pArgv list of arguments
+ *
+ * @return exit code
+ ******************************************************************************/
+int main( int pArgc, char* pArgv[] )
+{
+	std::string outputFileName = "GvHostBenchmark.json";
+	std::string workingDirectory = ".";
+	std::string filter;
+	std::string tag;
+	unsigned int nbIterations = 3;
+	std::vector< unsigned int > sizes;
+	sizes.push_back( 32 );
+	sizes.push_back( 64 );
+	sizes.push_back( 128 );
+	std::vector< unsigned int > threads;
+	threads.push_back( 1 );
+	threads.push_back( 2 );
+	threads.push_back( 4 );
+
+	// Parse command line
+	for ( int i = 1; i < pArgc; i++ )
+	{
+		const std::string argument = pArgv[ i ];
+		const bool hasValue = ( i + 1 < pArgc );
+
+		if ( argument == "--help" || argument == "-h" )
+		{
+			printUsage( pArgv[ 0 ] );
+
+			return 0;
+		}
+		else if ( argument == "--output" && hasValue )
+		{
+			outputFileName = pArgv[ ++i ];
+		}
+		else if ( argument == "--dir" && hasValue )
+		{
+			workingDirectory = pArgv[ ++i ];
+		}
+		else if ( argument == "--sizes" && hasValue )
+		{
+			if ( ! parseList( pArgv[ ++i ], sizes ) )
+			{
+				std::cerr << "Invalid list of sizes : " << pArgv[ i ] << std::endl;
+
+				return 1;
+			}
+		}
+		else if ( argument == "--threads" && hasValue )
+		{
+			if ( ! parseList( pArgv[ ++i ], threads ) )
+			{
+				std::cerr << "Invalid list of threads : " << pArgv[ i ] << std::endl;
+
+				return 1;
+			}
+		}
+		else if ( argument == "--iterations" && hasValue )
+		{
+			nbIterations = static_cast< unsigned int >( atoi( pArgv[ ++i ] ) );
+			if ( nbIterations == 0 )
+			{
+				std::cerr << "Invalid number of iterations : " << pArgv[ i ] << std::endl;
+
+				return 1;
+			}
+		}
+		else if ( argument == "--filter" && hasValue )
+		{
+			filter = pArgv[ ++i ];
+		}
+		else if ( argument == "--tag" && hasValue )
+		{
+			tag = pArgv[ ++i ];
+		}
+		else
+		{
+			std::cerr << "Unknown option : " << argument << std::endl;
+			printUsage( pArgv[ 0 ] );
+
+			return 1;
+		}
+	}
+
+	// Register benchmarks
+	GvBenchmarkSuite suite( workingDirectory );
+	suite.addCase( new GvIOHandlerSetVoxelBenchmark() );
+	suite.addCase( new GvIOHandlerGetVoxelBenchmark() );
+	suite.addCase( new GvBordersBenchmark() );
+	suite.addCase( new GvMipmapBenchmark() );
+	suite.addCase( new GvTriangleVoxelizationBenchmark() );
+	suite.addCase( new GvRLECompressionBenchmark() );
+	suite.addCase( new GvRLEDecompressionBenchmark() );
+	suite.addCase( new GvDataLoaderLoadBenchmark() );
+	suite.addCase( new GvDataLoaderLookupBenchmark() );
+
+	// Run benchmarks and write report
+	bool result = suite.run( sizes, threads, nbIterations, filter );
+	if ( ! suite.writeJSON( outputFileName, tag ) )
+	{
+		std::cerr << "Unable to write report : " << outputFileName << std::endl;
+		result = false;
+	}
+
+	return result ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#ifndef _GV_METRICS_SERVER_TEST_H_
+#define _GV_METRICS_SERVER_TEST_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvTestCase.h"
+
+// STL
+#include <string>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+/** 
+ * @class GvMetricsServerTest
+ *
+ * @brief Test the metrics collection (GvMetrics) and its localhost HTTP endpoint
+ * (GvMetricsServer) with a local HTTP client.
+ *
+ * It checks the published histograms and gauges in the Prometheus text format,
+ * the HTTP status of unknown paths and methods, and that every snapshot read
+ * by the endpoint is consistent while a writer thread publishes frames.
+ */
+class GvMetricsServerTest : public GvTestCase
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvMetricsServerTest();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvMetricsServerTest();
+
+	/**
+	 * Run the test
+	 */
+	virtual void run();
+
+protected:
+
+	/**
+	 * Send an HTTP request to a local server and read the whole response
+	 *
+	 * @param pPort the TCP port of the server
+	 * @param pRequest the request
+	 * @param pResponse the response
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	static bool sendRequest( unsigned short pPort, const std::string& pRequest, std::string& pResponse );
+
+	/**
+	 * Read the value of a sample in a Prometheus text
+	 *
+	 * @param pText the Prometheus text
+	 * @param pSample the sample name (with its labels)
+	 * @param pValue the value
+	 *
+	 * @return false if the sample is not found
+	 */
+	static bool getSample( const std::string& pText, const std::string& pSample, double& pValue );
+
+};
+
+#endif
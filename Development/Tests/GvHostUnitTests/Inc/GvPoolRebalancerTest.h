@@ -0,0 +1,89 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#ifndef _GV_POOL_REBALANCER_TEST_H_
+#define _GV_POOL_REBALANCER_TEST_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvTestCase.h"
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+/** 
+ * @class GvPoolRebalancerTest
+ *
+ * @brief Test the working set estimator of the node and brick caches (GvPoolRebalancer)
+ * on synthetic cache statistics.
+ *
+ * It checks the peak working set over the sliding window, the extrapolated demand
+ * of an overflowing cache, the proportional split of the memory budget,
+ * the minimum share of each pool and the hysteresis.
+ */
+class GvPoolRebalancerTest : public GvTestCase
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvPoolRebalancerTest();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvPoolRebalancerTest();
+
+	/**
+	 * Run the test
+	 */
+	virtual void run();
+
+};
+
+#endif
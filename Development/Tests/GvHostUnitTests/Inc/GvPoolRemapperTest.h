@@ -0,0 +1,88 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#ifndef _GV_POOL_REMAPPER_TEST_H_
+#define _GV_POOL_REMAPPER_TEST_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvTestCase.h"
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+/** 
+ * @class GvPoolRemapperTest
+ *
+ * @brief Test the remapping of resident node tiles and bricks in resized pools (GvPoolRemapper)
+ * on a synthetic node pool.
+ *
+ * It checks which elements are kept when pools shrink or grow, their new addresses
+ * in the node pool, the reset of dropped addresses and the order of the new element lists.
+ */
+class GvPoolRemapperTest : public GvTestCase
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvPoolRemapperTest();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvPoolRemapperTest();
+
+	/**
+	 * Run the test
+	 */
+	virtual void run();
+
+};
+
+#endif
@@ -0,0 +1,224 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#ifndef _GV_TEST_CASE_H_
+#define _GV_TEST_CASE_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <string>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Check a condition in the run() method of a test case.
+ * A failing check is reported with its expression and location, the test goes on.
+ */
+#define GV_CHECK( pCondition ) check( ( pCondition ), #pCondition, __FILE__, __LINE__ )
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+/** 
+ * @class GvTestCase
+ *
+ * @brief The GvTestCase class provides the interface of a host unit test.
+ *
+ * A case is prepared with setUp(), then run() evaluates its checks with the GV_CHECK() macro
+ * and tearDown() cleans data. A case succeeds if all its checks succeed.
+ *
+ * Tests only use host code, so that they run without a GPU nor an OpenGL context.
+ */
+class GvTestCase
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pName name of the test
+	 */
+	GvTestCase( const std::string& pName );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvTestCase();
+
+	/**
+	 * Get the name of the test
+	 *
+	 * @return the name of the test
+	 */
+	const std::string& getName() const;
+
+	/**
+	 * Get the number of evaluated checks
+	 *
+	 * @return the number of evaluated checks
+	 */
+	unsigned int getNbChecks() const;
+
+	/**
+	 * Get the number of failed checks
+	 *
+	 * @return the number of failed checks
+	 */
+	unsigned int getNbFailures() const;
+
+	/**
+	 * Prepare the test
+	 *
+	 * @param pWorkingDirectory directory where temporary files are written
+	 *
+	 * @return a flag telling wheter or not the test can be run
+	 */
+	virtual bool setUp( const std::string& pWorkingDirectory );
+
+	/**
+	 * Run the test
+	 */
+	virtual void run() = 0;
+
+	/**
+	 * Clean data after the test
+	 */
+	virtual void tearDown();
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Name of the test
+	 */
+	std::string _name;
+
+	/**
+	 * Directory where temporary files are written
+	 */
+	std::string _workingDirectory;
+
+	/**
+	 * Number of evaluated checks
+	 */
+	unsigned int _nbChecks;
+
+	/**
+	 * Number of failed checks
+	 */
+	unsigned int _nbFailures;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Evaluate a check (use the GV_CHECK() macro)
+	 *
+	 * @param pCondition the result of the check
+	 * @param pExpression the checked expression
+	 * @param pFile the source file
+	 * @param pLine the source line
+	 *
+	 * @return the result of the check
+	 */
+	bool check( bool pCondition, const char* pExpression, const char* pFile, int pLine );
+
+	/**
+	 * Tell wheter or not two values are equal up to a tolerance
+	 *
+	 * @param pValue1 first value
+	 * @param pValue2 second value
+	 * @param pEpsilon tolerance
+	 *
+	 * @return a flag telling wheter or not values are equal
+	 */
+	static bool isNear( double pValue1, double pValue2, double pEpsilon = 1e-5 );
+
+	/**
+	 * Get the full path of a temporary file
+	 *
+	 * @param pFilename the file name
+	 *
+	 * @return the path of the file in the working directory
+	 */
+	std::string getFilePath( const std::string& pFilename ) const;
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvTestCase( const GvTestCase& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvTestCase& operator=( const GvTestCase& );
+
+};
+
+#endif
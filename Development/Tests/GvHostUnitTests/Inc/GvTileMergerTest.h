@@ -0,0 +1,106 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#ifndef _GV_TILE_MERGER_TEST_H_
+#define _GV_TILE_MERGER_TEST_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvTestCase.h"
+
+// STL
+#include <string>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+/** 
+ * @class GvTileMergerTest
+ *
+ * @brief Test the distributed tile voxelization of the voxelizer (GvxTileMerger)
+ * on a synthetic scene of random triangles.
+ *
+ * The scene is voxelized once by a single process, then tile by tile
+ * by several local processes (one per tile) whose outputs are merged.
+ * Node, brick and summary files of all levels must be identical byte for byte.
+ *
+ * Note : on Windows, tiles are voxelized one after the other by the test process.
+ */
+class GvTileMergerTest : public GvTestCase
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvTileMergerTest();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvTileMergerTest();
+
+	/**
+	 * Run the test
+	 */
+	virtual void run();
+
+private:
+
+	/**
+	 * Tell wheter or not two files have the same content
+	 *
+	 * @param pFileName1 first file name
+	 * @param pFileName2 second file name
+	 *
+	 * @return a flag telling wheter or not the files have the same content
+	 */
+	static bool isSameFile( const std::string& pFileName1, const std::string& pFileName2 );
+
+};
+
+#endif
@@ -0,0 +1,347 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvMetricsServerTest.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include <GvPerfMon/GvMetrics.h>
+#include <GvPerfMon/GvMetricsServer.h>
+
+// STL
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+// System
+#ifndef WIN32
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <arpa/inet.h>
+	#include <unistd.h>
+	#include <pthread.h>
+#endif
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvPerfMon;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Number of HTTP requests sent while a writer thread publishes frames
+ */
+static const unsigned int cNbConcurrentRequests = 200;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/**
+ * Arguments of the writer thread
+ */
+struct GvMetricsWriterArguments
+{
+	volatile bool _stopRequested;
+	unsigned int _nbFrames;
+};
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Writer thread : publish frames as a render thread would do.
+ * Each frame adds one observation to the per-frame request histograms
+ * and sets a gauge to the frame number, so that readers can check the consistency
+ * of a snapshot.
+ *
+ * @param pArguments thread arguments
+ ******************************************************************************/
+static void* runWriter( void* pArguments )
+{
+	GvMetricsWriterArguments* arguments = static_cast< GvMetricsWriterArguments* >( pArguments );
+	GvMetrics& metrics = GvMetrics::get();
+	while ( ! arguments->_stopRequested )
+	{
+		arguments->_nbFrames++;
+		metrics.observe( GvMetrics::eBrickLoadsPerFrame, 3.0 );
+		metrics.observe( GvMetrics::eNodeSubdivisionsPerFrame, 1.0 );
+		metrics.setGauge( GvMetrics::eNbTreeNodes, static_cast< double >( arguments->_nbFrames ) );
+		metrics.endFrame();
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvMetricsServerTest::GvMetricsServerTest()
+:	GvTestCase( "MetricsServer" )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvMetricsServerTest::~GvMetricsServerTest()
+{
+}
+
+/******************************************************************************
+ * Send an HTTP request to a local server and read the whole response
+ *
+ * @param pPort the TCP port of the server
+ * @param pRequest the request
+ * @param pResponse the response
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvMetricsServerTest::sendRequest( unsigned short pPort, const std::string& pRequest, std::string& pResponse )
+{
+	pResponse.clear();
+
+#ifndef WIN32
+	const int clientSocket = socket( AF_INET, SOCK_STREAM, 0 );
+	if ( clientSocket < 0 )
+	{
+		return false;
+	}
+
+	sockaddr_in address;
+	memset( &address, 0, sizeof( address ) );
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+	address.sin_port = htons( pPort );
+	if ( connect( clientSocket, reinterpret_cast< sockaddr* >( &address ), sizeof( address ) ) != 0 )
+	{
+		close( clientSocket );
+
+		return false;
+	}
+
+	if ( send( clientSocket, pRequest.c_str(), pRequest.size(), MSG_NOSIGNAL ) != static_cast< ssize_t >( pRequest.size() ) )
+	{
+		close( clientSocket );
+
+		return false;
+	}
+
+	// The server closes the connection after its response
+	char buffer[ 4096 ];
+	ssize_t size = 0;
+	while ( ( size = recv( clientSocket, buffer, sizeof( buffer ), 0 ) ) > 0 )
+	{
+		pResponse.append( buffer, static_cast< size_t >( size ) );
+	}
+	close( clientSocket );
+
+	return size == 0;
+#else
+	return false;
+#endif
+}
+
+/******************************************************************************
+ * Read the value of a sample in a Prometheus text
+ *
+ * @param pText the Prometheus text
+ * @param pSample the sample name (with its labels)
+ * @param pValue the value
+ *
+ * @return false if the sample is not found
+ ******************************************************************************/
+bool GvMetricsServerTest::getSample( const std::string& pText, const std::string& pSample, double& pValue )
+{
+	std::istringstream stream( pText );
+	std::string line;
+	while ( std::getline( stream, line ) )
+	{
+		if ( line.size() > pSample.size() && line.compare( 0, pSample.size(), pSample ) == 0 && line[ pSample.size() ] == ' ' )
+		{
+			pValue = atof( line.c_str() + pSample.size() + 1 );
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * Run the test
+ ******************************************************************************/
+void GvMetricsServerTest::run()
+{
+#ifndef WIN32
+	GvMetrics& metrics = GvMetrics::get();
+
+	// Metrics are only collected when asked for
+	GV_CHECK( ! GvMetrics::_isActivated );
+
+	// Frame 1 : observations on bucket bounds go in the bucket of the bound
+	metrics.observe( GvMetrics::eBrickLoadsPerFrame, 0.0 );
+	metrics.observe( GvMetrics::eBrickLoadsPerFrame, 4.0 );
+	metrics.observe( GvMetrics::eBrickLoadsPerFrame, 5.0 );
+	metrics.observe( GvMetrics::eBrickLoadsPerFrame, 100000.0 );
+	metrics.observe( GvMetrics::eLoaderLatency, 2.0 );
+	metrics.setGauge( GvMetrics::eRendererElapsedTime, 12.0 );
+	metrics.setGauge( GvMetrics::eNodeCacheUsage, 42.0 );
+	metrics.setEventTime( 0, "cpmApplication", 8.0f, 1 );
+	metrics.endFrame();
+
+	GvMetrics::Snapshot* snapshot = new GvMetrics::Snapshot();
+	GV_CHECK( metrics.getSnapshot( *snapshot ) );
+	GV_CHECK( snapshot->_nbFrames == 1 );
+	GV_CHECK( snapshot->_histograms[ GvMetrics::eBrickLoadsPerFrame ]._count == 4 );
+	GV_CHECK( snapshot->_histograms[ GvMetrics::eBrickLoadsPerFrame ]._counts[ 0 ] == 1 );
+	GV_CHECK( snapshot->_histograms[ GvMetrics::eBrickLoadsPerFrame ]._counts[ 2 ] == 1 );
+	GV_CHECK( snapshot->_histograms[ GvMetrics::eBrickLoadsPerFrame ]._counts[ 3 ] == 1 );
+	GV_CHECK( snapshot->_histograms[ GvMetrics::eBrickLoadsPerFrame ]._counts[ snapshot->_histograms[ GvMetrics::eBrickLoadsPerFrame ]._nbBuckets ] == 1 );
+	delete snapshot;
+
+	// Start the endpoint on a port chosen by the system
+	GvMetricsServer server;
+	GV_CHECK( server.start( 0 ) );
+	GV_CHECK( server.isRunning() );
+	GV_CHECK( server.getPort() != 0 );
+	GV_CHECK( GvMetrics::_isActivated );
+
+	// Metrics (units are converted to seconds and buckets are cumulative)
+	std::string response;
+	GV_CHECK( sendRequest( server.getPort(), "GET /metrics HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n", response ) );
+	GV_CHECK( response.compare( 0, 15, "HTTP/1.0 200 OK" ) == 0 );
+	GV_CHECK( response.find( "Content-Type: text/plain; version=0.0.4" ) != std::string::npos );
+	const size_t bodyOffset = response.find( "\r\n\r\n" );
+	GV_CHECK( bodyOffset != std::string::npos );
+	const std::string body = ( bodyOffset != std::string::npos ) ? response.substr( bodyOffset + 4 ) : std::string();
+	std::ostringstream contentLength;
+	contentLength << "Content-Length: " << body.size() << "\r\n";
+	GV_CHECK( response.find( contentLength.str() ) != std::string::npos );
+
+	double value = 0.0;
+	GV_CHECK( getSample( body, "gigavoxels_frames_total", value ) && value == 1.0 );
+	GV_CHECK( getSample( body, "gigavoxels_renderer_elapsed_time_seconds", value ) && isNear( value, 0.012 ) );
+	GV_CHECK( getSample( body, "gigavoxels_node_cache_usage_percent", value ) && value == 42.0 );
+	GV_CHECK( getSample( body, "gigavoxels_brick_loads_per_frame_bucket{le=\"0\"}", value ) && value == 1.0 );
+	GV_CHECK( getSample( body, "gigavoxels_brick_loads_per_frame_bucket{le=\"1\"}", value ) && value == 1.0 );
+	GV_CHECK( getSample( body, "gigavoxels_brick_loads_per_frame_bucket{le=\"4\"}", value ) && value == 2.0 );
+	GV_CHECK( getSample( body, "gigavoxels_brick_loads_per_frame_bucket{le=\"16\"}", value ) && value == 3.0 );
+	GV_CHECK( getSample( body, "gigavoxels_brick_loads_per_frame_bucket{le=\"+Inf\"}", value ) && value == 4.0 );
+	GV_CHECK( getSample( body, "gigavoxels_brick_loads_per_frame_sum", value ) && value == 100009.0 );
+	GV_CHECK( getSample( body, "gigavoxels_brick_loads_per_frame_count", value ) && value == 4.0 );
+	GV_CHECK( getSample( body, "gigavoxels_loader_io_latency_seconds_bucket{le=\"0.005\"}", value ) && value == 1.0 );
+	GV_CHECK( getSample( body, "gigavoxels_loader_io_latency_seconds_sum", value ) && isNear( value, 0.002 ) );
+	GV_CHECK( getSample( body, "gigavoxels_frame_time_seconds_count", value ) && value == 0.0 );
+	GV_CHECK( getSample( body, "gigavoxels_perfmon_event_seconds{event=\"cpmApplication\"}", value ) && isNear( value, 0.008 ) );
+	GV_CHECK( getSample( body, "gigavoxels_perfmon_event_calls{event=\"cpmApplication\"}", value ) && value == 1.0 );
+	GV_CHECK( body.find( "# TYPE gigavoxels_node_subdivisions_per_frame histogram" ) != std::string::npos );
+
+	// Unknown path and method
+	GV_CHECK( sendRequest( server.getPort(), "GET /index.html HTTP/1.0\r\n\r\n", response ) );
+	GV_CHECK( response.compare( 0, 22, "HTTP/1.0 404 Not Found" ) == 0 );
+	GV_CHECK( sendRequest( server.getPort(), "POST /metrics HTTP/1.0\r\n\r\n", response ) );
+	GV_CHECK( response.compare( 0, 31, "HTTP/1.0 405 Method Not Allowed" ) == 0 );
+
+	// Read while a writer thread publishes frames : the writer never waits,
+	// and every snapshot served is consistent (all counters of a snapshot come from the same frame)
+	const double nbFramesBefore = 1.0;
+	const double nbBrickLoadsBefore = 4.0;
+	GvMetricsWriterArguments arguments;
+	arguments._stopRequested = false;
+	arguments._nbFrames = 0;
+	pthread_t writer;
+	GV_CHECK( pthread_create( &writer, NULL, runWriter, &arguments ) == 0 );
+	unsigned int nbServed = 0;
+	unsigned int nbConsistent = 0;
+	double lastNbFrames = 0.0;
+	bool isMonotonic = true;
+	for ( unsigned int i = 0; i < cNbConcurrentRequests; i++ )
+	{
+		if ( ! sendRequest( server.getPort(), "GET /metrics HTTP/1.0\r\n\r\n", response ) )
+		{
+			continue;
+		}
+		if ( response.compare( 0, 15, "HTTP/1.0 200 OK" ) != 0 )
+		{
+			// The writer may be too fast for the reader : "503 Service Unavailable" is allowed
+			continue;
+		}
+		nbServed++;
+
+		double nbFrames = 0.0;
+		double nbBrickLoads = 0.0;
+		double nbNodeSubdivisions = 0.0;
+		double nbTreeNodes = 0.0;
+		if ( getSample( response, "gigavoxels_frames_total", nbFrames )
+			&& getSample( response, "gigavoxels_brick_loads_per_frame_count", nbBrickLoads )
+			&& getSample( response, "gigavoxels_node_subdivisions_per_frame_count", nbNodeSubdivisions )
+			&& getSample( response, "gigavoxels_tree_nodes", nbTreeNodes ) )
+		{
+			const double nbWrittenFrames = nbFrames - nbFramesBefore;
+			if ( nbBrickLoads == nbBrickLoadsBefore + nbWrittenFrames
+				&& nbNodeSubdivisions == nbWrittenFrames
+				&& ( nbWrittenFrames == 0.0 || nbTreeNodes == nbWrittenFrames ) )
+			{
+				nbConsistent++;
+			}
+			isMonotonic = isMonotonic && ( nbFrames >= lastNbFrames );
+			lastNbFrames = nbFrames;
+		}
+	}
+	arguments._stopRequested = true;
+	pthread_join( writer, NULL );
+	GV_CHECK( nbServed > 0 );
+	GV_CHECK( nbConsistent == nbServed );
+	GV_CHECK( isMonotonic );
+	GV_CHECK( arguments._nbFrames > 0 );
+
+	// Last published frame once the writer is done
+	GV_CHECK( sendRequest( server.getPort(), "GET /metrics HTTP/1.0\r\n\r\n", response ) );
+	GV_CHECK( getSample( response, "gigavoxels_frames_total", value ) && value == nbFramesBefore + arguments._nbFrames );
+
+	// Stop : the port is closed
+	server.stop();
+	GV_CHECK( ! server.isRunning() );
+	GV_CHECK( ! sendRequest( server.getPort(), "GET /metrics HTTP/1.0\r\n\r\n", response ) );
+
+	GvMetrics::_isActivated = false;
+#endif
+}
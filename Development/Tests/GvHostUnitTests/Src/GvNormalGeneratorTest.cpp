@@ -0,0 +1,275 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvNormalGeneratorTest.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include <GvVoxelizer/GvDataStructureNormalGenerator.h>
+
+// STL
+#include <algorithm>
+#include <vector>
+
+// System
+#include <cmath>
+#include <cstdlib>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvVoxelizer;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Settings of the bricks : 8^3 voxels with a border of 1 voxel, in a 4^3 node grid
+ */
+static const unsigned int cBrickWidth = 8;
+static const unsigned int cBrickSize = ( cBrickWidth + 2 ) * ( cBrickWidth + 2 ) * ( cBrickWidth + 2 );
+static const unsigned int cNodeGridSize = 4;
+
+/**
+ * Max distance between a normal and its decoded octahedral coordinates
+ * (coordinates are quantized with a step of 2 / 65535)
+ */
+static const float cMaxOctahedralError = 1e-4f;
+
+/**
+ * Number of random normals of the round-trip
+ */
+static const unsigned int cNbRandomNormals = 100000;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/**
+ * @class GvBrickNormalGenerator
+ *
+ * @brief Normal generator giving access to the normals of a single brick,
+ * without reading or writing a data structure.
+ */
+class GvBrickNormalGenerator : public GvDataStructureNormalGenerator
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvBrickNormalGenerator()
+	:	GvDataStructureNormalGenerator()
+	{
+		_brickWidth = cBrickWidth;
+		_nodeGridSize = cNodeGridSize;
+		_scratch.resize( cBrickSize + 3 * cBrickWidth * cBrickWidth * cBrickWidth );
+	}
+
+	/**
+	 * Compute the normals of a brick
+	 *
+	 * @param pDensityBrick the density brick (uchar4, with borders)
+	 * @param pNodePos the node position of the brick
+	 * @param pNormalBrick the normal brick (with borders)
+	 */
+	void computeBrick( const std::vector< unsigned char >& pDensityBrick, const unsigned int pNodePos[ 3 ], std::vector< unsigned short >& pNormalBrick )
+	{
+		const unsigned int nbComponents = ( getNormalEncoding() == eHalf4 ) ? 4 : 2;
+		pNormalBrick.assign( nbComponents * cBrickSize, 0 );
+		computeBrickNormals( &pDensityBrick[ 0 ], pNodePos, &_scratch[ 0 ], reinterpret_cast< unsigned char* >( &pNormalBrick[ 0 ] ) );
+	}
+
+};
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Distance between two normals
+ *
+ * @param pNormal1 first normal
+ * @param pNormal2 second normal
+ *
+ * @return the distance between the normals
+ ******************************************************************************/
+static float getDistance( const float pNormal1[ 3 ], const float pNormal2[ 3 ] )
+{
+	const float x = pNormal1[ 0 ] - pNormal2[ 0 ];
+	const float y = pNormal1[ 1 ] - pNormal2[ 1 ];
+	const float z = pNormal1[ 2 ] - pNormal2[ 2 ];
+
+	return sqrtf( x * x + y * y + z * z );
+}
+
+/******************************************************************************
+ * Get a random value
+ *
+ * @param pMin min value
+ * @param pMax max value
+ *
+ * @return a random value in [ pMin ; pMax ]
+ ******************************************************************************/
+static float getRandom( float pMin, float pMax )
+{
+	return pMin + ( pMax - pMin ) * ( static_cast< float >( rand() ) / static_cast< float >( RAND_MAX ) );
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvNormalGeneratorTest::GvNormalGeneratorTest()
+:	GvTestCase( "NormalGenerator" )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvNormalGeneratorTest::~GvNormalGeneratorTest()
+{
+}
+
+/******************************************************************************
+ * Run the test
+ ******************************************************************************/
+void GvNormalGeneratorTest::run()
+{
+	srand( 1234 );
+
+	// Octahedral round-trip : axes and diagonals (on the folds of the octahedron), then random normals
+	float maxError = 0.f;
+	for ( unsigned int i = 0; i < 27 + cNbRandomNormals; i++ )
+	{
+		float normal[ 3 ];
+		if ( i < 27 )
+		{
+			normal[ 0 ] = static_cast< float >( static_cast< int >( i % 3 ) - 1 );
+			normal[ 1 ] = static_cast< float >( static_cast< int >( ( i / 3 ) % 3 ) - 1 );
+			normal[ 2 ] = static_cast< float >( static_cast< int >( i / 9 ) - 1 );
+		}
+		else
+		{
+			normal[ 0 ] = getRandom( -1.f, 1.f );
+			normal[ 1 ] = getRandom( -1.f, 1.f );
+			normal[ 2 ] = getRandom( -1.f, 1.f );
+		}
+		const float norm = sqrtf( normal[ 0 ] * normal[ 0 ] + normal[ 1 ] * normal[ 1 ] + normal[ 2 ] * normal[ 2 ] );
+		if ( norm == 0.f )
+		{
+			continue;
+		}
+		normal[ 0 ] /= norm;
+		normal[ 1 ] /= norm;
+		normal[ 2 ] /= norm;
+
+		unsigned short encodedNormal[ 2 ];
+		float decodedNormal[ 3 ];
+		GvDataStructureNormalGenerator::encodeOctahedral( normal, encodedNormal );
+		GvDataStructureNormalGenerator::decodeOctahedral( encodedNormal, decodedNormal );
+		maxError = std::max( maxError, getDistance( normal, decodedNormal ) );
+	}
+	GV_CHECK( maxError <= cMaxOctahedralError );
+
+	// A null normal is encoded as ( 0, 0, 1 )
+	const float nullNormal[ 3 ] = { 0.f, 0.f, 0.f };
+	const float zAxis[ 3 ] = { 0.f, 0.f, 1.f };
+	unsigned short encodedNullNormal[ 2 ];
+	float decodedNullNormal[ 3 ];
+	GvDataStructureNormalGenerator::encodeOctahedral( nullNormal, encodedNullNormal );
+	GvDataStructureNormalGenerator::decodeOctahedral( encodedNullNormal, decodedNullNormal );
+	GV_CHECK( getDistance( zAxis, decodedNullNormal ) <= cMaxOctahedralError );
+
+	// Random density brick, with empty voxels
+	std::vector< unsigned char > randomBrick( 4 * cBrickSize );
+	for ( unsigned int i = 0; i < cBrickSize; i++ )
+	{
+		const unsigned char density = ( rand() % 4 == 0 ) ? 0 : static_cast< unsigned char >( rand() % 256 );
+		std::fill( randomBrick.begin() + 4 * i, randomBrick.begin() + 4 * ( i + 1 ), density );
+	}
+
+	// SSE2 and scalar paths give the same normals, inside the volume and on its bounds (corner brick)
+	const unsigned int nodePositions[ 2 ][ 3 ] = { { 1, 2, 1 }, { 0, cNodeGridSize - 1, 0 } };
+	const GvDataStructureNormalGenerator::GradientOperator gradientOperators[ 2 ] = { GvDataStructureNormalGenerator::eCentralDifference, GvDataStructureNormalGenerator::eSobel };
+	const GvDataStructureNormalGenerator::NormalEncoding normalEncodings[ 2 ] = { GvDataStructureNormalGenerator::eOctahedral, GvDataStructureNormalGenerator::eHalf4 };
+	GvBrickNormalGenerator generator;
+	for ( unsigned int p = 0; p < 2; p++ )
+	for ( unsigned int o = 0; o < 2; o++ )
+	for ( unsigned int e = 0; e < 2; e++ )
+	{
+		generator.setGradientOperator( gradientOperators[ o ] );
+		generator.setNormalEncoding( normalEncodings[ e ] );
+
+		std::vector< unsigned short > simdNormals;
+		generator.useSIMD( true );
+		generator.computeBrick( randomBrick, nodePositions[ p ], simdNormals );
+
+		std::vector< unsigned short > scalarNormals;
+		generator.useSIMD( false );
+		generator.computeBrick( randomBrick, nodePositions[ p ], scalarNormals );
+
+		GV_CHECK( simdNormals == scalarNormals );
+	}
+
+	// Density ramp along the x axis : normals are the opposite of the x axis, for both gradient operators
+	std::vector< unsigned char > rampBrick( 4 * cBrickSize );
+	for ( unsigned int i = 0; i < cBrickSize; i++ )
+	{
+		const unsigned char density = static_cast< unsigned char >( 20 * ( i % ( cBrickWidth + 2 ) ) + 10 );
+		std::fill( rampBrick.begin() + 4 * i, rampBrick.begin() + 4 * ( i + 1 ), density );
+	}
+	const float xAxis[ 3 ] = { -1.f, 0.f, 0.f };
+	generator.setNormalEncoding( GvDataStructureNormalGenerator::eOctahedral );
+	generator.useSIMD( true );
+	for ( unsigned int o = 0; o < 2; o++ )
+	{
+		generator.setGradientOperator( gradientOperators[ o ] );
+
+		std::vector< unsigned short > rampNormals;
+		generator.computeBrick( rampBrick, nodePositions[ 0 ], rampNormals );
+
+		float maxRampError = 0.f;
+		for ( unsigned int i = 0; i < cBrickSize; i++ )
+		{
+			float normal[ 3 ];
+			GvDataStructureNormalGenerator::decodeOctahedral( &rampNormals[ 2 * i ], normal );
+			maxRampError = std::max( maxRampError, getDistance( xAxis, normal ) );
+		}
+		GV_CHECK( maxRampError <= cMaxOctahedralError );
+	}
+}
@@ -0,0 +1,223 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvPoolRebalancerTest.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include <GvCache/GvPoolRebalancer.h>
+
+// STL
+#include <cstddef>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvCache;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Node pool : 1000 nodes of 1000 bytes
+ */
+static const unsigned int cNodeCapacity = 1000;
+static const size_t cNodePoolMemorySize = 1000000;
+
+/**
+ * Brick pool : 900 bricks of 10000 bytes
+ */
+static const unsigned int cBrickCapacity = 900;
+static const size_t cBrickPoolMemorySize = 9000000;
+
+/**
+ * Number of frames of the sliding window
+ */
+static const unsigned int cHistorySize = 8;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Build the cache statistics of a frame
+ *
+ * @param pNbUsedNodes number of used nodes
+ * @param pNbUsedBricks number of used bricks
+ * @param pHasNodeCacheExceededCapacity flag telling wheter or not the node cache has overflowed
+ * @param pHasBrickCacheExceededCapacity flag telling wheter or not the brick cache has overflowed
+ *
+ * @return the cache statistics
+ ******************************************************************************/
+static GvPoolRebalancer::FrameStatistics getFrame( unsigned int pNbUsedNodes, unsigned int pNbUsedBricks,
+												bool pHasNodeCacheExceededCapacity = false, bool pHasBrickCacheExceededCapacity = false )
+{
+	GvPoolRebalancer::FrameStatistics frame;
+	frame._nodeCapacity = cNodeCapacity;
+	frame._brickCapacity = cBrickCapacity;
+	frame._nbUnusedNodes = cNodeCapacity - pNbUsedNodes;
+	frame._nbUnusedBricks = cBrickCapacity - pNbUsedBricks;
+	frame._hasNodeCacheExceededCapacity = pHasNodeCacheExceededCapacity;
+	frame._hasBrickCacheExceededCapacity = pHasBrickCacheExceededCapacity;
+
+	return frame;
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvPoolRebalancerTest::GvPoolRebalancerTest()
+:	GvTestCase( "PoolRebalancer" )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvPoolRebalancerTest::~GvPoolRebalancerTest()
+{
+}
+
+/******************************************************************************
+ * Run the test
+ ******************************************************************************/
+void GvPoolRebalancerTest::run()
+{
+	GvPoolRebalancer rebalancer;
+	rebalancer.setHistorySize( cHistorySize );
+	rebalancer.setSafetyMargin( 0.2f );
+	rebalancer.setMinPoolRatio( 0.01f );
+	rebalancer.setHysteresis( 0.1f );
+	rebalancer.setPoolMemorySizes( cNodePoolMemorySize, cBrickPoolMemorySize );
+	GV_CHECK( rebalancer.getMemoryBudget() == cNodePoolMemorySize + cBrickPoolMemorySize );
+
+	size_t nodePoolMemorySize = 0;
+	size_t brickPoolMemorySize = 0;
+
+	// No recommendation before the window is full, current sizes are returned
+	GV_CHECK( ! rebalancer.computeRecommendation( nodePoolMemorySize, brickPoolMemorySize ) );
+	GV_CHECK( nodePoolMemorySize == cNodePoolMemorySize && brickPoolMemorySize == cBrickPoolMemorySize );
+	GV_CHECK( rebalancer.getNodeDemand() == 0.0 );
+	for ( unsigned int i = 0; i + 1 < cHistorySize; i++ )
+	{
+		rebalancer.addFrame( getFrame( 500, 600 ) );
+	}
+	GV_CHECK( rebalancer.getNbFrames() == cHistorySize - 1 );
+	GV_CHECK( ! rebalancer.computeRecommendation( nodePoolMemorySize, brickPoolMemorySize ) );
+
+	// Steady working set : demand is the working set plus the safety margin,
+	// and the budget is split proportionally to the demands in bytes
+	rebalancer.addFrame( getFrame( 500, 600 ) );
+	GV_CHECK( isNear( rebalancer.getNodeDemand(), 600.0 ) );
+	GV_CHECK( isNear( rebalancer.getBrickDemand(), 720.0 ) );
+	GV_CHECK( rebalancer.computeRecommendation( nodePoolMemorySize, brickPoolMemorySize ) );
+	const double budget = static_cast< double >( cNodePoolMemorySize + cBrickPoolMemorySize );
+	const double expectedNodePoolMemorySize = budget * 600000.0 / ( 600000.0 + 7200000.0 );
+	GV_CHECK( isNear( static_cast< double >( nodePoolMemorySize ), expectedNodePoolMemorySize, 1.0 ) );
+	GV_CHECK( nodePoolMemorySize + brickPoolMemorySize == cNodePoolMemorySize + cBrickPoolMemorySize );
+
+	// Peak working set over the window
+	rebalancer.addFrame( getFrame( 800, 100 ) );
+	GV_CHECK( isNear( rebalancer.getNodeDemand(), 960.0 ) );
+	GV_CHECK( isNear( rebalancer.getBrickDemand(), 720.0 ) );
+
+	// Sliding window : the peak is forgotten after cHistorySize frames
+	for ( unsigned int i = 0; i < cHistorySize; i++ )
+	{
+		rebalancer.addFrame( getFrame( 500, 600 ) );
+	}
+	GV_CHECK( rebalancer.getNbFrames() == cHistorySize );
+	GV_CHECK( isNear( rebalancer.getNodeDemand(), 600.0 ) );
+
+	// Overflowing cache : the demand is extrapolated from the capacity and the fraction of overflowing frames
+	for ( unsigned int i = 0; i < cHistorySize; i++ )
+	{
+		const bool hasBrickCacheExceededCapacity = ( i % 4 == 0 );
+		rebalancer.addFrame( getFrame( 500, hasBrickCacheExceededCapacity ? cBrickCapacity : 600, false, hasBrickCacheExceededCapacity ) );
+	}
+	GV_CHECK( isNear( rebalancer.getBrickDemand(), cBrickCapacity * ( 1.0 + 0.2 + 0.25 ) ) );
+	GV_CHECK( isNear( rebalancer.getNodeDemand(), 600.0 ) );
+
+	// Unused counters greater than the capacity are clamped (empty working set)
+	GvPoolRebalancer::FrameStatistics frame = getFrame( 0, 0 );
+	frame._nbUnusedNodes = cNodeCapacity + 10;
+	rebalancer.setPoolMemorySizes( cNodePoolMemorySize, cBrickPoolMemorySize );
+	GV_CHECK( rebalancer.getNbFrames() == 0 );
+	for ( unsigned int i = 0; i < cHistorySize; i++ )
+	{
+		rebalancer.addFrame( frame );
+	}
+	GV_CHECK( rebalancer.getNodeDemand() == 0.0 );
+	GV_CHECK( rebalancer.getBrickDemand() == 0.0 );
+	GV_CHECK( ! rebalancer.computeRecommendation( nodePoolMemorySize, brickPoolMemorySize ) );
+
+	// Minimum share : an unused node cache keeps 1% of the budget
+	rebalancer.reset();
+	for ( unsigned int i = 0; i < cHistorySize; i++ )
+	{
+		rebalancer.addFrame( getFrame( 0, 800 ) );
+	}
+	GV_CHECK( rebalancer.computeRecommendation( nodePoolMemorySize, brickPoolMemorySize ) );
+	GV_CHECK( isNear( static_cast< double >( nodePoolMemorySize ), budget * 0.01, 1.0 ) );
+	GV_CHECK( nodePoolMemorySize + brickPoolMemorySize == cNodePoolMemorySize + cBrickPoolMemorySize );
+
+	// Hysteresis : a split close to the current one is not recommended,
+	// i.e. node demand of 900 x 1000 bytes for brick demand of 8100 x 10000 bytes moves less than 10% of the node pool
+	rebalancer.reset();
+	for ( unsigned int i = 0; i < cHistorySize; i++ )
+	{
+		rebalancer.addFrame( getFrame( 750, 675 ) );
+	}
+	GV_CHECK( ! rebalancer.computeRecommendation( nodePoolMemorySize, brickPoolMemorySize ) );
+	GV_CHECK( nodePoolMemorySize == cNodePoolMemorySize );
+	rebalancer.setHysteresis( 0.0f );
+	GV_CHECK( ! rebalancer.computeRecommendation( nodePoolMemorySize, brickPoolMemorySize ) );
+	for ( unsigned int i = 0; i < cHistorySize; i++ )
+	{
+		rebalancer.addFrame( getFrame( 760, 675 ) );
+	}
+	GV_CHECK( rebalancer.computeRecommendation( nodePoolMemorySize, brickPoolMemorySize ) );
+	GV_CHECK( nodePoolMemorySize > cNodePoolMemorySize );
+
+	// Applying the recommendation resets the measure
+	rebalancer.setPoolMemorySizes( nodePoolMemorySize, brickPoolMemorySize );
+	GV_CHECK( rebalancer.getNbFrames() == 0 );
+	GV_CHECK( rebalancer.getMemoryBudget() == cNodePoolMemorySize + cBrickPoolMemorySize );
+}
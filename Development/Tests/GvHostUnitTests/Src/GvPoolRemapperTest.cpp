@@ -0,0 +1,328 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvPoolRemapperTest.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include <GvCache/GvPoolRemapper.h>
+#include <GvStructure/GvVolumeTreeAddressType.h>
+
+// STL
+#include <vector>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvCache;
+using namespace GvStructure;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Node tiles of 8 nodes, bricks of 8 voxels with a border of 1 voxel
+ */
+static const unsigned int cNodeTileSize = 8;
+static const unsigned int cBrickSize = 10;
+
+/**
+ * Previous pools : 16 node tiles and 3x3x3 bricks
+ */
+static const unsigned int cNbNodeTiles = 16;
+static const uint3 cBrickPoolResolution = { 3, 3, 3 };
+
+/**
+ * Node flags
+ */
+static const unsigned int cBrickFlag = 0x40000000;
+static const unsigned int cTerminalFlag = 0x80000000;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Get the packed address of a brick (i.e. its position in the pool, in bricks)
+ ******************************************************************************/
+static unsigned int getBrick( unsigned int pX, unsigned int pY, unsigned int pZ )
+{
+	return VolTreeBrickAddress::packAddress( make_uint3( pX, pY, pZ ) );
+}
+
+/******************************************************************************
+ * Get the packed address of the first voxel of a brick (after its border)
+ ******************************************************************************/
+static unsigned int getVoxel( unsigned int pX, unsigned int pY, unsigned int pZ )
+{
+	return VolTreeBrickAddress::packAddress( make_uint3( pX * cBrickSize + 1, pY * cBrickSize + 1, pZ * cBrickSize + 1 ) );
+}
+
+/******************************************************************************
+ * Get the packed address of a node tile
+ ******************************************************************************/
+static unsigned int getNodeTile( unsigned int pIndex )
+{
+	return VolTreeNodeAddress::packAddress( pIndex );
+}
+
+/******************************************************************************
+ * Build the previous node pool and brick list
+ *
+ * Node tile 1 (root) -> 2 -> 3 -> 5 and 2 -> 4, node tile 6 is a stale one (not reachable).
+ * The brick list is sorted from the brick of node tile 5 to the brick of the root node,
+ * after the free bricks and the brick of node tile 6.
+ *
+ * @param pChildArray resulting child array
+ * @param pDataArray resulting data array
+ * @param pBrickList resulting brick list
+ ******************************************************************************/
+static void buildPools( std::vector< unsigned int >& pChildArray, std::vector< unsigned int >& pDataArray, std::vector< unsigned int >& pBrickList )
+{
+	pChildArray.assign( cNbNodeTiles * cNodeTileSize, 0 );
+	pDataArray.assign( cNbNodeTiles * cNodeTileSize, 0 );
+
+	// Root node
+	pChildArray[ 8 ] = 16 | cBrickFlag;
+	pDataArray[ 8 ] = getVoxel( 2, 0, 0 );
+
+	// Node tile 2
+	pChildArray[ 16 ] = 24;
+	pDataArray[ 16 ] = getVoxel( 0, 1, 0 );
+	pChildArray[ 17 ] = 32;
+	pDataArray[ 17 ] = getVoxel( 1, 1, 0 );
+	pChildArray[ 18 ] = cTerminalFlag;
+	pDataArray[ 18 ] = getVoxel( 2, 1, 0 );
+
+	// Node tile 3
+	pChildArray[ 24 ] = 40 | cBrickFlag;
+	pDataArray[ 24 ] = getVoxel( 0, 2, 0 );
+
+	// Node tile 4
+	pDataArray[ 32 ] = getVoxel( 1, 2, 0 );
+
+	// Node tile 5
+	pDataArray[ 40 ] = getVoxel( 2, 2, 0 );
+
+	// Node tile 6 (stale)
+	pChildArray[ 48 ] = 56;
+	pDataArray[ 48 ] = getVoxel( 0, 0, 1 );
+
+	// Used bricks, least recently used first
+	std::vector< unsigned int > usedBricks;
+	usedBricks.push_back( getBrick( 0, 0, 1 ) );
+	usedBricks.push_back( getBrick( 2, 2, 0 ) );
+	usedBricks.push_back( getBrick( 1, 2, 0 ) );
+	usedBricks.push_back( getBrick( 0, 2, 0 ) );
+	usedBricks.push_back( getBrick( 2, 1, 0 ) );
+	usedBricks.push_back( getBrick( 1, 1, 0 ) );
+	usedBricks.push_back( getBrick( 0, 1, 0 ) );
+	usedBricks.push_back( getBrick( 2, 0, 0 ) );
+
+	// Free bricks first (the first 2 bricks are locked)
+	pBrickList.clear();
+	unsigned int index = 0;
+	for ( unsigned int z = 0; z < cBrickPoolResolution.z; z++ )
+	for ( unsigned int y = 0; y < cBrickPoolResolution.y; y++ )
+	for ( unsigned int x = 0; x < cBrickPoolResolution.x; x++ )
+	{
+		const unsigned int brick = getBrick( x, y, z );
+		bool isUsed = false;
+		for ( size_t i = 0; i < usedBricks.size(); i++ )
+		{
+			isUsed = isUsed || usedBricks[ i ] == brick;
+		}
+		if ( index >= GvPoolRemapper::cNbLockedElements && ! isUsed )
+		{
+			pBrickList.push_back( brick );
+		}
+		index++;
+	}
+	pBrickList.insert( pBrickList.end(), usedBricks.begin(), usedBricks.end() );
+}
+
+/******************************************************************************
+ * Build a node tile list : free node tiles, stale ones, then the given used ones
+ *
+ * @param pUsedNodeTiles used node tiles, least recently used first
+ *
+ * @return the node tile list
+ ******************************************************************************/
+static std::vector< unsigned int > getNodeTileList( const std::vector< unsigned int >& pUsedNodeTiles )
+{
+	std::vector< unsigned int > nodeTileList;
+	for ( unsigned int nodeTile = 8; nodeTile < cNbNodeTiles; nodeTile++ )
+	{
+		nodeTileList.push_back( getNodeTile( nodeTile ) );
+	}
+	nodeTileList.push_back( getNodeTile( 6 ) );
+	nodeTileList.push_back( getNodeTile( 7 ) );
+	for ( size_t i = 0; i < pUsedNodeTiles.size(); i++ )
+	{
+		nodeTileList.push_back( getNodeTile( pUsedNodeTiles[ i ] ) );
+	}
+
+	return nodeTileList;
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvPoolRemapperTest::GvPoolRemapperTest()
+:	GvTestCase( "PoolRemapper" )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvPoolRemapperTest::~GvPoolRemapperTest()
+{
+}
+
+/******************************************************************************
+ * Run the test
+ ******************************************************************************/
+void GvPoolRemapperTest::run()
+{
+	std::vector< unsigned int > childArray;
+	std::vector< unsigned int > dataArray;
+	std::vector< unsigned int > brickList;
+	buildPools( childArray, dataArray, brickList );
+	GV_CHECK( brickList.size() == 25 );
+
+	// Node tiles used from 5 (least recently used) to 2
+	std::vector< unsigned int > usedNodeTiles;
+	usedNodeTiles.push_back( 5 );
+	usedNodeTiles.push_back( 4 );
+	usedNodeTiles.push_back( 3 );
+	usedNodeTiles.push_back( 2 );
+	const std::vector< unsigned int > nodeTileList = getNodeTileList( usedNodeTiles );
+	GV_CHECK( nodeTileList.size() == cNbNodeTiles - GvPoolRemapper::cNbLockedElements );
+
+	// Shrink : 5 node tiles (3 kept) and 2x2x1 bricks (2 kept)
+	GvPoolRemapper remapper( cNodeTileSize, cBrickSize );
+	remapper.remap( childArray, dataArray, nodeTileList, brickList, cBrickPoolResolution, 5, make_uint3( 2, 2, 1 ) );
+
+	// - the most recently used node tiles 4, 3, 2 are kept, in the order of the list, node tile 5 is dropped
+	const std::vector< GvPoolRemapper::ElementMapping >& nodeTileMappings = remapper.getNodeTileMappings();
+	GV_CHECK( nodeTileMappings.size() == 4 );
+	GV_CHECK( nodeTileMappings.size() == 4 && nodeTileMappings[ 0 ] == GvPoolRemapper::ElementMapping( 1, 1 ) );
+	GV_CHECK( nodeTileMappings.size() == 4 && nodeTileMappings[ 1 ] == GvPoolRemapper::ElementMapping( 4, 2 ) );
+	GV_CHECK( nodeTileMappings.size() == 4 && nodeTileMappings[ 2 ] == GvPoolRemapper::ElementMapping( 3, 3 ) );
+	GV_CHECK( nodeTileMappings.size() == 4 && nodeTileMappings[ 3 ] == GvPoolRemapper::ElementMapping( 2, 4 ) );
+
+	// - the most recently used bricks of kept nodes are kept : the ones of the root node and of node 16
+	const std::vector< GvPoolRemapper::ElementMapping >& brickMappings = remapper.getBrickMappings();
+	GV_CHECK( brickMappings.size() == 2 );
+	GV_CHECK( brickMappings.size() == 2 && brickMappings[ 0 ] == GvPoolRemapper::ElementMapping( getBrick( 0, 1, 0 ), getBrick( 0, 1, 0 ) ) );
+	GV_CHECK( brickMappings.size() == 2 && brickMappings[ 1 ] == GvPoolRemapper::ElementMapping( getBrick( 2, 0, 0 ), getBrick( 1, 1, 0 ) ) );
+
+	// - addresses are remapped, flags are kept, addresses of dropped elements are reset
+	const std::vector< unsigned int >& newChildArray = remapper.getChildArray();
+	const std::vector< unsigned int >& newDataArray = remapper.getDataArray();
+	GV_CHECK( newChildArray.size() == 5 * cNodeTileSize );
+	GV_CHECK( newDataArray.size() == 5 * cNodeTileSize );
+	if ( newChildArray.size() == 5 * cNodeTileSize && newDataArray.size() == 5 * cNodeTileSize )
+	{
+		GV_CHECK( newChildArray[ 8 ] == ( 32 | cBrickFlag ) );
+		GV_CHECK( newDataArray[ 8 ] == getVoxel( 1, 1, 0 ) );
+		GV_CHECK( newChildArray[ 32 ] == 24 );
+		GV_CHECK( newDataArray[ 32 ] == getVoxel( 0, 1, 0 ) );
+		GV_CHECK( newChildArray[ 33 ] == 16 );
+		GV_CHECK( newDataArray[ 33 ] == 0 );
+		GV_CHECK( newChildArray[ 34 ] == cTerminalFlag );
+		GV_CHECK( newDataArray[ 34 ] == 0 );
+		GV_CHECK( newChildArray[ 24 ] == cBrickFlag );
+		GV_CHECK( newDataArray[ 24 ] == 0 );
+		GV_CHECK( newDataArray[ 16 ] == 0 );
+	}
+
+	// - element lists only contain kept elements (no free ones), least recently used first
+	const std::vector< unsigned int >& newNodeTileList = remapper.getNodeTileList();
+	GV_CHECK( newNodeTileList.size() == 3 );
+	GV_CHECK( newNodeTileList.size() == 3 && newNodeTileList[ 0 ] == getNodeTile( 2 ) && newNodeTileList[ 2 ] == getNodeTile( 4 ) );
+	const std::vector< unsigned int >& newBrickList = remapper.getBrickList();
+	GV_CHECK( newBrickList.size() == 2 );
+	GV_CHECK( newBrickList.size() == 2 && newBrickList[ 0 ] == getBrick( 0, 1, 0 ) && newBrickList[ 1 ] == getBrick( 1, 1, 0 ) );
+
+	// Shrink with node tiles used from 3 (least recently used) to 4 : node tile 3 is dropped, so is its child node tile 5
+	usedNodeTiles.clear();
+	usedNodeTiles.push_back( 3 );
+	usedNodeTiles.push_back( 2 );
+	usedNodeTiles.push_back( 5 );
+	usedNodeTiles.push_back( 4 );
+	remapper.remap( childArray, dataArray, getNodeTileList( usedNodeTiles ), brickList, cBrickPoolResolution, 5, cBrickPoolResolution );
+	GV_CHECK( nodeTileMappings.size() == 3 );
+	GV_CHECK( nodeTileMappings.size() == 3 && nodeTileMappings[ 1 ] == GvPoolRemapper::ElementMapping( 2, 2 ) );
+	GV_CHECK( nodeTileMappings.size() == 3 && nodeTileMappings[ 2 ] == GvPoolRemapper::ElementMapping( 4, 3 ) );
+
+	// - all bricks of kept nodes fit, the one of node tile 6 is not resident
+	GV_CHECK( brickMappings.size() == 5 );
+	GV_CHECK( brickMappings.size() == 5 && brickMappings[ 0 ] == GvPoolRemapper::ElementMapping( getBrick( 1, 2, 0 ), getBrick( 2, 0, 0 ) ) );
+	GV_CHECK( brickMappings.size() == 5 && brickMappings[ 4 ] == GvPoolRemapper::ElementMapping( getBrick( 2, 0, 0 ), getBrick( 0, 2, 0 ) ) );
+	if ( newChildArray.size() == 5 * cNodeTileSize && newDataArray.size() == 5 * cNodeTileSize )
+	{
+		GV_CHECK( newChildArray[ 8 ] == ( 16 | cBrickFlag ) );
+		GV_CHECK( newDataArray[ 8 ] == getVoxel( 0, 2, 0 ) );
+		GV_CHECK( newChildArray[ 16 ] == 0 );
+		GV_CHECK( newChildArray[ 17 ] == 24 );
+		GV_CHECK( newDataArray[ 24 ] == getVoxel( 2, 0, 0 ) );
+	}
+
+	// - free elements come first in element lists
+	GV_CHECK( newNodeTileList.size() == 3 );
+	GV_CHECK( newNodeTileList.size() == 3 && newNodeTileList[ 0 ] == getNodeTile( 4 ) && newNodeTileList[ 1 ] == getNodeTile( 2 ) );
+	GV_CHECK( newBrickList.size() == 25 );
+	GV_CHECK( newBrickList.size() == 25 && newBrickList[ 0 ] == getBrick( 1, 2, 0 ) && newBrickList[ 24 ] == getBrick( 0, 2, 0 ) );
+
+	// Grow : all resident node tiles and bricks are kept
+	remapper.remap( childArray, dataArray, nodeTileList, brickList, cBrickPoolResolution, 32, make_uint3( 4, 4, 4 ) );
+	GV_CHECK( nodeTileMappings.size() == 5 );
+	GV_CHECK( nodeTileMappings.size() == 5 && nodeTileMappings[ 1 ] == GvPoolRemapper::ElementMapping( 5, 2 ) );
+	GV_CHECK( brickMappings.size() == 7 );
+	GV_CHECK( newNodeTileList.size() == 30 );
+	GV_CHECK( newBrickList.size() == 62 );
+	if ( newChildArray.size() == 32 * cNodeTileSize )
+	{
+		GV_CHECK( newChildArray[ 8 ] == ( 40 | cBrickFlag ) );
+		GV_CHECK( newChildArray[ 32 ] == ( 16 | cBrickFlag ) );
+	}
+}
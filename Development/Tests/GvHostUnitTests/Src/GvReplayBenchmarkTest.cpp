@@ -0,0 +1,389 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvReplayBenchmarkTest.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GvViewer
+#include <GvvPipelineInterface.h>
+#include <GvvCameraPath.h>
+#include <GvvCameraPathRecorder.h>
+#include <GvvReplayBenchmark.h>
+
+// STL
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GvViewer
+using namespace GvViewerCore;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Recorded frame rate (frames per second)
+ */
+static const double cRecordFrameRate = 60.0;
+
+/**
+ * Number of recorded frames
+ */
+static const unsigned int cNbRecordedFrames = 300;
+
+/**
+ * Number of frames emitting production requests after a cache clear
+ */
+static const unsigned int cNbProductionFrames = 10;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/**
+ * Mock pipeline.
+ *
+ * It stores the settings written by the replay driver, counts draws and cache clears,
+ * records the camera translation of each drawn frame and emits counters that only
+ * depend on the number of frames drawn since the last cache clear.
+ */
+class GvMockPipeline : public GvvPipelineInterface
+{
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	GvMockPipeline()
+	:	GvvPipelineInterface()
+	,	_maxDepth( 5 )
+	,	_cacheMaxNbNodeSubdivisions( 500 )
+	,	_cachePolicy( 0 )
+	,	_treeDataStructureMonitoring( false )
+	,	_nbDraws( 0 )
+	,	_nbFramesSinceClear( 0 )
+	,	_nbCacheClears( 0 )
+	,	_nbDrawsAtFirstClear( 0 )
+	{
+	}
+
+	/**
+	 * Draw a frame
+	 */
+	virtual void draw()
+	{
+		_nbDraws++;
+		_nbFramesSinceClear++;
+
+		// The ModelView matrix is the inverse of the camera frame : its translation is the opposite of the camera position
+		// (cameras of the test have no rotation)
+		_cameraPositions.push_back( -getModelViewMatrix()[ 12 ] );
+	}
+
+	/**
+	 * Clear the cache
+	 */
+	virtual void clearCache()
+	{
+		if ( _nbCacheClears == 0 )
+		{
+			_nbDrawsAtFirstClear = _nbDraws;
+		}
+		_nbCacheClears++;
+		_nbFramesSinceClear = 0;
+	}
+
+	virtual unsigned int getRendererMaxDepth() const { return _maxDepth; }
+	virtual void setRendererMaxDepth( unsigned int pValue ) { _maxDepth = pValue; }
+	virtual unsigned int getCacheMaxNbNodeSubdivisions() const { return _cacheMaxNbNodeSubdivisions; }
+	virtual void setCacheMaxNbNodeSubdivisions( unsigned int pValue ) { _cacheMaxNbNodeSubdivisions = pValue; }
+	virtual unsigned int getCachePolicy() const { return _cachePolicy; }
+	virtual void setCachePolicy( unsigned int pValue ) { _cachePolicy = pValue; }
+	virtual bool hasTreeDataStructureMonitoring() const { return _treeDataStructureMonitoring; }
+	virtual void setTreeDataStructureMonitoring( bool pFlag ) { _treeDataStructureMonitoring = pFlag; }
+
+	/**
+	 * Renderer time of frame n since the last clear is n ms
+	 */
+	virtual float getRendererElapsedTime() const { return static_cast< float >( _nbFramesSinceClear ); }
+
+	/**
+	 * Requests are only emitted by the first frames after a clear
+	 */
+	virtual unsigned int getCacheNbNodeSubdivisionRequests() const { return ( _nbFramesSinceClear <= cNbProductionFrames ) ? 100 : 0; }
+	virtual unsigned int getCacheNbBrickLoadRequests() const { return ( _nbFramesSinceClear <= cNbProductionFrames ) ? 50 : 0; }
+
+	/**
+	 * The tree is only monitored when asked for
+	 */
+	virtual unsigned int getNbTreeNodes() const { return _treeDataStructureMonitoring ? 8 * _nbFramesSinceClear : 0; }
+
+	unsigned int _maxDepth;
+	unsigned int _cacheMaxNbNodeSubdivisions;
+	unsigned int _cachePolicy;
+	bool _treeDataStructureMonitoring;
+	unsigned int _nbDraws;
+	unsigned int _nbFramesSinceClear;
+	unsigned int _nbCacheClears;
+	unsigned int _nbDrawsAtFirstClear;
+	std::vector< float > _cameraPositions;
+
+};
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Build the camera of a recorded frame (no rotation, constant speed along X)
+ *
+ * @param pFrame the recorded frame
+ *
+ * @return the camera
+ ******************************************************************************/
+static GvvCameraPath::KeyFrame getRecordedCamera( unsigned int pFrame )
+{
+	GvvCameraPath::KeyFrame camera;
+	camera._time = 0.f;
+	camera._position[ 0 ] = 0.01f * static_cast< float >( pFrame );
+	camera._position[ 1 ] = 0.f;
+	camera._position[ 2 ] = 3.f;
+	camera._orientation[ 0 ] = 0.f;
+	camera._orientation[ 1 ] = 0.f;
+	camera._orientation[ 2 ] = 0.f;
+	camera._orientation[ 3 ] = 1.f;
+	camera._fieldOfView = 0.8f;
+	camera._aspectRatio = 1.33f;
+	camera._zNear = 0.01f;
+	camera._zFar = 20.f;
+
+	return camera;
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvReplayBenchmarkTest::GvReplayBenchmarkTest()
+:	GvTestCase( "ReplayBenchmark" )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvReplayBenchmarkTest::~GvReplayBenchmarkTest()
+{
+}
+
+/******************************************************************************
+ * Run the test
+ ******************************************************************************/
+void GvReplayBenchmarkTest::run()
+{
+	GvMockPipeline pipeline;
+	pipeline._maxDepth = 9;
+	pipeline._cachePolicy = 2;
+
+	// Record a path at 60 fps, starting at an arbitrary time, with at most 20 keyframes per second
+	GvvCameraPathRecorder recorder;
+	recorder.setMinInterval( 0.05f );
+	recorder.start( &pipeline );
+	for ( unsigned int i = 0; i < cNbRecordedFrames; i++ )
+	{
+		recorder.record( 1000.0 + static_cast< double >( i ) / cRecordFrameRate, getRecordedCamera( i ) );
+	}
+	recorder.stop();
+	GV_CHECK( ! recorder.record( 2000.0, getRecordedCamera( 0 ) ) );
+
+	const GvvCameraPath& path = recorder.getCameraPath();
+	GV_CHECK( path.getNbKeyFrames() > 1 );
+	GV_CHECK( path.getNbKeyFrames() < cNbRecordedFrames / 2 );
+	GV_CHECK( path.getKeyFrame( 0 )._time == 0.f );
+	bool isIntervalRespected = true;
+	for ( unsigned int i = 1; i < path.getNbKeyFrames(); i++ )
+	{
+		isIntervalRespected = isIntervalRespected && ( path.getKeyFrame( i )._time - path.getKeyFrame( i - 1 )._time >= 0.05f );
+	}
+	GV_CHECK( isIntervalRespected );
+	GV_CHECK( path.hasPipelineSettings() );
+	GV_CHECK( path.getPipelineSettings()._rendererMaxDepth == 9 );
+	GV_CHECK( path.getPipelineSettings()._cachePolicy == 2 );
+
+	// Interpolation : positions move linearly with time, time is clamped to the path
+	GvvCameraPath::KeyFrame camera;
+	const float duration = path.getDuration();
+	GV_CHECK( path.interpolate( 0.5f * duration, camera ) );
+	GV_CHECK( isNear( camera._position[ 0 ], 0.01 * cRecordFrameRate * 0.5 * duration, 1e-4 ) );
+	GV_CHECK( isNear( camera._orientation[ 3 ], 1.0 ) );
+	GV_CHECK( path.interpolate( duration + 10.f, camera ) );
+	GV_CHECK( isNear( camera._position[ 0 ], path.getKeyFrame( path.getNbKeyFrames() - 1 )._position[ 0 ] ) );
+	GvvCameraPath emptyPath;
+	GV_CHECK( ! emptyPath.interpolate( 0.f, camera ) );
+
+	// Save/load round trip
+	const std::string pathFilename = getFilePath( "GvReplayBenchmarkTest_path.txt" );
+	GV_CHECK( path.save( pathFilename ) );
+	GvvCameraPath loadedPath;
+	GV_CHECK( loadedPath.load( pathFilename ) );
+	GV_CHECK( loadedPath.getNbKeyFrames() == path.getNbKeyFrames() );
+	bool isLoadedPathEqual = ( loadedPath.getNbKeyFrames() == path.getNbKeyFrames() );
+	for ( unsigned int i = 0; isLoadedPathEqual && i < path.getNbKeyFrames(); i++ )
+	{
+		const GvvCameraPath::KeyFrame& keyFrame = path.getKeyFrame( i );
+		const GvvCameraPath::KeyFrame& loadedKeyFrame = loadedPath.getKeyFrame( i );
+		isLoadedPathEqual = isNear( keyFrame._time, loadedKeyFrame._time )
+			&& isNear( keyFrame._position[ 0 ], loadedKeyFrame._position[ 0 ] )
+			&& isNear( keyFrame._position[ 2 ], loadedKeyFrame._position[ 2 ] )
+			&& isNear( keyFrame._fieldOfView, loadedKeyFrame._fieldOfView )
+			&& isNear( keyFrame._zFar, loadedKeyFrame._zFar );
+	}
+	GV_CHECK( isLoadedPathEqual );
+	GV_CHECK( loadedPath.hasPipelineSettings() );
+	GV_CHECK( loadedPath.getPipelineSettings()._rendererMaxDepth == 9 );
+	GV_CHECK( loadedPath.getPipelineSettings()._cacheMaxNbNodeSubdivisions == 500 );
+	GvvCameraPath missingPath;
+	GV_CHECK( ! missingPath.load( getFilePath( "GvReplayBenchmarkTest_missing.txt" ) ) );
+
+	// Change the settings of the pipeline, they must be restored by the replay
+	pipeline._maxDepth = 3;
+	pipeline._cachePolicy = 0;
+	pipeline._cacheMaxNbNodeSubdivisions = 10;
+
+	const unsigned int nbWarmupFrames = 2;
+	const float timeStep = 1.f / 30.f;
+	GvvReplayBenchmark benchmark;
+	benchmark.setGLMatrices( false );
+	benchmark.setNbWarmupFrames( nbWarmupFrames );
+	benchmark.setTimeStep( timeStep );
+	const unsigned int nbFrames = benchmark.run( pipeline, loadedPath );
+
+	// Settings, cache and monitoring
+	GV_CHECK( pipeline._maxDepth == 9 );
+	GV_CHECK( pipeline._cachePolicy == 2 );
+	GV_CHECK( pipeline._cacheMaxNbNodeSubdivisions == 500 );
+	GV_CHECK( pipeline._nbCacheClears == 1 );
+	GV_CHECK( pipeline._nbDrawsAtFirstClear == 0 );
+	GV_CHECK( ! pipeline._treeDataStructureMonitoring );
+
+	// Frames : warm-up frames first, then one frame per timestep
+	const unsigned int expectedNbFrames = static_cast< unsigned int >( floor( loadedPath.getDuration() / timeStep ) ) + 1;
+	GV_CHECK( nbFrames == expectedNbFrames );
+	GV_CHECK( benchmark.getNbFrames() == nbFrames );
+	GV_CHECK( pipeline._nbDraws == nbWarmupFrames + nbFrames );
+	bool isCameraReplayed = ( pipeline._cameraPositions.size() == nbWarmupFrames + nbFrames );
+	for ( unsigned int i = 0; isCameraReplayed && i < pipeline._cameraPositions.size(); i++ )
+	{
+		const float time = ( i < nbWarmupFrames ) ? 0.f : static_cast< float >( i - nbWarmupFrames ) * timeStep;
+		loadedPath.interpolate( time, camera );
+		isCameraReplayed = isNear( pipeline._cameraPositions[ i ], camera._position[ 0 ], 1e-4 );
+	}
+	GV_CHECK( isCameraReplayed );
+
+	// Counters : renderer time of collected frame i is ( warm-up frames + i + 1 ) ms
+	GV_CHECK( benchmark.getValue( 0, GvvReplayBenchmark::eRendererElapsedTime ) == static_cast< float >( nbWarmupFrames + 1 ) );
+	GV_CHECK( benchmark.getValue( 0, GvvReplayBenchmark::eNbTreeNodes ) == static_cast< float >( 8 * ( nbWarmupFrames + 1 ) ) );
+	const GvvReplayBenchmark::Statistics statistics = benchmark.getStatistics( GvvReplayBenchmark::eRendererElapsedTime );
+	const float offset = static_cast< float >( nbWarmupFrames );
+	GV_CHECK( statistics._min == offset + 1.f );
+	GV_CHECK( statistics._max == offset + static_cast< float >( nbFrames ) );
+	GV_CHECK( isNear( statistics._mean, offset + 0.5 * ( nbFrames + 1 ), 1e-3 ) );
+	GV_CHECK( statistics._p50 == offset + ceilf( 0.50f * nbFrames ) );
+	GV_CHECK( statistics._p95 == offset + ceilf( 0.95f * nbFrames ) );
+	GV_CHECK( statistics._p99 == offset + ceilf( 0.99f * nbFrames ) );
+
+	// Requests stop after the production frames (warm-up frames included)
+	GV_CHECK( benchmark.getConvergenceFrame() == cNbProductionFrames - nbWarmupFrames );
+	const GvvReplayBenchmark::Statistics requestStatistics = benchmark.getStatistics( GvvReplayBenchmark::eBrickLoadRequests );
+	GV_CHECK( requestStatistics._max == 50.f );
+	GV_CHECK( requestStatistics._p50 == 0.f );
+
+	// A second replay gives the same counters
+	GvvReplayBenchmark benchmark2;
+	benchmark2.setGLMatrices( false );
+	benchmark2.setNbWarmupFrames( nbWarmupFrames );
+	benchmark2.setTimeStep( timeStep );
+	GV_CHECK( benchmark2.run( pipeline, loadedPath ) == nbFrames );
+	bool isReplayDeterministic = true;
+	for ( unsigned int i = 0; i < nbFrames; i++ )
+	{
+		for ( unsigned int j = 0; j < GvvReplayBenchmark::eNbMetrics; j++ )
+		{
+			const GvvReplayBenchmark::EMetric metric = static_cast< GvvReplayBenchmark::EMetric >( j );
+			isReplayDeterministic = isReplayDeterministic && ( benchmark.getValue( i, metric ) == benchmark2.getValue( i, metric ) );
+		}
+	}
+	GV_CHECK( isReplayDeterministic );
+
+	// Reports
+	const std::string reportFilename = getFilePath( "GvReplayBenchmarkTest_report.json" );
+	GV_CHECK( benchmark.writeReport( reportFilename, "unit \"test\"" ) );
+	std::ifstream report( reportFilename.c_str() );
+	std::stringstream reportContent;
+	reportContent << report.rdbuf();
+	GV_CHECK( reportContent.str().find( "\"tag\": \"unit \\\"test\\\"\"" ) != std::string::npos );
+	GV_CHECK( reportContent.str().find( "\"p99\": " ) != std::string::npos );
+	const std::string framesFilename = getFilePath( "GvReplayBenchmarkTest_frames.csv" );
+	GV_CHECK( benchmark.writeFrames( framesFilename ) );
+	std::ifstream frames( framesFilename.c_str() );
+	unsigned int nbLines = 0;
+	std::string line;
+	while ( std::getline( frames, line ) )
+	{
+		nbLines++;
+	}
+	GV_CHECK( nbLines == nbFrames + 1 );
+
+	// Empty path
+	GvMockPipeline emptyPipeline;
+	GV_CHECK( benchmark.run( emptyPipeline, emptyPath ) == 0 );
+	GV_CHECK( emptyPipeline._nbDraws == 0 );
+}
+
+/******************************************************************************
+ * Clean data after the test
+ ******************************************************************************/
+void GvReplayBenchmarkTest::tearDown()
+{
+	remove( getFilePath( "GvReplayBenchmarkTest_path.txt" ).c_str() );
+	remove( getFilePath( "GvReplayBenchmarkTest_report.json" ).c_str() );
+	remove( getFilePath( "GvReplayBenchmarkTest_frames.csv" ).c_str() );
+}
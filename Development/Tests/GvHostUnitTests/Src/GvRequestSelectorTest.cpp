@@ -0,0 +1,287 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvRequestSelectorTest.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include <GvCache/GvRequestSelector.h>
+
+// STL
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvCache;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Types of request, stored in the highest bits of the node address
+ * (same values as in GvDataProductionManagerKernel.h, that can't be included without CUDA)
+ */
+static const unsigned int cRequestSubdivision = 0x40000000U;
+static const unsigned int cRequestLoad = 0x80000000U;
+
+/**
+ * Mask of the node address of a request
+ */
+static const unsigned int cAddressMask = 0x3FFFFFFFU;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Build a list of requests of both types, whose node address is their index in the list.
+ * Priorities are taken in a small set of values, so that there are many ties.
+ *
+ * @param pNbRequests the number of requests
+ * @param pSeed the seed of the random types and priorities
+ * @param pRequests the list of requests
+ * @param pPriorities the priorities of the requests
+ ******************************************************************************/
+static void getRequests( unsigned int pNbRequests, unsigned int pSeed, std::vector< unsigned int >& pRequests, std::vector< float >& pPriorities )
+{
+	srand( pSeed );
+	pRequests.resize( pNbRequests );
+	pPriorities.resize( pNbRequests );
+	for ( unsigned int i = 0; i < pNbRequests; i++ )
+	{
+		pRequests[ i ] = i | ( ( rand() % 3 == 0 ) ? cRequestSubdivision : cRequestLoad );
+		pPriorities[ i ] = static_cast< float >( rand() % 16 ) * 0.25f;
+	}
+}
+
+/******************************************************************************
+ * Count the requests of a given type
+ *
+ * @param pRequests the list of requests
+ * @param pRequestFlag the bit mask of the type of request
+ *
+ * @return the number of requests of the type
+ ******************************************************************************/
+static unsigned int getNbRequests( const std::vector< unsigned int >& pRequests, unsigned int pRequestFlag )
+{
+	unsigned int nbRequests = 0;
+	for ( size_t i = 0; i < pRequests.size(); i++ )
+	{
+		if ( pRequests[ i ] & pRequestFlag )
+		{
+			nbRequests++;
+		}
+	}
+
+	return nbRequests;
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvRequestSelectorTest::GvRequestSelectorTest()
+:	GvTestCase( "RequestSelector" )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvRequestSelectorTest::~GvRequestSelectorTest()
+{
+}
+
+/******************************************************************************
+ * Run the test
+ ******************************************************************************/
+void GvRequestSelectorTest::run()
+{
+	GvRequestSelector selector;
+
+	// Budgets
+	GV_CHECK( selector.getBudget( cRequestSubdivision ) == 0 );
+	selector.setBudget( cRequestSubdivision, 10 );
+	selector.setBudget( cRequestLoad, 5 );
+	selector.setBudget( cRequestLoad, 20 );
+	GV_CHECK( selector.getBudget( cRequestSubdivision ) == 10 );
+	GV_CHECK( selector.getBudget( cRequestLoad ) == 20 );
+
+	std::vector< unsigned int > requests;
+	std::vector< float > priorities;
+
+	// Short-cut : a list not longer than the budget of each type is never over budget
+	getRequests( 10, 1, requests, priorities );
+	GV_CHECK( ! selector.isOverBudget( &requests[ 0 ], 10 ) );
+	GV_CHECK( ! selector.isOverBudget( NULL, 0 ) );
+
+	// Longer lists are counted per type : 20 loads fit in the budget, 11 subdivisions don't
+	requests.assign( 20, cRequestLoad );
+	requests.resize( 30, cRequestSubdivision );
+	GV_CHECK( ! selector.isOverBudget( &requests[ 0 ], 30 ) );
+	requests.push_back( cRequestSubdivision );
+	GV_CHECK( selector.isOverBudget( &requests[ 0 ], 31 ) );
+	requests.assign( 21, cRequestLoad );
+	GV_CHECK( selector.isOverBudget( &requests[ 0 ], 21 ) );
+
+	// When the list is not over budget, all requests are selected,
+	// so skipping the selection doesn't change which requests are handled
+	getRequests( 25, 2, requests, priorities );
+	while ( selector.isOverBudget( &requests[ 0 ], static_cast< unsigned int >( requests.size() ) ) )
+	{
+		requests.pop_back();
+		priorities.pop_back();
+	}
+	const unsigned int nbRequests = static_cast< unsigned int >( requests.size() );
+	GV_CHECK( nbRequests > 10 );
+	GV_CHECK( selector.select( &requests[ 0 ], &priorities[ 0 ], nbRequests ) == nbRequests );
+
+	// Budget selection : the requests with the highest priorities of each type are at the front of the list
+	const unsigned int cNbRequests = 1000;
+	std::vector< unsigned int > initialRequests;
+	std::vector< float > initialPriorities;
+	getRequests( cNbRequests, 3, initialRequests, initialPriorities );
+	requests = initialRequests;
+	priorities = initialPriorities;
+	GV_CHECK( selector.isOverBudget( &requests[ 0 ], cNbRequests ) );
+	const unsigned int nbSelected = selector.select( &requests[ 0 ], &priorities[ 0 ], cNbRequests );
+	GV_CHECK( nbSelected == 30 );
+	GV_CHECK( getNbRequests( std::vector< unsigned int >( requests.begin(), requests.begin() + nbSelected ), cRequestSubdivision ) == 10 );
+	GV_CHECK( getNbRequests( std::vector< unsigned int >( requests.begin(), requests.begin() + nbSelected ), cRequestLoad ) == 20 );
+
+	// Priorities follow their requests, and the list is a permutation of the initial one
+	bool isPermutation = true;
+	std::vector< unsigned char > isFound( cNbRequests, 0 );
+	for ( unsigned int i = 0; i < cNbRequests; i++ )
+	{
+		const unsigned int index = requests[ i ] & cAddressMask;
+		isPermutation = isPermutation && index < cNbRequests && ! isFound[ index ]
+			&& requests[ i ] == initialRequests[ index ] && priorities[ i ] == initialPriorities[ index ];
+		isFound[ index ] = 1;
+	}
+	GV_CHECK( isPermutation );
+
+	// Selected requests are the best of their type : no request left behind has a higher priority
+	const unsigned int flags[ 2 ] = { cRequestSubdivision, cRequestLoad };
+	for ( unsigned int k = 0; k < 2; k++ )
+	{
+		std::vector< float > typePriorities;
+		for ( unsigned int i = 0; i < cNbRequests; i++ )
+		{
+			if ( initialRequests[ i ] & flags[ k ] )
+			{
+				typePriorities.push_back( initialPriorities[ i ] );
+			}
+		}
+		std::sort( typePriorities.begin(), typePriorities.end(), std::greater< float >() );
+		const float threshold = typePriorities[ selector.getBudget( flags[ k ] ) - 1 ];
+		bool isBest = true;
+		for ( unsigned int i = 0; i < cNbRequests; i++ )
+		{
+			if ( requests[ i ] & flags[ k ] )
+			{
+				isBest = isBest && ( ( i < nbSelected ) ? ( priorities[ i ] >= threshold ) : ( priorities[ i ] <= threshold ) );
+			}
+		}
+		GV_CHECK( isBest );
+	}
+
+	// Order : selected requests by decreasing priority, ties by initial position,
+	// then other requests in their initial order
+	bool isOrdered = true;
+	for ( unsigned int i = 1; i < cNbRequests; i++ )
+	{
+		const unsigned int index1 = requests[ i - 1 ] & cAddressMask;
+		const unsigned int index2 = requests[ i ] & cAddressMask;
+		if ( i < nbSelected )
+		{
+			isOrdered = isOrdered && ( priorities[ i - 1 ] > priorities[ i ] || ( priorities[ i - 1 ] == priorities[ i ] && index1 < index2 ) );
+		}
+		else if ( i > nbSelected )
+		{
+			isOrdered = isOrdered && ( index1 < index2 );
+		}
+	}
+	GV_CHECK( isOrdered );
+
+	// Tie ordering : with equal priorities, the first requests of each type in the list are selected
+	requests = initialRequests;
+	priorities.assign( cNbRequests, 1.f );
+	GV_CHECK( selector.select( &requests[ 0 ], &priorities[ 0 ], cNbRequests ) == 30 );
+	std::vector< unsigned int > firstRequests;
+	unsigned int nbSubdivisions = 0;
+	unsigned int nbLoads = 0;
+	for ( unsigned int i = 0; i < cNbRequests; i++ )
+	{
+		if ( ( initialRequests[ i ] & cRequestSubdivision ) ? ( nbSubdivisions++ < 10 ) : ( nbLoads++ < 20 ) )
+		{
+			firstRequests.push_back( initialRequests[ i ] );
+		}
+	}
+	const bool isFirst = std::equal( firstRequests.begin(), firstRequests.end(), requests.begin() );
+	GV_CHECK( isFirst );
+
+	// The selection is deterministic, and scratch buffers are reused by shorter lists
+	std::vector< unsigned int > requests2 = initialRequests;
+	std::vector< float > priorities2 = initialPriorities;
+	selector.select( &requests2[ 0 ], &priorities2[ 0 ], cNbRequests );
+	requests = initialRequests;
+	priorities = initialPriorities;
+	selector.select( &requests[ 0 ], &priorities[ 0 ], cNbRequests );
+	GV_CHECK( requests == requests2 && priorities == priorities2 );
+	GV_CHECK( selector.select( &requests[ 0 ], &priorities[ 0 ], 5 ) == 5 );
+
+	// A type without budget is never selected, and keeps its initial order
+	GvRequestSelector loadSelector;
+	loadSelector.setBudget( cRequestLoad, 3 );
+	requests = initialRequests;
+	priorities = initialPriorities;
+	GV_CHECK( loadSelector.select( &requests[ 0 ], &priorities[ 0 ], cNbRequests ) == 3 );
+	GV_CHECK( getNbRequests( std::vector< unsigned int >( requests.begin(), requests.begin() + 3 ), cRequestLoad ) == 3 );
+	loadSelector.setBudget( cRequestLoad, 0 );
+	requests = initialRequests;
+	priorities = initialPriorities;
+	GV_CHECK( loadSelector.isOverBudget( &requests[ 0 ], cNbRequests ) );
+	GV_CHECK( loadSelector.select( &requests[ 0 ], &priorities[ 0 ], cNbRequests ) == 0 );
+	GV_CHECK( requests == initialRequests );
+}
@@ -0,0 +1,311 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvSpatialHashTest.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include <GvCore/StaticRes3D.h>
+#include <GvStructure/GvSpatialHashKernel.h>
+
+// STL
+#include <map>
+#include <vector>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvCore;
+using namespace GvStructure;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/**
+ * Spatial hash of node tiles of 2x2x2 nodes
+ */
+typedef GvSpatialHashKernel< StaticRes3D< 2, 2, 2 > > SpatialHashType;
+
+/**
+ * Type definition of keys
+ */
+typedef SpatialHashType::KeyType KeyType;
+
+/**
+ * @class Table
+ *
+ * @brief Host memory of a spatial hash
+ */
+class Table
+{
+
+public:
+
+	/**
+	 * Spatial hash using the host memory
+	 */
+	SpatialHashType _kernelObject;
+
+	/**
+	 * Constructor
+	 *
+	 * @param pCapacity number of slots (power of two)
+	 */
+	Table( unsigned int pCapacity )
+	:	_keys( pCapacity, GV_SPATIAL_HASH_EMPTY_KEY )
+	,	_values( pCapacity, GV_SPATIAL_HASH_INVALID_VALUE )
+	{
+		_kernelObject._keys = &_keys[ 0 ];
+		_kernelObject._values = &_values[ 0 ];
+		_kernelObject._capacityMask = pCapacity - 1;
+	}
+
+	/**
+	 * Get the number of slots holding a given key
+	 *
+	 * @param pKey the key
+	 *
+	 * @return the number of slots
+	 */
+	unsigned int count( KeyType pKey ) const
+	{
+		unsigned int result = 0;
+		for ( size_t i = 0; i < _keys.size(); i++ )
+		{
+			result += ( _keys[ i ] == pKey ) ? 1 : 0;
+		}
+
+		return result;
+	}
+
+private:
+
+	/**
+	 * Key array
+	 */
+	std::vector< KeyType > _keys;
+
+	/**
+	 * Value array
+	 */
+	std::vector< unsigned int > _values;
+
+};
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Get a pseudo-random number (linear congruential generator, reproducible on all platforms)
+ *
+ * @param pSeed the state of the generator
+ *
+ * @return a number in [ 0 ; 2^31 [
+ ******************************************************************************/
+static unsigned int getRandom( unsigned int& pSeed )
+{
+	pSeed = pSeed * 1103515245U + 12345U;
+
+	return ( pSeed >> 1 ) & 0x7FFFFFFF;
+}
+
+/******************************************************************************
+ * Get the key of a node
+ *
+ * @param pIndex index of the node in a grid of 16x16x16 nodes (node depth 3)
+ *
+ * @return the key of the node
+ ******************************************************************************/
+static KeyType getNodeKey( unsigned int pIndex )
+{
+	return GvMortonCode::encode( make_uint3( pIndex & 15, ( pIndex >> 4 ) & 15, ( pIndex >> 8 ) & 15 ), 4 );
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvSpatialHashTest::GvSpatialHashTest()
+:	GvTestCase( "SpatialHash" )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvSpatialHashTest::~GvSpatialHashTest()
+{
+}
+
+/******************************************************************************
+ * Run the test
+ ******************************************************************************/
+void GvSpatialHashTest::run()
+{
+	// Random insert/erase/find sequence, against a std::map
+	{
+		Table table( 256 );
+		std::map< KeyType, unsigned int > reference;
+		unsigned int seed = 1;
+		unsigned int nbInsertErrors = 0;
+		unsigned int nbEraseErrors = 0;
+		unsigned int nbFindErrors = 0;
+		for ( unsigned int i = 0; i < 20000; i++ )
+		{
+			// 200 distinct keys at most : the load factor stays under 0.8
+			const KeyType key = getNodeKey( getRandom( seed ) % 200 );
+			const unsigned int operation = getRandom( seed ) % 3;
+			if ( operation == 0 )
+			{
+				const bool isInserted = table._kernelObject.insert( key, i );
+				const bool isExpected = reference.find( key ) == reference.end();
+				if ( isExpected )
+				{
+					reference[ key ] = i;
+				}
+				nbInsertErrors += ( isInserted != isExpected ) ? 1 : 0;
+			}
+			else if ( operation == 1 )
+			{
+				const unsigned int value = table._kernelObject.erase( key );
+				std::map< KeyType, unsigned int >::iterator it = reference.find( key );
+				const unsigned int expectedValue = ( it != reference.end() ) ? it->second : GV_SPATIAL_HASH_INVALID_VALUE;
+				if ( it != reference.end() )
+				{
+					reference.erase( it );
+				}
+				nbEraseErrors += ( value != expectedValue ) ? 1 : 0;
+			}
+			else
+			{
+				std::map< KeyType, unsigned int >::const_iterator it = reference.find( key );
+				const unsigned int expectedValue = ( it != reference.end() ) ? it->second : GV_SPATIAL_HASH_INVALID_VALUE;
+				nbFindErrors += ( table._kernelObject.find( key ) != expectedValue ) ? 1 : 0;
+			}
+		}
+		GV_CHECK( nbInsertErrors == 0 );
+		GV_CHECK( nbEraseErrors == 0 );
+		GV_CHECK( nbFindErrors == 0 );
+
+		// - final content
+		unsigned int nbContentErrors = 0;
+		for ( unsigned int i = 0; i < 200; i++ )
+		{
+			const KeyType key = getNodeKey( i );
+			std::map< KeyType, unsigned int >::const_iterator it = reference.find( key );
+			const unsigned int expectedValue = ( it != reference.end() ) ? it->second : GV_SPATIAL_HASH_INVALID_VALUE;
+			nbContentErrors += ( table._kernelObject.find( key ) != expectedValue || table.count( key ) != ( ( it != reference.end() ) ? 1U : 0U ) ) ? 1 : 0;
+		}
+		GV_CHECK( nbContentErrors == 0 );
+	}
+
+	// Erased slots are reused : far more keys than slots go through the table
+	{
+		Table table( 16 );
+		unsigned int nbInsertErrors = 0;
+		unsigned int nbFindErrors = 0;
+		for ( unsigned int round = 0; round < 100; round++ )
+		{
+			for ( unsigned int i = 0; i < 12; i++ )
+			{
+				nbInsertErrors += table._kernelObject.insert( getNodeKey( round * 12 + i ), i ) ? 0 : 1;
+			}
+			for ( unsigned int i = 0; i < 12; i++ )
+			{
+				nbFindErrors += ( table._kernelObject.find( getNodeKey( round * 12 + i ) ) == i ) ? 0 : 1;
+				table._kernelObject.erase( getNodeKey( round * 12 + i ) );
+			}
+		}
+		GV_CHECK( nbInsertErrors == 0 );
+		GV_CHECK( nbFindErrors == 0 );
+		GV_CHECK( table.count( GV_SPATIAL_HASH_DELETED_KEY ) + table.count( GV_SPATIAL_HASH_EMPTY_KEY ) == 16 );
+	}
+
+	// A key stored after erased slots is not inserted twice
+	{
+		Table table( 8 );
+		for ( unsigned int i = 0; i < 8; i++ )
+		{
+			table._kernelObject.insert( getNodeKey( i ), i );
+		}
+		GV_CHECK( table.count( GV_SPATIAL_HASH_EMPTY_KEY ) == 0 );
+		GV_CHECK( ! table._kernelObject.insert( getNodeKey( 8 ), 8 ) );
+		for ( unsigned int i = 0; i < 4; i++ )
+		{
+			table._kernelObject.erase( getNodeKey( i ) );
+		}
+		unsigned int nbDuplicates = 0;
+		for ( unsigned int i = 4; i < 8; i++ )
+		{
+			nbDuplicates += table._kernelObject.insert( getNodeKey( i ), 0 ) ? 1 : 0;
+			nbDuplicates += ( table.count( getNodeKey( i ) ) == 1 && table._kernelObject.find( getNodeKey( i ) ) == i ) ? 0 : 1;
+		}
+		GV_CHECK( nbDuplicates == 0 );
+		GV_CHECK( table.count( GV_SPATIAL_HASH_DELETED_KEY ) == 4 );
+
+		// - the table is full again, without empty slot
+		for ( unsigned int i = 0; i < 4; i++ )
+		{
+			GV_CHECK( table._kernelObject.insert( getNodeKey( 8 + i ), 8 + i ) );
+		}
+		GV_CHECK( ! table._kernelObject.insert( getNodeKey( 12 ), 12 ) );
+		GV_CHECK( table._kernelObject.find( getNodeKey( 11 ) ) == 11 );
+		GV_CHECK( table._kernelObject.find( getNodeKey( 12 ) ) == GV_SPATIAL_HASH_INVALID_VALUE );
+	}
+
+	// Deepest node containing a position
+	{
+		Table table( 64 );
+		const float3 position = make_float3( 0.3f, 0.6f, 0.9f );
+		for ( unsigned int depth = 0; depth < 4; depth++ )
+		{
+			table._kernelObject.insert( SpatialHashType::getKey( position, depth ), depth );
+		}
+		GV_CHECK( SpatialHashType::getKey( position, 0 ) == GvMortonCode::encode( make_uint3( 0, 1, 1 ), 1 ) );
+		GV_CHECK( SpatialHashType::getKey( position, 3 ) == GvMortonCode::encode( make_uint3( 4, 9, 14 ), 4 ) );
+
+		unsigned int depth = 0;
+		GV_CHECK( table._kernelObject.findDeepest( position, 10, depth ) == 3 && depth == 3 );
+		GV_CHECK( table._kernelObject.findDeepest( position, 1, depth ) == 1 && depth == 1 );
+		table._kernelObject.erase( SpatialHashType::getKey( position, 2 ) );
+		GV_CHECK( table._kernelObject.findDeepest( position, 10, depth ) == 1 && depth == 1 );
+		GV_CHECK( table._kernelObject.findDeepest( make_float3( 0.7f, 0.6f, 0.9f ), 10, depth ) == GV_SPATIAL_HASH_INVALID_VALUE );
+	}
+}
@@ -0,0 +1,176 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvTestCase.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <cmath>
+#include <iostream>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pName name of the test
+ ******************************************************************************/
+GvTestCase::GvTestCase( const std::string& pName )
+:	_name( pName )
+,	_workingDirectory( "." )
+,	_nbChecks( 0 )
+,	_nbFailures( 0 )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvTestCase::~GvTestCase()
+{
+}
+
+/******************************************************************************
+ * Get the name of the test
+ *
+ * @return the name of the test
+ ******************************************************************************/
+const std::string& GvTestCase::getName() const
+{
+	return _name;
+}
+
+/******************************************************************************
+ * Get the number of evaluated checks
+ *
+ * @return the number of evaluated checks
+ ******************************************************************************/
+unsigned int GvTestCase::getNbChecks() const
+{
+	return _nbChecks;
+}
+
+/******************************************************************************
+ * Get the number of failed checks
+ *
+ * @return the number of failed checks
+ ******************************************************************************/
+unsigned int GvTestCase::getNbFailures() const
+{
+	return _nbFailures;
+}
+
+/******************************************************************************
+ * Prepare the test
+ *
+ * @param pWorkingDirectory directory where temporary files are written
+ *
+ * @return a flag telling wheter or not the test can be run
+ ******************************************************************************/
+bool GvTestCase::setUp( const std::string& pWorkingDirectory )
+{
+	_workingDirectory = pWorkingDirectory;
+	_nbChecks = 0;
+	_nbFailures = 0;
+
+	return true;
+}
+
+/******************************************************************************
+ * Clean data after the test
+ ******************************************************************************/
+void GvTestCase::tearDown()
+{
+}
+
+/******************************************************************************
+ * Evaluate a check (use the GV_CHECK() macro)
+ *
+ * @param pCondition the result of the check
+ * @param pExpression the checked expression
+ * @param pFile the source file
+ * @param pLine the source line
+ *
+ * @return the result of the check
+ ******************************************************************************/
+bool GvTestCase::check( bool pCondition, const char* pExpression, const char* pFile, int pLine )
+{
+	_nbChecks++;
+	if ( ! pCondition )
+	{
+		_nbFailures++;
+		std::cerr << pFile << "(" << pLine << ") : " << _name << " : check failed : " << pExpression << std::endl;
+	}
+
+	return pCondition;
+}
+
+/******************************************************************************
+ * Tell wheter or not two values are equal up to a tolerance
+ *
+ * @param pValue1 first value
+ * @param pValue2 second value
+ * @param pEpsilon tolerance
+ *
+ * @return a flag telling wheter or not values are equal
+ ******************************************************************************/
+bool GvTestCase::isNear( double pValue1, double pValue2, double pEpsilon )
+{
+	return fabs( pValue1 - pValue2 ) <= pEpsilon;
+}
+
+/******************************************************************************
+ * Get the full path of a temporary file
+ *
+ * @param pFilename the file name
+ *
+ * @return the path of the file in the working directory
+ ******************************************************************************/
+std::string GvTestCase::getFilePath( const std::string& pFilename ) const
+{
+	return _workingDirectory + "/" + pFilename;
+}
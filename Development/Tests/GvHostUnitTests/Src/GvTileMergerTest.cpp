@@ -0,0 +1,349 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvTileMergerTest.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GvVoxelizer
+#include "GvxSceneVoxelizer.h"
+#include "GvxVoxelizerEngine.h"
+#include "GvxDataStructureIOHandler.h"
+#include "GvxTileMerger.h"
+
+// STL
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+
+// System
+#ifndef WIN32
+	#include <sys/types.h>
+	#include <sys/wait.h>
+	#include <unistd.h>
+#endif
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GvVoxelizer
+using namespace Gvx;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Settings of the voxelization : 16^3 nodes of 8^3 voxels, cut in 2^3 tiles
+ */
+static const unsigned int cMaxResolution = 4;
+static const unsigned int cBrickWidth = 8;
+static const unsigned int cTileSize = 8;
+
+/**
+ * Number of triangles of the synthetic scene
+ */
+static const unsigned int cNbTriangles = 300;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/**
+ * @class GvSyntheticScene
+ *
+ * @brief Scene of random triangles, already normalized, generated from a seed.
+ * Every instance built with the same seed gives the same triangles to the voxelizer engine.
+ */
+class GvSyntheticScene : public GvxSceneVoxelizer
+{
+
+public:
+
+	/**
+	 * Constructor
+	 *
+	 * @param pName name of the generated data
+	 * @param pSeed seed of the random triangles
+	 */
+	GvSyntheticScene( const std::string& pName, unsigned int pSeed )
+	:	GvxSceneVoxelizer()
+	,	_seed( pSeed )
+	{
+		setFileName( pName );
+		setMaxResolution( cMaxResolution );
+		setBrickWidth( cBrickWidth );
+		setDataType( GvxDataTypeHandler::gvUCHAR4 );
+		setNormals( true );
+		setFilterType( 1 );
+		setFilterIterations( 1 );
+	}
+
+protected:
+
+	/**
+	 * Seed of the random triangles
+	 */
+	unsigned int _seed;
+
+	/**
+	 * Load/import the scene
+	 */
+	virtual bool loadScene()
+	{
+		return true;
+	}
+
+	/**
+	 * Normalize the scene (triangles are generated in the normalized space)
+	 */
+	virtual bool normalizeScene()
+	{
+		return true;
+	}
+
+	/**
+	 * Voxelize the scene
+	 */
+	virtual bool voxelizeScene()
+	{
+		_voxelizerEngine.init( getMaxResolution(), getBrickWidth(), getFileName(), getDataType() );
+
+		return voxelizeTriangles( _voxelizerEngine );
+	}
+
+	/**
+	 * Give all triangles of the scene to a voxelizer engine, in a deterministic order :
+	 * small triangles, and a large one every 10 triangles to cross tile boundaries
+	 *
+	 * @param pVoxelizerEngine the voxelizer engine
+	 */
+	virtual bool voxelizeTriangles( GvxVoxelizerEngine& pVoxelizerEngine )
+	{
+		srand( _seed );
+		for ( unsigned int i = 0; i < cNbTriangles; i++ )
+		{
+			const float extent = ( i % 10 == 0 ) ? 0.3f : 0.06f;
+			const float center[ 3 ] = { getRandom( 0.05f, 0.95f ), getRandom( 0.05f, 0.95f ), getRandom( 0.05f, 0.95f ) };
+			float vertices[ 9 ];
+			for ( unsigned int k = 0; k < 9; k++ )
+			{
+				vertices[ k ] = std::min( 0.975f, std::max( 0.025f, center[ k % 3 ] + getRandom( -extent, extent ) ) );
+			}
+			const float color[ 3 ] = { getRandom( 0.f, 1.f ), getRandom( 0.f, 1.f ), getRandom( 0.f, 1.f ) };
+			for ( unsigned int k = 0; k < 3; k++ )
+			{
+				pVoxelizerEngine.setColor( color[ 0 ], color[ 1 ], color[ 2 ] );
+				pVoxelizerEngine.setNormal( color[ 1 ], 0.f, 1.f );
+				pVoxelizerEngine.setVertex( vertices[ 3 * k ], vertices[ 3 * k + 1 ], vertices[ 3 * k + 2 ] );
+			}
+			pVoxelizerEngine.voxelizeTriangle();
+		}
+
+		return true;
+	}
+
+	/**
+	 * Get a random value
+	 *
+	 * @param pMin min value
+	 * @param pMax max value
+	 *
+	 * @return a random value in [ pMin ; pMax ]
+	 */
+	static float getRandom( float pMin, float pMax )
+	{
+		return pMin + ( pMax - pMin ) * ( static_cast< float >( rand() ) / static_cast< float >( RAND_MAX ) );
+	}
+
+};
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvTileMergerTest::GvTileMergerTest()
+:	GvTestCase( "TileMerger" )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvTileMergerTest::~GvTileMergerTest()
+{
+}
+
+/******************************************************************************
+ * Tell wheter or not two files have the same content
+ *
+ * @param pFileName1 first file name
+ * @param pFileName2 second file name
+ *
+ * @return a flag telling wheter or not the files have the same content
+ ******************************************************************************/
+bool GvTileMergerTest::isSameFile( const std::string& pFileName1, const std::string& pFileName2 )
+{
+	FILE* file1 = fopen( pFileName1.c_str(), "rb" );
+	FILE* file2 = fopen( pFileName2.c_str(), "rb" );
+	bool isSame = ( file1 != NULL && file2 != NULL );
+	while ( isSame )
+	{
+		char buffer1[ 4096 ];
+		char buffer2[ 4096 ];
+		const size_t size1 = fread( buffer1, 1, sizeof( buffer1 ), file1 );
+		const size_t size2 = fread( buffer2, 1, sizeof( buffer2 ), file2 );
+		isSame = ( size1 == size2 ) && std::equal( buffer1, buffer1 + size1, buffer2 );
+		if ( size1 == 0 )
+		{
+			break;
+		}
+	}
+	if ( file1 != NULL )
+	{
+		fclose( file1 );
+	}
+	if ( file2 != NULL )
+	{
+		fclose( file2 );
+	}
+
+	return isSame;
+}
+
+/******************************************************************************
+ * Run the test
+ ******************************************************************************/
+void GvTileMergerTest::run()
+{
+	const unsigned int seed = 1234;
+	const std::string singleName = getFilePath( "TileMergerTest_single" );
+	const std::string mergedName = getFilePath( "TileMergerTest_merged" );
+
+	// Single-process voxelization
+	GvSyntheticScene singleScene( singleName, seed );
+	GV_CHECK( singleScene.launchVoxelizationStage() );
+	singleScene.getVoxelizerEngine().end();
+
+	// Tile origins
+	const unsigned int nodeGridSize = 1 << cMaxResolution;
+	std::vector< unsigned int > tileOrigins;
+	for ( unsigned int z = 0; z < nodeGridSize; z += cTileSize )
+	for ( unsigned int y = 0; y < nodeGridSize; y += cTileSize )
+	for ( unsigned int x = 0; x < nodeGridSize; x += cTileSize )
+	{
+		tileOrigins.push_back( x );
+		tileOrigins.push_back( y );
+		tileOrigins.push_back( z );
+	}
+	const size_t nbTiles = tileOrigins.size() / 3;
+	GV_CHECK( nbTiles == 8 );
+
+	// One process per tile
+	unsigned int nbVoxelizedTiles = 0;
+#ifndef WIN32
+	std::vector< pid_t > processes;
+	for ( size_t i = 0; i < nbTiles; i++ )
+	{
+		const pid_t process = fork();
+		if ( process == 0 )
+		{
+			GvSyntheticScene tileScene( mergedName, seed );
+			const bool isSucceeded = tileScene.launchTileVoxelizationProcess( &tileOrigins[ 3 * i ], cTileSize );
+			_exit( isSucceeded ? 0 : 1 );
+		}
+		processes.push_back( process );
+	}
+	for ( size_t i = 0; i < processes.size(); i++ )
+	{
+		int status = 1;
+		if ( processes[ i ] > 0 && waitpid( processes[ i ], &status, 0 ) == processes[ i ] && WIFEXITED( status ) && WEXITSTATUS( status ) == 0 )
+		{
+			nbVoxelizedTiles++;
+		}
+	}
+#else
+	for ( size_t i = 0; i < nbTiles; i++ )
+	{
+		GvSyntheticScene tileScene( mergedName, seed );
+		if ( tileScene.launchTileVoxelizationProcess( &tileOrigins[ 3 * i ], cTileSize ) )
+		{
+			nbVoxelizedTiles++;
+		}
+	}
+#endif
+	GV_CHECK( nbVoxelizedTiles == nbTiles );
+
+	// Merge
+	GvSyntheticScene mergedScene( mergedName, seed );
+	GvxTileMerger tileMerger( mergedScene );
+	for ( size_t i = 0; i < nbTiles; i++ )
+	{
+		tileMerger.addTile( GvxTileMerger::getTileName( mergedName, &tileOrigins[ 3 * i ] ) );
+	}
+	GV_CHECK( tileMerger.execute() );
+
+	// Missing tiles are refused
+	GvxTileMerger partialTileMerger( mergedScene );
+	partialTileMerger.addTile( getFilePath( "TileMergerTest_missing" ) );
+	GV_CHECK( ! partialTileMerger.execute() );
+
+	// Compare all levels
+	std::vector< GvxDataTypeHandler::VoxelDataType > dataTypes;
+	dataTypes.push_back( GvxDataTypeHandler::gvUCHAR4 );
+	dataTypes.push_back( GvxDataTypeHandler::gvHALF4 );
+	for ( unsigned int level = 0; level <= cMaxResolution; level++ )
+	{
+		GV_CHECK( isSameFile( GvxDataStructureIOHandler::getFileNameNode( singleName, level, cBrickWidth ),
+							GvxDataStructureIOHandler::getFileNameNode( mergedName, level, cBrickWidth ) ) );
+		for ( unsigned int channel = 0; channel < dataTypes.size(); channel++ )
+		{
+			const std::string typeName = GvxDataTypeHandler::getTypeName( dataTypes[ channel ] );
+			GV_CHECK( isSameFile( GvxDataStructureIOHandler::getFileNameBrick( singleName, level, cBrickWidth, channel, typeName ),
+								GvxDataStructureIOHandler::getFileNameBrick( mergedName, level, cBrickWidth, channel, typeName ) ) );
+		}
+		GV_CHECK( isSameFile( GvxDataStructureIOHandler::getFileNameSummary( singleName, level, cBrickWidth ),
+							GvxDataStructureIOHandler::getFileNameSummary( mergedName, level, cBrickWidth ) ) );
+	}
+
+	// The comparison is not blind : different scenes give different files
+	GvSyntheticScene otherScene( getFilePath( "TileMergerTest_other" ), seed + 1 );
+	GV_CHECK( otherScene.launchVoxelizationStage() );
+	otherScene.getVoxelizerEngine().end();
+	GV_CHECK( ! isSameFile( GvxDataStructureIOHandler::getFileNameNode( singleName, cMaxResolution, cBrickWidth ),
+							GvxDataStructureIOHandler::getFileNameNode( getFilePath( "TileMergerTest_other" ), cMaxResolution, cBrickWidth ) ) );
+}
@@ -0,0 +1,245 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvTimeSeriesTest.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include <GvVoxelizer/GvTimeSeries.h>
+#include <GvVoxelizer/GvTimeSeriesWriter.h>
+#include <GvVoxelizer/GvDataTypeHandler.h>
+
+// STL
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvCore;
+using namespace GvVoxelizer;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Dataset : 4 levels of bricks of 2^3 voxels with a border of 1 voxel, one channel of uchar
+ */
+static const unsigned int cNbLevels = 4;
+static const unsigned int cBrickResolution = 2;
+static const unsigned int cBorderSize = 1;
+static const size_t cBrickSize = 4 * 4 * 4;
+
+/**
+ * Flag of nodes having a brick (see ".nodes" files)
+ */
+static const unsigned int cBrickFlag = 0x40000000U;
+
+/**
+ * Changed nodes of the second time step (level, index in the node grid of the level)
+ */
+static const unsigned int cNbChangedNodes = 5;
+static const unsigned int cChangedNodes[ cNbChangedNodes ][ 2 ] = { { 0, 0 }, { 1, 5 }, { 3, 7 }, { 3, 100 }, { 3, 511 } };
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Get the position of a node in the node grid of its level
+ *
+ * @param pLevel level of resolution
+ * @param pNodeIndex index of the node in the node grid of the level
+ *
+ * @return the position of the node
+ ******************************************************************************/
+static uint3 getNodePosition( unsigned int pLevel, unsigned int pNodeIndex )
+{
+	const unsigned int levelResolution = 1 << pLevel;
+
+	return make_uint3( pNodeIndex % levelResolution, ( pNodeIndex / levelResolution ) % levelResolution, pNodeIndex / ( levelResolution * levelResolution ) );
+}
+
+/******************************************************************************
+ * Get the Morton key of a node as it is computed on device (see GvKernel_InvalidateNodes) :
+ * from the localization info of its node tile in the page table, and its offset in the node tile.
+ * The node tile of a node of depth L > 0 has the code of the parent node and the depth L,
+ * the root node tile has the code 0 and the depth 0.
+ *
+ * @param pLevel level of resolution
+ * @param pPosition position of the node in the node grid of the level
+ *
+ * @return the Morton key
+ ******************************************************************************/
+static GvMortonCode::ValueType getDeviceKey( unsigned int pLevel, const uint3& pPosition )
+{
+	typedef GvTimeSeries::NodeTileResolution NodeTileRes;
+
+	GvLocalizationCode nodeTileCode;
+	nodeTileCode.set( make_uint3( pPosition.x >> NodeTileRes::xLog2, pPosition.y >> NodeTileRes::yLog2, pPosition.z >> NodeTileRes::zLog2 ) );
+	GvLocalizationDepth nodeTileDepth;
+	nodeTileDepth.set( pLevel );
+	const uint3 nodeOffset = make_uint3( pPosition.x & ( NodeTileRes::x - 1 ), pPosition.y & ( NodeTileRes::y - 1 ), pPosition.z & ( NodeTileRes::z - 1 ) );
+
+	return GvMortonCode::encodeNode< NodeTileRes >( nodeTileCode.addLevel< NodeTileRes >( nodeOffset ), nodeTileDepth );
+}
+
+/******************************************************************************
+ * Build the levels of a time step : every node has a brick, whose index is the node index
+ *
+ * @param pStep the time step
+ * @param pLevels the levels
+ ******************************************************************************/
+static void getLevels( unsigned int pStep, std::vector< GvTimeSeries::Level >& pLevels )
+{
+	pLevels.resize( cNbLevels );
+	for ( unsigned int level = 0; level < cNbLevels; level++ )
+	{
+		const unsigned int nbNodes = 1 << ( 3 * level );
+		pLevels[ level ]._nodes.resize( nbNodes );
+		pLevels[ level ]._bricks.assign( 1, std::vector< unsigned char >( nbNodes * cBrickSize ) );
+		for ( unsigned int i = 0; i < nbNodes; i++ )
+		{
+			pLevels[ level ]._nodes[ i ] = cBrickFlag | i;
+			memset( &pLevels[ level ]._bricks[ 0 ][ i * cBrickSize ], static_cast< int >( ( level * 31 + i ) & 0x7F ), cBrickSize );
+		}
+	}
+
+	// Changed bricks
+	for ( unsigned int k = 0; pStep > 0 && k < cNbChangedNodes; k++ )
+	{
+		const unsigned int level = cChangedNodes[ k ][ 0 ];
+		const unsigned int i = cChangedNodes[ k ][ 1 ];
+		pLevels[ level ]._bricks[ 0 ][ i * cBrickSize + k ] = 0xFF;
+	}
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvTimeSeriesTest::GvTimeSeriesTest()
+:	GvTestCase( "TimeSeries" )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvTimeSeriesTest::~GvTimeSeriesTest()
+{
+}
+
+/******************************************************************************
+ * Run the test
+ ******************************************************************************/
+void GvTimeSeriesTest::run()
+{
+	typedef GvTimeSeries::NodeTileResolution NodeTileRes;
+
+	const std::string fileName = getFilePath( "GvTimeSeriesTest.gvts" );
+
+	// Write two time steps
+	std::vector< GvDataContainer::Channel > channels( 1 );
+	channels[ 0 ]._name = "density";
+	channels[ 0 ]._typeName = GvDataTypeHandler::getTypeName( GvDataTypeHandler::gvUCHAR );
+	GvTimeSeriesWriter writer;
+	GV_CHECK( writer.open( fileName, cBrickResolution, cBorderSize, cNbLevels, channels, 10 ) );
+	std::vector< GvTimeSeries::Level > levels;
+	getLevels( 0, levels );
+	GV_CHECK( writer.writeStep( levels ) );
+	getLevels( 1, levels );
+	GV_CHECK( writer.writeStep( levels ) );
+	GV_CHECK( writer.getNbChangedNodes() == cNbChangedNodes );
+	GV_CHECK( writer.close() );
+
+	// Move to the second time step
+	GvTimeSeries timeSeries;
+	GV_CHECK( timeSeries.open( fileName, 1 ) );
+	GV_CHECK( timeSeries.getNbLevels() == cNbLevels );
+	std::vector< GvMortonCode::ValueType > changedNodes;
+	GV_CHECK( timeSeries.setStep( 1, changedNodes ) );
+	GV_CHECK( changedNodes.size() == cNbChangedNodes );
+
+	// Keys are the ones computed on device, and they give back the region of the changed node
+	for ( unsigned int k = 0; k < cNbChangedNodes; k++ )
+	{
+		const unsigned int level = cChangedNodes[ k ][ 0 ];
+		const unsigned int nodeIndex = cChangedNodes[ k ][ 1 ];
+		const uint3 position = getNodePosition( level, nodeIndex );
+		const GvMortonCode::ValueType key = getDeviceKey( level, position );
+		GV_CHECK( key != 0 );
+		GV_CHECK( std::find( changedNodes.begin(), changedNodes.end(), key ) != changedNodes.end() );
+
+		// Localization info, as decoded by producers
+		GvLocalizationCode localizationCode;
+		GvLocalizationDepth localizationDepth;
+		GvMortonCode::decodeNode< NodeTileRes >( key, localizationCode, localizationDepth );
+		GV_CHECK( localizationDepth.get() == level );
+		GV_CHECK( localizationCode.get().x == position.x && localizationCode.get().y == position.y && localizationCode.get().z == position.z );
+
+		// Region of the node (position and size in [ 0 ; 1 ]), as producers compute it, and its node in the time series
+		const float levelResolution = static_cast< float >( 1 << localizationDepth.get() );
+		const float regionPosition[ 3 ] = { localizationCode.get().x / levelResolution, localizationCode.get().y / levelResolution, localizationCode.get().z / levelResolution };
+		const unsigned int regionLevelResolution = static_cast< unsigned int >( levelResolution );
+		const unsigned int regionNodeIndex = static_cast< unsigned int >( regionPosition[ 0 ] * regionLevelResolution )
+			+ static_cast< unsigned int >( regionPosition[ 1 ] * regionLevelResolution ) * regionLevelResolution
+			+ static_cast< unsigned int >( regionPosition[ 2 ] * regionLevelResolution ) * regionLevelResolution * regionLevelResolution;
+		GV_CHECK( regionNodeIndex == nodeIndex );
+		const unsigned int node = timeSeries.getNode( localizationDepth.get(), regionNodeIndex );
+		GV_CHECK( node & cBrickFlag );
+		const unsigned char* brick = timeSeries.getBrick( localizationDepth.get(), 0, node & 0x3FFFFFFFU );
+		GV_CHECK( brick != NULL && brick[ k ] == 0xFF );
+	}
+
+	// Nodes at the same position of different levels have different keys
+	GV_CHECK( getDeviceKey( 0, make_uint3( 0, 0, 0 ) ) != getDeviceKey( 1, make_uint3( 0, 0, 0 ) ) );
+
+	// Moving back to the keyframe gives the same nodes
+	std::vector< GvMortonCode::ValueType > restoredNodes;
+	GV_CHECK( timeSeries.setStep( 0, restoredNodes ) );
+	std::sort( changedNodes.begin(), changedNodes.end() );
+	std::sort( restoredNodes.begin(), restoredNodes.end() );
+	GV_CHECK( restoredNodes == changedNodes );
+
+	timeSeries.close();
+	remove( fileName.c_str() );
+}
@@ -0,0 +1,166 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2013 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * GigaVoxels is distributed under a dual-license scheme.
+ * You can obtain a specific license from Inria at gigavoxels-licensing@inria.fr.
+ * Otherwise the default license is the GPL version 3.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvTestCase.h"
+#include "GvReplayBenchmarkTest.h"
+#include "GvMetricsServerTest.h"
+#include "GvPoolRebalancerTest.h"
+#include "GvPoolRemapperTest.h"
+#include "GvTileMergerTest.h"
+#include "GvRequestSelectorTest.h"
+#include "GvTimeSeriesTest.h"
+#include "GvNormalGeneratorTest.h"
+#include "GvSpatialHashTest.h"
+
+// STL
+#include <iostream>
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Print command line usage
+ *
+ * @param pProgramName name of the program
+ ******************************************************************************/
+static void printUsage( const char* pProgramName )
+{
+	std::cout << "Usage : " << pProgramName << " [options]" << std::endl;
+	std::cout << "  --dir <directory>      directory of temporary files (default : .)" << std::endl;
+	std::cout << "  --filter <text>        only run tests whose name contains text" << std::endl;
+}
+
+/******************************************************************************
+ * Main entry program
+ *
+ * @param pArgc number of arguments
+ * @param pArgv list of arguments
+ *
+ * @return exit code (0 if all tests succeed)
+ ******************************************************************************/
+int main( int pArgc, char* pArgv[] )
+{
+	std::string workingDirectory = ".";
+	std::string filter;
+
+	// Parse command line
+	for ( int i = 1; i < pArgc; i++ )
+	{
+		const std::string argument = pArgv[ i ];
+		const bool hasValue = ( i + 1 < pArgc );
+
+		if ( argument == "--help" || argument == "-h" )
+		{
+			printUsage( pArgv[ 0 ] );
+
+			return 0;
+		}
+		else if ( argument == "--dir" && hasValue )
+		{
+			workingDirectory = pArgv[ ++i ];
+		}
+		else if ( argument == "--filter" && hasValue )
+		{
+			filter = pArgv[ ++i ];
+		}
+		else
+		{
+			std::cerr << "Unknown option : " << argument << std::endl;
+			printUsage( pArgv[ 0 ] );
+
+			return 1;
+		}
+	}
+
+	// Register tests
+	std::vector< GvTestCase* > tests;
+	tests.push_back( new GvReplayBenchmarkTest() );
+	tests.push_back( new GvMetricsServerTest() );
+	tests.push_back( new GvPoolRebalancerTest() );
+	tests.push_back( new GvPoolRemapperTest() );
+	tests.push_back( new GvTileMergerTest() );
+	tests.push_back( new GvRequestSelectorTest() );
+	tests.push_back( new GvTimeSeriesTest() );
+	tests.push_back( new GvNormalGeneratorTest() );
+	tests.push_back( new GvSpatialHashTest() );
+
+	// Run tests
+	unsigned int nbFailedTests = 0;
+	unsigned int nbRunTests = 0;
+	for ( size_t i = 0; i < tests.size(); i++ )
+	{
+		GvTestCase* test = tests[ i ];
+		if ( filter.empty() || test->getName().find( filter ) != std::string::npos )
+		{
+			nbRunTests++;
+
+			bool result = test->setUp( workingDirectory );
+			if ( result )
+			{
+				test->run();
+				test->tearDown();
+				result = ( test->getNbFailures() == 0 );
+			}
+			if ( ! result )
+			{
+				nbFailedTests++;
+			}
+
+			std::cout << ( result ? "[ OK ] " : "[FAIL] " ) << test->getName()
+				<< " : " << ( test->getNbChecks() - test->getNbFailures() ) << "/" << test->getNbChecks() << " checks" << std::endl;
+		}
+
+		delete test;
+	}
+
+	std::cout << ( nbRunTests - nbFailedTests ) << "/" << nbRunTests << " tests succeeded" << std::endl;
+
+	return ( nbFailedTests == 0 ) ? 0 : 1;
+}
@@ -34,6 +34,13 @@
 //#include <GL/glew.h>
 #include <GL/freeglut.h>
 
+// GigaVoxels
+#include <GvPerfMon/GvMetricsServer.h>
+
+// STL
+#include <cstdlib>
+#include <cstring>
+
 /******************************************************************************
  ****************************** NAMESPACE SECTION *****************************
  ******************************************************************************/
@@ -63,6 +70,16 @@ int main( int pArgc, char** pArgv )
 	// GLUT initialization
 	glutInit( &pArgc, pArgv );
 
+	// Optional local metrics endpoint : "--metrics-port <port>"
+	GvPerfMon::GvMetricsServer metricsServer;
+	for ( int i = 1; i + 1 < pArgc; i++ )
+	{
+		if ( strcmp( pArgv[ i ], "--metrics-port" ) == 0 )
+		{
+			metricsServer.start( static_cast< unsigned short >( atoi( pArgv[ i + 1 ] ) ) );
+		}
+	}
+
 	// Qt main application
 	GvViewerGui::GvvApplication::initialize( pArgc, pArgv );
 
@@ -0,0 +1,393 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GVV_CAMERA_PATH_H_
+#define _GVV_CAMERA_PATH_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GvViewer
+#include "GvvCoreConfig.h"
+
+// STL
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+// GvViewer
+namespace GvViewerCore
+{
+	class GvvPipelineInterface;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvViewerCore
+{
+
+/** 
+ * @class GvvCameraPath
+ *
+ * @brief The GvvCameraPath class provides a timestamped list of camera keyframes
+ * and the pipeline settings in use when the path has been recorded.
+ *
+ * Camera paths are used to replay exactly the same fly-through on different builds
+ * or settings (see GvvReplayBenchmark). Keyframes are sorted by time and the camera
+ * at any time is interpolated (linear position, spherical orientation).
+ *
+ * Paths are saved in a text file :
+ * - a header line "GvViewer camera path 1",
+ * - one "setting <name> <values>" line per pipeline setting,
+ * - one "keyframe <time> <position> <orientation> <fov> <aspect> <zNear> <zFar>" line per keyframe.
+ */
+class GVVIEWERCORE_EXPORT GvvCameraPath
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* INNER TYPES *******************************/
+
+	/**
+	 * Camera keyframe
+	 *
+	 * Orientation is the rotation from the camera frame to the world frame
+	 * (the camera looks along its -Z axis, as in OpenGL and QGLViewer).
+	 */
+	struct KeyFrame
+	{
+		/**
+		 * Time (in seconds, from the beginning of the path)
+		 */
+		float _time;
+
+		/**
+		 * Camera position (world coordinates)
+		 */
+		float _position[ 3 ];
+
+		/**
+		 * Camera orientation as a unit quaternion (x, y, z, w)
+		 */
+		float _orientation[ 4 ];
+
+		/**
+		 * Vertical field of view (in radians)
+		 */
+		float _fieldOfView;
+
+		/**
+		 * Aspect ratio (width / height)
+		 */
+		float _aspectRatio;
+
+		/**
+		 * Near clipping plane distance
+		 */
+		float _zNear;
+
+		/**
+		 * Far clipping plane distance
+		 */
+		float _zFar;
+	};
+
+	/**
+	 * Pipeline settings that have an impact on data production and rendering
+	 */
+	struct PipelineSettings
+	{
+		/**
+		 * Max depth of the renderer
+		 */
+		unsigned int _rendererMaxDepth;
+
+		/**
+		 * Max number of node subdivision requests per frame
+		 */
+		unsigned int _cacheMaxNbNodeSubdivisions;
+
+		/**
+		 * Max number of brick load requests per frame
+		 */
+		unsigned int _cacheMaxNbBrickLoads;
+
+		/**
+		 * Request strategy (priority on bricks or on node subdivisions)
+		 */
+		bool _rendererPriorityOnBricks;
+
+		/**
+		 * Cache policy
+		 */
+		unsigned int _cachePolicy;
+
+		/**
+		 * Dynamic update state
+		 */
+		bool _dynamicUpdate;
+
+		/**
+		 * Image downscaling state
+		 */
+		bool _imageDownscaling;
+
+		/**
+		 * Internal graphics buffer size
+		 */
+		unsigned int _viewportSize[ 2 ];
+
+		/**
+		 * Graphics buffer size used when image downscaling is activated
+		 */
+		unsigned int _graphicsBufferSize[ 2 ];
+
+		/**
+		 * Production time limit state
+		 */
+		bool _productionTimeLimited;
+
+		/**
+		 * Production time limit (in ms)
+		 */
+		float _productionTimeLimit;
+
+		/**
+		 * Request priority ordering state
+		 */
+		bool _requestPriorities;
+
+		/**
+		 * Rendering time budget state
+		 */
+		bool _renderingTimeBudgetActivated;
+
+		/**
+		 * Rendering time budget
+		 */
+		unsigned int _renderingTimeBudget;
+
+		/**
+		 * Translation of the GigaVoxels object
+		 */
+		float _translation[ 3 ];
+
+		/**
+		 * Rotation of the GigaVoxels object (angle in degree, then axis)
+		 */
+		float _rotation[ 4 ];
+
+		/**
+		 * Uniform scale of the GigaVoxels object
+		 */
+		float _scale;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvvCameraPath();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvvCameraPath();
+
+	/**
+	 * Remove all keyframes
+	 */
+	void clear();
+
+	/**
+	 * Add a keyframe.
+	 * Keyframes must be added by increasing time.
+	 *
+	 * @param pKeyFrame the keyframe
+	 *
+	 * @return false if the keyframe is older than the last one
+	 */
+	bool addKeyFrame( const KeyFrame& pKeyFrame );
+
+	/**
+	 * Get the number of keyframes
+	 *
+	 * @return the number of keyframes
+	 */
+	unsigned int getNbKeyFrames() const;
+
+	/**
+	 * Get a keyframe
+	 *
+	 * @param pIndex index of the keyframe
+	 *
+	 * @return the keyframe
+	 */
+	const KeyFrame& getKeyFrame( unsigned int pIndex ) const;
+
+	/**
+	 * Get the duration of the path (time of the last keyframe)
+	 *
+	 * @return the duration (in seconds)
+	 */
+	float getDuration() const;
+
+	/**
+	 * Interpolate the camera at a given time.
+	 * Time is clamped to the path duration.
+	 *
+	 * @param pTime the time (in seconds)
+	 * @param pKeyFrame the interpolated camera
+	 *
+	 * @return false if the path is empty
+	 */
+	bool interpolate( float pTime, KeyFrame& pKeyFrame ) const;
+
+	/**
+	 * Tell whether or not pipeline settings have been stored with the path
+	 *
+	 * @return a flag telling whether or not pipeline settings are available
+	 */
+	bool hasPipelineSettings() const;
+
+	/**
+	 * Get the pipeline settings
+	 *
+	 * @return the pipeline settings
+	 */
+	const PipelineSettings& getPipelineSettings() const;
+
+	/**
+	 * Set the pipeline settings
+	 *
+	 * @param pSettings the pipeline settings
+	 */
+	void setPipelineSettings( const PipelineSettings& pSettings );
+
+	/**
+	 * Store the current settings of a pipeline
+	 *
+	 * @param pPipeline the pipeline
+	 */
+	void capturePipelineSettings( const GvvPipelineInterface& pPipeline );
+
+	/**
+	 * Apply the stored settings to a pipeline (if any)
+	 *
+	 * @param pPipeline the pipeline
+	 */
+	void applyPipelineSettings( GvvPipelineInterface& pPipeline ) const;
+
+	/**
+	 * Save the path to a file
+	 *
+	 * @param pFilename the file name
+	 *
+	 * @return a flag telling whether or not it succeeds
+	 */
+	bool save( const std::string& pFilename ) const;
+
+	/**
+	 * Load a path from a file
+	 *
+	 * @param pFilename the file name
+	 *
+	 * @return a flag telling whether or not it succeeds
+	 */
+	bool load( const std::string& pFilename );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Keyframes (sorted by time)
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< KeyFrame > _keyFrames;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Pipeline settings
+	 */
+	PipelineSettings _pipelineSettings;
+
+	/**
+	 * Flag telling whether or not pipeline settings are available
+	 */
+	bool _hasPipelineSettings;
+
+	/******************************** METHODS *********************************/
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+};
+
+} // namespace GvViewerCore
+
+#endif // !_GVV_CAMERA_PATH_H_
@@ -0,0 +1,207 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GVV_CAMERA_PATH_RECORDER_H_
+#define _GVV_CAMERA_PATH_RECORDER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GvViewer
+#include "GvvCoreConfig.h"
+#include "GvvCameraPath.h"
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+// GvViewer
+namespace GvViewerCore
+{
+	class GvvPipelineInterface;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvViewerCore
+{
+
+/** 
+ * @class GvvCameraPathRecorder
+ *
+ * @brief The GvvCameraPathRecorder class records a camera path
+ * while the user navigates in a scene.
+ *
+ * The pipeline settings are captured when the recording starts.
+ * Then, the viewer gives the camera at each frame with its own clock,
+ * and keyframe times are stored relatively to the first recorded frame.
+ */
+class GVVIEWERCORE_EXPORT GvvCameraPathRecorder
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvvCameraPathRecorder();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvvCameraPathRecorder();
+
+	/**
+	 * Start a new recording.
+	 * The previous path is discarded.
+	 *
+	 * @param pPipeline the pipeline whose settings are stored with the path (can be NULL)
+	 */
+	void start( const GvvPipelineInterface* pPipeline );
+
+	/**
+	 * Stop the recording
+	 */
+	void stop();
+
+	/**
+	 * Tell whether or not a recording is in progress
+	 *
+	 * @return a flag telling whether or not a recording is in progress
+	 */
+	bool isRecording() const;
+
+	/**
+	 * Record the camera of the current frame.
+	 * The time of the keyframe is ignored and replaced by the given time.
+	 *
+	 * @param pTime the current time (in seconds, any origin)
+	 * @param pCamera the camera
+	 *
+	 * @return a flag telling whether or not a keyframe has been added
+	 */
+	bool record( double pTime, const GvvCameraPath::KeyFrame& pCamera );
+
+	/**
+	 * Get the min time between two keyframes
+	 *
+	 * @return the min time between two keyframes (in seconds)
+	 */
+	float getMinInterval() const;
+
+	/**
+	 * Set the min time between two keyframes.
+	 * With 0, every frame is recorded.
+	 *
+	 * @param pValue the min time between two keyframes (in seconds)
+	 */
+	void setMinInterval( float pValue );
+
+	/**
+	 * Get the recorded path
+	 *
+	 * @return the recorded path
+	 */
+	const GvvCameraPath& getCameraPath() const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Recorded path
+	 */
+	GvvCameraPath _cameraPath;
+
+	/**
+	 * Flag telling whether or not a recording is in progress
+	 */
+	bool _isRecording;
+
+	/**
+	 * Time of the first recorded frame
+	 */
+	double _startTime;
+
+	/**
+	 * Min time between two keyframes (in seconds)
+	 */
+	float _minInterval;
+
+	/******************************** METHODS *********************************/
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvvCameraPathRecorder( const GvvCameraPathRecorder& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvvCameraPathRecorder& operator=( const GvvCameraPathRecorder& );
+
+};
+
+} // namespace GvViewerCore
+
+#endif // !_GVV_CAMERA_PATH_RECORDER_H_
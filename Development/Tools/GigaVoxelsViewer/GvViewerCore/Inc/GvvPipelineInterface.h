@@ -524,6 +524,16 @@ public:
 	 */
 	virtual void setBrickCacheMemory( unsigned int pValue );
 
+	/**
+	 * Set the node and brick cache memory at once.
+	 * Pipelines that reallocate their pools should override it to do it only once,
+	 * the default implementation calls setNodeCacheMemory() and setBrickCacheMemory().
+	 *
+	 * @param pNodeValue the node cache memory
+	 * @param pBrickValue the brick cache memory
+	 */
+	virtual void setCacheMemory( unsigned int pNodeValue, unsigned int pBrickValue );
+
 	/**
 	 * Get the node cache capacity
 	 *
@@ -566,6 +576,20 @@ public:
 	 */
 	virtual unsigned int getCacheNbUnusedBricks() const;
 
+	/**
+	 * Tell wheter or not the nodes cache has exceeded its capacity during last frame
+	 *
+	 * @return a flag telling wheter or not the nodes cache has exceeded its capacity
+	 */
+	virtual bool hasNodeCacheExceededCapacity() const;
+
+	/**
+	 * Tell wheter or not the bricks cache has exceeded its capacity during last frame
+	 *
+	 * @return a flag telling wheter or not the bricks cache has exceeded its capacity
+	 */
+	virtual bool hasBrickCacheExceededCapacity() const;
+
 	/**
 	 * Get the nodes cache usage
 	 *
@@ -868,6 +892,21 @@ public:
 	 * @return the time limit.	
 	 */
 	virtual float getProductionTimeLimit() const;
+
+	/**
+	 * Set or unset the flag used to tell whether or not production requests
+	 * are ordered by priority (screen-space error) when they exceed the budget.
+	 *
+	 * @param pFlag the flag value.
+	 */
+	virtual void useRequestPriorities( bool pFlag );
+
+	/**
+	 * Get the flag telling whether or not production requests are ordered by priority.
+	 *
+	 * @return the flag telling whether or not production requests are ordered by priority.
+	 */
+	virtual bool hasRequestPriorities() const;
 				
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
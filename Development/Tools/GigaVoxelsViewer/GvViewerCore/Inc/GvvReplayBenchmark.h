@@ -0,0 +1,374 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GVV_REPLAY_BENCHMARK_H_
+#define _GVV_REPLAY_BENCHMARK_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GvViewer
+#include "GvvCoreConfig.h"
+#include "GvvCameraPath.h"
+
+// STL
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+// GvViewer
+namespace GvViewerCore
+{
+	class GvvPipelineInterface;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace GvViewerCore
+{
+
+/** 
+ * @class GvvReplayBenchmark
+ *
+ * @brief The GvvReplayBenchmark class replays a camera path on a pipeline
+ * at fixed timesteps and collects per-frame counters.
+ *
+ * The replay is deterministic : the camera of frame i is the camera of the path
+ * at time i x timestep, whatever the real duration of the frames. Pipeline settings
+ * stored with the path are applied and the cache is cleared before the first frame,
+ * so two replays of the same path on the same data issue the same requests.
+ *
+ * Per-frame counters are summarized with min, mean, max and p50/p95/p99 percentiles.
+ *
+ * The driver only uses the GvvPipelineInterface API, so it can run on any pipeline,
+ * including one that only implements a subset of the interface (e.g. a mock pipeline,
+ * with loading of OpenGL matrices disabled if there is no OpenGL context).
+ */
+class GVVIEWERCORE_EXPORT GvvReplayBenchmark
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* INNER TYPES *******************************/
+
+	/**
+	 * Per-frame metrics
+	 */
+	enum EMetric
+	{
+		eRendererElapsedTime = 0,
+		eNodeSubdivisionRequests,
+		eBrickLoadRequests,
+		eNodeCacheUsage,
+		eBrickCacheUsage,
+		eNbTreeNodes,
+		eNbTreeLeafNodes,
+		eNbMetrics
+	};
+
+	/**
+	 * Statistics of a metric over all frames
+	 */
+	struct Statistics
+	{
+		/**
+		 * Min value
+		 */
+		float _min;
+
+		/**
+		 * Mean value
+		 */
+		float _mean;
+
+		/**
+		 * Max value
+		 */
+		float _max;
+
+		/**
+		 * 50th percentile (median)
+		 */
+		float _p50;
+
+		/**
+		 * 95th percentile
+		 */
+		float _p95;
+
+		/**
+		 * 99th percentile
+		 */
+		float _p99;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvvReplayBenchmark();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvvReplayBenchmark();
+
+	/**
+	 * Get the name of a metric
+	 *
+	 * @param pMetric the metric
+	 *
+	 * @return the name of the metric
+	 */
+	static const char* getMetricName( EMetric pMetric );
+
+	/**
+	 * Get the timestep between two frames
+	 *
+	 * @return the timestep (in seconds)
+	 */
+	float getTimeStep() const;
+
+	/**
+	 * Set the timestep between two frames
+	 *
+	 * @param pValue the timestep (in seconds)
+	 */
+	void setTimeStep( float pValue );
+
+	/**
+	 * Get the number of frames replayed before counters are collected
+	 *
+	 * @return the number of warm-up frames
+	 */
+	unsigned int getNbWarmupFrames() const;
+
+	/**
+	 * Set the number of frames replayed before counters are collected.
+	 * Warm-up frames render the first camera of the path.
+	 *
+	 * @param pValue the number of warm-up frames
+	 */
+	void setNbWarmupFrames( unsigned int pValue );
+
+	/**
+	 * Tell whether or not cameras are also loaded in the OpenGL fixed pipeline matrices
+	 *
+	 * @return the flag telling whether or not OpenGL matrices are loaded
+	 */
+	bool hasGLMatrices() const;
+
+	/**
+	 * Set the flag telling whether or not cameras are also loaded in the OpenGL
+	 * fixed pipeline matrices (pipelines read their camera from OpenGL).
+	 * It requires a current OpenGL context.
+	 *
+	 * @param pFlag the flag telling whether or not OpenGL matrices are loaded
+	 */
+	void setGLMatrices( bool pFlag );
+
+	/**
+	 * Replay a camera path on a pipeline.
+	 * Previous results are discarded.
+	 *
+	 * @param pPipeline the pipeline
+	 * @param pCameraPath the camera path
+	 *
+	 * @return the number of frames that have been collected
+	 */
+	unsigned int run( GvvPipelineInterface& pPipeline, const GvvCameraPath& pCameraPath );
+
+	/**
+	 * Get the number of collected frames
+	 *
+	 * @return the number of collected frames
+	 */
+	unsigned int getNbFrames() const;
+
+	/**
+	 * Get the value of a metric for a given frame
+	 *
+	 * @param pFrame the frame
+	 * @param pMetric the metric
+	 *
+	 * @return the value
+	 */
+	float getValue( unsigned int pFrame, EMetric pMetric ) const;
+
+	/**
+	 * Compute the statistics of a metric over all collected frames
+	 *
+	 * @param pMetric the metric
+	 *
+	 * @return the statistics
+	 */
+	Statistics getStatistics( EMetric pMetric ) const;
+
+	/**
+	 * Get the convergence frame, i.e. the first collected frame from which
+	 * no more node subdivision nor brick load requests are emitted.
+	 * It is used to compare request orderings (time to a stable image).
+	 *
+	 * @return the convergence frame (the number of frames if the replay never converges)
+	 */
+	unsigned int getConvergenceFrame() const;
+
+	/**
+	 * Write the statistics of all metrics in a JSON file
+	 *
+	 * @param pFilename the file name
+	 * @param pTag a user tag used to identify the run (build, settings...)
+	 *
+	 * @return a flag telling whether or not it succeeds
+	 */
+	bool writeReport( const std::string& pFilename, const std::string& pTag ) const;
+
+	/**
+	 * Write the per-frame values of all metrics in a CSV file
+	 *
+	 * @param pFilename the file name
+	 *
+	 * @return a flag telling whether or not it succeeds
+	 */
+	bool writeFrames( const std::string& pFilename ) const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Timestep between two frames (in seconds)
+	 */
+	float _timeStep;
+
+	/**
+	 * Number of warm-up frames
+	 */
+	unsigned int _nbWarmupFrames;
+
+	/**
+	 * Flag telling whether or not cameras are loaded in OpenGL matrices
+	 */
+	bool _hasGLMatrices;
+
+	/**
+	 * Per-frame values (eNbMetrics values per frame)
+	 */
+#if defined _MSC_VER
+#pragma warning( push )
+#pragma warning( disable:4251 )
+#endif
+	std::vector< float > _values;
+#if defined _MSC_VER
+#pragma warning( pop )
+#endif
+
+	/**
+	 * Duration of the replayed path (in seconds)
+	 */
+	float _duration;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Set the camera of the pipeline.
+	 * Default implementation writes the ModelView and Projection matrices
+	 * of the pipeline and, if activated, the OpenGL ones.
+	 *
+	 * @param pPipeline the pipeline
+	 * @param pCamera the camera
+	 */
+	virtual void setCamera( GvvPipelineInterface& pPipeline, const GvvCameraPath::KeyFrame& pCamera );
+
+	/**
+	 * Render one frame.
+	 * Default implementation calls the draw() method of the pipeline.
+	 *
+	 * @param pPipeline the pipeline
+	 */
+	virtual void drawFrame( GvvPipelineInterface& pPipeline );
+
+	/**
+	 * Collect the counters of the last rendered frame
+	 *
+	 * @param pPipeline the pipeline
+	 */
+	void collectFrame( const GvvPipelineInterface& pPipeline );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvvReplayBenchmark( const GvvReplayBenchmark& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvvReplayBenchmark& operator=( const GvvReplayBenchmark& );
+
+};
+
+} // namespace GvViewerCore
+
+#endif // !_GVV_REPLAY_BENCHMARK_H_
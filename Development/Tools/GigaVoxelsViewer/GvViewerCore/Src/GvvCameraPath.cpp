@@ -0,0 +1,549 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvvCameraPath.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GvViewer
+#include "GvvPipelineInterface.h"
+
+// glm
+#include <glm/gtc/quaternion.hpp>
+
+// STL
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+// System
+#include <cassert>
+#include <cstring>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GvViewer
+using namespace GvViewerCore;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Header of camera path files
+ */
+static const char* cCameraPathHeader = "GvViewer camera path 1";
+
+/**
+ * Number of mandatory pipeline settings written in camera path files
+ * (requestPriorities is optional : files written before it was added don't have it)
+ */
+static const unsigned int cNbPipelineSettings = 16;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/**
+ * Comparison of a time and a keyframe (used to search keyframes)
+ */
+static bool compareTime( float pTime, const GvvCameraPath::KeyFrame& pKeyFrame )
+{
+	return pTime < pKeyFrame._time;
+}
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvvCameraPath::GvvCameraPath()
+:	_keyFrames()
+,	_pipelineSettings()
+,	_hasPipelineSettings( false )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvvCameraPath::~GvvCameraPath()
+{
+}
+
+/******************************************************************************
+ * Remove all keyframes
+ ******************************************************************************/
+void GvvCameraPath::clear()
+{
+	_keyFrames.clear();
+	_hasPipelineSettings = false;
+}
+
+/******************************************************************************
+ * Add a keyframe.
+ * Keyframes must be added by increasing time.
+ *
+ * @param pKeyFrame the keyframe
+ *
+ * @return false if the keyframe is older than the last one
+ ******************************************************************************/
+bool GvvCameraPath::addKeyFrame( const KeyFrame& pKeyFrame )
+{
+	if ( ! _keyFrames.empty() && pKeyFrame._time < _keyFrames.back()._time )
+	{
+		return false;
+	}
+
+	_keyFrames.push_back( pKeyFrame );
+
+	return true;
+}
+
+/******************************************************************************
+ * Get the number of keyframes
+ *
+ * @return the number of keyframes
+ ******************************************************************************/
+unsigned int GvvCameraPath::getNbKeyFrames() const
+{
+	return static_cast< unsigned int >( _keyFrames.size() );
+}
+
+/******************************************************************************
+ * Get a keyframe
+ *
+ * @param pIndex index of the keyframe
+ *
+ * @return the keyframe
+ ******************************************************************************/
+const GvvCameraPath::KeyFrame& GvvCameraPath::getKeyFrame( unsigned int pIndex ) const
+{
+	assert( pIndex < _keyFrames.size() );
+
+	return _keyFrames[ pIndex ];
+}
+
+/******************************************************************************
+ * Get the duration of the path (time of the last keyframe)
+ *
+ * @return the duration (in seconds)
+ ******************************************************************************/
+float GvvCameraPath::getDuration() const
+{
+	return _keyFrames.empty() ? 0.f : _keyFrames.back()._time;
+}
+
+/******************************************************************************
+ * Interpolate the camera at a given time.
+ * Time is clamped to the path duration.
+ *
+ * @param pTime the time (in seconds)
+ * @param pKeyFrame the interpolated camera
+ *
+ * @return false if the path is empty
+ ******************************************************************************/
+bool GvvCameraPath::interpolate( float pTime, KeyFrame& pKeyFrame ) const
+{
+	if ( _keyFrames.empty() )
+	{
+		return false;
+	}
+
+	// Find the first keyframe after the given time
+	vector< KeyFrame >::const_iterator next = upper_bound( _keyFrames.begin(), _keyFrames.end(), pTime, compareTime );
+	if ( next == _keyFrames.begin() )
+	{
+		pKeyFrame = _keyFrames.front();
+		pKeyFrame._time = pTime;
+
+		return true;
+	}
+	if ( next == _keyFrames.end() )
+	{
+		pKeyFrame = _keyFrames.back();
+		pKeyFrame._time = pTime;
+
+		return true;
+	}
+	const KeyFrame& previous = *( next - 1 );
+
+	// Interpolation factor
+	const float duration = next->_time - previous._time;
+	const float t = ( duration > 0.f ) ? ( pTime - previous._time ) / duration : 0.f;
+
+	pKeyFrame._time = pTime;
+	for ( unsigned int i = 0; i < 3; i++ )
+	{
+		pKeyFrame._position[ i ] = previous._position[ i ] + t * ( next->_position[ i ] - previous._position[ i ] );
+	}
+	pKeyFrame._fieldOfView = previous._fieldOfView + t * ( next->_fieldOfView - previous._fieldOfView );
+	pKeyFrame._aspectRatio = previous._aspectRatio + t * ( next->_aspectRatio - previous._aspectRatio );
+	pKeyFrame._zNear = previous._zNear + t * ( next->_zNear - previous._zNear );
+	pKeyFrame._zFar = previous._zFar + t * ( next->_zFar - previous._zFar );
+
+	// Spherical interpolation of the orientation (glm quaternions are stored as w, x, y, z)
+	const glm::quat q0( previous._orientation[ 3 ], previous._orientation[ 0 ], previous._orientation[ 1 ], previous._orientation[ 2 ] );
+	glm::quat q1( next->_orientation[ 3 ], next->_orientation[ 0 ], next->_orientation[ 1 ], next->_orientation[ 2 ] );
+	if ( glm::dot( q0, q1 ) < 0.f )
+	{
+		// Shortest path
+		q1 = -q1;
+	}
+	const glm::quat q = glm::normalize( glm::slerp( q0, q1, t ) );
+	pKeyFrame._orientation[ 0 ] = q.x;
+	pKeyFrame._orientation[ 1 ] = q.y;
+	pKeyFrame._orientation[ 2 ] = q.z;
+	pKeyFrame._orientation[ 3 ] = q.w;
+
+	return true;
+}
+
+/******************************************************************************
+ * Tell whether or not pipeline settings have been stored with the path
+ *
+ * @return a flag telling whether or not pipeline settings are available
+ ******************************************************************************/
+bool GvvCameraPath::hasPipelineSettings() const
+{
+	return _hasPipelineSettings;
+}
+
+/******************************************************************************
+ * Get the pipeline settings
+ *
+ * @return the pipeline settings
+ ******************************************************************************/
+const GvvCameraPath::PipelineSettings& GvvCameraPath::getPipelineSettings() const
+{
+	return _pipelineSettings;
+}
+
+/******************************************************************************
+ * Set the pipeline settings
+ *
+ * @param pSettings the pipeline settings
+ ******************************************************************************/
+void GvvCameraPath::setPipelineSettings( const PipelineSettings& pSettings )
+{
+	_pipelineSettings = pSettings;
+	_hasPipelineSettings = true;
+}
+
+/******************************************************************************
+ * Store the current settings of a pipeline
+ *
+ * @param pPipeline the pipeline
+ ******************************************************************************/
+void GvvCameraPath::capturePipelineSettings( const GvvPipelineInterface& pPipeline )
+{
+	PipelineSettings& settings = _pipelineSettings;
+
+	settings._rendererMaxDepth = pPipeline.getRendererMaxDepth();
+	settings._cacheMaxNbNodeSubdivisions = pPipeline.getCacheMaxNbNodeSubdivisions();
+	settings._cacheMaxNbBrickLoads = pPipeline.getCacheMaxNbBrickLoads();
+	settings._rendererPriorityOnBricks = pPipeline.hasRendererPriorityOnBricks();
+	settings._cachePolicy = pPipeline.getCachePolicy();
+	settings._dynamicUpdate = pPipeline.hasDynamicUpdate();
+	settings._imageDownscaling = pPipeline.hasImageDownscaling();
+	pPipeline.getViewportSize( settings._viewportSize[ 0 ], settings._viewportSize[ 1 ] );
+	pPipeline.getGraphicsBufferSize( settings._graphicsBufferSize[ 0 ], settings._graphicsBufferSize[ 1 ] );
+	settings._productionTimeLimited = pPipeline.isProductionTimeLimited();
+	settings._productionTimeLimit = pPipeline.getProductionTimeLimit();
+	settings._requestPriorities = pPipeline.hasRequestPriorities();
+	settings._renderingTimeBudgetActivated = pPipeline.hasRenderingTimeBudget();
+	settings._renderingTimeBudget = pPipeline.getRenderingTimeBudget();
+	pPipeline.getTranslation( settings._translation[ 0 ], settings._translation[ 1 ], settings._translation[ 2 ] );
+	pPipeline.getRotation( settings._rotation[ 0 ], settings._rotation[ 1 ], settings._rotation[ 2 ], settings._rotation[ 3 ] );
+	pPipeline.getScale( settings._scale );
+
+	_hasPipelineSettings = true;
+}
+
+/******************************************************************************
+ * Apply the stored settings to a pipeline (if any)
+ *
+ * @param pPipeline the pipeline
+ ******************************************************************************/
+void GvvCameraPath::applyPipelineSettings( GvvPipelineInterface& pPipeline ) const
+{
+	if ( ! _hasPipelineSettings )
+	{
+		return;
+	}
+
+	const PipelineSettings& settings = _pipelineSettings;
+
+	pPipeline.setRendererMaxDepth( settings._rendererMaxDepth );
+	pPipeline.setCacheMaxNbNodeSubdivisions( settings._cacheMaxNbNodeSubdivisions );
+	pPipeline.setCacheMaxNbBrickLoads( settings._cacheMaxNbBrickLoads );
+	pPipeline.setRendererPriorityOnBricks( settings._rendererPriorityOnBricks );
+	pPipeline.setCachePolicy( settings._cachePolicy );
+	pPipeline.setDynamicUpdate( settings._dynamicUpdate );
+	pPipeline.setImageDownscaling( settings._imageDownscaling );
+	pPipeline.setViewportSize( settings._viewportSize[ 0 ], settings._viewportSize[ 1 ] );
+	pPipeline.setGraphicsBufferSize( settings._graphicsBufferSize[ 0 ], settings._graphicsBufferSize[ 1 ] );
+	pPipeline.useProductionTimeLimit( settings._productionTimeLimited );
+	pPipeline.setProductionTimeLimit( settings._productionTimeLimit );
+	pPipeline.useRequestPriorities( settings._requestPriorities );
+	pPipeline.setRenderingTimeBudgetActivated( settings._renderingTimeBudgetActivated );
+	pPipeline.setRenderingTimeBudget( settings._renderingTimeBudget );
+	pPipeline.setTranslation( settings._translation[ 0 ], settings._translation[ 1 ], settings._translation[ 2 ] );
+	pPipeline.setRotation( settings._rotation[ 0 ], settings._rotation[ 1 ], settings._rotation[ 2 ], settings._rotation[ 3 ] );
+	pPipeline.setScale( settings._scale );
+}
+
+/******************************************************************************
+ * Save the path to a file
+ *
+ * @param pFilename the file name
+ *
+ * @return a flag telling whether or not it succeeds
+ ******************************************************************************/
+bool GvvCameraPath::save( const std::string& pFilename ) const
+{
+	ofstream file( pFilename.c_str() );
+	if ( ! file.is_open() )
+	{
+		cerr << "GvvCameraPath::save : unable to open file " << pFilename << endl;
+
+		return false;
+	}
+
+	// Floats are written with enough digits to be read back exactly
+	file.precision( 9 );
+
+	file << cCameraPathHeader << endl;
+
+	if ( _hasPipelineSettings )
+	{
+		const PipelineSettings& settings = _pipelineSettings;
+
+		file << "setting rendererMaxDepth " << settings._rendererMaxDepth << endl;
+		file << "setting cacheMaxNbNodeSubdivisions " << settings._cacheMaxNbNodeSubdivisions << endl;
+		file << "setting cacheMaxNbBrickLoads " << settings._cacheMaxNbBrickLoads << endl;
+		file << "setting rendererPriorityOnBricks " << settings._rendererPriorityOnBricks << endl;
+		file << "setting cachePolicy " << settings._cachePolicy << endl;
+		file << "setting dynamicUpdate " << settings._dynamicUpdate << endl;
+		file << "setting imageDownscaling " << settings._imageDownscaling << endl;
+		file << "setting viewportSize " << settings._viewportSize[ 0 ] << " " << settings._viewportSize[ 1 ] << endl;
+		file << "setting graphicsBufferSize " << settings._graphicsBufferSize[ 0 ] << " " << settings._graphicsBufferSize[ 1 ] << endl;
+		file << "setting productionTimeLimited " << settings._productionTimeLimited << endl;
+		file << "setting productionTimeLimit " << settings._productionTimeLimit << endl;
+		file << "setting requestPriorities " << settings._requestPriorities << endl;
+		file << "setting renderingTimeBudgetActivated " << settings._renderingTimeBudgetActivated << endl;
+		file << "setting renderingTimeBudget " << settings._renderingTimeBudget << endl;
+		file << "setting translation " << settings._translation[ 0 ] << " " << settings._translation[ 1 ] << " " << settings._translation[ 2 ] << endl;
+		file << "setting rotation " << settings._rotation[ 0 ] << " " << settings._rotation[ 1 ] << " " << settings._rotation[ 2 ] << " " << settings._rotation[ 3 ] << endl;
+		file << "setting scale " << settings._scale << endl;
+	}
+
+	for ( size_t i = 0; i < _keyFrames.size(); i++ )
+	{
+		const KeyFrame& keyFrame = _keyFrames[ i ];
+
+		file << "keyframe " << keyFrame._time
+			<< " " << keyFrame._position[ 0 ] << " " << keyFrame._position[ 1 ] << " " << keyFrame._position[ 2 ]
+			<< " " << keyFrame._orientation[ 0 ] << " " << keyFrame._orientation[ 1 ] << " " << keyFrame._orientation[ 2 ] << " " << keyFrame._orientation[ 3 ]
+			<< " " << keyFrame._fieldOfView << " " << keyFrame._aspectRatio << " " << keyFrame._zNear << " " << keyFrame._zFar << endl;
+	}
+
+	return file.good();
+}
+
+/******************************************************************************
+ * Load a path from a file
+ *
+ * @param pFilename the file name
+ *
+ * @return a flag telling whether or not it succeeds
+ ******************************************************************************/
+bool GvvCameraPath::load( const std::string& pFilename )
+{
+	ifstream file( pFilename.c_str() );
+	if ( ! file.is_open() )
+	{
+		cerr << "GvvCameraPath::load : unable to open file " << pFilename << endl;
+
+		return false;
+	}
+
+	string line;
+	if ( ! getline( file, line ) || line.compare( 0, strlen( cCameraPathHeader ), cCameraPathHeader ) != 0 )
+	{
+		cerr << "GvvCameraPath::load : " << pFilename << " is not a camera path file" << endl;
+
+		return false;
+	}
+
+	clear();
+
+	PipelineSettings& settings = _pipelineSettings;
+	settings._requestPriorities = false;
+	unsigned int nbSettings = 0;
+	unsigned int lineNumber = 1;
+	while ( getline( file, line ) )
+	{
+		lineNumber++;
+
+		istringstream stream( line );
+		string tag;
+		if ( ! ( stream >> tag ) )
+		{
+			// Empty line
+			continue;
+		}
+
+		if ( tag == "keyframe" )
+		{
+			KeyFrame keyFrame;
+			stream >> keyFrame._time
+				>> keyFrame._position[ 0 ] >> keyFrame._position[ 1 ] >> keyFrame._position[ 2 ]
+				>> keyFrame._orientation[ 0 ] >> keyFrame._orientation[ 1 ] >> keyFrame._orientation[ 2 ] >> keyFrame._orientation[ 3 ]
+				>> keyFrame._fieldOfView >> keyFrame._aspectRatio >> keyFrame._zNear >> keyFrame._zFar;
+			if ( stream.fail() || ! addKeyFrame( keyFrame ) )
+			{
+				cerr << "GvvCameraPath::load : invalid keyframe at line " << lineNumber << " of " << pFilename << endl;
+
+				return false;
+			}
+		}
+		else if ( tag == "setting" )
+		{
+			string name;
+			stream >> name;
+			if ( name == "rendererMaxDepth" )
+			{
+				stream >> settings._rendererMaxDepth;
+			}
+			else if ( name == "cacheMaxNbNodeSubdivisions" )
+			{
+				stream >> settings._cacheMaxNbNodeSubdivisions;
+			}
+			else if ( name == "cacheMaxNbBrickLoads" )
+			{
+				stream >> settings._cacheMaxNbBrickLoads;
+			}
+			else if ( name == "rendererPriorityOnBricks" )
+			{
+				stream >> settings._rendererPriorityOnBricks;
+			}
+			else if ( name == "cachePolicy" )
+			{
+				stream >> settings._cachePolicy;
+			}
+			else if ( name == "dynamicUpdate" )
+			{
+				stream >> settings._dynamicUpdate;
+			}
+			else if ( name == "imageDownscaling" )
+			{
+				stream >> settings._imageDownscaling;
+			}
+			else if ( name == "viewportSize" )
+			{
+				stream >> settings._viewportSize[ 0 ] >> settings._viewportSize[ 1 ];
+			}
+			else if ( name == "graphicsBufferSize" )
+			{
+				stream >> settings._graphicsBufferSize[ 0 ] >> settings._graphicsBufferSize[ 1 ];
+			}
+			else if ( name == "productionTimeLimited" )
+			{
+				stream >> settings._productionTimeLimited;
+			}
+			else if ( name == "productionTimeLimit" )
+			{
+				stream >> settings._productionTimeLimit;
+			}
+			else if ( name == "requestPriorities" )
+			{
+				stream >> settings._requestPriorities;
+
+				// Optional setting, not counted
+				nbSettings--;
+			}
+			else if ( name == "renderingTimeBudgetActivated" )
+			{
+				stream >> settings._renderingTimeBudgetActivated;
+			}
+			else if ( name == "renderingTimeBudget" )
+			{
+				stream >> settings._renderingTimeBudget;
+			}
+			else if ( name == "translation" )
+			{
+				stream >> settings._translation[ 0 ] >> settings._translation[ 1 ] >> settings._translation[ 2 ];
+			}
+			else if ( name == "rotation" )
+			{
+				stream >> settings._rotation[ 0 ] >> settings._rotation[ 1 ] >> settings._rotation[ 2 ] >> settings._rotation[ 3 ];
+			}
+			else if ( name == "scale" )
+			{
+				stream >> settings._scale;
+			}
+			else
+			{
+				// Unknown settings are ignored (files written by a newer version)
+				cerr << "GvvCameraPath::load : unknown setting " << name << " at line " << lineNumber << " of " << pFilename << endl;
+				continue;
+			}
+			if ( stream.fail() )
+			{
+				cerr << "GvvCameraPath::load : invalid setting at line " << lineNumber << " of " << pFilename << endl;
+
+				return false;
+			}
+			nbSettings++;
+		}
+		else
+		{
+			cerr << "GvvCameraPath::load : unknown tag " << tag << " at line " << lineNumber << " of " << pFilename << endl;
+
+			return false;
+		}
+	}
+
+	// Settings are only applied if all of them are available
+	_hasPipelineSettings = ( nbSettings >= cNbPipelineSettings );
+	if ( nbSettings > 0 && ! _hasPipelineSettings )
+	{
+		cerr << "GvvCameraPath::load : incomplete pipeline settings in " << pFilename << ", they will be ignored" << endl;
+	}
+
+	return true;
+}
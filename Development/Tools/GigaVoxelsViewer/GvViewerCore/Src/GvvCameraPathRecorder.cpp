@@ -0,0 +1,173 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvvCameraPathRecorder.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GvViewer
+#include "GvvPipelineInterface.h"
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GvViewer
+using namespace GvViewerCore;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvvCameraPathRecorder::GvvCameraPathRecorder()
+:	_cameraPath()
+,	_isRecording( false )
+,	_startTime( -1.0 )
+,	_minInterval( 0.f )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvvCameraPathRecorder::~GvvCameraPathRecorder()
+{
+}
+
+/******************************************************************************
+ * Start a new recording.
+ * The previous path is discarded.
+ *
+ * @param pPipeline the pipeline whose settings are stored with the path (can be NULL)
+ ******************************************************************************/
+void GvvCameraPathRecorder::start( const GvvPipelineInterface* pPipeline )
+{
+	_cameraPath.clear();
+	if ( pPipeline != NULL )
+	{
+		_cameraPath.capturePipelineSettings( *pPipeline );
+	}
+
+	_startTime = -1.0;
+	_isRecording = true;
+}
+
+/******************************************************************************
+ * Stop the recording
+ ******************************************************************************/
+void GvvCameraPathRecorder::stop()
+{
+	_isRecording = false;
+}
+
+/******************************************************************************
+ * Tell whether or not a recording is in progress
+ *
+ * @return a flag telling whether or not a recording is in progress
+ ******************************************************************************/
+bool GvvCameraPathRecorder::isRecording() const
+{
+	return _isRecording;
+}
+
+/******************************************************************************
+ * Record the camera of the current frame.
+ * The time of the keyframe is ignored and replaced by the given time.
+ *
+ * @param pTime the current time (in seconds, any origin)
+ * @param pCamera the camera
+ *
+ * @return a flag telling whether or not a keyframe has been added
+ ******************************************************************************/
+bool GvvCameraPathRecorder::record( double pTime, const GvvCameraPath::KeyFrame& pCamera )
+{
+	if ( ! _isRecording )
+	{
+		return false;
+	}
+
+	// The first recorded frame is the time origin of the path
+	if ( _startTime < 0.0 )
+	{
+		_startTime = pTime;
+	}
+
+	GvvCameraPath::KeyFrame keyFrame = pCamera;
+	keyFrame._time = static_cast< float >( pTime - _startTime );
+
+	// Skip frames that are too close to the previous keyframe
+	const unsigned int nbKeyFrames = _cameraPath.getNbKeyFrames();
+	if ( nbKeyFrames > 0 && keyFrame._time - _cameraPath.getKeyFrame( nbKeyFrames - 1 )._time < _minInterval )
+	{
+		return false;
+	}
+
+	return _cameraPath.addKeyFrame( keyFrame );
+}
+
+/******************************************************************************
+ * Get the min time between two keyframes
+ *
+ * @return the min time between two keyframes (in seconds)
+ ******************************************************************************/
+float GvvCameraPathRecorder::getMinInterval() const
+{
+	return _minInterval;
+}
+
+/******************************************************************************
+ * Set the min time between two keyframes.
+ * With 0, every frame is recorded.
+ *
+ * @param pValue the min time between two keyframes (in seconds)
+ ******************************************************************************/
+void GvvCameraPathRecorder::setMinInterval( float pValue )
+{
+	_minInterval = pValue;
+}
+
+/******************************************************************************
+ * Get the recorded path
+ *
+ * @return the recorded path
+ ******************************************************************************/
+const GvvCameraPath& GvvCameraPathRecorder::getCameraPath() const
+{
+	return _cameraPath;
+}
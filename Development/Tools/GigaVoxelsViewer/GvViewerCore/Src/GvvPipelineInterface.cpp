@@ -609,6 +609,29 @@ void GvvPipelineInterface::setBrickCacheMemory( unsigned int pValue )
 {
 }
 
+/******************************************************************************
+ * Set the node and brick cache memory at once.
+ * Pipelines that reallocate their pools should override it to do it only once,
+ * the default implementation calls setNodeCacheMemory() and setBrickCacheMemory().
+ *
+ * @param pNodeValue the node cache memory
+ * @param pBrickValue the brick cache memory
+ ******************************************************************************/
+void GvvPipelineInterface::setCacheMemory( unsigned int pNodeValue, unsigned int pBrickValue )
+{
+	// Shrink a pool before growing the other one to stay in the memory budget
+	if ( pNodeValue < getNodeCacheMemory() )
+	{
+		setNodeCacheMemory( pNodeValue );
+		setBrickCacheMemory( pBrickValue );
+	}
+	else
+	{
+		setBrickCacheMemory( pBrickValue );
+		setNodeCacheMemory( pNodeValue );
+	}
+}
+
 /******************************************************************************
  * Get the node cache capacity
  *
@@ -667,6 +690,26 @@ unsigned int GvvPipelineInterface::getCacheNbUnusedBricks() const
 	return 0;
 }
 
+/******************************************************************************
+ * Tell wheter or not the nodes cache has exceeded its capacity during last frame
+ *
+ * @return a flag telling wheter or not the nodes cache has exceeded its capacity
+ ******************************************************************************/
+bool GvvPipelineInterface::hasNodeCacheExceededCapacity() const
+{
+	return false;
+}
+
+/******************************************************************************
+ * Tell wheter or not the bricks cache has exceeded its capacity during last frame
+ *
+ * @return a flag telling wheter or not the bricks cache has exceeded its capacity
+ ******************************************************************************/
+bool GvvPipelineInterface::hasBrickCacheExceededCapacity() const
+{
+	return false;
+}
+
 /******************************************************************************
  * Get the nodes cache usage
  *
@@ -1081,3 +1124,23 @@ float GvvPipelineInterface::getProductionTimeLimit() const
 {
 	return 0.f;
 }
+
+/******************************************************************************
+ * Set or unset the flag used to tell whether or not production requests
+ * are ordered by priority (screen-space error) when they exceed the budget.
+ *
+ * @param pFlag the flag value.
+ ******************************************************************************/
+void GvvPipelineInterface::useRequestPriorities( bool pFlag )
+{
+}
+
+/******************************************************************************
+ * Get the flag telling whether or not production requests are ordered by priority.
+ *
+ * @return the flag telling whether or not production requests are ordered by priority.
+ ******************************************************************************/
+bool GvvPipelineInterface::hasRequestPriorities() const
+{
+	return false;
+}
@@ -0,0 +1,498 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvvReplayBenchmark.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GvViewer
+#include "GvvPipelineInterface.h"
+
+// OpenGL
+#include <GL/glew.h>
+
+// glm
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+// STL
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+// System
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GvViewer
+using namespace GvViewerCore;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Metric names (used in reports)
+ */
+static const char* cMetricNames[ GvvReplayBenchmark::eNbMetrics ] =
+{
+	"renderer_elapsed_time_ms",
+	"node_subdivision_requests",
+	"brick_load_requests",
+	"node_cache_usage",
+	"brick_cache_usage",
+	"tree_nodes",
+	"tree_leaf_nodes"
+};
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/**
+ * Nearest-rank percentile of a sorted list of values
+ *
+ * @param pValues sorted values (not empty)
+ * @param pPercentile percentile in [ 0 ; 100 ]
+ *
+ * @return the percentile
+ */
+static float getPercentile( const vector< float >& pValues, float pPercentile )
+{
+	assert( ! pValues.empty() );
+
+	const size_t nbValues = pValues.size();
+	size_t rank = static_cast< size_t >( ceil( pPercentile / 100.f * static_cast< float >( nbValues ) ) );
+	rank = std::min( std::max( rank, static_cast< size_t >( 1 ) ), nbValues );
+
+	return pValues[ rank - 1 ];
+}
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvvReplayBenchmark::GvvReplayBenchmark()
+:	_timeStep( 1.f / 60.f )
+,	_nbWarmupFrames( 0 )
+,	_hasGLMatrices( true )
+,	_values()
+,	_duration( 0.f )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvvReplayBenchmark::~GvvReplayBenchmark()
+{
+}
+
+/******************************************************************************
+ * Get the name of a metric
+ *
+ * @param pMetric the metric
+ *
+ * @return the name of the metric
+ ******************************************************************************/
+const char* GvvReplayBenchmark::getMetricName( EMetric pMetric )
+{
+	assert( pMetric < eNbMetrics );
+
+	return cMetricNames[ pMetric ];
+}
+
+/******************************************************************************
+ * Get the timestep between two frames
+ *
+ * @return the timestep (in seconds)
+ ******************************************************************************/
+float GvvReplayBenchmark::getTimeStep() const
+{
+	return _timeStep;
+}
+
+/******************************************************************************
+ * Set the timestep between two frames
+ *
+ * @param pValue the timestep (in seconds)
+ ******************************************************************************/
+void GvvReplayBenchmark::setTimeStep( float pValue )
+{
+	assert( pValue > 0.f );
+
+	_timeStep = pValue;
+}
+
+/******************************************************************************
+ * Get the number of frames replayed before counters are collected
+ *
+ * @return the number of warm-up frames
+ ******************************************************************************/
+unsigned int GvvReplayBenchmark::getNbWarmupFrames() const
+{
+	return _nbWarmupFrames;
+}
+
+/******************************************************************************
+ * Set the number of frames replayed before counters are collected.
+ * Warm-up frames render the first camera of the path.
+ *
+ * @param pValue the number of warm-up frames
+ ******************************************************************************/
+void GvvReplayBenchmark::setNbWarmupFrames( unsigned int pValue )
+{
+	_nbWarmupFrames = pValue;
+}
+
+/******************************************************************************
+ * Tell whether or not cameras are also loaded in the OpenGL fixed pipeline matrices
+ *
+ * @return the flag telling whether or not OpenGL matrices are loaded
+ ******************************************************************************/
+bool GvvReplayBenchmark::hasGLMatrices() const
+{
+	return _hasGLMatrices;
+}
+
+/******************************************************************************
+ * Set the flag telling whether or not cameras are also loaded in the OpenGL
+ * fixed pipeline matrices (pipelines read their camera from OpenGL).
+ * It requires a current OpenGL context.
+ *
+ * @param pFlag the flag telling whether or not OpenGL matrices are loaded
+ ******************************************************************************/
+void GvvReplayBenchmark::setGLMatrices( bool pFlag )
+{
+	_hasGLMatrices = pFlag;
+}
+
+/******************************************************************************
+ * Replay a camera path on a pipeline.
+ * Previous results are discarded.
+ *
+ * @param pPipeline the pipeline
+ * @param pCameraPath the camera path
+ *
+ * @return the number of frames that have been collected
+ ******************************************************************************/
+unsigned int GvvReplayBenchmark::run( GvvPipelineInterface& pPipeline, const GvvCameraPath& pCameraPath )
+{
+	_values.clear();
+	_duration = pCameraPath.getDuration();
+
+	if ( pCameraPath.getNbKeyFrames() == 0 )
+	{
+		cerr << "GvvReplayBenchmark::run : empty camera path" << endl;
+
+		return 0;
+	}
+
+	// Start from the recorded settings and an empty cache
+	pCameraPath.applyPipelineSettings( pPipeline );
+	const bool hasTreeDataStructureMonitoring = pPipeline.hasTreeDataStructureMonitoring();
+	pPipeline.setTreeDataStructureMonitoring( true );
+	pPipeline.clearCache();
+
+	GvvCameraPath::KeyFrame camera;
+
+	// Warm-up frames
+	pCameraPath.interpolate( 0.f, camera );
+	for ( unsigned int i = 0; i < _nbWarmupFrames; i++ )
+	{
+		setCamera( pPipeline, camera );
+		drawFrame( pPipeline );
+	}
+
+	// Replay at fixed timesteps
+	const unsigned int nbFrames = static_cast< unsigned int >( floor( _duration / _timeStep ) ) + 1;
+	_values.reserve( nbFrames * eNbMetrics );
+	for ( unsigned int i = 0; i < nbFrames; i++ )
+	{
+		pCameraPath.interpolate( static_cast< float >( i ) * _timeStep, camera );
+		setCamera( pPipeline, camera );
+		drawFrame( pPipeline );
+		collectFrame( pPipeline );
+	}
+
+	pPipeline.setTreeDataStructureMonitoring( hasTreeDataStructureMonitoring );
+
+	return nbFrames;
+}
+
+/******************************************************************************
+ * Set the camera of the pipeline.
+ * Default implementation writes the ModelView and Projection matrices
+ * of the pipeline and, if activated, the OpenGL ones.
+ *
+ * @param pPipeline the pipeline
+ * @param pCamera the camera
+ ******************************************************************************/
+void GvvReplayBenchmark::setCamera( GvvPipelineInterface& pPipeline, const GvvCameraPath::KeyFrame& pCamera )
+{
+	// The ModelView matrix is the inverse of the camera frame
+	const glm::quat orientation( pCamera._orientation[ 3 ], pCamera._orientation[ 0 ], pCamera._orientation[ 1 ], pCamera._orientation[ 2 ] );
+	const glm::vec3 position( pCamera._position[ 0 ], pCamera._position[ 1 ], pCamera._position[ 2 ] );
+	const glm::mat4 cameraFrame = glm::translate( glm::mat4( 1.f ), position ) * glm::mat4_cast( orientation );
+	const glm::mat4 modelViewMatrix = glm::inverse( cameraFrame );
+	const glm::mat4 projectionMatrix = glm::perspective( pCamera._fieldOfView, pCamera._aspectRatio, pCamera._zNear, pCamera._zFar );
+
+	memcpy( pPipeline.editModelViewMatrix(), glm::value_ptr( modelViewMatrix ), 16 * sizeof( float ) );
+	memcpy( pPipeline.editProjectionMatrix(), glm::value_ptr( projectionMatrix ), 16 * sizeof( float ) );
+
+	if ( _hasGLMatrices )
+	{
+		glMatrixMode( GL_PROJECTION );
+		glLoadMatrixf( glm::value_ptr( projectionMatrix ) );
+		glMatrixMode( GL_MODELVIEW );
+		glLoadMatrixf( glm::value_ptr( modelViewMatrix ) );
+	}
+}
+
+/******************************************************************************
+ * Render one frame.
+ * Default implementation calls the draw() method of the pipeline.
+ *
+ * @param pPipeline the pipeline
+ ******************************************************************************/
+void GvvReplayBenchmark::drawFrame( GvvPipelineInterface& pPipeline )
+{
+	pPipeline.draw();
+}
+
+/******************************************************************************
+ * Collect the counters of the last rendered frame
+ *
+ * @param pPipeline the pipeline
+ ******************************************************************************/
+void GvvReplayBenchmark::collectFrame( const GvvPipelineInterface& pPipeline )
+{
+	float values[ eNbMetrics ];
+	values[ eRendererElapsedTime ] = pPipeline.getRendererElapsedTime();
+	values[ eNodeSubdivisionRequests ] = static_cast< float >( pPipeline.getCacheNbNodeSubdivisionRequests() );
+	values[ eBrickLoadRequests ] = static_cast< float >( pPipeline.getCacheNbBrickLoadRequests() );
+	values[ eNodeCacheUsage ] = static_cast< float >( pPipeline.getNodeCacheUsage() );
+	values[ eBrickCacheUsage ] = static_cast< float >( pPipeline.getBrickCacheUsage() );
+	values[ eNbTreeNodes ] = static_cast< float >( pPipeline.getNbTreeNodes() );
+	values[ eNbTreeLeafNodes ] = static_cast< float >( pPipeline.getNbTreeLeafNodes() );
+
+	_values.insert( _values.end(), values, values + eNbMetrics );
+}
+
+/******************************************************************************
+ * Get the number of collected frames
+ *
+ * @return the number of collected frames
+ ******************************************************************************/
+unsigned int GvvReplayBenchmark::getNbFrames() const
+{
+	return static_cast< unsigned int >( _values.size() / eNbMetrics );
+}
+
+/******************************************************************************
+ * Get the value of a metric for a given frame
+ *
+ * @param pFrame the frame
+ * @param pMetric the metric
+ *
+ * @return the value
+ ******************************************************************************/
+float GvvReplayBenchmark::getValue( unsigned int pFrame, EMetric pMetric ) const
+{
+	assert( pFrame < getNbFrames() );
+	assert( pMetric < eNbMetrics );
+
+	return _values[ pFrame * eNbMetrics + pMetric ];
+}
+
+/******************************************************************************
+ * Compute the statistics of a metric over all collected frames
+ *
+ * @param pMetric the metric
+ *
+ * @return the statistics
+ ******************************************************************************/
+GvvReplayBenchmark::Statistics GvvReplayBenchmark::getStatistics( EMetric pMetric ) const
+{
+	Statistics statistics;
+	memset( &statistics, 0, sizeof( Statistics ) );
+
+	const unsigned int nbFrames = getNbFrames();
+	if ( nbFrames == 0 )
+	{
+		return statistics;
+	}
+
+	vector< float > values( nbFrames );
+	double sum = 0.0;
+	for ( unsigned int i = 0; i < nbFrames; i++ )
+	{
+		values[ i ] = getValue( i, pMetric );
+		sum += values[ i ];
+	}
+	sort( values.begin(), values.end() );
+
+	statistics._min = values.front();
+	statistics._max = values.back();
+	statistics._mean = static_cast< float >( sum / static_cast< double >( nbFrames ) );
+	statistics._p50 = getPercentile( values, 50.f );
+	statistics._p95 = getPercentile( values, 95.f );
+	statistics._p99 = getPercentile( values, 99.f );
+
+	return statistics;
+}
+
+/******************************************************************************
+ * Get the convergence frame, i.e. the first collected frame from which
+ * no more node subdivision nor brick load requests are emitted.
+ * It is used to compare request orderings (time to a stable image).
+ *
+ * @return the convergence frame (the number of frames if the replay never converges)
+ ******************************************************************************/
+unsigned int GvvReplayBenchmark::getConvergenceFrame() const
+{
+	unsigned int frame = getNbFrames();
+	while ( frame > 0
+		&& getValue( frame - 1, eNodeSubdivisionRequests ) == 0.f
+		&& getValue( frame - 1, eBrickLoadRequests ) == 0.f )
+	{
+		frame--;
+	}
+
+	return frame;
+}
+
+/******************************************************************************
+ * Write the statistics of all metrics in a JSON file
+ *
+ * @param pFilename the file name
+ * @param pTag a user tag used to identify the run (build, settings...)
+ *
+ * @return a flag telling whether or not it succeeds
+ ******************************************************************************/
+bool GvvReplayBenchmark::writeReport( const std::string& pFilename, const std::string& pTag ) const
+{
+	ofstream file( pFilename.c_str() );
+	if ( ! file.is_open() )
+	{
+		cerr << "GvvReplayBenchmark::writeReport : unable to open file " << pFilename << endl;
+
+		return false;
+	}
+
+	// Escape the tag (JSON string)
+	string tag;
+	for ( size_t i = 0; i < pTag.size(); i++ )
+	{
+		if ( pTag[ i ] == '"' || pTag[ i ] == '\\' )
+		{
+			tag += '\\';
+		}
+		tag += pTag[ i ];
+	}
+
+	file << "{" << endl;
+	file << "\t\"benchmark\": \"GvvReplayBenchmark\"," << endl;
+	file << "\t\"tag\": \"" << tag << "\"," << endl;
+	file << "\t\"timestamp\": " << static_cast< long >( time( NULL ) ) << "," << endl;
+	file << "\t\"time_step\": " << _timeStep << "," << endl;
+	file << "\t\"duration\": " << _duration << "," << endl;
+	file << "\t\"warmup_frames\": " << _nbWarmupFrames << "," << endl;
+	file << "\t\"frames\": " << getNbFrames() << "," << endl;
+	file << "\t\"convergence_frame\": " << getConvergenceFrame() << "," << endl;
+	file << "\t\"metrics\": [" << endl;
+	for ( unsigned int i = 0; i < eNbMetrics; i++ )
+	{
+		const Statistics statistics = getStatistics( static_cast< EMetric >( i ) );
+
+		file << "\t\t{ "
+			<< "\"name\": \"" << cMetricNames[ i ] << "\", "
+			<< "\"min\": " << statistics._min << ", "
+			<< "\"mean\": " << statistics._mean << ", "
+			<< "\"max\": " << statistics._max << ", "
+			<< "\"p50\": " << statistics._p50 << ", "
+			<< "\"p95\": " << statistics._p95 << ", "
+			<< "\"p99\": " << statistics._p99
+			<< " }" << ( ( i + 1 < eNbMetrics ) ? "," : "" ) << endl;
+	}
+	file << "\t]" << endl;
+	file << "}" << endl;
+
+	return file.good();
+}
+
+/******************************************************************************
+ * Write the per-frame values of all metrics in a CSV file
+ *
+ * @param pFilename the file name
+ *
+ * @return a flag telling whether or not it succeeds
+ ******************************************************************************/
+bool GvvReplayBenchmark::writeFrames( const std::string& pFilename ) const
+{
+	ofstream file( pFilename.c_str() );
+	if ( ! file.is_open() )
+	{
+		cerr << "GvvReplayBenchmark::writeFrames : unable to open file " << pFilename << endl;
+
+		return false;
+	}
+
+	file << "frame,time";
+	for ( unsigned int i = 0; i < eNbMetrics; i++ )
+	{
+		file << "," << cMetricNames[ i ];
+	}
+	file << endl;
+
+	const unsigned int nbFrames = getNbFrames();
+	for ( unsigned int frame = 0; frame < nbFrames; frame++ )
+	{
+		file << frame << "," << static_cast< float >( frame ) * _timeStep;
+		for ( unsigned int i = 0; i < eNbMetrics; i++ )
+		{
+			file << "," << getValue( frame, static_cast< EMetric >( i ) );
+		}
+		file << endl;
+	}
+
+	return file.good();
+}
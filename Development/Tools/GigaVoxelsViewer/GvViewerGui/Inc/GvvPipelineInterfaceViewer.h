@@ -42,6 +42,7 @@
 // Qt
 #include <QGLViewer/qglviewer.h>
 #include <QKeyEvent>
+#include <QTime>
 
 /******************************************************************************
  ************************* DEFINE AND CONSTANT SECTION ************************
@@ -60,6 +61,13 @@ namespace GvViewerCore
 {
 	class GvvPipelineInterface;
 	class GvvGLSceneInterface;
+	class GvvCameraPathRecorder;
+}
+
+// GigaVoxels
+namespace GvCache
+{
+	class GvPoolRebalancer;
 }
 
 // QGLViewer
@@ -93,6 +101,22 @@ class GVVIEWERGUI_EXPORT GvvPipelineInterfaceViewer : public QGLViewer, public G
 
 public:
 
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Node/brick pool rebalancing modes
+	 *
+	 * - recommend : the recommended split of the cache memory is only logged
+	 * - automatic : the recommended split is applied to the pipeline
+	 */
+	enum EPoolRebalancingMode
+	{
+		eNoPoolRebalancing,
+		eRecommendPoolRebalancing,
+		eAutomaticPoolRebalancing,
+		eNbPoolRebalancingModes
+	};
+
 	/******************************* ATTRIBUTES *******************************/
 
 	/******************************** METHODS *********************************/
@@ -137,6 +161,39 @@ public:
 	 */
 	bool captureVideo( bool pFlag );
 
+	/**
+	 * Record the camera path (and the pipeline settings) while navigating.
+	 * When the recording stops, the path is saved in the "Data/CameraPaths" directory.
+	 *
+	 * @param pFlag flag to start and stop the recording
+	 *
+	 * @return flag to tell wheter or not it succeeds
+	 */
+	bool recordCameraPath( bool pFlag );
+
+	/**
+	 * Replay the last recorded camera path at fixed timesteps and write
+	 * the per-frame counters and their p50/p95/p99 report in the "Data/CameraPaths" directory.
+	 *
+	 * @return flag to tell wheter or not it succeeds
+	 */
+	bool replayCameraPath();
+
+	/**
+	 * Set the node/brick pool rebalancing mode.
+	 * The working set of the caches is measured from the current pools.
+	 *
+	 * @param pMode the pool rebalancing mode
+	 */
+	void setPoolRebalancingMode( EPoolRebalancingMode pMode );
+
+	/**
+	 * Get the node/brick pool rebalancing mode
+	 *
+	 * @return the pool rebalancing mode
+	 */
+	EPoolRebalancingMode getPoolRebalancingMode() const;
+
 	/******************************** SIGNALS *********************************/
 
 signals:
@@ -306,8 +363,41 @@ private:
 	 */
 	GvViewerCore::GvvGLSceneInterface* _scene;
 
+	/**
+	 * Camera path recorder
+	 */
+	GvViewerCore::GvvCameraPathRecorder* _cameraPathRecorder;
+
+	/**
+	 * Clock used to timestamp recorded cameras
+	 */
+	QTime _cameraPathClock;
+
+	/**
+	 * Working set estimator of the node and brick caches
+	 */
+	GvCache::GvPoolRebalancer* _poolRebalancer;
+
+	/**
+	 * Node/brick pool rebalancing mode
+	 */
+	EPoolRebalancingMode _poolRebalancingMode;
+
 	/******************************** METHODS *********************************/
 
+	/**
+	 * Give the cache statistics of the last frame to the working set estimator,
+	 * and log or apply its recommended node/brick split
+	 */
+	void updatePoolRebalancing();
+
+	/**
+	 * Get the directory of camera paths and replay reports
+	 *
+	 * @return the directory of camera paths
+	 */
+	static QString getCameraPathRepository();
+
 };
 
 } // namespace GvViewerGui
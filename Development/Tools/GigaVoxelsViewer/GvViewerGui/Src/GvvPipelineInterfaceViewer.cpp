@@ -35,6 +35,8 @@
 
 #include "GvvPipelineInterface.h"
 #include "GvvGLSceneInterface.h"
+#include "GvvCameraPathRecorder.h"
+#include "GvvReplayBenchmark.h"
 
 #include "GvvApplication.h"
 #include "GvvMainWindow.h"
@@ -50,6 +52,10 @@
 #include <QDir>
 #include <QFileInfo>
 
+// STL
+#include <iostream>
+#include <algorithm>
+
 // System
 #include <cassert>
 
@@ -59,6 +65,10 @@
 // GigaSpace
 #include <GsGraphics/GsGraphicsUtils.h>
 
+// GigaVoxels
+#include <GvPerfMon/GvMetrics.h>
+#include <GvCache/GvPoolRebalancer.h>
+
 /******************************************************************************
  ****************************** NAMESPACE SECTION *****************************
  ******************************************************************************/
@@ -91,6 +101,10 @@ GvvPipelineInterfaceViewer::GvvPipelineInterfaceViewer( QWidget* parent, const Q
 ,	GvvGLSceneManagerListener()
 ,	mPipeline( NULL )
 ,	_scene( NULL )
+,	_cameraPathRecorder( new GvvCameraPathRecorder() )
+,	_cameraPathClock()
+,	_poolRebalancer( new GvCache::GvPoolRebalancer() )
+,	_poolRebalancingMode( eNoPoolRebalancing )
 {
 	setBackgroundColor( Qt::green );
 }
@@ -102,6 +116,12 @@ GvvPipelineInterfaceViewer::~GvvPipelineInterfaceViewer()
 {
 	//- test
 	saveStateToFile();
+
+	delete _cameraPathRecorder;
+	_cameraPathRecorder = NULL;
+
+	delete _poolRebalancer;
+	_poolRebalancer = NULL;
 }
 
 /******************************************************************************
@@ -117,6 +137,9 @@ void GvvPipelineInterfaceViewer::setPipeline( GvViewerCore::GvvPipelineInterface
 	//assert( mPipeline == NULL );
 	mPipeline = pPipeline;
 	// Pipeline END
+
+	// Measure the working set of the new pipeline from scratch
+	setPoolRebalancingMode( _poolRebalancingMode );
 }
 
 /******************************************************************************
@@ -311,6 +334,29 @@ void GvvPipelineInterfaceViewer::draw()
 		}
 	}
 
+	// Record the camera path
+	if ( _cameraPathRecorder->isRecording() )
+	{
+		const qglviewer::Vec position = camera()->position();
+		const qglviewer::Quaternion orientation = camera()->orientation();
+
+		GvvCameraPath::KeyFrame keyFrame;
+		keyFrame._time = 0.f;
+		keyFrame._position[ 0 ] = static_cast< float >( position.x );
+		keyFrame._position[ 1 ] = static_cast< float >( position.y );
+		keyFrame._position[ 2 ] = static_cast< float >( position.z );
+		for ( unsigned int i = 0; i < 4; i++ )
+		{
+			keyFrame._orientation[ i ] = static_cast< float >( orientation[ i ] );
+		}
+		keyFrame._fieldOfView = camera()->fieldOfView();
+		keyFrame._aspectRatio = camera()->aspectRatio();
+		keyFrame._zNear = camera()->zNear();
+		keyFrame._zFar = camera()->zFar();
+
+		_cameraPathRecorder->record( static_cast< double >( _cameraPathClock.elapsed() ) * 0.001, keyFrame );
+	}
+
 	// Pipeline BEGIN
 	if ( mPipeline != NULL )
 	{
@@ -362,6 +408,28 @@ void GvvPipelineInterfaceViewer::draw()
 				cacheUsageView->update( mPipeline );
 			}
 		}
+
+		// Publish metrics to the metrics endpoint if activated
+		if ( GvPerfMon::GvMetrics::_isActivated )
+		{
+			GvPerfMon::GvMetrics& metrics = GvPerfMon::GvMetrics::get();
+			metrics.setGauge( GvPerfMon::GvMetrics::eRendererElapsedTime, mPipeline->getRendererElapsedTime() );
+			metrics.setGauge( GvPerfMon::GvMetrics::eNodeCacheUsage, static_cast< double >( mPipeline->getNodeCacheUsage() ) );
+			metrics.setGauge( GvPerfMon::GvMetrics::eBrickCacheUsage, static_cast< double >( mPipeline->getBrickCacheUsage() ) );
+			metrics.setGauge( GvPerfMon::GvMetrics::eNodeCacheCapacity, static_cast< double >( mPipeline->getNodeCacheCapacity() ) );
+			metrics.setGauge( GvPerfMon::GvMetrics::eBrickCacheCapacity, static_cast< double >( mPipeline->getBrickCacheCapacity() ) );
+			metrics.setGauge( GvPerfMon::GvMetrics::eCacheNbUnusedNodes, static_cast< double >( mPipeline->getCacheNbUnusedNodes() ) );
+			metrics.setGauge( GvPerfMon::GvMetrics::eCacheNbUnusedBricks, static_cast< double >( mPipeline->getCacheNbUnusedBricks() ) );
+			metrics.setGauge( GvPerfMon::GvMetrics::eNbTreeNodes, static_cast< double >( mPipeline->getNbTreeNodes() ) );
+			metrics.setGauge( GvPerfMon::GvMetrics::eNbTreeLeafNodes, static_cast< double >( mPipeline->getNbTreeLeafNodes() ) );
+			metrics.setGauge( GvPerfMon::GvMetrics::eRendererMaxDepth, static_cast< double >( mPipeline->getRendererMaxDepth() ) );
+			metrics.observe( GvPerfMon::GvMetrics::eBrickLoadsPerFrame, static_cast< double >( mPipeline->getCacheNbBrickLoadRequests() ) );
+			metrics.observe( GvPerfMon::GvMetrics::eNodeSubdivisionsPerFrame, static_cast< double >( mPipeline->getCacheNbNodeSubdivisionRequests() ) );
+			metrics.endFrame();
+		}
+
+		// Handle node/brick pool rebalancing if activated
+		updatePoolRebalancing();
 	}
 	// Pipeline END
 
@@ -501,6 +569,18 @@ void GvvPipelineInterfaceViewer::keyPressEvent( QKeyEvent* e )
 			// Pipeline END
 			break;
 
+		case Qt::Key_R:
+			recordCameraPath( ! _cameraPathRecorder->isRecording() );
+			break;
+
+		case Qt::Key_B:
+			replayCameraPath();
+			break;
+
+		case Qt::Key_P:
+			setPoolRebalancingMode( static_cast< EPoolRebalancingMode >( ( _poolRebalancingMode + 1 ) % eNbPoolRebalancingModes ) );
+			break;
+
 		default:
 			QGLViewer::keyPressEvent( e );
 			break;
@@ -637,3 +717,201 @@ bool GvvPipelineInterfaceViewer::captureVideo( bool pFlag )
 
 	return true;
 }
+
+/******************************************************************************
+ * Record the camera path (and the pipeline settings) while navigating.
+ * When the recording stops, the path is saved in the "Data/CameraPaths" directory.
+ *
+ * @param pFlag flag to start and stop the recording
+ *
+ * @return flag to tell wheter or not it succeeds
+ ******************************************************************************/
+bool GvvPipelineInterfaceViewer::recordCameraPath( bool pFlag )
+{
+	if ( pFlag )
+	{
+		_cameraPathRecorder->start( mPipeline );
+		_cameraPathClock.start();
+
+		std::cout << "Camera path recording started" << std::endl;
+
+		return true;
+	}
+
+	if ( ! _cameraPathRecorder->isRecording() )
+	{
+		return false;
+	}
+	_cameraPathRecorder->stop();
+
+	const QString dataRepository = getCameraPathRepository();
+	QDir().mkpath( dataRepository );
+	const QString filename = dataRepository + QDir::separator() + QString( "cameraPath.txt" );
+	const bool result = _cameraPathRecorder->getCameraPath().save( filename.toStdString() );
+
+	std::cout << "Camera path recording stopped : " << _cameraPathRecorder->getCameraPath().getNbKeyFrames() << " keyframes saved in " << filename.toStdString() << std::endl;
+
+	return result;
+}
+
+/******************************************************************************
+ * Replay the last recorded camera path at fixed timesteps and write
+ * the per-frame counters and their p50/p95/p99 report in the "Data/CameraPaths" directory.
+ *
+ * @return flag to tell wheter or not it succeeds
+ ******************************************************************************/
+bool GvvPipelineInterfaceViewer::replayCameraPath()
+{
+	if ( mPipeline == NULL || _cameraPathRecorder->isRecording() )
+	{
+		return false;
+	}
+
+	const QString dataRepository = getCameraPathRepository();
+	const QString prefix = dataRepository + QDir::separator();
+
+	GvvCameraPath cameraPath;
+	if ( ! cameraPath.load( ( prefix + QString( "cameraPath.txt" ) ).toStdString() ) )
+	{
+		return false;
+	}
+
+	// The pipeline reads its camera from the OpenGL matrices of the viewer context
+	makeCurrent();
+	glPushAttrib( GL_ALL_ATTRIB_BITS );
+	glMatrixMode( GL_PROJECTION );
+	glPushMatrix();
+	glMatrixMode( GL_MODELVIEW );
+	glPushMatrix();
+
+	GvvReplayBenchmark benchmark;
+	benchmark.run( *mPipeline, cameraPath );
+
+	glMatrixMode( GL_PROJECTION );
+	glPopMatrix();
+	glMatrixMode( GL_MODELVIEW );
+	glPopMatrix();
+	glPopAttrib();
+
+	const bool result = benchmark.writeReport( ( prefix + QString( "replayReport.json" ) ).toStdString(), mPipeline->getName() )
+					&& benchmark.writeFrames( ( prefix + QString( "replayFrames.csv" ) ).toStdString() );
+
+	// LOG info
+	std::cout << "Camera path replayed : " << benchmark.getNbFrames() << " frames" << std::endl;
+	for ( unsigned int i = 0; i < GvvReplayBenchmark::eNbMetrics; i++ )
+	{
+		const GvvReplayBenchmark::EMetric metric = static_cast< GvvReplayBenchmark::EMetric >( i );
+		const GvvReplayBenchmark::Statistics statistics = benchmark.getStatistics( metric );
+		std::cout << "\t" << GvvReplayBenchmark::getMetricName( metric ) << " : p50 " << statistics._p50 << " - p95 " << statistics._p95 << " - p99 " << statistics._p99 << std::endl;
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * Set the node/brick pool rebalancing mode.
+ * The working set of the caches is measured from the current pools.
+ *
+ * @param pMode the pool rebalancing mode
+ ******************************************************************************/
+void GvvPipelineInterfaceViewer::setPoolRebalancingMode( EPoolRebalancingMode pMode )
+{
+	const bool hasModeChanged = ( pMode != _poolRebalancingMode );
+	_poolRebalancingMode = pMode;
+
+	// Current split of the cache memory (in Mo)
+	if ( mPipeline != NULL )
+	{
+		_poolRebalancer->setPoolMemorySizes( static_cast< size_t >( mPipeline->getNodeCacheMemory() ) * 1024U * 1024U,
+											static_cast< size_t >( mPipeline->getBrickCacheMemory() ) * 1024U * 1024U );
+	}
+	else
+	{
+		_poolRebalancer->setPoolMemorySizes( 0, 0 );
+	}
+
+	// LOG info
+	if ( hasModeChanged )
+	{
+		static const char* modeNames[ eNbPoolRebalancingModes ] = { "off", "recommend", "automatic" };
+		std::cout << "Pool rebalancing : " << modeNames[ _poolRebalancingMode ] << std::endl;
+	}
+}
+
+/******************************************************************************
+ * Get the node/brick pool rebalancing mode
+ *
+ * @return the pool rebalancing mode
+ ******************************************************************************/
+GvvPipelineInterfaceViewer::EPoolRebalancingMode GvvPipelineInterfaceViewer::getPoolRebalancingMode() const
+{
+	return _poolRebalancingMode;
+}
+
+/******************************************************************************
+ * Give the cache statistics of the last frame to the working set estimator,
+ * and log or apply its recommended node/brick split
+ ******************************************************************************/
+void GvvPipelineInterfaceViewer::updatePoolRebalancing()
+{
+	if ( _poolRebalancingMode == eNoPoolRebalancing || mPipeline == NULL || _poolRebalancer->getMemoryBudget() == 0 )
+	{
+		return;
+	}
+
+	GvCache::GvPoolRebalancer::FrameStatistics statistics;
+	statistics._nodeCapacity = mPipeline->getNodeCacheCapacity();
+	statistics._brickCapacity = mPipeline->getBrickCacheCapacity();
+	statistics._nbUnusedNodes = mPipeline->getCacheNbUnusedNodes();
+	statistics._nbUnusedBricks = mPipeline->getCacheNbUnusedBricks();
+	statistics._hasNodeCacheExceededCapacity = mPipeline->hasNodeCacheExceededCapacity();
+	statistics._hasBrickCacheExceededCapacity = mPipeline->hasBrickCacheExceededCapacity();
+	_poolRebalancer->addFrame( statistics );
+
+	size_t nodePoolMemorySize;
+	size_t brickPoolMemorySize;
+	if ( ! _poolRebalancer->computeRecommendation( nodePoolMemorySize, brickPoolMemorySize ) )
+	{
+		return;
+	}
+
+	// Pipelines handle their cache memory in Mo
+	const unsigned int budget = static_cast< unsigned int >( _poolRebalancer->getMemoryBudget() / ( 1024U * 1024U ) );
+	if ( budget < 2 )
+	{
+		return;
+	}
+	unsigned int nodeCacheMemory = static_cast< unsigned int >( ( nodePoolMemorySize + 512U * 1024U ) / ( 1024U * 1024U ) );
+	nodeCacheMemory = std::min( std::max( nodeCacheMemory, 1U ), budget - 1U );
+	const unsigned int brickCacheMemory = budget - nodeCacheMemory;
+
+	// LOG info
+	std::cout << "Pool rebalancing : working set [ nodes = " << _poolRebalancer->getNodeDemand() << " ] [ bricks = " << _poolRebalancer->getBrickDemand() << " ]"
+		<< " - recommended cache memory [ nodes = " << nodeCacheMemory << " Mo ] [ bricks = " << brickCacheMemory << " Mo ]"
+		<< " instead of [ nodes = " << mPipeline->getNodeCacheMemory() << " Mo ] [ bricks = " << mPipeline->getBrickCacheMemory() << " Mo ]" << std::endl;
+
+	if ( _poolRebalancingMode == eAutomaticPoolRebalancing && nodeCacheMemory != mPipeline->getNodeCacheMemory() )
+	{
+		// Pools are reallocated once, resident nodes and bricks are kept
+		mPipeline->setCacheMemory( nodeCacheMemory, brickCacheMemory );
+	}
+
+	// Start a new measure (from the new pools, if any)
+	setPoolRebalancingMode( _poolRebalancingMode );
+}
+
+/******************************************************************************
+ * Get the directory of camera paths and replay reports
+ *
+ * @return the directory of camera paths
+ ******************************************************************************/
+QString GvvPipelineInterfaceViewer::getCameraPathRepository()
+{
+	QString dataRepository = QCoreApplication::applicationDirPath();
+	dataRepository += QDir::separator();
+	dataRepository += QString( "Data" );
+	dataRepository += QDir::separator();
+	dataRepository += QString( "CameraPaths" );
+
+	return dataRepository;
+}
@@ -133,6 +133,16 @@ protected:
 	 */
 	virtual bool loadScene();
 
+	/**
+	 * Give all triangles of the scene to a voxelizer engine
+	 * (materials, textures and vertex attributes), in a deterministic order.
+	 *
+	 * @param pVoxelizerEngine the voxelizer engine
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	virtual bool voxelizeTriangles( GvxVoxelizerEngine& pVoxelizerEngine );
+
 	/**************************************************************************
 	 ***************************** PRIVATE SECTION ****************************
 	 **************************************************************************/
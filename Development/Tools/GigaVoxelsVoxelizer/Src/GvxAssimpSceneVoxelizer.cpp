@@ -141,6 +141,7 @@ bool GvxAssimpSceneVoxelizer::loadScene()
  * Normalize the scene.
  * It determines the whole scene bounding box and then modifies vertices
  * to scale the scene.
+ * With a fixed normalization, vertices are left unchanged if the scene doesn't fit in the normalized space.
  ******************************************************************************/
 bool GvxAssimpSceneVoxelizer::normalizeScene()
 {
@@ -194,8 +195,33 @@ bool GvxAssimpSceneVoxelizer::normalizeScene()
 		}
 	}
 
+	if ( _isNormalizationFixed )
+	{
+		// The scene must fit in the normalized space [ 0.0 ; 1.0 [ of the fixed normalization
+		const float boundsMin[ 3 ] = { xmin, ymin, zmin };
+		const float boundsMax[ 3 ] = { xmax, ymax, zmax };
+		for ( unsigned int i = 0; i < 3; i++ )
+		{
+			if ( ( boundsMin[ i ] - _normalizationCenter[ i ] ) * _normalizationScale + 0.5f < 0.f ||
+				( boundsMax[ i ] - _normalizationCenter[ i ] ) * _normalizationScale + 0.5f >= 1.f )
+			{
+				std::cerr << "GvxAssimpSceneVoxelizer::normalizeScene : the scene is out of the fixed normalization space" << std::endl;
+
+				return false;
+			}
+		}
+	}
+	else
+	{
+		// Fit the scene bounding box
+		_normalizationScale = 0.95f / std::max< float >( std::max< float >( xmax - xmin, ymax - ymin ), zmax - zmin );
+		_normalizationCenter[ 0 ] = 0.5f * ( xmax + xmin );
+		_normalizationCenter[ 1 ] = 0.5f * ( ymax + ymin );
+		_normalizationCenter[ 2 ] = 0.5f * ( zmax + zmin );
+	}
+
 	// Iterate through meshes to normalize the scene
-	float scale = 0.95f / std::max< float >( std::max< float >( xmax - xmin, ymax - ymin ), zmax - zmin );
+	const float scale = _normalizationScale;
 	for ( unsigned int i = 0; i < _scene->mNumMeshes; i++ )
 	{
 		// Get the current mesh
@@ -208,9 +234,9 @@ bool GvxAssimpSceneVoxelizer::normalizeScene()
 			aiVector3D& vertex = mesh->mVertices[ j ];
 
 			// Scale the scene
-			vertex.x = ( vertex.x  - 0.5f * ( xmax + xmin ) ) * scale + 0.5f;
-			vertex.y = ( vertex.y  - 0.5f * ( ymax + ymin ) ) * scale + 0.5f;
-			vertex.z = ( vertex.z  - 0.5f * ( zmax + zmin ) ) * scale + 0.5f;
+			vertex.x = ( vertex.x  - _normalizationCenter[ 0 ] ) * scale + 0.5f;
+			vertex.y = ( vertex.y  - _normalizationCenter[ 1 ] ) * scale + 0.5f;
+			vertex.z = ( vertex.z  - _normalizationCenter[ 2 ] ) * scale + 0.5f;
 		}
 	}
 
@@ -232,13 +258,6 @@ bool GvxAssimpSceneVoxelizer::voxelizeScene()
 		return false;
 	}
 
-	// Count number of faces
-	unsigned int nbFaces = 0;
-	for ( unsigned int i = 0; i < _scene->mNumMeshes; i++ )
-	{
-		nbFaces += _scene->mMeshes[ i ]->mNumFaces;
-	}
-
 	// Render
 	std::cout << "GvxVoxelizer at level : " << getMaxResolution() << std::endl;
 
@@ -256,9 +275,41 @@ bool GvxAssimpSceneVoxelizer::voxelizeScene()
 	
 	// Initialize the voxelization phase
 	_voxelizerEngine.init( getMaxResolution(), getBrickWidth(), getFileName(), getDataType() );
-	_voxelizerEngine.setColor( 1, 1, 1 );
-	_voxelizerEngine.setColor( 1, 1, 1 );
-	_voxelizerEngine.setColor( 1, 1, 1 );
+
+	// Voxelize triangles of the scene
+	return voxelizeTriangles( _voxelizerEngine );
+}
+
+/******************************************************************************
+ * Give all triangles of the scene to a voxelizer engine
+ * (materials, textures and vertex attributes), in a deterministic order.
+ *
+ * @param pVoxelizerEngine the voxelizer engine
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxAssimpSceneVoxelizer::voxelizeTriangles( GvxVoxelizerEngine& pVoxelizerEngine )
+{
+	assert( _scene != NULL );
+	if ( _scene == NULL )
+	{
+		// TO DO
+		// Handle error
+		// ...
+
+		return false;
+	}
+
+	// Count number of faces
+	unsigned int nbFaces = 0;
+	for ( unsigned int i = 0; i < _scene->mNumMeshes; i++ )
+	{
+		nbFaces += _scene->mMeshes[ i ]->mNumFaces;
+	}
+
+	pVoxelizerEngine.setColor( 1, 1, 1 );
+	pVoxelizerEngine.setColor( 1, 1, 1 );
+	pVoxelizerEngine.setColor( 1, 1, 1 );
 
 	// Iterate through meshes to voxelize them
 	unsigned int nbProcessedFaces = 0;
@@ -321,8 +372,8 @@ bool GvxAssimpSceneVoxelizer::voxelizeScene()
 		}
 #endif
 
-			_voxelizerEngine.setTexture( getFilePath() + texName );
-			_voxelizerEngine._useTexture = true;
+			pVoxelizerEngine.setTexture( getFilePath() + texName );
+			pVoxelizerEngine._useTexture = true;
 		}
 		else if ( nbAmbientTextures > 0 )
 		{
@@ -345,8 +396,8 @@ bool GvxAssimpSceneVoxelizer::voxelizeScene()
 		}
 #endif
 
-			_voxelizerEngine.setTexture( getFilePath() + texName );
-			_voxelizerEngine._useTexture = true;
+			pVoxelizerEngine.setTexture( getFilePath() + texName );
+			pVoxelizerEngine._useTexture = true;
 		}
 		else
 		{
@@ -358,11 +409,11 @@ bool GvxAssimpSceneVoxelizer::voxelizeScene()
 			aiGetMaterialColor( material, AI_MATKEY_COLOR_DIFFUSE, &diffuse );
 			aiGetMaterialColor( material, AI_MATKEY_COLOR_DIFFUSE, &specular );
 
-			_voxelizerEngine._useTexture = false;
+			pVoxelizerEngine._useTexture = false;
 
-			_voxelizerEngine.setColor( ambient.r + diffuse.r, ambient.g + diffuse.g, ambient.b + diffuse.b );
-			_voxelizerEngine.setColor( ambient.r + diffuse.r, ambient.g + diffuse.g, ambient.b + diffuse.b );
-			_voxelizerEngine.setColor( ambient.r + diffuse.r, ambient.g + diffuse.g, ambient.b + diffuse.b );
+			pVoxelizerEngine.setColor( ambient.r + diffuse.r, ambient.g + diffuse.g, ambient.b + diffuse.b );
+			pVoxelizerEngine.setColor( ambient.r + diffuse.r, ambient.g + diffuse.g, ambient.b + diffuse.b );
+			pVoxelizerEngine.setColor( ambient.r + diffuse.r, ambient.g + diffuse.g, ambient.b + diffuse.b );
 		}
 
 		// Iterate through mesh faces to voxelize them
@@ -382,20 +433,20 @@ bool GvxAssimpSceneVoxelizer::voxelizeScene()
 
 				// TO DO : question => check if there are always normals ?
 				// Retrieve normal
-				_voxelizerEngine.setNormal( mesh->mNormals[ ind ].x, mesh->mNormals[ ind ].y, mesh->mNormals[ ind ].z);
+				pVoxelizerEngine.setNormal( mesh->mNormals[ ind ].x, mesh->mNormals[ ind ].y, mesh->mNormals[ ind ].z);
 
 				// Retrieve texture coordinates
-				if ( _voxelizerEngine._useTexture )
+				if ( pVoxelizerEngine._useTexture )
 				{
-					_voxelizerEngine.setTexCoord( mesh->mTextureCoords[ 0 ][ ind ].x, mesh->mTextureCoords[ 0 ][ ind ].y );
+					pVoxelizerEngine.setTexCoord( mesh->mTextureCoords[ 0 ][ ind ].x, mesh->mTextureCoords[ 0 ][ ind ].y );
 				}
 
 				// Retrieve vertex coordinates
-				_voxelizerEngine.setVertex( mesh->mVertices[ ind ].x, mesh->mVertices[ ind ].y, mesh->mVertices[ ind ].z );
+				pVoxelizerEngine.setVertex( mesh->mVertices[ ind ].x, mesh->mVertices[ ind ].y, mesh->mVertices[ ind ].z );
 			}
 
 			// Generate a voxel from face data
-			_voxelizerEngine.voxelizeTriangle();
+			pVoxelizerEngine.voxelizeTriangle();
 
 			// Update the processed faces counter
 			nbProcessedFaces++;
@@ -406,8 +457,5 @@ bool GvxAssimpSceneVoxelizer::voxelizeScene()
 		}
 	}
 
-	// End of the voxelization phase
-	_voxelizerEngine.end();
-
 	return true;
 }
@@ -38,23 +38,26 @@
 #include "GvxVoxelizerEngine.h"
 #include "GvxDataTypeHandler.h"
 #include "GvxAssimpSceneVoxelizer.h"
+#include "GvxBatchVoxelizer.h"
+#include "GvxTileMerger.h"
+#include "GvxTextureCache.h"
+#include "GvxPointCloudVoxelizer.h"
+#include "GvxOcclusionBaker.h"
 
 // STL
 #include <string>
+#include <vector>
 #include <iostream>
 #include <cassert>
 #include <sstream>
+#include <cstdlib>
+#include <cstring>
 
 // Assimp
 #include <assimp/cimport.h>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
-// TinyXML
-#include <tinyxml.h>
-//#include <tinystr.h>
-
-
 // TO DO
 // This CImg dependency should be placed in an encapsulated class...
 // ...
@@ -80,6 +83,34 @@ using namespace std;
  ***************************** TYPE DEFINITION ********************************
  ******************************************************************************/
 
+/**
+ * Voxelization settings shared by the command line modes
+ * (default settings are the ones of the USER-dialog)
+ */
+struct VoxelizationSettings
+{
+	unsigned int _maxResolution;
+	unsigned int _brickWidth;
+	GvxDataTypeHandler::VoxelDataType _dataType;
+	bool _normals;
+	int _filterType;
+	int _nbFilterOperation;
+	bool _isBorderless;
+	unsigned int _textureCacheSize;
+
+	VoxelizationSettings()
+	:	_maxResolution( 6 )
+	,	_brickWidth( 8 )
+	,	_dataType( GvxDataTypeHandler::gvUCHAR4 )
+	,	_normals( false )
+	,	_filterType( 0 )
+	,	_nbFilterOperation( 0 )
+	,	_isBorderless( false )
+	,	_textureCacheSize( 512 )
+	{
+	}
+};
+
 /******************************************************************************
  ***************************** METHOD DEFINITION ******************************
  ******************************************************************************/
@@ -87,6 +118,16 @@ using namespace std;
 // CImg
 void printCImgLibraryInfo();
 
+// Batch mode
+int parseVoxelizationOption( int pArgc, char* pArgv[], int& pIndex, VoxelizationSettings& pSettings );
+bool checkVoxelizationSettings( const VoxelizationSettings& pSettings );
+void applyVoxelizationSettings( const VoxelizationSettings& pSettings, GvxSceneVoxelizer& pSceneVoxelizer );
+int runBatchVoxelization( int pArgc, char* pArgv[] );
+int runTileMerge( int pArgc, char* pArgv[] );
+int runPointCloudVoxelization( int pArgc, char* pArgv[] );
+int runOcclusionBaking( int pArgc, char* pArgv[] );
+void printBatchUsage();
+
 /******************************************************************************
  * Main entry program
  *
@@ -114,6 +155,24 @@ int main( int pArgc, char* pArgv[] )
 	printCImgLibraryInfo();
 #endif
 
+	// Batch mode : no user interaction (i.e. render farms, scripts)
+	if ( pArgc > 1 && strcmp( pArgv[ 1 ], "batch" ) == 0 )
+	{
+		return runBatchVoxelization( pArgc, pArgv );
+	}
+	if ( pArgc > 1 && strcmp( pArgv[ 1 ], "merge" ) == 0 )
+	{
+		return runTileMerge( pArgc, pArgv );
+	}
+	if ( pArgc > 1 && strcmp( pArgv[ 1 ], "points" ) == 0 )
+	{
+		return runPointCloudVoxelization( pArgc, pArgv );
+	}
+	if ( pArgc > 1 && strcmp( pArgv[ 1 ], "bake" ) == 0 )
+	{
+		return runOcclusionBaking( pArgc, pArgv );
+	}
+
 	// Qt main application
 	QApplication application( pArgc, pArgv );
 	
@@ -168,109 +227,688 @@ int main( int pArgc, char* pArgv[] )
 	//result = application.exec();
 
 
-	int nbChannels;
-	if (voxelizerDialog._normals)
+	// Write the XML file describing the generated data structure
+	sceneVoxelizer->writeDescriptorFile( sceneVoxelizer->getFileName() + ".xml" );
+
+	// Return exit code
+	return result;
+}
+
+/******************************************************************************
+ * Parse a voxelization setting of the command line
+ *
+ * @param pArgc number of arguments
+ * @param pArgv list of arguments
+ * @param pIndex index of the current argument (moved to its last value, if any)
+ * @param pSettings the voxelization settings
+ *
+ * @return 1 if the argument is a voxelization setting, 0 if it is not, -1 if its value is invalid
+ ******************************************************************************/
+int parseVoxelizationOption( int pArgc, char* pArgv[], int& pIndex, VoxelizationSettings& pSettings )
+{
+	const std::string argument = pArgv[ pIndex ];
+	const bool hasValue = ( pIndex + 1 < pArgc );
+
+	if ( argument == "--level" && hasValue )
 	{
-		nbChannels=2;
-	} else {
-		nbChannels=1;
+		pSettings._maxResolution = static_cast< unsigned int >( atoi( pArgv[ ++pIndex ] ) );
 	}
+	else if ( argument == "--brick-width" && hasValue )
+	{
+		pSettings._brickWidth = static_cast< unsigned int >( atoi( pArgv[ ++pIndex ] ) );
+	}
+	else if ( argument == "--data-type" && hasValue )
+	{
+		const std::string typeName = pArgv[ ++pIndex ];
+		if ( typeName == GvxDataTypeHandler::getTypeName( GvxDataTypeHandler::gvUCHAR4 ) )
+		{
+			pSettings._dataType = GvxDataTypeHandler::gvUCHAR4;
+		}
+		else if ( typeName == GvxDataTypeHandler::getTypeName( GvxDataTypeHandler::gvFLOAT ) )
+		{
+			pSettings._dataType = GvxDataTypeHandler::gvFLOAT;
+		}
+		else if ( typeName == GvxDataTypeHandler::getTypeName( GvxDataTypeHandler::gvFLOAT4 ) )
+		{
+			pSettings._dataType = GvxDataTypeHandler::gvFLOAT4;
+		}
+		else
+		{
+			std::cerr << "Unknown data type : " << typeName << std::endl;
 
+			return -1;
+		}
+	}
+	else if ( argument == "--normals" )
+	{
+		pSettings._normals = true;
+	}
+	else if ( argument == "--filter" && hasValue )
+	{
+		const std::string filterName = pArgv[ ++pIndex ];
+		if ( filterName == "mean" )
+		{
+			pSettings._filterType = 0;
+		}
+		else if ( filterName == "gaussian" )
+		{
+			pSettings._filterType = 1;
+		}
+		else if ( filterName == "laplacian" )
+		{
+			pSettings._filterType = 2;
+		}
+		else
+		{
+			std::cerr << "Unknown filter : " << filterName << std::endl;
 
+			return -1;
+		}
+	}
+	else if ( argument == "--filter-iterations" && hasValue )
+	{
+		pSettings._nbFilterOperation = atoi( pArgv[ ++pIndex ] );
+	}
+	else if ( argument == "--borderless" )
+	{
+		pSettings._isBorderless = true;
+	}
+	else if ( argument == "--texture-cache" && hasValue )
+	{
+		pSettings._textureCacheSize = static_cast< unsigned int >( atoi( pArgv[ ++pIndex ] ) );
+	}
+	else
+	{
+		return 0;
+	}
 
-	TiXmlDocument doc;
-	TiXmlElement * root;
-	root = new TiXmlElement( "Model" );  
-    root->SetAttribute("name",sceneVoxelizer->getFileName().c_str());
-    root->SetAttribute("directory",".");
+	return 1;
+}
 
-	stringstream nbLevels;
-	nbLevels<<(sceneVoxelizer->getMaxResolution())+1;
+/******************************************************************************
+ * Check voxelization settings
+ *
+ * @param pSettings the voxelization settings
+ *
+ * @return a flag telling wheter or not settings are valid
+ ******************************************************************************/
+bool checkVoxelizationSettings( const VoxelizationSettings& pSettings )
+{
+	if ( pSettings._brickWidth < 2 || ( pSettings._brickWidth & ( pSettings._brickWidth - 1 ) ) != 0 || pSettings._nbFilterOperation < 0 )
+	{
+		std::cerr << "Invalid settings : the brick width must be a power of two and the number of filter iterations must be positive" << std::endl;
 
-	root->SetAttribute("nbLevels",nbLevels.str().c_str());
+		return false;
+	}
 
+	return true;
+}
 
-	printf("%d %d\n",sceneVoxelizer->getBrickWidth(),sceneVoxelizer->getMaxResolution());
+/******************************************************************************
+ * Apply voxelization settings to a scene voxelizer
+ * (filter settings excepted, they depend on the voxelization mode)
+ *
+ * @param pSettings the voxelization settings
+ * @param pSceneVoxelizer the scene voxelizer
+ ******************************************************************************/
+void applyVoxelizationSettings( const VoxelizationSettings& pSettings, GvxSceneVoxelizer& pSceneVoxelizer )
+{
+	pSceneVoxelizer.setMaxResolution( pSettings._maxResolution );
+	pSceneVoxelizer.setBrickWidth( pSettings._brickWidth );
+	pSceneVoxelizer.setDataType( pSettings._dataType );
+	pSceneVoxelizer.setNormals( pSettings._normals );
+	pSceneVoxelizer.setBorderless( pSettings._isBorderless );
+
+	// Textures are shared by all scene voxelizers
+	GvxTextureCache::get().setMaxMemorySize( static_cast< size_t >( pSettings._textureCacheSize ) * 1024 * 1024 );
+}
 
-	TiXmlElement * tree = new TiXmlElement( "NodeTree" );
-	TiXmlElement * level;
-	TiXmlElement * channel;
+/******************************************************************************
+ * Voxelize a scene without any user interaction.
+ * The process is resumable : run the same command line again to continue
+ * an interrupted job (see GvxBatchVoxelizer).
+ *
+ * Usage : GvVoxelizer batch <scene file> [options]
+ *
+ * @param pArgc number of arguments
+ * @param pArgv list of arguments
+ *
+ * @return exit code
+ ******************************************************************************/
+int runBatchVoxelization( int pArgc, char* pArgv[] )
+{
+	std::string sceneFileName;
+	std::string previousSceneFileName;
+	VoxelizationSettings settings;
+	unsigned int tileOrigin[ 3 ] = { 0, 0, 0 };
+	unsigned int tileSize = 0;
+	unsigned int memorySize = 256;
+	unsigned int nbThreads = 0;
+
+	// Parse arguments
+	for ( int i = 2; i < pArgc; i++ )
+	{
+		const std::string argument = pArgv[ i ];
+
+		const int isSetting = parseVoxelizationOption( pArgc, pArgv, i, settings );
+		if ( isSetting < 0 )
+		{
+			printBatchUsage();
+
+			return 1;
+		}
+		else if ( isSetting > 0 )
+		{
+			continue;
+		}
+
+		if ( argument == "--previous" && i + 1 < pArgc )
+		{
+			previousSceneFileName = pArgv[ ++i ];
+		}
+		else if ( argument == "--tile" && i + 4 < pArgc )
+		{
+			tileOrigin[ 0 ] = static_cast< unsigned int >( atoi( pArgv[ ++i ] ) );
+			tileOrigin[ 1 ] = static_cast< unsigned int >( atoi( pArgv[ ++i ] ) );
+			tileOrigin[ 2 ] = static_cast< unsigned int >( atoi( pArgv[ ++i ] ) );
+			tileSize = static_cast< unsigned int >( atoi( pArgv[ ++i ] ) );
+			if ( tileSize == 0 )
+			{
+				std::cerr << "Invalid tile size" << std::endl;
+				printBatchUsage();
 
-	for (int k = 0;k<(sceneVoxelizer->getMaxResolution())+1;k++)
+				return 1;
+			}
+		}
+		else if ( argument == "--memory" && i + 1 < pArgc )
+		{
+			memorySize = static_cast< unsigned int >( atoi( pArgv[ ++i ] ) );
+		}
+		else if ( argument == "--threads" && i + 1 < pArgc )
+		{
+			nbThreads = static_cast< unsigned int >( atoi( pArgv[ ++i ] ) );
+		}
+		else if ( sceneFileName.empty() && argument[ 0 ] != '-' )
+		{
+			sceneFileName = argument;
+		}
+		else
+		{
+			std::cerr << "Invalid argument : " << argument << std::endl;
+			printBatchUsage();
+
+			return 1;
+		}
+	}
+
+	// Check input data
+	QFileInfo fileInfo( QString::fromLocal8Bit( sceneFileName.c_str() ) );
+	if ( sceneFileName.empty() || ! fileInfo.isFile() )
+	{
+		std::cerr << "Invalid scene file : " << sceneFileName << std::endl;
+		printBatchUsage();
+
+		return 1;
+	}
+	if ( ! checkVoxelizationSettings( settings ) )
+	{
+		return 1;
+	}
+	if ( memorySize == 0 )
 	{
-		level=  new TiXmlElement( "Level" );
-		stringstream levelK;
-		levelK<<k;
-		level->SetAttribute("id",levelK.str().c_str());
-		stringstream filename;
-		filename<<sceneVoxelizer->getFileName()<<"_BR"<<sceneVoxelizer->getBrickWidth()<<"_B1_L"<<k<<".nodes";
-		level->SetAttribute("filename",filename.str().c_str());
-		tree->LinkEndChild(level);
+		std::cerr << "Invalid settings : the memory size must be positive" << std::endl;
+
+		return 1;
 	}
-	root->LinkEndChild(tree);
 
-	tree=  new TiXmlElement( "BrickData" );
-	stringstream brickRes;
-	brickRes<<sceneVoxelizer->getBrickWidth();
-	tree->SetAttribute("brickResolution",brickRes.str().c_str());
-	tree->SetAttribute("borderSize","1");
+	// Create and initialize the scene voxelizer
+	GvxAssimpSceneVoxelizer sceneVoxelizer;
+	sceneVoxelizer.setFilePath( QString( fileInfo.absolutePath() + QDir::separator() ).toLatin1().constData() );
+	sceneVoxelizer.setFileName( fileInfo.completeBaseName().toLatin1().constData() );
+	sceneVoxelizer.setFileExtension( QString( "." + fileInfo.suffix() ).toLatin1().constData() );
+	applyVoxelizationSettings( settings, sceneVoxelizer );
 
-	for (int p = 0;p<nbChannels;p++)
+	// Tile mode : only the leaf level of one tile is generated (see the merge mode)
+	if ( tileSize > 0 )
 	{
-		channel=  new TiXmlElement( "Channel" );
-		stringstream channelP;
-		channelP<<p;
-		channel->SetAttribute("id",channelP.str().c_str());
-		if (p==0) 
+		if ( ! previousSceneFileName.empty() )
 		{
+			std::cerr << "Invalid settings : a tile can't be updated incrementally" << std::endl;
 
-			channel->SetAttribute("name","color");
-			channel->SetAttribute("type","uchar4");
-		} else if (p==1){
-			channel->SetAttribute("name","normal");
-			channel->SetAttribute("type","half4");
-		} else {
-			channel->SetAttribute("name","unknown");
-			channel->SetAttribute("type","unknown");
+			return 1;
 		}
 
-		for (int k = 0;k<(sceneVoxelizer->getMaxResolution())+1;k++)
+		// LOG
+		std::cout << "-------- BEGIN tile voxelization process --------" << std::endl;
+
+		// Launch the voxelization
+		const bool isSucceeded = sceneVoxelizer.launchTileVoxelizationProcess( tileOrigin, tileSize );
+
+		// LOG
+		std::cout << "-------- END tile voxelization process --------" << std::endl;
+
+		return isSucceeded ? 0 : 2;
+	}
+
+	// Incremental mode : only regions that differ from the previous version of the scene are updated
+	if ( ! previousSceneFileName.empty() )
+	{
+		if ( settings._isBorderless )
 		{
-			level=  new TiXmlElement( "Level" );
-			stringstream levelK;
-			levelK<<k;
-			level->SetAttribute("id",levelK.str().c_str());
+			std::cerr << "Invalid settings : borderless data can't be updated incrementally" << std::endl;
 
-			stringstream filename;
-			if (p==0) 
-			{
-				filename<<sceneVoxelizer->getFileName()<<"_BR"<<sceneVoxelizer->getBrickWidth()<<"_B1_L"<<k<<"_C"<<p<<"_uchar4"<<".bricks";
-			} else if (p==1) {
-				filename<<sceneVoxelizer->getFileName()<<"_BR"<<sceneVoxelizer->getBrickWidth()<<"_B1_L"<<k<<"_C"<<p<<"_half4"<<".bricks";
-			} else {
-				filename<<sceneVoxelizer->getFileName()<<"_BR"<<sceneVoxelizer->getBrickWidth()<<"_B1_L"<<k<<"_C"<<p<<"_unknown"<<".bricks";
-			}
+			return 1;
+		}
 
-			level->SetAttribute("filename",filename.str().c_str());
+		QFileInfo previousFileInfo( QString::fromLocal8Bit( previousSceneFileName.c_str() ) );
+		if ( ! previousFileInfo.isFile() )
+		{
+			std::cerr << "Invalid previous scene file : " << previousSceneFileName << std::endl;
+			printBatchUsage();
 
-			channel->LinkEndChild(level);
+			return 1;
 		}
 
+		GvxAssimpSceneVoxelizer previousSceneVoxelizer;
+		previousSceneVoxelizer.setFilePath( QString( previousFileInfo.absolutePath() + QDir::separator() ).toLatin1().constData() );
+		previousSceneVoxelizer.setFileName( previousFileInfo.completeBaseName().toLatin1().constData() );
+		previousSceneVoxelizer.setFileExtension( QString( "." + previousFileInfo.suffix() ).toLatin1().constData() );
+		applyVoxelizationSettings( settings, previousSceneVoxelizer );
+
+		sceneVoxelizer.setFilterType( settings._filterType );
+		sceneVoxelizer.setFilterIterations( settings._nbFilterOperation );
 
+		// LOG
+		std::cout << "-------- BEGIN incremental voxelization process --------" << std::endl;
+
+		// Launch the voxelization
+		const bool isSucceeded = sceneVoxelizer.launchIncrementalVoxelizationProcess( previousSceneVoxelizer );
+
+		// LOG
+		std::cout << "-------- END incremental voxelization process --------" << std::endl;
+
+		return isSucceeded ? 0 : 2;
+	}
 
-		tree->LinkEndChild(channel);
+	GvxBatchVoxelizer batchVoxelizer( sceneVoxelizer );
+	batchVoxelizer.setFilterType( settings._filterType );
+	batchVoxelizer.setFilterIterations( settings._nbFilterOperation );
+	batchVoxelizer.setMemorySize( static_cast< size_t >( memorySize ) * 1024 * 1024 );
+	if ( nbThreads > 0 )
+	{
+		batchVoxelizer.setNbThreads( nbThreads );
 	}
 
-	root->LinkEndChild(tree);
-    doc.LinkEndChild( root );
+	// LOG
+	std::cout << "-------- BEGIN batch voxelization process --------" << std::endl;
 
-	stringstream XMLFilename;
-	XMLFilename<<sceneVoxelizer->getFileName()<<".xml";
+	// Launch the voxelization
+	const bool isSucceeded = batchVoxelizer.execute();
 
-    doc.SaveFile( XMLFilename.str().c_str() );
+	// LOG
+	std::cout << "-------- END batch voxelization process --------" << std::endl;
 
-	// Return exit code
-	return result;
+	return isSucceeded ? 0 : 2;
+}
+
+/******************************************************************************
+ * Merge tiles voxelized by separate processes (see the batch mode --tile option)
+ * into one data structure : borders and mip-map levels are generated,
+ * then the XML descriptor file is written.
+ *
+ * Usage : GvVoxelizer merge <name> [options] <tile descriptor files>
+ *
+ * @param pArgc number of arguments
+ * @param pArgv list of arguments
+ *
+ * @return exit code
+ ******************************************************************************/
+int runTileMerge( int pArgc, char* pArgv[] )
+{
+	std::string name;
+	std::vector< std::string > tileNames;
+	VoxelizationSettings settings;
+
+	// Parse arguments
+	for ( int i = 2; i < pArgc; i++ )
+	{
+		const std::string argument = pArgv[ i ];
+
+		const int isSetting = parseVoxelizationOption( pArgc, pArgv, i, settings );
+		if ( isSetting < 0 )
+		{
+			printBatchUsage();
+
+			return 1;
+		}
+		else if ( isSetting > 0 )
+		{
+			continue;
+		}
+
+		if ( name.empty() && argument[ 0 ] != '-' )
+		{
+			name = argument;
+		}
+		else if ( argument.size() > 5 && argument.compare( argument.size() - 5, 5, ".tile" ) == 0 )
+		{
+			tileNames.push_back( argument.substr( 0, argument.size() - 5 ) );
+		}
+		else
+		{
+			std::cerr << "Invalid argument : " << argument << std::endl;
+			printBatchUsage();
+
+			return 1;
+		}
+	}
+
+	// Check input data
+	if ( name.empty() || tileNames.empty() )
+	{
+		std::cerr << "Invalid arguments : a data name and tile descriptor files are required" << std::endl;
+		printBatchUsage();
+
+		return 1;
+	}
+	if ( ! checkVoxelizationSettings( settings ) )
+	{
+		return 1;
+	}
+
+	// The scene voxelizer only holds settings of the merged data structure : no scene is loaded
+	GvxSceneVoxelizer sceneVoxelizer;
+	sceneVoxelizer.setFileName( name );
+	applyVoxelizationSettings( settings, sceneVoxelizer );
+	sceneVoxelizer.setFilterType( settings._filterType );
+	sceneVoxelizer.setFilterIterations( settings._nbFilterOperation );
+
+	GvxTileMerger tileMerger( sceneVoxelizer );
+	for ( size_t i = 0; i < tileNames.size(); i++ )
+	{
+		tileMerger.addTile( tileNames[ i ] );
+	}
+
+	// LOG
+	std::cout << "-------- BEGIN tile merge process --------" << std::endl;
+
+	// Launch the merge
+	bool isSucceeded = tileMerger.execute();
+	if ( isSucceeded )
+	{
+		// Write the XML file describing the generated data structure
+		isSucceeded = sceneVoxelizer.writeDescriptorFile( sceneVoxelizer.getFileName() + ".xml" );
+	}
+
+	// LOG
+	std::cout << "-------- END tile merge process --------" << std::endl;
+
+	return isSucceeded ? 0 : 2;
+}
+
+/******************************************************************************
+ * Voxelize a point cloud larger than memory (see GvxPointCloudVoxelizer),
+ * then write the XML descriptor file.
+ *
+ * Usage : GvVoxelizer points <point cloud file> [options]
+ *
+ * @param pArgc number of arguments
+ * @param pArgv list of arguments
+ *
+ * @return exit code
+ ******************************************************************************/
+int runPointCloudVoxelization( int pArgc, char* pArgv[] )
+{
+	std::string pointCloudFileName;
+	VoxelizationSettings settings;
+	unsigned int memorySize = 1024;
+	unsigned int nbThreads = 0;
+	float nbPointsPerVoxel = 1.0f;
+	bool isSplattingOn = false;
+
+	// Parse arguments
+	for ( int i = 2; i < pArgc; i++ )
+	{
+		const std::string argument = pArgv[ i ];
+
+		const int isSetting = parseVoxelizationOption( pArgc, pArgv, i, settings );
+		if ( isSetting < 0 )
+		{
+			printBatchUsage();
+
+			return 1;
+		}
+		else if ( isSetting > 0 )
+		{
+			continue;
+		}
+
+		if ( argument == "--memory" && i + 1 < pArgc )
+		{
+			memorySize = static_cast< unsigned int >( atoi( pArgv[ ++i ] ) );
+		}
+		else if ( argument == "--threads" && i + 1 < pArgc )
+		{
+			nbThreads = static_cast< unsigned int >( atoi( pArgv[ ++i ] ) );
+		}
+		else if ( argument == "--points-per-voxel" && i + 1 < pArgc )
+		{
+			nbPointsPerVoxel = static_cast< float >( atof( pArgv[ ++i ] ) );
+		}
+		else if ( argument == "--splat" )
+		{
+			isSplattingOn = true;
+		}
+		else if ( pointCloudFileName.empty() && argument[ 0 ] != '-' )
+		{
+			pointCloudFileName = argument;
+		}
+		else
+		{
+			std::cerr << "Invalid argument : " << argument << std::endl;
+			printBatchUsage();
+
+			return 1;
+		}
+	}
+
+	// Check input data
+	QFileInfo fileInfo( QString::fromLocal8Bit( pointCloudFileName.c_str() ) );
+	if ( pointCloudFileName.empty() || ! fileInfo.isFile() )
+	{
+		std::cerr << "Invalid point cloud file : " << pointCloudFileName << std::endl;
+		printBatchUsage();
+
+		return 1;
+	}
+	if ( ! checkVoxelizationSettings( settings ) )
+	{
+		return 1;
+	}
+	if ( settings._nbFilterOperation > 0 || memorySize == 0 || nbPointsPerVoxel <= 0.0f )
+	{
+		std::cerr << "Invalid settings : no filter is allowed, the memory size and the number of points per voxel must be positive" << std::endl;
+
+		return 1;
+	}
+
+	// The scene voxelizer only holds settings of the data structure : no scene is loaded
+	GvxSceneVoxelizer sceneVoxelizer;
+	sceneVoxelizer.setFileName( fileInfo.completeBaseName().toLatin1().constData() );
+	applyVoxelizationSettings( settings, sceneVoxelizer );
+
+	GvxPointCloudVoxelizer pointCloudVoxelizer( sceneVoxelizer );
+	pointCloudVoxelizer.setMemorySize( static_cast< size_t >( memorySize ) * 1024 * 1024 );
+	if ( nbThreads > 0 )
+	{
+		pointCloudVoxelizer.setNbThreads( nbThreads );
+	}
+	pointCloudVoxelizer.setNbPointsPerVoxel( nbPointsPerVoxel );
+	pointCloudVoxelizer.setSplatting( isSplattingOn );
+
+	// LOG
+	std::cout << "-------- BEGIN point cloud voxelization process --------" << std::endl;
+
+	// Launch the voxelization
+	bool isSucceeded = pointCloudVoxelizer.execute( pointCloudFileName );
+	if ( isSucceeded )
+	{
+		// Write the XML file describing the generated data structure
+		isSucceeded = sceneVoxelizer.writeDescriptorFile( sceneVoxelizer.getFileName() + ".xml" );
+	}
+
+	// LOG
+	std::cout << "-------- END point cloud voxelization process --------" << std::endl;
+
+	return isSucceeded ? 0 : 2;
+}
+
+/******************************************************************************
+ * Bake ambient occlusion (and optionally single-bounce irradiance) in an extra channel
+ * of an already voxelized data structure (see GvxOcclusionBaker),
+ * then write the "<name>_occlusion.xml" descriptor file listing it after the other channels
+ * (the "<name>.xml" descriptor file is left untouched).
+ *
+ * Usage : GvVoxelizer bake <name> [options]
+ *
+ * @param pArgc number of arguments
+ * @param pArgv list of arguments
+ *
+ * @return exit code
+ ******************************************************************************/
+int runOcclusionBaking( int pArgc, char* pArgv[] )
+{
+	std::string name;
+	VoxelizationSettings settings;
+	unsigned int nbThreads = 0;
+	float maxDistance = 0.05f;
+	bool isIrradianceOn = false;
+
+	// Parse arguments
+	for ( int i = 2; i < pArgc; i++ )
+	{
+		const std::string argument = pArgv[ i ];
+
+		const int isSetting = parseVoxelizationOption( pArgc, pArgv, i, settings );
+		if ( isSetting < 0 )
+		{
+			printBatchUsage();
+
+			return 1;
+		}
+		else if ( isSetting > 0 )
+		{
+			continue;
+		}
+
+		if ( argument == "--threads" && i + 1 < pArgc )
+		{
+			nbThreads = static_cast< unsigned int >( atoi( pArgv[ ++i ] ) );
+		}
+		else if ( argument == "--distance" && i + 1 < pArgc )
+		{
+			maxDistance = static_cast< float >( atof( pArgv[ ++i ] ) );
+		}
+		else if ( argument == "--irradiance" )
+		{
+			isIrradianceOn = true;
+		}
+		else if ( name.empty() && argument[ 0 ] != '-' )
+		{
+			name = argument;
+		}
+		else
+		{
+			std::cerr << "Invalid argument : " << argument << std::endl;
+			printBatchUsage();
+
+			return 1;
+		}
+	}
+
+	// Check input data
+	if ( name.empty() )
+	{
+		std::cerr << "Invalid arguments : a data name is required" << std::endl;
+		printBatchUsage();
+
+		return 1;
+	}
+	if ( ! checkVoxelizationSettings( settings ) )
+	{
+		return 1;
+	}
+	if ( maxDistance <= 0.0f )
+	{
+		std::cerr << "Invalid settings : the occlusion distance must be positive" << std::endl;
+
+		return 1;
+	}
+
+	// The scene voxelizer only holds settings of the data structure : no scene is loaded
+	GvxSceneVoxelizer sceneVoxelizer;
+	sceneVoxelizer.setFileName( name );
+	applyVoxelizationSettings( settings, sceneVoxelizer );
+	sceneVoxelizer.setBakedIrradianceOn( isIrradianceOn );
+
+	GvxOcclusionBaker occlusionBaker( sceneVoxelizer );
+	if ( nbThreads > 0 )
+	{
+		occlusionBaker.setNbThreads( nbThreads );
+	}
+	occlusionBaker.setMaxDistance( maxDistance );
+
+	// LOG
+	std::cout << "-------- BEGIN occlusion baking process --------" << std::endl;
+
+	// Launch the baking
+	bool isSucceeded = occlusionBaker.execute();
+	if ( isSucceeded )
+	{
+		// Write the XML file describing the data structure with the baked channel
+		isSucceeded = occlusionBaker.writeDescriptorFile( GvxOcclusionBaker::getDescriptorFileName( sceneVoxelizer.getFileName() ) );
+	}
+
+	// LOG
+	std::cout << "-------- END occlusion baking process --------" << std::endl;
+
+	return isSucceeded ? 0 : 2;
+}
+
+/******************************************************************************
+ * Print the batch mode usage
+ ******************************************************************************/
+void printBatchUsage()
+{
+	std::cout << "Usage : GvVoxelizer batch <scene file> [options]" << std::endl;
+	std::cout << "        GvVoxelizer merge <name> [options] <tile descriptor files (.tile)>" << std::endl;
+	std::cout << "        GvVoxelizer points <point cloud file (.ply, .xyz)> [options]" << std::endl;
+	std::cout << "        GvVoxelizer bake <name> [options]" << std::endl;
+	std::cout << "  --level N               max level of resolution (default 6, i.e. 512^3 voxels with 8^3 bricks)" << std::endl;
+	std::cout << "  --brick-width N         brick width (default 8)" << std::endl;
+	std::cout << "  --data-type T           uchar4 (default), float or float4" << std::endl;
+	std::cout << "  --normals               generate the normal channel" << std::endl;
+	std::cout << "  --filter F              mean (default), gaussian or laplacian" << std::endl;
+	std::cout << "  --filter-iterations N   number of filter applications (default 0)" << std::endl;
+	std::cout << "  --borderless            store bricks without borders, they are reconstructed at load time from neighbor bricks" << std::endl;
+	std::cout << "  --texture-cache N       max memory size of the texture cache, in MB (default 512)" << std::endl;
+	std::cout << "  --previous F            previous version of the scene, already voxelized with the same settings :" << std::endl;
+	std::cout << "                          only the regions that changed are updated, in the space of the previous voxelization (no filter allowed)" << std::endl;
+	std::cout << "  --tile X Y Z N          voxelize the leaf level of the tile of N^3 nodes starting at node (X, Y, Z) only." << std::endl;
+	std::cout << "                          Tiles voxelized by separate processes are then merged with the merge mode (same settings)" << std::endl;
+	std::cout << "  --threads N             number of threads used to generate mip-map levels (default : number of processors)" << std::endl;
+	std::cout << "  --memory N              max memory size used to generate a mip-map level, in MB (default 256)" << std::endl;
+	std::cout << "Point cloud options (uchar4 data type only, no filter) :" << std::endl;
+	std::cout << "  --memory N              max memory size used to sort points, in MB (default 1024)" << std::endl;
+	std::cout << "  --threads N             number of threads used to sort points (default : number of processors)" << std::endl;
+	std::cout << "  --points-per-voxel F    number of points that make a voxel opaque (default 1)" << std::endl;
+	std::cout << "  --splat                 splat points in the eight nearest voxels with trilinear weights" << std::endl;
+	std::cout << "Occlusion baking options (settings of the already voxelized data structure are given as above) :" << std::endl;
+	std::cout << "  --threads N             number of threads used to bake voxels (default : number of processors)" << std::endl;
+	std::cout << "  --distance F            max distance of occluders, the data structure being a unit cube (default 0.05)" << std::endl;
+	std::cout << "  --irradiance            bake single-bounce irradiance too (uchar4 channel : irradiance in RGB, visibility in alpha)" << std::endl;
+	std::cout << "                          The baked channel is listed in <name>_occlusion.xml, <name>.xml is left untouched" << std::endl;
+	std::cout << "Files are written in the current directory. Run the same command again to resume an interrupted job." << std::endl;
 }
 
 /******************************************************************************
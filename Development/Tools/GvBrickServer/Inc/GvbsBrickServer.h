@@ -0,0 +1,261 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#ifndef _GVBS_BRICK_SERVER_H_
+#define _GVBS_BRICK_SERVER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include <GvUtils/GvBrickServerProtocol.h>
+
+// STL
+#include <string>
+#include <vector>
+#include <map>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+namespace Gvbs
+{
+	class GvbsDataset;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace Gvbs
+{
+
+/**
+ * @class GvbsBrickServer
+ *
+ * @brief The GvbsBrickServer class provides a local brick server sharing one host cache
+ * of bricks between several viewer processes (see GvUtils::GvBrickServerProtocol).
+ *
+ * The server owns the dataset and a POSIX shared memory segment holding all nodes, node summaries
+ * and a fixed number of brick slots. Clients connect on a Unix socket and acquire/release bricks :
+ * on a miss, the brick is read from disk into a free slot, or into the least recently used slot
+ * that no client references anymore. References held by a client are released when it disconnects.
+ *
+ * The server is single threaded : requests are served in order by a poll() loop.
+ */
+class GvbsBrickServer
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pDataset the dataset served (must be open)
+	 */
+	GvbsBrickServer( GvbsDataset& pDataset );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvbsBrickServer();
+
+	/**
+	 * Create the shared memory, load nodes and summaries, and listen on a Unix socket
+	 *
+	 * @param pSocketPath path of the Unix socket
+	 * @param pNbSlots number of brick slots of the shared cache
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool initialize( const std::string& pSocketPath, unsigned int pNbSlots );
+
+	/**
+	 * Remove the shared memory and the Unix socket
+	 */
+	void finalize();
+
+	/**
+	 * Serve clients until stop() is called
+	 */
+	void run();
+
+	/**
+	 * Ask the server to stop (can be called from a signal handler)
+	 */
+	static void stop();
+
+	/**
+	 * Print statistics
+	 */
+	void printStatistics() const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Client connection and the references it holds (slot index -> number of references)
+	 */
+	struct Client
+	{
+		int _socket;
+		std::map< unsigned int, unsigned int > _references;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Stop flag
+	 */
+	static volatile int _stopRequested;
+
+	/**
+	 * The dataset served
+	 */
+	GvbsDataset& _dataset;
+
+	/**
+	 * Unix socket path and listening socket
+	 */
+	std::string _socketPath;
+	int _socket;
+
+	/**
+	 * Shared memory name, address and size
+	 */
+	std::string _sharedMemoryName;
+	void* _sharedMemory;
+	size_t _sharedMemorySize;
+
+	/**
+	 * Connected clients
+	 */
+	std::vector< Client > _clients;
+
+	/**
+	 * Slots holding a brick (( level << 32 ) | brick address -> slot index)
+	 */
+	std::map< unsigned long long, unsigned int > _slotMap;
+
+	/**
+	 * Logical clock used for LRU eviction
+	 */
+	unsigned long long _clock;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Retrieve the shared memory header
+	 *
+	 * @return the header
+	 */
+	GvUtils::GvBrickServerProtocol::Header* getHeader();
+
+	/**
+	 * Retrieve a slot
+	 *
+	 * @param pSlot slot index
+	 *
+	 * @return the slot
+	 */
+	GvUtils::GvBrickServerProtocol::Slot* getSlot( unsigned int pSlot );
+
+	/**
+	 * Serve a client request
+	 *
+	 * @param pClient the client
+	 * @param pRequest the request
+	 * @param pResponse the response
+	 */
+	void serve( Client& pClient, const GvUtils::GvBrickServerProtocol::Request& pRequest, GvUtils::GvBrickServerProtocol::Response& pResponse );
+
+	/**
+	 * Acquire a brick, loading it in a slot if needed
+	 *
+	 * @param pLevel level of resolution
+	 * @param pBrickAddress brick address in the brick files
+	 * @param pStatus the resulting status
+	 *
+	 * @return the slot index (GV_BRICK_SERVER_INVALID_SLOT on error)
+	 */
+	unsigned int acquire( unsigned int pLevel, unsigned int pBrickAddress, GvUtils::GvBrickServerProtocol::Status& pStatus );
+
+	/**
+	 * Release all references held by a client
+	 *
+	 * @param pClient the client
+	 */
+	void releaseAll( Client& pClient );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvbsBrickServer( const GvbsBrickServer& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvbsBrickServer& operator=( const GvbsBrickServer& );
+
+};
+
+} // namespace Gvbs
+
+#endif
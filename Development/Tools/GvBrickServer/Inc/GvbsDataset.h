@@ -0,0 +1,267 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#ifndef _GVBS_DATASET_H_
+#define _GVBS_DATASET_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include <GvVoxelizer/GvNodeSummary.h>
+
+// STL
+#include <string>
+#include <vector>
+#include <cstdio>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace Gvbs
+{
+
+/**
+ * @class GvbsDataset
+ *
+ * @brief The GvbsDataset class provides read access to a GigaVoxels dataset
+ * described by an XML file (as written by the voxelizer).
+ *
+ * Brick files are kept open while the dataset is open.
+ */
+class GvbsDataset
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Data channel description
+	 */
+	struct Channel
+	{
+		/**
+		 * Name and type name (i.e. "uchar4", "float", etc...)
+		 */
+		std::string _name;
+		std::string _typeName;
+
+		/**
+		 * Size of a voxel (in bytes)
+		 */
+		unsigned int _voxelSize;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvbsDataset();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvbsDataset();
+
+	/**
+	 * Open a dataset
+	 *
+	 * @param pFileName XML file describing the dataset
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool open( const std::string& pFileName );
+
+	/**
+	 * Close the dataset
+	 */
+	void close();
+
+	/**
+	 * Retrieve the number of levels of resolution
+	 *
+	 * @return the number of levels of resolution
+	 */
+	unsigned int getNbLevels() const;
+
+	/**
+	 * Retrieve the brick resolution (without borders)
+	 *
+	 * @return the brick resolution
+	 */
+	unsigned int getBrickResolution() const;
+
+	/**
+	 * Retrieve the brick border size
+	 *
+	 * @return the brick border size
+	 */
+	unsigned int getBorderSize() const;
+
+	/**
+	 * Retrieve the number of voxels of a brick (with borders)
+	 *
+	 * @return the number of voxels of a brick
+	 */
+	unsigned int getBrickNbVoxels() const;
+
+	/**
+	 * Retrieve the data channels
+	 *
+	 * @return the data channels
+	 */
+	const std::vector< Channel >& getChannels() const;
+
+	/**
+	 * Retrieve the number of nodes in each dimension at a given level
+	 *
+	 * @param pLevel level of resolution
+	 *
+	 * @return the number of nodes in each dimension
+	 */
+	unsigned int getNodeGridSize( unsigned int pLevel ) const;
+
+	/**
+	 * Read the nodes of a level of resolution
+	 *
+	 * @param pLevel level of resolution
+	 * @param pNodes the resulting nodes
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool readNodes( unsigned int pLevel, std::vector< unsigned int >& pNodes ) const;
+
+	/**
+	 * Read the node summaries of a level of resolution (they are optional)
+	 *
+	 * @param pLevel level of resolution
+	 * @param pSummaries the resulting node summaries
+	 *
+	 * @return a flag telling wheter or not summaries are available
+	 */
+	bool readSummaries( unsigned int pLevel, std::vector< GvVoxelizer::GvNodeSummary >& pSummaries ) const;
+
+	/**
+	 * Read a brick of a channel
+	 *
+	 * @param pLevel level of resolution
+	 * @param pChannel channel index
+	 * @param pBrickAddress brick address in the brick file (i.e. node & 0x3FFFFFFF)
+	 * @param pData the resulting brick data
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool readBrick( unsigned int pLevel, unsigned int pChannel, unsigned int pBrickAddress, void* pData );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Brick resolution (without borders) and border size
+	 */
+	unsigned int _brickResolution;
+	unsigned int _borderSize;
+
+	/**
+	 * Data channels
+	 */
+	std::vector< Channel > _channels;
+
+	/**
+	 * Node file names of each level
+	 */
+	std::vector< std::string > _nodeFileNames;
+
+	/**
+	 * Brick files of each level and channel (stored by level, then by channel)
+	 */
+	std::vector< std::string > _brickFileNames;
+	std::vector< FILE* > _brickFiles;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Retrieve the size of a data type given its name
+	 *
+	 * @param pTypeName data type name (i.e. "uchar4", "float", etc...)
+	 *
+	 * @return the size of the data type (0 if unknown)
+	 */
+	static unsigned int getTypeSize( const std::string& pTypeName );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvbsDataset( const GvbsDataset& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvbsDataset& operator=( const GvbsDataset& );
+
+};
+
+} // namespace Gvbs
+
+#endif
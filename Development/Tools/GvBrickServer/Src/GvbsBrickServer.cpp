@@ -0,0 +1,577 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#include "GvbsBrickServer.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvbsDataset.h"
+
+// GigaVoxels
+#include <GvVoxelizer/GvNodeSummary.h>
+
+// System
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+
+// STL
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// Project
+using namespace Gvbs;
+
+// GigaVoxels
+using namespace GvUtils;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Alignment of the shared memory sections (in bytes)
+ */
+static const size_t cSectionAlignment = 64;
+
+/**
+ * Alignment of the slots data (in bytes)
+ */
+static const size_t cDataAlignment = 4096;
+
+/**
+ * Timeout of the poll() loop (in milliseconds), used to check the stop flag
+ */
+static const int cPollTimeout = 250;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/**
+ * Stop flag
+ */
+volatile int GvbsBrickServer::_stopRequested = 0;
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Align a size
+ *
+ * @param pSize size
+ * @param pAlignment alignment
+ *
+ * @return the aligned size
+ ******************************************************************************/
+static size_t align( size_t pSize, size_t pAlignment )
+{
+	return ( pSize + pAlignment - 1 ) / pAlignment * pAlignment;
+}
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pDataset the dataset served (must be open)
+ ******************************************************************************/
+GvbsBrickServer::GvbsBrickServer( GvbsDataset& pDataset )
+:	_dataset( pDataset )
+,	_socketPath()
+,	_socket( -1 )
+,	_sharedMemoryName()
+,	_sharedMemory( NULL )
+,	_sharedMemorySize( 0 )
+,	_clients()
+,	_slotMap()
+,	_clock( 0 )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvbsBrickServer::~GvbsBrickServer()
+{
+	finalize();
+}
+
+/******************************************************************************
+ * Create the shared memory, load nodes and summaries, and listen on a Unix socket
+ *
+ * @param pSocketPath path of the Unix socket
+ * @param pNbSlots number of brick slots of the shared cache
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvbsBrickServer::initialize( const std::string& pSocketPath, unsigned int pNbSlots )
+{
+	const unsigned int nbLevels = _dataset.getNbLevels();
+	const std::vector< GvbsDataset::Channel >& channels = _dataset.getChannels();
+	if ( nbLevels == 0 || nbLevels > GV_BRICK_SERVER_MAX_LEVELS || channels.empty() || channels.size() > GV_BRICK_SERVER_MAX_CHANNELS || pNbSlots == 0 )
+	{
+		std::cerr << "GvbsBrickServer::initialize() : unsupported dataset (" << nbLevels << " levels, " << channels.size() << " channels) or number of slots" << std::endl;
+		return false;
+	}
+
+	// Read nodes and summaries
+	std::vector< std::vector< unsigned int > > nodes( nbLevels );
+	std::vector< std::vector< GvVoxelizer::GvNodeSummary > > summaries( nbLevels );
+	for ( unsigned int level = 0; level < nbLevels; level++ )
+	{
+		if ( ! _dataset.readNodes( level, nodes[ level ] ) )
+		{
+			return false;
+		}
+		if ( ! _dataset.readSummaries( level, summaries[ level ] ) )
+		{
+			summaries[ level ].clear();
+		}
+	}
+
+	// Compute the shared memory layout
+	GvBrickServerProtocol::Header header;
+	memset( &header, 0, sizeof( header ) );
+	header._magic = GV_BRICK_SERVER_MAGIC;
+	header._version = GV_BRICK_SERVER_VERSION;
+	header._brickResolution = _dataset.getBrickResolution();
+	header._borderSize = _dataset.getBorderSize();
+	header._nbLevels = nbLevels;
+	header._nbChannels = static_cast< unsigned int >( channels.size() );
+	header._brickNbVoxels = _dataset.getBrickNbVoxels();
+	size_t slotSize = 0;
+	for ( size_t channel = 0; channel < channels.size(); channel++ )
+	{
+		header._voxelSize[ channel ] = channels[ channel ]._voxelSize;
+		slotSize += static_cast< size_t >( channels[ channel ]._voxelSize ) * header._brickNbVoxels;
+	}
+	header._slotSize = static_cast< unsigned int >( align( slotSize, cSectionAlignment ) );
+	header._nbSlots = pNbSlots;
+
+	size_t offset = align( sizeof( header ), cSectionAlignment );
+	header._slotsOffset = offset;
+	offset = align( offset + pNbSlots * sizeof( GvBrickServerProtocol::Slot ), cSectionAlignment );
+	for ( unsigned int level = 0; level < nbLevels; level++ )
+	{
+		header._nodeGridSize[ level ] = _dataset.getNodeGridSize( level );
+		header._nodesOffset[ level ] = offset;
+		offset = align( offset + nodes[ level ].size() * sizeof( unsigned int ), cSectionAlignment );
+		if ( ! summaries[ level ].empty() )
+		{
+			header._summariesOffset[ level ] = offset;
+			offset = align( offset + summaries[ level ].size() * sizeof( GvVoxelizer::GvNodeSummary ), cSectionAlignment );
+		}
+	}
+	header._dataOffset = align( offset, cDataAlignment );
+	header._totalSize = header._dataOffset + static_cast< unsigned long long >( pNbSlots ) * header._slotSize;
+
+	// Create the shared memory
+	std::ostringstream sharedMemoryName;
+	sharedMemoryName << "/gvbrickserver_" << getpid();
+	_sharedMemoryName = sharedMemoryName.str();
+	int sharedMemoryFile = shm_open( _sharedMemoryName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644 );
+	if ( sharedMemoryFile < 0 )
+	{
+		std::cerr << "GvbsBrickServer::initialize() : unable to create shared memory " << _sharedMemoryName << " : " << strerror( errno ) << std::endl;
+		_sharedMemoryName.clear();
+		return false;
+	}
+	if ( ftruncate( sharedMemoryFile, static_cast< off_t >( header._totalSize ) ) != 0 )
+	{
+		std::cerr << "GvbsBrickServer::initialize() : unable to allocate " << header._totalSize << " bytes of shared memory : " << strerror( errno ) << std::endl;
+		close( sharedMemoryFile );
+		finalize();
+		return false;
+	}
+	void* sharedMemory = mmap( NULL, static_cast< size_t >( header._totalSize ), PROT_READ | PROT_WRITE, MAP_SHARED, sharedMemoryFile, 0 );
+	close( sharedMemoryFile );
+	if ( sharedMemory == MAP_FAILED )
+	{
+		std::cerr << "GvbsBrickServer::initialize() : unable to map shared memory : " << strerror( errno ) << std::endl;
+		finalize();
+		return false;
+	}
+	_sharedMemory = sharedMemory;
+	_sharedMemorySize = static_cast< size_t >( header._totalSize );
+
+	// Fill the shared memory (slots are zero-initialized, i.e. free)
+	char* data = static_cast< char* >( _sharedMemory );
+	memcpy( data, &header, sizeof( header ) );
+	for ( unsigned int level = 0; level < nbLevels; level++ )
+	{
+		memcpy( data + header._nodesOffset[ level ], &nodes[ level ][ 0 ], nodes[ level ].size() * sizeof( unsigned int ) );
+		if ( ! summaries[ level ].empty() )
+		{
+			memcpy( data + header._summariesOffset[ level ], &summaries[ level ][ 0 ], summaries[ level ].size() * sizeof( GvVoxelizer::GvNodeSummary ) );
+		}
+	}
+
+	// Listen on the Unix socket
+	sockaddr_un address;
+	memset( &address, 0, sizeof( address ) );
+	address.sun_family = AF_UNIX;
+	if ( pSocketPath.size() >= sizeof( address.sun_path ) )
+	{
+		std::cerr << "GvbsBrickServer::initialize() : socket path too long : " << pSocketPath << std::endl;
+		finalize();
+		return false;
+	}
+	strncpy( address.sun_path, pSocketPath.c_str(), sizeof( address.sun_path ) - 1 );
+	unlink( pSocketPath.c_str() );
+	_socket = socket( AF_UNIX, SOCK_STREAM, 0 );
+	if ( _socket < 0
+		|| bind( _socket, reinterpret_cast< sockaddr* >( &address ), sizeof( address ) ) != 0
+		|| listen( _socket, SOMAXCONN ) != 0 )
+	{
+		std::cerr << "GvbsBrickServer::initialize() : unable to listen on " << pSocketPath << " : " << strerror( errno ) << std::endl;
+		finalize();
+		return false;
+	}
+	_socketPath = pSocketPath;
+
+	// LOG
+	std::cout << "Shared memory " << _sharedMemoryName << " : " << ( header._totalSize >> 20 ) << " MB (" << pNbSlots << " slots of " << header._slotSize << " bytes)" << std::endl;
+
+	return true;
+}
+
+/******************************************************************************
+ * Remove the shared memory and the Unix socket
+ ******************************************************************************/
+void GvbsBrickServer::finalize()
+{
+	for ( size_t i = 0; i < _clients.size(); i++ )
+	{
+		close( _clients[ i ]._socket );
+	}
+	_clients.clear();
+	_slotMap.clear();
+
+	if ( _socket >= 0 )
+	{
+		close( _socket );
+		_socket = -1;
+	}
+	if ( ! _socketPath.empty() )
+	{
+		unlink( _socketPath.c_str() );
+		_socketPath.clear();
+	}
+
+	// Clients keep their mapping until they disconnect
+	if ( _sharedMemory != NULL )
+	{
+		munmap( _sharedMemory, _sharedMemorySize );
+		_sharedMemory = NULL;
+		_sharedMemorySize = 0;
+	}
+	if ( ! _sharedMemoryName.empty() )
+	{
+		shm_unlink( _sharedMemoryName.c_str() );
+		_sharedMemoryName.clear();
+	}
+}
+
+/******************************************************************************
+ * Serve clients until stop() is called
+ ******************************************************************************/
+void GvbsBrickServer::run()
+{
+	std::vector< pollfd > fileDescriptors;
+	while ( ! _stopRequested )
+	{
+		// Listening socket first, then one entry per client
+		fileDescriptors.resize( _clients.size() + 1 );
+		fileDescriptors[ 0 ].fd = _socket;
+		fileDescriptors[ 0 ].events = POLLIN;
+		fileDescriptors[ 0 ].revents = 0;
+		for ( size_t i = 0; i < _clients.size(); i++ )
+		{
+			fileDescriptors[ i + 1 ].fd = _clients[ i ]._socket;
+			fileDescriptors[ i + 1 ].events = POLLIN;
+			fileDescriptors[ i + 1 ].revents = 0;
+		}
+
+		const int result = poll( &fileDescriptors[ 0 ], fileDescriptors.size(), cPollTimeout );
+		if ( result < 0 )
+		{
+			if ( errno == EINTR )
+			{
+				continue;
+			}
+			std::cerr << "GvbsBrickServer::run() : poll failed : " << strerror( errno ) << std::endl;
+			break;
+		}
+
+		// Serve requests (iterate backward, so that disconnected clients can be removed)
+		for ( size_t i = fileDescriptors.size() - 1; i > 0; i-- )
+		{
+			if ( fileDescriptors[ i ].revents == 0 )
+			{
+				continue;
+			}
+
+			Client& client = _clients[ i - 1 ];
+			GvBrickServerProtocol::Request request;
+			GvBrickServerProtocol::Response response;
+			bool isConnected = ( recv( client._socket, &request, sizeof( request ), MSG_WAITALL ) == static_cast< ssize_t >( sizeof( request ) ) );
+			if ( isConnected )
+			{
+				serve( client, request, response );
+				isConnected = ( send( client._socket, &response, sizeof( response ), MSG_NOSIGNAL ) == static_cast< ssize_t >( sizeof( response ) ) );
+			}
+			if ( ! isConnected )
+			{
+				releaseAll( client );
+				close( client._socket );
+				_clients.erase( _clients.begin() + ( i - 1 ) );
+			}
+		}
+
+		// Accept new clients
+		if ( fileDescriptors[ 0 ].revents & POLLIN )
+		{
+			Client client;
+			client._socket = accept( _socket, NULL, NULL );
+			if ( client._socket >= 0 )
+			{
+				_clients.push_back( client );
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * Ask the server to stop (can be called from a signal handler)
+ ******************************************************************************/
+void GvbsBrickServer::stop()
+{
+	_stopRequested = 1;
+}
+
+/******************************************************************************
+ * Print statistics
+ ******************************************************************************/
+void GvbsBrickServer::printStatistics() const
+{
+	if ( _sharedMemory == NULL )
+	{
+		return;
+	}
+
+	const GvBrickServerProtocol::Header* header = static_cast< const GvBrickServerProtocol::Header* >( _sharedMemory );
+	std::cout << "Acquires : " << header->_nbAcquires
+				<< " - hits : " << header->_nbHits
+				<< " - misses : " << header->_nbMisses
+				<< " - evictions : " << header->_nbEvictions << std::endl;
+}
+
+/******************************************************************************
+ * Retrieve the shared memory header
+ *
+ * @return the header
+ ******************************************************************************/
+GvBrickServerProtocol::Header* GvbsBrickServer::getHeader()
+{
+	return static_cast< GvBrickServerProtocol::Header* >( _sharedMemory );
+}
+
+/******************************************************************************
+ * Retrieve a slot
+ *
+ * @param pSlot slot index
+ *
+ * @return the slot
+ ******************************************************************************/
+GvBrickServerProtocol::Slot* GvbsBrickServer::getSlot( unsigned int pSlot )
+{
+	return reinterpret_cast< GvBrickServerProtocol::Slot* >( static_cast< char* >( _sharedMemory ) + getHeader()->_slotsOffset ) + pSlot;
+}
+
+/******************************************************************************
+ * Serve a client request
+ *
+ * @param pClient the client
+ * @param pRequest the request
+ * @param pResponse the response
+ ******************************************************************************/
+void GvbsBrickServer::serve( Client& pClient, const GvBrickServerProtocol::Request& pRequest, GvBrickServerProtocol::Response& pResponse )
+{
+	memset( &pResponse, 0, sizeof( pResponse ) );
+	pResponse._status = GvBrickServerProtocol::eError;
+	pResponse._slot = GV_BRICK_SERVER_INVALID_SLOT;
+
+	switch ( pRequest._command )
+	{
+		case GvBrickServerProtocol::eHello:
+			pResponse._status = GvBrickServerProtocol::eOk;
+			strncpy( pResponse._sharedMemoryName, _sharedMemoryName.c_str(), GV_BRICK_SERVER_NAME_SIZE - 1 );
+			pResponse._sharedMemorySize = _sharedMemorySize;
+			break;
+
+		case GvBrickServerProtocol::eAcquire:
+			if ( pRequest._level < getHeader()->_nbLevels )
+			{
+				GvBrickServerProtocol::Status status;
+				pResponse._slot = acquire( pRequest._level, pRequest._nodeInfo & 0x3FFFFFFFU, status );
+				pResponse._status = status;
+				if ( status == GvBrickServerProtocol::eOk )
+				{
+					pClient._references[ pResponse._slot ]++;
+				}
+			}
+			break;
+
+		case GvBrickServerProtocol::eRelease:
+			{
+				std::map< unsigned int, unsigned int >::iterator reference = pClient._references.find( pRequest._slot );
+				if ( reference != pClient._references.end() )
+				{
+					getSlot( pRequest._slot )->_refCount--;
+					if ( --reference->second == 0 )
+					{
+						pClient._references.erase( reference );
+					}
+					pResponse._status = GvBrickServerProtocol::eOk;
+				}
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+/******************************************************************************
+ * Acquire a brick, loading it in a slot if needed
+ *
+ * @param pLevel level of resolution
+ * @param pBrickAddress brick address in the brick files
+ * @param pStatus the resulting status
+ *
+ * @return the slot index (GV_BRICK_SERVER_INVALID_SLOT on error)
+ ******************************************************************************/
+unsigned int GvbsBrickServer::acquire( unsigned int pLevel, unsigned int pBrickAddress, GvBrickServerProtocol::Status& pStatus )
+{
+	GvBrickServerProtocol::Header* header = getHeader();
+	header->_nbAcquires++;
+
+	// Hit : the brick is already in a slot
+	const unsigned long long key = ( static_cast< unsigned long long >( pLevel ) << 32 ) | pBrickAddress;
+	std::map< unsigned long long, unsigned int >::const_iterator slotIt = _slotMap.find( key );
+	if ( slotIt != _slotMap.end() )
+	{
+		GvBrickServerProtocol::Slot* slot = getSlot( slotIt->second );
+		slot->_refCount++;
+		slot->_lastUse = ++_clock;
+		header->_nbHits++;
+		pStatus = GvBrickServerProtocol::eOk;
+
+		return slotIt->second;
+	}
+
+	// Miss : use a free slot, or the least recently used slot that is not referenced
+	header->_nbMisses++;
+	unsigned int slotIndex = GV_BRICK_SERVER_INVALID_SLOT;
+	for ( unsigned int i = 0; i < header->_nbSlots; i++ )
+	{
+		const GvBrickServerProtocol::Slot* slot = getSlot( i );
+		if ( slot->_state == GvBrickServerProtocol::eFreeSlot )
+		{
+			slotIndex = i;
+			break;
+		}
+		if ( slot->_refCount == 0 && ( slotIndex == GV_BRICK_SERVER_INVALID_SLOT || slot->_lastUse < getSlot( slotIndex )->_lastUse ) )
+		{
+			slotIndex = i;
+		}
+	}
+	if ( slotIndex == GV_BRICK_SERVER_INVALID_SLOT )
+	{
+		// All slots are referenced : the client has to retry later
+		pStatus = GvBrickServerProtocol::eBusy;
+
+		return GV_BRICK_SERVER_INVALID_SLOT;
+	}
+
+	// Evict the previous brick
+	GvBrickServerProtocol::Slot* slot = getSlot( slotIndex );
+	if ( slot->_state == GvBrickServerProtocol::eReadySlot )
+	{
+		_slotMap.erase( ( static_cast< unsigned long long >( slot->_level ) << 32 ) | slot->_brickAddress );
+		header->_nbEvictions++;
+	}
+	slot->_state = GvBrickServerProtocol::eFreeSlot;
+
+	// Read all channels of the brick
+	for ( unsigned int channel = 0; channel < header->_nbChannels; channel++ )
+	{
+		void* data = static_cast< char* >( _sharedMemory ) + header->_dataOffset + static_cast< size_t >( slotIndex ) * header->_slotSize + GvBrickServerProtocol::getChannelOffset( header, channel );
+		if ( ! _dataset.readBrick( pLevel, channel, pBrickAddress, data ) )
+		{
+			pStatus = GvBrickServerProtocol::eError;
+
+			return GV_BRICK_SERVER_INVALID_SLOT;
+		}
+	}
+
+	slot->_level = pLevel;
+	slot->_brickAddress = pBrickAddress;
+	slot->_refCount = 1;
+	slot->_state = GvBrickServerProtocol::eReadySlot;
+	slot->_lastUse = ++_clock;
+	_slotMap[ key ] = slotIndex;
+	pStatus = GvBrickServerProtocol::eOk;
+
+	return slotIndex;
+}
+
+/******************************************************************************
+ * Release all references held by a client
+ *
+ * @param pClient the client
+ ******************************************************************************/
+void GvbsBrickServer::releaseAll( Client& pClient )
+{
+	for ( std::map< unsigned int, unsigned int >::const_iterator reference = pClient._references.begin(); reference != pClient._references.end(); ++reference )
+	{
+		getSlot( reference->first )->_refCount -= reference->second;
+	}
+	pClient._references.clear();
+}
@@ -0,0 +1,373 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#include "GvbsDataset.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include <GvVoxelizer/GvDataTypeHandler.h>
+#include <GvVoxelizer/GvDataStructureSummaryGenerator.h>
+
+// TinyXML
+#include <tinyxml.h>
+
+// STL
+#include <iostream>
+#include <cstdlib>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// Project
+using namespace Gvbs;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvbsDataset::GvbsDataset()
+:	_brickResolution( 0 )
+,	_borderSize( 0 )
+,	_channels()
+,	_nodeFileNames()
+,	_brickFileNames()
+,	_brickFiles()
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvbsDataset::~GvbsDataset()
+{
+	close();
+}
+
+/******************************************************************************
+ * Open a dataset
+ *
+ * @param pFileName XML file describing the dataset
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvbsDataset::open( const std::string& pFileName )
+{
+	close();
+
+	TiXmlDocument document( pFileName.c_str() );
+	if ( ! document.LoadFile() )
+	{
+		std::cerr << "GvbsDataset::open() : unable to load " << pFileName << std::endl;
+		return false;
+	}
+
+	// File names are relative to the "directory" attribute, itself relative to the XML file
+	const TiXmlElement* model = document.FirstChildElement( "Model" );
+	if ( model == NULL || model->Attribute( "directory" ) == NULL || model->Attribute( "nbLevels" ) == NULL )
+	{
+		std::cerr << "GvbsDataset::open() : invalid Model element in " << pFileName << std::endl;
+		return false;
+	}
+	std::string directory = pFileName.substr( 0, pFileName.find_last_of( "\\/" ) + 1 ) + model->Attribute( "directory" ) + "/";
+	const unsigned int nbLevels = static_cast< unsigned int >( atoi( model->Attribute( "nbLevels" ) ) );
+
+	// Node files
+	const TiXmlElement* nodeTree = model->FirstChildElement( "NodeTree" );
+	_nodeFileNames.resize( nbLevels );
+	for ( const TiXmlElement* level = nodeTree ? nodeTree->FirstChildElement( "Level" ) : NULL; level != NULL; level = level->NextSiblingElement( "Level" ) )
+	{
+		const unsigned int id = static_cast< unsigned int >( atoi( level->Attribute( "id" ) ? level->Attribute( "id" ) : "-1" ) );
+		if ( id < nbLevels && level->Attribute( "filename" ) != NULL )
+		{
+			_nodeFileNames[ id ] = directory + level->Attribute( "filename" );
+		}
+	}
+
+	// Brick files
+	const TiXmlElement* brickData = model->FirstChildElement( "BrickData" );
+	if ( brickData == NULL || brickData->Attribute( "brickResolution" ) == NULL || brickData->Attribute( "borderSize" ) == NULL )
+	{
+		std::cerr << "GvbsDataset::open() : invalid BrickData element in " << pFileName << std::endl;
+		return false;
+	}
+	_brickResolution = static_cast< unsigned int >( atoi( brickData->Attribute( "brickResolution" ) ) );
+	_borderSize = static_cast< unsigned int >( atoi( brickData->Attribute( "borderSize" ) ) );
+	if ( _borderSize == 0 )
+	{
+		// Borders of borderless bricks are reconstructed by the data loader, bricks are served as stored
+		std::cerr << "GvbsDataset::open() : borderless bricks are not supported in " << pFileName << std::endl;
+		return false;
+	}
+	std::vector< std::string > brickFileNames;
+	for ( const TiXmlElement* channel = brickData->FirstChildElement( "Channel" ); channel != NULL; channel = channel->NextSiblingElement( "Channel" ) )
+	{
+		Channel description;
+		description._name = channel->Attribute( "name" ) ? channel->Attribute( "name" ) : "";
+		description._typeName = channel->Attribute( "type" ) ? channel->Attribute( "type" ) : "";
+		description._voxelSize = getTypeSize( description._typeName );
+		if ( description._voxelSize == 0 )
+		{
+			std::cerr << "GvbsDataset::open() : unknown data type " << description._typeName << std::endl;
+			close();
+			return false;
+		}
+		_channels.push_back( description );
+
+		brickFileNames.resize( _channels.size() * nbLevels );
+		for ( const TiXmlElement* level = channel->FirstChildElement( "Level" ); level != NULL; level = level->NextSiblingElement( "Level" ) )
+		{
+			const unsigned int id = static_cast< unsigned int >( atoi( level->Attribute( "id" ) ? level->Attribute( "id" ) : "-1" ) );
+			if ( id < nbLevels && level->Attribute( "filename" ) != NULL )
+			{
+				brickFileNames[ ( _channels.size() - 1 ) * nbLevels + id ] = directory + level->Attribute( "filename" );
+			}
+		}
+	}
+
+	// Reorder brick files by level, then by channel, and open them
+	for ( unsigned int level = 0; level < nbLevels; level++ )
+	{
+		for ( size_t channel = 0; channel < _channels.size(); channel++ )
+		{
+			const std::string& fileName = brickFileNames[ channel * nbLevels + level ];
+			FILE* file = fileName.empty() ? NULL : fopen( fileName.c_str(), "rb" );
+			if ( file == NULL )
+			{
+				std::cerr << "GvbsDataset::open() : unable to open brick file " << fileName << " (level " << level << ", channel " << channel << ")" << std::endl;
+				close();
+				return false;
+			}
+			_brickFileNames.push_back( fileName );
+			_brickFiles.push_back( file );
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Close the dataset
+ ******************************************************************************/
+void GvbsDataset::close()
+{
+	for ( size_t i = 0; i < _brickFiles.size(); i++ )
+	{
+		fclose( _brickFiles[ i ] );
+	}
+	_brickFiles.clear();
+	_brickFileNames.clear();
+	_nodeFileNames.clear();
+	_channels.clear();
+}
+
+/******************************************************************************
+ * Retrieve the number of levels of resolution
+ *
+ * @return the number of levels of resolution
+ ******************************************************************************/
+unsigned int GvbsDataset::getNbLevels() const
+{
+	return static_cast< unsigned int >( _nodeFileNames.size() );
+}
+
+/******************************************************************************
+ * Retrieve the brick resolution (without borders)
+ *
+ * @return the brick resolution
+ ******************************************************************************/
+unsigned int GvbsDataset::getBrickResolution() const
+{
+	return _brickResolution;
+}
+
+/******************************************************************************
+ * Retrieve the brick border size
+ *
+ * @return the brick border size
+ ******************************************************************************/
+unsigned int GvbsDataset::getBorderSize() const
+{
+	return _borderSize;
+}
+
+/******************************************************************************
+ * Retrieve the number of voxels of a brick (with borders)
+ *
+ * @return the number of voxels of a brick
+ ******************************************************************************/
+unsigned int GvbsDataset::getBrickNbVoxels() const
+{
+	const unsigned int width = _brickResolution + 2 * _borderSize;
+
+	return width * width * width;
+}
+
+/******************************************************************************
+ * Retrieve the data channels
+ *
+ * @return the data channels
+ ******************************************************************************/
+const std::vector< GvbsDataset::Channel >& GvbsDataset::getChannels() const
+{
+	return _channels;
+}
+
+/******************************************************************************
+ * Retrieve the number of nodes in each dimension at a given level
+ *
+ * @param pLevel level of resolution
+ *
+ * @return the number of nodes in each dimension
+ ******************************************************************************/
+unsigned int GvbsDataset::getNodeGridSize( unsigned int pLevel ) const
+{
+	return 1U << pLevel;
+}
+
+/******************************************************************************
+ * Read the nodes of a level of resolution
+ *
+ * @param pLevel level of resolution
+ * @param pNodes the resulting nodes
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvbsDataset::readNodes( unsigned int pLevel, std::vector< unsigned int >& pNodes ) const
+{
+	const size_t gridSize = getNodeGridSize( pLevel );
+	pNodes.resize( gridSize * gridSize * gridSize );
+
+	FILE* file = fopen( _nodeFileNames[ pLevel ].c_str(), "rb" );
+	if ( file == NULL )
+	{
+		std::cerr << "GvbsDataset::readNodes() : unable to open node file " << _nodeFileNames[ pLevel ] << std::endl;
+		return false;
+	}
+	const bool result = ( fread( &pNodes[ 0 ], sizeof( unsigned int ), pNodes.size(), file ) == pNodes.size() );
+	fclose( file );
+
+	if ( ! result )
+	{
+		std::cerr << "GvbsDataset::readNodes() : unable to read node file " << _nodeFileNames[ pLevel ] << std::endl;
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * Read the node summaries of a level of resolution (they are optional)
+ *
+ * @param pLevel level of resolution
+ * @param pSummaries the resulting node summaries
+ *
+ * @return a flag telling wheter or not summaries are available
+ ******************************************************************************/
+bool GvbsDataset::readSummaries( unsigned int pLevel, std::vector< GvVoxelizer::GvNodeSummary >& pSummaries ) const
+{
+	// Summary file is stored alongside the node file, with ".summary" extension
+	std::string fileName = _nodeFileNames[ pLevel ];
+	const std::string::size_type extensionPosition = fileName.rfind( ".nodes" );
+	if ( extensionPosition != std::string::npos )
+	{
+		fileName.replace( extensionPosition, std::string( ".nodes" ).size(), ".summary" );
+	}
+	else
+	{
+		fileName += ".summary";
+	}
+
+	// Check that there is one summary per node and per channel
+	const size_t gridSize = getNodeGridSize( pLevel );
+	return GvVoxelizer::GvDataStructureSummaryGenerator::readSummaryFile( fileName, pSummaries )
+		&& pSummaries.size() == gridSize * gridSize * gridSize * _channels.size();
+}
+
+/******************************************************************************
+ * Read a brick of a channel
+ *
+ * @param pLevel level of resolution
+ * @param pChannel channel index
+ * @param pBrickAddress brick address in the brick file (i.e. node & 0x3FFFFFFF)
+ * @param pData the resulting brick data
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvbsDataset::readBrick( unsigned int pLevel, unsigned int pChannel, unsigned int pBrickAddress, void* pData )
+{
+	const size_t brickSize = static_cast< size_t >( getBrickNbVoxels() ) * _channels[ pChannel ]._voxelSize;
+	FILE* file = _brickFiles[ pLevel * _channels.size() + pChannel ];
+
+	// Position file pointer at position corresponding to the requested brick data
+#ifdef WIN32
+	_fseeki64( file, (__int64)pBrickAddress * brickSize, SEEK_SET );
+#else
+	fseeko( file, (off_t)pBrickAddress * brickSize, SEEK_SET );
+#endif
+	if ( fread( pData, 1, brickSize, file ) != brickSize )
+	{
+		std::cerr << "GvbsDataset::readBrick() : unable to read brick " << pBrickAddress << " in " << _brickFileNames[ pLevel * _channels.size() + pChannel ] << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Retrieve the size of a data type given its name
+ *
+ * @param pTypeName data type name (i.e. "uchar4", "float", etc...)
+ *
+ * @return the size of the data type (0 if unknown)
+ ******************************************************************************/
+unsigned int GvbsDataset::getTypeSize( const std::string& pTypeName )
+{
+	for ( int type = GvVoxelizer::GvDataTypeHandler::gvUCHAR; type <= GvVoxelizer::GvDataTypeHandler::gvFLOAT4; type++ )
+	{
+		const GvVoxelizer::GvDataTypeHandler::VoxelDataType dataType = static_cast< GvVoxelizer::GvDataTypeHandler::VoxelDataType >( type );
+		if ( GvVoxelizer::GvDataTypeHandler::getTypeName( dataType ) == pTypeName )
+		{
+			return GvVoxelizer::GvDataTypeHandler::canalByteSize( dataType );
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,264 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvbsDataset.h"
+#include "GvbsBrickServer.h"
+
+// GigaVoxels
+#include <GvUtils/GvBrickServerClient.h>
+
+// System
+#include <csignal>
+
+// STL
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// Project
+using namespace Gvbs;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Default number of brick slots
+ */
+static const unsigned int cDefaultNbSlots = 4096;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Signal handler used to stop the server
+ *
+ * @param pSignal signal
+ ******************************************************************************/
+static void onSignal( int /*pSignal*/ )
+{
+	GvbsBrickServer::stop();
+}
+
+/******************************************************************************
+ * Print usage
+ ******************************************************************************/
+static void printUsage()
+{
+	std::cout << "Usage :" << std::endl;
+	std::cout << "  GvBrickServer serve <dataset.xml> --socket <path> [--slots <n>]" << std::endl;
+	std::cout << "    serve a dataset to local viewers (stop with Ctrl+C)" << std::endl;
+	std::cout << "  GvBrickServer check <dataset.xml> --socket <path>" << std::endl;
+	std::cout << "    check all nodes and bricks served by a running server against the dataset files" << std::endl;
+}
+
+/******************************************************************************
+ * Serve a dataset
+ *
+ * @param pDataset the dataset
+ * @param pSocketPath path of the Unix socket
+ * @param pNbSlots number of brick slots
+ *
+ * @return exit code
+ ******************************************************************************/
+static int serve( GvbsDataset& pDataset, const std::string& pSocketPath, unsigned int pNbSlots )
+{
+	GvbsBrickServer server( pDataset );
+	if ( ! server.initialize( pSocketPath, pNbSlots ) )
+	{
+		return 3;
+	}
+
+	signal( SIGINT, onSignal );
+	signal( SIGTERM, onSignal );
+
+	// LOG
+	std::cout << "Listening on " << pSocketPath << std::endl;
+
+	server.run();
+
+	server.printStatistics();
+	server.finalize();
+
+	return 0;
+}
+
+/******************************************************************************
+ * Check all nodes and bricks served by a running server against the dataset files
+ *
+ * @param pDataset the dataset
+ * @param pSocketPath path of the Unix socket
+ *
+ * @return exit code
+ ******************************************************************************/
+static int check( GvbsDataset& pDataset, const std::string& pSocketPath )
+{
+	GvUtils::GvBrickServerClient client;
+	if ( ! client.connect( pSocketPath ) )
+	{
+		return 3;
+	}
+
+	const GvUtils::GvBrickServerProtocol::Header* header = client.getHeader();
+	const std::vector< GvbsDataset::Channel >& channels = pDataset.getChannels();
+	if ( header->_nbLevels != pDataset.getNbLevels() || header->_nbChannels != channels.size() || header->_brickNbVoxels != pDataset.getBrickNbVoxels() )
+	{
+		std::cerr << "The server does not serve this dataset" << std::endl;
+		return 4;
+	}
+
+	unsigned int nbNodeErrors = 0;
+	unsigned int nbBrickErrors = 0;
+	unsigned int nbBricks = 0;
+	std::vector< unsigned int > nodes;
+	std::vector< unsigned char > brick;
+	for ( unsigned int level = 0; level < pDataset.getNbLevels(); level++ )
+	{
+		if ( ! pDataset.readNodes( level, nodes ) )
+		{
+			return 5;
+		}
+
+		const unsigned int gridSize = pDataset.getNodeGridSize( level );
+		for ( unsigned int z = 0; z < gridSize; z++ )
+		for ( unsigned int y = 0; y < gridSize; y++ )
+		for ( unsigned int x = 0; x < gridSize; x++ )
+		{
+			const unsigned int node = nodes[ x + gridSize * ( y + gridSize * z ) ];
+			if ( client.getNode( level, x, y, z ) != node )
+			{
+				nbNodeErrors++;
+			}
+			if ( ! ( node & 0x40000000U ) )
+			{
+				continue;
+			}
+
+			// Compare each channel of the brick
+			nbBricks++;
+			const unsigned int slot = client.acquireBrick( level, node );
+			if ( slot == GV_BRICK_SERVER_INVALID_SLOT )
+			{
+				nbBrickErrors++;
+				continue;
+			}
+			for ( unsigned int channel = 0; channel < channels.size(); channel++ )
+			{
+				brick.resize( static_cast< size_t >( pDataset.getBrickNbVoxels() ) * channels[ channel ]._voxelSize );
+				if ( ! pDataset.readBrick( level, channel, node & 0x3FFFFFFFU, &brick[ 0 ] )
+					|| memcmp( &brick[ 0 ], client.getBrickData( slot, channel ), brick.size() ) != 0 )
+				{
+					nbBrickErrors++;
+					break;
+				}
+			}
+			client.releaseBrick( slot );
+		}
+	}
+
+	// LOG
+	std::cout << "Checked " << nbBricks << " bricks : " << nbNodeErrors << " node errors, " << nbBrickErrors << " brick errors" << std::endl;
+	std::cout << "Server acquires : " << header->_nbAcquires
+				<< " - hits : " << header->_nbHits
+				<< " - misses : " << header->_nbMisses
+				<< " - evictions : " << header->_nbEvictions << std::endl;
+
+	return ( nbNodeErrors == 0 && nbBrickErrors == 0 ) ? 0 : 6;
+}
+
+/******************************************************************************
+ * Main entry program
+ *
+ * @param pArgc number of arguments
+ * @param pArgv list of arguments
+ *
+ * @return exit code
+ ******************************************************************************/
+int main( int pArgc, char* pArgv[] )
+{
+	// LOG
+	std::cout << "--------------------------------------" << std::endl;
+	std::cout << "------ GigaVoxels Brick Server -------" << std::endl;
+	std::cout << "--------------------------------------" << std::endl;
+
+	// Parse command line
+	if ( pArgc < 3 )
+	{
+		printUsage();
+		return 1;
+	}
+	const std::string mode = pArgv[ 1 ];
+	const std::string fileName = pArgv[ 2 ];
+	std::string socketPath;
+	unsigned int nbSlots = cDefaultNbSlots;
+	for ( int i = 3; i < pArgc; i++ )
+	{
+		if ( strcmp( pArgv[ i ], "--socket" ) == 0 && i + 1 < pArgc )
+		{
+			socketPath = pArgv[ ++i ];
+		}
+		else if ( strcmp( pArgv[ i ], "--slots" ) == 0 && i + 1 < pArgc )
+		{
+			nbSlots = static_cast< unsigned int >( atoi( pArgv[ ++i ] ) );
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+	if ( socketPath.empty() || ( mode != "serve" && mode != "check" ) )
+	{
+		printUsage();
+		return 1;
+	}
+
+	// Open the dataset
+	GvbsDataset dataset;
+	if ( ! dataset.open( fileName ) )
+	{
+		return 2;
+	}
+
+	return ( mode == "serve" ) ? serve( dataset, socketPath, nbSlots ) : check( dataset, socketPath );
+}
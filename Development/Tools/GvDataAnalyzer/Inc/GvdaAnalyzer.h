@@ -0,0 +1,388 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GVDA_ANALYZER_H_
+#define _GVDA_ANALYZER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <string>
+#include <vector>
+#include <ostream>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+namespace Gvda
+{
+	class GvdaVolume;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace Gvda
+{
+
+/**
+ * @class GvdaAnalyzer
+ *
+ * @brief The GvdaAnalyzer class simulates data structure configurations
+ * (node tile resolution, brick resolution, stored border size) on a volume.
+ *
+ * For each configuration, it reports per-level occupied node tiles and bricks,
+ * empty and constant node ratios and bytes on disk. Then it replays a camera path
+ * (GvViewer camera path file, or an orbit around the volume) : at each view, nodes
+ * are refined until their voxels are smaller than a pixel, as the renderer does,
+ * and the bricks of the resulting cut go through an LRU data pool sized by the
+ * memory budget. This gives the pool pressure and an estimate of the number
+ * of requests and loaded bytes along the path.
+ *
+ * Visibility is only view frustum based (no occlusion), so request counts are upper bounds.
+ */
+class GvdaAnalyzer
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Data structure configuration
+	 */
+	struct Configuration
+	{
+		/**
+		 * Node tile resolution (2 for an octree)
+		 */
+		unsigned int _nodeTileResolution;
+
+		/**
+		 * Brick resolution (interior voxels)
+		 */
+		unsigned int _brickResolution;
+
+		/**
+		 * Border size of stored bricks (0 for borderless datasets, borders are then rebuilt at load time)
+		 */
+		unsigned int _borderSize;
+	};
+
+	/**
+	 * Statistics of a level of the data structure
+	 */
+	struct LevelStatistics
+	{
+		/**
+		 * Number of node tiles
+		 */
+		unsigned int _nbNodeTiles;
+
+		/**
+		 * Number of nodes
+		 */
+		unsigned int _nbNodes;
+
+		/**
+		 * Number of empty nodes (no brick)
+		 */
+		unsigned int _nbEmptyNodes;
+
+		/**
+		 * Number of constant nodes (terminal, their brick has a single value)
+		 */
+		unsigned int _nbConstantNodes;
+
+		/**
+		 * Number of bricks (constant nodes included)
+		 */
+		unsigned int _nbBricks;
+
+		/**
+		 * Size of the ".nodes" file
+		 */
+		unsigned long long _nodeFileSize;
+
+		/**
+		 * Size of the ".bricks" files
+		 */
+		unsigned long long _brickFileSize;
+	};
+
+	/**
+	 * Simulation report of a configuration
+	 */
+	struct Report
+	{
+		/**
+		 * Configuration
+		 */
+		Configuration _configuration;
+
+		/**
+		 * Max depth of the data structure
+		 */
+		unsigned int _maxDepth;
+
+		/**
+		 * Resolution of the finest level (voxels)
+		 */
+		unsigned int _resolution;
+
+		/**
+		 * Statistics of each level
+		 */
+		std::vector< LevelStatistics > _levels;
+
+		/**
+		 * Size of the dataset on disk
+		 */
+		unsigned long long _diskSize;
+
+		/**
+		 * Max number of bricks used by a view
+		 */
+		unsigned int _peakNbBricks;
+
+		/**
+		 * Max number of node tiles used by a view
+		 */
+		unsigned int _peakNbNodeTiles;
+
+		/**
+		 * Memory needed by the largest view (node pool and data pool)
+		 */
+		unsigned long long _peakMemorySize;
+
+		/**
+		 * Number of bricks of the data pool fitting in the memory budget
+		 */
+		unsigned int _poolCapacity;
+
+		/**
+		 * Number of brick requests along the camera path
+		 */
+		unsigned int _nbRequests;
+
+		/**
+		 * Number of bytes read along the camera path
+		 */
+		unsigned long long _loadedSize;
+	};
+
+	/**
+	 * View of a camera path (in the normalized space of the volume)
+	 */
+	struct View
+	{
+		/**
+		 * Camera position
+		 */
+		float _position[ 3 ];
+
+		/**
+		 * View direction (unit vector)
+		 */
+		float _direction[ 3 ];
+
+		/**
+		 * Vertical field of view (in radians)
+		 */
+		float _fieldOfView;
+
+		/**
+		 * Aspect ratio (width / height)
+		 */
+		float _aspectRatio;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pVolume the volume to analyze
+	 */
+	GvdaAnalyzer( const GvdaVolume& pVolume );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvdaAnalyzer();
+
+	/**
+	 * Set the memory budget of the node and data pools
+	 *
+	 * @param pSize the memory budget (in bytes)
+	 */
+	void setMemoryBudget( unsigned long long pSize );
+
+	/**
+	 * Set the viewport height
+	 *
+	 * @param pHeight the viewport height (in pixels)
+	 */
+	void setViewportHeight( unsigned int pHeight );
+
+	/**
+	 * Load the views of a GvViewer camera path file.
+	 * The transformation of the GigaVoxels object found in the file is taken into account.
+	 *
+	 * @param pFileName the camera path file
+	 * @param pNbSteps number of views per key frame interval
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool loadCameraPath( const std::string& pFileName, unsigned int pNbSteps );
+
+	/**
+	 * Create views orbiting around the volume
+	 *
+	 * @param pNbViews number of views
+	 */
+	void createOrbit( unsigned int pNbViews );
+
+	/**
+	 * Simulate a configuration
+	 *
+	 * @param pConfiguration the configuration
+	 *
+	 * @return the simulation report
+	 */
+	Report analyze( const Configuration& pConfiguration ) const;
+
+	/**
+	 * Select the recommended configuration : among configurations reaching the best resolution
+	 * and fitting in the memory budget, the one loading the fewest bytes along the camera path
+	 *
+	 * @param pReports reports of the simulated configurations
+	 * @param pFitsBudget a flag telling wheter or not the recommended configuration fits in the memory budget
+	 *
+	 * @return index of the recommended configuration
+	 */
+	size_t recommend( const std::vector< Report >& pReports, bool& pFitsBudget ) const;
+
+	/**
+	 * Print a simulation report
+	 *
+	 * @param pReport the simulation report
+	 * @param pStream the stream where to write
+	 */
+	void print( const Report& pReport, std::ostream& pStream ) const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Volume to analyze
+	 */
+	const GvdaVolume& _volume;
+
+	/**
+	 * Views of the camera path
+	 */
+	std::vector< View > _views;
+
+	/**
+	 * Memory budget of the node and data pools
+	 */
+	unsigned long long _memoryBudget;
+
+	/**
+	 * Viewport height (in pixels)
+	 */
+	unsigned int _viewportHeight;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Select the nodes used to render a view
+	 *
+	 * @param pConfiguration the configuration
+	 * @param pMaxDepth max depth of the data structure
+	 * @param pView the view
+	 * @param pDepth depth of the node tile
+	 * @param pTile position of the first node of the node tile
+	 * @param pBricks keys of the bricks used by the view
+	 * @param pNbNodeTiles number of node tiles used by the view
+	 */
+	void selectNodes( const Configuration& pConfiguration, unsigned int pMaxDepth, const View& pView,
+						unsigned int pDepth, const unsigned int pTile[ 3 ],
+						std::vector< unsigned long long >& pBricks, unsigned int& pNbNodeTiles ) const;
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvdaAnalyzer( const GvdaAnalyzer& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvdaAnalyzer& operator=( const GvdaAnalyzer& );
+
+};
+
+} // namespace Gvda
+
+#endif
@@ -0,0 +1,252 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GVDA_VOLUME_H_
+#define _GVDA_VOLUME_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace Gvda
+{
+
+/**
+ * @class GvdaVolume
+ *
+ * @brief The GvdaVolume class provides a classification pyramid of a volume,
+ * used to simulate data structure configurations without any brick data.
+ *
+ * The volume is loaded at a cubic power of two resolution (padded with empty voxels),
+ * and each voxel is replaced by a 32 bits signature of its value : 0 for empty voxels,
+ * cVariedValue for a region whose voxels are not all equal. Coarser levels of the
+ * pyramid are built by merging 2x2x2 regions, so the signature of any node of any
+ * N-Tree tells wheter it is empty, constant or has to be subdivided.
+ *
+ * Volumes come either from a RAW file, or from the finest level of an existing
+ * dataset (first channel) fitting in the analysis resolution.
+ */
+class GvdaVolume
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Special signatures
+	 */
+	enum
+	{
+		cEmptyValue = 0x00000000U,
+		cVariedValue = 0xFFFFFFFFU
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvdaVolume();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvdaVolume();
+
+	/**
+	 * Load a RAW file (voxels stored X axis first, then Y axis, then Z axis)
+	 *
+	 * @param pFileName the RAW file
+	 * @param pWidth number of voxels along X axis
+	 * @param pHeight number of voxels along Y axis
+	 * @param pDepth number of voxels along Z axis
+	 * @param pTypeName type of voxels (uchar, uchar4, ushort, float, float4)
+	 * @param pMaxResolution max analysis resolution (the volume is downsampled above)
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool loadRAW( const std::string& pFileName, unsigned int pWidth, unsigned int pHeight, unsigned int pDepth,
+					const std::string& pTypeName, unsigned int pMaxResolution );
+
+	/**
+	 * Load the finest level of a dataset fitting in the analysis resolution
+	 *
+	 * @param pXMLFileName XML file describing the dataset
+	 * @param pMaxResolution max analysis resolution
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool loadDataset( const std::string& pXMLFileName, unsigned int pMaxResolution );
+
+	/**
+	 * Get the analysis resolution (number of voxels along each axis of the finest level)
+	 *
+	 * @return the analysis resolution
+	 */
+	unsigned int getResolution() const;
+
+	/**
+	 * Get the signature of a region
+	 *
+	 * @param pResolution resolution of the pyramid level (power of two, up to getResolution())
+	 * @param pX region position along X axis
+	 * @param pY region position along Y axis
+	 * @param pZ region position along Z axis
+	 *
+	 * @return the signature of the region
+	 */
+	unsigned int get( unsigned int pResolution, unsigned int pX, unsigned int pY, unsigned int pZ ) const;
+
+	/**
+	 * Get the size of a voxel, over all its data channels
+	 *
+	 * @return the size of a voxel (in bytes)
+	 */
+	unsigned int getVoxelSize() const;
+
+	/**
+	 * Get the size of a voxel data type
+	 *
+	 * @param pTypeName type of voxels (uchar, uchar4, ushort, float, float4, half4)
+	 *
+	 * @return the size of the type (in bytes), 0 if the type is unknown
+	 */
+	static unsigned int getTypeSize( const std::string& pTypeName );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Signature of a region not filled yet
+	 */
+	enum
+	{
+		cUnsetValue = 0xFFFFFFFEU
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Pyramid levels, from resolution 1 to the analysis resolution
+	 */
+	std::vector< std::vector< unsigned int > > _levels;
+
+	/**
+	 * Size of a voxel, over all its data channels
+	 */
+	unsigned int _voxelSize;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Allocate the pyramid for a given analysis resolution
+	 *
+	 * @param pResolution the analysis resolution (power of two)
+	 */
+	void allocate( unsigned int pResolution );
+
+	/**
+	 * Build the coarser levels of the pyramid from its finest level
+	 */
+	void buildPyramid();
+
+	/**
+	 * Compute the signature of a voxel value
+	 *
+	 * @param pData the voxel value
+	 * @param pSize the size of the voxel value (in bytes)
+	 *
+	 * @return the signature
+	 */
+	static unsigned int getSignature( const unsigned char* pData, unsigned int pSize );
+
+	/**
+	 * Merge a signature in the signature of a region
+	 *
+	 * @param pRegion the signature of the region
+	 * @param pValue the signature to merge
+	 */
+	static void merge( unsigned int& pRegion, unsigned int pValue );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvdaVolume( const GvdaVolume& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvdaVolume& operator=( const GvdaVolume& );
+
+};
+
+} // namespace Gvda
+
+#endif
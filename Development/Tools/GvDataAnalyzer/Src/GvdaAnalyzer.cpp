@@ -0,0 +1,691 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvdaAnalyzer.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvdaVolume.h"
+
+// STL
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <cmath>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// Project
+using namespace Gvda;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Header of GvViewer camera path files
+ */
+static const char* cCameraPathHeader = "GvViewer camera path 1";
+
+/**
+ * Default viewport height (in pixels)
+ */
+static const unsigned int cDefaultViewportHeight = 768;
+
+/**
+ * Distance of orbit views to the center of the volume, and their height above it
+ */
+static const float cOrbitRadius = 1.5f;
+static const float cOrbitHeight = 0.3f;
+
+/**
+ * Field of view of orbit views (60 degrees)
+ */
+static const float cOrbitFieldOfView = 1.0471976f;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Compute an integer power
+ *
+ * @param pValue the value
+ * @param pExponent the exponent
+ *
+ * @return the power
+ ******************************************************************************/
+static unsigned long long power( unsigned int pValue, unsigned int pExponent )
+{
+	unsigned long long result = 1;
+	for ( unsigned int i = 0; i < pExponent; i++ )
+	{
+		result *= pValue;
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * Rotate a vector around an axis (Rodrigues formula)
+ *
+ * @param pVector the vector
+ * @param pAngle the angle (in radians)
+ * @param pAxis the axis (unit vector)
+ ******************************************************************************/
+static void rotate( float pVector[ 3 ], float pAngle, const float pAxis[ 3 ] )
+{
+	const float c = cosf( pAngle );
+	const float s = sinf( pAngle );
+	const float dot = pVector[ 0 ] * pAxis[ 0 ] + pVector[ 1 ] * pAxis[ 1 ] + pVector[ 2 ] * pAxis[ 2 ];
+	const float cross[ 3 ] =
+	{
+		pAxis[ 1 ] * pVector[ 2 ] - pAxis[ 2 ] * pVector[ 1 ],
+		pAxis[ 2 ] * pVector[ 0 ] - pAxis[ 0 ] * pVector[ 2 ],
+		pAxis[ 0 ] * pVector[ 1 ] - pAxis[ 1 ] * pVector[ 0 ]
+	};
+	for ( unsigned int i = 0; i < 3; i++ )
+	{
+		pVector[ i ] = pVector[ i ] * c + cross[ i ] * s + pAxis[ i ] * dot * ( 1.0f - c );
+	}
+}
+
+/******************************************************************************
+ * Normalize a vector
+ *
+ * @param pVector the vector
+ ******************************************************************************/
+static void normalize( float* pVector, unsigned int pSize )
+{
+	float length = 0.0f;
+	for ( unsigned int i = 0; i < pSize; i++ )
+	{
+		length += pVector[ i ] * pVector[ i ];
+	}
+	length = sqrtf( length );
+	if ( length > 0.0f )
+	{
+		for ( unsigned int i = 0; i < pSize; i++ )
+		{
+			pVector[ i ] /= length;
+		}
+	}
+}
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pVolume the volume to analyze
+ ******************************************************************************/
+GvdaAnalyzer::GvdaAnalyzer( const GvdaVolume& pVolume )
+:	_volume( pVolume )
+,	_views()
+,	_memoryBudget( 512ULL << 20 )
+,	_viewportHeight( cDefaultViewportHeight )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvdaAnalyzer::~GvdaAnalyzer()
+{
+}
+
+/******************************************************************************
+ * Set the memory budget of the node and data pools
+ *
+ * @param pSize the memory budget (in bytes)
+ ******************************************************************************/
+void GvdaAnalyzer::setMemoryBudget( unsigned long long pSize )
+{
+	_memoryBudget = pSize;
+}
+
+/******************************************************************************
+ * Set the viewport height
+ *
+ * @param pHeight the viewport height (in pixels)
+ ******************************************************************************/
+void GvdaAnalyzer::setViewportHeight( unsigned int pHeight )
+{
+	_viewportHeight = ( pHeight > 0 ) ? pHeight : cDefaultViewportHeight;
+}
+
+/******************************************************************************
+ * Load the views of a GvViewer camera path file.
+ * The transformation of the GigaVoxels object found in the file is taken into account.
+ *
+ * @param pFileName the camera path file
+ * @param pNbSteps number of views per key frame interval
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvdaAnalyzer::loadCameraPath( const std::string& pFileName, unsigned int pNbSteps )
+{
+	std::ifstream file( pFileName.c_str() );
+	std::string line;
+	if ( ! file.is_open() || ! std::getline( file, line ) || line.compare( 0, std::string( cCameraPathHeader ).size(), cCameraPathHeader ) != 0 )
+	{
+		std::cerr << "GvdaAnalyzer::loadCameraPath() : " << pFileName << " is not a camera path file" << std::endl;
+		return false;
+	}
+
+	// Object transformation (rotation, then scale, then translation, as in GvViewer)
+	float translation[ 3 ] = { 0.0f, 0.0f, 0.0f };
+	float rotation[ 4 ] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	float scale = 1.0f;
+
+	// Key frames : position, orientation (x, y, z, w), field of view, aspect ratio
+	std::vector< std::vector< float > > keyFrames;
+	while ( std::getline( file, line ) )
+	{
+		std::istringstream stream( line );
+		std::string tag;
+		if ( ! ( stream >> tag ) )
+		{
+			continue;
+		}
+
+		if ( tag == "keyframe" )
+		{
+			float time;
+			std::vector< float > keyFrame( 9 );
+			stream >> time;
+			for ( unsigned int i = 0; i < keyFrame.size(); i++ )
+			{
+				stream >> keyFrame[ i ];
+			}
+			if ( stream )
+			{
+				keyFrames.push_back( keyFrame );
+			}
+		}
+		else if ( tag == "setting" )
+		{
+			std::string name;
+			stream >> name;
+			if ( name == "translation" )
+			{
+				stream >> translation[ 0 ] >> translation[ 1 ] >> translation[ 2 ];
+			}
+			else if ( name == "rotation" )
+			{
+				stream >> rotation[ 0 ] >> rotation[ 1 ] >> rotation[ 2 ] >> rotation[ 3 ];
+			}
+			else if ( name == "scale" )
+			{
+				stream >> scale;
+			}
+			else if ( name == "viewportSize" )
+			{
+				unsigned int width = 0;
+				unsigned int height = 0;
+				if ( stream >> width >> height )
+				{
+					setViewportHeight( height );
+				}
+			}
+		}
+	}
+	if ( keyFrames.empty() )
+	{
+		std::cerr << "GvdaAnalyzer::loadCameraPath() : no key frame in " << pFileName << std::endl;
+		return false;
+	}
+	normalize( &rotation[ 1 ], 3 );
+	const float angle = -rotation[ 0 ] * 3.14159265f / 180.0f;
+	if ( scale <= 0.0f )
+	{
+		scale = 1.0f;
+	}
+
+	// Interpolate key frames, then move views in the normalized space of the volume
+	_views.clear();
+	const unsigned int nbSteps = ( pNbSteps > 0 ) ? pNbSteps : 1;
+	for ( size_t k = 0; k < keyFrames.size(); k++ )
+	{
+		const std::vector< float >& current = keyFrames[ k ];
+		const std::vector< float >& next = keyFrames[ ( k + 1 < keyFrames.size() ) ? k + 1 : k ];
+		const unsigned int nbViews = ( k + 1 < keyFrames.size() ) ? nbSteps : 1;
+
+		// Shortest path between orientations
+		const float sign = ( current[ 3 ] * next[ 3 ] + current[ 4 ] * next[ 4 ] + current[ 5 ] * next[ 5 ] + current[ 6 ] * next[ 6 ] < 0.0f ) ? -1.0f : 1.0f;
+
+		for ( unsigned int step = 0; step < nbViews; step++ )
+		{
+			const float t = static_cast< float >( step ) / static_cast< float >( nbSteps );
+			float frame[ 9 ];
+			for ( unsigned int i = 0; i < 9; i++ )
+			{
+				const float nextValue = ( i >= 3 && i < 7 ) ? sign * next[ i ] : next[ i ];
+				frame[ i ] = current[ i ] + t * ( nextValue - current[ i ] );
+			}
+			normalize( &frame[ 3 ], 4 );
+
+			// Cameras look along -Z : d = q * ( 0, 0, -1 ) * q^-1
+			const float* q = &frame[ 3 ];
+			View view;
+			view._direction[ 0 ] = -2.0f * ( q[ 0 ] * q[ 2 ] + q[ 3 ] * q[ 1 ] );
+			view._direction[ 1 ] = -2.0f * ( q[ 1 ] * q[ 2 ] - q[ 3 ] * q[ 0 ] );
+			view._direction[ 2 ] = -1.0f + 2.0f * ( q[ 0 ] * q[ 0 ] + q[ 1 ] * q[ 1 ] );
+			view._position[ 0 ] = frame[ 0 ];
+			view._position[ 1 ] = frame[ 1 ];
+			view._position[ 2 ] = frame[ 2 ];
+
+			// Inverse object transformation
+			rotate( view._position, angle, &rotation[ 1 ] );
+			rotate( view._direction, angle, &rotation[ 1 ] );
+			normalize( view._direction, 3 );
+			for ( unsigned int i = 0; i < 3; i++ )
+			{
+				view._position[ i ] = view._position[ i ] / scale - translation[ i ];
+			}
+
+			view._fieldOfView = frame[ 7 ];
+			view._aspectRatio = ( frame[ 8 ] > 0.0f ) ? frame[ 8 ] : 1.0f;
+			_views.push_back( view );
+		}
+	}
+
+	// LOG
+	std::cout << "Loaded " << keyFrames.size() << " key frames from " << pFileName << " ( " << _views.size() << " views )" << std::endl;
+
+	return true;
+}
+
+/******************************************************************************
+ * Create views orbiting around the volume
+ *
+ * @param pNbViews number of views
+ ******************************************************************************/
+void GvdaAnalyzer::createOrbit( unsigned int pNbViews )
+{
+	_views.clear();
+	for ( unsigned int i = 0; i < pNbViews; i++ )
+	{
+		const float angle = 2.0f * 3.14159265f * static_cast< float >( i ) / static_cast< float >( pNbViews );
+
+		View view;
+		view._position[ 0 ] = 0.5f + cOrbitRadius * cosf( angle );
+		view._position[ 1 ] = 0.5f + cOrbitHeight;
+		view._position[ 2 ] = 0.5f + cOrbitRadius * sinf( angle );
+		for ( unsigned int j = 0; j < 3; j++ )
+		{
+			view._direction[ j ] = 0.5f - view._position[ j ];
+		}
+		normalize( view._direction, 3 );
+		view._fieldOfView = cOrbitFieldOfView;
+		view._aspectRatio = 1.0f;
+		_views.push_back( view );
+	}
+}
+
+/******************************************************************************
+ * Simulate a configuration
+ *
+ * @param pConfiguration the configuration
+ *
+ * @return the simulation report
+ ******************************************************************************/
+GvdaAnalyzer::Report GvdaAnalyzer::analyze( const Configuration& pConfiguration ) const
+{
+	Report report;
+	report._configuration = pConfiguration;
+	report._maxDepth = 0;
+	report._resolution = 0;
+	report._diskSize = 0;
+	report._peakNbBricks = 0;
+	report._peakNbNodeTiles = 0;
+	report._peakMemorySize = 0;
+	report._poolCapacity = 0;
+	report._nbRequests = 0;
+	report._loadedSize = 0;
+
+	// The finest level can't be finer than the analysis resolution
+	const unsigned int tileResolution = pConfiguration._nodeTileResolution;
+	const unsigned int brickResolution = pConfiguration._brickResolution;
+	const unsigned long long resolution = _volume.getResolution();
+	if ( static_cast< unsigned long long >( tileResolution ) * brickResolution > resolution )
+	{
+		return report;
+	}
+	while ( power( tileResolution, report._maxDepth + 2 ) * brickResolution <= resolution )
+	{
+		report._maxDepth++;
+	}
+	report._resolution = static_cast< unsigned int >( power( tileResolution, report._maxDepth + 1 ) * brickResolution );
+
+	// Stored bricks may be borderless, bricks in the data pool always have a border
+	const unsigned long long storedBrickWidth = brickResolution + 2 * pConfiguration._borderSize;
+	const unsigned long long storedBrickSize = storedBrickWidth * storedBrickWidth * storedBrickWidth * _volume.getVoxelSize();
+	const unsigned long long poolBrickSize = power( brickResolution + 2, 3 ) * _volume.getVoxelSize();
+	const unsigned long long nodeTileSize = power( tileResolution, 3 ) * 2 * sizeof( unsigned int );
+
+	// -------- Levels --------
+
+	for ( unsigned int depth = 0; depth <= report._maxDepth; depth++ )
+	{
+		const unsigned int nbNodes = static_cast< unsigned int >( power( tileResolution, depth + 1 ) );
+		const unsigned int nbParents = nbNodes / tileResolution;
+
+		LevelStatistics statistics;
+		statistics._nbNodeTiles = 0;
+		statistics._nbNodes = 0;
+		statistics._nbEmptyNodes = 0;
+		statistics._nbConstantNodes = 0;
+
+		// Nodes of a level are the children of the subdivided nodes of the previous level
+		for ( unsigned int pz = 0; pz < nbParents; pz++ )
+		{
+			for ( unsigned int py = 0; py < nbParents; py++ )
+			{
+				for ( unsigned int px = 0; px < nbParents; px++ )
+				{
+					if ( depth > 0 && _volume.get( nbParents, px, py, pz ) != GvdaVolume::cVariedValue )
+					{
+						continue;
+					}
+
+					statistics._nbNodeTiles++;
+					for ( unsigned int z = pz * tileResolution; z < ( pz + 1 ) * tileResolution; z++ )
+					{
+						for ( unsigned int y = py * tileResolution; y < ( py + 1 ) * tileResolution; y++ )
+						{
+							for ( unsigned int x = px * tileResolution; x < ( px + 1 ) * tileResolution; x++ )
+							{
+								const unsigned int value = _volume.get( nbNodes, x, y, z );
+								statistics._nbNodes++;
+								if ( value == GvdaVolume::cEmptyValue )
+								{
+									statistics._nbEmptyNodes++;
+								}
+								else if ( value != GvdaVolume::cVariedValue )
+								{
+									statistics._nbConstantNodes++;
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		// Node files are dense grids, empty nodes have no brick
+		statistics._nbBricks = statistics._nbNodes - statistics._nbEmptyNodes;
+		statistics._nodeFileSize = power( nbNodes, 3 ) * sizeof( unsigned int );
+		statistics._brickFileSize = statistics._nbBricks * storedBrickSize;
+		report._diskSize += statistics._nodeFileSize + statistics._brickFileSize;
+
+		report._levels.push_back( statistics );
+	}
+
+	// -------- Camera path --------
+
+	const unsigned int root[ 3 ] = { 0, 0, 0 };
+	std::vector< unsigned long long > bricks;
+
+	// The node pool is sized for the largest view, the data pool gets the rest of the budget
+	for ( size_t v = 0; v < _views.size(); v++ )
+	{
+		unsigned int nbNodeTiles = 0;
+		bricks.clear();
+		selectNodes( pConfiguration, report._maxDepth, _views[ v ], 0, root, bricks, nbNodeTiles );
+
+		report._peakNbBricks = std::max( report._peakNbBricks, static_cast< unsigned int >( bricks.size() ) );
+		report._peakNbNodeTiles = std::max( report._peakNbNodeTiles, nbNodeTiles );
+	}
+	report._peakMemorySize = report._peakNbNodeTiles * nodeTileSize + report._peakNbBricks * poolBrickSize;
+	const unsigned long long nodePoolSize = report._peakNbNodeTiles * nodeTileSize;
+	report._poolCapacity = ( _memoryBudget > nodePoolSize ) ? static_cast< unsigned int >( ( _memoryBudget - nodePoolSize ) / poolBrickSize ) : 0;
+
+	// LRU data pool : brick key -> last use, and bricks ordered by last use
+	std::map< unsigned long long, unsigned int > pool;
+	std::set< std::pair< unsigned int, unsigned long long > > usage;
+	for ( size_t v = 0; v < _views.size(); v++ )
+	{
+		unsigned int nbNodeTiles = 0;
+		bricks.clear();
+		selectNodes( pConfiguration, report._maxDepth, _views[ v ], 0, root, bricks, nbNodeTiles );
+
+		const unsigned int frame = static_cast< unsigned int >( v );
+		for ( size_t b = 0; b < bricks.size(); b++ )
+		{
+			std::map< unsigned long long, unsigned int >::iterator brick = pool.find( bricks[ b ] );
+			if ( brick != pool.end() )
+			{
+				usage.erase( std::make_pair( brick->second, brick->first ) );
+				brick->second = frame;
+				usage.insert( std::make_pair( frame, brick->first ) );
+				continue;
+			}
+
+			report._nbRequests++;
+			report._loadedSize += storedBrickSize;
+			if ( report._poolCapacity == 0 )
+			{
+				continue;
+			}
+
+			// Evict the least recently used brick (possibly one of this view when the pool is too small)
+			if ( pool.size() >= report._poolCapacity )
+			{
+				pool.erase( usage.begin()->second );
+				usage.erase( usage.begin() );
+			}
+			pool[ bricks[ b ] ] = frame;
+			usage.insert( std::make_pair( frame, bricks[ b ] ) );
+		}
+	}
+
+	return report;
+}
+
+/******************************************************************************
+ * Select the recommended configuration : among configurations reaching the best resolution
+ * and fitting in the memory budget, the one loading the fewest bytes along the camera path
+ *
+ * @param pReports reports of the simulated configurations
+ * @param pFitsBudget a flag telling wheter or not the recommended configuration fits in the memory budget
+ *
+ * @return index of the recommended configuration
+ ******************************************************************************/
+size_t GvdaAnalyzer::recommend( const std::vector< Report >& pReports, bool& pFitsBudget ) const
+{
+	unsigned int bestResolution = 0;
+	for ( size_t i = 0; i < pReports.size(); i++ )
+	{
+		bestResolution = std::max( bestResolution, pReports[ i ]._resolution );
+	}
+
+	// Configurations not fitting in the budget are only candidates when no configuration fits
+	size_t result = pReports.size();
+	pFitsBudget = false;
+	for ( size_t i = 0; i < pReports.size(); i++ )
+	{
+		const Report& report = pReports[ i ];
+		if ( bestResolution == 0 || report._resolution != bestResolution )
+		{
+			continue;
+		}
+
+		const bool fitsBudget = ( report._peakMemorySize <= _memoryBudget );
+		if ( result == pReports.size() || ( fitsBudget && ! pFitsBudget ) )
+		{
+			result = i;
+			pFitsBudget = fitsBudget;
+			continue;
+		}
+		if ( fitsBudget != pFitsBudget )
+		{
+			continue;
+		}
+
+		const Report& best = pReports[ result ];
+		const bool isBetter = fitsBudget
+			? ( report._loadedSize < best._loadedSize || ( report._loadedSize == best._loadedSize && report._diskSize < best._diskSize ) )
+			: ( report._peakMemorySize < best._peakMemorySize );
+		if ( isBetter )
+		{
+			result = i;
+		}
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * Print a simulation report
+ *
+ * @param pReport the simulation report
+ * @param pStream the stream where to write
+ ******************************************************************************/
+void GvdaAnalyzer::print( const Report& pReport, std::ostream& pStream ) const
+{
+	const double cMegaByte = 1024.0 * 1024.0;
+	const Configuration& configuration = pReport._configuration;
+
+	pStream << "NodeRes " << configuration._nodeTileResolution << " / BrickRes " << configuration._brickResolution << " / border " << configuration._borderSize;
+	if ( pReport._resolution == 0 )
+	{
+		pStream << " : bricks are larger than the volume" << std::endl;
+		return;
+	}
+	pStream << " : max depth " << pReport._maxDepth << ", resolution " << pReport._resolution << std::endl;
+
+	pStream << "  level     tiles      nodes  empty %  const %     bricks   disk MB" << std::endl;
+	for ( size_t depth = 0; depth < pReport._levels.size(); depth++ )
+	{
+		const LevelStatistics& level = pReport._levels[ depth ];
+		const double nbNodes = ( level._nbNodes > 0 ) ? static_cast< double >( level._nbNodes ) : 1.0;
+		pStream << "  " << std::setw( 5 ) << depth
+				<< " " << std::setw( 9 ) << level._nbNodeTiles
+				<< " " << std::setw( 10 ) << level._nbNodes
+				<< std::fixed << std::setprecision( 1 )
+				<< " " << std::setw( 8 ) << 100.0 * level._nbEmptyNodes / nbNodes
+				<< " " << std::setw( 8 ) << 100.0 * level._nbConstantNodes / nbNodes
+				<< " " << std::setw( 10 ) << level._nbBricks
+				<< " " << std::setw( 9 ) << ( level._nodeFileSize + level._brickFileSize ) / cMegaByte
+				<< std::endl;
+	}
+
+	pStream << "  disk size : " << pReport._diskSize / cMegaByte << " MB" << std::endl;
+	pStream << "  camera path : peak " << pReport._peakNbBricks << " bricks and " << pReport._peakNbNodeTiles << " node tiles ( "
+			<< pReport._peakMemorySize / cMegaByte << " MB ), pool of " << pReport._poolCapacity << " bricks";
+	if ( pReport._poolCapacity > 0 )
+	{
+		pStream << " ( pressure " << 100.0 * pReport._peakNbBricks / pReport._poolCapacity << " % )";
+	}
+	pStream << ", " << pReport._nbRequests << " requests, " << pReport._loadedSize / cMegaByte << " MB loaded" << std::endl;
+	pStream.unsetf( std::ios::fixed );
+}
+
+/******************************************************************************
+ * Select the nodes used to render a view
+ *
+ * @param pConfiguration the configuration
+ * @param pMaxDepth max depth of the data structure
+ * @param pView the view
+ * @param pDepth depth of the node tile
+ * @param pTile position of the first node of the node tile
+ * @param pBricks keys of the bricks used by the view
+ * @param pNbNodeTiles number of node tiles used by the view
+ ******************************************************************************/
+void GvdaAnalyzer::selectNodes( const Configuration& pConfiguration, unsigned int pMaxDepth, const View& pView,
+								unsigned int pDepth, const unsigned int pTile[ 3 ],
+								std::vector< unsigned long long >& pBricks, unsigned int& pNbNodeTiles ) const
+{
+	pNbNodeTiles++;
+
+	const unsigned int tileResolution = pConfiguration._nodeTileResolution;
+	const unsigned int nbNodes = static_cast< unsigned int >( power( tileResolution, pDepth + 1 ) );
+	const float nodeSize = 1.0f / static_cast< float >( nbNodes );
+	const float nodeRadius = 0.8660254f * nodeSize;
+	const float voxelSize = nodeSize / static_cast< float >( pConfiguration._brickResolution );
+
+	// Half angle of the cone around the view frustum, and size of a pixel at distance 1
+	const float tanHalfFieldOfView = tanf( 0.5f * pView._fieldOfView );
+	const float halfAngle = atanf( tanHalfFieldOfView * sqrtf( 1.0f + pView._aspectRatio * pView._aspectRatio ) );
+	const float pixelSize = 2.0f * tanHalfFieldOfView / static_cast< float >( _viewportHeight );
+
+	for ( unsigned int z = pTile[ 2 ]; z < pTile[ 2 ] + tileResolution; z++ )
+	{
+		for ( unsigned int y = pTile[ 1 ]; y < pTile[ 1 ] + tileResolution; y++ )
+		{
+			for ( unsigned int x = pTile[ 0 ]; x < pTile[ 0 ] + tileResolution; x++ )
+			{
+				const unsigned int value = _volume.get( nbNodes, x, y, z );
+				if ( value == GvdaVolume::cEmptyValue )
+				{
+					continue;
+				}
+
+				// Visibility (bounding sphere against view cone)
+				const float offset[ 3 ] =
+				{
+					( static_cast< float >( x ) + 0.5f ) * nodeSize - pView._position[ 0 ],
+					( static_cast< float >( y ) + 0.5f ) * nodeSize - pView._position[ 1 ],
+					( static_cast< float >( z ) + 0.5f ) * nodeSize - pView._position[ 2 ]
+				};
+				const float distance = sqrtf( offset[ 0 ] * offset[ 0 ] + offset[ 1 ] * offset[ 1 ] + offset[ 2 ] * offset[ 2 ] );
+				if ( distance > nodeRadius )
+				{
+					const float cosAngle = ( offset[ 0 ] * pView._direction[ 0 ] + offset[ 1 ] * pView._direction[ 1 ] + offset[ 2 ] * pView._direction[ 2 ] ) / distance;
+					const float angle = acosf( std::max( -1.0f, std::min( 1.0f, cosAngle ) ) );
+					if ( angle - asinf( nodeRadius / distance ) > halfAngle )
+					{
+						continue;
+					}
+				}
+
+				// Refine while voxels are larger than a pixel
+				const float footprint = std::max( distance - nodeRadius, 0.0f ) * pixelSize;
+				if ( value == GvdaVolume::cVariedValue && pDepth < pMaxDepth && voxelSize > footprint )
+				{
+					const unsigned int tile[ 3 ] = { x * tileResolution, y * tileResolution, z * tileResolution };
+					selectNodes( pConfiguration, pMaxDepth, pView, pDepth + 1, tile, pBricks, pNbNodeTiles );
+				}
+				else
+				{
+					pBricks.push_back( ( static_cast< unsigned long long >( pDepth ) << 48 ) | ( x + static_cast< unsigned long long >( nbNodes ) * ( y + static_cast< unsigned long long >( nbNodes ) * z ) ) );
+				}
+			}
+		}
+	}
+}
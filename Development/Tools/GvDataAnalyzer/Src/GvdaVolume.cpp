@@ -0,0 +1,484 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvdaVolume.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// TinyXML
+#include <tinyxml.h>
+
+// STL
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <cstdlib>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// Project
+using namespace Gvda;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Mask of the brick index in a node of a ".nodes" file
+ */
+static const unsigned int cBrickIndexMask = 0x3fffffff;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvdaVolume::GvdaVolume()
+:	_levels()
+,	_voxelSize( 0 )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvdaVolume::~GvdaVolume()
+{
+}
+
+/******************************************************************************
+ * Load a RAW file (voxels stored X axis first, then Y axis, then Z axis)
+ *
+ * @param pFileName the RAW file
+ * @param pWidth number of voxels along X axis
+ * @param pHeight number of voxels along Y axis
+ * @param pDepth number of voxels along Z axis
+ * @param pTypeName type of voxels (uchar, uchar4, ushort, float, float4)
+ * @param pMaxResolution max analysis resolution (the volume is downsampled above)
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvdaVolume::loadRAW( const std::string& pFileName, unsigned int pWidth, unsigned int pHeight, unsigned int pDepth,
+							const std::string& pTypeName, unsigned int pMaxResolution )
+{
+	const unsigned int typeSize = getTypeSize( pTypeName );
+	if ( typeSize == 0 || pWidth == 0 || pHeight == 0 || pDepth == 0 )
+	{
+		std::cerr << "GvdaVolume::loadRAW() : invalid type or size" << std::endl;
+		return false;
+	}
+
+	std::ifstream file( pFileName.c_str(), std::ios::binary );
+	if ( ! file.is_open() )
+	{
+		std::cerr << "GvdaVolume::loadRAW() : unable to open " << pFileName << std::endl;
+		return false;
+	}
+
+	// The volume is padded to a cube of power of two resolution,
+	// then each analysis voxel covers a block of factor^3 voxels
+	unsigned int paddedResolution = 1;
+	while ( paddedResolution < pWidth || paddedResolution < pHeight || paddedResolution < pDepth )
+	{
+		paddedResolution <<= 1;
+	}
+	unsigned int resolution = paddedResolution;
+	while ( resolution > 1 && resolution > pMaxResolution )
+	{
+		resolution >>= 1;
+	}
+	const unsigned int factor = paddedResolution / resolution;
+
+	allocate( resolution );
+	_voxelSize = typeSize;
+	std::vector< unsigned int >& voxels = _levels.back();
+
+	// Read slice by slice
+	std::vector< unsigned char > slice( static_cast< size_t >( pWidth ) * pHeight * typeSize );
+	for ( unsigned int z = 0; z < pDepth; z++ )
+	{
+		if ( ! file.read( reinterpret_cast< char* >( &slice[ 0 ] ), slice.size() ) )
+		{
+			std::cerr << "GvdaVolume::loadRAW() : unexpected end of file in " << pFileName << std::endl;
+			_levels.clear();
+			return false;
+		}
+
+		const unsigned char* data = &slice[ 0 ];
+		for ( unsigned int y = 0; y < pHeight; y++ )
+		{
+			const size_t offset = static_cast< size_t >( resolution ) * ( y / factor + static_cast< size_t >( resolution ) * ( z / factor ) );
+			for ( unsigned int x = 0; x < pWidth; x++ )
+			{
+				merge( voxels[ offset + x / factor ], getSignature( data, typeSize ) );
+				data += typeSize;
+			}
+		}
+	}
+
+	// Blocks crossing the volume bounds also contain padding (empty) voxels
+	for ( unsigned int z = 0; z < resolution; z++ )
+	{
+		for ( unsigned int y = 0; y < resolution; y++ )
+		{
+			for ( unsigned int x = 0; x < resolution; x++ )
+			{
+				if ( ( x + 1 ) * factor > pWidth || ( y + 1 ) * factor > pHeight || ( z + 1 ) * factor > pDepth )
+				{
+					merge( voxels[ x + static_cast< size_t >( resolution ) * ( y + static_cast< size_t >( resolution ) * z ) ], cEmptyValue );
+				}
+			}
+		}
+	}
+
+	buildPyramid();
+
+	// LOG
+	std::cout << "Loaded " << pFileName << " ( " << pWidth << "x" << pHeight << "x" << pDepth << " " << pTypeName << " )"
+				<< ", analysis resolution : " << resolution << std::endl;
+
+	return true;
+}
+
+/******************************************************************************
+ * Load the finest level of a dataset fitting in the analysis resolution
+ *
+ * @param pXMLFileName XML file describing the dataset
+ * @param pMaxResolution max analysis resolution
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvdaVolume::loadDataset( const std::string& pXMLFileName, unsigned int pMaxResolution )
+{
+	TiXmlDocument document( pXMLFileName.c_str() );
+	if ( ! document.LoadFile() )
+	{
+		std::cerr << "GvdaVolume::loadDataset() : unable to load " << pXMLFileName << std::endl;
+		return false;
+	}
+
+	// File names are relative to the "directory" attribute, itself relative to the XML file
+	const TiXmlElement* model = document.FirstChildElement( "Model" );
+	const TiXmlElement* nodeTree = model ? model->FirstChildElement( "NodeTree" ) : NULL;
+	const TiXmlElement* brickData = model ? model->FirstChildElement( "BrickData" ) : NULL;
+	if ( model == NULL || model->Attribute( "directory" ) == NULL || model->Attribute( "nbLevels" ) == NULL
+		|| nodeTree == NULL || brickData == NULL || brickData->Attribute( "brickResolution" ) == NULL || brickData->Attribute( "borderSize" ) == NULL )
+	{
+		std::cerr << "GvdaVolume::loadDataset() : invalid dataset description in " << pXMLFileName << std::endl;
+		return false;
+	}
+	const std::string directory = pXMLFileName.substr( 0, pXMLFileName.find_last_of( "\\/" ) + 1 ) + model->Attribute( "directory" ) + "/";
+	const unsigned int nbLevels = static_cast< unsigned int >( atoi( model->Attribute( "nbLevels" ) ) );
+	const unsigned int brickResolution = static_cast< unsigned int >( atoi( brickData->Attribute( "brickResolution" ) ) );
+	const unsigned int borderSize = static_cast< unsigned int >( atoi( brickData->Attribute( "borderSize" ) ) );
+	if ( nbLevels == 0 || brickResolution == 0 || ( brickResolution & ( brickResolution - 1 ) ) != 0 )
+	{
+		std::cerr << "GvdaVolume::loadDataset() : unsupported levels or brick resolution in " << pXMLFileName << std::endl;
+		return false;
+	}
+
+	// Finest level fitting in the analysis resolution
+	unsigned int level = 0;
+	while ( level + 1 < nbLevels && ( brickResolution << ( level + 1 ) ) <= pMaxResolution )
+	{
+		level++;
+	}
+
+	// Node file of the level
+	std::string nodeFileName;
+	for ( const TiXmlElement* element = nodeTree->FirstChildElement( "Level" ); element != NULL; element = element->NextSiblingElement( "Level" ) )
+	{
+		if ( element->Attribute( "id" ) && static_cast< unsigned int >( atoi( element->Attribute( "id" ) ) ) == level && element->Attribute( "filename" ) )
+		{
+			nodeFileName = directory + element->Attribute( "filename" );
+		}
+	}
+
+	// Voxels are as big as all channels, but only the first one is analyzed
+	std::string brickFileName;
+	unsigned int typeSize = 0;
+	_voxelSize = 0;
+	for ( const TiXmlElement* channel = brickData->FirstChildElement( "Channel" ); channel != NULL; channel = channel->NextSiblingElement( "Channel" ) )
+	{
+		const unsigned int channelTypeSize = getTypeSize( channel->Attribute( "type" ) ? channel->Attribute( "type" ) : "" );
+		if ( channelTypeSize == 0 )
+		{
+			std::cerr << "GvdaVolume::loadDataset() : unknown channel type in " << pXMLFileName << std::endl;
+			return false;
+		}
+		_voxelSize += channelTypeSize;
+
+		if ( typeSize == 0 )
+		{
+			typeSize = channelTypeSize;
+			for ( const TiXmlElement* element = channel->FirstChildElement( "Level" ); element != NULL; element = element->NextSiblingElement( "Level" ) )
+			{
+				if ( element->Attribute( "id" ) && static_cast< unsigned int >( atoi( element->Attribute( "id" ) ) ) == level && element->Attribute( "filename" ) )
+				{
+					brickFileName = directory + element->Attribute( "filename" );
+				}
+			}
+		}
+	}
+
+	std::ifstream nodeFile( nodeFileName.c_str(), std::ios::binary );
+	std::ifstream brickFile( brickFileName.c_str(), std::ios::binary );
+	if ( nodeFileName.empty() || brickFileName.empty() || ! nodeFile.is_open() || ! brickFile.is_open() )
+	{
+		std::cerr << "GvdaVolume::loadDataset() : unable to open the node or brick file of level " << level << " in " << pXMLFileName << std::endl;
+		return false;
+	}
+
+	const unsigned int nodeGridSize = 1 << level;
+	const unsigned int resolution = nodeGridSize * brickResolution;
+	const unsigned int storedBrickWidth = brickResolution + 2 * borderSize;
+	const size_t storedBrickSize = static_cast< size_t >( storedBrickWidth ) * storedBrickWidth * storedBrickWidth * typeSize;
+
+	allocate( resolution );
+	std::vector< unsigned int >& voxels = _levels.back();
+	voxels.assign( voxels.size(), cEmptyValue );
+
+	// Nodes are stored X axis first, then Y axis, then Z axis (0 for empty nodes)
+	std::vector< unsigned int > nodes( static_cast< size_t >( nodeGridSize ) * nodeGridSize * nodeGridSize );
+	if ( ! nodeFile.read( reinterpret_cast< char* >( &nodes[ 0 ] ), nodes.size() * sizeof( unsigned int ) ) )
+	{
+		std::cerr << "GvdaVolume::loadDataset() : unexpected end of file in " << nodeFileName << std::endl;
+		_levels.clear();
+		return false;
+	}
+
+	std::vector< unsigned char > brick( storedBrickSize );
+	size_t nodeIndex = 0;
+	for ( unsigned int z = 0; z < nodeGridSize; z++ )
+	{
+		for ( unsigned int y = 0; y < nodeGridSize; y++ )
+		{
+			for ( unsigned int x = 0; x < nodeGridSize; x++, nodeIndex++ )
+			{
+				const unsigned int node = nodes[ nodeIndex ];
+				if ( node == 0 )
+				{
+					continue;
+				}
+
+				brickFile.seekg( static_cast< std::streamoff >( node & cBrickIndexMask ) * static_cast< std::streamoff >( storedBrickSize ), std::ios::beg );
+				if ( ! brickFile.read( reinterpret_cast< char* >( &brick[ 0 ] ), storedBrickSize ) )
+				{
+					std::cerr << "GvdaVolume::loadDataset() : unexpected end of file in " << brickFileName << std::endl;
+					_levels.clear();
+					return false;
+				}
+
+				// Interior voxels only
+				for ( unsigned int k = 0; k < brickResolution; k++ )
+				{
+					for ( unsigned int j = 0; j < brickResolution; j++ )
+					{
+						const unsigned char* data = &brick[ ( borderSize + storedBrickWidth * ( ( j + borderSize ) + storedBrickWidth * ( k + borderSize ) ) ) * typeSize ];
+						unsigned int* voxel = &voxels[ x * brickResolution + static_cast< size_t >( resolution ) * ( ( y * brickResolution + j ) + static_cast< size_t >( resolution ) * ( z * brickResolution + k ) ) ];
+						for ( unsigned int i = 0; i < brickResolution; i++ )
+						{
+							voxel[ i ] = getSignature( data, typeSize );
+							data += typeSize;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	buildPyramid();
+
+	// LOG
+	std::cout << "Loaded level " << level << " of " << pXMLFileName << ", analysis resolution : " << resolution << std::endl;
+
+	return true;
+}
+
+/******************************************************************************
+ * Get the analysis resolution (number of voxels along each axis of the finest level)
+ *
+ * @return the analysis resolution
+ ******************************************************************************/
+unsigned int GvdaVolume::getResolution() const
+{
+	return _levels.empty() ? 0 : ( 1 << ( _levels.size() - 1 ) );
+}
+
+/******************************************************************************
+ * Get the signature of a region
+ *
+ * @param pResolution resolution of the pyramid level (power of two, up to getResolution())
+ * @param pX region position along X axis
+ * @param pY region position along Y axis
+ * @param pZ region position along Z axis
+ *
+ * @return the signature of the region
+ ******************************************************************************/
+unsigned int GvdaVolume::get( unsigned int pResolution, unsigned int pX, unsigned int pY, unsigned int pZ ) const
+{
+	unsigned int level = 0;
+	while ( ( 1U << level ) < pResolution )
+	{
+		level++;
+	}
+
+	return _levels[ level ][ pX + static_cast< size_t >( pResolution ) * ( pY + static_cast< size_t >( pResolution ) * pZ ) ];
+}
+
+/******************************************************************************
+ * Get the size of a voxel, over all its data channels
+ *
+ * @return the size of a voxel (in bytes)
+ ******************************************************************************/
+unsigned int GvdaVolume::getVoxelSize() const
+{
+	return _voxelSize;
+}
+
+/******************************************************************************
+ * Get the size of a voxel data type
+ *
+ * @param pTypeName type of voxels (uchar, uchar4, ushort, float, float4, half4)
+ *
+ * @return the size of the type (in bytes), 0 if the type is unknown
+ ******************************************************************************/
+unsigned int GvdaVolume::getTypeSize( const std::string& pTypeName )
+{
+	std::map< std::string, unsigned int > sizes;
+	sizes[ "uchar" ] = 1;
+	sizes[ "uchar4" ] = 4;
+	sizes[ "ushort" ] = 2;
+	sizes[ "float" ] = 4;
+	sizes[ "float4" ] = 16;
+	sizes[ "half4" ] = 8;
+
+	std::map< std::string, unsigned int >::const_iterator size = sizes.find( pTypeName );
+
+	return ( size != sizes.end() ) ? size->second : 0;
+}
+
+/******************************************************************************
+ * Allocate the pyramid for a given analysis resolution
+ *
+ * @param pResolution the analysis resolution (power of two)
+ ******************************************************************************/
+void GvdaVolume::allocate( unsigned int pResolution )
+{
+	_levels.clear();
+	for ( unsigned int resolution = 1; resolution <= pResolution; resolution <<= 1 )
+	{
+		_levels.push_back( std::vector< unsigned int >( static_cast< size_t >( resolution ) * resolution * resolution, cUnsetValue ) );
+	}
+}
+
+/******************************************************************************
+ * Build the coarser levels of the pyramid from its finest level
+ ******************************************************************************/
+void GvdaVolume::buildPyramid()
+{
+	for ( size_t level = _levels.size() - 1; level > 0; level-- )
+	{
+		const std::vector< unsigned int >& fine = _levels[ level ];
+		std::vector< unsigned int >& coarse = _levels[ level - 1 ];
+		const size_t fineResolution = static_cast< size_t >( 1 ) << level;
+		const size_t coarseResolution = fineResolution >> 1;
+
+		for ( size_t z = 0; z < coarseResolution; z++ )
+		{
+			for ( size_t y = 0; y < coarseResolution; y++ )
+			{
+				for ( size_t x = 0; x < coarseResolution; x++ )
+				{
+					unsigned int& region = coarse[ x + coarseResolution * ( y + coarseResolution * z ) ];
+					region = cUnsetValue;
+					for ( size_t child = 0; child < 8; child++ )
+					{
+						const size_t fx = 2 * x + ( child & 1 );
+						const size_t fy = 2 * y + ( ( child >> 1 ) & 1 );
+						const size_t fz = 2 * z + ( child >> 2 );
+						merge( region, fine[ fx + fineResolution * ( fy + fineResolution * fz ) ] );
+					}
+				}
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * Compute the signature of a voxel value
+ *
+ * @param pData the voxel value
+ * @param pSize the size of the voxel value (in bytes)
+ *
+ * @return the signature
+ ******************************************************************************/
+unsigned int GvdaVolume::getSignature( const unsigned char* pData, unsigned int pSize )
+{
+	// FNV-1a hash, empty voxels (all bytes to 0) have their own signature
+	bool isEmpty = true;
+	unsigned int hash = 2166136261U;
+	for ( unsigned int i = 0; i < pSize; i++ )
+	{
+		isEmpty = isEmpty && ( pData[ i ] == 0 );
+		hash = ( hash ^ pData[ i ] ) * 16777619U;
+	}
+	if ( isEmpty )
+	{
+		return cEmptyValue;
+	}
+
+	// Keep special signatures for special regions
+	return ( hash == cEmptyValue || hash >= cUnsetValue ) ? 1 : hash;
+}
+
+/******************************************************************************
+ * Merge a signature in the signature of a region
+ *
+ * @param pRegion the signature of the region
+ * @param pValue the signature to merge
+ ******************************************************************************/
+void GvdaVolume::merge( unsigned int& pRegion, unsigned int pValue )
+{
+	if ( pRegion == cUnsetValue )
+	{
+		pRegion = pValue;
+	}
+	else if ( pRegion != pValue )
+	{
+		pRegion = cVariedValue;
+	}
+}
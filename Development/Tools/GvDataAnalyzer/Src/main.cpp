@@ -0,0 +1,249 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvdaVolume.h"
+#include "GvdaAnalyzer.h"
+
+// STL
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// Project
+using namespace Gvda;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Default max analysis resolution
+ */
+static const unsigned int cDefaultResolution = 256;
+
+/**
+ * Default memory budget (in MB)
+ */
+static const unsigned int cDefaultMemoryBudget = 512;
+
+/**
+ * Default number of orbit views, and of views per camera path key frame interval
+ */
+static const unsigned int cDefaultNbOrbitViews = 32;
+static const unsigned int cDefaultNbSteps = 4;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Print usage
+ ******************************************************************************/
+static void printUsage()
+{
+	std::cout << "Usage :" << std::endl;
+	std::cout << "  GvDataAnalyzer raw <file.raw> <width> <height> <depth> <type> [options]" << std::endl;
+	std::cout << "    analyze a RAW volume (type : uchar, uchar4, ushort, float, float4)" << std::endl;
+	std::cout << "  GvDataAnalyzer dataset <dataset.xml> [options]" << std::endl;
+	std::cout << "    analyze an existing dataset (finest level fitting in the analysis resolution, first channel)" << std::endl;
+	std::cout << "Options :" << std::endl;
+	std::cout << "  --budget <MB>            memory budget of the node and data pools (default " << cDefaultMemoryBudget << ")" << std::endl;
+	std::cout << "  --resolution <voxels>    max analysis resolution (default " << cDefaultResolution << ")" << std::endl;
+	std::cout << "  --camera-path <file>     GvViewer camera path used to estimate requests" << std::endl;
+	std::cout << "  --steps <n>              views per camera path key frame interval (default " << cDefaultNbSteps << ")" << std::endl;
+	std::cout << "  --orbit <n>              number of orbit views when there is no camera path (default " << cDefaultNbOrbitViews << ")" << std::endl;
+	std::cout << "  --viewport <height>      viewport height in pixels" << std::endl;
+}
+
+/******************************************************************************
+ * Main entry program
+ *
+ * @param pArgc number of arguments
+ * @param pArgv list of arguments
+ *
+ * @return exit code
+ ******************************************************************************/
+int main( int pArgc, char* pArgv[] )
+{
+	// LOG
+	std::cout << "--------------------------------------" << std::endl;
+	std::cout << "----- GigaVoxels Data Analyzer -------" << std::endl;
+	std::cout << "--------------------------------------" << std::endl;
+
+	// Parse command line
+	if ( pArgc < 3 )
+	{
+		printUsage();
+		return 1;
+	}
+	const std::string mode = pArgv[ 1 ];
+	int firstOption = 0;
+	if ( mode == "raw" && pArgc >= 7 )
+	{
+		firstOption = 7;
+	}
+	else if ( mode == "dataset" )
+	{
+		firstOption = 3;
+	}
+	else
+	{
+		printUsage();
+		return 1;
+	}
+
+	unsigned int memoryBudget = cDefaultMemoryBudget;
+	unsigned int resolution = cDefaultResolution;
+	std::string cameraPathFileName;
+	unsigned int nbSteps = cDefaultNbSteps;
+	unsigned int nbOrbitViews = cDefaultNbOrbitViews;
+	unsigned int viewportHeight = 0;
+	for ( int i = firstOption; i < pArgc; i++ )
+	{
+		const std::string option = pArgv[ i ];
+		if ( i + 1 >= pArgc )
+		{
+			std::cerr << "Missing value of option " << option << std::endl;
+			return 1;
+		}
+		const char* value = pArgv[ ++i ];
+		if ( option == "--budget" )
+		{
+			memoryBudget = static_cast< unsigned int >( atoi( value ) );
+		}
+		else if ( option == "--resolution" )
+		{
+			resolution = static_cast< unsigned int >( atoi( value ) );
+		}
+		else if ( option == "--camera-path" )
+		{
+			cameraPathFileName = value;
+		}
+		else if ( option == "--steps" )
+		{
+			nbSteps = static_cast< unsigned int >( atoi( value ) );
+		}
+		else if ( option == "--orbit" )
+		{
+			nbOrbitViews = static_cast< unsigned int >( atoi( value ) );
+		}
+		else if ( option == "--viewport" )
+		{
+			viewportHeight = static_cast< unsigned int >( atoi( value ) );
+		}
+		else
+		{
+			std::cerr << "Unknown option " << option << std::endl;
+			printUsage();
+			return 1;
+		}
+	}
+
+	// Load the volume
+	GvdaVolume volume;
+	const bool isLoaded = ( mode == "raw" )
+		? volume.loadRAW( pArgv[ 2 ], static_cast< unsigned int >( atoi( pArgv[ 3 ] ) ), static_cast< unsigned int >( atoi( pArgv[ 4 ] ) ), static_cast< unsigned int >( atoi( pArgv[ 5 ] ) ), pArgv[ 6 ], resolution )
+		: volume.loadDataset( pArgv[ 2 ], resolution );
+	if ( ! isLoaded )
+	{
+		return 2;
+	}
+
+	// Views (the viewport height of the command line overrides the one of the camera path)
+	GvdaAnalyzer analyzer( volume );
+	analyzer.setMemoryBudget( static_cast< unsigned long long >( memoryBudget ) << 20 );
+	if ( ! cameraPathFileName.empty() )
+	{
+		if ( ! analyzer.loadCameraPath( cameraPathFileName, nbSteps ) )
+		{
+			return 2;
+		}
+	}
+	else
+	{
+		analyzer.createOrbit( nbOrbitViews );
+	}
+	if ( viewportHeight > 0 )
+	{
+		analyzer.setViewportHeight( viewportHeight );
+	}
+
+	// Simulate all configurations
+	const unsigned int nodeTileResolutions[] = { 2, 4 };
+	const unsigned int brickResolutions[] = { 8, 16, 32 };
+	const unsigned int borderSizes[] = { 1, 0 };
+	std::vector< GvdaAnalyzer::Report > reports;
+	for ( unsigned int n = 0; n < 2; n++ )
+	{
+		for ( unsigned int b = 0; b < 3; b++ )
+		{
+			for ( unsigned int s = 0; s < 2; s++ )
+			{
+				GvdaAnalyzer::Configuration configuration;
+				configuration._nodeTileResolution = nodeTileResolutions[ n ];
+				configuration._brickResolution = brickResolutions[ b ];
+				configuration._borderSize = borderSizes[ s ];
+
+				reports.push_back( analyzer.analyze( configuration ) );
+
+				std::cout << std::endl;
+				analyzer.print( reports.back(), std::cout );
+			}
+		}
+	}
+
+	// Recommendation
+	bool fitsBudget = false;
+	const size_t recommended = analyzer.recommend( reports, fitsBudget );
+	std::cout << std::endl;
+	if ( recommended >= reports.size() )
+	{
+		std::cout << "No configuration can be recommended : the analysis resolution is too low" << std::endl;
+		return 3;
+	}
+	const GvdaAnalyzer::Configuration& configuration = reports[ recommended ]._configuration;
+	std::cout << "Recommended configuration " << ( fitsBudget ? "" : "( does not fit in the memory budget ) " ) << ": " << std::endl;
+	std::cout << "  typedef GvCore::StaticRes1D< " << configuration._nodeTileResolution << " > NodeRes;" << std::endl;
+	std::cout << "  typedef GvCore::StaticRes1D< " << configuration._brickResolution << " > BrickRes;" << std::endl;
+	std::cout << "  stored bricks : " << ( configuration._borderSize == 0 ? "borderless ( voxelizer --borderless )" : "with borders" ) << std::endl;
+
+	return fitsBudget ? 0 : 3;
+}
@@ -0,0 +1,206 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GVDP_PACKER_H_
+#define _GVDP_PACKER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include <GvVoxelizer/GvDataContainer.h>
+
+// STL
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace Gvdp
+{
+
+/**
+ * @class GvdpPacker
+ *
+ * @brief The GvdpPacker class converts a GigaVoxels dataset between its
+ * separate files form (XML file, ".nodes", ".bricks" and ".summary" files)
+ * and its single container file form (".gvc").
+ * It also packs the datasets of the time steps of a time-varying dataset
+ * in a time series file (".gvts", see GvVoxelizer::GvTimeSeries).
+ *
+ * Unpacking writes back the files with the voxelizer naming scheme,
+ * and an XML file so that the container can still be used by XML based tools.
+ */
+class GvdpPacker
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Pack a dataset in a container file
+	 *
+	 * @param pXMLFileName XML file describing the dataset
+	 * @param pContainerFileName the container file to write
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	static bool pack( const std::string& pXMLFileName, const std::string& pContainerFileName );
+
+	/**
+	 * Unpack a container file in separate files
+	 *
+	 * @param pContainerFileName the container file
+	 * @param pDirectory the directory where files are written
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	static bool unpack( const std::string& pContainerFileName, const std::string& pDirectory );
+
+	/**
+	 * Pack the datasets of the time steps of a time-varying dataset in a time series file
+	 *
+	 * @param pXMLFileNames XML files describing the dataset of each time step
+	 * @param pFileName the time series file to write
+	 * @param pKeyframeInterval number of time steps between two keyframes
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	static bool packTimeSeries( const std::vector< std::string >& pXMLFileNames, const std::string& pFileName, unsigned int pKeyframeInterval );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Write the XML file describing the unpacked dataset
+	 *
+	 * @param pContainer the container
+	 * @param pFileName the XML file name
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	static bool writeXMLFile( const GvVoxelizer::GvDataContainer& pContainer, const std::string& pFileName );
+
+	/**
+	 * Retrieve the file name of a section, as written by the voxelizer
+	 *
+	 * @param pContainer the container
+	 * @param pSectionIndex index of the section
+	 *
+	 * @return the file name (without directory)
+	 */
+	static std::string getSectionFileName( const GvVoxelizer::GvDataContainer& pContainer, unsigned int pSectionIndex );
+
+	/**
+	 * Read the description of a dataset and the list of its files
+	 *
+	 * @param pXMLFileName XML file describing the dataset
+	 * @param pName the dataset name
+	 * @param pBrickResolution brick resolution (without borders)
+	 * @param pBorderSize brick border size
+	 * @param pNbLevels number of levels of resolution
+	 * @param pChannels data channels
+	 * @param pFiles node, brick and summary files of the dataset
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	static bool readDataset( const std::string& pXMLFileName, std::string& pName,
+							unsigned int& pBrickResolution, unsigned int& pBorderSize, unsigned int& pNbLevels,
+							std::vector< GvVoxelizer::GvDataContainer::Channel >& pChannels, std::vector< GvVoxelizer::GvDataContainer::SectionFile >& pFiles );
+
+	/**
+	 * Read a whole file
+	 *
+	 * @param pFileName the file name
+	 * @param pData the file content
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	static bool readFile( const std::string& pFileName, std::vector< unsigned char >& pData );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor forbidden (only static methods).
+	 */
+	GvdpPacker();
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvdpPacker( const GvdpPacker& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvdpPacker& operator=( const GvdpPacker& );
+
+};
+
+} // namespace Gvdp
+
+#endif
@@ -0,0 +1,540 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#include "GvdpPacker.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// GigaVoxels
+#include <GvVoxelizer/GvDataContainer.h>
+#include <GvVoxelizer/GvTimeSeries.h>
+#include <GvVoxelizer/GvTimeSeriesWriter.h>
+
+// TinyXML
+#include <tinyxml.h>
+
+// STL
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GigaVoxels
+using namespace GvVoxelizer;
+
+// Project
+using namespace Gvdp;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Size of the buffer used to extract sections
+ */
+static const size_t cCopyBufferSize = 1 << 20;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Pack a dataset in a container file
+ *
+ * @param pXMLFileName XML file describing the dataset
+ * @param pContainerFileName the container file to write
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvdpPacker::pack( const std::string& pXMLFileName, const std::string& pContainerFileName )
+{
+	std::string name;
+	unsigned int brickResolution;
+	unsigned int borderSize;
+	unsigned int nbLevels;
+	std::vector< GvDataContainer::Channel > channels;
+	std::vector< GvDataContainer::SectionFile > files;
+	if ( ! readDataset( pXMLFileName, name, brickResolution, borderSize, nbLevels, channels, files ) )
+	{
+		return false;
+	}
+
+	if ( ! GvDataContainer::write( pContainerFileName, name, brickResolution, borderSize, nbLevels, channels, files ) )
+	{
+		return false;
+	}
+
+	// LOG
+	std::cout << "Packed " << files.size() << " files in " << pContainerFileName << std::endl;
+
+	return true;
+}
+
+/******************************************************************************
+ * Pack the datasets of the time steps of a time-varying dataset in a time series file
+ *
+ * @param pXMLFileNames XML files describing the dataset of each time step
+ * @param pFileName the time series file to write
+ * @param pKeyframeInterval number of time steps between two keyframes
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvdpPacker::packTimeSeries( const std::vector< std::string >& pXMLFileNames, const std::string& pFileName, unsigned int pKeyframeInterval )
+{
+	GvTimeSeriesWriter writer;
+	unsigned int firstBrickResolution = 0;
+	unsigned int firstBorderSize = 0;
+	std::vector< GvDataContainer::Channel > firstChannels;
+	for ( size_t step = 0; step < pXMLFileNames.size(); step++ )
+	{
+		std::string name;
+		unsigned int brickResolution;
+		unsigned int borderSize;
+		unsigned int nbLevels;
+		std::vector< GvDataContainer::Channel > channels;
+		std::vector< GvDataContainer::SectionFile > files;
+		if ( ! readDataset( pXMLFileNames[ step ], name, brickResolution, borderSize, nbLevels, channels, files ) )
+		{
+			return false;
+		}
+
+		// All time steps must have the same layout
+		if ( step == 0 )
+		{
+			if ( ! writer.open( pFileName, brickResolution, borderSize, nbLevels, channels, pKeyframeInterval ) )
+			{
+				return false;
+			}
+			firstBrickResolution = brickResolution;
+			firstBorderSize = borderSize;
+			firstChannels = channels;
+		}
+		bool isValid = ( brickResolution == firstBrickResolution && borderSize == firstBorderSize && channels.size() == firstChannels.size() );
+		for ( size_t i = 0; isValid && i < channels.size(); i++ )
+		{
+			isValid = ( channels[ i ]._typeName == firstChannels[ i ]._typeName );
+		}
+		if ( ! isValid )
+		{
+			std::cerr << "GvdpPacker::packTimeSeries() : " << pXMLFileNames[ step ] << " has not the same bricks as the first time step" << std::endl;
+			return false;
+		}
+
+		// Read the node and brick files of each level (summaries are not used)
+		std::vector< GvTimeSeries::Level > levels( nbLevels );
+		for ( size_t i = 0; i < levels.size(); i++ )
+		{
+			levels[ i ]._bricks.resize( channels.size() );
+		}
+		std::vector< unsigned char > buffer;
+		for ( size_t i = 0; i < files.size(); i++ )
+		{
+			if ( files[ i ]._type == GvDataContainer::eSummarySection )
+			{
+				continue;
+			}
+			if ( ! readFile( files[ i ]._fileName, buffer ) )
+			{
+				return false;
+			}
+
+			GvTimeSeries::Level& level = levels[ files[ i ]._level ];
+			if ( files[ i ]._type == GvDataContainer::eNodeSection )
+			{
+				level._nodes.resize( buffer.size() / sizeof( unsigned int ) );
+				if ( ! level._nodes.empty() )
+				{
+					memcpy( &level._nodes[ 0 ], &buffer[ 0 ], level._nodes.size() * sizeof( unsigned int ) );
+				}
+			}
+			else
+			{
+				level._bricks[ files[ i ]._channel ].swap( buffer );
+			}
+		}
+
+		if ( ! writer.writeStep( levels ) )
+		{
+			return false;
+		}
+
+		// LOG
+		std::cout << "Time step " << step << " : " << writer.getNbChangedNodes() << " changed nodes, " << writer.getStepSize() << " bytes" << std::endl;
+	}
+
+	if ( ! writer.close() )
+	{
+		return false;
+	}
+
+	// LOG
+	std::cout << "Packed " << pXMLFileNames.size() << " time steps in " << pFileName << std::endl;
+
+	return true;
+}
+
+/******************************************************************************
+ * Unpack a container file in separate files
+ *
+ * @param pContainerFileName the container file
+ * @param pDirectory the directory where files are written
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvdpPacker::unpack( const std::string& pContainerFileName, const std::string& pDirectory )
+{
+	GvDataContainer container;
+	if ( ! container.open( pContainerFileName ) )
+	{
+		return false;
+	}
+
+	const std::string directory = pDirectory.empty() ? std::string( "" ) : pDirectory + "/";
+	std::vector< unsigned char > buffer( cCopyBufferSize );
+	const std::vector< GvDataContainer::Section >& sections = container.getSections();
+	for ( unsigned int i = 0; i < sections.size(); i++ )
+	{
+		const std::string fileName = directory + getSectionFileName( container, i );
+		FILE* file = fopen( fileName.c_str(), "wb" );
+		if ( file == NULL )
+		{
+			std::cerr << "GvdpPacker::unpack() : unable to create " << fileName << std::endl;
+			return false;
+		}
+
+		// Copy the section by chunks
+		bool isOk = true;
+		for ( unsigned long long offset = 0; isOk && offset < sections[ i ]._size; offset += cCopyBufferSize )
+		{
+			const size_t size = ( sections[ i ]._size - offset < cCopyBufferSize ) ? static_cast< size_t >( sections[ i ]._size - offset ) : cCopyBufferSize;
+			isOk = container.read( sections[ i ], offset, &buffer[ 0 ], size ) && fwrite( &buffer[ 0 ], 1, size, file ) == size;
+		}
+		fclose( file );
+		if ( ! isOk )
+		{
+			std::cerr << "GvdpPacker::unpack() : unable to write " << fileName << std::endl;
+			return false;
+		}
+	}
+
+	// The XML file describing the dataset is written last
+	const std::string xmlFileName = directory + getSectionFileName( container, static_cast< unsigned int >( sections.size() ) );
+	if ( ! writeXMLFile( container, xmlFileName ) )
+	{
+		return false;
+	}
+
+	// LOG
+	std::cout << "Unpacked " << sections.size() << " files, dataset is described by " << xmlFileName << std::endl;
+
+	return true;
+}
+
+/******************************************************************************
+ * Write the XML file describing the unpacked dataset
+ *
+ * @param pContainer the container
+ * @param pFileName the XML file name
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvdpPacker::writeXMLFile( const GvDataContainer& pContainer, const std::string& pFileName )
+{
+	const std::vector< GvDataContainer::Section >& sections = pContainer.getSections();
+	const std::vector< GvDataContainer::Channel >& channels = pContainer.getChannels();
+
+	// Same layout as the one written by the voxelizer
+	TiXmlDocument doc;
+	TiXmlElement* modelElement = new TiXmlElement( "Model" );
+	modelElement->SetAttribute( "name", pContainer.getName().c_str() );
+	modelElement->SetAttribute( "directory", "." );
+	modelElement->SetAttribute( "nbLevels", static_cast< int >( pContainer.getNbLevels() ) );
+	doc.LinkEndChild( modelElement );
+
+	// Node tree
+	TiXmlElement* nodeTreeElement = new TiXmlElement( "NodeTree" );
+	modelElement->LinkEndChild( nodeTreeElement );
+	for ( unsigned int i = 0; i < sections.size(); i++ )
+	{
+		if ( sections[ i ]._type == GvDataContainer::eNodeSection )
+		{
+			TiXmlElement* levelElement = new TiXmlElement( "Level" );
+			levelElement->SetAttribute( "id", static_cast< int >( sections[ i ]._level ) );
+			levelElement->SetAttribute( "filename", getSectionFileName( pContainer, i ).c_str() );
+			nodeTreeElement->LinkEndChild( levelElement );
+		}
+	}
+
+	// Brick data
+	TiXmlElement* brickDataElement = new TiXmlElement( "BrickData" );
+	brickDataElement->SetAttribute( "brickResolution", static_cast< int >( pContainer.getBrickResolution() ) );
+	brickDataElement->SetAttribute( "borderSize", static_cast< int >( pContainer.getBorderSize() ) );
+	modelElement->LinkEndChild( brickDataElement );
+	for ( unsigned int channel = 0; channel < channels.size(); channel++ )
+	{
+		TiXmlElement* channelElement = new TiXmlElement( "Channel" );
+		channelElement->SetAttribute( "id", static_cast< int >( channel ) );
+		channelElement->SetAttribute( "name", channels[ channel ]._name.c_str() );
+		channelElement->SetAttribute( "type", channels[ channel ]._typeName.c_str() );
+		brickDataElement->LinkEndChild( channelElement );
+
+		for ( unsigned int i = 0; i < sections.size(); i++ )
+		{
+			if ( sections[ i ]._type == GvDataContainer::eBrickSection && sections[ i ]._channel == channel )
+			{
+				TiXmlElement* levelElement = new TiXmlElement( "Level" );
+				levelElement->SetAttribute( "id", static_cast< int >( sections[ i ]._level ) );
+				levelElement->SetAttribute( "filename", getSectionFileName( pContainer, i ).c_str() );
+				channelElement->LinkEndChild( levelElement );
+			}
+		}
+	}
+
+	if ( ! doc.SaveFile( pFileName.c_str() ) )
+	{
+		std::cerr << "GvdpPacker::writeXMLFile() : unable to write " << pFileName << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Retrieve the file name of a section, as written by the voxelizer
+ * (i.e. "fux_BR8_B1_L0.nodes", "fux_BR8_B1_L0_C0_uchar4.bricks", "fux_BR8_B1_L0.summary").
+ * An out of range section index gives the XML file name ("fux.xml").
+ *
+ * @param pContainer the container
+ * @param pSectionIndex index of the section
+ *
+ * @return the file name (without directory)
+ ******************************************************************************/
+std::string GvdpPacker::getSectionFileName( const GvDataContainer& pContainer, unsigned int pSectionIndex )
+{
+	// The dataset name may have been given with a path to the voxelizer
+	const std::string& name = pContainer.getName();
+	std::ostringstream oss;
+	oss << name.substr( name.find_last_of( "\\/" ) + 1 );
+	if ( pSectionIndex >= pContainer.getSections().size() )
+	{
+		oss << ".xml";
+
+		return oss.str();
+	}
+
+	const GvDataContainer::Section& section = pContainer.getSections()[ pSectionIndex ];
+	oss << "_BR" << pContainer.getBrickResolution() << "_B" << pContainer.getBorderSize() << "_L" << section._level;
+	switch ( section._type )
+	{
+		case GvDataContainer::eNodeSection:
+			oss << ".nodes";
+			break;
+
+		case GvDataContainer::eBrickSection:
+			oss << "_C" << section._channel << "_" << pContainer.getChannels()[ section._channel ]._typeName << ".bricks";
+			break;
+
+		default:
+			oss << ".summary";
+			break;
+	}
+
+	return oss.str();
+}
+
+/******************************************************************************
+ * Read the description of a dataset and the list of its files
+ *
+ * @param pXMLFileName XML file describing the dataset
+ * @param pName the dataset name
+ * @param pBrickResolution brick resolution (without borders)
+ * @param pBorderSize brick border size
+ * @param pNbLevels number of levels of resolution
+ * @param pChannels data channels
+ * @param pFiles node, brick and summary files of the dataset
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvdpPacker::readDataset( const std::string& pXMLFileName, std::string& pName,
+							unsigned int& pBrickResolution, unsigned int& pBorderSize, unsigned int& pNbLevels,
+							std::vector< GvDataContainer::Channel >& pChannels, std::vector< GvDataContainer::SectionFile >& pFiles )
+{
+	TiXmlDocument document( pXMLFileName.c_str() );
+	if ( ! document.LoadFile() )
+	{
+		std::cerr << "GvdpPacker::readDataset() : unable to load " << pXMLFileName << std::endl;
+		return false;
+	}
+
+	// File names are relative to the "directory" attribute, itself relative to the XML file
+	const TiXmlElement* model = document.FirstChildElement( "Model" );
+	if ( model == NULL || model->Attribute( "directory" ) == NULL || model->Attribute( "nbLevels" ) == NULL )
+	{
+		std::cerr << "GvdpPacker::readDataset() : invalid Model element in " << pXMLFileName << std::endl;
+		return false;
+	}
+	const std::string directory = pXMLFileName.substr( 0, pXMLFileName.find_last_of( "\\/" ) + 1 ) + model->Attribute( "directory" ) + "/";
+	const unsigned int nbLevels = static_cast< unsigned int >( atoi( model->Attribute( "nbLevels" ) ) );
+	const std::string name = model->Attribute( "name" ) ? model->Attribute( "name" ) : "";
+
+	// Node files, and their summary files when they exist
+	std::vector< GvDataContainer::SectionFile > files;
+	const TiXmlElement* nodeTree = model->FirstChildElement( "NodeTree" );
+	for ( const TiXmlElement* level = nodeTree ? nodeTree->FirstChildElement( "Level" ) : NULL; level != NULL; level = level->NextSiblingElement( "Level" ) )
+	{
+		const unsigned int id = static_cast< unsigned int >( atoi( level->Attribute( "id" ) ? level->Attribute( "id" ) : "-1" ) );
+		if ( id >= nbLevels || level->Attribute( "filename" ) == NULL )
+		{
+			continue;
+		}
+
+		GvDataContainer::SectionFile file;
+		file._type = GvDataContainer::eNodeSection;
+		file._level = id;
+		file._channel = 0;
+		file._fileName = directory + level->Attribute( "filename" );
+		files.push_back( file );
+
+		// Summary file is stored alongside the node file, with ".summary" extension
+		std::string::size_type extensionPosition = file._fileName.rfind( ".nodes" );
+		if ( extensionPosition != std::string::npos )
+		{
+			file._fileName.replace( extensionPosition, std::string( ".nodes" ).size(), ".summary" );
+		}
+		else
+		{
+			file._fileName += ".summary";
+		}
+		FILE* summaryFile = fopen( file._fileName.c_str(), "rb" );
+		if ( summaryFile != NULL )
+		{
+			fclose( summaryFile );
+
+			file._type = GvDataContainer::eSummarySection;
+			files.push_back( file );
+		}
+	}
+
+	// Brick files
+	const TiXmlElement* brickData = model->FirstChildElement( "BrickData" );
+	if ( brickData == NULL || brickData->Attribute( "brickResolution" ) == NULL || brickData->Attribute( "borderSize" ) == NULL )
+	{
+		std::cerr << "GvdpPacker::readDataset() : invalid BrickData element in " << pXMLFileName << std::endl;
+		return false;
+	}
+	const unsigned int brickResolution = static_cast< unsigned int >( atoi( brickData->Attribute( "brickResolution" ) ) );
+	const unsigned int borderSize = static_cast< unsigned int >( atoi( brickData->Attribute( "borderSize" ) ) );
+	std::vector< GvDataContainer::Channel > channels;
+	for ( const TiXmlElement* channel = brickData->FirstChildElement( "Channel" ); channel != NULL; channel = channel->NextSiblingElement( "Channel" ) )
+	{
+		GvDataContainer::Channel description;
+		description._name = channel->Attribute( "name" ) ? channel->Attribute( "name" ) : "";
+		description._typeName = channel->Attribute( "type" ) ? channel->Attribute( "type" ) : "";
+		channels.push_back( description );
+
+		for ( const TiXmlElement* level = channel->FirstChildElement( "Level" ); level != NULL; level = level->NextSiblingElement( "Level" ) )
+		{
+			const unsigned int id = static_cast< unsigned int >( atoi( level->Attribute( "id" ) ? level->Attribute( "id" ) : "-1" ) );
+			if ( id < nbLevels && level->Attribute( "filename" ) != NULL )
+			{
+				GvDataContainer::SectionFile file;
+				file._type = GvDataContainer::eBrickSection;
+				file._level = id;
+				file._channel = static_cast< unsigned int >( channels.size() - 1 );
+				file._fileName = directory + level->Attribute( "filename" );
+				files.push_back( file );
+			}
+		}
+	}
+
+	// Each level needs its node file and one brick file per channel
+	if ( files.size() < nbLevels * ( channels.size() + 1 ) )
+	{
+		std::cerr << "GvdpPacker::readDataset() : missing node or brick files in " << pXMLFileName << std::endl;
+		return false;
+	}
+
+	pName = name;
+	pBrickResolution = brickResolution;
+	pBorderSize = borderSize;
+	pNbLevels = nbLevels;
+	pChannels.swap( channels );
+	pFiles.swap( files );
+
+	return true;
+}
+
+/******************************************************************************
+ * Read a whole file
+ *
+ * @param pFileName the file name
+ * @param pData the file content
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvdpPacker::readFile( const std::string& pFileName, std::vector< unsigned char >& pData )
+{
+	FILE* file = fopen( pFileName.c_str(), "rb" );
+	if ( file == NULL )
+	{
+		std::cerr << "GvdpPacker::readFile() : unable to open " << pFileName << std::endl;
+		return false;
+	}
+
+	// Retrieve the file size
+#ifdef WIN32
+	_fseeki64( file, 0, SEEK_END );
+	const unsigned long long size = static_cast< unsigned long long >( _ftelli64( file ) );
+	_fseeki64( file, 0, SEEK_SET );
+#else
+	fseeko( file, 0, SEEK_END );
+	const unsigned long long size = static_cast< unsigned long long >( ftello( file ) );
+	fseeko( file, 0, SEEK_SET );
+#endif
+
+	pData.resize( static_cast< size_t >( size ) );
+	const bool isOk = pData.empty() || ( fread( &pData[ 0 ], 1, pData.size(), file ) == pData.size() );
+	fclose( file );
+	if ( ! isOk )
+	{
+		std::cerr << "GvdpPacker::readFile() : unable to read " << pFileName << std::endl;
+	}
+
+	return isOk;
+}
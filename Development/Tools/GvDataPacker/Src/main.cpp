@@ -0,0 +1,115 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvdpPacker.h"
+
+// STL
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// Project
+using namespace Gvdp;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Print usage
+ ******************************************************************************/
+static void printUsage()
+{
+	std::cout << "Usage :" << std::endl;
+	std::cout << "  GvDataPacker pack <dataset.xml> <dataset.gvc>" << std::endl;
+	std::cout << "    store a dataset (nodes, bricks and summaries) in a single page-aligned container file" << std::endl;
+	std::cout << "  GvDataPacker unpack <dataset.gvc> [directory]" << std::endl;
+	std::cout << "    write back the separate files of a container and the XML file describing them" << std::endl;
+	std::cout << "  GvDataPacker timeseries <dataset.gvts> <keyframeInterval> <step0.xml> [step1.xml ...]" << std::endl;
+	std::cout << "    store the datasets of the time steps of a time-varying dataset in a delta-coded time series file" << std::endl;
+}
+
+/******************************************************************************
+ * Main entry program
+ *
+ * @param pArgc number of arguments
+ * @param pArgv list of arguments
+ *
+ * @return exit code
+ ******************************************************************************/
+int main( int pArgc, char* pArgv[] )
+{
+	// LOG
+	std::cout << "--------------------------------------" << std::endl;
+	std::cout << "------ GigaVoxels Data Packer --------" << std::endl;
+	std::cout << "--------------------------------------" << std::endl;
+
+	// Parse command line
+	if ( pArgc < 3 )
+	{
+		printUsage();
+		return 1;
+	}
+	const std::string mode = pArgv[ 1 ];
+	if ( mode == "pack" && pArgc == 4 )
+	{
+		return GvdpPacker::pack( pArgv[ 2 ], pArgv[ 3 ] ) ? 0 : 2;
+	}
+	if ( mode == "unpack" && pArgc <= 4 )
+	{
+		return GvdpPacker::unpack( pArgv[ 2 ], ( pArgc == 4 ) ? pArgv[ 3 ] : "." ) ? 0 : 2;
+	}
+	if ( mode == "timeseries" && pArgc >= 5 )
+	{
+		const std::vector< std::string > xmlFileNames( pArgv + 4, pArgv + pArgc );
+		const int keyframeInterval = atoi( pArgv[ 3 ] );
+
+		return GvdpPacker::packTimeSeries( xmlFileNames, pArgv[ 2 ], ( keyframeInterval > 0 ) ? keyframeInterval : 1 ) ? 0 : 2;
+	}
+
+	printUsage();
+
+	return 1;
+}
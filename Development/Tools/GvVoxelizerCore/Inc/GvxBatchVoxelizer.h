@@ -0,0 +1,299 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#ifndef _GVX_BATCH_VOXELIZER_H_
+#define _GVX_BATCH_VOXELIZER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+namespace Gvx
+{
+	class GvxSceneVoxelizer;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace Gvx
+{
+
+/** 
+ * @class GvxBatchVoxelizer
+ *
+ * @brief The GvxBatchVoxelizer class runs the voxelization process without
+ * any user interaction, as a sequence of resumable stages.
+ *
+ * Stages are : voxelize (max level), borders, filter, mipmap (one step per level)
+ * and xml (descriptor file). Each completed step is recorded in a checkpoint file
+ * ("<name>.checkpoint", next to the generated files). When a job is killed, running
+ * it again with the same parameters skips completed steps and restarts at the
+ * first incomplete one.
+ *
+ * Stages that modify the max level files in place (borders, filter) first back up
+ * these files. If a previous run was interrupted during such a stage, its backups
+ * are restored before the stage is run again, so a stage is never applied twice.
+ * Other stages write fresh files and can simply be run again.
+ *
+ * Mip-map stages use the thread and memory budget. It is not part of the checkpoint
+ * signature (generated files don't depend on it), so a job can be resumed on another node.
+ */
+class GvxBatchVoxelizer
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pSceneVoxelizer the scene voxelizer (all its settings must have been done)
+	 */
+	GvxBatchVoxelizer( GvxSceneVoxelizer& pSceneVoxelizer );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvxBatchVoxelizer();
+
+	/**
+	 * Set the filter type
+	 *
+	 * 0 = mean
+	 * 1 = gaussian
+	 * 2 = laplacian
+	 *
+	 * @param pValue the filter type
+	 */
+	void setFilterType( int pValue );
+
+	/**
+	 * Set the number of application of the filter
+	 *
+	 * @param pValue the number of application of the filter
+	 */
+	void setFilterIterations( int pValue );
+
+	/**
+	 * Set the number of threads used by the mip-map stages
+	 * (number of processors by default)
+	 *
+	 * @param pValue the number of threads
+	 */
+	void setNbThreads( unsigned int pValue );
+
+	/**
+	 * Set the max memory size used by a mip-map stage
+	 *
+	 * @param pSize the memory size (in bytes)
+	 */
+	void setMemorySize( size_t pSize );
+
+	/**
+	 * Launch the voxelization process,
+	 * resuming from the last checkpoint if any.
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool execute();
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * The scene voxelizer
+	 */
+	GvxSceneVoxelizer& _sceneVoxelizer;
+
+	/**
+	 * Filter type
+	 */
+	int _filterType;
+
+	/**
+	 * Number of application of the filter
+	 */
+	int _nbFilterApplications;
+
+	/**
+	 * Checkpoint file name
+	 */
+	std::string _checkpointFileName;
+
+	/**
+	 * Steps already completed (as read from/written to the checkpoint file)
+	 */
+	std::vector< std::string > _completedSteps;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Get the signature of the voxelization parameters.
+	 * A checkpoint is only reused by a job with the same signature.
+	 *
+	 * @return the parameters signature
+	 */
+	std::string getSignature() const;
+
+	/**
+	 * Read the checkpoint file (if any)
+	 */
+	void readCheckpoint();
+
+	/**
+	 * Record a completed step and write the checkpoint file.
+	 * The file is replaced atomically (written aside, then renamed).
+	 *
+	 * @param pStep the completed step
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool commitStep( const std::string& pStep );
+
+	/**
+	 * Tell wheter or not a step has been completed
+	 *
+	 * @param pStep the step
+	 *
+	 * @return a flag telling wheter or not the step has been completed
+	 */
+	bool isStepCompleted( const std::string& pStep ) const;
+
+	/**
+	 * Run a stage modifying the max level files in place (borders or filter),
+	 * protected by backups of these files.
+	 *
+	 * @param pStep the stage name
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool executeInPlaceStage( const std::string& pStep );
+
+	/**
+	 * Get the files of a level of resolution (nodes and bricks of all channels)
+	 *
+	 * @param pLevel level of resolution
+	 *
+	 * @return the list of file names
+	 */
+	std::vector< std::string > getLevelFileNames( unsigned int pLevel ) const;
+
+	/**
+	 * Get the backup file name of a file for a given stage
+	 *
+	 * @param pFileName the file name
+	 * @param pStep the stage name
+	 *
+	 * @return the backup file name
+	 */
+	static std::string getBackupFileName( const std::string& pFileName, const std::string& pStep );
+
+	/**
+	 * Tell wheter or not a file exists
+	 *
+	 * @param pFileName the file name
+	 *
+	 * @return a flag telling wheter or not the file exists
+	 */
+	static bool isFileExisting( const std::string& pFileName );
+
+	/**
+	 * Copy a file.
+	 * The destination is written aside, then renamed, so that it is either complete or missing.
+	 *
+	 * @param pSource the source file name
+	 * @param pDestination the destination file name
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	static bool copyFile( const std::string& pSource, const std::string& pDestination );
+
+	/**
+	 * Rename a file, replacing the destination if it exists
+	 *
+	 * @param pSource the source file name
+	 * @param pDestination the destination file name
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	static bool replaceFile( const std::string& pSource, const std::string& pDestination );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvxBatchVoxelizer( const GvxBatchVoxelizer& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvxBatchVoxelizer& operator=( const GvxBatchVoxelizer& );
+
+};
+
+}
+
+#endif
@@ -35,6 +35,7 @@
 
 // STL
 #include <vector>
+#include <set>
 
 // Project
 #include "GvxDataTypeHandler.h"
@@ -98,10 +99,16 @@ public:
 	 */
 	const unsigned int _brickWidth;
 
+	/**
+	 * Brick border size.
+	 * This is the number of border voxels on each side of bricks :
+	 * 1 by default, 0 for borderless bricks (interior voxels only).
+	 */
+	const unsigned int _borderSize;
+
 	/**
 	 * Brick size.
 	 * This is the total number of voxels in a brick by taking to account borders.
-	 * Currently, there is only a border of one voxel on each side of bricks.
 	 */
 	const unsigned int _brickSize;	
 	
@@ -115,12 +122,14 @@ public:
 	 * @param pBrickWidth width of bricks in the data structure
 	 * @param pDataType type of voxel data (i.e. uchar4, float, float4, etc...)
 	 * @param pNewFiles a flag telling wheter or not "new files" are used
+	 * @param pBorderSize border size of bricks (0 or 1)
 	 */
 	GvxDataStructureIOHandler( const std::string& pName, 
 								unsigned int pLevel,
 								unsigned int pBrickWidth,
 								GvxDataTypeHandler::VoxelDataType pDataType,
-								bool pNewFiles );
+								bool pNewFiles,
+								unsigned int pBorderSize = 1 );
 
 	/**
      * Constructor
@@ -130,12 +139,14 @@ public:
 	 * @param pBrickWidth width of bricks in the data structure
 	 * @param pDataTypes types of voxel data (i.e. uchar4, float, float4, etc...)
 	 * @param pNewFiles a flag telling wheter or not "new files" are used
+	 * @param pBorderSize border size of bricks (0 or 1)
 	 */
 	GvxDataStructureIOHandler( const std::string& pName, 
 								unsigned int pLevel,
 								unsigned int pBrickWidth,
 								const std::vector< GvxDataTypeHandler::VoxelDataType >& pDataTypes,
-								bool pNewFiles );
+								bool pNewFiles,
+								unsigned int pBorderSize = 1 );
 
 	/**
      * Destructor
@@ -194,6 +205,13 @@ public:
 	 */
 	unsigned int getBrickNumber() const;
 
+	/**
+	 * Get the types of voxel data of each data channel
+	 *
+	 * @return the types of voxel data
+	 */
+	const std::vector< GvxDataTypeHandler::VoxelDataType >& getDataTypes() const;
+
 	/**
 	 * Get brick data in a node at given data channel
 	 *
@@ -212,6 +230,25 @@ public:
 	 */
 	void setBrick( unsigned int pNodePos[ 3 ], void* pBrickData, unsigned int pDataChannel );
 
+	/**
+	 * Get brick data in a node at given data channel, surrounded by a border of one voxel
+	 * filled from its neighbor nodes, whatever the border size of the data structure.
+	 * The resulting brick has ( _brickWidth + 2 )^3 voxels, the border is null outside the data structure.
+	 *
+	 * @param pNodePos node position
+	 * @param pBrickData brick data
+	 * @param pDataChannel data channel index
+	 */
+	void getBrickWithBorders( unsigned int pNodePos[ 3 ], void* pBrickData, unsigned int pDataChannel );
+
+	/**
+	 * Reset brick data (borders included) of a node in all data channels.
+	 * The node keeps its brick : empty nodes are left untouched.
+	 *
+	 * @param pNodePos node position
+	 */
+	void clearBrick( unsigned int pNodePos[ 3 ] );
+
 	/**
 	 * Get the voxel size at current level of resolution
 	 *
@@ -232,6 +269,23 @@ public:
 	 */
 	void getNodePosition(  float pNormalizedNodePos[ 3 ], unsigned int pNodePos[ 3 ] );
 
+	/**
+	 * Convert a node index to its indexed node position
+	 *
+	 * @param pNodeIndex node index (as stored in the node file)
+	 * @param pNodePos indexed node position
+	 */
+	void getNodePosition( unsigned int pNodeIndex, unsigned int pNodePos[ 3 ] ) const;
+
+	/**
+	 * Convert an indexed node position to its node index
+	 *
+	 * @param pNodePos indexed node position
+	 *
+	 * @return the node index (as stored in the node file)
+	 */
+	unsigned int getNodeIndex( unsigned int pNodePos[ 3 ] ) const;
+
 	/**
 	 * Convert a normalized voxel position to its indexed voxel position
 	 *
@@ -252,9 +306,32 @@ public:
 
 	/**
 	 * Fill all brick borders of the data strucuture with data.
+	 * There is nothing to do for borderless bricks.
 	 */
 	void computeBorders();
 
+	/**
+	 * Fill brick borders around a subset of nodes.
+	 * Each given node copies its data in the borders of its neighbors,
+	 * so a node's own borders are only updated if its neighbors are given too.
+	 * There is nothing to do for borderless bricks.
+	 *
+	 * @param pNodeIndices indices of the nodes (sorted by node index)
+	 */
+	void computeBorders( const std::set< unsigned int >& pNodeIndices );
+
+	/**
+	 * Set empty the nodes of a subset whose brick data (borders included) is null in all data channels,
+	 * as a whole voxelization would have left them.
+	 * Their brick is no longer referenced but stays in the brick files :
+	 * brick indices of the other nodes of the level are unchanged.
+	 *
+	 * @param pNodeIndices indices of the nodes
+	 *
+	 * @return the number of nodes set empty
+	 */
+	unsigned int releaseEmptyBricks( const std::set< unsigned int >& pNodeIndices );
+
 	/**
 	 * Tell wheter or not a node is empty given its node info.
 	 *
@@ -282,6 +359,52 @@ public:
 	 */
 	void loadNodeandBrick( unsigned int pNodePos[ 3 ] );
 
+	/**
+	 * Retrieve the node file name.
+	 * An example of GigaVoxels node file could be : "fux_BR8_B1_L0.nodes"
+	 * where "fux" is the name, "8" is the brick width BR, "1" is the brick border size B,
+	 * "0" is the level of resolution L and "nodes" is the file extension.
+	 *
+	 * @param pName name of the data file
+	 * @param pLevel data structure level of resolution
+	 * @param pBrickWidth width of bricks
+	 * @param pBorderSize border size of bricks
+	 *
+	 * @return the node file name in GigaVoxels format.
+	 */
+	static std::string getFileNameNode( const std::string& pName, unsigned int pLevel, unsigned int pBrickWidth, unsigned int pBorderSize = 1 );
+
+	/**
+	 * Retrieve the brick file name.
+	 * An example of GigaVoxels brick file could be : "fux_BR8_B1_L0_C0_uchar4.bricks"
+	 * where "fux" is the name, "8" is the brick width BR, "1" is the brick border size B,
+	 * "0" is the level of resolution L, "0" is the data channel index C,
+	 * "uchar4" the data type name and "bricks" is the file extension.
+	 *
+	 * @param pName name of the data file
+	 * @param pLevel data structure level of resolution
+	 * @param pBrickWidth width of bricks
+	 * @param pDataChannelIndex data channel index
+	 * @param pDataTypeName data type name
+	 * @param pBorderSize border size of bricks
+	 *
+	 * @return the brick file name in GigaVoxels format.
+	 */
+	static std::string getFileNameBrick( const std::string& pName, unsigned int pLevel, unsigned int pBrickWidth, unsigned int pDataChannelIndex, const std::string& pDataTypeName, unsigned int pBorderSize = 1 );
+
+	/**
+	 * Retrieve the node summary file name (see GvxDataStructureSummaryGenerator).
+	 * It is the node file name with the "summary" file extension, i.e. "fux_BR8_B1_L0.summary".
+	 *
+	 * @param pName name of the data file
+	 * @param pLevel data structure level of resolution
+	 * @param pBrickWidth width of bricks
+	 * @param pBorderSize border size of bricks
+	 *
+	 * @return the node summary file name in GigaVoxels format.
+	 */
+	static std::string getFileNameSummary( const std::string& pName, unsigned int pLevel, unsigned int pBrickWidth, unsigned int pBorderSize = 1 );
+
 
 protected:
 
@@ -333,6 +456,12 @@ protected:
 	 */
 	bool _isBufferLoaded;
 
+	/**
+	 * Flag to tell wheter or not the current node or brick have been modified since they have been loaded.
+	 * Unmodified data is not written back on disk.
+	 */
+	bool _isBufferModified;
+
 	/**
 	 * Buffer of node position.
 	 * It corresponds to the current indexed node position.
@@ -364,6 +493,17 @@ protected:
 	 */
 	void saveNodeandBrick();
 
+	/**
+	 * Copy the data of a node in the borders of its neighbors at given data channel.
+	 * Empty neighbors are created if the node data facing them is not empty.
+	 *
+	 * @param pNodePos node position
+	 * @param pDataChannel data channel index
+	 * @param pBrick brick buffer used to store the node data
+	 * @param pNeighborBrick brick buffer used to store the neighbor data
+	 */
+	void computeNodeBorders( unsigned int pNodePos[ 3 ], unsigned int pDataChannel, void* pBrick, void* pNeighborBrick );
+
 	/**
 	 * Initialize all the files that will be generated.
 	 *
@@ -374,36 +514,6 @@ protected:
 	 */
 	void openFiles( const std::string& name, bool newFiles );
 
-	/**
-	 * Retrieve the node file name.
-	 * An example of GigaVoxels node file could be : "fux_BR8_B1_L0.nodes"
-	 * where "fux" is the name, "8" is the brick width BR, "1" is the brick border size B,
-	 * "0" is the level of resolution L and "nodes" is the file extension.
-	 *
-	 * @param pName name of the data file
-	 * @param pLevel data structure level of resolution
-	 * @param pBrickWidth width of bricks
-	 *
-	 * @return the node file name in GigaVoxels format.
-	 */
-	static std::string getFileNameNode( const std::string& pName, unsigned int pLevel, unsigned int pBrickWidth );
-
-	/**
-	 * Retrieve the brick file name.
-	 * An example of GigaVoxels brick file could be : "fux_BR8_B1_L0_C0_uchar4.bricks"
-	 * where "fux" is the name, "8" is the brick width BR, "1" is the brick border size B,
-	 * "0" is the level of resolution L, "0" is the data channel index C,
-	 * "uchar4" the data type name and "bricks" is the file extension.
-	 *
-	 * @param pName name of the data file
-	 * @param pLevel data structure level of resolution
-	 * @param pBrickWidth width of bricks
-	 * @param pDataChannelIndex data channel index
-	 * @param pDataTypeName data type name
-	 *
-	 * @return the brick file name in GigaVoxels format.
-	 */
-	static std::string getFileNameBrick( const std::string& pName, unsigned int pLevel, unsigned int pBrickWidth, unsigned int pDataChannelIndex, const std::string& pDataTypeName );
 
 	/**
 	 * Create a brick node info (address + brick index)
@@ -0,0 +1,232 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GVX_DATA_STRUCTURE_SUMMARY_GENERATOR_H_
+#define _GVX_DATA_STRUCTURE_SUMMARY_GENERATOR_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <vector>
+#include <string>
+
+// Project
+#include "GvxDataTypeHandler.h"
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Node summary flags (same values as the GigaVoxels library, see GvVoxelizer/GvNodeSummary.h)
+ *
+ * - EMPTY : the node has no brick (all its subtree is empty)
+ * - CONSTANT : all interior voxels of the node brick have the same value
+ * - HOMOGENEOUS : the node and all its subtree have the same value,
+ *   so the node can be made terminal without any loss
+ */
+#define GVX_NODE_SUMMARY_EMPTY_FLAG			0x00000001U
+#define GVX_NODE_SUMMARY_CONSTANT_FLAG		0x00000002U
+#define GVX_NODE_SUMMARY_HOMOGENEOUS_FLAG	0x00000004U
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+namespace Gvx
+{
+	class GvxDataStructureIOHandler;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace Gvx
+{
+
+/**
+ * @struct GvxNodeSummary
+ *
+ * @brief The GvxNodeSummary struct provides a summary of the data
+ * contained in a node of the data structure for one data channel.
+ *
+ * Its memory layout is the one of the GigaVoxels library GvNodeSummary,
+ * so that ".summary" files written by the voxelizer are read by GvDataLoader.
+ *
+ * Note : values are normalized in [ 0.0 ; 1.0 ] for unsigned char data types.
+ * Unused components (i.e. for one-component types) are set to 0.
+ */
+struct GvxNodeSummary
+{
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Min value of each component over the whole subtree of the node
+	 */
+	float _min[ 4 ];
+
+	/**
+	 * Max value of each component over the whole subtree of the node
+	 */
+	float _max[ 4 ];
+
+	/**
+	 * Fraction of non-zero interior voxels in the node brick
+	 */
+	float _occupancy;
+
+	/**
+	 * Summary flags (empty, constant, homogeneous)
+	 */
+	unsigned int _flags;
+
+};
+
+/** 
+ * @class GvxDataStructureSummaryGenerator
+ *
+ * @brief The GvxDataStructureSummaryGenerator class provides methods to compute
+ * per-node summaries (min/max, occupancy, homogeneity) of the levels of a data structure.
+ *
+ * Summaries are computed level by level, from the finest to the coarsest one,
+ * and written in a ".summary" file per level, alongside the ".nodes" file.
+ * The summaries of the finer level are used to propagate min/max values
+ * and homogeneity over the whole subtree of each node.
+ *
+ * Summaries of a level are stored as an array indexed by :
+ * ( x + nodeGridSize * ( y + nodeGridSize * z ) ) * nbChannels + channel
+ */
+class GvxDataStructureSummaryGenerator
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Compute and write the node summaries of all levels of a data structure,
+	 * from the max level of resolution to the level 0.
+	 *
+	 * Note : files of all levels must have been written on disk.
+	 *
+	 * @param pName name of the data (i.e. sponza, sibenik, dragon, etc...)
+	 * @param pLevel max level of resolution
+	 * @param pBrickWidth width of bricks
+	 * @param pDataTypes types of voxel data of each channel
+	 * @param pBorderSize border size of bricks
+	 *
+	 * @return a flag telling wheter or not the process has succeeded
+	 */
+	static bool generateSummaryFiles( const std::string& pName, unsigned int pLevel, unsigned int pBrickWidth, const std::vector< GvxDataTypeHandler::VoxelDataType >& pDataTypes, unsigned int pBorderSize = 1 );
+
+	/**
+	 * Compute the node summaries of a data structure level.
+	 *
+	 * Note : borders of bricks must not be taken into account, only interior voxels are scanned.
+	 *
+	 * @param pIOHandler data structure handler of the level to process
+	 * @param pFinerSummaries node summaries of the finer level (NULL at the finest level)
+	 * @param pSummaries the resulting node summaries
+	 *
+	 * @return a flag telling wheter or not the process has succeeded
+	 */
+	static bool generateSummaries( GvxDataStructureIOHandler& pIOHandler, const std::vector< GvxNodeSummary >* pFinerSummaries, std::vector< GvxNodeSummary >& pSummaries );
+
+	/**
+	 * Write node summaries in a file
+	 *
+	 * @param pFileName summary file name
+	 * @param pSummaries node summaries
+	 *
+	 * @return a flag telling wheter or not the process has succeeded
+	 */
+	static bool writeSummaryFile( const std::string& pFileName, const std::vector< GvxNodeSummary >& pSummaries );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Compute the summary of a brick (interior voxels only)
+	 *
+	 * @param pIOHandler data structure handler
+	 * @param pNodePos node position
+	 * @param pDataChannel data channel index
+	 * @param pBrickData a buffer large enough to store a brick of the data channel
+	 * @param pSummary the resulting summary
+	 */
+	static void computeBrickSummary( GvxDataStructureIOHandler& pIOHandler, unsigned int pNodePos[ 3 ], unsigned int pDataChannel, void* pBrickData, GvxNodeSummary& pSummary );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor forbidden.
+	 */
+	GvxDataStructureSummaryGenerator();
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvxDataStructureSummaryGenerator( const GvxDataStructureSummaryGenerator& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvxDataStructureSummaryGenerator& operator=( const GvxDataStructureSummaryGenerator& );
+
+};
+
+}
+
+#endif
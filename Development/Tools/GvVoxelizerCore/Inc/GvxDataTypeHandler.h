@@ -79,7 +79,8 @@ public:
 		gvUCHAR4,
 		gvFLOAT,
 		gvFLOAT4,
-		gvHALF4
+		gvHALF4,
+		gvUCHAR
 	}
 	VoxelDataType;
 
@@ -106,6 +107,14 @@ public:
      */
 	static void* allocateVoxels( VoxelDataType pDataType, unsigned int pNbElements );
 
+	/**
+     * Free memory allocated by allocateVoxels() for a given data type
+	 *
+	 * @param pDataType the data type used to allocate the memory (i.e. uchar4, float, float4, etc...)
+	 * @param pDataBuffer a pointer on the allocated memory space
+     */
+	static void freeVoxels( VoxelDataType pDataType, void* pDataBuffer );
+
 	/**
      * Retrieve the address of an element of a given data type in an associated buffer
 	 *
@@ -0,0 +1,412 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#ifndef _GVX_OCCLUSION_BAKER_H_
+#define _GVX_OCCLUSION_BAKER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvxDataTypeHandler.h"
+
+// STL
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+namespace Gvx
+{
+	class GvxSceneVoxelizer;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace Gvx
+{
+
+/** 
+ * @class GvxOcclusionBaker
+ *
+ * @brief The GvxOcclusionBaker class bakes ambient occlusion (and optionally
+ * single-bounce irradiance) in an extra channel of an already voxelized data structure,
+ * so that shaders get it with one more fetch instead of tracing secondary rays.
+ *
+ * The opacity (and color) of all levels of resolution is loaded in memory. Then,
+ * for each voxel of the max level of resolution, cones are traced in the hemisphere
+ * around the voxel normal (given by the opacity gradient, all directions when there is none) :
+ * each cone samples the mip-map level matching its diameter, and accumulates
+ * opacity (and color) front to back. Voxels of coarser levels are averaged
+ * from their eight children, weighted by their opacity. Voxels are baked on several threads.
+ *
+ * The channel is written after the channels listed in the XML descriptor file of the data structure,
+ * with the same brick layout (and borders). The descriptor file itself is left untouched :
+ * the baked channel is listed in a separate descriptor file (see writeDescriptorFile()),
+ * so that loaders of the original channels still get them. It is an uchar channel holding the visibility (1 - occlusion), or an
+ * uchar4 channel holding the irradiance bounced by occluders lit by a uniform white sky in RGB
+ * and the visibility in alpha (see GvxSceneVoxelizer::getBakedOcclusionDataType()).
+ */
+class GvxOcclusionBaker
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pSceneVoxelizer the scene voxelizer providing the settings of the data structure
+	 * (file name, max level of resolution, brick width, data type, borderless bricks, baked channel type)
+	 */
+	GvxOcclusionBaker( GvxSceneVoxelizer& pSceneVoxelizer );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvxOcclusionBaker();
+
+	/**
+	 * Set the number of threads used to bake voxels
+	 *
+	 * @param pValue the number of threads
+	 */
+	void setNbThreads( unsigned int pValue );
+
+	/**
+	 * Set the max distance of occluders (cones are not traced further)
+	 *
+	 * @param pValue the distance (the data structure is a unit cube)
+	 */
+	void setMaxDistance( float pValue );
+
+	/**
+	 * Bake the occlusion channel of all levels of resolution
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool execute();
+
+	/**
+	 * Write the XML file describing the data structure with the baked channel :
+	 * it is a copy of the descriptor file of the data structure, with the baked channel
+	 * listed after the other ones (the channel must have been baked, see execute()).
+	 *
+	 * @param pFileName the file name
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool writeDescriptorFile( const std::string& pFileName ) const;
+
+	/**
+	 * Get the name of the XML file describing a data structure with its baked channel
+	 *
+	 * @param pName name of the data structure
+	 *
+	 * @return the file name ("<name>_occlusion.xml")
+	 */
+	static std::string getDescriptorFileName( const std::string& pName );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Level of resolution held in memory
+	 */
+	struct Level
+	{
+		/**
+		 * Number of nodes along each axis
+		 */
+		unsigned int _nodeGridSize;
+
+		/**
+		 * Nodes (as stored in the node file)
+		 */
+		std::vector< unsigned int > _nodes;
+
+		/**
+		 * Node index of each brick (the number of nodes if no node refers to the brick)
+		 */
+		std::vector< unsigned int > _brickNodes;
+
+		/**
+		 * Opacity and color (RGB, premultiplied) of the voxels of the bricks (without borders)
+		 */
+		std::vector< unsigned char > _opacities;
+		std::vector< unsigned char > _colors;
+
+		/**
+		 * Baked data of the voxels of the bricks (without borders)
+		 */
+		std::vector< unsigned char > _bakedData;
+	};
+
+	/**
+	 * Bricks of a level baked by a thread
+	 */
+	struct BakeTask
+	{
+		/**
+		 * The occlusion baker
+		 */
+		GvxOcclusionBaker* _baker;
+
+		/**
+		 * Level of resolution
+		 */
+		unsigned int _level;
+
+		/**
+		 * First brick, and number of bricks between two bricks of the task
+		 */
+		unsigned int _firstBrick;
+		unsigned int _brickStep;
+	};
+
+	/**
+	 * Cone traced from a voxel
+	 */
+	struct Cone
+	{
+		/**
+		 * Direction
+		 */
+		float _direction[ 3 ];
+
+		/**
+		 * Weight
+		 */
+		float _weight;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * The scene voxelizer
+	 */
+	GvxSceneVoxelizer& _sceneVoxelizer;
+
+	/**
+	 * Number of threads used to bake voxels
+	 */
+	unsigned int _nbThreads;
+
+	/**
+	 * Max distance of occluders
+	 */
+	float _maxDistance;
+
+	/**
+	 * Brick width and border size
+	 */
+	unsigned int _brickWidth;
+	unsigned int _borderSize;
+
+	/**
+	 * Number of components of the baked channel (1 : occlusion, 4 : irradiance and occlusion)
+	 */
+	unsigned int _nbBakedComponents;
+
+	/**
+	 * Index of the baked channel (number of channels of the data structure)
+	 */
+	unsigned int _channel;
+
+	/**
+	 * Levels of resolution
+	 */
+	std::vector< Level > _levels;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Read the number of channels of the data structure in its XML descriptor file
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool readDescriptorFile();
+
+	/**
+	 * Load the node file and the opacity (and color) of the first channel of a level
+	 *
+	 * @param pLevel level of resolution
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool loadLevel( unsigned int pLevel );
+
+	/**
+	 * Write the baked channel of a level
+	 *
+	 * @param pLevel level of resolution
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool writeLevel( unsigned int pLevel );
+
+	/**
+	 * Bake bricks of a level : cone tracing at the max level of resolution,
+	 * averaging of the children otherwise
+	 *
+	 * @param pLevel level of resolution
+	 * @param pFirstBrick first brick
+	 * @param pBrickStep number of bricks between two baked bricks
+	 */
+	void bakeBricks( unsigned int pLevel, unsigned int pFirstBrick, unsigned int pBrickStep );
+
+	/**
+	 * Bake a voxel of the max level of resolution by cone tracing
+	 *
+	 * @param pVoxelPos voxel position
+	 * @param pBakedData the baked data of the voxel
+	 */
+	void traceVoxel( const int pVoxelPos[ 3 ], unsigned char* pBakedData ) const;
+
+	/**
+	 * Bake a voxel of a coarser level from its children
+	 *
+	 * @param pLevel level of resolution
+	 * @param pVoxelPos voxel position
+	 * @param pBakedData the baked data of the voxel
+	 */
+	void filterVoxel( unsigned int pLevel, const int pVoxelPos[ 3 ], unsigned char* pBakedData ) const;
+
+	/**
+	 * Trace a cone and accumulate opacity and color front to back
+	 *
+	 * @param pOrigin origin of the cone
+	 * @param pDirection direction of the cone
+	 * @param pOcclusion the accumulated occlusion
+	 * @param pColor the accumulated color
+	 */
+	void traceCone( const float pOrigin[ 3 ], const float pDirection[ 3 ], float& pOcclusion, float pColor[ 3 ] ) const;
+
+	/**
+	 * Sample opacity and color of a level with trilinear interpolation
+	 *
+	 * @param pLevel level of resolution
+	 * @param pPosition position (the data structure is a unit cube)
+	 * @param pOpacity the opacity
+	 * @param pColor the color (premultiplied)
+	 */
+	void sampleLevel( unsigned int pLevel, const float pPosition[ 3 ], float& pOpacity, float pColor[ 3 ] ) const;
+
+	/**
+	 * Retrieve the index of a voxel in the bricks of a level (bricks without borders)
+	 *
+	 * @param pLevel level of resolution
+	 * @param pVoxelPos voxel position
+	 *
+	 * @return the index of the voxel, -1 if it is outside the data structure or in an empty node
+	 */
+	long long getVoxelIndex( unsigned int pLevel, const int pVoxelPos[ 3 ] ) const;
+
+	/**
+	 * Get the opacity of a voxel
+	 *
+	 * @param pLevel level of resolution
+	 * @param pVoxelPos voxel position
+	 *
+	 * @return the opacity (0 outside the data structure and in empty nodes)
+	 */
+	float getOpacity( unsigned int pLevel, const int pVoxelPos[ 3 ] ) const;
+
+	/**
+	 * Run bake tasks, one thread per task
+	 *
+	 * @param pTasks the tasks
+	 */
+	static void runBakeTasks( std::vector< BakeTask >& pTasks );
+
+	/**
+	 * Thread entry point of a bake task
+	 *
+	 * @param pTask the task
+	 *
+	 * @return NULL
+	 */
+	static void* runBakeTask( void* pTask );
+
+	/**
+	 * Build the cones of a hemisphere
+	 *
+	 * @param pNormal axis of the hemisphere
+	 * @param pCones the cones (they are appended to the list)
+	 */
+	static void buildHemisphereCones( const float pNormal[ 3 ], std::vector< Cone >& pCones );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvxOcclusionBaker( const GvxOcclusionBaker& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvxOcclusionBaker& operator=( const GvxOcclusionBaker& );
+
+};
+
+}
+
+#endif
@@ -0,0 +1,366 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#ifndef _GVX_POINT_CLOUD_READER_H_
+#define _GVX_POINT_CLOUD_READER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <string>
+#include <vector>
+
+// System
+#include <cstdio>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace Gvx
+{
+
+/** 
+ * @class GvxPointCloudReader
+ *
+ * @brief The GvxPointCloudReader class streams the points of a point cloud file,
+ * one point after the other, so that point sets larger than memory can be read.
+ *
+ * Supported formats :
+ * - PLY (".ply") : ascii, binary little endian and binary big endian.
+ * The "vertex" element must be the first one. Its "x", "y", "z" properties are required,
+ * "red", "green", "blue" (or "r", "g", "b") and "nx", "ny", "nz" are optional.
+ * Other properties are skipped.
+ * - XYZ (any other extension) : one point per line, with 3 columns (x y z), 4 columns (x y z intensity),
+ * 6 columns (x y z r g b), 7 columns (x y z intensity r g b, as in PTS files) or 9 columns (x y z r g b nx ny nz).
+ * Lines starting with '#' are skipped. Intensities are skipped.
+ * Colors are integers in [ 0 ; 255 ] or reals in [ 0 ; 1 ] (as written for the first point).
+ */
+class GvxPointCloudReader
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Point
+	 */
+	struct Point
+	{
+		/**
+		 * Position
+		 */
+		double _position[ 3 ];
+
+		/**
+		 * Color (in [ 0 ; 1 ], white if the file has no color)
+		 */
+		float _color[ 3 ];
+
+		/**
+		 * Normal (null if the file has no normal)
+		 */
+		float _normal[ 3 ];
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvxPointCloudReader();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvxPointCloudReader();
+
+	/**
+	 * Open a point cloud file and read its header
+	 *
+	 * @param pFileName the point cloud file name
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool open( const std::string& pFileName );
+
+	/**
+	 * Close the point cloud file
+	 */
+	void close();
+
+	/**
+	 * Go back to the first point
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool rewind();
+
+	/**
+	 * Read the next point
+	 *
+	 * @param pPoint the point
+	 *
+	 * @return false at the end of the points (or on a read error, see hasError())
+	 */
+	bool readPoint( Point& pPoint );
+
+	/**
+	 * Tell wheter or not a read error occured
+	 *
+	 * @return a flag telling wheter or not a read error occured
+	 */
+	bool hasError() const;
+
+	/**
+	 * Tell wheter or not points have colors
+	 *
+	 * @return a flag telling wheter or not points have colors
+	 */
+	bool hasColors() const;
+
+	/**
+	 * Tell wheter or not points have normals
+	 *
+	 * @return a flag telling wheter or not points have normals
+	 */
+	bool hasNormals() const;
+
+	/**
+	 * Get the number of points given by the file header
+	 *
+	 * @return the number of points (0 if the format has no header)
+	 */
+	unsigned long long getNbPoints() const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * File format
+	 */
+	enum EFormat
+	{
+		eXYZ,
+		ePLYAscii,
+		ePLYBinaryLittleEndian,
+		ePLYBinaryBigEndian
+	};
+
+	/**
+	 * Property of the PLY "vertex" element
+	 */
+	struct Property
+	{
+		/**
+		 * Size of the property (in bytes)
+		 */
+		unsigned int _size;
+
+		/**
+		 * Flag telling wheter or not the property is a floating point value
+		 */
+		bool _isFloat;
+
+		/**
+		 * Flag telling wheter or not the property is signed
+		 */
+		bool _isSigned;
+
+		/**
+		 * Scale applied to the property (colors are brought in [ 0 ; 1 ])
+		 */
+		double _scale;
+
+		/**
+		 * Point attribute filled by the property :
+		 * 0 to 2 for position, 3 to 5 for color, 6 to 8 for normal, -1 if it is skipped
+		 */
+		int _attribute;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Point cloud file
+	 */
+	FILE* _file;
+
+	/**
+	 * File format
+	 */
+	EFormat _format;
+
+	/**
+	 * Offset of the first point in the file (in bytes)
+	 */
+	long long _dataOffset;
+
+	/**
+	 * Number of points given by the file header
+	 */
+	unsigned long long _nbPoints;
+
+	/**
+	 * Number of points already read
+	 */
+	unsigned long long _nbReadPoints;
+
+	/**
+	 * Properties of the PLY "vertex" element
+	 */
+	std::vector< Property > _properties;
+
+	/**
+	 * Size of a binary PLY vertex (in bytes)
+	 */
+	unsigned int _vertexSize;
+
+	/**
+	 * Buffer used to read a binary PLY vertex
+	 */
+	std::vector< unsigned char > _vertexBuffer;
+
+	/**
+	 * Flag telling wheter or not points have colors
+	 */
+	bool _hasColors;
+
+	/**
+	 * Flag telling wheter or not points have normals
+	 */
+	bool _hasNormals;
+
+	/**
+	 * Point attribute filled by each column of a XYZ file (see Property::_attribute)
+	 */
+	std::vector< int > _columns;
+
+	/**
+	 * Scale applied to colors of a XYZ file
+	 */
+	double _colorScale;
+
+	/**
+	 * Flag telling wheter or not a read error occured
+	 */
+	bool _hasError;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Read the header of a PLY file
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool readPLYHeader();
+
+	/**
+	 * Read the first point of a XYZ file to find its columns
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool readXYZHeader();
+
+	/**
+	 * Read the next line of a text file
+	 *
+	 * @param pLine the line
+	 *
+	 * @return false at the end of the file
+	 */
+	bool readLine( std::string& pLine );
+
+	/**
+	 * Set the values of a point
+	 *
+	 * @param pValues values of the point attributes (position, color and normal)
+	 * @param pPoint the point
+	 */
+	void setPoint( const double pValues[ 9 ], Point& pPoint ) const;
+
+	/**
+	 * Decode a binary PLY property
+	 *
+	 * @param pProperty the property
+	 * @param pData the property data
+	 *
+	 * @return the property value
+	 */
+	double decodeProperty( const Property& pProperty, const unsigned char* pData ) const;
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvxPointCloudReader( const GvxPointCloudReader& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvxPointCloudReader& operator=( const GvxPointCloudReader& );
+
+};
+
+}
+
+#endif
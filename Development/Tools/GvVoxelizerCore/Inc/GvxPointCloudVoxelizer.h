@@ -0,0 +1,495 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#ifndef _GVX_POINT_CLOUD_VOXELIZER_H_
+#define _GVX_POINT_CLOUD_VOXELIZER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvxDataTypeHandler.h"
+
+// STL
+#include <string>
+#include <vector>
+
+// System
+#include <cstdio>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+namespace Gvx
+{
+	class GvxSceneVoxelizer;
+	class GvxPointCloudReader;
+	class GvxDataStructureIOHandler;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace Gvx
+{
+
+/** 
+ * @class GvxPointCloudVoxelizer
+ *
+ * @brief The GvxPointCloudVoxelizer class voxelizes point clouds larger than memory
+ * (see GvxPointCloudReader for supported formats).
+ *
+ * The voxelization is out-of-core :
+ * - the points are read a first time to compute the bounding box (normalized as meshes are),
+ * - the points are read a second time : each one is given the Morton key of its voxel
+ * at the max level of resolution, and points are sorted by key in runs of bounded size
+ * (with several threads) written in temporary files,
+ * - runs are merged : voxels come in Morton order, so that the voxels of a brick come
+ * one after the other. Each brick is written as soon as it is complete, and the eight
+ * children of a node come one after the other too, so that the mip-map levels are
+ * built from the same stream (a single pending brick per level).
+ *
+ * Points are splatted in their voxel, or in the eight nearest voxels with trilinear weights.
+ * Colors are averaged and the density (alpha) is the splatted weight relative to
+ * the number of points that make a voxel opaque. Normals are averaged too.
+ * Only the uchar4 data type is supported, with the optional half4 normal channel.
+ */
+class GvxPointCloudVoxelizer
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pSceneVoxelizer the scene voxelizer providing the settings of the data structure
+	 * (file name, max level of resolution, brick width, data type, normals, borderless bricks)
+	 */
+	GvxPointCloudVoxelizer( GvxSceneVoxelizer& pSceneVoxelizer );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvxPointCloudVoxelizer();
+
+	/**
+	 * Set the max memory size used to sort points
+	 *
+	 * @param pSize the memory size (in bytes)
+	 */
+	void setMemorySize( size_t pSize );
+
+	/**
+	 * Set the number of threads used to sort points
+	 *
+	 * @param pValue the number of threads
+	 */
+	void setNbThreads( unsigned int pValue );
+
+	/**
+	 * Set the number of points that make a voxel opaque
+	 *
+	 * @param pValue the number of points
+	 */
+	void setNbPointsPerVoxel( float pValue );
+
+	/**
+	 * Set wheter or not points are splatted in the eight nearest voxels
+	 *
+	 * @param pFlag the flag
+	 */
+	void setSplatting( bool pFlag );
+
+	/**
+	 * Voxelize a point cloud : all levels of resolution are written
+	 *
+	 * @param pFileName the point cloud file name
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool execute( const std::string& pFileName );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Point splatted in a voxel
+	 */
+	struct PointRecord
+	{
+		/**
+		 * Morton key of the voxel at the max level of resolution
+		 */
+		unsigned long long _key;
+
+		/**
+		 * Splatting weight
+		 */
+		float _weight;
+
+		/**
+		 * Color
+		 */
+		unsigned char _color[ 4 ];
+
+		/**
+		 * Normal
+		 */
+		float _normal[ 3 ];
+	};
+
+	/**
+	 * Sorted run of points read back from its temporary file
+	 */
+	struct Run
+	{
+		/**
+		 * Run file
+		 */
+		FILE* _file;
+
+		/**
+		 * Number of points not read yet from the file
+		 */
+		unsigned long long _nbRemainingPoints;
+
+		/**
+		 * Points read from the file
+		 */
+		std::vector< PointRecord > _buffer;
+
+		/**
+		 * Index of the next point in the buffer
+		 */
+		size_t _position;
+	};
+
+	/**
+	 * Part of the points sorted by a thread, or two sorted parts merged by a thread
+	 */
+	struct SortTask
+	{
+		/**
+		 * First point
+		 */
+		PointRecord* _first;
+
+		/**
+		 * End of the first sorted part (merge only)
+		 */
+		PointRecord* _middle;
+
+		/**
+		 * End of the points
+		 */
+		PointRecord* _last;
+
+		/**
+		 * Output of the merge (NULL to sort)
+		 */
+		PointRecord* _output;
+	};
+
+	/**
+	 * Brick of a mip-map level, accumulating the bricks of its child nodes
+	 */
+	struct PendingBrick
+	{
+		/**
+		 * Flag telling wheter or not a child node has been accumulated
+		 */
+		bool _isValid;
+
+		/**
+		 * Morton key of the node
+		 */
+		unsigned long long _key;
+
+		/**
+		 * Sum of the colors of the child voxels
+		 */
+		std::vector< float > _colors;
+
+		/**
+		 * Sum of the normals of the child voxels
+		 */
+		std::vector< float > _normals;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * The scene voxelizer
+	 */
+	GvxSceneVoxelizer& _sceneVoxelizer;
+
+	/**
+	 * Max memory size used to sort points (in bytes)
+	 */
+	size_t _memorySize;
+
+	/**
+	 * Number of threads used to sort points
+	 */
+	unsigned int _nbThreads;
+
+	/**
+	 * Number of points that make a voxel opaque
+	 */
+	float _nbPointsPerVoxel;
+
+	/**
+	 * Flag telling wheter or not points are splatted in the eight nearest voxels
+	 */
+	bool _isSplattingOn;
+
+	/**
+	 * Normalization applied to points : they are centered on 0.5 then scaled
+	 */
+	double _normalizationCenter[ 3 ];
+	double _normalizationScale;
+
+	/**
+	 * Number of bits of a voxel position along each axis, at the max level of resolution
+	 */
+	unsigned int _nbVoxelBits;
+
+	/**
+	 * Number of bits of a voxel position in a brick along each axis
+	 */
+	unsigned int _nbBrickBits;
+
+	/**
+	 * Names of the temporary run files
+	 */
+	std::vector< std::string > _runFileNames;
+
+	/**
+	 * Data channels
+	 */
+	std::vector< GvxDataTypeHandler::VoxelDataType > _dataTypes;
+
+	/**
+	 * Data structures of all levels of resolution
+	 */
+	std::vector< GvxDataStructureIOHandler* > _dataStructureIOHandlers;
+
+	/**
+	 * Pending brick of each mip-map level
+	 */
+	std::vector< PendingBrick > _pendingBricks;
+
+	/**
+	 * Morton key of the leaf brick being accumulated (the flag tells wheter or not there is one)
+	 */
+	unsigned long long _leafKey;
+	bool _isLeafValid;
+
+	/**
+	 * Splatted weight, weighted colors and weighted normals of the voxels of the leaf brick
+	 */
+	std::vector< float > _leafWeights;
+	std::vector< float > _leafColors;
+	std::vector< float > _leafNormals;
+
+	/**
+	 * Number of bricks written
+	 */
+	unsigned long long _nbBricks;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Compute the normalization of points from their bounding box
+	 *
+	 * @param pReader the point cloud reader
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool computeNormalization( GvxPointCloudReader& pReader );
+
+	/**
+	 * Splat points in voxels and write sorted runs
+	 *
+	 * @param pReader the point cloud reader
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool createRuns( GvxPointCloudReader& pReader );
+
+	/**
+	 * Sort points and write them in a new run file
+	 *
+	 * @param pPoints the points
+	 * @param pBuffer buffer used to merge sorted parts (as large as the points)
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool writeRun( std::vector< PointRecord >& pPoints, std::vector< PointRecord >& pBuffer );
+
+	/**
+	 * Merge the runs : points are accumulated in Morton order
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool mergeRuns();
+
+	/**
+	 * Remove the temporary run files
+	 */
+	void removeRuns();
+
+	/**
+	 * Accumulate a point in the leaf brick
+	 *
+	 * @param pPoint the point
+	 */
+	void addPoint( const PointRecord& pPoint );
+
+	/**
+	 * Write the leaf brick and accumulate it in its parent
+	 */
+	void flushLeafBrick();
+
+	/**
+	 * Write a brick and accumulate it in its parent
+	 *
+	 * @param pLevel level of resolution of the brick
+	 * @param pKey Morton key of the node
+	 * @param pColors colors of the brick (with the border size of the data structure)
+	 * @param pNormals normals of the brick (with the border size of the data structure, if any)
+	 */
+	void addBrick( unsigned int pLevel, unsigned long long pKey, unsigned char* pColors, unsigned short* pNormals );
+
+	/**
+	 * Write the pending brick of a mip-map level and accumulate it in its parent
+	 *
+	 * @param pLevel level of resolution of the brick
+	 */
+	void flushPendingBrick( unsigned int pLevel );
+
+	/**
+	 * Sort points with several threads
+	 *
+	 * @param pPoints the points
+	 * @param pBuffer buffer used to merge sorted parts (as large as the points)
+	 * @param pNbThreads number of threads
+	 */
+	static void sortPoints( std::vector< PointRecord >& pPoints, std::vector< PointRecord >& pBuffer, unsigned int pNbThreads );
+
+	/**
+	 * Run sort tasks, one thread per task
+	 *
+	 * @param pTasks the tasks
+	 */
+	static void runSortTasks( std::vector< SortTask >& pTasks );
+
+	/**
+	 * Thread entry point of a sort task
+	 *
+	 * @param pTask the task
+	 *
+	 * @return NULL
+	 */
+	static void* runSortTask( void* pTask );
+
+	/**
+	 * Compare the Morton keys of two points
+	 *
+	 * @param pPoint1 the first point
+	 * @param pPoint2 the second point
+	 *
+	 * @return a flag telling wheter or not the key of the first point is less than the key of the second one
+	 */
+	static bool isKeyLess( const PointRecord& pPoint1, const PointRecord& pPoint2 );
+
+	/**
+	 * Interleave the bits of a position (21 bits along each axis)
+	 *
+	 * @param pPosition the position
+	 *
+	 * @return the Morton key
+	 */
+	static unsigned long long encodeMortonKey( const unsigned int pPosition[ 3 ] );
+
+	/**
+	 * Retrieve a position from its Morton key
+	 *
+	 * @param pKey the Morton key
+	 * @param pPosition the position
+	 */
+	static void decodeMortonKey( unsigned long long pKey, unsigned int pPosition[ 3 ] );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvxPointCloudVoxelizer( const GvxPointCloudVoxelizer& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvxPointCloudVoxelizer& operator=( const GvxPointCloudVoxelizer& );
+
+};
+
+}
+
+#endif
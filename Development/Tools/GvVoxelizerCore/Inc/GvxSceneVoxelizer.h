@@ -95,6 +95,111 @@ public:
 	 */
 	virtual bool launchVoxelizationProcess();
 
+	/**
+	 * Voxelize the scene at the max level of resolution only.
+	 * Post-voxelization stages (borders, filter, mipmap) are not applied :
+	 * they can be run afterwards through the voxelizer engine.
+	 * All settings must have been done previously (i.e. filename, path, etc...)
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool launchVoxelizationStage();
+
+	/**
+	 * Update a previous voxelization of the scene incrementally.
+	 * Only the leaf nodes touched by triangles that differ between the previous
+	 * and the current version of the scene are revoxelized, then borders and
+	 * mip-map levels are recomputed along their neighbors and ancestor chains.
+	 *
+	 * The data structure files of the previous version must exist with the current
+	 * settings (file name, resolution, brick width, data type, normals) and no filter.
+	 * Both versions are voxelized with the normalization of the previous voxelization
+	 * (see writeNormalizationFile()), so a change of the scene bounding box keeps voxels in place.
+	 * The whole scene is voxelized again only if it no longer fits in that normalization.
+	 *
+	 * @param pPreviousScene the previous version of the scene (with its own file name)
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool launchIncrementalVoxelizationProcess( GvxSceneVoxelizer& pPreviousScene );
+
+	/**
+	 * Voxelize one tile of the scene : a sub-cube of the node grid at the max level of resolution.
+	 * Only the leaf level of the tile is generated, in files named after the tile,
+	 * along with a tile descriptor file. Tiles are then stitched together by GvxTileMerger.
+	 * All settings must have been done previously (i.e. filename, path, etc...)
+	 *
+	 * @param pTileOrigin indexed position of the first node of the tile
+	 * @param pTileSize number of nodes of the tile along each axis
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool launchTileVoxelizationProcess( const unsigned int pTileOrigin[ 3 ], unsigned int pTileSize );
+
+	/**
+	 * Write the XML file describing the generated data structure
+	 * (levels of resolution, channels and associated files).
+	 *
+	 * @param pFileName the XML file name
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool writeDescriptorFile( const std::string& pFileName ) const;
+
+	/**
+	 * Write the normalization applied to the scene in the "<file name>.normalization" file,
+	 * so that a later incremental update voxelizes in the same space.
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool writeNormalizationFile() const;
+
+	/**
+	 * Read the normalization of a previous voxelization from the "<file name>.normalization" file
+	 *
+	 * @param pCenter center of the normalization
+	 * @param pScale scale of the normalization
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool readNormalizationFile( float pCenter[ 3 ], float& pScale ) const;
+
+	/**
+	 * Fix the normalization of the scene : vertices are centered and scaled with the given values
+	 * instead of fitting the scene bounding box.
+	 *
+	 * @param pCenter center of the normalization (vertices are centered on 0.5)
+	 * @param pScale scale of the normalization
+	 */
+	void setNormalization( const float pCenter[ 3 ], float pScale );
+
+	/**
+	 * Get the normalization applied to the scene
+	 *
+	 * @param pCenter center of the normalization
+	 * @param pScale scale of the normalization
+	 */
+	void getNormalization( float pCenter[ 3 ], float& pScale ) const;
+
+	/**
+	 * Tell wheter or not the normalization of the scene is fixed
+	 *
+	 * @return a flag telling wheter or not the normalization of the scene is fixed
+	 */
+	bool hasFixedNormalization() const;
+
+	/**
+	 * Release the fixed normalization : the scene bounding box is fitted again
+	 */
+	void resetNormalization();
+
+	/**
+	 * Get the voxelizer engine
+	 *
+	 * @return the voxelizer engine
+	 */
+	GvxVoxelizerEngine& getVoxelizerEngine();
+
 	/**
 	 * Get the data file path
 	 *
@@ -165,6 +270,28 @@ public:
 	 */
 	void setGenerateNormalsOn( bool pFlag );
 
+	/**
+	 * Tell wheter or not the baked ambient occlusion channel (see GvxOcclusionBaker) holds single-bounce irradiance too
+	 *
+	 * @return a flag telling wheter or not the baked channel holds single-bounce irradiance
+	 */
+	bool isBakedIrradianceOn() const;
+
+	/**
+	 * Set the flag telling wheter or not the baked ambient occlusion channel holds single-bounce irradiance too
+	 *
+	 * @param pFlag the flag telling wheter or not the baked channel holds single-bounce irradiance
+	 */
+	void setBakedIrradianceOn( bool pFlag );
+
+	/**
+	 * Get the data type of the baked ambient occlusion channel :
+	 * uchar (occlusion), or uchar4 (irradiance in RGB, occlusion in alpha)
+	 *
+	 * @return the data type of the baked channel
+	 */
+	GvxDataTypeHandler::VoxelDataType getBakedOcclusionDataType() const;
+
 	/**
 	 * Get the brick width
 	 *
@@ -212,6 +339,12 @@ public:
 	 */
 	void setNormals ( bool normals);
 
+	/**
+	 * Set whether or not bricks are stored without borders
+	 * (borders are then reconstructed at load time)
+	 */
+	void setBorderless( bool pFlag );
+
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
 	 **************************************************************************/
@@ -246,6 +379,11 @@ protected:
 	 */
 	bool _isGenerateNormalsOn;
 
+	/**
+	 * Flag to tell wheter or not the baked ambient occlusion channel holds single-bounce irradiance too
+	 */
+	bool _isBakedIrradianceOn;
+
 	/**
 	 * Brick width
 	 */
@@ -260,6 +398,19 @@ protected:
 	 * Voxelizer engine
 	 */
 	GvxVoxelizerEngine _voxelizerEngine;
+
+	/**
+	 * Normalization applied to the scene (set by normalizeScene()) :
+	 * vertices are centered on 0.5 then scaled.
+	 */
+	float _normalizationCenter[ 3 ];
+	float _normalizationScale;
+
+	/**
+	 * Flag telling wheter or not the normalization is fixed (see setNormalization()).
+	 * normalizeScene() then fails if the scene doesn't fit in the normalized space.
+	 */
+	bool _isNormalizationFixed;
 	
 	/******************************** METHODS *********************************/
 
@@ -272,6 +423,7 @@ protected:
 	 * Normalize the scene.
 	 * It determines the whole scene bounding box and then modifies vertices
 	 * to scale the scene.
+	 * With a fixed normalization, vertices are left unchanged if the scene doesn't fit in the normalized space.
 	 */
 	virtual bool normalizeScene();
 
@@ -280,6 +432,16 @@ protected:
 	 */
 	virtual bool voxelizeScene();
 
+	/**
+	 * Give all triangles of the scene to a voxelizer engine
+	 * (materials, textures and vertex attributes), in a deterministic order.
+	 *
+	 * @param pVoxelizerEngine the voxelizer engine
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	virtual bool voxelizeTriangles( GvxVoxelizerEngine& pVoxelizerEngine );
+
 	/**
 	 * Apply the mip-mapping algorithmn.
 	 * Given a pre-filtered voxel scene at a given level of resolution,
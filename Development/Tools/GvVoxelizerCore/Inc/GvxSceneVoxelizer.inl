@@ -135,6 +135,37 @@ inline void GvxSceneVoxelizer::setGenerateNormalsOn( bool pFlag )
 	_isGenerateNormalsOn = pFlag;
 }
 
+/******************************************************************************
+ * Tell wheter or not the baked ambient occlusion channel (see GvxOcclusionBaker) holds single-bounce irradiance too
+ *
+ * @return a flag telling wheter or not the baked channel holds single-bounce irradiance
+ ******************************************************************************/
+inline bool GvxSceneVoxelizer::isBakedIrradianceOn() const
+{
+	return _isBakedIrradianceOn;
+}
+
+/******************************************************************************
+ * Set the flag telling wheter or not the baked ambient occlusion channel holds single-bounce irradiance too
+ *
+ * @param pFlag the flag telling wheter or not the baked channel holds single-bounce irradiance
+ ******************************************************************************/
+inline void GvxSceneVoxelizer::setBakedIrradianceOn( bool pFlag )
+{
+	_isBakedIrradianceOn = pFlag;
+}
+
+/******************************************************************************
+ * Get the data type of the baked ambient occlusion channel :
+ * uchar (occlusion), or uchar4 (irradiance in RGB, occlusion in alpha)
+ *
+ * @return the data type of the baked channel
+ ******************************************************************************/
+inline GvxDataTypeHandler::VoxelDataType GvxSceneVoxelizer::getBakedOcclusionDataType() const
+{
+	return _isBakedIrradianceOn ? GvxDataTypeHandler::gvUCHAR4 : GvxDataTypeHandler::gvUCHAR;
+}
+
 /******************************************************************************
  * Get the brick width
  *
@@ -175,4 +206,52 @@ inline void GvxSceneVoxelizer::setDataType( GvxDataTypeHandler::VoxelDataType pT
 	_dataType = pType;
 }
 
+/******************************************************************************
+ * Fix the normalization of the scene : vertices are centered and scaled with the given values
+ * instead of fitting the scene bounding box.
+ *
+ * @param pCenter center of the normalization (vertices are centered on 0.5)
+ * @param pScale scale of the normalization
+ ******************************************************************************/
+inline void GvxSceneVoxelizer::setNormalization( const float pCenter[ 3 ], float pScale )
+{
+	_normalizationCenter[ 0 ] = pCenter[ 0 ];
+	_normalizationCenter[ 1 ] = pCenter[ 1 ];
+	_normalizationCenter[ 2 ] = pCenter[ 2 ];
+	_normalizationScale = pScale;
+	_isNormalizationFixed = true;
+}
+
+/******************************************************************************
+ * Get the normalization applied to the scene
+ *
+ * @param pCenter center of the normalization
+ * @param pScale scale of the normalization
+ ******************************************************************************/
+inline void GvxSceneVoxelizer::getNormalization( float pCenter[ 3 ], float& pScale ) const
+{
+	pCenter[ 0 ] = _normalizationCenter[ 0 ];
+	pCenter[ 1 ] = _normalizationCenter[ 1 ];
+	pCenter[ 2 ] = _normalizationCenter[ 2 ];
+	pScale = _normalizationScale;
+}
+
+/******************************************************************************
+ * Tell wheter or not the normalization of the scene is fixed
+ *
+ * @return a flag telling wheter or not the normalization of the scene is fixed
+ ******************************************************************************/
+inline bool GvxSceneVoxelizer::hasFixedNormalization() const
+{
+	return _isNormalizationFixed;
+}
+
+/******************************************************************************
+ * Release the fixed normalization : the scene bounding box is fitted again
+ ******************************************************************************/
+inline void GvxSceneVoxelizer::resetNormalization()
+{
+	_isNormalizationFixed = false;
+}
+
 }
@@ -0,0 +1,311 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GVX_TEXTURE_CACHE_H_
+#define _GVX_TEXTURE_CACHE_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <string>
+#include <vector>
+#include <map>
+#include <cstddef>
+
+// System
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace Gvx
+{
+
+/** 
+ * @class GvxTextureCache
+ *
+ * @brief The GvxTextureCache class provides the textures sampled by the voxelizer.
+ *
+ * Textures are loaded once, converted to 8-bit RGBA and stored with their
+ * whole mip-map pyramid (box filtered). They are shared by all scene voxelizers
+ * and voxelizer engines of the process (see get()), and can be accessed from several threads.
+ *
+ * A texture is referenced between acquire() and release() : while referenced, it stays
+ * in memory. Unreferenced textures are kept for later use, and the least recently used
+ * ones are evicted when the memory size of the cache exceeds its max memory size
+ * (the max memory size can only be exceeded by textures currently referenced).
+ */
+class GvxTextureCache
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Texture with its mip-map pyramid (8-bit RGBA texels).
+	 *
+	 * Texel data is never modified once loaded, so sampling needs no lock.
+	 */
+	struct Texture
+	{
+		/**
+		 * Image file name
+		 */
+		std::string _filename;
+
+		/**
+		 * Width of each mip-map level
+		 */
+		std::vector< unsigned int > _widths;
+
+		/**
+		 * Height of each mip-map level
+		 */
+		std::vector< unsigned int > _heights;
+
+		/**
+		 * Offset of the first texel of each mip-map level in the texel buffer
+		 */
+		std::vector< size_t > _offsets;
+
+		/**
+		 * Texels of all mip-map levels (RGBA, 8 bits per component)
+		 */
+		std::vector< unsigned char > _texels;
+
+		/**
+		 * Number of references (see acquire() and release())
+		 */
+		unsigned int _nbReferences;
+
+		/**
+		 * Last use (value of the use counter of the cache)
+		 */
+		unsigned long long _lastUse;
+
+		/**
+		 * Get the number of mip-map levels
+		 *
+		 * @return the number of mip-map levels
+		 */
+		unsigned int getNbLevels() const;
+
+		/**
+		 * Get the memory size of the texels
+		 *
+		 * @return the memory size (in bytes)
+		 */
+		size_t getMemorySize() const;
+
+		/**
+		 * Sample the texture (nearest texel).
+		 * The mip-map level is selected from the footprint of the sample, i.e. the extent
+		 * of the sampled area (a voxel) in texture space : the level is the one where
+		 * this extent is closest to one texel.
+		 *
+		 * @param pS s texture coordinate (positive)
+		 * @param pT t texture coordinate (positive)
+		 * @param pFootprint extent of the sampled area in texture coordinates
+		 * @param pColor the sampled color (RGBA, normalized in [ 0.0 ; 1.0 ])
+		 */
+		void sample( float pS, float pT, float pFootprint, float pColor[ 4 ] ) const;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Get the texture cache shared by all voxelizers
+	 *
+	 * @return the texture cache
+	 */
+	static GvxTextureCache& get();
+
+	/**
+	 * Get a texture, loading it if it is not in the cache.
+	 * The texture stays in memory until it is released.
+	 *
+	 * @param pFilename the image filename
+	 *
+	 * @return the texture (NULL if the image can't be loaded)
+	 */
+	const Texture* acquire( const std::string& pFilename );
+
+	/**
+	 * Release a texture previously acquired
+	 *
+	 * @param pTexture the texture (NULL is ignored)
+	 */
+	void release( const Texture* pTexture );
+
+	/**
+	 * Set the max memory size of the cache.
+	 * Unreferenced textures are evicted if needed.
+	 *
+	 * @param pSize the max memory size (in bytes)
+	 */
+	void setMaxMemorySize( size_t pSize );
+
+	/**
+	 * Get the max memory size of the cache
+	 *
+	 * @return the max memory size (in bytes)
+	 */
+	size_t getMaxMemorySize() const;
+
+	/**
+	 * Get the memory size of the textures in the cache
+	 *
+	 * @return the memory size (in bytes)
+	 */
+	size_t getMemorySize() const;
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Textures, by filename
+	 */
+	std::map< std::string, Texture* > _textures;
+
+	/**
+	 * Memory size of the textures
+	 */
+	size_t _memorySize;
+
+	/**
+	 * Max memory size
+	 */
+	size_t _maxMemorySize;
+
+	/**
+	 * Use counter (incremented on each access, used to find the least recently used texture)
+	 */
+	unsigned long long _useCounter;
+
+#ifndef WIN32
+	/**
+	 * Mutex protecting the cache (not the texel data).
+	 *
+	 * Note : voxelizers only run several threads with pthread, so there is no lock on Windows.
+	 */
+	mutable pthread_mutex_t _mutex;
+#endif
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvxTextureCache();
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvxTextureCache();
+
+	/**
+	 * Lock the mutex protecting the cache
+	 */
+	void lock() const;
+
+	/**
+	 * Unlock the mutex protecting the cache
+	 */
+	void unlock() const;
+
+	/**
+	 * Evict the least recently used unreferenced textures
+	 * until the memory size fits in the max memory size.
+	 * The mutex must be locked.
+	 *
+	 * @param pNeededSize memory size needed for a new texture (in bytes)
+	 */
+	void evict( size_t pNeededSize );
+
+	/**
+	 * Load an image file as a 8-bit RGBA texture and build its mip-map pyramid
+	 *
+	 * @param pFilename the image filename
+	 * @param pTexture the texture
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	static bool load( const std::string& pFilename, Texture& pTexture );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvxTextureCache( const GvxTextureCache& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvxTextureCache& operator=( const GvxTextureCache& );
+
+};
+
+}
+
+#endif
@@ -0,0 +1,258 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef _GVX_TILE_MERGER_H_
+#define _GVX_TILE_MERGER_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <string>
+#include <vector>
+#include <map>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+namespace Gvx
+{
+	class GvxSceneVoxelizer;
+}
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace Gvx
+{
+
+/** 
+ * @class GvxTileMerger
+ *
+ * @brief The GvxTileMerger class stitches the partial outputs of several tile
+ * voxelizations into one data structure.
+ *
+ * A tile is a sub-cube of the node grid at the max level of resolution. Each tile
+ * is voxelized by its own process (see GvxSceneVoxelizer::launchTileVoxelizationProcess()),
+ * which writes the leaf level of the tile only, without borders, plus a tile descriptor
+ * file ("<tile name>.tile").
+ *
+ * The descriptor stores the tile settings and, for each node of the tile, the index
+ * of its first voxel write in the global write sequence of the voxelizer. Bricks are
+ * copied in that order, so that they get the same brick indices as in a single-process
+ * voxelization. Borders (including the ones across tiles), filter and mip-map levels
+ * are then generated as usual : the merged result is identical, byte for byte,
+ * to a single-process run.
+ *
+ * Tile descriptor layout (native endianness) :
+ * - 7 unsigned int : level, brick width, tile origin (x, y, z), tile size, number of nodes N
+ * - N unsigned int : node indices
+ * - N unsigned long long : index of the first write of each node
+ */
+class GvxTileMerger
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 *
+	 * @param pSceneVoxelizer the scene voxelizer providing the settings of the merged
+	 * data structure (file name, max level of resolution, brick width, data type, normals, filter)
+	 */
+	GvxTileMerger( GvxSceneVoxelizer& pSceneVoxelizer );
+
+	/**
+	 * Destructor
+	 */
+	virtual ~GvxTileMerger();
+
+	/**
+	 * Add a tile to merge
+	 *
+	 * @param pTileName name of the tile data (i.e. its descriptor file name without the ".tile" extension)
+	 */
+	void addTile( const std::string& pTileName );
+
+	/**
+	 * Merge the tiles : the leaf level is assembled from all tiles,
+	 * then borders, filter and mip-map levels are generated.
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool execute();
+
+	/**
+	 * Get the name of the data of a tile
+	 *
+	 * @param pName name of the whole data (i.e. sponza, dragon, sibenik, etc...)
+	 * @param pTileOrigin indexed position of the first node of the tile
+	 *
+	 * @return the name of the tile data
+	 */
+	static std::string getTileName( const std::string& pName, const unsigned int pTileOrigin[ 3 ] );
+
+	/**
+	 * Write a tile descriptor file
+	 *
+	 * @param pTileName name of the tile data
+	 * @param pLevel max level of resolution
+	 * @param pBrickWidth brick width
+	 * @param pTileOrigin indexed position of the first node of the tile
+	 * @param pTileSize number of nodes of the tile along each axis
+	 * @param pNodeWrites index of the first write of each node of the tile, by node index
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	static bool writeTileDescriptor( const std::string& pTileName, unsigned int pLevel, unsigned int pBrickWidth,
+									const unsigned int pTileOrigin[ 3 ], unsigned int pTileSize,
+									const std::map< unsigned int, unsigned long long >& pNodeWrites );
+
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Tile descriptor
+	 */
+	struct Tile
+	{
+		/**
+		 * Name of the tile data
+		 */
+		std::string _name;
+
+		/**
+		 * Indexed position of the first node of the tile
+		 */
+		unsigned int _origin[ 3 ];
+
+		/**
+		 * Number of nodes of the tile along each axis
+		 */
+		unsigned int _size;
+
+		/**
+		 * Indices of the non-empty nodes of the tile
+		 */
+		std::vector< unsigned int > _nodeIndices;
+
+		/**
+		 * Index of the first write of each node
+		 */
+		std::vector< unsigned long long > _nodeWrites;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * The scene voxelizer
+	 */
+	GvxSceneVoxelizer& _sceneVoxelizer;
+
+	/**
+	 * Names of the tiles to merge
+	 */
+	std::vector< std::string > _tileNames;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Read a tile descriptor file
+	 *
+	 * @param pTileName name of the tile data
+	 * @param pTile the tile descriptor
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool readTileDescriptor( const std::string& pTileName, Tile& pTile ) const;
+
+	/**
+	 * Check that tiles lie in the node grid and do not overlap
+	 *
+	 * @param pTiles the tile descriptors
+	 *
+	 * @return a flag telling wheter or not tiles are valid
+	 */
+	bool checkTiles( const std::vector< Tile >& pTiles ) const;
+
+	/**
+	 * Assemble the leaf level from the data of all tiles
+	 *
+	 * @param pTiles the tile descriptors
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool mergeLeafLevel( const std::vector< Tile >& pTiles );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvxTileMerger( const GvxTileMerger& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvxTileMerger& operator=( const GvxTileMerger& );
+
+};
+
+}
+
+#endif
@@ -0,0 +1,750 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#ifndef _GVX_VOXELIZER_ENGINE_H_
+#define _GVX_VOXELIZER_ENGINE_H_
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvxDataStructureIOHandler.h"
+#include "GvxDataTypeHandler.h"
+#include "GvxTextureCache.h"
+
+// STL
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+namespace Gvx
+{
+
+/** 
+ * @class GvxVoxelizerEngine
+ *
+ * @brief The GvxVoxelizerEngine class provides a client interface to voxelize a mesh.
+ *
+ * It is the core class that, given data at triangle (vertices, normals, textures, etc...),
+ * generate voxel data in the GigaVoxels data structure (i.e. octree).
+ *
+ * An existing data structure can also be updated incrementally when the scene changes :
+ * triangles of the previous and the new scene are compared, only the leaf nodes touched
+ * by added or removed triangles are revoxelized, then borders and mip-map levels are
+ * recomputed along their neighbors and ancestor chains only.
+ *
+ * The voxelization can also be restricted to a tile (a sub-cube of the node grid
+ * at the max level of resolution) so that it can be distributed over several
+ * processes. Partial outputs are stitched together by GvxTileMerger.
+ */
+class GvxVoxelizerEngine
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Incremental voxelization stages.
+	 * Triangles given to voxelizeTriangle() are handled according to the current stage :
+	 * - eFullVoxelization : triangles are voxelized (default)
+	 * - eRegisterTriangles : triangles of the previous scene are registered
+	 * - eMarkAddedTriangles : triangles of the new scene that have not been registered mark their nodes dirty
+	 * - eMarkRemovedTriangles : registered triangles not found in the new scene mark their nodes dirty
+	 * - eUpdateDirtyNodes : triangles of the new scene are voxelized in dirty nodes only
+	 */
+	enum EIncrementalStage
+	{
+		eFullVoxelization,
+		eRegisterTriangles,
+		eMarkAddedTriangles,
+		eMarkRemovedTriangles,
+		eUpdateDirtyNodes
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/**
+	 * Flag to tell wheter or not to handle textures
+	 */
+	bool _useTexture;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Constructor
+	 */
+	GvxVoxelizerEngine();
+
+	/**
+	 * Destructor
+	 */
+	~GvxVoxelizerEngine();
+
+	/**
+	 * Initialize the voxelizer
+	 *
+	 * Call before voxelization
+	 *
+	 * @param pLevel Max level of resolution
+	 * @param pBrickWidth Width a brick
+	 * @param pName Filename to be processed
+	 * @param pDataType Data type that will be processed
+	 */
+	void init( int pLevel, int pBrickWidth, const std::string& pName, GvxDataTypeHandler::VoxelDataType pDataType );
+
+	/**
+	 * Set the data structure parameters without creating its files.
+	 *
+	 * Call instead of init() to run the post-voxelization stages
+	 * (borders, filter, mipmap) on previously voxelized data.
+	 *
+	 * @param pLevel Max level of resolution
+	 * @param pBrickWidth Width a brick
+	 * @param pName Filename to be processed
+	 * @param pDataType Data type that will be processed
+	 */
+	void setup( int pLevel, int pBrickWidth, const std::string& pName, GvxDataTypeHandler::VoxelDataType pDataType );
+	
+	/**
+	 * Finalize the voxelizer
+	 *
+	 * Call after voxelization.
+	 * It runs all post-voxelization stages : borders, filter, mipmap and node summaries.
+	 */
+	void end();
+
+	/**
+	 * Close the data structure of the max level of resolution,
+	 * so that its files are written on disk.
+	 */
+	void closeDataStructure();
+
+	/**
+	 * Apply the update borders algorithmn at the max level of resolution.
+	 * Fill borders with data.
+	 */
+	void updateBorders();
+
+	/**
+	 * Apply the filtering algorithm at the max level of resolution
+	 */
+	void applyFilter();
+
+	/**
+	 * Apply the mip-mapping algorithmn.
+	 * Given a pre-filtered voxel scene at a given level of resolution,
+	 * it generates a mip-map pyramid hierarchy of coarser levels (until 0).
+	 */
+	void mipmap();
+
+	/**
+	 * Generate one level of the mip-map pyramid hierarchy from the next finer level.
+	 * Files of the generated level are written on disk when the method returns.
+	 *
+	 * @param pLevel level of resolution to generate (the finer level must exist)
+	 */
+	void mipmapLevel( int pLevel );
+
+	/**
+	 * Write the node summaries (min/max, occupancy, homogeneity) of all levels of resolution,
+	 * so that producers can classify nodes without reading their bricks (see GvDataLoader).
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool generateSummaries();
+
+	/**
+	 * Start the incremental update of previously voxelized data.
+	 * The data structure files of the max level of resolution are reopened
+	 * and the stage is set to eRegisterTriangles.
+	 *
+	 * Note : filtering is not supported, data must have been generated without filter.
+	 *
+	 * @param pLevel Max level of resolution
+	 * @param pBrickWidth Width a brick
+	 * @param pName Filename to be processed
+	 * @param pDataType Data type that will be processed
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool beginIncrementalVoxelization( int pLevel, int pBrickWidth, const std::string& pName, GvxDataTypeHandler::VoxelDataType pDataType );
+
+	/**
+	 * Set the incremental voxelization stage.
+	 * Entering the eUpdateDirtyNodes stage clears the bricks of dirty nodes.
+	 *
+	 * @param pStage the incremental voxelization stage
+	 */
+	void setIncrementalStage( EIncrementalStage pStage );
+
+	/**
+	 * Get the incremental voxelization stage
+	 *
+	 * @return the incremental voxelization stage
+	 */
+	EIncrementalStage getIncrementalStage() const;
+
+	/**
+	 * Mark dirty the leaf nodes touched by the current triangle.
+	 * It can be used directly (before the eUpdateDirtyNodes stage)
+	 * to provide an explicit list of changed triangles.
+	 */
+	void markTriangle();
+
+	/**
+	 * Get the number of dirty leaf nodes
+	 *
+	 * @return the number of dirty leaf nodes
+	 */
+	unsigned int getNbDirtyNodes() const;
+
+	/**
+	 * Finalize the incremental update.
+	 * Borders are computed around dirty nodes, then mip-map levels
+	 * are generated along their ancestor chains only.
+	 * Updated nodes left without data are set empty at each level.
+	 */
+	void endIncrementalVoxelization();
+
+	/**
+	 * Restrict the voxelization to a tile of the node grid at the max level of resolution.
+	 * Call before init() : data files are then named after the tile (see GvxTileMerger::getTileName())
+	 * and only the leaf level is generated.
+	 *
+	 * @param pTileOrigin indexed position of the first node of the tile
+	 * @param pTileSize number of nodes of the tile along each axis (0 to voxelize the whole scene)
+	 */
+	void setTile( const unsigned int pTileOrigin[ 3 ], unsigned int pTileSize );
+
+	/**
+	 * Tell wheter or not the voxelization is restricted to a tile
+	 *
+	 * @return a flag telling wheter or not the voxelization is restricted to a tile
+	 */
+	bool hasTile() const;
+
+	/**
+	 * Finalize a tile voxelization.
+	 * Files of the leaf level are closed (no borders, filter nor mipmap)
+	 * and the tile descriptor file is written next to them.
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool endTile();
+
+	/**
+	  * Voxelize a triangle.
+	 *
+	 * Given vertex attributes previously set for a triangle (positions, normals,
+	 * colors and texture coordinates), it voxelizes triangle (by writing data). 
+	 */
+	void voxelizeTriangle();
+
+	/**
+	 * Store a 3D position in the vertex buffer.
+	 * During voxelization, each triangle attribute is stored.
+	 * Due to kind of circular buffer technique, calling setVertex() method on each vertex
+	 * of a triangle, register each position internally.
+	 *
+	 * @param pX x coordinate
+	 * @param pY y coordinate
+	 * @param pZ z coordinate
+	 */
+	void setVertex( float pX, float pY, float pZ );
+
+	/**
+	 * Store a nomal in the buffer of normals.
+	 * During voxelization, each triangle attribute is stored.
+	 * Due to kind of circular buffer technique, calling setNormal() method on each vertex
+	 * of a triangle, register each normal internally.
+	 *
+	 * @param pX x normal component
+	 * @param pY y normal component
+	 * @param pZ z normal component
+	 */
+	void setNormal( float pX, float pY, float pZ );
+
+	/**
+	 * Store a color in the color buffer.
+	 * During voxelization, each triangle attribute is stored.
+	 * Due to kind of circular buffer technique, calling setColor() method on each vertex
+	 * of a triangle, register each color internally.
+	 *
+	 * @param pR red color component
+	 * @param pG green color component
+	 * @param pB blue color component
+	 */
+	void setColor( float pR, float pG, float pB );
+
+	/**
+	 * Store a texture coordinates in the texture coordinates buffer.
+	 * During voxelization, each triangle attribute is stored.
+	 * Due to kind of circular buffer technique, calling setTexCoord() method on each vertex
+	 * of a triangle, register each texture coordinate internally.
+	 *
+	 * @param pR r texture coordinate
+	 * @param pS s texture coordinate
+	 */
+	void setTexCoord( float pR, float pS );
+
+	/**
+	 * Construct image from reading an image file.
+	 *
+	 * @param pFilename the image filename
+	 */
+	void setTexture( const std::string& pFilename );
+
+	/**
+	 * Set The number of times we apply the filter
+	 */
+	void setNbFilterApplications(int pValue);
+
+	/**
+	 * Set the type of the filter 
+	 * 0 = mean
+	 * 1 = gaussian
+	 * 2 = laplacian
+	 */
+	void setFilterType (int pValue);
+
+	/**
+	 * Set the _normals value
+	 */
+	void setNormals( bool value);
+
+	/**
+	 * Set the flag telling wheter or not bricks are stored without borders.
+	 * Bricks of all levels are then written with their interior voxels only
+	 * and borders are never computed (they are reconstructed at load time from neighbor bricks).
+	 *
+	 * Note : nodes are not created for borders of empty neighbors,
+	 * so the reconstructed borders are only taken from non-empty bricks.
+	 */
+	void setBorderless( bool pFlag );
+
+	/**
+	 * Tell wheter or not bricks are stored without borders
+	 *
+	 * @return the borderless flag
+	 */
+	bool isBorderless() const;
+
+	/**
+	 * Get the border size of bricks in data structure files
+	 *
+	 * @return 0 for borderless bricks, 1 otherwise
+	 */
+	unsigned int getBorderSize() const;
+
+	/**
+	 * Set the number of threads used to generate the mip-map levels (1 by default).
+	 * With several threads, nodes are processed by batches (see setMemorySize()).
+	 *
+	 * @param pValue the number of threads
+	 */
+	void setNbThreads( unsigned int pValue );
+
+	/**
+	 * Set the max memory size used to generate a mip-map level with several threads.
+	 * A batch of coarser nodes is held in memory along with the bricks of their children.
+	 *
+	 * @param pSize the memory size (in bytes)
+	 */
+	void setMemorySize( size_t pSize );
+	
+	/**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/**
+	 * Mip-map task : nodes of a batch processed by one thread
+	 */
+	struct MipmapTask
+	{
+		/**
+		 * The voxelizer engine
+		 */
+		const GvxVoxelizerEngine* _engine;
+
+		/**
+		 * Bricks of the children of the nodes of the batch (8 bricks of all channels per node)
+		 */
+		const unsigned char* _childBricks;
+
+		/**
+		 * Flags of the non-empty children of the nodes of the batch (one bit per child)
+		 */
+		const unsigned char* _childMasks;
+
+		/**
+		 * Generated bricks of the nodes of the batch (all channels)
+		 */
+		unsigned char* _bricks;
+
+		/**
+		 * Number of nodes of the batch
+		 */
+		size_t _nbNodes;
+
+		/**
+		 * Index of the first node processed by the task
+		 */
+		size_t _firstNode;
+
+		/**
+		 * Step between two nodes processed by the task
+		 */
+		size_t _nodeStep;
+	};
+
+	/******************************* ATTRIBUTES *******************************/
+	
+	/**
+	 * List of types that will be used during voxelization (i.e. ucahr4, float, float4, etc...)
+	 */
+	std::vector< GvxDataTypeHandler::VoxelDataType > _dataTypes;
+
+	/**
+	 * File/stream handler.
+	 * It ios used to read and/ or write to GigaVoxels files (internal format).
+	 */
+	GvxDataStructureIOHandler* _dataStructureIOHandler;
+	
+	/**
+	 * Filename to be processed.
+	 * Currently, this is just a name like "sponza", not a real path+filename.
+	 */
+	std::string _fileName;
+	
+	/**
+	 * Brick width
+	 */
+	int _brickWidth;
+	
+	/**
+	 * Max level of resolution
+	 */
+	int _level;
+
+	/**
+	 * The number of times we apply the filter
+	 */
+	int _nbFilterApplications;
+
+	/**
+	 * the type of the filter 
+	 * 0 = mean
+	 * 1 = gaussian
+	 * 2 = laplacian
+	 */
+	int _filterType;
+
+	/**
+	 * bool that says whether or not we produce normals
+	 */
+	bool _normals;
+
+	/**
+	 * Flag telling wheter or not bricks are stored without borders
+	 */
+	bool _isBorderless;
+
+	/**
+	 * Number of threads used to generate the mip-map levels
+	 */
+	unsigned int _nbThreads;
+
+	/**
+	 * Max memory size used to generate a mip-map level with several threads (in bytes)
+	 */
+	size_t _memorySize;
+
+
+	// primitives
+
+	/**
+	 * Vertices of a triangle
+	 */
+	float _v1[ 3 ];
+	float _v2[ 3 ];
+	float _v3[ 3 ];
+
+	/**
+	 * Normals of a triangle
+	 */
+	float _n1[ 3 ];
+	float _n2[ 3 ];
+	float _n3[ 3 ];
+
+	/**
+	 * Colors of a triangle
+	 */
+	float _c1[ 3 ];
+	float _c2[ 3 ];
+	float _c3[ 3 ];
+
+	/**
+	 * Texture coordinates of a triangle
+	 */
+	float _t1[ 2 ];
+	float _t2[ 2 ];
+	float _t3[ 2 ];
+
+	/**
+	 * Current texture (8-bit RGBA with mip-map levels, shared through the texture cache)
+	 */
+	const GvxTextureCache::Texture* _texture;
+
+	/**
+	 * Current texture filename (used to identify triangles during an incremental update)
+	 */
+	std::string _textureName;
+
+	/**
+	 * Current incremental voxelization stage
+	 */
+	EIncrementalStage _incrementalStage;
+
+	/**
+	 * Sorted signatures of the registered triangles (previous scene)
+	 */
+	std::vector< unsigned long long > _triangleSignatures;
+
+	/**
+	 * Number of registered triangles per signature that have not been found yet in the new scene
+	 */
+	std::vector< unsigned int > _triangleSignatureCounts;
+
+	/**
+	 * Indices of the dirty nodes at the max level of resolution
+	 */
+	std::set< unsigned int > _dirtyNodes;
+
+	/**
+	 * Indexed position of the first node of the tile
+	 */
+	unsigned int _tileOrigin[ 3 ];
+
+	/**
+	 * Number of nodes of the tile along each axis (0 if the voxelization is not restricted to a tile)
+	 */
+	unsigned int _tileSize;
+
+	/**
+	 * Number of voxel writes issued since init(), including the ones outside the tile
+	 */
+	unsigned long long _writeIndex;
+
+	/**
+	 * Index of the first write of each node of the tile, by node index.
+	 * It gives the order in which a single process would have created their bricks.
+	 */
+	std::map< unsigned int, unsigned long long > _tileNodeWrites;
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Apply the normalize algorithmn
+	 */
+	void normalize();
+
+	/**
+	 * Compute the signature of the current triangle
+	 * from all its attributes used during voxelization.
+	 *
+	 * @return the triangle signature
+	 */
+	unsigned long long getTriangleSignature() const;
+
+	/**
+	 * Consume one registered triangle with the given signature.
+	 *
+	 * @param pSignature a triangle signature
+	 *
+	 * @return a flag telling wheter or not a registered triangle has been found
+	 */
+	bool consumeTriangleSignature( unsigned long long pSignature );
+
+	/**
+	 * Retrieve the range of leaf nodes touched by the current triangle
+	 * (taking into account the 2 voxels width splatting).
+	 *
+	 * @param pMinNodePos min indexed node position
+	 * @param pMaxNodePos max indexed node position
+	 */
+	void getTriangleNodeRange( unsigned int pMinNodePos[ 3 ], unsigned int pMaxNodePos[ 3 ] ) const;
+
+	/**
+	 * Tell wheter or not the current triangle touches a dirty node
+	 *
+	 * @return a flag telling wheter or not the current triangle touches a dirty node
+	 */
+	bool isTriangleDirty() const;
+
+	/**
+	 * Tell wheter or not a voxel is in a dirty node
+	 *
+	 * @param pVoxelPos voxel position
+	 *
+	 * @return a flag telling wheter or not a voxel is in a dirty node
+	 */
+	bool isDirtyVoxel( unsigned int pVoxelPos[ 3 ] ) const;
+
+	/**
+	 * Reset the bricks of dirty nodes before revoxelizing them
+	 */
+	void clearDirtyBricks();
+
+	/**
+	 * Tell wheter or not the current triangle touches the tile
+	 *
+	 * @return a flag telling wheter or not the current triangle touches the tile
+	 */
+	bool isTriangleInTile() const;
+
+	/**
+	 * Tell wheter or not a voxel is in the tile
+	 *
+	 * @param pVoxelPos voxel position
+	 *
+	 * @return a flag telling wheter or not a voxel is in the tile
+	 */
+	bool isTileVoxel( unsigned int pVoxelPos[ 3 ] ) const;
+
+	/**
+	 * Add the neighbors of the given nodes to the list
+	 *
+	 * @param pNodeIndices indices of the nodes
+	 * @param pNodeGridSize node grid size of the associated level of resolution
+	 */
+	static void addNeighborNodes( std::set< unsigned int >& pNodeIndices, unsigned int pNodeGridSize );
+
+	/**
+	 * Generate the data of one node of a coarser level from the next finer level
+	 *
+	 * @param pDataStructureIOHandlerUP data structure at the finer level
+	 * @param pDataStructureIOHandlerDOWN data structure at the coarser level
+	 * @param pNodePos position of a non-empty node at the finer level
+	 */
+	void mipmapNode( GvxDataStructureIOHandler* pDataStructureIOHandlerUP, GvxDataStructureIOHandler* pDataStructureIOHandlerDOWN, unsigned int pNodePos[ 3 ] );
+
+	/**
+	 * Regenerate a subset of nodes of one level of the mip-map pyramid hierarchy
+	 * from the next finer level, then their borders.
+	 *
+	 * @param pLevel level of resolution to update (the finer level must exist)
+	 * @param pNodeIndices indices of the nodes to update at this level
+	 */
+	void mipmapLevel( int pLevel, const std::set< unsigned int >& pNodeIndices );
+
+	/**
+	 * Generate one level of the mip-map pyramid hierarchy from the next finer level
+	 * with several threads.
+	 *
+	 * Coarser nodes are processed by batches fitting in the memory size : the main thread
+	 * reads the bricks of their children, threads average them, then the main thread
+	 * writes the generated bricks in the order mipmapLevel() would have created them,
+	 * so that files are identical.
+	 *
+	 * @param pLevel level of resolution to generate (the finer level must exist)
+	 */
+	void mipmapLevelByBatches( int pLevel );
+
+	/**
+	 * Generate the bricks of the nodes of a batch handled by a mip-map task
+	 *
+	 * @param pTask the mip-map task
+	 */
+	void mipmapBricks( const MipmapTask& pTask ) const;
+
+	/**
+	 * Run mip-map tasks, one thread per task
+	 *
+	 * @param pTasks the tasks
+	 */
+	static void runMipmapTasks( std::vector< MipmapTask >& pTasks );
+
+	/**
+	 * Thread entry point of a mip-map task
+	 *
+	 * @param pTask the task
+	 *
+	 * @return NULL
+	 */
+	static void* runMipmapTask( void* pTask );
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+	/**
+	 * Copy constructor forbidden.
+	 */
+	GvxVoxelizerEngine( const GvxVoxelizerEngine& );
+
+	/**
+	 * Copy operator forbidden.
+	 */
+	GvxVoxelizerEngine& operator=( const GvxVoxelizerEngine& );
+
+};
+
+}
+
+#endif
@@ -0,0 +1,588 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#include "GvxBatchVoxelizer.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvxSceneVoxelizer.h"
+#include "GvxVoxelizerEngine.h"
+#include "GvxDataStructureIOHandler.h"
+#include "GvxDataTypeHandler.h"
+
+// STL
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+// System
+#include <cstdio>
+#ifndef WIN32
+	#include <unistd.h>
+#endif
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// Project
+using namespace Gvx;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * First line of checkpoint files
+ */
+static const char* cCheckpointHeader = "GvVoxelizer checkpoint 1";
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pSceneVoxelizer the scene voxelizer (all its settings must have been done)
+ ******************************************************************************/
+GvxBatchVoxelizer::GvxBatchVoxelizer( GvxSceneVoxelizer& pSceneVoxelizer )
+:	_sceneVoxelizer( pSceneVoxelizer )
+,	_filterType( 0 )
+,	_nbFilterApplications( 0 )
+,	_checkpointFileName()
+,	_completedSteps()
+{
+#ifndef WIN32
+	const long nbProcessors = sysconf( _SC_NPROCESSORS_ONLN );
+	_sceneVoxelizer.getVoxelizerEngine().setNbThreads( ( nbProcessors > 0 ) ? static_cast< unsigned int >( nbProcessors ) : 1 );
+#endif
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvxBatchVoxelizer::~GvxBatchVoxelizer()
+{
+}
+
+/******************************************************************************
+ * Set the filter type
+ *
+ * @param pValue the filter type
+ ******************************************************************************/
+void GvxBatchVoxelizer::setFilterType( int pValue )
+{
+	_filterType = pValue;
+	_sceneVoxelizer.setFilterType( pValue );
+}
+
+/******************************************************************************
+ * Set the number of application of the filter
+ *
+ * @param pValue the number of application of the filter
+ ******************************************************************************/
+void GvxBatchVoxelizer::setFilterIterations( int pValue )
+{
+	_nbFilterApplications = pValue;
+	_sceneVoxelizer.setFilterIterations( pValue );
+}
+
+/******************************************************************************
+ * Set the number of threads used by the mip-map stages
+ *
+ * @param pValue the number of threads
+ ******************************************************************************/
+void GvxBatchVoxelizer::setNbThreads( unsigned int pValue )
+{
+	_sceneVoxelizer.getVoxelizerEngine().setNbThreads( pValue );
+}
+
+/******************************************************************************
+ * Set the max memory size used by a mip-map stage
+ *
+ * @param pSize the memory size (in bytes)
+ ******************************************************************************/
+void GvxBatchVoxelizer::setMemorySize( size_t pSize )
+{
+	_sceneVoxelizer.getVoxelizerEngine().setMemorySize( pSize );
+}
+
+/******************************************************************************
+ * Launch the voxelization process,
+ * resuming from the last checkpoint if any.
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxBatchVoxelizer::execute()
+{
+	GvxVoxelizerEngine& voxelizerEngine = _sceneVoxelizer.getVoxelizerEngine();
+	const unsigned int maxLevel = _sceneVoxelizer.getMaxResolution();
+
+	// Retrieve previous progress
+	_checkpointFileName = _sceneVoxelizer.getFileName() + ".checkpoint";
+	readCheckpoint();
+
+	// Voxelization of the max level of resolution
+	if ( ! isStepCompleted( "voxelize" ) )
+	{
+		std::cout << "GvxBatchVoxelizer : stage [ voxelize ]" << std::endl;
+
+		// Backups left by another job are meaningless for the new data
+		const std::vector< std::string > fileNames = getLevelFileNames( maxLevel );
+		for ( size_t i = 0; i < fileNames.size(); i++ )
+		{
+			remove( getBackupFileName( fileNames[ i ], "borders" ).c_str() );
+			remove( getBackupFileName( fileNames[ i ], "filter" ).c_str() );
+		}
+
+		if ( ! _sceneVoxelizer.launchVoxelizationStage() )
+		{
+			std::cerr << "GvxBatchVoxelizer : unable to voxelize the scene " << _sceneVoxelizer.getFilePath() << _sceneVoxelizer.getFileName() << _sceneVoxelizer.getFileExtension() << std::endl;
+
+			return false;
+		}
+		if ( ! commitStep( "voxelize" ) )
+		{
+			return false;
+		}
+	}
+	else
+	{
+		std::cout << "GvxBatchVoxelizer : stage [ voxelize ] already completed" << std::endl;
+
+		// Data structure parameters are required by the next stages
+		voxelizerEngine.setup( maxLevel, _sceneVoxelizer.getBrickWidth(), _sceneVoxelizer.getFileName(), _sceneVoxelizer.getDataType() );
+	}
+
+	// Fill borders, then apply the filter at the max level of resolution
+	if ( ! executeInPlaceStage( "borders" ) || ! executeInPlaceStage( "filter" ) )
+	{
+		return false;
+	}
+
+	// Mip-mapping : one step per level, from the finest to the coarsest
+	for ( int level = static_cast< int >( maxLevel ) - 1; level >= 0; level-- )
+	{
+		std::ostringstream step;
+		step << "mipmap " << level;
+
+		if ( isStepCompleted( step.str() ) )
+		{
+			continue;
+		}
+
+		std::cout << "GvxBatchVoxelizer : stage [ " << step.str() << " ]" << std::endl;
+
+		voxelizerEngine.mipmapLevel( level );
+		if ( ! commitStep( step.str() ) )
+		{
+			return false;
+		}
+	}
+
+	// Node summaries (files are rewritten on resume)
+	if ( ! isStepCompleted( "summaries" ) )
+	{
+		std::cout << "GvxBatchVoxelizer : stage [ summaries ]" << std::endl;
+
+		if ( ! voxelizerEngine.generateSummaries() )
+		{
+			return false;
+		}
+		if ( ! commitStep( "summaries" ) )
+		{
+			return false;
+		}
+	}
+
+	// Descriptor file
+	if ( ! isStepCompleted( "xml" ) )
+	{
+		std::cout << "GvxBatchVoxelizer : stage [ xml ]" << std::endl;
+
+		if ( ! _sceneVoxelizer.writeDescriptorFile( _sceneVoxelizer.getFileName() + ".xml" ) )
+		{
+			return false;
+		}
+		if ( ! commitStep( "xml" ) )
+		{
+			return false;
+		}
+	}
+
+	std::cout << "GvxBatchVoxelizer : all stages completed" << std::endl;
+
+	return true;
+}
+
+/******************************************************************************
+ * Get the signature of the voxelization parameters.
+ * A checkpoint is only reused by a job with the same signature.
+ *
+ * @return the parameters signature
+ ******************************************************************************/
+std::string GvxBatchVoxelizer::getSignature() const
+{
+	std::ostringstream signature;
+	signature << "file=" << _sceneVoxelizer.getFilePath() << _sceneVoxelizer.getFileName() << _sceneVoxelizer.getFileExtension()
+		<< " level=" << _sceneVoxelizer.getMaxResolution()
+		<< " brickWidth=" << _sceneVoxelizer.getBrickWidth()
+		<< " dataType=" << GvxDataTypeHandler::getTypeName( _sceneVoxelizer.getDataType() )
+		<< " normals=" << ( _sceneVoxelizer.isGenerateNormalsOn() ? 1 : 0 )
+		<< " filter=" << _filterType
+		<< " filterIterations=" << _nbFilterApplications
+		<< " borderless=" << ( _sceneVoxelizer.getVoxelizerEngine().isBorderless() ? 1 : 0 );
+
+	return signature.str();
+}
+
+/******************************************************************************
+ * Read the checkpoint file (if any)
+ ******************************************************************************/
+void GvxBatchVoxelizer::readCheckpoint()
+{
+	_completedSteps.clear();
+
+	std::ifstream file( _checkpointFileName.c_str() );
+	if ( ! file.is_open() )
+	{
+		return;
+	}
+
+	std::string header;
+	std::string signature;
+	std::getline( file, header );
+	std::getline( file, signature );
+	if ( header != cCheckpointHeader || signature != getSignature() )
+	{
+		std::cout << "GvxBatchVoxelizer : checkpoint file " << _checkpointFileName << " does not match the current parameters, starting from scratch" << std::endl;
+
+		return;
+	}
+
+	std::string step;
+	while ( std::getline( file, step ) )
+	{
+		if ( ! step.empty() )
+		{
+			_completedSteps.push_back( step );
+		}
+	}
+
+	std::cout << "GvxBatchVoxelizer : resuming from checkpoint file " << _checkpointFileName << " (" << _completedSteps.size() << " completed steps)" << std::endl;
+}
+
+/******************************************************************************
+ * Record a completed step and write the checkpoint file.
+ * The file is replaced atomically (written aside, then renamed).
+ *
+ * @param pStep the completed step
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxBatchVoxelizer::commitStep( const std::string& pStep )
+{
+	_completedSteps.push_back( pStep );
+
+	const std::string temporaryFileName = _checkpointFileName + ".tmp";
+	FILE* file = fopen( temporaryFileName.c_str(), "wb" );
+	if ( file == NULL )
+	{
+		std::cerr << "GvxBatchVoxelizer::commitStep : unable to write " << temporaryFileName << std::endl;
+
+		return false;
+	}
+
+	fprintf( file, "%s\n%s\n", cCheckpointHeader, getSignature().c_str() );
+	for ( size_t i = 0; i < _completedSteps.size(); i++ )
+	{
+		fprintf( file, "%s\n", _completedSteps[ i ].c_str() );
+	}
+
+	// Make sure data is on disk before the checkpoint is replaced
+	bool isWritten = ( fflush( file ) == 0 );
+#ifndef WIN32
+	isWritten = isWritten && ( fsync( fileno( file ) ) == 0 );
+#endif
+	isWritten = ( fclose( file ) == 0 ) && isWritten;
+
+	if ( ! isWritten || ! replaceFile( temporaryFileName, _checkpointFileName ) )
+	{
+		std::cerr << "GvxBatchVoxelizer::commitStep : unable to write " << _checkpointFileName << std::endl;
+
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Tell wheter or not a step has been completed
+ *
+ * @param pStep the step
+ *
+ * @return a flag telling wheter or not the step has been completed
+ ******************************************************************************/
+bool GvxBatchVoxelizer::isStepCompleted( const std::string& pStep ) const
+{
+	for ( size_t i = 0; i < _completedSteps.size(); i++ )
+	{
+		if ( _completedSteps[ i ] == pStep )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * Run a stage modifying the max level files in place (borders or filter),
+ * protected by backups of these files.
+ *
+ * @param pStep the stage name
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxBatchVoxelizer::executeInPlaceStage( const std::string& pStep )
+{
+	const std::vector< std::string > fileNames = getLevelFileNames( _sceneVoxelizer.getMaxResolution() );
+
+	// Count backups left by an interrupted run
+	size_t nbBackups = 0;
+	for ( size_t i = 0; i < fileNames.size(); i++ )
+	{
+		if ( isFileExisting( getBackupFileName( fileNames[ i ], pStep ) ) )
+		{
+			nbBackups++;
+		}
+	}
+
+	if ( isStepCompleted( pStep ) )
+	{
+		std::cout << "GvxBatchVoxelizer : stage [ " << pStep << " ] already completed" << std::endl;
+
+		// The run may have been interrupted before backups were removed
+		for ( size_t i = 0; i < fileNames.size(); i++ )
+		{
+			remove( getBackupFileName( fileNames[ i ], pStep ).c_str() );
+		}
+
+		return true;
+	}
+
+	if ( nbBackups == fileNames.size() )
+	{
+		// The stage may have modified the files : restore them
+		std::cout << "GvxBatchVoxelizer : stage [ " << pStep << " ] was interrupted, restoring its input files" << std::endl;
+
+		for ( size_t i = 0; i < fileNames.size(); i++ )
+		{
+			if ( ! copyFile( getBackupFileName( fileNames[ i ], pStep ), fileNames[ i ] ) )
+			{
+				return false;
+			}
+		}
+	}
+	else
+	{
+		// The stage has not started (backups are incomplete or missing) : files are unmodified
+		for ( size_t i = 0; i < fileNames.size(); i++ )
+		{
+			if ( ! copyFile( fileNames[ i ], getBackupFileName( fileNames[ i ], pStep ) ) )
+			{
+				return false;
+			}
+		}
+	}
+
+	std::cout << "GvxBatchVoxelizer : stage [ " << pStep << " ]" << std::endl;
+
+	GvxVoxelizerEngine& voxelizerEngine = _sceneVoxelizer.getVoxelizerEngine();
+	if ( pStep == "borders" )
+	{
+		voxelizerEngine.updateBorders();
+	}
+	else
+	{
+		voxelizerEngine.applyFilter();
+	}
+
+	if ( ! commitStep( pStep ) )
+	{
+		return false;
+	}
+
+	// Backups are useless once the stage is recorded
+	for ( size_t i = 0; i < fileNames.size(); i++ )
+	{
+		remove( getBackupFileName( fileNames[ i ], pStep ).c_str() );
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Get the files of a level of resolution (nodes and bricks of all channels)
+ *
+ * @param pLevel level of resolution
+ *
+ * @return the list of file names
+ ******************************************************************************/
+std::vector< std::string > GvxBatchVoxelizer::getLevelFileNames( unsigned int pLevel ) const
+{
+	const std::string& name = _sceneVoxelizer.getFileName();
+	const unsigned int brickWidth = _sceneVoxelizer.getBrickWidth();
+	const unsigned int borderSize = _sceneVoxelizer.getVoxelizerEngine().getBorderSize();
+
+	std::vector< std::string > fileNames;
+	fileNames.push_back( GvxDataStructureIOHandler::getFileNameNode( name, pLevel, brickWidth, borderSize ) );
+	fileNames.push_back( GvxDataStructureIOHandler::getFileNameBrick( name, pLevel, brickWidth, 0, GvxDataTypeHandler::getTypeName( _sceneVoxelizer.getDataType() ), borderSize ) );
+	if ( _sceneVoxelizer.isGenerateNormalsOn() )
+	{
+		fileNames.push_back( GvxDataStructureIOHandler::getFileNameBrick( name, pLevel, brickWidth, 1, GvxDataTypeHandler::getTypeName( GvxDataTypeHandler::gvHALF4 ), borderSize ) );
+	}
+
+	return fileNames;
+}
+
+/******************************************************************************
+ * Get the backup file name of a file for a given stage
+ *
+ * @param pFileName the file name
+ * @param pStep the stage name
+ *
+ * @return the backup file name
+ ******************************************************************************/
+std::string GvxBatchVoxelizer::getBackupFileName( const std::string& pFileName, const std::string& pStep )
+{
+	return pFileName + "." + pStep + ".backup";
+}
+
+/******************************************************************************
+ * Tell wheter or not a file exists
+ *
+ * @param pFileName the file name
+ *
+ * @return a flag telling wheter or not the file exists
+ ******************************************************************************/
+bool GvxBatchVoxelizer::isFileExisting( const std::string& pFileName )
+{
+	FILE* file = fopen( pFileName.c_str(), "rb" );
+	if ( file == NULL )
+	{
+		return false;
+	}
+	fclose( file );
+
+	return true;
+}
+
+/******************************************************************************
+ * Copy a file.
+ * The destination is written aside, then renamed, so that it is either complete or missing.
+ *
+ * @param pSource the source file name
+ * @param pDestination the destination file name
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxBatchVoxelizer::copyFile( const std::string& pSource, const std::string& pDestination )
+{
+	const std::string temporaryFileName = pDestination + ".tmp";
+
+	FILE* source = fopen( pSource.c_str(), "rb" );
+	FILE* destination = ( source != NULL ) ? fopen( temporaryFileName.c_str(), "wb" ) : NULL;
+	bool result = ( destination != NULL );
+
+	// Copy by blocks
+	char buffer[ 65536 ];
+	while ( result )
+	{
+		const size_t nbBytes = fread( buffer, 1, sizeof( buffer ), source );
+		if ( nbBytes > 0 && fwrite( buffer, 1, nbBytes, destination ) != nbBytes )
+		{
+			result = false;
+		}
+		if ( nbBytes < sizeof( buffer ) )
+		{
+			result = result && ( ferror( source ) == 0 );
+			break;
+		}
+	}
+
+	if ( destination != NULL )
+	{
+		result = result && ( fflush( destination ) == 0 );
+#ifndef WIN32
+		result = result && ( fsync( fileno( destination ) ) == 0 );
+#endif
+		result = ( fclose( destination ) == 0 ) && result;
+	}
+	if ( source != NULL )
+	{
+		fclose( source );
+	}
+
+	result = result && replaceFile( temporaryFileName, pDestination );
+	if ( ! result )
+	{
+		std::cerr << "GvxBatchVoxelizer::copyFile : unable to copy " << pSource << " to " << pDestination << std::endl;
+		remove( temporaryFileName.c_str() );
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * Rename a file, replacing the destination if it exists
+ *
+ * @param pSource the source file name
+ * @param pDestination the destination file name
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxBatchVoxelizer::replaceFile( const std::string& pSource, const std::string& pDestination )
+{
+#ifdef WIN32
+	// rename() does not replace an existing file on Windows
+	remove( pDestination.c_str() );
+#endif
+
+	return ( rename( pSource.c_str(), pDestination.c_str() ) == 0 );
+}
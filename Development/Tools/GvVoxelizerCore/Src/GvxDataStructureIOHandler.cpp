@@ -73,19 +73,23 @@ const unsigned int GvxDataStructureIOHandler::_cEmptyNodeFlag = 0;
  * @param pBrickWidth width of bricks in the data structure
  * @param pDataType type of voxel data (i.e. uchar4, float, float4, etc...)
  * @param pNewFiles a flag telling wheter or not "new files" are used
+ * @param pBorderSize border size of bricks (0 or 1)
  ******************************************************************************/
 GvxDataStructureIOHandler::GvxDataStructureIOHandler( const std::string& pName, 
 							unsigned int pLevel,
 							unsigned int pBrickWidth,
 							GvxDataTypeHandler::VoxelDataType pDataType,
-							bool pNewFiles )
+							bool pNewFiles,
+							unsigned int pBorderSize )
 // TO DO
 // attention  l'ordre des initializations...
 :	_nodeFile( NULL )
 ,	_level( pLevel )
 ,	_brickWidth( pBrickWidth )
-,	_brickSize( ( pBrickWidth + 2 ) * ( pBrickWidth + 2 ) * ( pBrickWidth + 2 ) )
+,	_borderSize( pBorderSize )
+,	_brickSize( ( pBrickWidth + 2 * pBorderSize ) * ( pBrickWidth + 2 * pBorderSize ) * ( pBrickWidth + 2 * pBorderSize ) )
 ,	_isBufferLoaded( false )
+,	_isBufferModified( false )
 ,	_brickNumber( 0 )
 ,	_nodeGridSize( 1 << pLevel )
 ,	_voxelGridSize( _nodeGridSize * pBrickWidth )
@@ -106,20 +110,24 @@ GvxDataStructureIOHandler::GvxDataStructureIOHandler( const std::string& pName,
  * @param pBrickWidth width of bricks in the data structure
  * @param pDataTypes types of voxel data (i.e. uchar4, float, float4, etc...)
  * @param pNewFiles a flag telling wheter or not "new files" are used
+ * @param pBorderSize border size of bricks (0 or 1)
  ******************************************************************************/
 GvxDataStructureIOHandler::GvxDataStructureIOHandler( const std::string& pName, 
 							unsigned int pLevel,
 							unsigned int pBrickWidth,
 							const vector< GvxDataTypeHandler::VoxelDataType >& pDataTypes,
-							bool pNewFiles )
+							bool pNewFiles,
+							unsigned int pBorderSize )
 // TO DO
 // attention  l'ordre des initializations...
 :	_nodeFile( NULL )
 ,	_level( pLevel )
 ,	_brickWidth( pBrickWidth )
-,	_brickSize( ( pBrickWidth + 2 ) * ( pBrickWidth + 2 ) * ( pBrickWidth + 2 ) )
+,	_borderSize( pBorderSize )
+,	_brickSize( ( pBrickWidth + 2 * pBorderSize ) * ( pBrickWidth + 2 * pBorderSize ) * ( pBrickWidth + 2 * pBorderSize ) )
 ,	_dataTypes( pDataTypes )
 ,	_isBufferLoaded( false )
+,	_isBufferModified( false )
 ,	_brickNumber( 0 )
 ,	_nodeGridSize( 1 << pLevel )
 ,	_voxelGridSize( _nodeGridSize * pBrickWidth )
@@ -143,7 +151,7 @@ GvxDataStructureIOHandler::~GvxDataStructureIOHandler()
 
 	for ( unsigned int c = 0; c < _dataTypes.size(); ++c )
 	{
-		delete [] _brickBuffers[ c ];
+		GvxDataTypeHandler::freeVoxels( _dataTypes[ c ], _brickBuffers[ c ] );
 		fclose( _brickFiles[ c ] );	
 	}
 }
@@ -158,6 +166,16 @@ unsigned int GvxDataStructureIOHandler::getBrickNumber() const
 	return _brickNumber;
 }
 
+/******************************************************************************
+ * Get the types of voxel data of each data channel
+ *
+ * @return the types of voxel data
+ ******************************************************************************/
+const std::vector< GvxDataTypeHandler::VoxelDataType >& GvxDataStructureIOHandler::getDataTypes() const
+{
+	return _dataTypes;
+}
+
 /******************************************************************************
  * Get the voxel size at current level of resolution
  *
@@ -208,14 +226,16 @@ void GvxDataStructureIOHandler::setVoxel( unsigned int pVoxelPos[ 3 ], void* pVo
 	// Retrieve the voxel position in the current brick
 	// (take into account the border)
 	unsigned int voxelPosInBrick[ 3 ];
-	voxelPosInBrick[ 0 ] = pVoxelPos[ 0 ] % _brickWidth + 1;
-	voxelPosInBrick[ 1 ] = pVoxelPos[ 1 ] % _brickWidth + 1;
-	voxelPosInBrick[ 2 ] = pVoxelPos[ 2 ] % _brickWidth + 1;
+	voxelPosInBrick[ 0 ] = pVoxelPos[ 0 ] % _brickWidth + _borderSize;
+	voxelPosInBrick[ 1 ] = pVoxelPos[ 1 ] % _brickWidth + _borderSize;
+	voxelPosInBrick[ 2 ] = pVoxelPos[ 2 ] % _brickWidth + _borderSize;
 
 	// Write voxel data
-	memcpy( GvxDataTypeHandler::getAddress( _dataTypes[ pDataChannel ], _brickBuffers[ pDataChannel ], voxelPosInBrick[ 0 ] + ( _brickWidth + 2 ) * ( voxelPosInBrick[ 1 ] + ( _brickWidth + 2 ) * voxelPosInBrick[ 2 ] ) ),
+	const unsigned int brickResolution = _brickWidth + 2 * _borderSize;
+	memcpy( GvxDataTypeHandler::getAddress( _dataTypes[ pDataChannel ], _brickBuffers[ pDataChannel ], voxelPosInBrick[ 0 ] + brickResolution * ( voxelPosInBrick[ 1 ] + brickResolution * voxelPosInBrick[ 2 ] ) ),
 			pVoxelData,
 			GvxDataTypeHandler::canalByteSize( _dataTypes[ pDataChannel ] ) );
+	_isBufferModified = true;
 }
 
 /******************************************************************************
@@ -252,16 +272,17 @@ void GvxDataStructureIOHandler::getVoxel( unsigned int pVoxelPos[ 3 ], void* vox
 	
 	// Retrieve the voxel position in the current brick
 	unsigned int voxelPosInBrick[ 3 ];
-	voxelPosInBrick[ 0 ] = pVoxelPos[ 0 ] % _brickWidth+1;
-	voxelPosInBrick[ 1 ] = pVoxelPos[ 1 ] % _brickWidth+1;
-	voxelPosInBrick[ 2 ] = pVoxelPos[ 2 ] % _brickWidth+1;
+	voxelPosInBrick[ 0 ] = pVoxelPos[ 0 ] % _brickWidth + _borderSize;
+	voxelPosInBrick[ 1 ] = pVoxelPos[ 1 ] % _brickWidth + _borderSize;
+	voxelPosInBrick[ 2 ] = pVoxelPos[ 2 ] % _brickWidth + _borderSize;
 
 	// Load data (eventually from cache)
 	loadNodeandBrick( nodePos );
 
 	// Copy data from memory
+	const unsigned int brickResolution = _brickWidth + 2 * _borderSize;
 	memcpy( voxelData,
-			GvxDataTypeHandler::getAddress( _dataTypes[ pDataChannel ], _brickBuffers[ pDataChannel ], voxelPosInBrick[ 0 ] + ( _brickWidth + 2 ) * ( voxelPosInBrick[ 1 ] + ( _brickWidth + 2 ) * voxelPosInBrick[ 2 ] ) ),		
+			GvxDataTypeHandler::getAddress( _dataTypes[ pDataChannel ], _brickBuffers[ pDataChannel ], voxelPosInBrick[ 0 ] + brickResolution * ( voxelPosInBrick[ 1 ] + brickResolution * voxelPosInBrick[ 2 ] ) ),		
 			GvxDataTypeHandler::canalByteSize( _dataTypes[ pDataChannel ] ) );
 }
 
@@ -312,6 +333,100 @@ void GvxDataStructureIOHandler::setBrick( unsigned int pNodePos[ 3 ], void* pBri
 
 	// Write data in memory
 	memcpy( _brickBuffers[ pDataChannel ], pBrickData, _brickSize * GvxDataTypeHandler::canalByteSize( _dataTypes[ pDataChannel ] ) );
+	_isBufferModified = true;
+}
+
+/******************************************************************************
+ * Get brick data in a node at given data channel, surrounded by a border of one voxel
+ * filled from its neighbor nodes, whatever the border size of the data structure.
+ * The resulting brick has ( _brickWidth + 2 )^3 voxels, the border is null outside the data structure.
+ *
+ * @param pNodePos node position
+ * @param pBrickData brick data
+ * @param pDataChannel data channel index
+ ******************************************************************************/
+void GvxDataStructureIOHandler::getBrickWithBorders( unsigned int pNodePos[ 3 ], void* pBrickData, unsigned int pDataChannel )
+{
+	// Borders are already stored
+	if ( _borderSize == 1 )
+	{
+		getBrick( pNodePos, pBrickData, pDataChannel );
+
+		return;
+	}
+
+	const unsigned int width = _brickWidth + 2;
+	const unsigned int brickResolution = _brickWidth + 2 * _borderSize;
+	const size_t voxelSize = GvxDataTypeHandler::canalByteSize( _dataTypes[ pDataChannel ] );
+	memset( pBrickData, 0, width * width * width * voxelSize );
+
+	// Iterate through the node and its neighbor nodes (in 3D, there are 26 neighbors)
+	for ( int k2 = -1; k2 <= 1; k2++ )
+	for ( int j2 = -1; j2 <= 1; j2++ )
+	for ( int i2 = -1; i2 <= 1; i2++ )
+	{
+		// Check the neighbor node position is inside the data structure bounds
+		const int nodePos2[ 3 ] = { static_cast< int >( pNodePos[ 0 ] ) + i2, static_cast< int >( pNodePos[ 1 ] ) + j2, static_cast< int >( pNodePos[ 2 ] ) + k2 };
+		if ( nodePos2[ 0 ] < 0 || nodePos2[ 0 ] >= static_cast< int >( _nodeGridSize ) ||
+			nodePos2[ 1 ] < 0 || nodePos2[ 1 ] >= static_cast< int >( _nodeGridSize ) ||
+			nodePos2[ 2 ] < 0 || nodePos2[ 2 ] >= static_cast< int >( _nodeGridSize ) )
+		{
+			continue;
+		}
+
+		// Empty nodes have no data
+		unsigned int neighborNodePos[ 3 ] = { static_cast< unsigned int >( nodePos2[ 0 ] ), static_cast< unsigned int >( nodePos2[ 1 ] ), static_cast< unsigned int >( nodePos2[ 2 ] ) };
+		if ( isEmpty( getNode( neighborNodePos ) ) )
+		{
+			continue;
+		}
+
+		// Voxels of the neighbor lying in the border (or all voxels of the node itself)
+		const int offset[ 3 ] = { i2, j2, k2 };
+		unsigned int first[ 3 ];
+		unsigned int last[ 3 ];
+		for ( unsigned int d = 0; d < 3; d++ )
+		{
+			first[ d ] = ( offset[ d ] < 0 ) ? _brickWidth - 1 : 0;
+			last[ d ] = ( offset[ d ] > 0 ) ? 0 : _brickWidth - 1;
+		}
+
+		for ( unsigned int z = first[ 2 ]; z <= last[ 2 ]; z++ )
+		for ( unsigned int y = first[ 1 ]; y <= last[ 1 ]; y++ )
+		for ( unsigned int x = first[ 0 ]; x <= last[ 0 ]; x++ )
+		{
+			const unsigned int x2 = x + 1 + i2 * _brickWidth;
+			const unsigned int y2 = y + 1 + j2 * _brickWidth;
+			const unsigned int z2 = z + 1 + k2 * _brickWidth;
+			memcpy( GvxDataTypeHandler::getAddress( _dataTypes[ pDataChannel ], pBrickData, x2 + width * ( y2 + width * z2 ) ),
+					GvxDataTypeHandler::getAddress( _dataTypes[ pDataChannel ], _brickBuffers[ pDataChannel ], ( x + _borderSize ) + brickResolution * ( ( y + _borderSize ) + brickResolution * ( z + _borderSize ) ) ),
+					voxelSize );
+		}
+	}
+}
+
+/******************************************************************************
+ * Reset brick data (borders included) of a node in all data channels.
+ * The node keeps its brick : empty nodes are left untouched.
+ *
+ * @param pNodePos node position
+ ******************************************************************************/
+void GvxDataStructureIOHandler::clearBrick( unsigned int pNodePos[ 3 ] )
+{
+	// Retrieve node info and associated brick data
+	loadNodeandBrick( pNodePos );
+
+	if ( isEmpty( _nodeBuffer ) )
+	{
+		return;
+	}
+
+	// Iterate through data channels
+	for ( unsigned int c = 0; c < _dataTypes.size(); ++c )
+	{
+		memset( _brickBuffers[ c ], 0, _brickSize * GvxDataTypeHandler::canalByteSize( _dataTypes[ c ] ) );
+	}
+	_isBufferModified = true;
 }
 
 /******************************************************************************
@@ -327,6 +442,31 @@ void GvxDataStructureIOHandler::getNodePosition( float pNormalizedNodePos[ 3 ],
 	pNodePos[ 2 ] = static_cast< unsigned int >( pNormalizedNodePos[ 2 ] * static_cast< float >( _nodeGridSize ) );
 }
 
+/******************************************************************************
+ * Convert a node index to its indexed node position
+ *
+ * @param pNodeIndex node index (as stored in the node file)
+ * @param pNodePos indexed node position
+ ******************************************************************************/
+void GvxDataStructureIOHandler::getNodePosition( unsigned int pNodeIndex, unsigned int pNodePos[ 3 ] ) const
+{
+	pNodePos[ 0 ] = pNodeIndex % _nodeGridSize;
+	pNodePos[ 1 ] = ( pNodeIndex / _nodeGridSize ) % _nodeGridSize;
+	pNodePos[ 2 ] = pNodeIndex / ( _nodeGridSize * _nodeGridSize );
+}
+
+/******************************************************************************
+ * Convert an indexed node position to its node index
+ *
+ * @param pNodePos indexed node position
+ *
+ * @return the node index (as stored in the node file)
+ ******************************************************************************/
+unsigned int GvxDataStructureIOHandler::getNodeIndex( unsigned int pNodePos[ 3 ] ) const
+{
+	return pNodePos[ 0 ] + _nodeGridSize * ( pNodePos[ 1 ] + _nodeGridSize * pNodePos[ 2 ] );
+}
+
 /******************************************************************************
  * Convert a normalized voxel position to its indexed voxel position
  *
@@ -348,9 +488,9 @@ void GvxDataStructureIOHandler::getVoxelPosition( float pNormalizedVoxelPos[ 3 ]
  ******************************************************************************/
 void GvxDataStructureIOHandler::getVoxelPositionInBrick( float pNormalizedVoxelPos[ 3 ], unsigned int pVoxelPosInBrick[ 3 ] )
 {
-	pVoxelPosInBrick[ 0 ] = ( ( static_cast< unsigned int >( pNormalizedVoxelPos[ 0 ] * static_cast< float >( _voxelGridSize ) ) ) % _brickWidth ) + 1;
-	pVoxelPosInBrick[ 1 ] = ( ( static_cast< unsigned int >( pNormalizedVoxelPos[ 1 ] * static_cast< float >( _voxelGridSize ) ) ) % _brickWidth ) + 1;
-	pVoxelPosInBrick[ 2 ] = ( ( static_cast< unsigned int >( pNormalizedVoxelPos[ 2 ] * static_cast< float >( _voxelGridSize ) ) ) % _brickWidth ) + 1;
+	pVoxelPosInBrick[ 0 ] = ( ( static_cast< unsigned int >( pNormalizedVoxelPos[ 0 ] * static_cast< float >( _voxelGridSize ) ) ) % _brickWidth ) + _borderSize;
+	pVoxelPosInBrick[ 1 ] = ( ( static_cast< unsigned int >( pNormalizedVoxelPos[ 1 ] * static_cast< float >( _voxelGridSize ) ) ) % _brickWidth ) + _borderSize;
+	pVoxelPosInBrick[ 2 ] = ( ( static_cast< unsigned int >( pNormalizedVoxelPos[ 2 ] * static_cast< float >( _voxelGridSize ) ) ) % _brickWidth ) + _borderSize;
 }
 
 /******************************************************************************
@@ -440,6 +580,7 @@ void GvxDataStructureIOHandler::loadNodeandBrick( unsigned int pNodePos[ 3 ] )
 
 	// Update the flag telling wheter or not the current node and brick have been loaded in memory (and stored in buffers)
 	_isBufferLoaded = true;
+	_isBufferModified = false;
 }
 
 /******************************************************************************
@@ -447,8 +588,9 @@ void GvxDataStructureIOHandler::loadNodeandBrick( unsigned int pNodePos[ 3 ] )
  ******************************************************************************/
 void GvxDataStructureIOHandler::saveNodeandBrick()
 {
-	// Check the flag telling wheter or not the current node and brick have been loaded in memory (and stored in buffers)
-	if ( _isBufferLoaded )
+	// Check the flag telling wheter or not the current node and brick have been loaded in memory (and stored in buffers).
+	// Data only read is already on disk.
+	if ( _isBufferLoaded && _isBufferModified )
 	{
 		// Write current node info (address+brick index)
 #ifdef WIN32
@@ -463,7 +605,8 @@ void GvxDataStructureIOHandler::saveNodeandBrick()
 		// Retrieve the brick offset in brick file
 		unsigned int brickOffset = getBrickOffset( _nodeBuffer );
 		// Iterate through data channels
-		for ( unsigned int c = 0; c < _dataTypes.size(); ++c )
+		// (empty nodes have no brick : writing their buffer would overwrite the first brick)
+		for ( unsigned int c = 0; c < _dataTypes.size() && ! isEmpty( _nodeBuffer ); ++c )
 		{
 			// Write current brick data
 #ifdef WIN32
@@ -479,6 +622,7 @@ void GvxDataStructureIOHandler::saveNodeandBrick()
 
 	// Update the flag telling wheter or not the current node and brick have been loaded in memory (and stored in buffers)
 	_isBufferLoaded = false;
+	_isBufferModified = false;
 }
 
 /******************************************************************************
@@ -486,9 +630,15 @@ void GvxDataStructureIOHandler::saveNodeandBrick()
  ******************************************************************************/
 void GvxDataStructureIOHandler::computeBorders()
 {
+	// Borderless bricks have no border to fill
+	if ( _borderSize == 0 )
+	{
+		return;
+	}
+
 	// LOG message
 	std::cout << "GvxDataStructureIOHandler::computeBorders()" << std::endl;
-	bool emptyNode;
+
 	// Iterate trough data ytpes
 	for ( unsigned int c = 0; c < _dataTypes.size(); ++c )
 	{
@@ -511,177 +661,293 @@ void GvxDataStructureIOHandler::computeBorders()
 			nodePos[ 1 ] = j;
 			nodePos[ 2 ] = k;
 
-			// Retrieve the associated node info
-			unsigned int node = getNode( nodePos );
+			// Copy the node data in the borders of its neighbors
+			computeNodeBorders( nodePos, c, brick, brick2 );
+		}
+		}
 
-			// If node is empty, there is nothing to do, so go to next node
-			if ( isEmpty( node ) )
-			{
-				
+		// Free memory of the two brick data buffers
+		GvxDataTypeHandler::freeVoxels( _dataTypes[ c ], brick );
+		GvxDataTypeHandler::freeVoxels( _dataTypes[ c ], brick2 );
+	}
+}
+
+/******************************************************************************
+ * Fill brick borders around a subset of nodes.
+ * Each given node copies its data in the borders of its neighbors,
+ * so a node's own borders are only updated if its neighbors are given too.
+ *
+ * @param pNodeIndices indices of the nodes (sorted by node index)
+ ******************************************************************************/
+void GvxDataStructureIOHandler::computeBorders( const std::set< unsigned int >& pNodeIndices )
+{
+	// Borderless bricks have no border to fill
+	if ( _borderSize == 0 )
+	{
+		return;
+	}
+
+	// LOG message
+	std::cout << "GvxDataStructureIOHandler::computeBorders() - " << pNodeIndices.size() << " nodes" << std::endl;
+
+	// Iterate trough data ytpes
+	for ( unsigned int c = 0; c < _dataTypes.size(); ++c )
+	{
+		// Create two brick buffers
+		void* brick = GvxDataTypeHandler::allocateVoxels( _dataTypes[ c ], _brickSize );
+		void* brick2 = GvxDataTypeHandler::allocateVoxels( _dataTypes[ c ], _brickSize );
+
+		// Iterate trough the given nodes (in the same order than the whole data structure traversal)
+		std::set< unsigned int >::const_iterator nodeIt = pNodeIndices.begin();
+		for ( ; nodeIt != pNodeIndices.end(); ++nodeIt )
+		{
+			unsigned int nodePos[ 3 ];
+			getNodePosition( *nodeIt, nodePos );
+
+			// Copy the node data in the borders of its neighbors
+			computeNodeBorders( nodePos, c, brick, brick2 );
+		}
+
+		// Free memory of the two brick data buffers
+		GvxDataTypeHandler::freeVoxels( _dataTypes[ c ], brick );
+		GvxDataTypeHandler::freeVoxels( _dataTypes[ c ], brick2 );
+	}
+}
+
+/******************************************************************************
+ * Set empty the nodes of a subset whose brick data (borders included) is null in all data channels,
+ * as a whole voxelization would have left them.
+ * Their brick is no longer referenced but stays in the brick files :
+ * brick indices of the other nodes of the level are unchanged.
+ *
+ * @param pNodeIndices indices of the nodes
+ *
+ * @return the number of nodes set empty
+ ******************************************************************************/
+unsigned int GvxDataStructureIOHandler::releaseEmptyBricks( const std::set< unsigned int >& pNodeIndices )
+{
+	unsigned int nbReleasedBricks = 0;
+
+	// Iterate trough the given nodes
+	std::set< unsigned int >::const_iterator nodeIt = pNodeIndices.begin();
+	for ( ; nodeIt != pNodeIndices.end(); ++nodeIt )
+	{
+		unsigned int nodePos[ 3 ];
+		getNodePosition( *nodeIt, nodePos );
+
+		// Retrieve node info and associated brick data
+		loadNodeandBrick( nodePos );
+		if ( isEmpty( _nodeBuffer ) )
+		{
 			continue;
-			} else {
-		
-				// Retrieve the associated brick data
-				getBrick( nodePos, brick, c );
+		}
 
-				// Iterate through each neighbor nodes (in 3D, there are 26 neighbors)
-				for ( int k2 =- 1; k2 <= 1; k2++ )
-				for ( int j2 =- 1; j2 <= 1; j2++ )
-				for ( int i2 =- 1; i2 <= 1; i2++ )
+		// Search for non-null data in all data channels
+		bool isBrickEmpty = true;
+		for ( unsigned int c = 0; c < _dataTypes.size() && isBrickEmpty; ++c )
+		{
+			const unsigned char* brickData = static_cast< const unsigned char* >( _brickBuffers[ c ] );
+			const size_t brickByteSize = static_cast< size_t >( _brickSize ) * GvxDataTypeHandler::canalByteSize( _dataTypes[ c ] );
+			for ( size_t i = 0; i < brickByteSize; i++ )
+			{
+				if ( brickData[ i ] != 0 )
 				{
-					// Elude the identity case
-					if (i2==0 && j2==0 && k2 ==0) 
-					{
-						continue;
-					}
-					// Check the current neighbor node position.
-					// If it is outside the data structure bounds,
-					// there is nothing to do, so go to next neighbor node.
-					if ( i + i2 < 0 || i + i2 >= _nodeGridSize ||
-						j + j2 < 0 || j + j2 >= _nodeGridSize ||
-						k + k2 < 0 || k + k2 >= _nodeGridSize )
-					{
-						continue;
-					}
+					isBrickEmpty = false;
+					break;
+				}
+			}
+		}
 
-					// Store current neighbor node neighboor position
-					unsigned int nodePos2[ 3 ];
-					nodePos2[ 0 ] = i + i2;
-					nodePos2[ 1 ] = j + j2;
-					nodePos2[ 2 ] = k + k2;
+		// The node info is written on disk with the next node (its brick data is not)
+		if ( isBrickEmpty )
+		{
+			_nodeBuffer = _cEmptyNodeFlag;
+			_isBufferModified = true;
+			nbReleasedBricks++;
+		}
+	}
 
-					// Retrieve the associated neighbor node info
-					unsigned int node2 = getNode( nodePos2 );
-					
+	return nbReleasedBricks;
+}
 
-					// If node is empty :
-					// It has to be created and data has to be put in its border only if the limit face/edge/point of the current node corresponding to that neighboor 
-					// is not empty
-					if ( isEmpty( node2 ))
-					{
+/******************************************************************************
+ * Copy the data of a node in the borders of its neighbors at given data channel.
+ * Empty neighbors are created if the node data facing them is not empty.
+ *
+ * @param pNodePos node position
+ * @param pDataChannel data channel index
+ * @param pBrick brick buffer used to store the node data
+ * @param pNeighborBrick brick buffer used to store the neighbor data
+ ******************************************************************************/
+void GvxDataStructureIOHandler::computeNodeBorders( unsigned int pNodePos[ 3 ], unsigned int pDataChannel, void* pBrick, void* pNeighborBrick )
+{
+	const unsigned int i = pNodePos[ 0 ];
+	const unsigned int j = pNodePos[ 1 ];
+	const unsigned int k = pNodePos[ 2 ];
+	const unsigned int c = pDataChannel;
 
-						unsigned int voxelPos[ 3 ];
-						unsigned char voxelData[4];
-						unsigned char voxelNormal[4];
-						unsigned char brickDataCol[4000]; 
-						// Retrieve the corresponding channel 0 (color) to test for opacity and then determine if the border is empty
-						getBrick( nodePos, brickDataCol, 0 );
-
-						// We don't do the tests for every loop, only for the first one, the node won't be empty for the next channels so we won't have 
-						// to go through all of this again
-						bool dataModified = (c!=0);
-
-
-						for ( int u = 1 ; u < _brickWidth+1; u++ ) 
-						{
-							if (dataModified==true) 
-								break;
-							for ( int v = 1 ; v < _brickWidth+1; v++ ) 
-							{
-								if (dataModified==true) 
-									break;
-								for ( int w = 1 ; w < _brickWidth+1; w++ )
-								{
-									// If we have already determined that this border is not empty , exit the 3 loops
-									if (dataModified==true) 
-										break;
-
-									voxelPos[0]= (i2==0)? u : 1+static_cast<int>((_brickWidth-1) * (1.f+i2)/2.f);
-									voxelPos[1]= (j2==0)? v : 1+static_cast<int>((_brickWidth-1) * (1.f+j2)/2.f);
-									voxelPos[2]= (k2==0)? w : 1+static_cast<int>((_brickWidth-1) * (1.f+k2)/2.f);
-						
-									voxelData[3] = brickDataCol[voxelPos[2]*10*10*4+voxelPos[1]*10*4+voxelPos[0]*4+3];   // Warning HARDCODED 10 = _brickWidth + 2*borderSize
-
-									if (voxelData[3]==0){
-										// nothing
-									} else {
-										dataModified=true;
-										break;
-									}
-
-								}
-							}
-						}
-					
-						if (dataModified ==false || c!=0)
-						{
-							//the node has no influence on the considered neighboor, skip the neighboor
-							continue;
-						} else 
-						{
-							// make 1 voxel writing at the center of the neighboor node to trigger the creation of the brick
-							voxelPos[0] =nodePos2[0]*_brickWidth + _brickWidth/2;
-							voxelPos[1] =nodePos2[1]*_brickWidth + _brickWidth/2;
-							voxelPos[2] =nodePos2[2]*_brickWidth + _brickWidth/2;
-							voxelData[0] =0;voxelData[1] =0;voxelData[2] =0;voxelData[3] =0;
-							//setVoxel( voxelPos,voxelData,0);
-							for ( unsigned int c = 0; c < _dataTypes.size(); ++c )
-								setVoxel( voxelPos,voxelData,c);
-						
-						}
-							
-					}
+	// Retrieve the associated node info
+	unsigned int node = getNode( pNodePos );
 
-					// Get the neighboor brick
-					getBrick( nodePos2, brick2, c );
-					
-					// In this part, the goal is to copy voxel data from original brick to voxel data
-					// of the current neighbor brick if it is on a border.
-					// For this, we use a flag telling that data has been modified in the neighbor brick.
-					bool modified = false;
-
-					// Iterate through voxels of the brick
-					for ( unsigned int z = 1; z < _brickWidth + 1; ++z )
-					for ( unsigned int y = 1; y < _brickWidth + 1; ++y )
-					for ( unsigned int x = 1; x < _brickWidth + 1; ++x )
-					{
-						// Store the voxel position of the neighbor brick
-						int x2 = (-i2) * (_brickWidth) + x;
-						int y2 = (-j2) * (_brickWidth) + y;
-						int z2 = (-k2) * (_brickWidth) + z;
-
-							// Check if ( HYPOTHESIS_1 && HYPOTHESIS_2 ) is true.
-							// If yes, it means that this voxel is in the border of the neighbor brick
-							// and we have to copy voxel data of the current brick
-							// to the voxel of the neighbor brick
-							if ( /*HYPOTHESIS_1*/( x2==0 || x2==_brickWidth+1 || 
-								y2==0 || y2==_brickWidth+1 || 
-								z2==0 || z2==_brickWidth+1 )
-								&& /*HYPOTHESIS_2*/ ( x2>=0 && x2<=_brickWidth+1 
-								&& y2>=0 && y2<=_brickWidth+1 
-								&& z2>=0 && z2<=_brickWidth+1 ) )
-							{
-								// Copy voxel data from original brick to "border" voxel of current neighbor brick
-
-								/*for( unsigned int d = 0; d < components[ c ]; ++d )
-								{
-									brick2[(x2 + (brickWidth+2)*(y2 + (brickWidth+2)*z2))*components[c] + d] =
-										brick[(x + (brickWidth+2)*(y + (brickWidth+2)*z))*components[c] + d];
-								}*/
-								memcpy(
-										/*destination*/GvxDataTypeHandler::getAddress( _dataTypes[ c ], brick2, x2 + ( _brickWidth + 2 ) * ( y2 + ( _brickWidth + 2 ) * z2 ) ),
-										/*source*/GvxDataTypeHandler::getAddress( _dataTypes[ c ], brick , x  + ( _brickWidth + 2 ) * ( y  + ( _brickWidth + 2 ) * z ) ),
-										/*size*/GvxDataTypeHandler::canalByteSize( _dataTypes[ c ] )
-								);
-
-								// Update the flag telling that data has been modified in the neighbor brick.
-								modified = true;
-							}
-					}
+	// If node is empty, there is nothing to do
+	if ( isEmpty( node ) )
+	{
+		return;
+	}
 
-					// If the brick data has been modified, copy the data to the neighbor brick buffer
-					if ( modified)
+	// Retrieve the associated brick data
+	getBrick( pNodePos, pBrick, c );
+
+	// Iterate through each neighbor nodes (in 3D, there are 26 neighbors)
+	for ( int k2 =- 1; k2 <= 1; k2++ )
+	for ( int j2 =- 1; j2 <= 1; j2++ )
+	for ( int i2 =- 1; i2 <= 1; i2++ )
+	{
+		// Elude the identity case
+		if (i2==0 && j2==0 && k2 ==0) 
+		{
+			continue;
+		}
+		// Check the current neighbor node position.
+		// If it is outside the data structure bounds,
+		// there is nothing to do, so go to next neighbor node.
+		if ( i + i2 < 0 || i + i2 >= _nodeGridSize ||
+			j + j2 < 0 || j + j2 >= _nodeGridSize ||
+			k + k2 < 0 || k + k2 >= _nodeGridSize )
+		{
+			continue;
+		}
+
+		// Store current neighbor node neighboor position
+		unsigned int nodePos2[ 3 ];
+		nodePos2[ 0 ] = i + i2;
+		nodePos2[ 1 ] = j + j2;
+		nodePos2[ 2 ] = k + k2;
+
+		// Retrieve the associated neighbor node info
+		unsigned int node2 = getNode( nodePos2 );
+		
+
+		// If node is empty :
+		// It has to be created and data has to be put in its border only if the limit face/edge/point of the current node corresponding to that neighboor 
+		// is not empty
+		if ( isEmpty( node2 ))
+		{
+
+			unsigned int voxelPos[ 3 ];
+			unsigned char voxelData[16];	// large enough for all data types (written in every channel)
+			unsigned char voxelNormal[4];
+			unsigned char brickDataCol[4000]; 
+			// Retrieve the corresponding channel 0 (color) to test for opacity and then determine if the border is empty
+			getBrick( pNodePos, brickDataCol, 0 );
+
+			// We don't do the tests for every loop, only for the first one, the node won't be empty for the next channels so we won't have 
+			// to go through all of this again
+			bool dataModified = (c!=0);
+
+
+			for ( int u = 1 ; u < _brickWidth+1; u++ ) 
+			{
+				if (dataModified==true) 
+					break;
+				for ( int v = 1 ; v < _brickWidth+1; v++ ) 
+				{
+					if (dataModified==true) 
+						break;
+					for ( int w = 1 ; w < _brickWidth+1; w++ )
 					{
-						setBrick( nodePos2, brick2, c );
+						// If we have already determined that this border is not empty , exit the 3 loops
+						if (dataModified==true) 
+							break;
+
+						voxelPos[0]= (i2==0)? u : 1+static_cast<int>((_brickWidth-1) * (1.f+i2)/2.f);
+						voxelPos[1]= (j2==0)? v : 1+static_cast<int>((_brickWidth-1) * (1.f+j2)/2.f);
+						voxelPos[2]= (k2==0)? w : 1+static_cast<int>((_brickWidth-1) * (1.f+k2)/2.f);
+			
+						voxelData[3] = brickDataCol[voxelPos[2]*10*10*4+voxelPos[1]*10*4+voxelPos[0]*4+3];   // Warning HARDCODED 10 = _brickWidth + 2*borderSize
+
+						if (voxelData[3]==0){
+							// nothing
+						} else {
+							dataModified=true;
+							break;
+						}
+
 					}
 				}
 			}
+		
+			if (dataModified ==false || c!=0)
+			{
+				//the node has no influence on the considered neighboor, skip the neighboor
+				continue;
+			} else 
+			{
+				// make 1 voxel writing at the center of the neighboor node to trigger the creation of the brick
+				voxelPos[0] =nodePos2[0]*_brickWidth + _brickWidth/2;
+				voxelPos[1] =nodePos2[1]*_brickWidth + _brickWidth/2;
+				voxelPos[2] =nodePos2[2]*_brickWidth + _brickWidth/2;
+				memset( voxelData, 0, sizeof( voxelData ) );
+				//setVoxel( voxelPos,voxelData,0);
+				for ( unsigned int c = 0; c < _dataTypes.size(); ++c )
+					setVoxel( voxelPos,voxelData,c);
+			
+			}
+				
 		}
+
+		// Get the neighboor brick
+		getBrick( nodePos2, pNeighborBrick, c );
+		
+		// In this part, the goal is to copy voxel data from original brick to voxel data
+		// of the current neighbor brick if it is on a border.
+		// For this, we use a flag telling that data has been modified in the neighbor brick.
+		bool modified = false;
+
+		// Iterate through voxels of the brick
+		for ( unsigned int z = 1; z < _brickWidth + 1; ++z )
+		for ( unsigned int y = 1; y < _brickWidth + 1; ++y )
+		for ( unsigned int x = 1; x < _brickWidth + 1; ++x )
+		{
+			// Store the voxel position of the neighbor brick
+			int x2 = (-i2) * (_brickWidth) + x;
+			int y2 = (-j2) * (_brickWidth) + y;
+			int z2 = (-k2) * (_brickWidth) + z;
+
+				// Check if ( HYPOTHESIS_1 && HYPOTHESIS_2 ) is true.
+				// If yes, it means that this voxel is in the border of the neighbor brick
+				// and we have to copy voxel data of the current brick
+				// to the voxel of the neighbor brick
+				if ( /*HYPOTHESIS_1*/( x2==0 || x2==_brickWidth+1 || 
+					y2==0 || y2==_brickWidth+1 || 
+					z2==0 || z2==_brickWidth+1 )
+					&& /*HYPOTHESIS_2*/ ( x2>=0 && x2<=_brickWidth+1 
+					&& y2>=0 && y2<=_brickWidth+1 
+					&& z2>=0 && z2<=_brickWidth+1 ) )
+				{
+					// Copy voxel data from original brick to "border" voxel of current neighbor brick
+
+					/*for( unsigned int d = 0; d < components[ c ]; ++d )
+					{
+						brick2[(x2 + (brickWidth+2)*(y2 + (brickWidth+2)*z2))*components[c] + d] =
+							brick[(x + (brickWidth+2)*(y + (brickWidth+2)*z))*components[c] + d];
+					}*/
+					memcpy(
+							/*destination*/GvxDataTypeHandler::getAddress( _dataTypes[ c ], pNeighborBrick, x2 + ( _brickWidth + 2 ) * ( y2 + ( _brickWidth + 2 ) * z2 ) ),
+							/*source*/GvxDataTypeHandler::getAddress( _dataTypes[ c ], pBrick, x  + ( _brickWidth + 2 ) * ( y  + ( _brickWidth + 2 ) * z ) ),
+							/*size*/GvxDataTypeHandler::canalByteSize( _dataTypes[ c ] )
+					);
+
+					// Update the flag telling that data has been modified in the neighbor brick.
+					modified = true;
+				}
 		}
 
-		// Free memory of the two brick data buffers
-		delete [] brick;
-		delete [] brick2;
+		// If the brick data has been modified, copy the data to the neighbor brick buffer
+		if ( modified)
+		{
+			setBrick( nodePos2, pNeighborBrick, c );
+		}
 	}
 }
 
@@ -698,7 +964,7 @@ void GvxDataStructureIOHandler::openFiles( const string& pName, bool pNewFiles )
 	// [ 1 ] - Handle node file - [ 1 ]
 
 	// Retrieve the node file name
-	_fileNameNode = getFileNameNode( pName, _level, _brickWidth );
+	_fileNameNode = getFileNameNode( pName, _level, _brickWidth, _borderSize );
 
 	// Handle case where no "new files" are requested
 	if ( ! pNewFiles )
@@ -744,7 +1010,7 @@ void GvxDataStructureIOHandler::openFiles( const string& pName, bool pNewFiles )
 	for ( int c = 0; c < _dataTypes.size(); ++c )
 	{
 		// Retrieve the brick file name associated to current data channel and store it
-		_fileNamesBrick.push_back( getFileNameBrick( pName, _level, _brickWidth, c, GvxDataTypeHandler::getTypeName( _dataTypes[ c ] ) ) );
+		_fileNamesBrick.push_back( getFileNameBrick( pName, _level, _brickWidth, c, GvxDataTypeHandler::getTypeName( _dataTypes[ c ] ), _borderSize ) );
 
 		FILE* brickFile = NULL;
 
@@ -781,14 +1047,15 @@ void GvxDataStructureIOHandler::openFiles( const string& pName, bool pNewFiles )
  * @param pName name of the data file
  * @param pLevel data structure level of resolution
  * @param pBrickWidth width of bricks
+ * @param pBorderSize border size of bricks
  *
  * @return the node file name in GigaVoxels format.
  ******************************************************************************/
-string GvxDataStructureIOHandler::getFileNameNode( const std::string& pName, unsigned int pLevel, unsigned int pBrickWidth )
+string GvxDataStructureIOHandler::getFileNameNode( const std::string& pName, unsigned int pLevel, unsigned int pBrickWidth, unsigned int pBorderSize )
 {
 	std::ostringstream oss;
 	
-	oss << pName << "_BR" << pBrickWidth << "_B1_L" << pLevel << ".nodes";
+	oss << pName << "_BR" << pBrickWidth << "_B" << pBorderSize << "_L" << pLevel << ".nodes";
 
 	return oss.str();
 }
@@ -805,14 +1072,35 @@ string GvxDataStructureIOHandler::getFileNameNode( const std::string& pName, uns
  * @param pBrickWidth width of bricks
  * @param pDataChannelIndex data channel index
  * @param pDataTypeName data type name
+ * @param pBorderSize border size of bricks
  *
  * @return the brick file name in GigaVoxels format.
  ******************************************************************************/
-string GvxDataStructureIOHandler::getFileNameBrick( const string& pName, unsigned int pLevel, unsigned int pBrickWidth, unsigned int pDataChannelIndex, const string& pDataTypeName )
+string GvxDataStructureIOHandler::getFileNameBrick( const string& pName, unsigned int pLevel, unsigned int pBrickWidth, unsigned int pDataChannelIndex, const string& pDataTypeName, unsigned int pBorderSize )
+{
+	std::ostringstream oss;
+
+	oss << pName << "_BR" << pBrickWidth << "_B" << pBorderSize << "_L" << pLevel << "_C" << pDataChannelIndex << "_" << pDataTypeName << ".bricks";
+
+	return oss.str();
+}
+
+/******************************************************************************
+ * Retrieve the node summary file name (see GvxDataStructureSummaryGenerator).
+ * It is the node file name with the "summary" file extension, i.e. "fux_BR8_B1_L0.summary".
+ *
+ * @param pName name of the data file
+ * @param pLevel data structure level of resolution
+ * @param pBrickWidth width of bricks
+ * @param pBorderSize border size of bricks
+ *
+ * @return the node summary file name in GigaVoxels format.
+ ******************************************************************************/
+string GvxDataStructureIOHandler::getFileNameSummary( const string& pName, unsigned int pLevel, unsigned int pBrickWidth, unsigned int pBorderSize )
 {
 	std::ostringstream oss;
 
-	oss << pName << "_BR" << pBrickWidth << "_B1_L" << pLevel << "_C" << pDataChannelIndex << "_" << pDataTypeName << ".bricks";
+	oss << pName << "_BR" << pBrickWidth << "_B" << pBorderSize << "_L" << pLevel << ".summary";
 
 	return oss.str();
 }
@@ -836,7 +1124,7 @@ bool GvxDataStructureIOHandler::isEmpty( unsigned int pNode )
  *
  * @return a brick node info
  ******************************************************************************/
-unsigned int createBrickNode( unsigned int pBrickNumber )
+unsigned int GvxDataStructureIOHandler::createBrickNode( unsigned int pBrickNumber )
 {
 	return ( pBrickNumber | 0x40000000 );
 }
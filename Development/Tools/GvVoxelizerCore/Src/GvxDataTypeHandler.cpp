@@ -81,6 +81,10 @@ unsigned int GvxDataTypeHandler::canalByteSize( VoxelDataType pDataType )
 			result = 4 * sizeof( unsigned short );
 			break;
 
+		case gvUCHAR:
+			result = sizeof( unsigned char );
+			break;
+
 		default:
 			// TO DO
 			// Handle error
@@ -120,6 +124,10 @@ void* GvxDataTypeHandler::allocateVoxels( VoxelDataType pDataType, unsigned int
 			result = new unsigned short[ 4 * pNbElements ];
 			break;
 
+		case gvUCHAR:
+			result = new unsigned char[ pNbElements ];
+			break;
+
 		default:
 			// TO DO
 			// Handle error
@@ -130,6 +138,39 @@ void* GvxDataTypeHandler::allocateVoxels( VoxelDataType pDataType, unsigned int
 	return result;
 }
 
+/******************************************************************************
+ * Free memory allocated by allocateVoxels() for a given data type
+ *
+ * @param pDataType the data type used to allocate the memory (i.e. uchar4, float, float4, etc...)
+ * @param pDataBuffer a pointer on the allocated memory space
+ ******************************************************************************/
+void GvxDataTypeHandler::freeVoxels( VoxelDataType pDataType, void* pDataBuffer )
+{
+	// Memory must be released with the type used by allocateVoxels()
+	switch ( pDataType )
+	{
+		case gvUCHAR4:
+		case gvUCHAR:
+			delete [] static_cast< unsigned char* >( pDataBuffer );
+			break;
+
+		case gvFLOAT:
+		case gvFLOAT4:
+			delete [] static_cast< float* >( pDataBuffer );
+			break;
+
+		case gvHALF4:
+			delete [] static_cast< unsigned short* >( pDataBuffer );
+			break;
+
+		default:
+			// TO DO
+			// Handle error
+			assert( false );
+			break;
+	}
+}
+
 /******************************************************************************
  * Retrieve the address of an element of a given data type in an associated buffer
  *
@@ -163,6 +204,10 @@ void* GvxDataTypeHandler::getAddress( VoxelDataType pDataType, void* pDataBuffer
 			result = &(static_cast< unsigned short* >( pDataBuffer )[ 4 * pElementPosition ] );
 			break;
 
+		case gvUCHAR:
+			result = &( static_cast< unsigned char* >( pDataBuffer )[ pElementPosition ] );
+			break;
+
 		default:
 			// TO DO
 			// Handle error
@@ -201,6 +246,10 @@ std::string GvxDataTypeHandler::getTypeName( VoxelDataType pDataType )
 			result = std::string( "half4" );
 			break;
 
+		case gvUCHAR:
+			result = std::string( "uchar" );
+			break;
+
 		default:
 			// TO DO
 			// Handle error
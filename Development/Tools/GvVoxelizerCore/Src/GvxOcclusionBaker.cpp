@@ -0,0 +1,990 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#include "GvxOcclusionBaker.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvxSceneVoxelizer.h"
+#include "GvxDataStructureIOHandler.h"
+
+// TinyXML
+#include <tinyxml.h>
+
+// STL
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// System
+#ifndef WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// Project
+using namespace Gvx;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Tangent of the half aperture of cones (30 degrees : six cones cover a hemisphere)
+ */
+static const float cConeTanHalfAperture = 0.57735f;
+
+/**
+ * Accumulated occlusion beyond which a cone is stopped
+ */
+static const float cMaxOcclusion = 0.99f;
+
+/**
+ * Node flag bits (the other bits hold the brick index)
+ */
+static const unsigned int cNodeFlagMask = 0xC0000000;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+namespace
+{
+
+/******************************************************************************
+ * Round a value in [ 0 ; 1 ] to the nearest unsigned char
+ *
+ * @param pValue the value
+ *
+ * @return the unsigned char value
+ ******************************************************************************/
+inline unsigned char roundToUchar( float pValue )
+{
+	return static_cast< unsigned char >( std::min( std::max( pValue, 0.f ), 1.f ) * 255.f + 0.5f );
+}
+
+}
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pSceneVoxelizer the scene voxelizer providing the settings of the data structure
+ * (file name, max level of resolution, brick width, data type, borderless bricks, baked channel type)
+ ******************************************************************************/
+GvxOcclusionBaker::GvxOcclusionBaker( GvxSceneVoxelizer& pSceneVoxelizer )
+:	_sceneVoxelizer( pSceneVoxelizer )
+,	_nbThreads( 1 )
+,	_maxDistance( 0.05f )
+,	_brickWidth( pSceneVoxelizer.getBrickWidth() )
+,	_borderSize( pSceneVoxelizer.getVoxelizerEngine().isBorderless() ? 0 : 1 )
+,	_nbBakedComponents( pSceneVoxelizer.isBakedIrradianceOn() ? 4 : 1 )
+,	_channel( 0 )
+,	_levels()
+{
+#ifndef WIN32
+	const long nbProcessors = sysconf( _SC_NPROCESSORS_ONLN );
+	_nbThreads = ( nbProcessors > 0 ) ? static_cast< unsigned int >( nbProcessors ) : 1;
+#endif
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvxOcclusionBaker::~GvxOcclusionBaker()
+{
+}
+
+/******************************************************************************
+ * Set the number of threads used to bake voxels
+ *
+ * @param pValue the number of threads
+ ******************************************************************************/
+void GvxOcclusionBaker::setNbThreads( unsigned int pValue )
+{
+	_nbThreads = std::max( pValue, 1U );
+}
+
+/******************************************************************************
+ * Set the max distance of occluders (cones are not traced further)
+ *
+ * @param pValue the distance (the data structure is a unit cube)
+ ******************************************************************************/
+void GvxOcclusionBaker::setMaxDistance( float pValue )
+{
+	_maxDistance = pValue;
+}
+
+/******************************************************************************
+ * Bake the occlusion channel of all levels of resolution
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxOcclusionBaker::execute()
+{
+	const GvxDataTypeHandler::VoxelDataType dataType = _sceneVoxelizer.getDataType();
+	if ( dataType != GvxDataTypeHandler::gvUCHAR4 && dataType != GvxDataTypeHandler::gvFLOAT4 && dataType != GvxDataTypeHandler::gvFLOAT )
+	{
+		std::cerr << "GvxOcclusionBaker::execute : the data type must be uchar4, float or float4" << std::endl;
+
+		return false;
+	}
+	if ( _nbBakedComponents > 1 && dataType == GvxDataTypeHandler::gvFLOAT )
+	{
+		std::cerr << "GvxOcclusionBaker::execute : irradiance requires colors (uchar4 or float4 data type)" << std::endl;
+
+		return false;
+	}
+	if ( _maxDistance <= 0.f )
+	{
+		std::cerr << "GvxOcclusionBaker::execute : the max distance must be positive" << std::endl;
+
+		return false;
+	}
+
+	// The baked channel comes after the channels of the data structure
+	if ( ! readDescriptorFile() )
+	{
+		return false;
+	}
+
+	// Cones sample all levels of resolution : they are all held in memory
+	const unsigned int nbLevels = _sceneVoxelizer.getMaxResolution() + 1;
+	_levels.clear();
+	_levels.resize( nbLevels );
+	for ( unsigned int level = 0; level < nbLevels; level++ )
+	{
+		if ( ! loadLevel( level ) )
+		{
+			_levels.clear();
+
+			return false;
+		}
+	}
+
+	// The max level of resolution is baked first, coarser levels are then averaged from their children
+	const unsigned int brickSize = _brickWidth * _brickWidth * _brickWidth;
+	for ( int level = nbLevels - 1; level >= 0; level-- )
+	{
+		// LOG info
+		std::cout << "GvxOcclusionBaker::execute : level : " << level << std::endl;
+
+		// Voxels that are not baked (no opacity) are fully visible and receive no irradiance
+		Level& currentLevel = _levels[ level ];
+		const unsigned int nbBricks = static_cast< unsigned int >( currentLevel._brickNodes.size() );
+		currentLevel._bakedData.assign( static_cast< size_t >( nbBricks ) * brickSize * _nbBakedComponents, 0 );
+		for ( size_t i = _nbBakedComponents - 1; i < currentLevel._bakedData.size(); i += _nbBakedComponents )
+		{
+			currentLevel._bakedData[ i ] = 255;
+		}
+
+		// Bricks are shared out between threads
+		const unsigned int nbTasks = std::max( std::min( _nbThreads, nbBricks ), 1U );
+		std::vector< BakeTask > tasks( nbTasks );
+		for ( unsigned int i = 0; i < nbTasks; i++ )
+		{
+			tasks[ i ]._baker = this;
+			tasks[ i ]._level = static_cast< unsigned int >( level );
+			tasks[ i ]._firstBrick = i;
+			tasks[ i ]._brickStep = nbTasks;
+		}
+		runBakeTasks( tasks );
+
+		if ( ! writeLevel( static_cast< unsigned int >( level ) ) )
+		{
+			_levels.clear();
+
+			return false;
+		}
+
+		// The finer level is not used anymore
+		if ( static_cast< unsigned int >( level ) + 1 < nbLevels )
+		{
+			Level emptyLevel;
+			std::swap( _levels[ level + 1 ], emptyLevel );
+		}
+	}
+
+	_levels.clear();
+
+	return true;
+}
+
+/******************************************************************************
+ * Write the XML file describing the data structure with the baked channel :
+ * it is a copy of the descriptor file of the data structure, with the baked channel
+ * listed after the other ones (the channel must have been baked, see execute()).
+ *
+ * @param pFileName the file name
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxOcclusionBaker::writeDescriptorFile( const std::string& pFileName ) const
+{
+	const std::string descriptorFileName = _sceneVoxelizer.getFileName() + ".xml";
+	TiXmlDocument doc( descriptorFileName.c_str() );
+	TiXmlElement* brickDataElement = NULL;
+	if ( doc.LoadFile() && doc.RootElement() != NULL )
+	{
+		brickDataElement = doc.RootElement()->FirstChildElement( "BrickData" );
+	}
+	if ( brickDataElement == NULL )
+	{
+		std::cerr << "GvxOcclusionBaker::writeDescriptorFile : unable to read " << descriptorFileName << std::endl;
+
+		return false;
+	}
+
+	// Baked channel
+	const std::string typeName = GvxDataTypeHandler::getTypeName( _sceneVoxelizer.getBakedOcclusionDataType() );
+	TiXmlElement* channelElement = new TiXmlElement( "Channel" );
+	channelElement->SetAttribute( "id", _channel );
+	channelElement->SetAttribute( "name", "occlusion" );
+	channelElement->SetAttribute( "type", typeName.c_str() );
+	brickDataElement->LinkEndChild( channelElement );
+	const unsigned int nbLevels = _sceneVoxelizer.getMaxResolution() + 1;
+	for ( unsigned int level = 0; level < nbLevels; level++ )
+	{
+		TiXmlElement* levelElement = new TiXmlElement( "Level" );
+		levelElement->SetAttribute( "id", level );
+		levelElement->SetAttribute( "filename", GvxDataStructureIOHandler::getFileNameBrick( _sceneVoxelizer.getFileName(), level, _brickWidth, _channel, typeName, _borderSize ).c_str() );
+		channelElement->LinkEndChild( levelElement );
+	}
+
+	if ( ! doc.SaveFile( pFileName.c_str() ) )
+	{
+		std::cerr << "GvxOcclusionBaker::writeDescriptorFile : unable to write " << pFileName << std::endl;
+
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Get the name of the XML file describing a data structure with its baked channel
+ *
+ * @param pName name of the data structure
+ *
+ * @return the file name ("<name>_occlusion.xml")
+ ******************************************************************************/
+std::string GvxOcclusionBaker::getDescriptorFileName( const std::string& pName )
+{
+	return pName + "_occlusion.xml";
+}
+
+/******************************************************************************
+ * Read the number of channels of the data structure in its XML descriptor file
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxOcclusionBaker::readDescriptorFile()
+{
+	const std::string descriptorFileName = _sceneVoxelizer.getFileName() + ".xml";
+	TiXmlDocument doc( descriptorFileName.c_str() );
+	const TiXmlElement* brickDataElement = NULL;
+	if ( doc.LoadFile() && doc.RootElement() != NULL )
+	{
+		brickDataElement = doc.RootElement()->FirstChildElement( "BrickData" );
+	}
+	if ( brickDataElement == NULL )
+	{
+		std::cerr << "GvxOcclusionBaker::readDescriptorFile : unable to read " << descriptorFileName << std::endl;
+
+		return false;
+	}
+
+	_channel = 0;
+	for ( const TiXmlElement* channelElement = brickDataElement->FirstChildElement( "Channel" ); channelElement != NULL; channelElement = channelElement->NextSiblingElement( "Channel" ) )
+	{
+		_channel++;
+	}
+	if ( _channel == 0 )
+	{
+		std::cerr << "GvxOcclusionBaker::readDescriptorFile : no channel in " << descriptorFileName << std::endl;
+
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Load the node file and the opacity (and color) of the first channel of a level
+ *
+ * @param pLevel level of resolution
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxOcclusionBaker::loadLevel( unsigned int pLevel )
+{
+	Level& level = _levels[ pLevel ];
+	level._nodeGridSize = 1 << pLevel;
+	const unsigned int nbNodes = level._nodeGridSize * level._nodeGridSize * level._nodeGridSize;
+
+	// Nodes
+	const std::string nodeFileName = GvxDataStructureIOHandler::getFileNameNode( _sceneVoxelizer.getFileName(), pLevel, _brickWidth, _borderSize );
+	FILE* nodeFile = fopen( nodeFileName.c_str(), "rb" );
+	if ( nodeFile == NULL )
+	{
+		std::cerr << "GvxOcclusionBaker::loadLevel : unable to open " << nodeFileName << std::endl;
+
+		return false;
+	}
+	level._nodes.resize( nbNodes );
+	const bool isNodeFileRead = ( fread( &level._nodes[ 0 ], sizeof( unsigned int ), nbNodes, nodeFile ) == nbNodes );
+	fclose( nodeFile );
+	if ( ! isNodeFileRead )
+	{
+		std::cerr << "GvxOcclusionBaker::loadLevel : unable to read " << nodeFileName << std::endl;
+
+		return false;
+	}
+
+	// Bricks of the first channel : only opacity and color of voxels (borders excluded) are kept
+	const GvxDataTypeHandler::VoxelDataType dataType = _sceneVoxelizer.getDataType();
+	const std::string brickFileName = GvxDataStructureIOHandler::getFileNameBrick( _sceneVoxelizer.getFileName(), pLevel, _brickWidth, 0, GvxDataTypeHandler::getTypeName( dataType ), _borderSize );
+	FILE* brickFile = fopen( brickFileName.c_str(), "rb" );
+	if ( brickFile == NULL )
+	{
+		std::cerr << "GvxOcclusionBaker::loadLevel : unable to open " << brickFileName << std::endl;
+
+		return false;
+	}
+	const unsigned int brickResolution = _brickWidth + 2 * _borderSize;
+	const unsigned int brickSize = _brickWidth * _brickWidth * _brickWidth;
+	const unsigned int voxelByteSize = GvxDataTypeHandler::canalByteSize( dataType );
+	std::vector< unsigned char > brick( static_cast< size_t >( brickResolution ) * brickResolution * brickResolution * voxelByteSize );
+	level._opacities.clear();
+	level._colors.clear();
+	while ( fread( &brick[ 0 ], 1, brick.size(), brickFile ) == brick.size() )
+	{
+		for ( unsigned int z = 0; z < _brickWidth; z++ )
+		for ( unsigned int y = 0; y < _brickWidth; y++ )
+		for ( unsigned int x = 0; x < _brickWidth; x++ )
+		{
+			const unsigned int voxel = ( x + _borderSize ) + brickResolution * ( ( y + _borderSize ) + brickResolution * ( z + _borderSize ) );
+			const void* voxelData = GvxDataTypeHandler::getAddress( dataType, &brick[ 0 ], voxel );
+			if ( dataType == GvxDataTypeHandler::gvUCHAR4 )
+			{
+				const unsigned char* color = static_cast< const unsigned char* >( voxelData );
+				level._opacities.push_back( color[ 3 ] );
+				level._colors.push_back( color[ 0 ] );
+				level._colors.push_back( color[ 1 ] );
+				level._colors.push_back( color[ 2 ] );
+			}
+			else if ( dataType == GvxDataTypeHandler::gvFLOAT4 )
+			{
+				const float* color = static_cast< const float* >( voxelData );
+				level._opacities.push_back( roundToUchar( color[ 3 ] ) );
+				level._colors.push_back( roundToUchar( color[ 0 ] ) );
+				level._colors.push_back( roundToUchar( color[ 1 ] ) );
+				level._colors.push_back( roundToUchar( color[ 2 ] ) );
+			}
+			else
+			{
+				// Densities have no color : occluders are white
+				const unsigned char density = roundToUchar( *static_cast< const float* >( voxelData ) );
+				level._opacities.push_back( density );
+				level._colors.push_back( density );
+				level._colors.push_back( density );
+				level._colors.push_back( density );
+			}
+		}
+	}
+	fclose( brickFile );
+
+	// Node of each brick
+	const unsigned int nbBricks = static_cast< unsigned int >( level._opacities.size() / brickSize );
+	level._brickNodes.assign( nbBricks, nbNodes );
+	for ( unsigned int i = 0; i < nbNodes; i++ )
+	{
+		if ( GvxDataStructureIOHandler::isEmpty( level._nodes[ i ] ) )
+		{
+			continue;
+		}
+
+		const unsigned int brickIndex = level._nodes[ i ] & ~cNodeFlagMask;
+		if ( brickIndex >= nbBricks )
+		{
+			std::cerr << "GvxOcclusionBaker::loadLevel : " << brickFileName << " has " << nbBricks << " bricks, node " << i << " refers to brick " << brickIndex << std::endl;
+
+			return false;
+		}
+		level._brickNodes[ brickIndex ] = i;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Write the baked channel of a level
+ *
+ * @param pLevel level of resolution
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxOcclusionBaker::writeLevel( unsigned int pLevel )
+{
+	const Level& level = _levels[ pLevel ];
+
+	// The baked channel comes after the channels of the data structure
+	const std::string typeName = GvxDataTypeHandler::getTypeName( _sceneVoxelizer.getBakedOcclusionDataType() );
+	const std::string fileName = GvxDataStructureIOHandler::getFileNameBrick( _sceneVoxelizer.getFileName(), pLevel, _brickWidth, _channel, typeName, _borderSize );
+	FILE* file = fopen( fileName.c_str(), "wb" );
+	if ( file == NULL )
+	{
+		std::cerr << "GvxOcclusionBaker::writeLevel : unable to create " << fileName << std::endl;
+
+		return false;
+	}
+
+	// Bricks get the same layout as in other channels : border voxels are copied from neighbor bricks
+	const unsigned int brickResolution = _brickWidth + 2 * _borderSize;
+	const unsigned int nbNodes = level._nodeGridSize * level._nodeGridSize * level._nodeGridSize;
+	std::vector< unsigned char > brick( static_cast< size_t >( brickResolution ) * brickResolution * brickResolution * _nbBakedComponents );
+	bool isWritten = true;
+	for ( unsigned int brickIndex = 0; brickIndex < level._brickNodes.size() && isWritten; brickIndex++ )
+	{
+		const unsigned int node = level._brickNodes[ brickIndex ];
+		int nodePos[ 3 ];
+		nodePos[ 0 ] = static_cast< int >( node % level._nodeGridSize );
+		nodePos[ 1 ] = static_cast< int >( ( node / level._nodeGridSize ) % level._nodeGridSize );
+		nodePos[ 2 ] = static_cast< int >( node / ( level._nodeGridSize * level._nodeGridSize ) );
+
+		unsigned char* voxelData = &brick[ 0 ];
+		for ( unsigned int z = 0; z < brickResolution; z++ )
+		for ( unsigned int y = 0; y < brickResolution; y++ )
+		for ( unsigned int x = 0; x < brickResolution; x++ )
+		{
+			int voxelPos[ 3 ];
+			voxelPos[ 0 ] = nodePos[ 0 ] * static_cast< int >( _brickWidth ) + static_cast< int >( x ) - static_cast< int >( _borderSize );
+			voxelPos[ 1 ] = nodePos[ 1 ] * static_cast< int >( _brickWidth ) + static_cast< int >( y ) - static_cast< int >( _borderSize );
+			voxelPos[ 2 ] = nodePos[ 2 ] * static_cast< int >( _brickWidth ) + static_cast< int >( z ) - static_cast< int >( _borderSize );
+
+			const long long voxelIndex = ( node < nbNodes ) ? getVoxelIndex( pLevel, voxelPos ) : -1;
+			for ( unsigned int c = 0; c < _nbBakedComponents; c++ )
+			{
+				voxelData[ c ] = ( voxelIndex >= 0 ) ? level._bakedData[ static_cast< size_t >( voxelIndex ) * _nbBakedComponents + c ] : ( ( c + 1 == _nbBakedComponents ) ? 255 : 0 );
+			}
+			voxelData += _nbBakedComponents;
+		}
+
+		isWritten = ( fwrite( &brick[ 0 ], 1, brick.size(), file ) == brick.size() );
+	}
+	if ( fclose( file ) != 0 )
+	{
+		isWritten = false;
+	}
+	if ( ! isWritten )
+	{
+		std::cerr << "GvxOcclusionBaker::writeLevel : unable to write " << fileName << std::endl;
+	}
+
+	return isWritten;
+}
+
+/******************************************************************************
+ * Bake bricks of a level : cone tracing at the max level of resolution,
+ * averaging of the children otherwise
+ *
+ * @param pLevel level of resolution
+ * @param pFirstBrick first brick
+ * @param pBrickStep number of bricks between two baked bricks
+ ******************************************************************************/
+void GvxOcclusionBaker::bakeBricks( unsigned int pLevel, unsigned int pFirstBrick, unsigned int pBrickStep )
+{
+	Level& level = _levels[ pLevel ];
+	const bool isMaxLevel = ( pLevel + 1 == _levels.size() );
+	const unsigned int nbNodes = level._nodeGridSize * level._nodeGridSize * level._nodeGridSize;
+	const unsigned int brickSize = _brickWidth * _brickWidth * _brickWidth;
+
+	for ( unsigned int brickIndex = pFirstBrick; brickIndex < level._brickNodes.size(); brickIndex += pBrickStep )
+	{
+		// Bricks that no node refers to are not used
+		const unsigned int node = level._brickNodes[ brickIndex ];
+		if ( node >= nbNodes )
+		{
+			continue;
+		}
+
+		int nodePos[ 3 ];
+		nodePos[ 0 ] = static_cast< int >( node % level._nodeGridSize );
+		nodePos[ 1 ] = static_cast< int >( ( node / level._nodeGridSize ) % level._nodeGridSize );
+		nodePos[ 2 ] = static_cast< int >( node / ( level._nodeGridSize * level._nodeGridSize ) );
+
+		unsigned int voxelInBrick = 0;
+		for ( unsigned int z = 0; z < _brickWidth; z++ )
+		for ( unsigned int y = 0; y < _brickWidth; y++ )
+		for ( unsigned int x = 0; x < _brickWidth; x++, voxelInBrick++ )
+		{
+			const size_t voxelIndex = static_cast< size_t >( brickIndex ) * brickSize + voxelInBrick;
+
+			// Empty voxels keep their default value
+			if ( level._opacities[ voxelIndex ] == 0 )
+			{
+				continue;
+			}
+
+			int voxelPos[ 3 ];
+			voxelPos[ 0 ] = nodePos[ 0 ] * static_cast< int >( _brickWidth ) + static_cast< int >( x );
+			voxelPos[ 1 ] = nodePos[ 1 ] * static_cast< int >( _brickWidth ) + static_cast< int >( y );
+			voxelPos[ 2 ] = nodePos[ 2 ] * static_cast< int >( _brickWidth ) + static_cast< int >( z );
+
+			unsigned char* bakedData = &level._bakedData[ voxelIndex * _nbBakedComponents ];
+			if ( isMaxLevel )
+			{
+				traceVoxel( voxelPos, bakedData );
+			}
+			else
+			{
+				filterVoxel( pLevel, voxelPos, bakedData );
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * Bake a voxel of the max level of resolution by cone tracing
+ *
+ * @param pVoxelPos voxel position
+ * @param pBakedData the baked data of the voxel
+ ******************************************************************************/
+void GvxOcclusionBaker::traceVoxel( const int pVoxelPos[ 3 ], unsigned char* pBakedData ) const
+{
+	const unsigned int maxLevel = static_cast< unsigned int >( _levels.size() ) - 1;
+	const float voxelSize = 1.f / static_cast< float >( _levels[ maxLevel ]._nodeGridSize * _brickWidth );
+
+	// The normal is the opposite of the opacity gradient
+	float normal[ 3 ];
+	for ( unsigned int i = 0; i < 3; i++ )
+	{
+		int previousVoxelPos[ 3 ] = { pVoxelPos[ 0 ], pVoxelPos[ 1 ], pVoxelPos[ 2 ] };
+		int nextVoxelPos[ 3 ] = { pVoxelPos[ 0 ], pVoxelPos[ 1 ], pVoxelPos[ 2 ] };
+		previousVoxelPos[ i ]--;
+		nextVoxelPos[ i ]++;
+		normal[ i ] = getOpacity( maxLevel, previousVoxelPos ) - getOpacity( maxLevel, nextVoxelPos );
+	}
+	const float norm = sqrtf( normal[ 0 ] * normal[ 0 ] + normal[ 1 ] * normal[ 1 ] + normal[ 2 ] * normal[ 2 ] );
+
+	// Cones are traced in the hemisphere around the normal. Voxels with no gradient are
+	// given the mean of the hemispheres of the axes along which the neighbor voxel is less opaque
+	// (i.e. both sides of thin structures), or of all axes (inside matter).
+	std::vector< float > axes;
+	if ( norm > 0.01f )
+	{
+		axes.push_back( normal[ 0 ] / norm );
+		axes.push_back( normal[ 1 ] / norm );
+		axes.push_back( normal[ 2 ] / norm );
+	}
+	else
+	{
+		const float opacity = getOpacity( maxLevel, pVoxelPos );
+		for ( unsigned int pass = 0; pass < 2 && axes.empty(); pass++ )
+		{
+			for ( unsigned int i = 0; i < 6; i++ )
+			{
+				float axis[ 3 ] = { 0.f, 0.f, 0.f };
+				axis[ i / 2 ] = ( i % 2 ) ? -1.f : 1.f;
+
+				int neighborVoxelPos[ 3 ] = { pVoxelPos[ 0 ], pVoxelPos[ 1 ], pVoxelPos[ 2 ] };
+				neighborVoxelPos[ i / 2 ] += ( i % 2 ) ? -1 : 1;
+				if ( pass == 1 || getOpacity( maxLevel, neighborVoxelPos ) < opacity )
+				{
+					axes.insert( axes.end(), axis, axis + 3 );
+				}
+			}
+		}
+	}
+
+	float visibility = 0.f;
+	float irradiance[ 3 ] = { 0.f, 0.f, 0.f };
+	const float nbHemispheres = static_cast< float >( axes.size() / 3 );
+	std::vector< Cone > cones;
+	for ( size_t axis = 0; axis < axes.size(); axis += 3 )
+	{
+		// Cones start from the surface (one voxel away from the voxel center)
+		float origin[ 3 ];
+		for ( unsigned int i = 0; i < 3; i++ )
+		{
+			origin[ i ] = ( static_cast< float >( pVoxelPos[ i ] ) + 0.5f + axes[ axis + i ] ) * voxelSize;
+		}
+		cones.clear();
+		buildHemisphereCones( &axes[ axis ], cones );
+
+		// Occlusion and irradiance are weighted sums of the cones
+		float occlusion = 0.f;
+		float hemisphereIrradiance[ 3 ] = { 0.f, 0.f, 0.f };
+		float weightSum = 0.f;
+		for ( size_t i = 0; i < cones.size(); i++ )
+		{
+			float coneOcclusion;
+			float coneColor[ 3 ];
+			traceCone( origin, cones[ i ]._direction, coneOcclusion, coneColor );
+
+			occlusion += cones[ i ]._weight * coneOcclusion;
+			hemisphereIrradiance[ 0 ] += cones[ i ]._weight * coneColor[ 0 ];
+			hemisphereIrradiance[ 1 ] += cones[ i ]._weight * coneColor[ 1 ];
+			hemisphereIrradiance[ 2 ] += cones[ i ]._weight * coneColor[ 2 ];
+			weightSum += cones[ i ]._weight;
+		}
+
+		visibility += ( 1.f - occlusion / weightSum ) / nbHemispheres;
+		irradiance[ 0 ] += hemisphereIrradiance[ 0 ] / ( weightSum * nbHemispheres );
+		irradiance[ 1 ] += hemisphereIrradiance[ 1 ] / ( weightSum * nbHemispheres );
+		irradiance[ 2 ] += hemisphereIrradiance[ 2 ] / ( weightSum * nbHemispheres );
+	}
+
+	if ( _nbBakedComponents == 1 )
+	{
+		pBakedData[ 0 ] = roundToUchar( visibility );
+	}
+	else
+	{
+		pBakedData[ 0 ] = roundToUchar( irradiance[ 0 ] );
+		pBakedData[ 1 ] = roundToUchar( irradiance[ 1 ] );
+		pBakedData[ 2 ] = roundToUchar( irradiance[ 2 ] );
+		pBakedData[ 3 ] = roundToUchar( visibility );
+	}
+}
+
+/******************************************************************************
+ * Bake a voxel of a coarser level from its children
+ *
+ * @param pLevel level of resolution
+ * @param pVoxelPos voxel position
+ * @param pBakedData the baked data of the voxel
+ ******************************************************************************/
+void GvxOcclusionBaker::filterVoxel( unsigned int pLevel, const int pVoxelPos[ 3 ], unsigned char* pBakedData ) const
+{
+	const Level& childLevel = _levels[ pLevel + 1 ];
+
+	// Children are weighted by their opacity, as shading is
+	float bakedData[ 4 ] = { 0.f, 0.f, 0.f, 0.f };
+	float weightSum = 0.f;
+	for ( int z = 0; z < 2; z++ )
+	for ( int y = 0; y < 2; y++ )
+	for ( int x = 0; x < 2; x++ )
+	{
+		int childVoxelPos[ 3 ];
+		childVoxelPos[ 0 ] = 2 * pVoxelPos[ 0 ] + x;
+		childVoxelPos[ 1 ] = 2 * pVoxelPos[ 1 ] + y;
+		childVoxelPos[ 2 ] = 2 * pVoxelPos[ 2 ] + z;
+
+		const long long childVoxelIndex = getVoxelIndex( pLevel + 1, childVoxelPos );
+		if ( childVoxelIndex < 0 )
+		{
+			continue;
+		}
+
+		const float weight = static_cast< float >( childLevel._opacities[ static_cast< size_t >( childVoxelIndex ) ] );
+		const unsigned char* childBakedData = &childLevel._bakedData[ static_cast< size_t >( childVoxelIndex ) * _nbBakedComponents ];
+		for ( unsigned int c = 0; c < _nbBakedComponents; c++ )
+		{
+			bakedData[ c ] += weight * static_cast< float >( childBakedData[ c ] );
+		}
+		weightSum += weight;
+	}
+
+	if ( weightSum > 0.f )
+	{
+		for ( unsigned int c = 0; c < _nbBakedComponents; c++ )
+		{
+			pBakedData[ c ] = static_cast< unsigned char >( bakedData[ c ] / weightSum + 0.5f );
+		}
+	}
+}
+
+/******************************************************************************
+ * Trace a cone and accumulate opacity and color front to back
+ *
+ * @param pOrigin origin of the cone
+ * @param pDirection direction of the cone
+ * @param pOcclusion the accumulated occlusion
+ * @param pColor the accumulated color
+ ******************************************************************************/
+void GvxOcclusionBaker::traceCone( const float pOrigin[ 3 ], const float pDirection[ 3 ], float& pOcclusion, float pColor[ 3 ] ) const
+{
+	const unsigned int maxLevel = static_cast< unsigned int >( _levels.size() ) - 1;
+	const float voxelSize = 1.f / static_cast< float >( _levels[ maxLevel ]._nodeGridSize * _brickWidth );
+
+	pOcclusion = 0.f;
+	pColor[ 0 ] = 0.f;
+	pColor[ 1 ] = 0.f;
+	pColor[ 2 ] = 0.f;
+
+	float distance = voxelSize;
+	while ( distance < _maxDistance && pOcclusion < cMaxOcclusion )
+	{
+		// The level of resolution matches the cone diameter : it is interpolated between two levels
+		const float diameter = std::max( 2.f * cConeTanHalfAperture * distance, voxelSize );
+		const float level = std::max( static_cast< float >( maxLevel ) - log( diameter / voxelSize ) / log( 2.f ), 0.f );
+		const unsigned int coarseLevel = static_cast< unsigned int >( level );
+		const unsigned int fineLevel = std::min( coarseLevel + 1, maxLevel );
+		const float fineWeight = level - static_cast< float >( coarseLevel );
+
+		float position[ 3 ];
+		position[ 0 ] = pOrigin[ 0 ] + distance * pDirection[ 0 ];
+		position[ 1 ] = pOrigin[ 1 ] + distance * pDirection[ 1 ];
+		position[ 2 ] = pOrigin[ 2 ] + distance * pDirection[ 2 ];
+
+		float opacity;
+		float color[ 3 ];
+		sampleLevel( coarseLevel, position, opacity, color );
+		if ( fineWeight > 0.f )
+		{
+			float fineOpacity;
+			float fineColor[ 3 ];
+			sampleLevel( fineLevel, position, fineOpacity, fineColor );
+			opacity += fineWeight * ( fineOpacity - opacity );
+			color[ 0 ] += fineWeight * ( fineColor[ 0 ] - color[ 0 ] );
+			color[ 1 ] += fineWeight * ( fineColor[ 1 ] - color[ 1 ] );
+			color[ 2 ] += fineWeight * ( fineColor[ 2 ] - color[ 2 ] );
+		}
+
+		// Samples are taken every half diameter : opacity is corrected accordingly
+		const float step = 0.5f * diameter;
+		if ( opacity > 0.f )
+		{
+			const float correctedOpacity = 1.f - pow( std::max( 1.f - opacity, 0.f ), step / diameter );
+			const float transmittance = 1.f - pOcclusion;
+
+			// Occluders are lit by the sky : they reflect their color (colors are premultiplied)
+			pColor[ 0 ] += transmittance * correctedOpacity * color[ 0 ] / opacity;
+			pColor[ 1 ] += transmittance * correctedOpacity * color[ 1 ] / opacity;
+			pColor[ 2 ] += transmittance * correctedOpacity * color[ 2 ] / opacity;
+			pOcclusion += transmittance * correctedOpacity;
+		}
+
+		distance += step;
+	}
+}
+
+/******************************************************************************
+ * Sample opacity and color of a level with trilinear interpolation
+ *
+ * @param pLevel level of resolution
+ * @param pPosition position (the data structure is a unit cube)
+ * @param pOpacity the opacity
+ * @param pColor the color (premultiplied)
+ ******************************************************************************/
+void GvxOcclusionBaker::sampleLevel( unsigned int pLevel, const float pPosition[ 3 ], float& pOpacity, float pColor[ 3 ] ) const
+{
+	const Level& level = _levels[ pLevel ];
+	const float voxelGridSize = static_cast< float >( level._nodeGridSize * _brickWidth );
+
+	// Voxel centers are at half voxels
+	int firstVoxelPos[ 3 ];
+	float weights[ 3 ];
+	for ( unsigned int i = 0; i < 3; i++ )
+	{
+		const float position = pPosition[ i ] * voxelGridSize - 0.5f;
+		const float firstPosition = floor( position );
+		firstVoxelPos[ i ] = static_cast< int >( firstPosition );
+		weights[ i ] = position - firstPosition;
+	}
+
+	pOpacity = 0.f;
+	pColor[ 0 ] = 0.f;
+	pColor[ 1 ] = 0.f;
+	pColor[ 2 ] = 0.f;
+	for ( int z = 0; z < 2; z++ )
+	for ( int y = 0; y < 2; y++ )
+	for ( int x = 0; x < 2; x++ )
+	{
+		int voxelPos[ 3 ];
+		voxelPos[ 0 ] = firstVoxelPos[ 0 ] + x;
+		voxelPos[ 1 ] = firstVoxelPos[ 1 ] + y;
+		voxelPos[ 2 ] = firstVoxelPos[ 2 ] + z;
+
+		const long long voxelIndex = getVoxelIndex( pLevel, voxelPos );
+		if ( voxelIndex < 0 )
+		{
+			continue;
+		}
+
+		const float weight = ( x ? weights[ 0 ] : 1.f - weights[ 0 ] ) * ( y ? weights[ 1 ] : 1.f - weights[ 1 ] ) * ( z ? weights[ 2 ] : 1.f - weights[ 2 ] ) / 255.f;
+		pOpacity += weight * static_cast< float >( level._opacities[ static_cast< size_t >( voxelIndex ) ] );
+		pColor[ 0 ] += weight * static_cast< float >( level._colors[ 3 * static_cast< size_t >( voxelIndex ) + 0 ] );
+		pColor[ 1 ] += weight * static_cast< float >( level._colors[ 3 * static_cast< size_t >( voxelIndex ) + 1 ] );
+		pColor[ 2 ] += weight * static_cast< float >( level._colors[ 3 * static_cast< size_t >( voxelIndex ) + 2 ] );
+	}
+}
+
+/******************************************************************************
+ * Retrieve the index of a voxel in the bricks of a level (bricks without borders)
+ *
+ * @param pLevel level of resolution
+ * @param pVoxelPos voxel position
+ *
+ * @return the index of the voxel, -1 if it is outside the data structure or in an empty node
+ ******************************************************************************/
+long long GvxOcclusionBaker::getVoxelIndex( unsigned int pLevel, const int pVoxelPos[ 3 ] ) const
+{
+	const Level& level = _levels[ pLevel ];
+	const int voxelGridSize = static_cast< int >( level._nodeGridSize * _brickWidth );
+	if ( pVoxelPos[ 0 ] < 0 || pVoxelPos[ 0 ] >= voxelGridSize ||
+		pVoxelPos[ 1 ] < 0 || pVoxelPos[ 1 ] >= voxelGridSize ||
+		pVoxelPos[ 2 ] < 0 || pVoxelPos[ 2 ] >= voxelGridSize )
+	{
+		return -1;
+	}
+
+	const unsigned int brickWidth = _brickWidth;
+	const unsigned int voxelPos[ 3 ] = { static_cast< unsigned int >( pVoxelPos[ 0 ] ), static_cast< unsigned int >( pVoxelPos[ 1 ] ), static_cast< unsigned int >( pVoxelPos[ 2 ] ) };
+	const unsigned int node = level._nodes[ voxelPos[ 0 ] / brickWidth + level._nodeGridSize * ( voxelPos[ 1 ] / brickWidth + level._nodeGridSize * ( voxelPos[ 2 ] / brickWidth ) ) ];
+	if ( GvxDataStructureIOHandler::isEmpty( node ) )
+	{
+		return -1;
+	}
+
+	const unsigned int voxelInBrick = voxelPos[ 0 ] % brickWidth + brickWidth * ( voxelPos[ 1 ] % brickWidth + brickWidth * ( voxelPos[ 2 ] % brickWidth ) );
+
+	return static_cast< long long >( node & ~cNodeFlagMask ) * ( brickWidth * brickWidth * brickWidth ) + voxelInBrick;
+}
+
+/******************************************************************************
+ * Get the opacity of a voxel
+ *
+ * @param pLevel level of resolution
+ * @param pVoxelPos voxel position
+ *
+ * @return the opacity (0 outside the data structure and in empty nodes)
+ ******************************************************************************/
+float GvxOcclusionBaker::getOpacity( unsigned int pLevel, const int pVoxelPos[ 3 ] ) const
+{
+	const long long voxelIndex = getVoxelIndex( pLevel, pVoxelPos );
+
+	return ( voxelIndex >= 0 ) ? static_cast< float >( _levels[ pLevel ]._opacities[ static_cast< size_t >( voxelIndex ) ] ) / 255.f : 0.f;
+}
+
+/******************************************************************************
+ * Run bake tasks, one thread per task
+ *
+ * @param pTasks the tasks
+ ******************************************************************************/
+void GvxOcclusionBaker::runBakeTasks( std::vector< BakeTask >& pTasks )
+{
+#ifndef WIN32
+	std::vector< pthread_t > threads( pTasks.size() );
+	std::vector< bool > isThreadCreated( pTasks.size(), false );
+	for ( size_t i = 0; i < pTasks.size(); i++ )
+	{
+		isThreadCreated[ i ] = ( pthread_create( &threads[ i ], NULL, runBakeTask, &pTasks[ i ] ) == 0 );
+		if ( ! isThreadCreated[ i ] )
+		{
+			runBakeTask( &pTasks[ i ] );
+		}
+	}
+	for ( size_t i = 0; i < pTasks.size(); i++ )
+	{
+		if ( isThreadCreated[ i ] )
+		{
+			pthread_join( threads[ i ], NULL );
+		}
+	}
+#else
+	for ( size_t i = 0; i < pTasks.size(); i++ )
+	{
+		runBakeTask( &pTasks[ i ] );
+	}
+#endif
+}
+
+/******************************************************************************
+ * Thread entry point of a bake task
+ *
+ * @param pTask the task
+ *
+ * @return NULL
+ ******************************************************************************/
+void* GvxOcclusionBaker::runBakeTask( void* pTask )
+{
+	BakeTask* task = static_cast< BakeTask* >( pTask );
+	task->_baker->bakeBricks( task->_level, task->_firstBrick, task->_brickStep );
+
+	return NULL;
+}
+
+/******************************************************************************
+ * Build the cones of a hemisphere : one cone along the axis and five cones around it
+ * (60 degrees away from the axis), weighted by the cosine of their direction
+ *
+ * @param pNormal axis of the hemisphere
+ * @param pCones the cones (they are appended to the list)
+ ******************************************************************************/
+void GvxOcclusionBaker::buildHemisphereCones( const float pNormal[ 3 ], std::vector< Cone >& pCones )
+{
+	const float pi = 3.14159265f;
+
+	// Tangent frame of the hemisphere
+	const float other[ 3 ] = { ( fabs( pNormal[ 0 ] ) < 0.9f ) ? 1.f : 0.f, ( fabs( pNormal[ 0 ] ) < 0.9f ) ? 0.f : 1.f, 0.f };
+	float tangent[ 3 ];
+	tangent[ 0 ] = pNormal[ 1 ] * other[ 2 ] - pNormal[ 2 ] * other[ 1 ];
+	tangent[ 1 ] = pNormal[ 2 ] * other[ 0 ] - pNormal[ 0 ] * other[ 2 ];
+	tangent[ 2 ] = pNormal[ 0 ] * other[ 1 ] - pNormal[ 1 ] * other[ 0 ];
+	const float tangentNorm = sqrtf( tangent[ 0 ] * tangent[ 0 ] + tangent[ 1 ] * tangent[ 1 ] + tangent[ 2 ] * tangent[ 2 ] );
+	tangent[ 0 ] /= tangentNorm;
+	tangent[ 1 ] /= tangentNorm;
+	tangent[ 2 ] /= tangentNorm;
+	float bitangent[ 3 ];
+	bitangent[ 0 ] = pNormal[ 1 ] * tangent[ 2 ] - pNormal[ 2 ] * tangent[ 1 ];
+	bitangent[ 1 ] = pNormal[ 2 ] * tangent[ 0 ] - pNormal[ 0 ] * tangent[ 2 ];
+	bitangent[ 2 ] = pNormal[ 0 ] * tangent[ 1 ] - pNormal[ 1 ] * tangent[ 0 ];
+
+	Cone cone;
+	cone._direction[ 0 ] = pNormal[ 0 ];
+	cone._direction[ 1 ] = pNormal[ 1 ];
+	cone._direction[ 2 ] = pNormal[ 2 ];
+	cone._weight = 0.25f;
+	pCones.push_back( cone );
+
+	for ( unsigned int i = 0; i < 5; i++ )
+	{
+		const float angle = 2.f * pi * static_cast< float >( i ) / 5.f;
+		for ( unsigned int j = 0; j < 3; j++ )
+		{
+			cone._direction[ j ] = 0.5f * pNormal[ j ] + 0.866025f * ( cos( angle ) * tangent[ j ] + sin( angle ) * bitangent[ j ] );
+		}
+		cone._weight = 0.15f;
+		pCones.push_back( cone );
+	}
+}
@@ -0,0 +1,662 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#include "GvxPointCloudReader.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// Project
+using namespace Gvx;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvxPointCloudReader::GvxPointCloudReader()
+:	_file( NULL )
+,	_format( eXYZ )
+,	_dataOffset( 0 )
+,	_nbPoints( 0 )
+,	_nbReadPoints( 0 )
+,	_properties()
+,	_vertexSize( 0 )
+,	_vertexBuffer()
+,	_hasColors( false )
+,	_hasNormals( false )
+,	_columns()
+,	_colorScale( 1.0 )
+,	_hasError( false )
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvxPointCloudReader::~GvxPointCloudReader()
+{
+	close();
+}
+
+/******************************************************************************
+ * Open a point cloud file and read its header
+ *
+ * @param pFileName the point cloud file name
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxPointCloudReader::open( const std::string& pFileName )
+{
+	close();
+
+	_file = fopen( pFileName.c_str(), "rb" );
+	if ( _file == NULL )
+	{
+		std::cerr << "GvxPointCloudReader::open : unable to open " << pFileName << std::endl;
+
+		return false;
+	}
+
+	// The format is given by the file extension
+	std::string extension = pFileName.substr( std::min( pFileName.size(), pFileName.find_last_of( '.' ) ) );
+	std::transform( extension.begin(), extension.end(), extension.begin(), ::tolower );
+	const bool isSucceeded = ( extension == ".ply" ) ? readPLYHeader() : readXYZHeader();
+	if ( ! isSucceeded )
+	{
+		std::cerr << "GvxPointCloudReader::open : unsupported point cloud file " << pFileName << std::endl;
+		close();
+
+		return false;
+	}
+
+	return rewind();
+}
+
+/******************************************************************************
+ * Close the point cloud file
+ ******************************************************************************/
+void GvxPointCloudReader::close()
+{
+	if ( _file != NULL )
+	{
+		fclose( _file );
+		_file = NULL;
+	}
+
+	_nbPoints = 0;
+	_nbReadPoints = 0;
+	_properties.clear();
+	_columns.clear();
+	_hasColors = false;
+	_hasNormals = false;
+	_hasError = false;
+}
+
+/******************************************************************************
+ * Go back to the first point
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxPointCloudReader::rewind()
+{
+	if ( _file == NULL )
+	{
+		return false;
+	}
+
+#ifdef WIN32
+	const bool isSucceeded = ( _fseeki64( _file, _dataOffset, SEEK_SET ) == 0 );
+#else
+	const bool isSucceeded = ( fseeko( _file, static_cast< off_t >( _dataOffset ), SEEK_SET ) == 0 );
+#endif
+	_nbReadPoints = 0;
+	_hasError = ! isSucceeded;
+
+	return isSucceeded;
+}
+
+/******************************************************************************
+ * Read the next point
+ *
+ * @param pPoint the point
+ *
+ * @return false at the end of the points (or on a read error, see hasError())
+ ******************************************************************************/
+bool GvxPointCloudReader::readPoint( Point& pPoint )
+{
+	if ( _file == NULL || _hasError )
+	{
+		return false;
+	}
+
+	double values[ 9 ] = { 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 0.0, 0.0, 0.0 };
+
+	if ( _format == ePLYBinaryLittleEndian || _format == ePLYBinaryBigEndian )
+	{
+		if ( _nbReadPoints >= _nbPoints )
+		{
+			return false;
+		}
+		if ( fread( &_vertexBuffer[ 0 ], 1, _vertexSize, _file ) != _vertexSize )
+		{
+			std::cerr << "GvxPointCloudReader::readPoint : unexpected end of file at point " << _nbReadPoints << std::endl;
+			_hasError = true;
+
+			return false;
+		}
+
+		const unsigned char* data = &_vertexBuffer[ 0 ];
+		for ( size_t i = 0; i < _properties.size(); i++ )
+		{
+			if ( _properties[ i ]._attribute >= 0 )
+			{
+				values[ _properties[ i ]._attribute ] = decodeProperty( _properties[ i ], data ) * _properties[ i ]._scale;
+			}
+			data += _properties[ i ]._size;
+		}
+	}
+	else
+	{
+		if ( _format == ePLYAscii && _nbReadPoints >= _nbPoints )
+		{
+			return false;
+		}
+
+		// Skip empty lines and comments
+		std::string line;
+		const char* text = NULL;
+		do
+		{
+			if ( ! readLine( line ) )
+			{
+				if ( _format == ePLYAscii )
+				{
+					std::cerr << "GvxPointCloudReader::readPoint : unexpected end of file at point " << _nbReadPoints << std::endl;
+					_hasError = true;
+				}
+
+				return false;
+			}
+			text = line.c_str();
+			while ( isspace( static_cast< unsigned char >( *text ) ) )
+			{
+				text++;
+			}
+		}
+		while ( *text == '\0' || *text == '#' );
+
+		// Parse values, one per column (or PLY property)
+		const size_t nbColumns = ( _format == ePLYAscii ) ? _properties.size() : _columns.size();
+		for ( size_t i = 0; i < nbColumns; i++ )
+		{
+			char* end = NULL;
+			const double value = strtod( text, &end );
+			if ( end == text )
+			{
+				std::cerr << "GvxPointCloudReader::readPoint : invalid point " << _nbReadPoints << " : " << line << std::endl;
+				_hasError = true;
+
+				return false;
+			}
+			text = end;
+
+			if ( _format == ePLYAscii )
+			{
+				if ( _properties[ i ]._attribute >= 0 )
+				{
+					values[ _properties[ i ]._attribute ] = value * _properties[ i ]._scale;
+				}
+			}
+			else if ( _columns[ i ] >= 0 )
+			{
+				values[ _columns[ i ] ] = ( _columns[ i ] >= 3 && _columns[ i ] < 6 ) ? value * _colorScale : value;
+			}
+		}
+	}
+
+	setPoint( values, pPoint );
+	_nbReadPoints++;
+
+	return true;
+}
+
+/******************************************************************************
+ * Tell wheter or not a read error occured
+ *
+ * @return a flag telling wheter or not a read error occured
+ ******************************************************************************/
+bool GvxPointCloudReader::hasError() const
+{
+	return _hasError;
+}
+
+/******************************************************************************
+ * Tell wheter or not points have colors
+ *
+ * @return a flag telling wheter or not points have colors
+ ******************************************************************************/
+bool GvxPointCloudReader::hasColors() const
+{
+	return _hasColors;
+}
+
+/******************************************************************************
+ * Tell wheter or not points have normals
+ *
+ * @return a flag telling wheter or not points have normals
+ ******************************************************************************/
+bool GvxPointCloudReader::hasNormals() const
+{
+	return _hasNormals;
+}
+
+/******************************************************************************
+ * Get the number of points given by the file header
+ *
+ * @return the number of points (0 if the format has no header)
+ ******************************************************************************/
+unsigned long long GvxPointCloudReader::getNbPoints() const
+{
+	return _nbPoints;
+}
+
+/******************************************************************************
+ * Read the header of a PLY file
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxPointCloudReader::readPLYHeader()
+{
+	std::string line;
+	if ( ! readLine( line ) || line != "ply" )
+	{
+		return false;
+	}
+
+	bool hasFormat = false;
+	bool isVertexElement = false;
+	bool hasVertexElement = false;
+	int positionAttributes = 0;
+	while ( readLine( line ) && line != "end_header" )
+	{
+		std::istringstream stream( line );
+		std::string keyword;
+		stream >> keyword;
+
+		if ( keyword == "format" )
+		{
+			std::string format;
+			stream >> format;
+			if ( format == "ascii" )
+			{
+				_format = ePLYAscii;
+			}
+			else if ( format == "binary_little_endian" )
+			{
+				_format = ePLYBinaryLittleEndian;
+			}
+			else if ( format == "binary_big_endian" )
+			{
+				_format = ePLYBinaryBigEndian;
+			}
+			else
+			{
+				return false;
+			}
+			hasFormat = true;
+		}
+		else if ( keyword == "element" )
+		{
+			std::string name;
+			stream >> name;
+
+			// Points are read from the first element only
+			isVertexElement = ( name == "vertex" && ! hasVertexElement );
+			if ( name == "vertex" )
+			{
+				if ( hasVertexElement || _nbPoints > 0 || ! _properties.empty() )
+				{
+					std::cerr << "GvxPointCloudReader::readPLYHeader : the vertex element must be the first element" << std::endl;
+
+					return false;
+				}
+				stream >> _nbPoints;
+				hasVertexElement = true;
+			}
+			else if ( ! hasVertexElement )
+			{
+				std::cerr << "GvxPointCloudReader::readPLYHeader : the vertex element must be the first element" << std::endl;
+
+				return false;
+			}
+		}
+		else if ( keyword == "property" && isVertexElement )
+		{
+			std::string type;
+			std::string name;
+			stream >> type >> name;
+			if ( type == "list" )
+			{
+				std::cerr << "GvxPointCloudReader::readPLYHeader : list properties are not supported in the vertex element" << std::endl;
+
+				return false;
+			}
+
+			Property property;
+			property._isFloat = ( type == "float" || type == "float32" || type == "double" || type == "float64" );
+			property._isSigned = ( type == "char" || type == "int8" || type == "short" || type == "int16" || type == "int" || type == "int32" );
+			if ( type == "char" || type == "int8" || type == "uchar" || type == "uint8" )
+			{
+				property._size = 1;
+			}
+			else if ( type == "short" || type == "int16" || type == "ushort" || type == "uint16" )
+			{
+				property._size = 2;
+			}
+			else if ( type == "int" || type == "int32" || type == "uint" || type == "uint32" || type == "float" || type == "float32" )
+			{
+				property._size = 4;
+			}
+			else if ( type == "double" || type == "float64" )
+			{
+				property._size = 8;
+			}
+			else
+			{
+				std::cerr << "GvxPointCloudReader::readPLYHeader : unknown property type " << type << std::endl;
+
+				return false;
+			}
+
+			// Integer colors are brought in [ 0 ; 1 ]
+			const char* attributeNames[ 9 ] = { "x", "y", "z", "red", "green", "blue", "nx", "ny", "nz" };
+			const char* shortAttributeNames[ 9 ] = { "x", "y", "z", "r", "g", "b", "nx", "ny", "nz" };
+			property._attribute = -1;
+			property._scale = 1.0;
+			for ( int i = 0; i < 9; i++ )
+			{
+				if ( name == attributeNames[ i ] || name == shortAttributeNames[ i ] )
+				{
+					property._attribute = i;
+				}
+			}
+			if ( property._attribute >= 3 && property._attribute < 6 )
+			{
+				_hasColors = true;
+				if ( ! property._isFloat )
+				{
+					property._scale = 1.0 / static_cast< double >( ( 1ULL << ( 8 * property._size - ( property._isSigned ? 1 : 0 ) ) ) - 1 );
+				}
+			}
+			else if ( property._attribute >= 6 )
+			{
+				_hasNormals = true;
+			}
+			else if ( property._attribute >= 0 )
+			{
+				positionAttributes |= 1 << property._attribute;
+			}
+
+			_properties.push_back( property );
+			_vertexSize += property._size;
+		}
+	}
+
+	if ( ! hasFormat || ! hasVertexElement || positionAttributes != 7 || line != "end_header" )
+	{
+		return false;
+	}
+
+	_vertexBuffer.resize( _vertexSize );
+
+#ifdef WIN32
+	_dataOffset = _ftelli64( _file );
+#else
+	_dataOffset = static_cast< long long >( ftello( _file ) );
+#endif
+
+	return true;
+}
+
+/******************************************************************************
+ * Read the first point of a XYZ file to find its columns
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxPointCloudReader::readXYZHeader()
+{
+	_format = eXYZ;
+	_dataOffset = 0;
+
+	// Retrieve the first point
+	std::string line;
+	const char* text = NULL;
+	do
+	{
+		if ( ! readLine( line ) )
+		{
+			return false;
+		}
+		text = line.c_str();
+		while ( isspace( static_cast< unsigned char >( *text ) ) )
+		{
+			text++;
+		}
+	}
+	while ( *text == '\0' || *text == '#' );
+
+	// Count its columns
+	std::vector< std::string > columns;
+	std::istringstream stream( text );
+	std::string column;
+	while ( stream >> column )
+	{
+		columns.push_back( column );
+	}
+
+	// Point attribute of each column (intensities are skipped)
+	const int xyzColumns[ 3 ] = { 0, 1, 2 };
+	const int xyziColumns[ 4 ] = { 0, 1, 2, -1 };
+	const int xyzrgbColumns[ 6 ] = { 0, 1, 2, 3, 4, 5 };
+	const int xyzirgbColumns[ 7 ] = { 0, 1, 2, -1, 3, 4, 5 };
+	const int xyzrgbnColumns[ 9 ] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+	switch ( columns.size() )
+	{
+		case 3:
+			_columns.assign( xyzColumns, xyzColumns + 3 );
+			break;
+
+		case 4:
+			_columns.assign( xyziColumns, xyziColumns + 4 );
+			break;
+
+		case 6:
+			_columns.assign( xyzrgbColumns, xyzrgbColumns + 6 );
+			break;
+
+		case 7:
+			_columns.assign( xyzirgbColumns, xyzirgbColumns + 7 );
+			break;
+
+		case 9:
+			_columns.assign( xyzrgbnColumns, xyzrgbnColumns + 9 );
+			break;
+
+		default:
+			std::cerr << "GvxPointCloudReader::readXYZHeader : unsupported number of columns " << columns.size() << std::endl;
+			return false;
+	}
+	_hasColors = ( columns.size() >= 6 );
+	_hasNormals = ( columns.size() == 9 );
+
+	// Integer colors are in [ 0 ; 255 ], real ones in [ 0 ; 1 ]
+	_colorScale = 1.0 / 255.0;
+	if ( _hasColors )
+	{
+		const size_t firstColorColumn = ( columns.size() == 7 ) ? 4 : 3;
+		for ( size_t i = firstColorColumn; i < firstColorColumn + 3; i++ )
+		{
+			if ( columns[ i ].find_first_of( ".eE" ) != std::string::npos )
+			{
+				_colorScale = 1.0;
+			}
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Read the next line of a text file
+ *
+ * @param pLine the line
+ *
+ * @return false at the end of the file
+ ******************************************************************************/
+bool GvxPointCloudReader::readLine( std::string& pLine )
+{
+	pLine.clear();
+
+	char buffer[ 256 ];
+	while ( fgets( buffer, sizeof( buffer ), _file ) != NULL )
+	{
+		pLine += buffer;
+		if ( ! pLine.empty() && pLine[ pLine.size() - 1 ] == '\n' )
+		{
+			break;
+		}
+	}
+	if ( pLine.empty() )
+	{
+		return false;
+	}
+
+	// Remove the end of line
+	while ( ! pLine.empty() && ( pLine[ pLine.size() - 1 ] == '\n' || pLine[ pLine.size() - 1 ] == '\r' ) )
+	{
+		pLine.erase( pLine.size() - 1 );
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Set the values of a point
+ *
+ * @param pValues values of the point attributes (position, color and normal)
+ * @param pPoint the point
+ ******************************************************************************/
+void GvxPointCloudReader::setPoint( const double pValues[ 9 ], Point& pPoint ) const
+{
+	for ( int i = 0; i < 3; i++ )
+	{
+		pPoint._position[ i ] = pValues[ i ];
+		pPoint._color[ i ] = static_cast< float >( std::min( std::max( pValues[ 3 + i ], 0.0 ), 1.0 ) );
+		pPoint._normal[ i ] = static_cast< float >( pValues[ 6 + i ] );
+	}
+}
+
+/******************************************************************************
+ * Decode a binary PLY property
+ *
+ * @param pProperty the property
+ * @param pData the property data
+ *
+ * @return the property value
+ ******************************************************************************/
+double GvxPointCloudReader::decodeProperty( const Property& pProperty, const unsigned char* pData ) const
+{
+	// Bring the property in the host (little endian) byte order
+	unsigned char data[ 8 ];
+	for ( unsigned int i = 0; i < pProperty._size; i++ )
+	{
+		data[ i ] = ( _format == ePLYBinaryBigEndian ) ? pData[ pProperty._size - 1 - i ] : pData[ i ];
+	}
+
+	if ( pProperty._isFloat )
+	{
+		if ( pProperty._size == 4 )
+		{
+			float value;
+			memcpy( &value, data, sizeof( float ) );
+
+			return value;
+		}
+
+		double value;
+		memcpy( &value, data, sizeof( double ) );
+
+		return value;
+	}
+
+	switch ( pProperty._size )
+	{
+		case 1:
+			return pProperty._isSigned ? static_cast< double >( static_cast< signed char >( data[ 0 ] ) ) : static_cast< double >( data[ 0 ] );
+
+		case 2:
+		{
+			unsigned short value;
+			memcpy( &value, data, sizeof( unsigned short ) );
+			return pProperty._isSigned ? static_cast< double >( static_cast< short >( value ) ) : static_cast< double >( value );
+		}
+
+		default:
+		{
+			unsigned int value;
+			memcpy( &value, data, sizeof( unsigned int ) );
+			return pProperty._isSigned ? static_cast< double >( static_cast< int >( value ) ) : static_cast< double >( value );
+		}
+	}
+}
@@ -0,0 +1,1016 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+
+#include "GvxPointCloudVoxelizer.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvxSceneVoxelizer.h"
+#include "GvxVoxelizerEngine.h"
+#include "GvxDataStructureIOHandler.h"
+#include "GvxPointCloudReader.h"
+
+// STL
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <queue>
+#include <functional>
+#include <utility>
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+
+// System
+#ifndef WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// Project
+using namespace Gvx;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+// Half conversions (see GvxVoxelizerEngine.cpp)
+unsigned short float2HalfInUshort( float f );
+float halfInUshort2Float( unsigned short u );
+
+namespace
+{
+
+/******************************************************************************
+ * Round a value to the nearest unsigned char
+ * (as done by the voxelizer engine when mip-mapping)
+ *
+ * @param pValue the value
+ *
+ * @return the unsigned char value
+ ******************************************************************************/
+inline unsigned char roundToUchar( float pValue )
+{
+	return static_cast< unsigned char >( pValue + 0.5f );
+}
+
+/******************************************************************************
+ * Spread the 21 lower bits of a value, two zero bits between each bit
+ *
+ * @param pValue the value
+ *
+ * @return the spread value
+ ******************************************************************************/
+inline unsigned long long spreadBits( unsigned long long pValue )
+{
+	pValue &= 0x1FFFFFULL;
+	pValue = ( pValue | ( pValue << 32 ) ) & 0x1F00000000FFFFULL;
+	pValue = ( pValue | ( pValue << 16 ) ) & 0x1F0000FF0000FFULL;
+	pValue = ( pValue | ( pValue << 8 ) ) & 0x100F00F00F00F00FULL;
+	pValue = ( pValue | ( pValue << 4 ) ) & 0x10C30C30C30C30C3ULL;
+	pValue = ( pValue | ( pValue << 2 ) ) & 0x1249249249249249ULL;
+
+	return pValue;
+}
+
+/******************************************************************************
+ * Compact the bits spread by spreadBits()
+ *
+ * @param pValue the spread value
+ *
+ * @return the value
+ ******************************************************************************/
+inline unsigned int compactBits( unsigned long long pValue )
+{
+	pValue &= 0x1249249249249249ULL;
+	pValue = ( pValue | ( pValue >> 2 ) ) & 0x10C30C30C30C30C3ULL;
+	pValue = ( pValue | ( pValue >> 4 ) ) & 0x100F00F00F00F00FULL;
+	pValue = ( pValue | ( pValue >> 8 ) ) & 0x1F0000FF0000FFULL;
+	pValue = ( pValue | ( pValue >> 16 ) ) & 0x1F00000000FFFFULL;
+	pValue = ( pValue | ( pValue >> 32 ) ) & 0x1FFFFFULL;
+
+	return static_cast< unsigned int >( pValue );
+}
+
+}
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pSceneVoxelizer the scene voxelizer providing the settings of the data structure
+ * (file name, max level of resolution, brick width, data type, normals, borderless bricks)
+ ******************************************************************************/
+GvxPointCloudVoxelizer::GvxPointCloudVoxelizer( GvxSceneVoxelizer& pSceneVoxelizer )
+:	_sceneVoxelizer( pSceneVoxelizer )
+,	_memorySize( static_cast< size_t >( 1024 ) * 1024 * 1024 )
+,	_nbThreads( 1 )
+,	_nbPointsPerVoxel( 1.0f )
+,	_isSplattingOn( false )
+,	_normalizationScale( 1.0 )
+,	_nbVoxelBits( 0 )
+,	_nbBrickBits( 0 )
+,	_runFileNames()
+,	_dataTypes()
+,	_dataStructureIOHandlers()
+,	_pendingBricks()
+,	_leafKey( 0 )
+,	_isLeafValid( false )
+,	_leafWeights()
+,	_leafColors()
+,	_leafNormals()
+,	_nbBricks( 0 )
+{
+	_normalizationCenter[ 0 ] = 0.0;
+	_normalizationCenter[ 1 ] = 0.0;
+	_normalizationCenter[ 2 ] = 0.0;
+
+#ifndef WIN32
+	const long nbProcessors = sysconf( _SC_NPROCESSORS_ONLN );
+	_nbThreads = ( nbProcessors > 0 ) ? static_cast< unsigned int >( nbProcessors ) : 1;
+#endif
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvxPointCloudVoxelizer::~GvxPointCloudVoxelizer()
+{
+	removeRuns();
+
+	for ( size_t i = 0; i < _dataStructureIOHandlers.size(); i++ )
+	{
+		delete _dataStructureIOHandlers[ i ];
+	}
+}
+
+/******************************************************************************
+ * Set the max memory size used to sort points
+ *
+ * @param pSize the memory size (in bytes)
+ ******************************************************************************/
+void GvxPointCloudVoxelizer::setMemorySize( size_t pSize )
+{
+	_memorySize = pSize;
+}
+
+/******************************************************************************
+ * Set the number of threads used to sort points
+ *
+ * @param pValue the number of threads
+ ******************************************************************************/
+void GvxPointCloudVoxelizer::setNbThreads( unsigned int pValue )
+{
+	_nbThreads = std::max( pValue, 1U );
+}
+
+/******************************************************************************
+ * Set the number of points that make a voxel opaque
+ *
+ * @param pValue the number of points
+ ******************************************************************************/
+void GvxPointCloudVoxelizer::setNbPointsPerVoxel( float pValue )
+{
+	_nbPointsPerVoxel = pValue;
+}
+
+/******************************************************************************
+ * Set wheter or not points are splatted in the eight nearest voxels
+ *
+ * @param pFlag the flag
+ ******************************************************************************/
+void GvxPointCloudVoxelizer::setSplatting( bool pFlag )
+{
+	_isSplattingOn = pFlag;
+}
+
+/******************************************************************************
+ * Voxelize a point cloud : all levels of resolution are written
+ *
+ * @param pFileName the point cloud file name
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxPointCloudVoxelizer::execute( const std::string& pFileName )
+{
+	const unsigned int level = _sceneVoxelizer.getMaxResolution();
+	const unsigned int brickWidth = _sceneVoxelizer.getBrickWidth();
+
+	// Check settings
+	_nbBrickBits = 0;
+	while ( ( 1U << _nbBrickBits ) < brickWidth )
+	{
+		_nbBrickBits++;
+	}
+	_nbVoxelBits = level + _nbBrickBits;
+	if ( _nbVoxelBits > 21 )
+	{
+		std::cerr << "GvxPointCloudVoxelizer::execute : the voxel grid is too large (" << _nbVoxelBits << " bits per axis, 21 max)" << std::endl;
+
+		return false;
+	}
+	if ( _sceneVoxelizer.getDataType() != GvxDataTypeHandler::gvUCHAR4 )
+	{
+		std::cerr << "GvxPointCloudVoxelizer::execute : only the uchar4 data type is supported" << std::endl;
+
+		return false;
+	}
+	if ( _nbPointsPerVoxel <= 0.0f )
+	{
+		std::cerr << "GvxPointCloudVoxelizer::execute : the number of points per voxel must be positive" << std::endl;
+
+		return false;
+	}
+
+	GvxPointCloudReader reader;
+	if ( ! reader.open( pFileName ) )
+	{
+		return false;
+	}
+	if ( _sceneVoxelizer.isGenerateNormalsOn() && ! reader.hasNormals() )
+	{
+		std::cerr << "GvxPointCloudVoxelizer::execute : " << pFileName << " has no normals" << std::endl;
+
+		return false;
+	}
+
+	// Data channels, as generated by the voxelizer engine
+	_dataTypes.clear();
+	_dataTypes.push_back( GvxDataTypeHandler::gvUCHAR4 );
+	if ( _sceneVoxelizer.isGenerateNormalsOn() )
+	{
+		_dataTypes.push_back( GvxDataTypeHandler::gvHALF4 );
+	}
+
+	// [ 1 ] - Bounding box
+	if ( ! computeNormalization( reader ) )
+	{
+		return false;
+	}
+
+	// [ 2 ] - Sorted runs
+	if ( ! createRuns( reader ) )
+	{
+		removeRuns();
+
+		return false;
+	}
+	reader.close();
+
+	// [ 3 ] - Bricks of all levels, in Morton order
+	// (borderless bricks are written with their interior voxels only)
+	GvxVoxelizerEngine& voxelizerEngine = _sceneVoxelizer.getVoxelizerEngine();
+	for ( unsigned int l = 0; l <= level; l++ )
+	{
+		_dataStructureIOHandlers.push_back( new GvxDataStructureIOHandler( _sceneVoxelizer.getFileName(), l, brickWidth, _dataTypes, true, voxelizerEngine.getBorderSize() ) );
+	}
+	const size_t nbVoxels = static_cast< size_t >( brickWidth ) * brickWidth * brickWidth;
+	_pendingBricks.resize( level );
+	for ( unsigned int l = 0; l < level; l++ )
+	{
+		_pendingBricks[ l ]._isValid = false;
+		_pendingBricks[ l ]._colors.resize( 4 * nbVoxels );
+		_pendingBricks[ l ]._normals.resize( _dataTypes.size() > 1 ? 3 * nbVoxels : 0 );
+	}
+	_leafWeights.assign( nbVoxels, 0.0f );
+	_leafColors.assign( 3 * nbVoxels, 0.0f );
+	_leafNormals.assign( _dataTypes.size() > 1 ? 3 * nbVoxels : 0, 0.0f );
+	_isLeafValid = false;
+	_nbBricks = 0;
+
+	const bool isSucceeded = mergeRuns();
+	removeRuns();
+	if ( ! isSucceeded )
+	{
+		return false;
+	}
+
+	// Last bricks
+	flushLeafBrick();
+	for ( int l = static_cast< int >( level ) - 1; l >= 0; l-- )
+	{
+		flushPendingBrick( static_cast< unsigned int >( l ) );
+	}
+
+	// LOG
+	std::cout << "GvxPointCloudVoxelizer : " << _nbBricks << " bricks written" << std::endl;
+
+	// [ 4 ] - Borders
+	for ( size_t l = 0; l < _dataStructureIOHandlers.size(); l++ )
+	{
+		if ( ! voxelizerEngine.isBorderless() )
+		{
+			std::cout << "GvxPointCloudVoxelizer : borders : level : " << l << std::endl;
+			_dataStructureIOHandlers[ l ]->computeBorders();
+		}
+		delete _dataStructureIOHandlers[ l ];
+	}
+	_dataStructureIOHandlers.clear();
+
+	// [ 5 ] - Node summaries
+	voxelizerEngine.setup( level, brickWidth, _sceneVoxelizer.getFileName(), _sceneVoxelizer.getDataType() );
+
+	return voxelizerEngine.generateSummaries();
+}
+
+/******************************************************************************
+ * Compute the normalization of points from their bounding box
+ *
+ * @param pReader the point cloud reader
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxPointCloudVoxelizer::computeNormalization( GvxPointCloudReader& pReader )
+{
+	double boundsMin[ 3 ] = { +DBL_MAX, +DBL_MAX, +DBL_MAX };
+	double boundsMax[ 3 ] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+
+	unsigned long long nbPoints = 0;
+	GvxPointCloudReader::Point point;
+	while ( pReader.readPoint( point ) )
+	{
+		for ( int i = 0; i < 3; i++ )
+		{
+			boundsMin[ i ] = std::min( boundsMin[ i ], point._position[ i ] );
+			boundsMax[ i ] = std::max( boundsMax[ i ], point._position[ i ] );
+		}
+		nbPoints++;
+	}
+	if ( pReader.hasError() || ! pReader.rewind() )
+	{
+		return false;
+	}
+
+	// LOG
+	std::cout << "GvxPointCloudVoxelizer : " << nbPoints << " points" << std::endl;
+
+	// Points are normalized as meshes are (see GvxAssimpSceneVoxelizer::normalizeScene())
+	const double extent = std::max( std::max( boundsMax[ 0 ] - boundsMin[ 0 ], boundsMax[ 1 ] - boundsMin[ 1 ] ), boundsMax[ 2 ] - boundsMin[ 2 ] );
+	_normalizationScale = ( nbPoints > 0 && extent > 0.0 ) ? 0.95 / extent : 1.0;
+	for ( int i = 0; i < 3; i++ )
+	{
+		_normalizationCenter[ i ] = ( nbPoints > 0 ) ? 0.5 * ( boundsMin[ i ] + boundsMax[ i ] ) : 0.0;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Splat points in voxels and write sorted runs
+ *
+ * @param pReader the point cloud reader
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxPointCloudVoxelizer::createRuns( GvxPointCloudReader& pReader )
+{
+	// Points and the merge buffer of the sort share the memory
+	const size_t capacity = std::max( _memorySize / ( 2 * sizeof( PointRecord ) ), static_cast< size_t >( 8 ) );
+	std::vector< PointRecord > points;
+	std::vector< PointRecord > buffer;
+	points.reserve( capacity );
+
+	const unsigned int voxelGridSize = 1U << _nbVoxelBits;
+	GvxPointCloudReader::Point point;
+	while ( pReader.readPoint( point ) )
+	{
+		PointRecord record;
+		for ( int i = 0; i < 3; i++ )
+		{
+			record._color[ i ] = roundToUchar( point._color[ i ] * 255.f );
+			record._normal[ i ] = point._normal[ i ];
+		}
+		record._color[ 3 ] = 255;
+
+		// Position in the voxel grid
+		float voxelPosition[ 3 ];
+		for ( int i = 0; i < 3; i++ )
+		{
+			voxelPosition[ i ] = static_cast< float >( ( ( point._position[ i ] - _normalizationCenter[ i ] ) * _normalizationScale + 0.5 ) * voxelGridSize );
+		}
+
+		if ( _isSplattingOn )
+		{
+			// Trilinear weights of the eight nearest voxel centers
+			int firstVoxel[ 3 ];
+			float weights[ 3 ];
+			for ( int i = 0; i < 3; i++ )
+			{
+				const float position = voxelPosition[ i ] - 0.5f;
+				firstVoxel[ i ] = static_cast< int >( floorf( position ) );
+				weights[ i ] = position - static_cast< float >( firstVoxel[ i ] );
+			}
+			for ( int z = 0; z < 2; z++ )
+			for ( int y = 0; y < 2; y++ )
+			for ( int x = 0; x < 2; x++ )
+			{
+				const int offset[ 3 ] = { x, y, z };
+				unsigned int voxel[ 3 ];
+				record._weight = 1.0f;
+				for ( int i = 0; i < 3; i++ )
+				{
+					const int position = firstVoxel[ i ] + offset[ i ];
+					voxel[ i ] = static_cast< unsigned int >( std::min( std::max( position, 0 ), static_cast< int >( voxelGridSize ) - 1 ) );
+					record._weight *= offset[ i ] ? weights[ i ] : 1.0f - weights[ i ];
+				}
+				if ( record._weight > 0.0f )
+				{
+					record._key = encodeMortonKey( voxel );
+					points.push_back( record );
+				}
+			}
+		}
+		else
+		{
+			unsigned int voxel[ 3 ];
+			for ( int i = 0; i < 3; i++ )
+			{
+				voxel[ i ] = static_cast< unsigned int >( std::min( std::max( static_cast< int >( floorf( voxelPosition[ i ] ) ), 0 ), static_cast< int >( voxelGridSize ) - 1 ) );
+			}
+			record._key = encodeMortonKey( voxel );
+			record._weight = 1.0f;
+			points.push_back( record );
+		}
+
+		// A run is full : it is sorted and written
+		// (room is kept for the eight splatted points of the next point)
+		if ( points.size() + 8 > capacity )
+		{
+			if ( ! writeRun( points, buffer ) )
+			{
+				return false;
+			}
+		}
+	}
+	if ( pReader.hasError() )
+	{
+		return false;
+	}
+	if ( ! points.empty() && ! writeRun( points, buffer ) )
+	{
+		return false;
+	}
+
+	// LOG
+	std::cout << "GvxPointCloudVoxelizer : " << _runFileNames.size() << " sorted runs" << std::endl;
+
+	return true;
+}
+
+/******************************************************************************
+ * Sort points and write them in a new run file
+ *
+ * @param pPoints the points
+ * @param pBuffer buffer used to merge sorted parts (as large as the points)
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxPointCloudVoxelizer::writeRun( std::vector< PointRecord >& pPoints, std::vector< PointRecord >& pBuffer )
+{
+	sortPoints( pPoints, pBuffer, _nbThreads );
+
+	std::ostringstream fileName;
+	fileName << _sceneVoxelizer.getFileName() << ".run" << _runFileNames.size();
+	_runFileNames.push_back( fileName.str() );
+
+	FILE* file = fopen( fileName.str().c_str(), "wb" );
+	if ( file == NULL )
+	{
+		std::cerr << "GvxPointCloudVoxelizer::writeRun : unable to write " << fileName.str() << std::endl;
+
+		return false;
+	}
+	const unsigned long long nbPoints = pPoints.size();
+	bool isSucceeded = ( fwrite( &nbPoints, sizeof( unsigned long long ), 1, file ) == 1 ) &&
+						( fwrite( &pPoints[ 0 ], sizeof( PointRecord ), pPoints.size(), file ) == pPoints.size() );
+	if ( fclose( file ) != 0 )
+	{
+		isSucceeded = false;
+	}
+	if ( ! isSucceeded )
+	{
+		std::cerr << "GvxPointCloudVoxelizer::writeRun : unable to write " << fileName.str() << std::endl;
+	}
+
+	pPoints.clear();
+
+	return isSucceeded;
+}
+
+/******************************************************************************
+ * Merge the runs : points are accumulated in Morton order
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxPointCloudVoxelizer::mergeRuns()
+{
+	// Runs share the memory
+	const size_t bufferSize = std::max( _memorySize / ( std::max( _runFileNames.size(), static_cast< size_t >( 1 ) ) * sizeof( PointRecord ) ), static_cast< size_t >( 4096 ) );
+
+	std::vector< Run > runs( _runFileNames.size() );
+	bool isSucceeded = true;
+	for ( size_t i = 0; i < runs.size() && isSucceeded; i++ )
+	{
+		runs[ i ]._file = fopen( _runFileNames[ i ].c_str(), "rb" );
+		runs[ i ]._nbRemainingPoints = 0;
+		runs[ i ]._position = 0;
+		isSucceeded = ( runs[ i ]._file != NULL ) && ( fread( &runs[ i ]._nbRemainingPoints, sizeof( unsigned long long ), 1, runs[ i ]._file ) == 1 );
+	}
+
+	// The next point of each run is kept in a priority queue
+	typedef std::pair< unsigned long long, size_t > QueueItem;
+	std::priority_queue< QueueItem, std::vector< QueueItem >, std::greater< QueueItem > > queue;
+	for ( size_t i = 0; i < runs.size() && isSucceeded; i++ )
+	{
+		Run& run = runs[ i ];
+		const size_t nbPoints = static_cast< size_t >( std::min( static_cast< unsigned long long >( bufferSize ), run._nbRemainingPoints ) );
+		run._buffer.resize( nbPoints );
+		isSucceeded = ( nbPoints == 0 ) || ( fread( &run._buffer[ 0 ], sizeof( PointRecord ), nbPoints, run._file ) == nbPoints );
+		run._nbRemainingPoints -= nbPoints;
+		if ( nbPoints > 0 )
+		{
+			queue.push( QueueItem( run._buffer[ 0 ]._key, i ) );
+		}
+	}
+
+	while ( ! queue.empty() && isSucceeded )
+	{
+		Run& run = runs[ queue.top().second ];
+		const size_t runIndex = queue.top().second;
+		queue.pop();
+
+		addPoint( run._buffer[ run._position ] );
+		run._position++;
+
+		// Read the next points of the run
+		if ( run._position == run._buffer.size() )
+		{
+			const size_t nbPoints = static_cast< size_t >( std::min( static_cast< unsigned long long >( bufferSize ), run._nbRemainingPoints ) );
+			run._buffer.resize( nbPoints );
+			run._position = 0;
+			isSucceeded = ( nbPoints == 0 ) || ( fread( &run._buffer[ 0 ], sizeof( PointRecord ), nbPoints, run._file ) == nbPoints );
+			run._nbRemainingPoints -= nbPoints;
+		}
+		if ( run._position < run._buffer.size() )
+		{
+			queue.push( QueueItem( run._buffer[ run._position ]._key, runIndex ) );
+		}
+	}
+
+	for ( size_t i = 0; i < runs.size(); i++ )
+	{
+		if ( runs[ i ]._file != NULL )
+		{
+			fclose( runs[ i ]._file );
+		}
+	}
+	if ( ! isSucceeded )
+	{
+		std::cerr << "GvxPointCloudVoxelizer::mergeRuns : unable to read the sorted runs" << std::endl;
+	}
+
+	return isSucceeded;
+}
+
+/******************************************************************************
+ * Remove the temporary run files
+ ******************************************************************************/
+void GvxPointCloudVoxelizer::removeRuns()
+{
+	for ( size_t i = 0; i < _runFileNames.size(); i++ )
+	{
+		remove( _runFileNames[ i ].c_str() );
+	}
+	_runFileNames.clear();
+}
+
+/******************************************************************************
+ * Accumulate a point in the leaf brick
+ *
+ * @param pPoint the point
+ ******************************************************************************/
+void GvxPointCloudVoxelizer::addPoint( const PointRecord& pPoint )
+{
+	// Voxels of a brick come one after the other
+	const unsigned long long key = pPoint._key >> ( 3 * _nbBrickBits );
+	if ( _isLeafValid && key != _leafKey )
+	{
+		flushLeafBrick();
+	}
+	_leafKey = key;
+	_isLeafValid = true;
+
+	unsigned int voxelPosition[ 3 ];
+	decodeMortonKey( pPoint._key & ( ( 1ULL << ( 3 * _nbBrickBits ) ) - 1 ), voxelPosition );
+	const unsigned int brickWidth = 1U << _nbBrickBits;
+	const size_t voxel = voxelPosition[ 0 ] + brickWidth * ( voxelPosition[ 1 ] + brickWidth * voxelPosition[ 2 ] );
+
+	_leafWeights[ voxel ] += pPoint._weight;
+	for ( int i = 0; i < 3; i++ )
+	{
+		_leafColors[ 3 * voxel + i ] += pPoint._weight * pPoint._color[ i ];
+	}
+	if ( ! _leafNormals.empty() )
+	{
+		for ( int i = 0; i < 3; i++ )
+		{
+			_leafNormals[ 3 * voxel + i ] += pPoint._weight * pPoint._normal[ i ];
+		}
+	}
+}
+
+/******************************************************************************
+ * Write the leaf brick and accumulate it in its parent
+ ******************************************************************************/
+void GvxPointCloudVoxelizer::flushLeafBrick()
+{
+	if ( ! _isLeafValid )
+	{
+		return;
+	}
+	_isLeafValid = false;
+
+	const unsigned int brickWidth = 1U << _nbBrickBits;
+	const unsigned int borderSize = _dataStructureIOHandlers.back()->_borderSize;
+	const unsigned int brickResolution = brickWidth + 2 * borderSize;
+	const unsigned int brickSize = brickResolution * brickResolution * brickResolution;
+	std::vector< unsigned char > colors( 4 * brickSize, 0 );
+	std::vector< unsigned short > normals( _leafNormals.empty() ? 0 : 4 * brickSize, 0 );
+
+	// Averaged colors (premultiplied by the density) and normals, with empty borders
+	unsigned int voxelPosition[ 3 ];
+	for ( voxelPosition[ 2 ] = 0; voxelPosition[ 2 ] < brickWidth; voxelPosition[ 2 ]++ )
+	for ( voxelPosition[ 1 ] = 0; voxelPosition[ 1 ] < brickWidth; voxelPosition[ 1 ]++ )
+	for ( voxelPosition[ 0 ] = 0; voxelPosition[ 0 ] < brickWidth; voxelPosition[ 0 ]++ )
+	{
+		const size_t voxel = voxelPosition[ 0 ] + brickWidth * ( voxelPosition[ 1 ] + brickWidth * voxelPosition[ 2 ] );
+		const float weight = _leafWeights[ voxel ];
+		if ( weight <= 0.0f )
+		{
+			continue;
+		}
+
+		const size_t voxelInBrick = ( voxelPosition[ 0 ] + borderSize ) + brickResolution * ( ( voxelPosition[ 1 ] + borderSize ) + brickResolution * ( voxelPosition[ 2 ] + borderSize ) );
+		const float alpha = std::min( weight / _nbPointsPerVoxel, 1.0f );
+		for ( int i = 0; i < 3; i++ )
+		{
+			colors[ 4 * voxelInBrick + i ] = roundToUchar( _leafColors[ 3 * voxel + i ] / weight * alpha );
+		}
+		colors[ 4 * voxelInBrick + 3 ] = roundToUchar( alpha * 255.f );
+
+		if ( ! normals.empty() )
+		{
+			const float* normal = &_leafNormals[ 3 * voxel ];
+			const float norm = sqrtf( normal[ 0 ] * normal[ 0 ] + normal[ 1 ] * normal[ 1 ] + normal[ 2 ] * normal[ 2 ] );
+			if ( norm >= 0.00001f )
+			{
+				normals[ 4 * voxelInBrick + 0 ] = float2HalfInUshort( normal[ 0 ] / norm );
+				normals[ 4 * voxelInBrick + 1 ] = float2HalfInUshort( normal[ 1 ] / norm );
+				normals[ 4 * voxelInBrick + 2 ] = float2HalfInUshort( normal[ 2 ] / norm );
+				normals[ 4 * voxelInBrick + 3 ] = 1; // flag as non-empty
+			}
+		}
+	}
+
+	addBrick( static_cast< unsigned int >( _dataStructureIOHandlers.size() - 1 ), _leafKey, &colors[ 0 ], normals.empty() ? NULL : &normals[ 0 ] );
+
+	std::fill( _leafWeights.begin(), _leafWeights.end(), 0.0f );
+	std::fill( _leafColors.begin(), _leafColors.end(), 0.0f );
+	std::fill( _leafNormals.begin(), _leafNormals.end(), 0.0f );
+}
+
+/******************************************************************************
+ * Write a brick and accumulate it in its parent
+ *
+ * @param pLevel level of resolution of the brick
+ * @param pKey Morton key of the node
+ * @param pColors colors of the brick (with the border size of the data structure)
+ * @param pNormals normals of the brick (with the border size of the data structure, if any)
+ ******************************************************************************/
+void GvxPointCloudVoxelizer::addBrick( unsigned int pLevel, unsigned long long pKey, unsigned char* pColors, unsigned short* pNormals )
+{
+	GvxDataStructureIOHandler* dataStructureIOHandler = _dataStructureIOHandlers[ pLevel ];
+	const unsigned int brickWidth = dataStructureIOHandler->_brickWidth;
+	const unsigned int borderSize = dataStructureIOHandler->_borderSize;
+	const unsigned int brickResolution = brickWidth + 2 * borderSize;
+
+	// Writing one voxel creates the brick of the node (as done by the voxelizer),
+	// then its whole content is replaced
+	unsigned int nodePosition[ 3 ];
+	decodeMortonKey( pKey, nodePosition );
+	unsigned int voxelPosition[ 3 ];
+	voxelPosition[ 0 ] = nodePosition[ 0 ] * brickWidth;
+	voxelPosition[ 1 ] = nodePosition[ 1 ] * brickWidth;
+	voxelPosition[ 2 ] = nodePosition[ 2 ] * brickWidth;
+	unsigned char voxelData[ 16 ];
+	memset( voxelData, 0, sizeof( voxelData ) );
+	dataStructureIOHandler->setVoxel( voxelPosition, voxelData, 0 );
+	dataStructureIOHandler->setBrick( nodePosition, pColors, 0 );
+	if ( pNormals != NULL )
+	{
+		dataStructureIOHandler->setBrick( nodePosition, pNormals, 1 );
+	}
+	_nbBricks++;
+
+	if ( pLevel == 0 )
+	{
+		return;
+	}
+
+	// The eight children of a node come one after the other
+	PendingBrick& parent = _pendingBricks[ pLevel - 1 ];
+	if ( parent._isValid && parent._key != ( pKey >> 3 ) )
+	{
+		flushPendingBrick( pLevel - 1 );
+	}
+	if ( ! parent._isValid )
+	{
+		parent._isValid = true;
+		parent._key = pKey >> 3;
+		std::fill( parent._colors.begin(), parent._colors.end(), 0.0f );
+		std::fill( parent._normals.begin(), parent._normals.end(), 0.0f );
+	}
+
+	// Each voxel of the parent is the mean of 8 voxels of its children
+	// (as done by the voxelizer engine when mip-mapping)
+	const unsigned int halfBrickWidth = brickWidth / 2;
+	const unsigned int childOffset[ 3 ] = { static_cast< unsigned int >( pKey & 1 ) * halfBrickWidth, static_cast< unsigned int >( ( pKey >> 1 ) & 1 ) * halfBrickWidth, static_cast< unsigned int >( ( pKey >> 2 ) & 1 ) * halfBrickWidth };
+	for ( unsigned int z = 0; z < brickWidth; z++ )
+	for ( unsigned int y = 0; y < brickWidth; y++ )
+	for ( unsigned int x = 0; x < brickWidth; x++ )
+	{
+		const size_t voxelInBrick = ( x + borderSize ) + brickResolution * ( ( y + borderSize ) + brickResolution * ( z + borderSize ) );
+		const size_t parentVoxel = ( childOffset[ 0 ] + x / 2 ) + brickWidth * ( ( childOffset[ 1 ] + y / 2 ) + brickWidth * ( childOffset[ 2 ] + z / 2 ) );
+		for ( int i = 0; i < 4; i++ )
+		{
+			parent._colors[ 4 * parentVoxel + i ] += pColors[ 4 * voxelInBrick + i ];
+		}
+		if ( pNormals != NULL )
+		{
+			for ( int i = 0; i < 3; i++ )
+			{
+				parent._normals[ 3 * parentVoxel + i ] += halfInUshort2Float( pNormals[ 4 * voxelInBrick + i ] );
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * Write the pending brick of a mip-map level and accumulate it in its parent
+ *
+ * @param pLevel level of resolution of the brick
+ ******************************************************************************/
+void GvxPointCloudVoxelizer::flushPendingBrick( unsigned int pLevel )
+{
+	PendingBrick& pendingBrick = _pendingBricks[ pLevel ];
+	if ( ! pendingBrick._isValid )
+	{
+		return;
+	}
+	pendingBrick._isValid = false;
+
+	const unsigned int brickWidth = 1U << _nbBrickBits;
+	const unsigned int borderSize = _dataStructureIOHandlers[ pLevel ]->_borderSize;
+	const unsigned int brickResolution = brickWidth + 2 * borderSize;
+	const unsigned int brickSize = brickResolution * brickResolution * brickResolution;
+	std::vector< unsigned char > colors( 4 * brickSize, 0 );
+	std::vector< unsigned short > normals( pendingBrick._normals.empty() ? 0 : 4 * brickSize, 0 );
+
+	for ( unsigned int z = 0; z < brickWidth; z++ )
+	for ( unsigned int y = 0; y < brickWidth; y++ )
+	for ( unsigned int x = 0; x < brickWidth; x++ )
+	{
+		const size_t voxel = x + brickWidth * ( y + brickWidth * z );
+		const size_t voxelInBrick = ( x + borderSize ) + brickResolution * ( ( y + borderSize ) + brickResolution * ( z + borderSize ) );
+		for ( int i = 0; i < 4; i++ )
+		{
+			colors[ 4 * voxelInBrick + i ] = roundToUchar( pendingBrick._colors[ 4 * voxel + i ] / 8.f );
+		}
+
+		if ( ! normals.empty() )
+		{
+			const float* normal = &pendingBrick._normals[ 3 * voxel ];
+			const float norm = sqrtf( normal[ 0 ] * normal[ 0 ] + normal[ 1 ] * normal[ 1 ] + normal[ 2 ] * normal[ 2 ] );
+			if ( norm >= 0.00001f )
+			{
+				normals[ 4 * voxelInBrick + 0 ] = float2HalfInUshort( normal[ 0 ] / norm );
+				normals[ 4 * voxelInBrick + 1 ] = float2HalfInUshort( normal[ 1 ] / norm );
+				normals[ 4 * voxelInBrick + 2 ] = float2HalfInUshort( normal[ 2 ] / norm );
+				normals[ 4 * voxelInBrick + 3 ] = 1;
+			}
+		}
+	}
+
+	addBrick( pLevel, pendingBrick._key, &colors[ 0 ], normals.empty() ? NULL : &normals[ 0 ] );
+}
+
+/******************************************************************************
+ * Sort points with several threads
+ *
+ * @param pPoints the points
+ * @param pBuffer buffer used to merge sorted parts (as large as the points)
+ * @param pNbThreads number of threads
+ ******************************************************************************/
+void GvxPointCloudVoxelizer::sortPoints( std::vector< PointRecord >& pPoints, std::vector< PointRecord >& pBuffer, unsigned int pNbThreads )
+{
+	const size_t nbPoints = pPoints.size();
+
+	// Each thread sorts a part of the points (small sets are not worth it)
+	size_t nbParts = std::min( static_cast< size_t >( pNbThreads ), nbPoints / 65536 );
+#ifdef WIN32
+	nbParts = 1;
+#endif
+	if ( nbParts <= 1 )
+	{
+		std::sort( pPoints.begin(), pPoints.end(), isKeyLess );
+
+		return;
+	}
+
+	std::vector< size_t > bounds( nbParts + 1 );
+	for ( size_t i = 0; i <= nbParts; i++ )
+	{
+		bounds[ i ] = nbPoints * i / nbParts;
+	}
+	pBuffer.resize( nbPoints );
+
+	PointRecord* points = &pPoints[ 0 ];
+	PointRecord* buffer = &pBuffer[ 0 ];
+	std::vector< SortTask > tasks( nbParts );
+	for ( size_t i = 0; i < nbParts; i++ )
+	{
+		tasks[ i ]._first = points + bounds[ i ];
+		tasks[ i ]._middle = points + bounds[ i + 1 ];
+		tasks[ i ]._last = points + bounds[ i + 1 ];
+		tasks[ i ]._output = NULL;
+	}
+	runSortTasks( tasks );
+
+	// Sorted parts are merged two by two, from one buffer to the other
+	bool isInBuffer = false;
+	while ( bounds.size() > 2 )
+	{
+		PointRecord* input = isInBuffer ? buffer : points;
+		PointRecord* output = isInBuffer ? points : buffer;
+
+		std::vector< size_t > mergedBounds;
+		tasks.clear();
+		for ( size_t i = 0; i + 1 < bounds.size(); i += 2 )
+		{
+			// The last part is copied if it has no pair
+			const size_t last = ( i + 2 < bounds.size() ) ? bounds[ i + 2 ] : bounds[ i + 1 ];
+
+			SortTask task;
+			task._first = input + bounds[ i ];
+			task._middle = input + bounds[ i + 1 ];
+			task._last = input + last;
+			task._output = output + bounds[ i ];
+			tasks.push_back( task );
+
+			mergedBounds.push_back( bounds[ i ] );
+		}
+		mergedBounds.push_back( nbPoints );
+		runSortTasks( tasks );
+
+		bounds.swap( mergedBounds );
+		isInBuffer = ! isInBuffer;
+	}
+	if ( isInBuffer )
+	{
+		pPoints.swap( pBuffer );
+	}
+}
+
+/******************************************************************************
+ * Run sort tasks, one thread per task
+ *
+ * @param pTasks the tasks
+ ******************************************************************************/
+void GvxPointCloudVoxelizer::runSortTasks( std::vector< SortTask >& pTasks )
+{
+#ifndef WIN32
+	std::vector< pthread_t > threads( pTasks.size() );
+	std::vector< bool > isThreadCreated( pTasks.size(), false );
+	for ( size_t i = 0; i < pTasks.size(); i++ )
+	{
+		isThreadCreated[ i ] = ( pthread_create( &threads[ i ], NULL, runSortTask, &pTasks[ i ] ) == 0 );
+		if ( ! isThreadCreated[ i ] )
+		{
+			runSortTask( &pTasks[ i ] );
+		}
+	}
+	for ( size_t i = 0; i < pTasks.size(); i++ )
+	{
+		if ( isThreadCreated[ i ] )
+		{
+			pthread_join( threads[ i ], NULL );
+		}
+	}
+#else
+	for ( size_t i = 0; i < pTasks.size(); i++ )
+	{
+		runSortTask( &pTasks[ i ] );
+	}
+#endif
+}
+
+/******************************************************************************
+ * Thread entry point of a sort task
+ *
+ * @param pTask the task
+ *
+ * @return NULL
+ ******************************************************************************/
+void* GvxPointCloudVoxelizer::runSortTask( void* pTask )
+{
+	SortTask* task = static_cast< SortTask* >( pTask );
+	if ( task->_output == NULL )
+	{
+		std::sort( task->_first, task->_last, isKeyLess );
+	}
+	else
+	{
+		std::merge( task->_first, task->_middle, task->_middle, task->_last, task->_output, isKeyLess );
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ * Compare the Morton keys of two points
+ *
+ * @param pPoint1 the first point
+ * @param pPoint2 the second point
+ *
+ * @return a flag telling wheter or not the key of the first point is less than the key of the second one
+ ******************************************************************************/
+bool GvxPointCloudVoxelizer::isKeyLess( const PointRecord& pPoint1, const PointRecord& pPoint2 )
+{
+	return pPoint1._key < pPoint2._key;
+}
+
+/******************************************************************************
+ * Interleave the bits of a position (21 bits along each axis)
+ *
+ * @param pPosition the position
+ *
+ * @return the Morton key
+ ******************************************************************************/
+unsigned long long GvxPointCloudVoxelizer::encodeMortonKey( const unsigned int pPosition[ 3 ] )
+{
+	return spreadBits( pPosition[ 0 ] ) | ( spreadBits( pPosition[ 1 ] ) << 1 ) | ( spreadBits( pPosition[ 2 ] ) << 2 );
+}
+
+/******************************************************************************
+ * Retrieve a position from its Morton key
+ *
+ * @param pKey the Morton key
+ * @param pPosition the position
+ ******************************************************************************/
+void GvxPointCloudVoxelizer::decodeMortonKey( unsigned long long pKey, unsigned int pPosition[ 3 ] )
+{
+	pPosition[ 0 ] = compactBits( pKey );
+	pPosition[ 1 ] = compactBits( pKey >> 1 );
+	pPosition[ 2 ] = compactBits( pKey >> 2 );
+}
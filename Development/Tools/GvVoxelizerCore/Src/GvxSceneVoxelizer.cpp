@@ -0,0 +1,625 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** 
+ * @version 1.0
+ */
+
+#include "GvxSceneVoxelizer.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvxDataStructureIOHandler.h"
+
+// TinyXML
+#include <tinyxml.h>
+
+// STL
+#include <iostream>
+#include <cassert>
+#include <sstream>
+#include <cstdio>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GvVoxelizer
+using namespace Gvx;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvxSceneVoxelizer::GvxSceneVoxelizer()
+:	_filePath()
+,	_fileName()
+,	_fileExtension()
+,	_maxResolution( 512 )
+,	_isGenerateNormalsOn( false )
+,	_isBakedIrradianceOn( false )
+,	_brickWidth( 8 )
+,	_dataType( GvxDataTypeHandler::gvUCHAR4 )
+,	_voxelizerEngine()
+,	_normalizationScale( 1.f )
+,	_isNormalizationFixed( false )
+{
+	_normalizationCenter[ 0 ] = 0.5f;
+	_normalizationCenter[ 1 ] = 0.5f;
+	_normalizationCenter[ 2 ] = 0.5f;
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvxSceneVoxelizer::~GvxSceneVoxelizer()
+{
+}
+
+/******************************************************************************
+ * The main method called to voxelize a scene.
+ * All settings must have been done previously (i.e. filename, path, etc...)
+ ******************************************************************************/
+bool GvxSceneVoxelizer::launchVoxelizationProcess()
+{
+	// Load/import scene
+	loadScene();
+
+	// Normalize the scene
+	normalizeScene();
+	writeNormalizationFile();
+
+	// Voxelize the scene
+	voxelizeScene();
+
+	// Finalize the voxelization (borders, filter and mipmap)
+	_voxelizerEngine.end();
+
+	// mipmap();
+
+	return false;
+}
+
+/******************************************************************************
+ * Voxelize the scene at the max level of resolution only.
+ * Post-voxelization stages (borders, filter, mipmap) are not applied.
+ ******************************************************************************/
+bool GvxSceneVoxelizer::launchVoxelizationStage()
+{
+	// Load/import scene
+	if ( ! loadScene() )
+	{
+		return false;
+	}
+
+	// Normalize the scene
+	if ( ! normalizeScene() || ! writeNormalizationFile() )
+	{
+		return false;
+	}
+
+	// Voxelize the scene
+	if ( ! voxelizeScene() )
+	{
+		return false;
+	}
+
+	// Flush and close the max level files
+	_voxelizerEngine.closeDataStructure();
+
+	return true;
+}
+
+/******************************************************************************
+ * Update a previous voxelization of the scene incrementally.
+ * Only the leaf nodes touched by triangles that differ between the previous
+ * and the current version of the scene are revoxelized, then borders and
+ * mip-map levels are recomputed along their neighbors and ancestor chains.
+ *
+ * @param pPreviousScene the previous version of the scene (with its own file name)
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxSceneVoxelizer::launchIncrementalVoxelizationProcess( GvxSceneVoxelizer& pPreviousScene )
+{
+	// Voxel positions depend on the normalization : both versions of the scene are voxelized
+	// in the space of the previous voxelization, even if the scene bounding box has changed.
+	// Data generated before normalizations were recorded used the bounding box of the previous scene.
+	float normalizationCenter[ 3 ];
+	float normalizationScale;
+	if ( readNormalizationFile( normalizationCenter, normalizationScale ) )
+	{
+		pPreviousScene.setNormalization( normalizationCenter, normalizationScale );
+	}
+
+	// Load/import and normalize both versions of the scene
+	if ( ! pPreviousScene.loadScene() || ! pPreviousScene.normalizeScene() )
+	{
+		std::cerr << "GvxSceneVoxelizer::launchIncrementalVoxelizationProcess : unable to load the previous scene" << std::endl;
+
+		return false;
+	}
+	pPreviousScene.getNormalization( normalizationCenter, normalizationScale );
+	setNormalization( normalizationCenter, normalizationScale );
+	if ( ! loadScene() )
+	{
+		std::cerr << "GvxSceneVoxelizer::launchIncrementalVoxelizationProcess : unable to load the scene" << std::endl;
+
+		return false;
+	}
+
+	// The scene has grown out of the voxelized space : every voxel moves
+	if ( ! normalizeScene() )
+	{
+		std::cout << "GvxSceneVoxelizer::launchIncrementalVoxelizationProcess : the scene doesn't fit in the previous voxelization, the whole scene is voxelized" << std::endl;
+
+		resetNormalization();
+		if ( ! normalizeScene() || ! writeNormalizationFile() || ! voxelizeScene() )
+		{
+			return false;
+		}
+		_voxelizerEngine.end();
+
+		return true;
+	}
+	if ( ! writeNormalizationFile() )
+	{
+		return false;
+	}
+
+	// Reopen the previous voxelization
+	if ( ! _voxelizerEngine.beginIncrementalVoxelization( getMaxResolution(), getBrickWidth(), getFileName(), getDataType() ) )
+	{
+		return false;
+	}
+
+	// Compare triangles of both versions :
+	// nodes touched by added triangles, then by removed ones, are marked dirty
+	pPreviousScene.voxelizeTriangles( _voxelizerEngine );
+	_voxelizerEngine.setIncrementalStage( GvxVoxelizerEngine::eMarkAddedTriangles );
+	voxelizeTriangles( _voxelizerEngine );
+	_voxelizerEngine.setIncrementalStage( GvxVoxelizerEngine::eMarkRemovedTriangles );
+	pPreviousScene.voxelizeTriangles( _voxelizerEngine );
+
+	// Revoxelize dirty nodes only (all triangles touching them are voxelized again, in the original order)
+	_voxelizerEngine.setIncrementalStage( GvxVoxelizerEngine::eUpdateDirtyNodes );
+	voxelizeTriangles( _voxelizerEngine );
+
+	// Update borders and mip-map levels around dirty nodes
+	_voxelizerEngine.endIncrementalVoxelization();
+
+	return true;
+}
+
+/******************************************************************************
+ * Voxelize one tile of the scene : a sub-cube of the node grid at the max level of resolution.
+ * Only the leaf level of the tile is generated, in files named after the tile,
+ * along with a tile descriptor file.
+ *
+ * @param pTileOrigin indexed position of the first node of the tile
+ * @param pTileSize number of nodes of the tile along each axis
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxSceneVoxelizer::launchTileVoxelizationProcess( const unsigned int pTileOrigin[ 3 ], unsigned int pTileSize )
+{
+	const unsigned int nodeGridSize = 1 << getMaxResolution();
+	if ( pTileSize == 0 || pTileOrigin[ 0 ] + pTileSize > nodeGridSize || pTileOrigin[ 1 ] + pTileSize > nodeGridSize || pTileOrigin[ 2 ] + pTileSize > nodeGridSize )
+	{
+		std::cerr << "GvxSceneVoxelizer::launchTileVoxelizationProcess : the tile is out of the node grid (" << nodeGridSize << " nodes per axis)" << std::endl;
+
+		return false;
+	}
+
+	// Load/import and normalize the whole scene :
+	// all tiles must share the same normalization
+	if ( ! loadScene() || ! normalizeScene() || ! writeNormalizationFile() )
+	{
+		std::cerr << "GvxSceneVoxelizer::launchTileVoxelizationProcess : unable to load the scene" << std::endl;
+
+		return false;
+	}
+
+	// Voxelize the tile
+	_voxelizerEngine.setTile( pTileOrigin, pTileSize );
+	const bool isSucceeded = voxelizeScene();
+
+	// Flush and close the tile files, then write the tile descriptor
+	const bool isTileWritten = _voxelizerEngine.endTile();
+
+	// Back to whole scene voxelization
+	const unsigned int noTileOrigin[ 3 ] = { 0, 0, 0 };
+	_voxelizerEngine.setTile( noTileOrigin, 0 );
+
+	return isSucceeded && isTileWritten;
+}
+
+/******************************************************************************
+ * Write the XML file describing the generated data structure
+ * (levels of resolution, channels and associated files).
+ ******************************************************************************/
+bool GvxSceneVoxelizer::writeDescriptorFile( const std::string& pFileName ) const
+{
+	const unsigned int nbLevels = _maxResolution + 1;
+
+	TiXmlDocument doc;
+
+	// Model
+	TiXmlElement* modelElement = new TiXmlElement( "Model" );
+	modelElement->SetAttribute( "name", _fileName.c_str() );
+	modelElement->SetAttribute( "directory", "." );
+	modelElement->SetAttribute( "nbLevels", nbLevels );
+	doc.LinkEndChild( modelElement );
+
+	// Borderless bricks have their borders reconstructed at load time
+	const unsigned int borderSize = _voxelizerEngine.isBorderless() ? 0 : 1;
+
+	// Node tree
+	TiXmlElement* nodeTreeElement = new TiXmlElement( "NodeTree" );
+	modelElement->LinkEndChild( nodeTreeElement );
+	for ( unsigned int level = 0; level < nbLevels; level++ )
+	{
+		TiXmlElement* levelElement = new TiXmlElement( "Level" );
+		levelElement->SetAttribute( "id", level );
+		levelElement->SetAttribute( "filename", GvxDataStructureIOHandler::getFileNameNode( _fileName, level, _brickWidth, borderSize ).c_str() );
+		nodeTreeElement->LinkEndChild( levelElement );
+	}
+
+	// Brick data
+	TiXmlElement* brickDataElement = new TiXmlElement( "BrickData" );
+	brickDataElement->SetAttribute( "brickResolution", _brickWidth );
+	brickDataElement->SetAttribute( "borderSize", borderSize );
+	modelElement->LinkEndChild( brickDataElement );
+
+	// Channels
+	std::vector< std::string > channelNames;
+	std::vector< GvxDataTypeHandler::VoxelDataType > channelTypes;
+	channelNames.push_back( "color" );
+	channelTypes.push_back( _dataType );
+	if ( _isGenerateNormalsOn )
+	{
+		channelNames.push_back( "normal" );
+		channelTypes.push_back( GvxDataTypeHandler::gvHALF4 );
+	}
+	for ( unsigned int channel = 0; channel < channelNames.size(); channel++ )
+	{
+		const std::string typeName = GvxDataTypeHandler::getTypeName( channelTypes[ channel ] );
+
+		TiXmlElement* channelElement = new TiXmlElement( "Channel" );
+		channelElement->SetAttribute( "id", channel );
+		channelElement->SetAttribute( "name", channelNames[ channel ].c_str() );
+		channelElement->SetAttribute( "type", typeName.c_str() );
+		brickDataElement->LinkEndChild( channelElement );
+
+		for ( unsigned int level = 0; level < nbLevels; level++ )
+		{
+			TiXmlElement* levelElement = new TiXmlElement( "Level" );
+			levelElement->SetAttribute( "id", level );
+			levelElement->SetAttribute( "filename", GvxDataStructureIOHandler::getFileNameBrick( _fileName, level, _brickWidth, channel, typeName, borderSize ).c_str() );
+			channelElement->LinkEndChild( levelElement );
+		}
+	}
+
+	if ( ! doc.SaveFile( pFileName.c_str() ) )
+	{
+		std::cerr << "GvxSceneVoxelizer::writeDescriptorFile : unable to write " << pFileName << std::endl;
+
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Write the normalization applied to the scene in the "<file name>.normalization" file,
+ * so that a later incremental update voxelizes in the same space.
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxSceneVoxelizer::writeNormalizationFile() const
+{
+	const std::string fileName = _fileName + ".normalization";
+
+	FILE* file = fopen( fileName.c_str(), "wb" );
+	if ( file == NULL )
+	{
+		std::cerr << "GvxSceneVoxelizer::writeNormalizationFile : unable to write " << fileName << std::endl;
+
+		return false;
+	}
+
+	// Center then scale, stored as is so that they are read back exactly
+	float normalization[ 4 ];
+	normalization[ 0 ] = _normalizationCenter[ 0 ];
+	normalization[ 1 ] = _normalizationCenter[ 1 ];
+	normalization[ 2 ] = _normalizationCenter[ 2 ];
+	normalization[ 3 ] = _normalizationScale;
+	bool isSucceeded = ( fwrite( normalization, sizeof( float ), 4, file ) == 4 );
+	if ( fclose( file ) != 0 )
+	{
+		isSucceeded = false;
+	}
+	if ( ! isSucceeded )
+	{
+		std::cerr << "GvxSceneVoxelizer::writeNormalizationFile : unable to write " << fileName << std::endl;
+	}
+
+	return isSucceeded;
+}
+
+/******************************************************************************
+ * Read the normalization of a previous voxelization from the "<file name>.normalization" file
+ *
+ * @param pCenter center of the normalization
+ * @param pScale scale of the normalization
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxSceneVoxelizer::readNormalizationFile( float pCenter[ 3 ], float& pScale ) const
+{
+	const std::string fileName = _fileName + ".normalization";
+
+	FILE* file = fopen( fileName.c_str(), "rb" );
+	if ( file == NULL )
+	{
+		return false;
+	}
+
+	float normalization[ 4 ];
+	const bool isSucceeded = ( fread( normalization, sizeof( float ), 4, file ) == 4 ) && normalization[ 3 ] > 0.f;
+	fclose( file );
+	if ( ! isSucceeded )
+	{
+		std::cerr << "GvxSceneVoxelizer::readNormalizationFile : invalid file " << fileName << std::endl;
+
+		return false;
+	}
+
+	pCenter[ 0 ] = normalization[ 0 ];
+	pCenter[ 1 ] = normalization[ 1 ];
+	pCenter[ 2 ] = normalization[ 2 ];
+	pScale = normalization[ 3 ];
+
+	return true;
+}
+
+/******************************************************************************
+ * Get the voxelizer engine
+ ******************************************************************************/
+GvxVoxelizerEngine& GvxSceneVoxelizer::getVoxelizerEngine()
+{
+	return _voxelizerEngine;
+}
+
+/******************************************************************************
+ * Load/import the scene
+ ******************************************************************************/
+bool GvxSceneVoxelizer::loadScene()
+{
+	return false;
+}
+
+/******************************************************************************
+ * Normalize the scene.
+ * It determines the whole scene bounding box and then modifies vertices
+ * to scale the scene.
+ ******************************************************************************/
+bool GvxSceneVoxelizer::normalizeScene()
+{
+	return false;
+}
+
+/******************************************************************************
+ * Voxelize the scene
+ ******************************************************************************/
+bool GvxSceneVoxelizer::voxelizeScene()
+{
+	return false;
+}
+
+/******************************************************************************
+ * Give all triangles of the scene to a voxelizer engine
+ * (materials, textures and vertex attributes), in a deterministic order.
+ *
+ * @param pVoxelizerEngine the voxelizer engine
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxSceneVoxelizer::voxelizeTriangles( GvxVoxelizerEngine& pVoxelizerEngine )
+{
+	return false;
+}
+
+/******************************************************************************
+ * Apply the mip-mapping algorithmn.
+ * Given a pre-filtered voxel scene at a given level of resolution,
+ * it generates a mip-map pyramid hierarchy of coarser levels (until 0).
+******************************************************************************/
+bool GvxSceneVoxelizer::mipmap()
+{
+	// The mip-map pyramid hierarchy is built recursively from adjacent levels.
+	// Two files/streamers are used :
+	// UP is an already pre-filtered scene at resolution [ N ]
+	// DOWN is the coarser version to generate at resolution [ N - 1 ]
+	GvxDataStructureIOHandler* dataStructureIOHandlerUP = new GvxDataStructureIOHandler( getFileName(), getMaxResolution(), getBrickWidth(), getDataType(), false );
+	GvxDataStructureIOHandler* dataStructureIOHandlerDOWN = NULL;
+
+	// Iterate through levels of resolution
+	for ( int level = getMaxResolution() - 1; level >= 0; level-- )
+	{
+		// LOG info
+		std::cout << "GvxVoxelizer::mipmap : level : " << level << std::endl;
+
+		// The coarser data handler is allocated dynamically due to memory consumption considerations.
+		dataStructureIOHandlerDOWN = new GvxDataStructureIOHandler( getFileName(), getMaxResolution(), getBrickWidth(), getDataType(), true );
+
+		// Iterate through nodes of the structure
+		unsigned int nodePos[ 3 ];
+		for ( nodePos[ 2 ] = 0; nodePos[ 2 ] < dataStructureIOHandlerUP->_nodeGridSize; nodePos[ 2 ]++ )
+		for ( nodePos[ 1 ] = 0; nodePos[ 1 ] < dataStructureIOHandlerUP->_nodeGridSize; nodePos[ 1 ]++ )
+		for ( nodePos[ 0 ] = 0; nodePos[ 0 ] < dataStructureIOHandlerUP->_nodeGridSize; nodePos[ 0 ]++ )
+		{
+			// Retrieve the current node info
+			unsigned int node = dataStructureIOHandlerUP->getNode( nodePos );
+
+			// If node is empty, go to next node
+			if ( GvxDataStructureIOHandler::isEmpty( node ) )
+			{
+				continue;
+			}
+
+			// Iterate through voxels of the current node
+			unsigned int voxelPos[3];
+			for ( voxelPos[ 2 ] = _brickWidth * nodePos[ 2 ]; voxelPos[ 2 ] < dataStructureIOHandlerUP->_brickWidth * ( nodePos[ 2 ] + 1 ); voxelPos[ 2 ] += 2 )
+			for ( voxelPos[ 1 ] = _brickWidth * nodePos[ 1 ]; voxelPos[ 1 ] < dataStructureIOHandlerUP->_brickWidth * ( nodePos[ 1 ] + 1 ); voxelPos[ 1 ] += 2 )
+			for ( voxelPos[ 0 ] = _brickWidth * nodePos[ 0 ]; voxelPos[ 0 ] < dataStructureIOHandlerUP->_brickWidth * ( nodePos[ 0 ] + 1 ); voxelPos[ 0 ] += 2 )
+			{
+				float voxelDataDOWNf[ 4 ] = { 0.f, 0.f, 0.f, 0.f };
+				float voxelDataDOWNf2[ 4 ] = { 0.f, 0.f, 0.f, 0.f };
+
+				// As the underlying structure is an octree,
+				// to compute data at coaser level,
+				// we need to iterate through 8 voxels and take the mean value.
+				for ( unsigned int z = 0; z < 2; z++ )
+				for ( unsigned int y = 0; y < 2; y++ )
+				for ( unsigned int x = 0; x < 2; x++ )
+				{
+					// Retrieve position of voxel in the UP resolution version
+					unsigned int voxelPosUP[ 3 ];
+					voxelPosUP[ 0 ] = voxelPos[ 0 ] + x;
+					voxelPosUP[ 1 ] = voxelPos[ 1 ] + y;
+					voxelPosUP[ 2 ] = voxelPos[ 2 ] + z;
+
+					// Get associated data (in the UP resolution version)
+					unsigned char voxelDataUP[ 4 ];
+					dataStructureIOHandlerUP->getVoxel( voxelPosUP, voxelDataUP, 0 );
+					voxelDataDOWNf[ 0 ] += voxelDataUP[ 0 ];
+					voxelDataDOWNf[ 1 ] += voxelDataUP[ 1 ];
+					voxelDataDOWNf[ 2 ] += voxelDataUP[ 2 ];
+					voxelDataDOWNf[ 3 ] += voxelDataUP[ 3 ];
+				}
+
+				// Coarser voxel is scaled from current UP voxel (2 times smaller for octree)
+				unsigned int voxelPosDOWN[ 3 ];
+				voxelPosDOWN[ 0 ] = voxelPos[ 0 ] / 2;
+				voxelPosDOWN[ 1 ] = voxelPos[ 1 ] / 2;
+				voxelPosDOWN[ 2 ] = voxelPos[ 2 ] / 2;
+
+				// Set data in coarser voxel (take alpha into account)
+				unsigned char vd[ 4 ];	// "vd" stands for "voxel data"
+				float alpha = voxelDataDOWNf[ 3 ] / 8.f;
+				if ( alpha > 0 )
+				{
+					float R = voxelDataDOWNf[ 0 ] / 8.f / alpha;
+					float G = voxelDataDOWNf[ 1 ] / 8.f / alpha;
+					float B = voxelDataDOWNf[ 2 ] / 8.f / alpha;
+
+					alpha = min< float >( 2.f * alpha, 255.f );
+
+					vd[ 0 ] = static_cast< unsigned char >( R * alpha );
+					vd[ 1 ] = static_cast< unsigned char >( G * alpha );
+					vd[ 2 ] = static_cast< unsigned char >( B * alpha );
+					vd[ 3 ] = static_cast< unsigned char >( alpha );
+				}
+				else
+				{
+					vd[ 0 ] = 0;
+					vd[ 1 ] = 0;
+					vd[ 2 ] = 0;
+					vd[ 3 ] = 0;
+				}
+				dataStructureIOHandlerDOWN->setVoxel( voxelPosDOWN, vd, 0 );
+			}
+		}
+
+		// Generate the border data of the coarser scene
+		dataStructureIOHandlerDOWN->computeBorders();
+
+		// Destroy the coarser data handler (due to memory consumption considerations)
+		delete dataStructureIOHandlerUP;
+
+		// The mip-map pyramid hierarchy is built recursively from adjacent levels.
+		// Now that the coarser version has been generated, a coarser one need to be generated from it.
+		// So, the coarser one is the UP version.
+		dataStructureIOHandlerUP = dataStructureIOHandlerDOWN;
+	}
+
+	// Free memory
+	delete dataStructureIOHandlerDOWN;
+
+	return true;
+}
+
+/******************************************************************************
+ * Set the filter type
+ *
+ * 0 = mean
+ * 1 = gaussian
+ * 2 = laplacian
+ ******************************************************************************/
+void GvxSceneVoxelizer::setFilterType(int filterType)
+{
+	_voxelizerEngine.setFilterType(filterType);
+}
+
+/******************************************************************************
+ * Set the number of application of the filter
+ ******************************************************************************/
+void GvxSceneVoxelizer::setFilterIterations(int nbFilterOperation)
+{
+	_voxelizerEngine.setNbFilterApplications(nbFilterOperation);
+}
+
+/******************************************************************************
+ * Set whether or not we generate the normal field
+ ******************************************************************************/
+void GvxSceneVoxelizer::setNormals ( bool normals)
+{
+	_isGenerateNormalsOn = normals;
+	_voxelizerEngine.setNormals(normals);
+}
+
+/******************************************************************************
+ * Set whether or not bricks are stored without borders
+ * (borders are then reconstructed at load time)
+ ******************************************************************************/
+void GvxSceneVoxelizer::setBorderless( bool pFlag )
+{
+	_voxelizerEngine.setBorderless( pFlag );
+}
\ No newline at end of file
@@ -0,0 +1,444 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvxTextureCache.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// STL
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+// CImg
+#define cimg_use_magick	// Beware, this definition must be placed before including CImg.h
+#include <CImg.h>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// Project
+using namespace Gvx;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * Default max memory size of the cache (in bytes)
+ */
+static const size_t cDefaultMaxMemorySize = static_cast< size_t >( 512 ) * 1024 * 1024;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Get the number of mip-map levels
+ *
+ * @return the number of mip-map levels
+ ******************************************************************************/
+unsigned int GvxTextureCache::Texture::getNbLevels() const
+{
+	return static_cast< unsigned int >( _widths.size() );
+}
+
+/******************************************************************************
+ * Get the memory size of the texels
+ *
+ * @return the memory size (in bytes)
+ ******************************************************************************/
+size_t GvxTextureCache::Texture::getMemorySize() const
+{
+	return _texels.size();
+}
+
+/******************************************************************************
+ * Sample the texture (nearest texel).
+ * The mip-map level is selected from the footprint of the sample, i.e. the extent
+ * of the sampled area (a voxel) in texture space : the level is the one where
+ * this extent is closest to one texel.
+ *
+ * @param pS s texture coordinate (positive)
+ * @param pT t texture coordinate (positive)
+ * @param pFootprint extent of the sampled area in texture coordinates
+ * @param pColor the sampled color (RGBA, normalized in [ 0.0 ; 1.0 ])
+ ******************************************************************************/
+void GvxTextureCache::Texture::sample( float pS, float pT, float pFootprint, float pColor[ 4 ] ) const
+{
+	// Select the mip-map level
+	unsigned int level = 0;
+	const float nbTexels = pFootprint * static_cast< float >( std::max( _widths[ 0 ], _heights[ 0 ] ) );
+	if ( nbTexels > 1.f )
+	{
+		level = static_cast< unsigned int >( floorf( logf( nbTexels ) / logf( 2.f ) + 0.5f ) );
+		level = std::min( level, getNbLevels() - 1 );
+	}
+	const unsigned int width = _widths[ level ];
+	const unsigned int height = _heights[ level ];
+
+	// Retrieve indexed texel coordinates (same addressing at each level)
+	unsigned int tx = static_cast< unsigned int >( pS * ( width - 1 ) );
+	tx = tx % width;
+	unsigned int ty = static_cast< unsigned int >( pT * ( height - 1 ) );
+	ty = ty % height;
+
+	// Normalize value
+	const unsigned char* texel = &_texels[ _offsets[ level ] + 4 * ( ty * static_cast< size_t >( width ) + tx ) ];
+	pColor[ 0 ] = texel[ 0 ] / 255.f;
+	pColor[ 1 ] = texel[ 1 ] / 255.f;
+	pColor[ 2 ] = texel[ 2 ] / 255.f;
+	pColor[ 3 ] = texel[ 3 ] / 255.f;
+}
+
+/******************************************************************************
+ * Get the texture cache shared by all voxelizers
+ *
+ * @return the texture cache
+ ******************************************************************************/
+GvxTextureCache& GvxTextureCache::get()
+{
+	static GvxTextureCache textureCache;
+
+	return textureCache;
+}
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvxTextureCache::GvxTextureCache()
+:	_textures()
+,	_memorySize( 0 )
+,	_maxMemorySize( cDefaultMaxMemorySize )
+,	_useCounter( 0 )
+{
+#ifndef WIN32
+	pthread_mutex_init( &_mutex, NULL );
+#endif
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvxTextureCache::~GvxTextureCache()
+{
+	for ( map< string, Texture* >::iterator it = _textures.begin(); it != _textures.end(); ++it )
+	{
+		delete it->second;
+	}
+
+#ifndef WIN32
+	pthread_mutex_destroy( &_mutex );
+#endif
+}
+
+/******************************************************************************
+ * Get a texture, loading it if it is not in the cache.
+ * The texture stays in memory until it is released.
+ *
+ * @param pFilename the image filename
+ *
+ * @return the texture (NULL if the image can't be loaded)
+ ******************************************************************************/
+const GvxTextureCache::Texture* GvxTextureCache::acquire( const std::string& pFilename )
+{
+	lock();
+
+	// Search the cache
+	map< string, Texture* >::iterator it = _textures.find( pFilename );
+	if ( it != _textures.end() )
+	{
+		Texture* texture = it->second;
+		texture->_nbReferences++;
+		texture->_lastUse = ++_useCounter;
+
+		unlock();
+
+		return texture;
+	}
+
+	// Load texture
+	Texture* texture = new Texture();
+	if ( ! load( pFilename, *texture ) )
+	{
+		delete texture;
+
+		unlock();
+
+		return NULL;
+	}
+
+	// Make room for it
+	evict( texture->getMemorySize() );
+
+	texture->_nbReferences = 1;
+	texture->_lastUse = ++_useCounter;
+	_textures[ pFilename ] = texture;
+	_memorySize += texture->getMemorySize();
+
+	unlock();
+
+	return texture;
+}
+
+/******************************************************************************
+ * Release a texture previously acquired
+ *
+ * @param pTexture the texture (NULL is ignored)
+ ******************************************************************************/
+void GvxTextureCache::release( const Texture* pTexture )
+{
+	if ( pTexture == NULL )
+	{
+		return;
+	}
+
+	lock();
+
+	map< string, Texture* >::iterator it = _textures.find( pTexture->_filename );
+	if ( it == _textures.end() || it->second->_nbReferences == 0 )
+	{
+		cerr << "GvxTextureCache::release : texture " << pTexture->_filename << " is not referenced" << endl;
+
+		unlock();
+
+		return;
+	}
+
+	it->second->_nbReferences--;
+
+	// Textures may have been kept over the max memory size while referenced
+	evict( 0 );
+
+	unlock();
+}
+
+/******************************************************************************
+ * Set the max memory size of the cache.
+ * Unreferenced textures are evicted if needed.
+ *
+ * @param pSize the max memory size (in bytes)
+ ******************************************************************************/
+void GvxTextureCache::setMaxMemorySize( size_t pSize )
+{
+	lock();
+
+	_maxMemorySize = pSize;
+	evict( 0 );
+
+	unlock();
+}
+
+/******************************************************************************
+ * Get the max memory size of the cache
+ *
+ * @return the max memory size (in bytes)
+ ******************************************************************************/
+size_t GvxTextureCache::getMaxMemorySize() const
+{
+	lock();
+	const size_t size = _maxMemorySize;
+	unlock();
+
+	return size;
+}
+
+/******************************************************************************
+ * Get the memory size of the textures in the cache
+ *
+ * @return the memory size (in bytes)
+ ******************************************************************************/
+size_t GvxTextureCache::getMemorySize() const
+{
+	lock();
+	const size_t size = _memorySize;
+	unlock();
+
+	return size;
+}
+
+/******************************************************************************
+ * Lock the mutex protecting the cache
+ ******************************************************************************/
+void GvxTextureCache::lock() const
+{
+#ifndef WIN32
+	pthread_mutex_lock( &_mutex );
+#endif
+}
+
+/******************************************************************************
+ * Unlock the mutex protecting the cache
+ ******************************************************************************/
+void GvxTextureCache::unlock() const
+{
+#ifndef WIN32
+	pthread_mutex_unlock( &_mutex );
+#endif
+}
+
+/******************************************************************************
+ * Evict the least recently used unreferenced textures
+ * until the memory size fits in the max memory size.
+ * The mutex must be locked.
+ *
+ * @param pNeededSize memory size needed for a new texture (in bytes)
+ ******************************************************************************/
+void GvxTextureCache::evict( size_t pNeededSize )
+{
+	while ( _memorySize + pNeededSize > _maxMemorySize )
+	{
+		// Search the least recently used unreferenced texture
+		map< string, Texture* >::iterator lru = _textures.end();
+		for ( map< string, Texture* >::iterator it = _textures.begin(); it != _textures.end(); ++it )
+		{
+			if ( it->second->_nbReferences == 0 && ( lru == _textures.end() || it->second->_lastUse < lru->second->_lastUse ) )
+			{
+				lru = it;
+			}
+		}
+		if ( lru == _textures.end() )
+		{
+			// All remaining textures are in use
+			return;
+		}
+
+		_memorySize -= lru->second->getMemorySize();
+		delete lru->second;
+		_textures.erase( lru );
+	}
+}
+
+/******************************************************************************
+ * Load an image file as a 8-bit RGBA texture and build its mip-map pyramid
+ *
+ * @param pFilename the image filename
+ * @param pTexture the texture
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxTextureCache::load( const std::string& pFilename, Texture& pTexture )
+{
+	cimg_library::CImg< unsigned char > image;
+	try
+	{
+		image.load( pFilename.c_str() );
+	}
+	catch ( cimg_library::CImgException& )
+	{
+		cerr << "GvxTextureCache::load : unable to load image " << pFilename << endl;
+
+		return false;
+	}
+	if ( image.is_empty() )
+	{
+		cerr << "GvxTextureCache::load : empty image " << pFilename << endl;
+
+		return false;
+	}
+
+	pTexture._filename = pFilename;
+	pTexture._nbReferences = 0;
+	pTexture._lastUse = 0;
+
+	// Mip-map level sizes (down to 1x1)
+	unsigned int width = static_cast< unsigned int >( image.width() );
+	unsigned int height = static_cast< unsigned int >( image.height() );
+	size_t nbTexels = 0;
+	for ( ; ; )
+	{
+		pTexture._widths.push_back( width );
+		pTexture._heights.push_back( height );
+		pTexture._offsets.push_back( 4 * nbTexels );
+		nbTexels += static_cast< size_t >( width ) * height;
+		if ( width == 1 && height == 1 )
+		{
+			break;
+		}
+		width = std::max( width / 2, 1U );
+		height = std::max( height / 2, 1U );
+	}
+	pTexture._texels.resize( 4 * nbTexels );
+
+	// Convert the image to RGBA (CImg stores each channel in its own plane)
+	const int nbChannels = image.spectrum();
+	unsigned char* texel = &pTexture._texels[ 0 ];
+	for ( int y = 0; y < image.height(); y++ )
+	for ( int x = 0; x < image.width(); x++ )
+	{
+		if ( nbChannels < 3 )
+		{
+			// Grey, with optional alpha
+			texel[ 0 ] = image( x, y, 0, 0 );
+			texel[ 1 ] = texel[ 0 ];
+			texel[ 2 ] = texel[ 0 ];
+			texel[ 3 ] = ( nbChannels == 2 ) ? image( x, y, 0, 1 ) : 255;
+		}
+		else
+		{
+			texel[ 0 ] = image( x, y, 0, 0 );
+			texel[ 1 ] = image( x, y, 0, 1 );
+			texel[ 2 ] = image( x, y, 0, 2 );
+			texel[ 3 ] = ( nbChannels > 3 ) ? image( x, y, 0, 3 ) : 255;
+		}
+		texel += 4;
+	}
+
+	// Build coarser levels (2x2 box filter, the last row/column of odd sizes is clamped)
+	for ( unsigned int level = 1; level < pTexture.getNbLevels(); level++ )
+	{
+		const unsigned int srcWidth = pTexture._widths[ level - 1 ];
+		const unsigned int srcHeight = pTexture._heights[ level - 1 ];
+		const unsigned char* src = &pTexture._texels[ pTexture._offsets[ level - 1 ] ];
+		unsigned char* dst = &pTexture._texels[ pTexture._offsets[ level ] ];
+		for ( unsigned int y = 0; y < pTexture._heights[ level ]; y++ )
+		for ( unsigned int x = 0; x < pTexture._widths[ level ]; x++ )
+		{
+			const unsigned int x0 = 2 * x;
+			const unsigned int x1 = std::min( 2 * x + 1, srcWidth - 1 );
+			const unsigned int y0 = 2 * y;
+			const unsigned int y1 = std::min( 2 * y + 1, srcHeight - 1 );
+			for ( unsigned int c = 0; c < 4; c++ )
+			{
+				const unsigned int sum = src[ 4 * ( y0 * srcWidth + x0 ) + c ] + src[ 4 * ( y0 * srcWidth + x1 ) + c ]
+										+ src[ 4 * ( y1 * srcWidth + x0 ) + c ] + src[ 4 * ( y1 * srcWidth + x1 ) + c ];
+				*dst++ = static_cast< unsigned char >( ( sum + 2 ) / 4 );
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,454 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvxTileMerger.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvxSceneVoxelizer.h"
+#include "GvxVoxelizerEngine.h"
+#include "GvxDataStructureIOHandler.h"
+#include "GvxDataTypeHandler.h"
+
+// STL
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <utility>
+#include <cstring>
+
+// System
+#include <cstdio>
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// Project
+using namespace Gvx;
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ *
+ * @param pSceneVoxelizer the scene voxelizer providing the settings of the merged
+ * data structure (file name, max level of resolution, brick width, data type, normals, filter)
+ ******************************************************************************/
+GvxTileMerger::GvxTileMerger( GvxSceneVoxelizer& pSceneVoxelizer )
+:	_sceneVoxelizer( pSceneVoxelizer )
+,	_tileNames()
+{
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvxTileMerger::~GvxTileMerger()
+{
+}
+
+/******************************************************************************
+ * Add a tile to merge
+ *
+ * @param pTileName name of the tile data (i.e. its descriptor file name without the ".tile" extension)
+ ******************************************************************************/
+void GvxTileMerger::addTile( const std::string& pTileName )
+{
+	_tileNames.push_back( pTileName );
+}
+
+/******************************************************************************
+ * Merge the tiles : the leaf level is assembled from all tiles,
+ * then borders, filter and mip-map levels are generated.
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxTileMerger::execute()
+{
+	if ( _tileNames.empty() )
+	{
+		std::cerr << "GvxTileMerger::execute : no tile to merge" << std::endl;
+
+		return false;
+	}
+
+	// Retrieve tile descriptors
+	std::vector< Tile > tiles( _tileNames.size() );
+	for ( size_t i = 0; i < _tileNames.size(); i++ )
+	{
+		if ( ! readTileDescriptor( _tileNames[ i ], tiles[ i ] ) )
+		{
+			return false;
+		}
+	}
+	if ( ! checkTiles( tiles ) )
+	{
+		return false;
+	}
+
+	// Assemble the leaf level
+	std::cout << "GvxTileMerger : merging " << tiles.size() << " tiles" << std::endl;
+	if ( ! mergeLeafLevel( tiles ) )
+	{
+		return false;
+	}
+
+	// Borders (across tiles too), filter and mip-map levels
+	GvxVoxelizerEngine& voxelizerEngine = _sceneVoxelizer.getVoxelizerEngine();
+	voxelizerEngine.setup( _sceneVoxelizer.getMaxResolution(), _sceneVoxelizer.getBrickWidth(), _sceneVoxelizer.getFileName(), _sceneVoxelizer.getDataType() );
+	voxelizerEngine.end();
+
+	return true;
+}
+
+/******************************************************************************
+ * Get the name of the data of a tile
+ *
+ * @param pName name of the whole data (i.e. sponza, dragon, sibenik, etc...)
+ * @param pTileOrigin indexed position of the first node of the tile
+ *
+ * @return the name of the tile data
+ ******************************************************************************/
+std::string GvxTileMerger::getTileName( const std::string& pName, const unsigned int pTileOrigin[ 3 ] )
+{
+	std::ostringstream tileName;
+	tileName << pName << "_T" << pTileOrigin[ 0 ] << "_" << pTileOrigin[ 1 ] << "_" << pTileOrigin[ 2 ];
+
+	return tileName.str();
+}
+
+/******************************************************************************
+ * Write a tile descriptor file
+ *
+ * @param pTileName name of the tile data
+ * @param pLevel max level of resolution
+ * @param pBrickWidth brick width
+ * @param pTileOrigin indexed position of the first node of the tile
+ * @param pTileSize number of nodes of the tile along each axis
+ * @param pNodeWrites index of the first write of each node of the tile, by node index
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxTileMerger::writeTileDescriptor( const std::string& pTileName, unsigned int pLevel, unsigned int pBrickWidth,
+										const unsigned int pTileOrigin[ 3 ], unsigned int pTileSize,
+										const std::map< unsigned int, unsigned long long >& pNodeWrites )
+{
+	const std::string fileName = pTileName + ".tile";
+
+	FILE* file = fopen( fileName.c_str(), "wb" );
+	if ( file == NULL )
+	{
+		std::cerr << "GvxTileMerger::writeTileDescriptor : unable to write " << fileName << std::endl;
+
+		return false;
+	}
+
+	unsigned int header[ 7 ];
+	header[ 0 ] = pLevel;
+	header[ 1 ] = pBrickWidth;
+	header[ 2 ] = pTileOrigin[ 0 ];
+	header[ 3 ] = pTileOrigin[ 1 ];
+	header[ 4 ] = pTileOrigin[ 2 ];
+	header[ 5 ] = pTileSize;
+	header[ 6 ] = static_cast< unsigned int >( pNodeWrites.size() );
+
+	std::vector< unsigned int > nodeIndices;
+	std::vector< unsigned long long > nodeWrites;
+	nodeIndices.reserve( pNodeWrites.size() );
+	nodeWrites.reserve( pNodeWrites.size() );
+	std::map< unsigned int, unsigned long long >::const_iterator nodeIt = pNodeWrites.begin();
+	for ( ; nodeIt != pNodeWrites.end(); ++nodeIt )
+	{
+		nodeIndices.push_back( nodeIt->first );
+		nodeWrites.push_back( nodeIt->second );
+	}
+
+	bool isSucceeded = ( fwrite( header, sizeof( unsigned int ), 7, file ) == 7 );
+	if ( isSucceeded && ! nodeIndices.empty() )
+	{
+		isSucceeded = ( fwrite( &nodeIndices[ 0 ], sizeof( unsigned int ), nodeIndices.size(), file ) == nodeIndices.size() ) &&
+						( fwrite( &nodeWrites[ 0 ], sizeof( unsigned long long ), nodeWrites.size(), file ) == nodeWrites.size() );
+	}
+	if ( fclose( file ) != 0 )
+	{
+		isSucceeded = false;
+	}
+	if ( ! isSucceeded )
+	{
+		std::cerr << "GvxTileMerger::writeTileDescriptor : unable to write " << fileName << std::endl;
+	}
+
+	return isSucceeded;
+}
+
+/******************************************************************************
+ * Read a tile descriptor file
+ *
+ * @param pTileName name of the tile data
+ * @param pTile the tile descriptor
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxTileMerger::readTileDescriptor( const std::string& pTileName, Tile& pTile ) const
+{
+	const std::string fileName = pTileName + ".tile";
+
+	FILE* file = fopen( fileName.c_str(), "rb" );
+	if ( file == NULL )
+	{
+		std::cerr << "GvxTileMerger::readTileDescriptor : unable to read " << fileName << std::endl;
+
+		return false;
+	}
+
+	unsigned int header[ 7 ];
+	bool isSucceeded = ( fread( header, sizeof( unsigned int ), 7, file ) == 7 );
+	if ( isSucceeded )
+	{
+		pTile._name = pTileName;
+		pTile._origin[ 0 ] = header[ 2 ];
+		pTile._origin[ 1 ] = header[ 3 ];
+		pTile._origin[ 2 ] = header[ 4 ];
+		pTile._size = header[ 5 ];
+		pTile._nodeIndices.resize( header[ 6 ] );
+		pTile._nodeWrites.resize( header[ 6 ] );
+		if ( header[ 6 ] > 0 )
+		{
+			isSucceeded = ( fread( &pTile._nodeIndices[ 0 ], sizeof( unsigned int ), header[ 6 ], file ) == header[ 6 ] ) &&
+							( fread( &pTile._nodeWrites[ 0 ], sizeof( unsigned long long ), header[ 6 ], file ) == header[ 6 ] );
+		}
+	}
+	fclose( file );
+
+	if ( ! isSucceeded )
+	{
+		std::cerr << "GvxTileMerger::readTileDescriptor : invalid tile descriptor " << fileName << std::endl;
+
+		return false;
+	}
+
+	// Tiles must have been voxelized with the settings of the merged data structure
+	if ( header[ 0 ] != _sceneVoxelizer.getMaxResolution() || header[ 1 ] != _sceneVoxelizer.getBrickWidth() )
+	{
+		std::cerr << "GvxTileMerger::readTileDescriptor : " << fileName << " has been generated at level " << header[ 0 ]
+					<< " with a brick width of " << header[ 1 ] << std::endl;
+
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Check that tiles lie in the node grid and do not overlap
+ *
+ * @param pTiles the tile descriptors
+ *
+ * @return a flag telling wheter or not tiles are valid
+ ******************************************************************************/
+bool GvxTileMerger::checkTiles( const std::vector< Tile >& pTiles ) const
+{
+	const unsigned long long nodeGridSize = 1ULL << _sceneVoxelizer.getMaxResolution();
+
+	unsigned long long nbNodes = 0;
+	for ( size_t i = 0; i < pTiles.size(); i++ )
+	{
+		const Tile& tile = pTiles[ i ];
+		if ( tile._size == 0 || tile._origin[ 0 ] + static_cast< unsigned long long >( tile._size ) > nodeGridSize ||
+			tile._origin[ 1 ] + static_cast< unsigned long long >( tile._size ) > nodeGridSize ||
+			tile._origin[ 2 ] + static_cast< unsigned long long >( tile._size ) > nodeGridSize )
+		{
+			std::cerr << "GvxTileMerger::checkTiles : tile " << tile._name << " is out of the node grid" << std::endl;
+
+			return false;
+		}
+
+		for ( size_t j = 0; j < i; j++ )
+		{
+			const Tile& otherTile = pTiles[ j ];
+			bool isOverlapping = true;
+			for ( int axis = 0; axis < 3; axis++ )
+			{
+				if ( tile._origin[ axis ] >= otherTile._origin[ axis ] + otherTile._size ||
+					otherTile._origin[ axis ] >= tile._origin[ axis ] + tile._size )
+				{
+					isOverlapping = false;
+				}
+			}
+			if ( isOverlapping )
+			{
+				std::cerr << "GvxTileMerger::checkTiles : tiles " << otherTile._name << " and " << tile._name << " overlap" << std::endl;
+
+				return false;
+			}
+		}
+
+		nbNodes += static_cast< unsigned long long >( tile._size ) * tile._size * tile._size;
+	}
+
+	// Missing tiles are not an error (i.e. empty regions of the scene), but their data would be lost
+	if ( nbNodes != nodeGridSize * nodeGridSize * nodeGridSize )
+	{
+		std::cout << "GvxTileMerger::checkTiles : warning, tiles do not cover the whole node grid" << std::endl;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Assemble the leaf level from the data of all tiles
+ *
+ * @param pTiles the tile descriptors
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxTileMerger::mergeLeafLevel( const std::vector< Tile >& pTiles )
+{
+	const unsigned int level = _sceneVoxelizer.getMaxResolution();
+	const unsigned int brickWidth = _sceneVoxelizer.getBrickWidth();
+	const unsigned int borderSize = _sceneVoxelizer.getVoxelizerEngine().getBorderSize();
+
+	// Data channels, as generated by the voxelizer engine
+	std::vector< GvxDataTypeHandler::VoxelDataType > dataTypes;
+	dataTypes.push_back( _sceneVoxelizer.getDataType() );
+	if ( _sceneVoxelizer.isGenerateNormalsOn() )
+	{
+		dataTypes.push_back( GvxDataTypeHandler::gvHALF4 );
+	}
+
+	// Leaf level files of all tiles must exist
+	for ( size_t i = 0; i < pTiles.size(); i++ )
+	{
+		std::vector< std::string > fileNames;
+		fileNames.push_back( GvxDataStructureIOHandler::getFileNameNode( pTiles[ i ]._name, level, brickWidth, borderSize ) );
+		for ( unsigned int c = 0; c < dataTypes.size(); ++c )
+		{
+			fileNames.push_back( GvxDataStructureIOHandler::getFileNameBrick( pTiles[ i ]._name, level, brickWidth, c, GvxDataTypeHandler::getTypeName( dataTypes[ c ] ), borderSize ) );
+		}
+
+		for ( size_t j = 0; j < fileNames.size(); j++ )
+		{
+			FILE* file = fopen( fileNames[ j ].c_str(), "rb" );
+			if ( file == NULL )
+			{
+				std::cerr << "GvxTileMerger::mergeLeafLevel : missing file " << fileNames[ j ] << std::endl;
+
+				return false;
+			}
+			fclose( file );
+		}
+	}
+
+	// Order nodes of all tiles by their first write,
+	// i.e. the order in which a single process creates their bricks
+	std::vector< std::pair< unsigned long long, std::pair< size_t, unsigned int > > > nodes;
+	for ( size_t i = 0; i < pTiles.size(); i++ )
+	{
+		for ( size_t j = 0; j < pTiles[ i ]._nodeIndices.size(); j++ )
+		{
+			nodes.push_back( std::make_pair( pTiles[ i ]._nodeWrites[ j ], std::make_pair( i, pTiles[ i ]._nodeIndices[ j ] ) ) );
+		}
+	}
+	std::sort( nodes.begin(), nodes.end() );
+
+	// Open data structures
+	std::vector< GvxDataStructureIOHandler* > tileDataStructureIOHandlers;
+	for ( size_t i = 0; i < pTiles.size(); i++ )
+	{
+		tileDataStructureIOHandlers.push_back( new GvxDataStructureIOHandler( pTiles[ i ]._name, level, brickWidth, dataTypes, false, borderSize ) );
+	}
+	GvxDataStructureIOHandler* dataStructureIOHandler = new GvxDataStructureIOHandler( _sceneVoxelizer.getFileName(), level, brickWidth, dataTypes, true, borderSize );
+
+	std::vector< void* > bricks;
+	for ( unsigned int c = 0; c < dataTypes.size(); ++c )
+	{
+		bricks.push_back( GvxDataTypeHandler::allocateVoxels( dataTypes[ c ], dataStructureIOHandler->_brickSize ) );
+	}
+
+	// Zero data, large enough for any data type
+	unsigned char voxelData[ 16 ];
+	memset( voxelData, 0, sizeof( voxelData ) );
+
+	// Copy bricks
+	bool isSucceeded = true;
+	for ( size_t i = 0; i < nodes.size(); i++ )
+	{
+		GvxDataStructureIOHandler* tileDataStructureIOHandler = tileDataStructureIOHandlers[ nodes[ i ].second.first ];
+
+		unsigned int nodePos[ 3 ];
+		tileDataStructureIOHandler->getNodePosition( nodes[ i ].second.second, nodePos );
+		if ( GvxDataStructureIOHandler::isEmpty( tileDataStructureIOHandler->getNode( nodePos ) ) )
+		{
+			std::cerr << "GvxTileMerger::mergeLeafLevel : node " << nodes[ i ].second.second << " is empty in tile " << pTiles[ nodes[ i ].second.first ]._name << std::endl;
+
+			isSucceeded = false;
+			break;
+		}
+
+		// Writing one voxel creates the brick of the node (as done by the voxelizer),
+		// then its whole content is replaced by the tile data
+		unsigned int voxelPos[ 3 ];
+		voxelPos[ 0 ] = nodePos[ 0 ] * brickWidth;
+		voxelPos[ 1 ] = nodePos[ 1 ] * brickWidth;
+		voxelPos[ 2 ] = nodePos[ 2 ] * brickWidth;
+		dataStructureIOHandler->setVoxel( voxelPos, voxelData, 0 );
+
+		for ( unsigned int c = 0; c < dataTypes.size(); ++c )
+		{
+			tileDataStructureIOHandler->getBrick( nodePos, bricks[ c ], c );
+			dataStructureIOHandler->setBrick( nodePos, bricks[ c ], c );
+		}
+	}
+
+	for ( unsigned int c = 0; c < dataTypes.size(); ++c )
+	{
+		GvxDataTypeHandler::freeVoxels( dataTypes[ c ], bricks[ c ] );
+	}
+	for ( size_t i = 0; i < tileDataStructureIOHandlers.size(); i++ )
+	{
+		delete tileDataStructureIOHandlers[ i ];
+	}
+	delete dataStructureIOHandler;
+
+	return isSucceeded;
+}
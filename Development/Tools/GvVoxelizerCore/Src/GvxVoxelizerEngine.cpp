@@ -0,0 +1,2248 @@
+/*
+ * GigaVoxels is a ray-guided streaming library used for efficient
+ * 3D real-time rendering of highly detailed volumetric scenes.
+ *
+ * Copyright (C) 2011-2012 INRIA <http://www.inria.fr/>
+ *
+ * Authors : GigaVoxels Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "GvxVoxelizerEngine.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// Project
+#include "GvxTileMerger.h"
+#include "GvxDataStructureSummaryGenerator.h"
+
+// STL
+#include <iostream>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+// System
+#include <cstdio>
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// GvVoxelizer
+using namespace Gvx;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+/**
+ * This flag tell wheter or not to generate normals
+ */
+// #define NORMALS 1
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+GvxVoxelizerEngine::GvxVoxelizerEngine()
+:	_useTexture( false )
+,	_dataTypes()
+,	_dataStructureIOHandler( NULL )
+,	_fileName()
+,	_brickWidth( 8 )
+,	_level( 0 )
+,	_nbFilterApplications( 0 )
+,	_filterType( 0 )
+,	_normals( false )
+,	_isBorderless( false )
+,	_nbThreads( 1 )
+,	_memorySize( static_cast< size_t >( 256 ) * 1024 * 1024 )
+,	_texture( NULL )
+,	_textureName()
+,	_incrementalStage( eFullVoxelization )
+,	_triangleSignatures()
+,	_triangleSignatureCounts()
+,	_dirtyNodes()
+,	_tileSize( 0 )
+,	_writeIndex( 0 )
+,	_tileNodeWrites()
+{
+	_tileOrigin[ 0 ] = 0;
+	_tileOrigin[ 1 ] = 0;
+	_tileOrigin[ 2 ] = 0;
+}
+
+/******************************************************************************
+ * Destructor
+ ******************************************************************************/
+GvxVoxelizerEngine::~GvxVoxelizerEngine()
+{
+	// Close the data structure if the voxelization has not been finalized
+	closeDataStructure();
+
+	GvxTextureCache::get().release( _texture );
+}
+
+/******************************************************************************
+ * Initialize the voxelizer
+ *
+ * Call before voxelization
+ *
+ * @param pLevel Max level of resolution
+ * @param pBrickWidth Width a brick
+ * @param pName Filename to be processed
+ * @param pDataType Data type that will be processed
+ ******************************************************************************/
+void GvxVoxelizerEngine::init( int pLevel, int pBrickWidth, const std::string& pName, GvxDataTypeHandler::VoxelDataType pDataType )
+{
+	// Store initialization values
+	setup( pLevel, pBrickWidth, pName, pDataType );
+
+	// Tile voxelization : partial data is written in its own files
+	_writeIndex = 0;
+	_tileNodeWrites.clear();
+	if ( _tileSize > 0 )
+	{
+		_fileName = GvxTileMerger::getTileName( pName, _tileOrigin );
+	}
+
+	// Create a file/streamer handler to read/write GigaVoxels data
+	_dataStructureIOHandler = new GvxDataStructureIOHandler( _fileName, _level, _brickWidth, _dataTypes, true, getBorderSize() );
+}
+
+/******************************************************************************
+ * Set the data structure parameters without creating its files.
+ *
+ * Call instead of init() to run the post-voxelization stages
+ * (borders, filter, mipmap) on previously voxelized data.
+ *
+ * @param pLevel Max level of resolution
+ * @param pBrickWidth Width a brick
+ * @param pName Filename to be processed
+ * @param pDataType Data type that will be processed
+ ******************************************************************************/
+void GvxVoxelizerEngine::setup( int pLevel, int pBrickWidth, const std::string& pName, GvxDataTypeHandler::VoxelDataType pDataType )
+{
+	// Store initialization values
+	_level = pLevel;
+	_brickWidth = pBrickWidth;
+	_fileName = pName;
+
+	// Handle data types to process
+	_dataTypes.clear();
+	_dataTypes.push_back( pDataType );
+
+	if (_normals)
+	{
+		_dataTypes.push_back( Gvx::GvxDataTypeHandler::gvHALF4 );
+	}
+}
+
+/******************************************************************************
+ * Set The number of times we apply the filter
+ ******************************************************************************/
+void GvxVoxelizerEngine::setNbFilterApplications(int pValue)
+{
+	_nbFilterApplications = pValue;
+}
+
+/******************************************************************************
+ * Set the type of the filter
+ * 0 = mean
+ * 1 = gaussian
+ * 2 = laplacian
+ ******************************************************************************/
+void GvxVoxelizerEngine::setFilterType (int pValue)
+{
+	_filterType = pValue;
+}
+
+/******************************************************************************
+ * Set the _normals value
+ ******************************************************************************/
+void GvxVoxelizerEngine::setNormals( bool value)
+{
+	_normals=value;
+}
+
+/******************************************************************************
+ * Set the flag telling wheter or not bricks are stored without borders.
+ * Bricks of all levels are then written with their interior voxels only
+ * and borders are never computed (they are reconstructed at load time from neighbor bricks).
+ *
+ * @param pFlag the borderless flag
+ ******************************************************************************/
+void GvxVoxelizerEngine::setBorderless( bool pFlag )
+{
+	_isBorderless = pFlag;
+}
+
+/******************************************************************************
+ * Tell wheter or not bricks are stored without borders
+ *
+ * @return the borderless flag
+ ******************************************************************************/
+bool GvxVoxelizerEngine::isBorderless() const
+{
+	return _isBorderless;
+}
+
+/******************************************************************************
+ * Get the border size of bricks in data structure files
+ *
+ * @return 0 for borderless bricks, 1 otherwise
+ ******************************************************************************/
+unsigned int GvxVoxelizerEngine::getBorderSize() const
+{
+	return _isBorderless ? 0 : 1;
+}
+
+/******************************************************************************
+ * Set the number of threads used to generate the mip-map levels (1 by default).
+ * With several threads, nodes are processed by batches (see setMemorySize()).
+ *
+ * @param pValue the number of threads
+ ******************************************************************************/
+void GvxVoxelizerEngine::setNbThreads( unsigned int pValue )
+{
+	_nbThreads = std::max( pValue, 1U );
+}
+
+/******************************************************************************
+ * Set the max memory size used to generate a mip-map level with several threads.
+ * A batch of coarser nodes is held in memory along with the bricks of their children.
+ *
+ * @param pSize the memory size (in bytes)
+ ******************************************************************************/
+void GvxVoxelizerEngine::setMemorySize( size_t pSize )
+{
+	_memorySize = pSize;
+}
+
+/******************************************************************************
+ * Finalize the voxelizer
+ *
+ * Call after voxelization
+ ******************************************************************************/
+void GvxVoxelizerEngine::end()
+{
+	// Normalize normals (if activated)
+	// normalize();
+
+	// Compute borders (this will be done for the last level of resolution)
+	updateBorders();
+
+	// delete file/streamer handler
+	closeDataStructure();
+
+	// apply a smoothing filter
+	applyFilter();
+
+	// Mipmap data
+	mipmap();
+
+	// Node summaries of all levels
+	generateSummaries();
+}
+
+/******************************************************************************
+ * Store a 3D position in the vertex buffer.
+ * During voxelization, each triangle attribute is stored.
+ * Due to kind of circular buffer technique, calling setVertex() method on each vertex
+ * of a triangle, register each position internally.
+ *
+ * @param pX x coordinate
+ * @param pY y coordinate
+ * @param pZ z coordinate
+ ******************************************************************************/
+void GvxVoxelizerEngine::setVertex( float pX, float pY, float pZ )
+{
+	// Update circular vertex buffer
+	memcpy( _v1, _v2, 3 * sizeof( float ) );
+	memcpy( _v2, _v3, 3 * sizeof( float ) );
+
+	// Store 3D position
+	_v3[ 0 ] = pX;
+	_v3[ 1 ] = pY;
+	_v3[ 2 ] = pZ;
+}
+
+/******************************************************************************
+ * Store a color in the color buffer.
+ * During voxelization, each triangle attribute is stored.
+ * Due to kind of circular buffer technique, calling setColor() method on each vertex
+ * of a triangle, register each color internally.
+ *
+ * @param pR red color component
+ * @param pG green color component
+ * @param pB blue color component
+ ******************************************************************************/
+void GvxVoxelizerEngine::setColor( float pR, float pG, float pB )
+{
+	// Update circular color buffer
+	memcpy( _c1, _c2, 3 * sizeof( float ) );
+	memcpy( _c2, _c3, 3 * sizeof( float ) );
+
+	// Store color
+	_c3[ 0 ] = pR;
+	_c3[ 1 ] = pG;
+	_c3[ 2 ] = pB;
+}
+
+/******************************************************************************
+ * Store a texture coordinates in the texture coordinates buffer.
+ * During voxelization, each triangle attribute is stored.
+ * Due to kind of circular buffer technique, calling setTexCoord() method on each vertex
+ * of a triangle, register each texture coordinate internally.
+ *
+ * @param pR r texture coordinate
+ * @param pS s texture coordinate
+ ******************************************************************************/
+void GvxVoxelizerEngine::setTexCoord( float pR, float pS )
+{
+	// Update circular texture coordinates buffer
+	memcpy( _t1, _t2, 2 * sizeof( float ) );
+	memcpy( _t2, _t3, 2 * sizeof( float ) );
+
+	// Store texture coordinates
+	_t3[ 0 ] = pR;
+	_t3[ 1 ] = pS;
+}
+
+/******************************************************************************
+ * Store a normal in the buffer of normals.
+ * During voxelization, each triangle attribute is stored.
+ * Due to kind of circular buffer technique, calling setNormal() method on each vertex
+ * of a triangle, register each normal internally.
+ *
+ * @param pX x normal component
+ * @param pY y normal component
+ * @param pZ z normal component
+ ******************************************************************************/
+void GvxVoxelizerEngine::setNormal( float pX, float pY, float pZ )
+{
+	// Update circular buffer of normals
+	memcpy( _n1, _n2, 3 * sizeof( float ) );
+	memcpy( _n2, _n3, 3 * sizeof( float ) );
+
+	// Store normal
+	_n3[ 0 ] = pX;
+	_n3[ 1 ] = pY;
+	_n3[ 2 ] = pZ;
+
+	// float length = sqrtf(pX * pX + pY * pY + pZ * pZ);
+	// float normalized[3] = {abs(pX)/length, abs(pY)/length, abs(pZ)/length};
+	// _n3[ 0 ] = normalized[0];
+	// _n3[ 1 ] = normalized[1];
+	// _n3[ 2 ] = normalized[2];
+}
+
+/******************************************************************************
+ * Set the current texture from an image file.
+ * Textures are retrieved from the texture cache (loaded only once, then shared).
+ *
+ * @param pFilename the image filename
+ ******************************************************************************/
+void GvxVoxelizerEngine::setTexture( const std::string& pFilename )
+{
+	_textureName = pFilename;
+
+	// Release the previous texture
+	GvxTextureCache::get().release( _texture );
+	_texture = NULL;
+
+	// Texture data is not needed while triangles are only compared (incremental update)
+	if ( _incrementalStage != eFullVoxelization && _incrementalStage != eUpdateDirtyNodes )
+	{
+		return;
+	}
+
+	_texture = GvxTextureCache::get().acquire( pFilename );
+}
+
+unsigned short float2HalfInUshort (float f) {
+
+	// if (abs(f)<0.001)
+	// 	return (unsigned short)(0);
+	unsigned int a = *((unsigned int *)(&f)); // reinterpret cast
+	unsigned int s = (a & 0x80000000); // isolating sign
+	s= s>>16; // moving it to match a 16 bits number
+	unsigned short ss = (unsigned short)(s); // casting
+
+	unsigned int exp = (a & 0x7FFFFFFF) >> 23; // masking the bit and removing mantissa
+
+	exp = (exp+15)-127; // Decentring the exponent of the 8 bit space, recentering it on a 5 bit space
+	exp  = exp<<10;
+	unsigned short exps = (unsigned short)(exp); // casting
+	unsigned int mantissa = (a & 0x007FFFFF ) >> 13 ; // isolating matissa and removing 13 lights bits
+	unsigned short mantissas = (unsigned short)(mantissa); // casting
+
+	return ss | exps | mantissas; // Concatenation
+
+
+}
+
+float halfInUshort2Float (unsigned short u) {
+
+	if (u==0)
+		return 0.f;
+	unsigned short s = (u & 0x8000); // isolating sign
+	unsigned int si = (unsigned int)(s); // casting
+	si = si<<16; // shifting to its proper place
+	unsigned short exp = (u & 0x7FFF) >> 10;   // isolating exposant
+	unsigned int expi = (unsigned int)(exp);   // casting
+	expi = (expi+127)-15;   // decentring on the 5 bits scale, recentring on a 8 bit scale
+	expi = expi<<23;      // shifting to its position, after mantissa
+
+	unsigned short mantissa = (u & 0x03FF );     // isolating mantissa
+	unsigned int mantissai = (unsigned int)(mantissa);   // casting
+	mantissai = mantissai<<13;    // replacing by zero padding
+
+	unsigned int ret = si | expi | mantissai;  // concatenation
+	return * ((float *)(&ret));     // reinterpret cast
+
+}
+
+
+/******************************************************************************
+ * Voxelize a triangle.
+ *
+ * Given vertex attributes previously set for a triangle (positions, normals,
+ * colors and texture coordinates), it voxelizes triangle (by writing data).
+ ******************************************************************************/
+void GvxVoxelizerEngine::voxelizeTriangle()
+{
+	// Handle incremental update stages
+	switch ( _incrementalStage )
+	{
+		case eRegisterTriangles:
+			_triangleSignatures.push_back( getTriangleSignature() );
+			return;
+
+		case eMarkAddedTriangles:
+			if ( ! consumeTriangleSignature( getTriangleSignature() ) )
+			{
+				markTriangle();
+			}
+			return;
+
+		case eMarkRemovedTriangles:
+			if ( consumeTriangleSignature( getTriangleSignature() ) )
+			{
+				markTriangle();
+			}
+			return;
+
+		case eUpdateDirtyNodes:
+			if ( ! isTriangleDirty() )
+			{
+				return;
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	// Compute length of each border of the current triangle
+	float length1 = sqrtf( ( _v1[0] - _v2[0] ) * ( _v1[0] - _v2[0] ) + ( _v1[1] - _v2[1] ) * ( _v1[1] - _v2[1] ) + ( _v1[2] - _v2[2] ) * ( _v1[2] - _v2[2] ) );
+	float length2 = sqrtf( ( _v1[0] - _v3[0] ) * ( _v1[0] - _v3[0] ) + ( _v1[1] - _v3[1] ) * ( _v1[1] - _v3[1] ) + ( _v1[2] - _v3[2] ) * ( _v1[2] - _v3[2] ) );
+	float length3 = sqrtf( ( _v2[0] - _v3[0] ) * ( _v2[0] - _v3[0] ) + ( _v2[1] - _v3[1] ) * ( _v2[1] - _v3[1] ) + ( _v2[2] - _v3[2] ) * ( _v2[2] - _v3[2] ) );
+
+	// Compute the tesselation value
+	// (.i.e how many voxels can be put in the largest length of the triangle borders)
+	float length = std::max< float >( length1, std::max< float >( length2, length3 ) );
+	int tesselation = static_cast< int >( length / _dataStructureIOHandler->getVoxelSize() ) + 1;
+
+	// Tile voxelization : triangles outside the tile are skipped,
+	// their writes are only counted to keep the same write order as a single process
+	if ( _tileSize > 0 && ! isTriangleInTile() )
+	{
+		_writeIndex += static_cast< unsigned long long >( tesselation ) * static_cast< unsigned long long >( tesselation ) * 8;
+
+		return;
+	}
+
+	// Compute the texture footprint of a voxel, i.e. the distance between two samples
+	// in texture space, to select the mip-map level of the texture
+	float textureFootprint = 0.f;
+	if ( _useTexture && _texture != NULL )
+	{
+		const float uvLength1 = sqrtf( ( _t1[0] - _t2[0] ) * ( _t1[0] - _t2[0] ) + ( _t1[1] - _t2[1] ) * ( _t1[1] - _t2[1] ) );
+		const float uvLength2 = sqrtf( ( _t1[0] - _t3[0] ) * ( _t1[0] - _t3[0] ) + ( _t1[1] - _t3[1] ) * ( _t1[1] - _t3[1] ) );
+		const float uvLength3 = sqrtf( ( _t2[0] - _t3[0] ) * ( _t2[0] - _t3[0] ) + ( _t2[1] - _t3[1] ) * ( _t2[1] - _t3[1] ) );
+		textureFootprint = std::max< float >( uvLength1, std::max< float >( uvLength2, uvLength3 ) ) / static_cast< float >( tesselation );
+	}
+
+	// Iterate through voxels
+	for ( int i = 0; i < tesselation; ++i )
+	for ( int j = 0; j < tesselation; ++j )
+	{
+		// Vertex, color and normal variables
+		float v[ 3 ];
+		float c[ 3 ];
+		float n[ 3 ];
+
+
+		// Compute weights associated to vertices (barycentric coordinates)
+		float w1 = i / static_cast< float >( tesselation );
+		float w2 = (1.0f - w1) * j / static_cast< float >( tesselation );
+		float w3 = 1.0f - w1 - w2;
+
+		// Compute weighted position (barycentric coordinates)
+		v[0] = w1 * _v1[0] + w2 * _v2[0] + w3 * _v3[0];
+		v[1] = w1 * _v1[1] + w2 * _v2[1] + w3 * _v3[1];
+		v[2] = w1 * _v1[2] + w2 * _v2[2] + w3 * _v3[2];
+
+		// Compute color
+		if ( _useTexture && _texture != NULL )
+		{
+			// Compute weighted texture coordinates
+			float t[2];
+			t[0] = w1 * _t1[0] + w2 * _t2[0] + w3 * _t3[0];
+			t[1] = w1 * _t1[1] + w2 * _t2[1] + w3 * _t3[1];
+
+			// Handle negative texture coordinates
+			t[0] = ( t[0] >= 0.0f ) ? t[0] : t[0] - floor( t[0] );
+			t[1] = ( t[1] >= 0.0f ) ? t[1] : t[1] - floor( t[1] );
+
+			// Sample texture at the mip-map level matching the voxel footprint
+			float texel[ 4 ];
+			_texture->sample( t[0], t[1], textureFootprint, texel );
+			c[0] = texel[0];
+			c[1] = texel[1];
+			c[2] = texel[2];
+		}
+		else
+		{
+			// Compute weighted colors
+			c[0] = w1 * _c1[0] + w2 * _c2[0] + w3 * _c3[0];
+			c[1] = w1 * _c1[1] + w2 * _c2[1] + w3 * _c3[1];
+			c[2] = w1 * _c1[2] + w2 * _c2[2] + w3 * _c3[2];
+			// c[0] = 0.5f;
+			// c[1] = 0.5f;
+			// c[2] = 0.5f;
+		}
+
+		// TO DO
+		// WARNING : question ==> Why "unsigned char" ? This should be the type of GvxDataTypeHandler specified by the user ?
+		// ...
+		// color data uchar4
+		unsigned char voxelData[4];
+		voxelData[0] = static_cast< unsigned char >( c[0] * 255.f ); // Red
+		voxelData[1] = static_cast< unsigned char >( c[1] * 255.f ); // Green
+		voxelData[2] = static_cast< unsigned char >( c[2] * 255.f ); // Blue
+		voxelData[3] = 255; // Alpha
+
+		unsigned short normalData[4];
+		if (_normals)
+		{
+			// Compute weighted normals
+			n[0] = w1 * _n1[0] + w2 * _n2[0] + w3 * _n3[0];
+			n[1] = w1 * _n1[1] + w2 * _n2[1] + w3 * _n3[1];
+			n[2] = w1 * _n1[2] + w2 * _n2[2] + w3 * _n3[2];
+			//Compute normal as cross product manually...
+			// const float e1[3] = {_v2[0] - _v1[0], _v2[1] - _v1[1], _v2[2] - _v1[2]};
+			// const float e2[3] = {_v3[0] - _v2[0], _v3[1] - _v2[1], _v3[2] - _v2[2]};
+			// n[0] = e1[1]*e2[2] - e1[2]*e2[1];
+			// n[1] = e1[2]*e2[0] - e1[0]*e2[2];
+			// n[2] = e1[0]*e2[1] - e1[1]*e2[0];
+			// const float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			// n[0] /= length;
+			// n[1] /= length;
+			// n[2] /= length;
+			// n[0] = (n[0] < 0 ? -n[0] : n[0]);
+			// n[1] = (n[1] < 0 ? -n[1] : n[1]);
+			// n[2] = (n[2] < 0 ? -n[2] : n[2]);
+
+			// std::cout << n[0] << ";" << n[1] << ";" << n[2] << ";" << std::endl;
+			// normal data uchar4
+
+			normalData[0] = float2HalfInUshort( n[0] ); // normal x
+			// normalData[0] = float2HalfInUshort( n[0] ); // normal x
+			/*if (abs(n[0] - halfInUshort2Float( float2HalfInUshort( n[0] )) ) >1.f)
+				printf ("%f != %f\n",n[0],halfInUshort2Float( float2HalfInUshort( n[0] )));*/
+
+			normalData[1] = float2HalfInUshort( n[1] );
+			// normalData[1] = float2HalfInUshort( n[1] ); // normal y
+			/*if (abs(n[1] - halfInUshort2Float( float2HalfInUshort( n[1] )) ) >1.f)
+				printf ("%f != %f\n",n[1],halfInUshort2Float( float2HalfInUshort( n[1] )));*/
+
+			normalData[2] = float2HalfInUshort( n[2] );
+			// normalData[2] = float2HalfInUshort( n[2] ); // normal z
+			/*if (abs(n[2] - halfInUshort2Float( float2HalfInUshort( n[2] )) ) >1.f)
+				printf ("%f != %f\n",n[2],halfInUshort2Float( float2HalfInUshort( n[2] )));*/
+
+			normalData[3] = 1; // flag as non-empty
+		}
+
+		// Retrieve voxel positions in octree
+		unsigned int voxelPos[3];
+		unsigned int voxelPosInBrick[3];
+		_dataStructureIOHandler->getVoxelPosition( v, voxelPos );
+		_dataStructureIOHandler->getVoxelPositionInBrick( v, voxelPosInBrick );
+
+		// Splat in octree with 2 voxels width
+		for ( int z = 0; z <= 1; ++z )
+		for ( int y = 0; y <= 1; ++y )
+		for ( int x = 0; x <= 1; ++x )
+		{
+			unsigned int voxelPos2[3];
+
+			// The splat stays in the brick : it grows inwards from the first voxel of a brick (after its border)
+			const unsigned int borderSize = _dataStructureIOHandler->_borderSize;
+			voxelPos2[0] = ( voxelPosInBrick[0] == borderSize ) ? voxelPos[0] + x : voxelPos[0] - x;
+			voxelPos2[1] = ( voxelPosInBrick[1] == borderSize ) ? voxelPos[1] + y : voxelPos[1] - y;
+			voxelPos2[2] = ( voxelPosInBrick[2] == borderSize ) ? voxelPos[2] + z : voxelPos[2] - z;
+
+			// During an incremental update, only dirty nodes are written
+			if ( _incrementalStage == eUpdateDirtyNodes && ! isDirtyVoxel( voxelPos2 ) )
+			{
+				continue;
+			}
+
+			// Tile voxelization : only nodes of the tile are written,
+			// the first write of each node is recorded to order bricks when tiles are merged
+			if ( _tileSize > 0 )
+			{
+				const unsigned long long writeIndex = _writeIndex++;
+				if ( ! isTileVoxel( voxelPos2 ) )
+				{
+					continue;
+				}
+
+				unsigned int nodePos[ 3 ];
+				nodePos[ 0 ] = voxelPos2[ 0 ] / _brickWidth;
+				nodePos[ 1 ] = voxelPos2[ 1 ] / _brickWidth;
+				nodePos[ 2 ] = voxelPos2[ 2 ] / _brickWidth;
+				_tileNodeWrites.insert( std::make_pair( _dataStructureIOHandler->getNodeIndex( nodePos ), writeIndex ) );
+			}
+
+			// Set voxel data
+			_dataStructureIOHandler->setVoxel( voxelPos2, voxelData, 0 );
+
+			if (_normals)
+			{
+				// Set voxel normal
+				_dataStructureIOHandler->setVoxel( voxelPos2, normalData, 1 );
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * Apply the update borders algorithmn.
+ * Fill borders with data.
+ ******************************************************************************/
+void GvxVoxelizerEngine::updateBorders()
+{
+	// Borderless bricks have no border to fill
+	if ( _isBorderless )
+	{
+		return;
+	}
+
+	// Reopen the data structure if it has already been closed (i.e. resumed voxelization)
+	const bool isOpen = ( _dataStructureIOHandler != NULL );
+	if ( ! isOpen )
+	{
+		_dataStructureIOHandler = new GvxDataStructureIOHandler( _fileName, _level, _brickWidth, _dataTypes, false, getBorderSize() );
+	}
+
+	std::cout << "GvxVoxelizerEngine::updateBorders : level : " << _dataStructureIOHandler->_level << std::endl;
+	_dataStructureIOHandler->computeBorders();
+
+	if ( ! isOpen )
+	{
+		closeDataStructure();
+	}
+}
+
+/******************************************************************************
+ * Close the data structure of the max level of resolution,
+ * so that its files are written on disk.
+ ******************************************************************************/
+void GvxVoxelizerEngine::closeDataStructure()
+{
+	delete _dataStructureIOHandler;
+	_dataStructureIOHandler = NULL;
+}
+
+/******************************************************************************
+ * Apply the normalize algorithmn
+ ******************************************************************************/
+void GvxVoxelizerEngine::normalize()
+{
+	if (_normals)
+	{
+		unsigned short* brick1 = new unsigned short[ 4 * _dataStructureIOHandler->_brickSize ];
+
+		// Iterate through nodes
+		unsigned int nodePos[ 3 ];
+		for ( nodePos[2] = 0; nodePos[2] < _dataStructureIOHandler->_nodeGridSize; ++nodePos[2] )
+		for ( nodePos[1] = 0; nodePos[1] < _dataStructureIOHandler->_nodeGridSize; ++nodePos[1] )
+		for ( nodePos[0] = 0; nodePos[0] < _dataStructureIOHandler->_nodeGridSize; ++nodePos[0] )
+		{
+			// If node is empty, continue
+			unsigned int node = _dataStructureIOHandler->getNode( nodePos );
+			if ( GvxDataStructureIOHandler::isEmpty( node ) )
+			{
+				continue;
+			}
+
+			// Get brick data for channel normals (stored in the second channel)
+			_dataStructureIOHandler->getBrick( nodePos, brick1, 1 );
+
+			// Iterate through brick voxels and process them
+			for ( unsigned int voxel = 0; voxel < _dataStructureIOHandler->_brickSize; voxel++ )
+			{
+				// If flag empty
+				if ( brick1[ 4 * voxel + 3 ] == 0 )
+				{
+					// Set normal components to 0		// TO DO => QUESTION : what's that ??
+					brick1[ 4 * voxel + 0 ] = 128;
+					brick1[ 4 * voxel + 1 ] = 128;
+					brick1[ 4 * voxel + 2 ] = 128;
+				}
+				// Set flag empty to 0
+				brick1[ 4 * voxel + 3 ] = 0;
+			}
+
+			// Set brick data
+			_dataStructureIOHandler->setBrick( nodePos, brick1, 1 );
+		}
+
+		delete [] brick1;
+	}
+}
+
+// Helper function to have more accurate type casts (because static_cast<unsigned char>(f) always return the floor value of f)
+unsigned char float2uchar(float a) {
+	return  static_cast<unsigned char>(a+0.5f);
+}
+
+
+#define FILTER 1          // the half-tchickness of the 3D kernel
+#define SIGMA FILTER      // the sigma of the gaussian
+#define DIM (FILTER*2+1)  // the dimension of the full kernel
+#define SIZE (DIM*DIM*DIM)// the total num of elements of the kernel
+
+// Different functions for filtering
+float identity(float x)
+{
+	return 1;
+}
+float gaussian(float x)
+{
+	return exp(-(x*x)/(2*SIGMA*SIGMA)); // gaussian evaluation;
+}
+float laplacian(float x)
+{
+	return 1;
+}
+
+/******************************************************************************
+ * Apply the filtering algorithm
+ *
+ * Borderless bricks are filtered in new files at each pass, the neighborhood of voxels
+ * being read in the neighbor bricks of the previous pass. Empty nodes in which the data
+ * of their neighbors spreads are created (as computeBorders() does for bricks with borders).
+ ******************************************************************************/
+void GvxVoxelizerEngine::applyFilter()
+{
+	//Retrieving the IO Handler
+	GvxDataStructureIOHandler* dataStructureIOHandlerUP = new GvxDataStructureIOHandler( _fileName, _level, _brickWidth, _dataTypes, false, getBorderSize() );
+
+	// Borderless bricks are written in the files of the filtered data, then renamed
+	GvxDataStructureIOHandler* dataStructureIOHandlerFiltered = NULL;
+	const std::string filteredFileName = _fileName + "_filtered";
+
+	// Defining the blurring kernel
+	float kernel[SIZE] ;  // The gaussian/laplacian/mean kernel
+	float sum = 0;		  // The sum of all the coefficients of the gaussian kernel
+
+	// Choosing the appropriate function for the kernel
+	printf ("Applying a ");
+	float (*filter)(float);
+	switch (_filterType)
+	{
+	case 0:
+		printf ("mean ");
+		filter = &identity;
+		break;
+	case 1:
+		printf ("gaussian ");
+		filter = &gaussian;
+		break;
+	case 2:
+		printf ("laplacian ");
+		filter = &laplacian;
+		break;
+	default:
+		printf ("default (mean) but how did you get in here ? ");
+		filter = &identity;
+		break;
+	}
+	printf ("Filter %d times...\n",_nbFilterApplications);
+
+	// filling the filter with the function evaluated at each point of the kernel
+	for (int i = -FILTER;i<=FILTER;i++)
+	for (int j = -FILTER;j<=FILTER;j++)
+	for (int k = -FILTER;k<=FILTER;k++)
+	{
+		// x is the disance to the center of the kernel
+		float x = sqrtf(i*i+j*j+k*k); // distance to center of the kernel
+		// y is f(x) , the value to assign in the kernel (f = 1D function)
+		float y = filter(x);
+		// linearization of the kernel (no matter the order, it's symetric)
+		kernel[(i+FILTER)*DIM*DIM+(j+FILTER)*DIM+(k+FILTER)] = y ;
+		// builfing the local sum to be able to normalize later on
+		sum+=y;
+	}
+
+	// The data of the grid with a neighborhood corresponding to the kernel size
+	unsigned char voxelDataTotal[SIZE][4] ;
+	unsigned short voxelNormalTotal[SIZE][4] ;
+
+	unsigned char voxelData[ 4 ];
+	unsigned char voxelDataTemp[ 4 ];
+
+	unsigned short voxelNormal[ 4 ];
+	unsigned short voxelNormalTemp[ 4 ];
+
+	unsigned int nodePos[ 3 ];
+
+	// We load the data brick per brick for now
+	// WARNING, this forces the kernel to be 3*3*3 only because we can anly use the borders to make the convolution
+	unsigned char  * voxelDataBrick;// [4000];        // WARNING, 4000 HARDCODED and unsigned char : (_brickWidth + bordersize*2) * dataTypeSize (8 + 1*2)*4
+	// the backup array is the array in which we store the convolution results (at the end we do a kind of swapArrays).
+	unsigned char  * voxelDataBrickBackup;// [4000];  // WARNING, 4000 HARDCODED and unsigned char : (_brickWidth + bordersize*2) * dataTypeSize (8 + 1*2)*4
+
+	unsigned short  * voxelNormalBrick;// [4000];      // WARNING, 4000 HARDCODED and unsigned char : (_brickWidth + bordersize*2) * dataTypeSize (8 + 1*2)*4
+	unsigned short *  voxelNormalBrickBackup;// [4000];// WARNING, 4000 HARDCODED and unsigned char : (_brickWidth + bordersize*2) * dataTypeSize (8 + 1*2)*4
+
+	voxelDataBrick = new unsigned char[4 * (_brickWidth+2)*(_brickWidth+2)*(_brickWidth+2)] ;
+	voxelDataBrickBackup = new unsigned char[4 * (_brickWidth+2)*(_brickWidth+2)*(_brickWidth+2)] ;
+
+	if (_normals)
+	{
+		voxelNormalBrick = new unsigned short[4 * (_brickWidth+2)*(_brickWidth+2)*(_brickWidth+2)] ;
+		voxelNormalBrickBackup = new unsigned short[4 * (_brickWidth+2)*(_brickWidth+2)*(_brickWidth+2)] ;
+	}
+
+	// Interior voxels of a filtered brick (borderless bricks)
+	std::vector< unsigned char > voxelDataInterior( _isBorderless ? 4 * _brickWidth * _brickWidth * _brickWidth : 0 );
+	std::vector< unsigned short > voxelNormalInterior( _isBorderless && _normals ? 4 * _brickWidth * _brickWidth * _brickWidth : 0 );
+
+	// We may have to apply successively many times the filter (to emulate a bigger blur)
+	for (int var = 0; var<_nbFilterApplications ; var++)
+	{
+		if ( _isBorderless )
+		{
+			dataStructureIOHandlerFiltered = new GvxDataStructureIOHandler( filteredFileName, _level, _brickWidth, _dataTypes, true, 0 );
+		}
+
+		// for all the nodes of the grid
+		for ( nodePos[2] = 0; nodePos[2] < dataStructureIOHandlerUP->_nodeGridSize; nodePos[2]++ )
+		for ( nodePos[1] = 0; nodePos[1] < dataStructureIOHandlerUP->_nodeGridSize; nodePos[1]++ )
+		for ( nodePos[0] = 0; nodePos[0] < dataStructureIOHandlerUP->_nodeGridSize; nodePos[0]++ )
+		{
+			//// Retrieve the current node info
+			unsigned int node = dataStructureIOHandlerUP->getNode( nodePos );
+
+			if ( _isBorderless )
+			{
+				// Get the brick with the borders taken from its neighbors
+				dataStructureIOHandlerUP->getBrickWithBorders( nodePos, voxelDataBrick, 0 );
+
+				// An empty node is only blurred if the data of a neighbor spreads in it
+				if ( GvxDataStructureIOHandler::isEmpty( node ) )
+				{
+					bool isDataSpread = false;
+					for ( unsigned int voxel = 0; voxel < (_brickWidth+2)*(_brickWidth+2)*(_brickWidth+2) && ! isDataSpread; voxel++ )
+					{
+						isDataSpread = ( voxelDataBrick[ 4 * voxel + 3 ] != 0 );
+					}
+					if ( ! isDataSpread )
+					{
+						continue;
+					}
+				}
+
+				if (_normals)
+				{
+					dataStructureIOHandlerUP->getBrickWithBorders( nodePos, voxelNormalBrick, 1 );
+				}
+			}
+			else
+			{
+				//// If node is empty no need to blur, go to next node
+				if ( GvxDataStructureIOHandler::isEmpty( node ) )
+				{
+					continue;
+				}
+
+				// If not empty, get the brick from file and store it in memory
+				dataStructureIOHandlerUP->getBrick(nodePos,voxelDataBrick,0);
+				if (_normals)
+				{
+					dataStructureIOHandlerUP->getBrick(nodePos,voxelNormalBrick,1);
+				}
+			}
+
+			// We will now iterate through voxels of the current node and apply the kernel on their neighborhood
+			unsigned int voxelPos[ 3 ];
+			unsigned int voxelPos2[ 3 ];
+
+			// For all the voxels of the brick WITHOUT THE BORDER !
+			for ( voxelPos[ 2 ] =1; voxelPos[ 2 ] < (_brickWidth)+2-1; voxelPos[ 2 ] +=1 )
+			for ( voxelPos[ 1 ] =1; voxelPos[ 1 ] < (_brickWidth)+2-1; voxelPos[ 1 ] +=1 )
+			for ( voxelPos[ 0 ] =1; voxelPos[ 0 ] < (_brickWidth)+2-1; voxelPos[ 0 ] +=1 )
+			{
+
+				// Retrieve the data of the neighborhood of the voxel ( 27 values for a kernel of 3*3*3)
+				for (int i = -FILTER;i<=FILTER;i++)
+				for (int j = -FILTER;j<=FILTER;j++)
+				for (int k = -FILTER;k<=FILTER;k++)
+				{
+					// Compute the position of the neighbor
+					voxelPos2[0] = voxelPos[0]+i;voxelPos2[1] = voxelPos[1]+j;voxelPos2[2] = voxelPos[2]+k;
+
+					// Linearize it to get an index in the brickData pool
+					unsigned int deb =  voxelPos2[0]*10*10*4 + voxelPos2[1]*10*4 + voxelPos2[2]*4;    // Warning HARDCODED 10 = _brickWidth + 2*borderSize
+					// retrieve the data from the brick
+					voxelDataTemp[0] = voxelDataBrick[deb];
+					voxelDataTemp[1] = voxelDataBrick[deb+1];
+					voxelDataTemp[2] = voxelDataBrick[deb+2];
+					voxelDataTemp[3] = voxelDataBrick[deb+3];
+
+					// Store it in the neighborhood matrix
+					voxelDataTotal[(i+FILTER)*DIM*DIM+(j+FILTER)*DIM+(k+FILTER)][0] = voxelDataTemp[0];
+					voxelDataTotal[(i+FILTER)*DIM*DIM+(j+FILTER)*DIM+(k+FILTER)][1] = voxelDataTemp[1];
+					voxelDataTotal[(i+FILTER)*DIM*DIM+(j+FILTER)*DIM+(k+FILTER)][2] = voxelDataTemp[2];
+					voxelDataTotal[(i+FILTER)*DIM*DIM+(j+FILTER)*DIM+(k+FILTER)][3] = voxelDataTemp[3];
+
+					if (_normals)
+					{
+						// Same for normals
+						voxelNormalTemp[0] = voxelNormalBrick[deb];
+						voxelNormalTemp[1] = voxelNormalBrick[deb+1];
+						voxelNormalTemp[2] = voxelNormalBrick[deb+2];
+						voxelNormalTemp[3] = voxelNormalBrick[deb+3];
+						voxelNormalTotal[(i+FILTER)*DIM*DIM+(j+FILTER)*DIM+(k+FILTER)][0] = voxelNormalTemp[0];
+						voxelNormalTotal[(i+FILTER)*DIM*DIM+(j+FILTER)*DIM+(k+FILTER)][1] = voxelNormalTemp[1];
+						voxelNormalTotal[(i+FILTER)*DIM*DIM+(j+FILTER)*DIM+(k+FILTER)][2] = voxelNormalTemp[2];
+						voxelNormalTotal[(i+FILTER)*DIM*DIM+(j+FILTER)*DIM+(k+FILTER)][3] = voxelNormalTemp[3];
+					}
+
+				} // from now on voxelNormalTotal contains the 27 values of the neighboors of the voxel we are considering (the value of the voxel itself being in the center)
+
+
+				// Computing the convolution of the filter and the neighborhood
+				float temp = 0.f;
+				float sumNormal =0.f;
+				float sumColor =0.f;
+				float tempColor[3] = {0.f,0.f,0.f};
+				float tempNormal[3] = {0.f,0.f,0.f};
+
+				// For all the values of the 3*3*3 kernel (linearized)
+				for (int k = 0;k<SIZE;k++)
+				{
+					// make the convolution of the opacity (in float)
+					temp+= (static_cast<float>(voxelDataTotal[k][3])/255.f) * kernel[k];
+
+					// also make the convolution of normals and color , but only when opacity is not null (void has no color and no normal)
+					if (voxelDataTotal[k][3] !=0)
+					{
+						// Don't forget that the colors are premultiplied by the opacity so we have to demultiply them
+						tempColor[0]+= ((static_cast<float>(voxelDataTotal[k][0])/255.f)/(static_cast<float>(voxelDataTotal[k][3])/255.f))*kernel[k];
+						tempColor[1]+= ((static_cast<float>(voxelDataTotal[k][1])/255.f)/(static_cast<float>(voxelDataTotal[k][3])/255.f))*kernel[k];
+						tempColor[2]+= ((static_cast<float>(voxelDataTotal[k][2])/255.f)/(static_cast<float>(voxelDataTotal[k][3])/255.f))*kernel[k];
+						//building the local sum for color (can be different from the local sum of the kernel, because we skip the void elements)
+						sumColor +=   kernel[k];
+						if (_normals)
+						{
+							// converting the normals back in float
+							tempNormal[0]+= (halfInUshort2Float(voxelNormalTotal[k][0]))*kernel[k];
+							tempNormal[1]+= (halfInUshort2Float(voxelNormalTotal[k][1]))*kernel[k];
+							tempNormal[2]+= (halfInUshort2Float(voxelNormalTotal[k][2]))*kernel[k];
+							//building the local sum for normals (can be different from the local sum of the kernel, because we skip the void elements)
+							sumNormal +=  kernel[k];
+						}
+					}
+
+
+				} // end of the convolution
+
+				// we normalize the sums and transform everyone to uchar
+				float opacity = temp/sum;
+				voxelData[3] = float2uchar (opacity*255.f);
+
+				if (sumColor> 0)
+				{
+					// normalization + apha premultiplication + cast to uchar
+					voxelData[0] = float2uchar ((tempColor[0]*opacity/sumColor)*255.f);
+					voxelData[1] = float2uchar ((tempColor[1]*opacity/sumColor)*255.f);
+					voxelData[2] = float2uchar ((tempColor[2]*opacity/sumColor)*255.f);
+				}
+				else
+				{
+					voxelData[0] = float2uchar (0.f);
+					voxelData[1] = float2uchar (0.f);
+					voxelData[2] = float2uchar (0.f);
+				}
+
+				if (_normals)
+				{
+
+					if (sumNormal>0 )
+					{
+						// normalization
+						tempNormal[0] /= sumNormal;
+						tempNormal[1] /= sumNormal;
+						tempNormal[2] /= sumNormal;
+						float length= sqrtf(tempNormal[0]*tempNormal[0]+tempNormal[1]*tempNormal[1]+tempNormal[2]*tempNormal[2]);
+						if ( length> 0)
+						{
+							// normalization (in the sense of the normal) + apha premultiplication + cast to uchar
+							voxelNormal[0] = float2HalfInUshort ((tempNormal[0])/length);
+							voxelNormal[1] = float2HalfInUshort ((tempNormal[1])/length);
+							voxelNormal[2] = float2HalfInUshort ((tempNormal[2])/length);
+							voxelNormal[3] = 1;
+						}
+						else
+						{
+							voxelNormal[0] = float2HalfInUshort (0.f);
+							voxelNormal[1] = float2HalfInUshort (0.f);
+							voxelNormal[2] = float2HalfInUshort (0.f);
+							voxelNormal[3] = 0;
+						}
+					}
+					else
+					{
+						voxelNormal[0] = float2HalfInUshort (0.f);
+						voxelNormal[1] = float2HalfInUshort (0.f);
+						voxelNormal[2] = float2HalfInUshort (0.f);
+						voxelNormal[3] = 0;
+					}
+
+
+				}
+
+				// Storing the new data in the Brick data
+				unsigned int deb =  voxelPos[0]*10*10*4 + voxelPos[1]*10*4 + voxelPos[2]*4;  // Warning HARDCODED 10 = _brickWidth + 2*borderSize
+				voxelDataBrickBackup[deb] = voxelData[0];
+				voxelDataBrickBackup[deb+1] = voxelData[1];
+				voxelDataBrickBackup[deb+2] = voxelData[2];
+				voxelDataBrickBackup[deb+3] = voxelData[3];
+
+				if (_normals)
+				{
+					voxelNormalBrickBackup[deb] = voxelNormal[0];
+					voxelNormalBrickBackup[deb+1] = voxelNormal[1];
+					voxelNormalBrickBackup[deb+2] = voxelNormal[2];
+					voxelNormalBrickBackup[deb+3] = voxelNormal[3];
+
+				}
+
+			}
+
+			// Post pass to recopy the values from the backup array to the final array
+			for ( voxelPos[ 2 ] =1; voxelPos[ 2 ] < (_brickWidth)+2-1; voxelPos[ 2 ] +=1 )
+			for ( voxelPos[ 1 ] =1; voxelPos[ 1 ] < (_brickWidth)+2-1; voxelPos[ 1 ] +=1 )
+			for ( voxelPos[ 0 ] =1; voxelPos[ 0 ] < (_brickWidth)+2-1; voxelPos[ 0 ] +=1 )
+			{
+				// linearization of the index
+				unsigned int deb =  voxelPos[0]*10*10*4 + voxelPos[1]*10*4 + voxelPos[2]*4;  // Warning HARDCODED 10 = _brickWidth + 2*borderSize
+
+				voxelDataBrick[deb+3] = voxelDataBrickBackup[deb+3];
+				voxelDataBrick[deb] =  voxelDataBrickBackup[deb];
+				voxelDataBrick[deb+1] =  voxelDataBrickBackup[deb+1];
+				voxelDataBrick[deb+2] =  voxelDataBrickBackup[deb+2];
+
+
+				if (_normals)
+				{
+					voxelNormalBrick[deb] = voxelNormalBrickBackup[deb];
+					voxelNormalBrick[deb+1] = voxelNormalBrickBackup[deb+1];
+					voxelNormalBrick[deb+2] = voxelNormalBrickBackup[deb+2];
+					voxelNormalBrick[deb+3] = voxelNormalBrickBackup[deb+3];
+
+				}
+			}
+
+			// storing the modified brick
+			if ( _isBorderless )
+			{
+				// Only interior voxels are stored
+				const unsigned int width = _brickWidth + 2;
+				for ( unsigned int z = 0; z < _brickWidth; z++ )
+				for ( unsigned int y = 0; y < _brickWidth; y++ )
+				{
+					memcpy( &voxelDataInterior[ 4 * _brickWidth * ( y + _brickWidth * z ) ], &voxelDataBrick[ 4 * ( 1 + width * ( ( y + 1 ) + width * ( z + 1 ) ) ) ], 4 * _brickWidth * sizeof( unsigned char ) );
+					if (_normals)
+					{
+						memcpy( &voxelNormalInterior[ 4 * _brickWidth * ( y + _brickWidth * z ) ], &voxelNormalBrick[ 4 * ( 1 + width * ( ( y + 1 ) + width * ( z + 1 ) ) ) ], 4 * _brickWidth * sizeof( unsigned short ) );
+					}
+				}
+
+				// Writing one voxel creates the brick of the node, then its whole content is replaced
+				unsigned int voxelPos[ 3 ];
+				voxelPos[ 0 ] = nodePos[ 0 ] * _brickWidth;
+				voxelPos[ 1 ] = nodePos[ 1 ] * _brickWidth;
+				voxelPos[ 2 ] = nodePos[ 2 ] * _brickWidth;
+				unsigned char voxelDataZero[ 16 ];
+				memset( voxelDataZero, 0, sizeof( voxelDataZero ) );
+				dataStructureIOHandlerFiltered->setVoxel( voxelPos, voxelDataZero, 0 );
+				dataStructureIOHandlerFiltered->setBrick( nodePos, &voxelDataInterior[ 0 ], 0 );
+				if (_normals)
+				{
+					dataStructureIOHandlerFiltered->setBrick( nodePos, &voxelNormalInterior[ 0 ], 1 );
+				}
+			}
+			else
+			{
+				dataStructureIOHandlerUP->setBrick(nodePos,voxelDataBrick,0);
+				if (_normals)
+				{
+					dataStructureIOHandlerUP->setBrick(nodePos,voxelNormalBrick,1);
+				}
+			}
+		}
+
+		if ( _isBorderless )
+		{
+			// The filtered data replaces the data of the previous pass
+			delete dataStructureIOHandlerUP;
+			delete dataStructureIOHandlerFiltered;
+			dataStructureIOHandlerFiltered = NULL;
+
+			std::vector< std::string > fileNames;
+			std::vector< std::string > filteredFileNames;
+			fileNames.push_back( GvxDataStructureIOHandler::getFileNameNode( _fileName, _level, _brickWidth, 0 ) );
+			filteredFileNames.push_back( GvxDataStructureIOHandler::getFileNameNode( filteredFileName, _level, _brickWidth, 0 ) );
+			for ( unsigned int c = 0; c < _dataTypes.size(); ++c )
+			{
+				fileNames.push_back( GvxDataStructureIOHandler::getFileNameBrick( _fileName, _level, _brickWidth, c, GvxDataTypeHandler::getTypeName( _dataTypes[ c ] ), 0 ) );
+				filteredFileNames.push_back( GvxDataStructureIOHandler::getFileNameBrick( filteredFileName, _level, _brickWidth, c, GvxDataTypeHandler::getTypeName( _dataTypes[ c ] ), 0 ) );
+			}
+			for ( size_t i = 0; i < fileNames.size(); i++ )
+			{
+				remove( fileNames[ i ].c_str() );
+				if ( rename( filteredFileNames[ i ].c_str(), fileNames[ i ].c_str() ) != 0 )
+				{
+					std::cerr << "GvxVoxelizerEngine::applyFilter : unable to rename " << filteredFileNames[ i ] << std::endl;
+				}
+			}
+
+			dataStructureIOHandlerUP = new GvxDataStructureIOHandler( _fileName, _level, _brickWidth, _dataTypes, false, 0 );
+		}
+		else
+		{
+			// Recompute the borders to make them accord the new changes
+			dataStructureIOHandlerUP->computeBorders();
+		}
+
+	}
+
+	delete[] voxelDataBrick;
+	delete[] voxelDataBrickBackup;
+	if (_normals)
+	{
+		delete[] voxelNormalBrick;
+		delete[] voxelNormalBrickBackup;
+	}
+
+	// Destroy the data handler (this writes the filtered level on disk)
+	delete dataStructureIOHandlerUP;
+
+
+}
+
+
+/******************************************************************************
+ * Apply the mip-mapping algorithmn.
+ * Given a pre-filtered voxel scene at a given level of resolution,
+ * it generates a mip-map pyramid hierarchy of coarser levels (until 0).
+ ******************************************************************************/
+void GvxVoxelizerEngine::mipmap()
+{
+	// The mip-map pyramid hierarchy is built recursively from adjacent levels.
+	for ( int level = _level - 1; level >= 0; level-- )
+	{
+		mipmapLevel( level );
+	}
+}
+
+/******************************************************************************
+ * Generate one level of the mip-map pyramid hierarchy from the next finer level.
+ * Files of the generated level are written on disk when the method returns.
+ *
+ * @param pLevel level of resolution to generate (the finer level must exist)
+ ******************************************************************************/
+void GvxVoxelizerEngine::mipmapLevel( int pLevel )
+{
+	// Two files/streamers are used :
+	// UP is an already pre-filtered scene at resolution [ N ]
+	// DOWN is the coarser version to generate at resolution [ N - 1 ]
+
+	// Threads only handle uchar4 data with optional half4 normals (as mipmapNode())
+	if ( _nbThreads > 1 && _dataTypes[ 0 ] == GvxDataTypeHandler::gvUCHAR4 && _dataTypes.size() == ( _normals ? 2 : 1 ) )
+	{
+		mipmapLevelByBatches( pLevel );
+
+		return;
+	}
+
+	// LOG info
+	std::cout << "GvxVoxelizerEngine::mipmap : level : " << pLevel << std::endl;
+
+	GvxDataStructureIOHandler* dataStructureIOHandlerUP = new GvxDataStructureIOHandler( _fileName, pLevel + 1, _brickWidth, _dataTypes, false, getBorderSize() );
+
+	// The coarser data handler creates new files
+	GvxDataStructureIOHandler* dataStructureIOHandlerDOWN = new GvxDataStructureIOHandler( _fileName, pLevel, _brickWidth, _dataTypes, true, getBorderSize() );
+
+	// Iterate through nodes of the structure
+	unsigned int nodePos[ 3 ];
+	for ( nodePos[2] = 0; nodePos[2] < dataStructureIOHandlerUP->_nodeGridSize; nodePos[2]++ )
+	for ( nodePos[1] = 0; nodePos[1] < dataStructureIOHandlerUP->_nodeGridSize; nodePos[1]++ )
+	{
+		// LOG info
+		std::cout << "mipmap - LEVEL [ " << pLevel << " ] - Node [ " << "x" << " / " << nodePos[1] << " / " << nodePos[2] << " ] - " << dataStructureIOHandlerUP->_nodeGridSize << std::endl;
+
+	for ( nodePos[ 0 ] = 0; nodePos[ 0 ] < dataStructureIOHandlerUP->_nodeGridSize; nodePos[ 0 ]++ )
+	{
+		// Retrieve the current node info
+		unsigned int node = dataStructureIOHandlerUP->getNode( nodePos );
+
+		// If node is empty, go to next node
+		if ( GvxDataStructureIOHandler::isEmpty( node ) )
+		{
+			continue;
+		}
+
+		// Average its voxels in the coarser level
+		mipmapNode( dataStructureIOHandlerUP, dataStructureIOHandlerDOWN, nodePos );
+	}
+	}
+
+	// Generate the border data of the coarser scene
+	// (mip-mapping only reads voxels inside bricks, so it is not needed for borderless bricks)
+	if ( ! _isBorderless )
+	{
+		dataStructureIOHandlerDOWN->computeBorders();
+	}
+
+	// Destroy the data handlers (this writes the coarser level on disk)
+	delete dataStructureIOHandlerUP;
+	delete dataStructureIOHandlerDOWN;
+}
+
+/******************************************************************************
+ * Write the node summaries (min/max, occupancy, homogeneity) of all levels of resolution,
+ * so that producers can classify nodes without reading their bricks (see GvDataLoader).
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxVoxelizerEngine::generateSummaries()
+{
+	// Files of the max level of resolution must be written on disk
+	closeDataStructure();
+
+	return GvxDataStructureSummaryGenerator::generateSummaryFiles( _fileName, _level, _brickWidth, _dataTypes, getBorderSize() );
+}
+
+/******************************************************************************
+ * Generate the data of one node of a coarser level from the next finer level
+ *
+ * @param pDataStructureIOHandlerUP data structure at the finer level
+ * @param pDataStructureIOHandlerDOWN data structure at the coarser level
+ * @param pNodePos position of a non-empty node at the finer level
+ ******************************************************************************/
+void GvxVoxelizerEngine::mipmapNode( GvxDataStructureIOHandler* pDataStructureIOHandlerUP, GvxDataStructureIOHandler* pDataStructureIOHandlerDOWN, unsigned int pNodePos[ 3 ] )
+{
+	// Iterate through voxels of the current node
+	unsigned int voxelPos[ 3 ];
+	for ( voxelPos[ 2 ] = _brickWidth * pNodePos[ 2 ]; voxelPos[ 2 ] < pDataStructureIOHandlerUP->_brickWidth * ( pNodePos[ 2 ] + 1 ); voxelPos[ 2 ] +=2 )
+	for ( voxelPos[ 1 ] = _brickWidth * pNodePos[ 1 ]; voxelPos[ 1 ] < pDataStructureIOHandlerUP->_brickWidth * ( pNodePos[ 1 ] + 1 ); voxelPos[ 1 ] +=2 )
+	for ( voxelPos[ 0 ] = _brickWidth * pNodePos[ 0 ]; voxelPos[ 0 ] < pDataStructureIOHandlerUP->_brickWidth * ( pNodePos[ 0 ] + 1 ); voxelPos[ 0 ] +=2 )
+	{
+		float voxelDataDOWNf[ 4 ] = { 0.f, 0.f, 0.f, 0.f };
+		float voxelDataDOWNf2[ 4 ] = { 0.f, 0.f, 0.f, 0.f };
+
+		// As the underlying structure is an octree,
+		// to compute data at coaser level,
+		// we need to iterate through 8 voxels and take the mean value.
+		for ( unsigned int z = 0; z < 2; z++ )
+		for ( unsigned int y = 0; y < 2; y++ )
+		for ( unsigned int x = 0; x < 2; x++ )
+		{
+			// Retrieve position of voxel in the UP resolution version
+			unsigned int voxelPosUP[ 3 ];
+			voxelPosUP[ 0 ] = voxelPos[ 0 ] + x;
+			voxelPosUP[ 1 ] = voxelPos[ 1 ] + y;
+			voxelPosUP[ 2 ] = voxelPos[ 2 ] + z;
+
+			// Get associated data (in the UP resolution version)
+			unsigned char voxelDataUP[ 4 ];
+			pDataStructureIOHandlerUP->getVoxel( voxelPosUP, voxelDataUP, 0 );
+			voxelDataDOWNf[ 0 ] += voxelDataUP[ 0 ];
+			voxelDataDOWNf[ 1 ] += voxelDataUP[ 1 ];
+			voxelDataDOWNf[ 2 ] += voxelDataUP[ 2 ];
+			voxelDataDOWNf[ 3 ] += voxelDataUP[ 3 ];
+
+			unsigned short voxelNormalUP[ 4 ];
+			if (_normals)
+			{
+				// Get associated normal (in the UP resolution version)
+				pDataStructureIOHandlerUP->getVoxel( voxelPosUP, voxelNormalUP, 1 );
+				voxelDataDOWNf2[ 0 ] += halfInUshort2Float(voxelNormalUP[ 0 ]) ;
+				voxelDataDOWNf2[ 1 ] += halfInUshort2Float(voxelNormalUP[ 1 ]) ;
+				voxelDataDOWNf2[ 2 ] += halfInUshort2Float(voxelNormalUP[ 2 ]) ;
+				//voxelDataDOWNf2[ 3 ] += 0.f;
+			}
+		}
+
+		// Coarser voxel is scaled from current UP voxel (2 times smaller for octree)
+		unsigned int voxelPosDOWN[3];
+		voxelPosDOWN[ 0 ] = voxelPos[ 0 ] / 2;
+		voxelPosDOWN[ 1 ] = voxelPos[ 1 ] / 2;
+		voxelPosDOWN[ 2 ] = voxelPos[ 2 ] / 2;
+
+		// Set data in coarser voxel
+		unsigned char vd[4];		// "vd" stands for "voxel data"
+		vd[ 0 ] = float2uchar ( voxelDataDOWNf[ 0 ] / 8.f );
+		vd[ 1 ] = float2uchar ( voxelDataDOWNf[ 1 ] / 8.f );
+		vd[ 2 ] = float2uchar ( voxelDataDOWNf[ 2 ] / 8.f );
+		vd[ 3 ] = float2uchar ( voxelDataDOWNf[ 3 ] / 8.f );
+		pDataStructureIOHandlerDOWN->setVoxel( voxelPosDOWN, vd, 0 );
+
+
+		if (_normals)
+		{
+			unsigned short vd2[4];
+			// Set normal in coarser voxel
+			float norm = sqrtf( voxelDataDOWNf2[ 0 ] * voxelDataDOWNf2[ 0 ] + voxelDataDOWNf2[ 1 ] * voxelDataDOWNf2[ 1 ] + voxelDataDOWNf2[ 2 ] * voxelDataDOWNf2[ 2 ] );
+			if ( norm < 0.00001 ) // check EPSILLON value to avoid "div by 0"
+			{
+				vd2[ 0 ] = 0;
+				vd2[ 1 ] = 0;
+				vd2[ 2 ] = 0;
+				vd2[ 3 ] = 0; // => not sure about that one ?
+			}
+			else
+			{
+				vd2[ 0 ] = float2HalfInUshort( voxelDataDOWNf2[ 0 ] / norm );
+				vd2[ 1 ] = float2HalfInUshort( voxelDataDOWNf2[ 1 ] / norm );
+				vd2[ 2 ] = float2HalfInUshort( voxelDataDOWNf2[ 2 ] / norm );
+				vd2[ 3 ] = 1;
+			}
+			pDataStructureIOHandlerDOWN->setVoxel( voxelPosDOWN, vd2, 1 );
+		}
+	}
+}
+
+/******************************************************************************
+ * Generate one level of the mip-map pyramid hierarchy from the next finer level
+ * with several threads.
+ *
+ * Coarser nodes are processed by batches fitting in the memory size : the main thread
+ * reads the bricks of their children, threads average them, then the main thread
+ * writes the generated bricks in the order mipmapLevel() would have created them,
+ * so that files are identical.
+ *
+ * @param pLevel level of resolution to generate (the finer level must exist)
+ ******************************************************************************/
+void GvxVoxelizerEngine::mipmapLevelByBatches( int pLevel )
+{
+	// LOG info
+	std::cout << "GvxVoxelizerEngine::mipmap : level : " << pLevel << " - " << _nbThreads << " threads" << std::endl;
+
+	// Non-empty nodes of the finer level are found in its node file, read slice by slice
+	const std::string nodeFileNameUP = GvxDataStructureIOHandler::getFileNameNode( _fileName, pLevel + 1, _brickWidth, getBorderSize() );
+	FILE* nodeFileUP = fopen( nodeFileNameUP.c_str(), "rb" );
+	if ( nodeFileUP == NULL )
+	{
+		std::cerr << "GvxVoxelizerEngine::mipmapLevelByBatches : unable to open " << nodeFileNameUP << std::endl;
+
+		return;
+	}
+
+	GvxDataStructureIOHandler* dataStructureIOHandlerUP = new GvxDataStructureIOHandler( _fileName, pLevel + 1, _brickWidth, _dataTypes, false, getBorderSize() );
+
+	// The coarser data handler creates new files
+	GvxDataStructureIOHandler* dataStructureIOHandlerDOWN = new GvxDataStructureIOHandler( _fileName, pLevel, _brickWidth, _dataTypes, true, getBorderSize() );
+
+	const unsigned int nodeGridSizeUP = dataStructureIOHandlerUP->_nodeGridSize;
+	const unsigned int nodeGridSizeDOWN = dataStructureIOHandlerDOWN->_nodeGridSize;
+
+	// Bricks of all channels are stored contiguously
+	std::vector< size_t > channelOffsets;
+	size_t brickByteSize = 0;
+	for ( size_t c = 0; c < _dataTypes.size(); c++ )
+	{
+		channelOffsets.push_back( brickByteSize );
+		brickByteSize += dataStructureIOHandlerUP->_brickSize * GvxDataTypeHandler::canalByteSize( _dataTypes[ c ] );
+	}
+
+	// A node of a batch holds its brick and the bricks of its 8 children.
+	// Batches don't exceed a slice of coarser nodes.
+	const size_t batchCapacity = std::min( std::max( _memorySize / ( 9 * brickByteSize ), static_cast< size_t >( 1 ) ),
+											static_cast< size_t >( nodeGridSizeDOWN ) * nodeGridSizeDOWN );
+	std::vector< unsigned char > childBricks( batchCapacity * 8 * brickByteSize );
+	std::vector< unsigned char > childMasks( batchCapacity );
+	std::vector< unsigned char > bricks( batchCapacity * brickByteSize );
+
+	std::vector< unsigned int > nodeSliceUP( nodeGridSizeUP * nodeGridSizeUP );
+	std::vector< bool > isNodeListed( nodeGridSizeDOWN * nodeGridSizeDOWN );
+	std::vector< unsigned int > nodeIndices;
+	for ( unsigned int zDOWN = 0; zDOWN < nodeGridSizeDOWN; zDOWN++ )
+	{
+		// LOG info
+		std::cout << "mipmap - LEVEL [ " << pLevel << " ] - Slice [ " << zDOWN << " ] - " << nodeGridSizeDOWN << std::endl;
+
+		// List the coarser nodes of the slice in the order their first non-empty child creates them
+		std::fill( isNodeListed.begin(), isNodeListed.end(), false );
+		nodeIndices.clear();
+		for ( unsigned int z = 0; z < 2; z++ )
+		{
+			if ( fread( &nodeSliceUP[ 0 ], sizeof( unsigned int ), nodeSliceUP.size(), nodeFileUP ) != nodeSliceUP.size() )
+			{
+				std::cerr << "GvxVoxelizerEngine::mipmapLevelByBatches : unable to read " << nodeFileNameUP << std::endl;
+				std::fill( nodeSliceUP.begin(), nodeSliceUP.end(), 0 );
+			}
+
+			for ( unsigned int y = 0; y < nodeGridSizeUP; y++ )
+			for ( unsigned int x = 0; x < nodeGridSizeUP; x++ )
+			{
+				const unsigned int nodeIndex = x / 2 + nodeGridSizeDOWN * ( y / 2 );
+				if ( ! GvxDataStructureIOHandler::isEmpty( nodeSliceUP[ x + nodeGridSizeUP * y ] ) && ! isNodeListed[ nodeIndex ] )
+				{
+					isNodeListed[ nodeIndex ] = true;
+					nodeIndices.push_back( nodeIndex );
+				}
+			}
+		}
+
+		for ( size_t firstNode = 0; firstNode < nodeIndices.size(); firstNode += batchCapacity )
+		{
+			const size_t nbNodes = std::min( batchCapacity, nodeIndices.size() - firstNode );
+
+			// Read the bricks of the children
+			for ( size_t i = 0; i < nbNodes; i++ )
+			{
+				const unsigned int nodeIndex = nodeIndices[ firstNode + i ];
+
+				childMasks[ i ] = 0;
+				for ( unsigned int child = 0; child < 8; child++ )
+				{
+					unsigned int nodePos[ 3 ];
+					nodePos[ 0 ] = 2 * ( nodeIndex % nodeGridSizeDOWN ) + ( child & 1 );
+					nodePos[ 1 ] = 2 * ( nodeIndex / nodeGridSizeDOWN ) + ( ( child >> 1 ) & 1 );
+					nodePos[ 2 ] = 2 * zDOWN + ( child >> 2 );
+					if ( GvxDataStructureIOHandler::isEmpty( dataStructureIOHandlerUP->getNode( nodePos ) ) )
+					{
+						continue;
+					}
+
+					childMasks[ i ] |= static_cast< unsigned char >( 1 << child );
+					for ( size_t c = 0; c < _dataTypes.size(); c++ )
+					{
+						dataStructureIOHandlerUP->getBrick( nodePos, &childBricks[ ( i * 8 + child ) * brickByteSize + channelOffsets[ c ] ], static_cast< unsigned int >( c ) );
+					}
+				}
+			}
+
+			// Average them, nodes being interleaved between threads
+			std::vector< MipmapTask > tasks( std::min( static_cast< size_t >( _nbThreads ), nbNodes ) );
+			for ( size_t t = 0; t < tasks.size(); t++ )
+			{
+				tasks[ t ]._engine = this;
+				tasks[ t ]._childBricks = &childBricks[ 0 ];
+				tasks[ t ]._childMasks = &childMasks[ 0 ];
+				tasks[ t ]._bricks = &bricks[ 0 ];
+				tasks[ t ]._nbNodes = nbNodes;
+				tasks[ t ]._firstNode = t;
+				tasks[ t ]._nodeStep = tasks.size();
+			}
+			runMipmapTasks( tasks );
+
+			// Write the generated bricks.
+			// Writing one voxel creates the brick of the node, then its whole content is replaced.
+			for ( size_t i = 0; i < nbNodes; i++ )
+			{
+				const unsigned int nodeIndex = nodeIndices[ firstNode + i ];
+
+				unsigned int nodePos[ 3 ];
+				nodePos[ 0 ] = nodeIndex % nodeGridSizeDOWN;
+				nodePos[ 1 ] = nodeIndex / nodeGridSizeDOWN;
+				nodePos[ 2 ] = zDOWN;
+				unsigned int voxelPos[ 3 ];
+				voxelPos[ 0 ] = nodePos[ 0 ] * _brickWidth;
+				voxelPos[ 1 ] = nodePos[ 1 ] * _brickWidth;
+				voxelPos[ 2 ] = nodePos[ 2 ] * _brickWidth;
+				unsigned char voxelData[ 16 ];
+				memset( voxelData, 0, sizeof( voxelData ) );
+				dataStructureIOHandlerDOWN->setVoxel( voxelPos, voxelData, 0 );
+				for ( size_t c = 0; c < _dataTypes.size(); c++ )
+				{
+					dataStructureIOHandlerDOWN->setBrick( nodePos, &bricks[ i * brickByteSize + channelOffsets[ c ] ], static_cast< unsigned int >( c ) );
+				}
+			}
+		}
+	}
+
+	fclose( nodeFileUP );
+
+	// Generate the border data of the coarser scene
+	// (mip-mapping only reads voxels inside bricks, so it is not needed for borderless bricks)
+	if ( ! _isBorderless )
+	{
+		dataStructureIOHandlerDOWN->computeBorders();
+	}
+
+	// Destroy the data handlers (this writes the coarser level on disk)
+	delete dataStructureIOHandlerUP;
+	delete dataStructureIOHandlerDOWN;
+}
+
+/******************************************************************************
+ * Generate the bricks of the nodes of a batch handled by a mip-map task
+ *
+ * @param pTask the mip-map task
+ ******************************************************************************/
+void GvxVoxelizerEngine::mipmapBricks( const MipmapTask& pTask ) const
+{
+	const unsigned int brickWidth = static_cast< unsigned int >( _brickWidth );
+	const unsigned int borderSize = getBorderSize();
+	const unsigned int width = brickWidth + 2 * borderSize;
+	const size_t brickSize = static_cast< size_t >( width ) * width * width;
+
+	// Channels are uchar4 data and optional half4 normals
+	const size_t normalOffset = brickSize * GvxDataTypeHandler::canalByteSize( _dataTypes[ 0 ] );
+	size_t brickByteSize = 0;
+	for ( size_t c = 0; c < _dataTypes.size(); c++ )
+	{
+		brickByteSize += brickSize * GvxDataTypeHandler::canalByteSize( _dataTypes[ c ] );
+	}
+
+	for ( size_t i = pTask._firstNode; i < pTask._nbNodes; i += pTask._nodeStep )
+	{
+		unsigned char* brick = pTask._bricks + i * brickByteSize;
+		unsigned short* normalBrick = reinterpret_cast< unsigned short* >( brick + normalOffset );
+		memset( brick, 0, brickByteSize );
+
+		for ( unsigned int child = 0; child < 8; child++ )
+		{
+			if ( ( pTask._childMasks[ i ] & ( 1 << child ) ) == 0 )
+			{
+				continue;
+			}
+
+			const unsigned char* childBrick = pTask._childBricks + ( i * 8 + child ) * brickByteSize;
+			const unsigned short* childNormalBrick = reinterpret_cast< const unsigned short* >( childBrick + normalOffset );
+
+			// The child is averaged in an octant of the brick
+			const unsigned int octant[ 3 ] = { ( child & 1 ) * brickWidth / 2, ( ( child >> 1 ) & 1 ) * brickWidth / 2, ( child >> 2 ) * brickWidth / 2 };
+
+			// Same computation as mipmapNode()
+			for ( unsigned int voxelZ = 0; voxelZ < brickWidth; voxelZ += 2 )
+			for ( unsigned int voxelY = 0; voxelY < brickWidth; voxelY += 2 )
+			for ( unsigned int voxelX = 0; voxelX < brickWidth; voxelX += 2 )
+			{
+				float voxelDataDOWNf[ 4 ] = { 0.f, 0.f, 0.f, 0.f };
+				float voxelDataDOWNf2[ 4 ] = { 0.f, 0.f, 0.f, 0.f };
+
+				for ( unsigned int z = 0; z < 2; z++ )
+				for ( unsigned int y = 0; y < 2; y++ )
+				for ( unsigned int x = 0; x < 2; x++ )
+				{
+					const size_t voxelIndexUP = ( voxelX + x + borderSize ) + width * ( ( voxelY + y + borderSize ) + width * ( voxelZ + z + borderSize ) );
+					voxelDataDOWNf[ 0 ] += childBrick[ 4 * voxelIndexUP + 0 ];
+					voxelDataDOWNf[ 1 ] += childBrick[ 4 * voxelIndexUP + 1 ];
+					voxelDataDOWNf[ 2 ] += childBrick[ 4 * voxelIndexUP + 2 ];
+					voxelDataDOWNf[ 3 ] += childBrick[ 4 * voxelIndexUP + 3 ];
+
+					if ( _normals )
+					{
+						voxelDataDOWNf2[ 0 ] += halfInUshort2Float( childNormalBrick[ 4 * voxelIndexUP + 0 ] );
+						voxelDataDOWNf2[ 1 ] += halfInUshort2Float( childNormalBrick[ 4 * voxelIndexUP + 1 ] );
+						voxelDataDOWNf2[ 2 ] += halfInUshort2Float( childNormalBrick[ 4 * voxelIndexUP + 2 ] );
+					}
+				}
+
+				const size_t voxelIndex = ( octant[ 0 ] + voxelX / 2 + borderSize ) + width * ( ( octant[ 1 ] + voxelY / 2 + borderSize ) + width * ( octant[ 2 ] + voxelZ / 2 + borderSize ) );
+				brick[ 4 * voxelIndex + 0 ] = float2uchar( voxelDataDOWNf[ 0 ] / 8.f );
+				brick[ 4 * voxelIndex + 1 ] = float2uchar( voxelDataDOWNf[ 1 ] / 8.f );
+				brick[ 4 * voxelIndex + 2 ] = float2uchar( voxelDataDOWNf[ 2 ] / 8.f );
+				brick[ 4 * voxelIndex + 3 ] = float2uchar( voxelDataDOWNf[ 3 ] / 8.f );
+
+				if ( _normals )
+				{
+					float norm = sqrtf( voxelDataDOWNf2[ 0 ] * voxelDataDOWNf2[ 0 ] + voxelDataDOWNf2[ 1 ] * voxelDataDOWNf2[ 1 ] + voxelDataDOWNf2[ 2 ] * voxelDataDOWNf2[ 2 ] );
+					if ( norm < 0.00001 ) // check EPSILLON value to avoid "div by 0"
+					{
+						// The normal stays null (the brick has been cleared)
+					}
+					else
+					{
+						normalBrick[ 4 * voxelIndex + 0 ] = float2HalfInUshort( voxelDataDOWNf2[ 0 ] / norm );
+						normalBrick[ 4 * voxelIndex + 1 ] = float2HalfInUshort( voxelDataDOWNf2[ 1 ] / norm );
+						normalBrick[ 4 * voxelIndex + 2 ] = float2HalfInUshort( voxelDataDOWNf2[ 2 ] / norm );
+						normalBrick[ 4 * voxelIndex + 3 ] = 1;
+					}
+				}
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * Run mip-map tasks, one thread per task
+ *
+ * @param pTasks the tasks
+ ******************************************************************************/
+void GvxVoxelizerEngine::runMipmapTasks( std::vector< MipmapTask >& pTasks )
+{
+#ifndef WIN32
+	std::vector< pthread_t > threads( pTasks.size() );
+	std::vector< bool > isThreadCreated( pTasks.size(), false );
+	for ( size_t i = 0; i < pTasks.size(); i++ )
+	{
+		isThreadCreated[ i ] = ( pthread_create( &threads[ i ], NULL, runMipmapTask, &pTasks[ i ] ) == 0 );
+		if ( ! isThreadCreated[ i ] )
+		{
+			runMipmapTask( &pTasks[ i ] );
+		}
+	}
+	for ( size_t i = 0; i < pTasks.size(); i++ )
+	{
+		if ( isThreadCreated[ i ] )
+		{
+			pthread_join( threads[ i ], NULL );
+		}
+	}
+#else
+	for ( size_t i = 0; i < pTasks.size(); i++ )
+	{
+		runMipmapTask( &pTasks[ i ] );
+	}
+#endif
+}
+
+/******************************************************************************
+ * Thread entry point of a mip-map task
+ *
+ * @param pTask the task
+ *
+ * @return NULL
+ ******************************************************************************/
+void* GvxVoxelizerEngine::runMipmapTask( void* pTask )
+{
+	MipmapTask* task = static_cast< MipmapTask* >( pTask );
+	task->_engine->mipmapBricks( *task );
+
+	return NULL;
+}
+
+/******************************************************************************
+ * Start the incremental update of previously voxelized data.
+ * The data structure files of the max level of resolution are reopened
+ * and the stage is set to eRegisterTriangles.
+ *
+ * Note : filtering is not supported, data must have been generated without filter.
+ *
+ * @param pLevel Max level of resolution
+ * @param pBrickWidth Width a brick
+ * @param pName Filename to be processed
+ * @param pDataType Data type that will be processed
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxVoxelizerEngine::beginIncrementalVoxelization( int pLevel, int pBrickWidth, const std::string& pName, GvxDataTypeHandler::VoxelDataType pDataType )
+{
+	// The filter spreads data in neighbor voxels, so filtered data can't be updated locally
+	if ( _nbFilterApplications > 0 )
+	{
+		std::cerr << "GvxVoxelizerEngine::beginIncrementalVoxelization : filtered data can't be updated incrementally" << std::endl;
+
+		return false;
+	}
+
+	// Store initialization values
+	setup( pLevel, pBrickWidth, pName, pDataType );
+
+	// All levels of resolution must have been generated previously with the same settings
+	for ( int level = 0; level <= _level; level++ )
+	{
+		std::vector< std::string > fileNames;
+		fileNames.push_back( GvxDataStructureIOHandler::getFileNameNode( _fileName, level, _brickWidth, getBorderSize() ) );
+		for ( unsigned int c = 0; c < _dataTypes.size(); ++c )
+		{
+			fileNames.push_back( GvxDataStructureIOHandler::getFileNameBrick( _fileName, level, _brickWidth, c, GvxDataTypeHandler::getTypeName( _dataTypes[ c ] ), getBorderSize() ) );
+		}
+
+		for ( size_t i = 0; i < fileNames.size(); i++ )
+		{
+			FILE* file = fopen( fileNames[ i ].c_str(), "rb" );
+			if ( file == NULL )
+			{
+				std::cerr << "GvxVoxelizerEngine::beginIncrementalVoxelization : missing file " << fileNames[ i ] << std::endl;
+
+				return false;
+			}
+			fclose( file );
+		}
+	}
+
+	// Reopen the data structure of the max level of resolution
+	closeDataStructure();
+	_dataStructureIOHandler = new GvxDataStructureIOHandler( _fileName, _level, _brickWidth, _dataTypes, false, getBorderSize() );
+
+	_triangleSignatures.clear();
+	_triangleSignatureCounts.clear();
+	_dirtyNodes.clear();
+	_incrementalStage = eRegisterTriangles;
+
+	return true;
+}
+
+/******************************************************************************
+ * Set the incremental voxelization stage.
+ * Entering the eUpdateDirtyNodes stage clears the bricks of dirty nodes.
+ *
+ * @param pStage the incremental voxelization stage
+ ******************************************************************************/
+void GvxVoxelizerEngine::setIncrementalStage( EIncrementalStage pStage )
+{
+	// Registration is finished : sort signatures and count duplicated ones
+	if ( _incrementalStage == eRegisterTriangles && pStage != eRegisterTriangles )
+	{
+		std::sort( _triangleSignatures.begin(), _triangleSignatures.end() );
+
+		std::vector< unsigned long long > signatures;
+		_triangleSignatureCounts.clear();
+		for ( size_t i = 0; i < _triangleSignatures.size(); i++ )
+		{
+			if ( signatures.empty() || signatures.back() != _triangleSignatures[ i ] )
+			{
+				signatures.push_back( _triangleSignatures[ i ] );
+				_triangleSignatureCounts.push_back( 0 );
+			}
+			_triangleSignatureCounts.back()++;
+		}
+		_triangleSignatures.swap( signatures );
+	}
+
+	// Dirty nodes are fully revoxelized
+	if ( pStage == eUpdateDirtyNodes && _incrementalStage != eUpdateDirtyNodes )
+	{
+		// LOG info
+		std::cout << "GvxVoxelizerEngine::setIncrementalStage : " << _dirtyNodes.size() << " dirty nodes" << std::endl;
+
+		clearDirtyBricks();
+	}
+
+	_incrementalStage = pStage;
+}
+
+/******************************************************************************
+ * Get the incremental voxelization stage
+ *
+ * @return the incremental voxelization stage
+ ******************************************************************************/
+GvxVoxelizerEngine::EIncrementalStage GvxVoxelizerEngine::getIncrementalStage() const
+{
+	return _incrementalStage;
+}
+
+/******************************************************************************
+ * Mark dirty the leaf nodes touched by the current triangle.
+ * It can be used directly (before the eUpdateDirtyNodes stage)
+ * to provide an explicit list of changed triangles.
+ ******************************************************************************/
+void GvxVoxelizerEngine::markTriangle()
+{
+	unsigned int minNodePos[ 3 ];
+	unsigned int maxNodePos[ 3 ];
+	getTriangleNodeRange( minNodePos, maxNodePos );
+
+	unsigned int nodePos[ 3 ];
+	for ( nodePos[ 2 ] = minNodePos[ 2 ]; nodePos[ 2 ] <= maxNodePos[ 2 ]; nodePos[ 2 ]++ )
+	for ( nodePos[ 1 ] = minNodePos[ 1 ]; nodePos[ 1 ] <= maxNodePos[ 1 ]; nodePos[ 1 ]++ )
+	for ( nodePos[ 0 ] = minNodePos[ 0 ]; nodePos[ 0 ] <= maxNodePos[ 0 ]; nodePos[ 0 ]++ )
+	{
+		_dirtyNodes.insert( _dataStructureIOHandler->getNodeIndex( nodePos ) );
+	}
+}
+
+/******************************************************************************
+ * Get the number of dirty leaf nodes
+ *
+ * @return the number of dirty leaf nodes
+ ******************************************************************************/
+unsigned int GvxVoxelizerEngine::getNbDirtyNodes() const
+{
+	return static_cast< unsigned int >( _dirtyNodes.size() );
+}
+
+/******************************************************************************
+ * Finalize the incremental update.
+ * Borders are computed around dirty nodes, then mip-map levels
+ * are generated along their ancestor chains only.
+ * Updated nodes left without data are set empty at each level.
+ ******************************************************************************/
+void GvxVoxelizerEngine::endIncrementalVoxelization()
+{
+	if ( _dataStructureIOHandler == NULL )
+	{
+		return;
+	}
+
+	// LOG info
+	std::cout << "GvxVoxelizerEngine::endIncrementalVoxelization : level : " << _level << " - " << _dirtyNodes.size() << " dirty nodes" << std::endl;
+
+	// Dirty nodes and their neighbors exchange their border data.
+	// Neighbors may also have been created to hold the border data of dirty nodes.
+	std::set< unsigned int > nodes = _dirtyNodes;
+	addNeighborNodes( nodes, _dataStructureIOHandler->_nodeGridSize );
+	_dataStructureIOHandler->computeBorders( nodes );
+
+	// Nodes left without data (removed geometry, or borders of removed geometry) become empty again
+	const unsigned int nbReleasedBricks = _dataStructureIOHandler->releaseEmptyBricks( nodes );
+	std::cout << "GvxVoxelizerEngine::endIncrementalVoxelization : " << nbReleasedBricks << " nodes set empty" << std::endl;
+
+	// Flush and close the max level files
+	closeDataStructure();
+
+	// Update the mip-map pyramid hierarchy along the ancestor chains
+	for ( int level = _level - 1; level >= 0; level-- )
+	{
+		const unsigned int nodeGridSizeUP = 1 << ( level + 1 );
+		const unsigned int nodeGridSizeDOWN = 1 << level;
+
+		// Retrieve parent nodes
+		std::set< unsigned int > parentNodes;
+		std::set< unsigned int >::const_iterator nodeIt = nodes.begin();
+		for ( ; nodeIt != nodes.end(); ++nodeIt )
+		{
+			const unsigned int x = ( *nodeIt % nodeGridSizeUP ) / 2;
+			const unsigned int y = ( ( *nodeIt / nodeGridSizeUP ) % nodeGridSizeUP ) / 2;
+			const unsigned int z = ( *nodeIt / ( nodeGridSizeUP * nodeGridSizeUP ) ) / 2;
+			parentNodes.insert( x + nodeGridSizeDOWN * ( y + nodeGridSizeDOWN * z ) );
+		}
+
+		mipmapLevel( level, parentNodes );
+
+		// Parent nodes may have created neighbors while computing their borders
+		nodes.swap( parentNodes );
+		addNeighborNodes( nodes, nodeGridSizeDOWN );
+	}
+
+	// Node summaries of all levels
+	generateSummaries();
+
+	// Back to the default stage
+	_incrementalStage = eFullVoxelization;
+	_triangleSignatures.clear();
+	_triangleSignatureCounts.clear();
+	_dirtyNodes.clear();
+}
+
+/******************************************************************************
+ * Restrict the voxelization to a tile of the node grid at the max level of resolution.
+ * Call before init() : data files are then named after the tile (see GvxTileMerger::getTileName())
+ * and only the leaf level is generated.
+ *
+ * @param pTileOrigin indexed position of the first node of the tile
+ * @param pTileSize number of nodes of the tile along each axis (0 to voxelize the whole scene)
+ ******************************************************************************/
+void GvxVoxelizerEngine::setTile( const unsigned int pTileOrigin[ 3 ], unsigned int pTileSize )
+{
+	_tileOrigin[ 0 ] = pTileOrigin[ 0 ];
+	_tileOrigin[ 1 ] = pTileOrigin[ 1 ];
+	_tileOrigin[ 2 ] = pTileOrigin[ 2 ];
+	_tileSize = pTileSize;
+}
+
+/******************************************************************************
+ * Tell wheter or not the voxelization is restricted to a tile
+ *
+ * @return a flag telling wheter or not the voxelization is restricted to a tile
+ ******************************************************************************/
+bool GvxVoxelizerEngine::hasTile() const
+{
+	return ( _tileSize > 0 );
+}
+
+/******************************************************************************
+ * Finalize a tile voxelization.
+ * Files of the leaf level are closed (no borders, filter nor mipmap)
+ * and the tile descriptor file is written next to them.
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool GvxVoxelizerEngine::endTile()
+{
+	// Flush and close the leaf level files
+	closeDataStructure();
+
+	return GvxTileMerger::writeTileDescriptor( _fileName, _level, _brickWidth, _tileOrigin, _tileSize, _tileNodeWrites );
+}
+
+/******************************************************************************
+ * Compute the signature of the current triangle
+ * from all its attributes used during voxelization.
+ *
+ * @return the triangle signature
+ ******************************************************************************/
+unsigned long long GvxVoxelizerEngine::getTriangleSignature() const
+{
+	// FNV-1a hash of the triangle attributes
+	unsigned long long hash = 14695981039346656037ULL;
+	const unsigned long long prime = 1099511628211ULL;
+
+	std::vector< float > attributes;
+	attributes.insert( attributes.end(), _v1, _v1 + 3 );
+	attributes.insert( attributes.end(), _v2, _v2 + 3 );
+	attributes.insert( attributes.end(), _v3, _v3 + 3 );
+	if ( _normals )
+	{
+		attributes.insert( attributes.end(), _n1, _n1 + 3 );
+		attributes.insert( attributes.end(), _n2, _n2 + 3 );
+		attributes.insert( attributes.end(), _n3, _n3 + 3 );
+	}
+	if ( _useTexture )
+	{
+		attributes.insert( attributes.end(), _t1, _t1 + 2 );
+		attributes.insert( attributes.end(), _t2, _t2 + 2 );
+		attributes.insert( attributes.end(), _t3, _t3 + 2 );
+	}
+	else
+	{
+		attributes.insert( attributes.end(), _c1, _c1 + 3 );
+		attributes.insert( attributes.end(), _c2, _c2 + 3 );
+		attributes.insert( attributes.end(), _c3, _c3 + 3 );
+	}
+
+	const unsigned char* bytes = reinterpret_cast< const unsigned char* >( &attributes[ 0 ] );
+	for ( size_t i = 0; i < attributes.size() * sizeof( float ); i++ )
+	{
+		hash = ( hash ^ bytes[ i ] ) * prime;
+	}
+
+	// A texture change modifies the voxel colors of the triangle
+	if ( _useTexture )
+	{
+		for ( size_t i = 0; i < _textureName.size(); i++ )
+		{
+			hash = ( hash ^ static_cast< unsigned char >( _textureName[ i ] ) ) * prime;
+		}
+	}
+
+	return hash;
+}
+
+/******************************************************************************
+ * Consume one registered triangle with the given signature.
+ *
+ * @param pSignature a triangle signature
+ *
+ * @return a flag telling wheter or not a registered triangle has been found
+ ******************************************************************************/
+bool GvxVoxelizerEngine::consumeTriangleSignature( unsigned long long pSignature )
+{
+	std::vector< unsigned long long >::const_iterator it = std::lower_bound( _triangleSignatures.begin(), _triangleSignatures.end(), pSignature );
+	if ( it == _triangleSignatures.end() || *it != pSignature )
+	{
+		return false;
+	}
+
+	unsigned int& count = _triangleSignatureCounts[ it - _triangleSignatures.begin() ];
+	if ( count == 0 )
+	{
+		return false;
+	}
+	count--;
+
+	return true;
+}
+
+/******************************************************************************
+ * Retrieve the range of leaf nodes touched by the current triangle
+ * (taking into account the 2 voxels width splatting).
+ *
+ * @param pMinNodePos min indexed node position
+ * @param pMaxNodePos max indexed node position
+ ******************************************************************************/
+void GvxVoxelizerEngine::getTriangleNodeRange( unsigned int pMinNodePos[ 3 ], unsigned int pMaxNodePos[ 3 ] ) const
+{
+	const int voxelGridSize = static_cast< int >( _dataStructureIOHandler->_voxelGridSize );
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		const float minValue = std::min< float >( _v1[ i ], std::min< float >( _v2[ i ], _v3[ i ] ) );
+		const float maxValue = std::max< float >( _v1[ i ], std::max< float >( _v2[ i ], _v3[ i ] ) );
+
+		// Splatting writes one voxel further on each side
+		int minVoxel = static_cast< int >( floorf( minValue * static_cast< float >( voxelGridSize ) ) ) - 1;
+		int maxVoxel = static_cast< int >( floorf( maxValue * static_cast< float >( voxelGridSize ) ) ) + 1;
+		minVoxel = std::min< int >( std::max< int >( minVoxel, 0 ), voxelGridSize - 1 );
+		maxVoxel = std::min< int >( std::max< int >( maxVoxel, 0 ), voxelGridSize - 1 );
+
+		pMinNodePos[ i ] = static_cast< unsigned int >( minVoxel ) / _brickWidth;
+		pMaxNodePos[ i ] = static_cast< unsigned int >( maxVoxel ) / _brickWidth;
+	}
+}
+
+/******************************************************************************
+ * Tell wheter or not the current triangle touches a dirty node
+ *
+ * @return a flag telling wheter or not the current triangle touches a dirty node
+ ******************************************************************************/
+bool GvxVoxelizerEngine::isTriangleDirty() const
+{
+	unsigned int minNodePos[ 3 ];
+	unsigned int maxNodePos[ 3 ];
+	getTriangleNodeRange( minNodePos, maxNodePos );
+
+	const size_t nbNodes = static_cast< size_t >( maxNodePos[ 0 ] - minNodePos[ 0 ] + 1 ) * ( maxNodePos[ 1 ] - minNodePos[ 1 ] + 1 ) * ( maxNodePos[ 2 ] - minNodePos[ 2 ] + 1 );
+
+	// Large triangles : test dirty nodes against the range
+	if ( nbNodes > _dirtyNodes.size() )
+	{
+		std::set< unsigned int >::const_iterator nodeIt = _dirtyNodes.begin();
+		for ( ; nodeIt != _dirtyNodes.end(); ++nodeIt )
+		{
+			unsigned int nodePos[ 3 ];
+			_dataStructureIOHandler->getNodePosition( *nodeIt, nodePos );
+			if ( nodePos[ 0 ] >= minNodePos[ 0 ] && nodePos[ 0 ] <= maxNodePos[ 0 ] &&
+				nodePos[ 1 ] >= minNodePos[ 1 ] && nodePos[ 1 ] <= maxNodePos[ 1 ] &&
+				nodePos[ 2 ] >= minNodePos[ 2 ] && nodePos[ 2 ] <= maxNodePos[ 2 ] )
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Small triangles : test nodes of the range
+	unsigned int nodePos[ 3 ];
+	for ( nodePos[ 2 ] = minNodePos[ 2 ]; nodePos[ 2 ] <= maxNodePos[ 2 ]; nodePos[ 2 ]++ )
+	for ( nodePos[ 1 ] = minNodePos[ 1 ]; nodePos[ 1 ] <= maxNodePos[ 1 ]; nodePos[ 1 ]++ )
+	for ( nodePos[ 0 ] = minNodePos[ 0 ]; nodePos[ 0 ] <= maxNodePos[ 0 ]; nodePos[ 0 ]++ )
+	{
+		if ( _dirtyNodes.find( _dataStructureIOHandler->getNodeIndex( nodePos ) ) != _dirtyNodes.end() )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * Tell wheter or not a voxel is in a dirty node
+ *
+ * @param pVoxelPos voxel position
+ *
+ * @return a flag telling wheter or not a voxel is in a dirty node
+ ******************************************************************************/
+bool GvxVoxelizerEngine::isDirtyVoxel( unsigned int pVoxelPos[ 3 ] ) const
+{
+	const unsigned int voxelGridSize = _dataStructureIOHandler->_voxelGridSize;
+	if ( pVoxelPos[ 0 ] >= voxelGridSize || pVoxelPos[ 1 ] >= voxelGridSize || pVoxelPos[ 2 ] >= voxelGridSize )
+	{
+		return false;
+	}
+
+	unsigned int nodePos[ 3 ];
+	nodePos[ 0 ] = pVoxelPos[ 0 ] / _brickWidth;
+	nodePos[ 1 ] = pVoxelPos[ 1 ] / _brickWidth;
+	nodePos[ 2 ] = pVoxelPos[ 2 ] / _brickWidth;
+
+	return _dirtyNodes.find( _dataStructureIOHandler->getNodeIndex( nodePos ) ) != _dirtyNodes.end();
+}
+
+/******************************************************************************
+ * Reset the bricks of dirty nodes before revoxelizing them
+ ******************************************************************************/
+void GvxVoxelizerEngine::clearDirtyBricks()
+{
+	// Nodes keep their brick until borders have been updated :
+	// the ones that end up empty are released afterwards (see endIncrementalVoxelization()).
+	std::set< unsigned int >::const_iterator nodeIt = _dirtyNodes.begin();
+	for ( ; nodeIt != _dirtyNodes.end(); ++nodeIt )
+	{
+		unsigned int nodePos[ 3 ];
+		_dataStructureIOHandler->getNodePosition( *nodeIt, nodePos );
+		_dataStructureIOHandler->clearBrick( nodePos );
+	}
+}
+
+/******************************************************************************
+ * Tell wheter or not the current triangle touches the tile
+ *
+ * @return a flag telling wheter or not the current triangle touches the tile
+ ******************************************************************************/
+bool GvxVoxelizerEngine::isTriangleInTile() const
+{
+	unsigned int minNodePos[ 3 ];
+	unsigned int maxNodePos[ 3 ];
+	getTriangleNodeRange( minNodePos, maxNodePos );
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		if ( maxNodePos[ i ] < _tileOrigin[ i ] || minNodePos[ i ] >= _tileOrigin[ i ] + _tileSize )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Tell wheter or not a voxel is in the tile
+ *
+ * @param pVoxelPos voxel position
+ *
+ * @return a flag telling wheter or not a voxel is in the tile
+ ******************************************************************************/
+bool GvxVoxelizerEngine::isTileVoxel( unsigned int pVoxelPos[ 3 ] ) const
+{
+	const unsigned int voxelGridSize = _dataStructureIOHandler->_voxelGridSize;
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		if ( pVoxelPos[ i ] >= voxelGridSize )
+		{
+			return false;
+		}
+
+		const unsigned int nodePos = pVoxelPos[ i ] / _brickWidth;
+		if ( nodePos < _tileOrigin[ i ] || nodePos >= _tileOrigin[ i ] + _tileSize )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Add the neighbors of the given nodes to the list
+ *
+ * @param pNodeIndices indices of the nodes
+ * @param pNodeGridSize node grid size of the associated level of resolution
+ ******************************************************************************/
+void GvxVoxelizerEngine::addNeighborNodes( std::set< unsigned int >& pNodeIndices, unsigned int pNodeGridSize )
+{
+	const std::set< unsigned int > nodes = pNodeIndices;
+
+	std::set< unsigned int >::const_iterator nodeIt = nodes.begin();
+	for ( ; nodeIt != nodes.end(); ++nodeIt )
+	{
+		const int x = static_cast< int >( *nodeIt % pNodeGridSize );
+		const int y = static_cast< int >( ( *nodeIt / pNodeGridSize ) % pNodeGridSize );
+		const int z = static_cast< int >( *nodeIt / ( pNodeGridSize * pNodeGridSize ) );
+
+		// Iterate through each neighbor nodes (in 3D, there are 26 neighbors)
+		for ( int k = std::max( z - 1, 0 ); k <= std::min( z + 1, static_cast< int >( pNodeGridSize ) - 1 ); k++ )
+		for ( int j = std::max( y - 1, 0 ); j <= std::min( y + 1, static_cast< int >( pNodeGridSize ) - 1 ); j++ )
+		for ( int i = std::max( x - 1, 0 ); i <= std::min( x + 1, static_cast< int >( pNodeGridSize ) - 1 ); i++ )
+		{
+			pNodeIndices.insert( static_cast< unsigned int >( i ) + pNodeGridSize * ( static_cast< unsigned int >( j ) + pNodeGridSize * static_cast< unsigned int >( k ) ) );
+		}
+	}
+}
+
+/******************************************************************************
+ * Regenerate a subset of nodes of one level of the mip-map pyramid hierarchy
+ * from the next finer level, then their borders.
+ *
+ * @param pLevel level of resolution to update (the finer level must exist)
+ * @param pNodeIndices indices of the nodes to update at this level
+ ******************************************************************************/
+void GvxVoxelizerEngine::mipmapLevel( int pLevel, const std::set< unsigned int >& pNodeIndices )
+{
+	// LOG info
+	std::cout << "GvxVoxelizerEngine::mipmap : level : " << pLevel << " - " << pNodeIndices.size() << " nodes" << std::endl;
+
+	// Both levels already exist : the coarser one is updated in place
+	GvxDataStructureIOHandler* dataStructureIOHandlerUP = new GvxDataStructureIOHandler( _fileName, pLevel + 1, _brickWidth, _dataTypes, false, getBorderSize() );
+	GvxDataStructureIOHandler* dataStructureIOHandlerDOWN = new GvxDataStructureIOHandler( _fileName, pLevel, _brickWidth, _dataTypes, false, getBorderSize() );
+
+	// Iterate through nodes to update
+	std::set< unsigned int >::const_iterator nodeIt = pNodeIndices.begin();
+	for ( ; nodeIt != pNodeIndices.end(); ++nodeIt )
+	{
+		unsigned int nodePos[ 3 ];
+		dataStructureIOHandlerDOWN->getNodePosition( *nodeIt, nodePos );
+
+		// All children are averaged again
+		dataStructureIOHandlerDOWN->clearBrick( nodePos );
+
+		// Iterate through the 8 children at the finer level
+		for ( unsigned int z = 0; z < 2; z++ )
+		for ( unsigned int y = 0; y < 2; y++ )
+		for ( unsigned int x = 0; x < 2; x++ )
+		{
+			unsigned int childNodePos[ 3 ];
+			childNodePos[ 0 ] = 2 * nodePos[ 0 ] + x;
+			childNodePos[ 1 ] = 2 * nodePos[ 1 ] + y;
+			childNodePos[ 2 ] = 2 * nodePos[ 2 ] + z;
+
+			// If node is empty, go to next node
+			if ( GvxDataStructureIOHandler::isEmpty( dataStructureIOHandlerUP->getNode( childNodePos ) ) )
+			{
+				continue;
+			}
+
+			// Average its voxels in the coarser level
+			mipmapNode( dataStructureIOHandlerUP, dataStructureIOHandlerDOWN, childNodePos );
+		}
+	}
+
+	// Generate the border data around the updated nodes
+	std::set< unsigned int > nodes = pNodeIndices;
+	addNeighborNodes( nodes, dataStructureIOHandlerDOWN->_nodeGridSize );
+	dataStructureIOHandlerDOWN->computeBorders( nodes );
+
+	// Nodes whose children are all empty become empty too
+	dataStructureIOHandlerDOWN->releaseEmptyBricks( nodes );
+
+	// Destroy the data handlers (this writes the coarser level on disk)
+	delete dataStructureIOHandlerUP;
+	delete dataStructureIOHandlerDOWN;
+}
@@ -251,6 +251,15 @@ protected:
 	 */
 	GvCore::Array3D< uint >* _h_nodesBuffer;
 
+	/**
+	 * Bricks feedback.
+	 * Will be accessed through zero-copy.
+	 *
+	 * HOST producer store, for each brick request, the feedback returned by its associated DEVICE-side object
+	 * (0 if the brick has been loaded, 3 if its data were not available and the brick must be requested again).
+	 */
+	GvCore::Array3D< uint >* _h_bricksFeedbackBuffer;
+
 	/**
 	 * Channels caches pool
 	 *
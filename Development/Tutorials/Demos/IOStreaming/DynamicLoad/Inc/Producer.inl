@@ -75,6 +75,9 @@ Producer< TDataStructureType, TDataProductionManager >
 	// TODO fix maxRequestNumber * 8
 	_h_nodesBuffer = new GvCore::Array3D< uint >( dim3( _nbMaxRequests * 8, 1, 1 ), 2 ); // Allocated mappable pinned memory // TODO : check this size limit
 
+	// Bricks feedback (one value per brick request)
+	_h_bricksFeedbackBuffer = new GvCore::Array3D< uint >( dim3( _nbMaxRequests, 1, 1 ), 2 ); // Allocated mappable pinned memory
+
 	// Check error
 	GV_CHECK_CUDA_ERROR( "GPUVoxelProducerDynamic:GPUVoxelProducerDynamic : end" );
 }
@@ -118,6 +121,7 @@ inline void Producer< TDataStructureType, TDataProductionManager >
 	delete _requestListLoc;
 	delete d_TempLocalizationCodeList;
 	delete d_TempLocalizationDepthList;
+	delete _h_bricksFeedbackBuffer;
 }
 
 /******************************************************************************
@@ -170,7 +174,7 @@ inline void Producer< TDataStructureType, TDataProductionManager >
 				Loki::Int2Type< 0 > )
 {
 	// Initialize the device-side producer (with the node pool and the brick pool)
-	this->_kernelProducer.init( _maxDepth, _h_nodesBuffer->getDeviceArray(), _channelsCachesPool->getKernelPool() );
+	this->_kernelProducer.init( _maxDepth, _h_nodesBuffer->getDeviceArray(), _h_bricksFeedbackBuffer->getDeviceArray(), _channelsCachesPool->getKernelPool() );
 	GvCore::GvIProviderKernel< 0, KernelProducerType > kernelProvider( this->_kernelProducer );
 		
 	// Define kernel block size
@@ -237,7 +241,7 @@ inline void Producer< TDataStructureType, TDataProductionManager >
 				Loki::Int2Type< 1 > )
 {
 	// Initialize the device-side producer (with the node pool and the brick pool)
-	this->_kernelProducer.init( _maxDepth, _h_nodesBuffer->getDeviceArray(), _channelsCachesPool->getKernelPool() );
+	this->_kernelProducer.init( _maxDepth, _h_nodesBuffer->getDeviceArray(), _h_bricksFeedbackBuffer->getDeviceArray(), _channelsCachesPool->getKernelPool() );
 	GvCore::GvIProviderKernel< 1, KernelProducerType > kernelProvider( this->_kernelProducer );
 	
 	// Define kernel block size
@@ -416,7 +420,10 @@ inline void Producer< TDataStructureType, TDataProductionManager >
 			
 			// Retrieve the node and associated brick located in this region of space,
 			// and depending of its type, if it contains data, load it.
-			loader->getRegion( regionPos, regionSize, _channelsCachesPool, brickOffset * i );
+			// If its data could not be retrieved, the brick is flagged as not produced (feedback 3),
+			// so that its node is not updated and requested again.
+			const typename LoaderType::VPRegionInfo regionInfo = loader->getRegion( regionPos, regionSize, _channelsCachesPool, brickOffset * i );
+			_h_bricksFeedbackBuffer->get( i ) = ( regionInfo == LoaderType::VP_UNAVAILABLE_REGION ) ? 3 : 0;
 		}
 
 		CUDAPM_STOP_EVENT( gpuProdDynamic_preLoadMgtData_dataLoad_elemLoop )
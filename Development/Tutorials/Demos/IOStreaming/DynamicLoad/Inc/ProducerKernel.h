@@ -168,6 +168,11 @@ public:
 	 */
 	GvCore::Array3DKernelLinear< uint >	_cpuNodesCache;
 
+	/**
+	 * DEVICE-side associated HOST bricks feedback
+	 */
+	GvCore::Array3DKernelLinear< uint >	_cpuBricksFeedback;
+
 	/******************************** METHODS *********************************/
 
 	/**
@@ -182,9 +187,10 @@ public:
 	 *
 	 * @param maxdepth max depth
 	 * @param nodescache nodes cache
+	 * @param brickfeedbacks bricks feedback
 	 * @param datacachepool data cache pool
 	 */
-	inline void init( uint maxdepth, const GvCore::Array3DKernelLinear< uint >& nodescache, const DataCachePoolKernelType& datacachepool );
+	inline void init( uint maxdepth, const GvCore::Array3DKernelLinear< uint >& nodescache, const GvCore::Array3DKernelLinear< uint >& brickfeedbacks, const DataCachePoolKernelType& datacachepool );
 
 	/**
 	 * Produce data on device.
@@ -53,14 +53,16 @@ inline void ProducerKernel< TDataStructureType >
  *
  * @param maxdepth max depth
  * @param nodescache nodes cache
+ * @param brickfeedbacks bricks feedback
  * @param datacachepool data cache pool
  ******************************************************************************/
 template< typename TDataStructureType >
 inline void ProducerKernel< TDataStructureType >
-::init( uint maxdepth, const GvCore::Array3DKernelLinear< uint >& nodescache, const DataCachePoolKernelType& datacachepool )
+::init( uint maxdepth, const GvCore::Array3DKernelLinear< uint >& nodescache, const GvCore::Array3DKernelLinear< uint >& brickfeedbacks, const DataCachePoolKernelType& datacachepool )
 {
 	_maxDepth = maxdepth;
 	_cpuNodesCache = nodescache;
+	_cpuBricksFeedback = brickfeedbacks;
 	_cpuDataCachePool = datacachepool;
 }
 
@@ -159,6 +161,14 @@ inline uint ProducerKernel< TDataStructureType >
 				uint3 pNewElemAddress, const GvCore::GvLocalizationInfo& pParentLocInfo,
 				Loki::Int2Type< 1 > )
 {
+	// Data of this brick have not been loaded by the HOST producer :
+	// the brick is not produced, its node will request it again (same value for all threads of the brick)
+	const uint brickFeedback = _cpuBricksFeedback.get( pRequestID );
+	if ( brickFeedback != 0 )
+	{
+		return brickFeedback;
+	}
+
 	// parentLocDepth++; //Shift needed, to be corrected
 	bool nonNull = ProducerKernel_ChannelLoad< TDataStructureType, TGPUPoolKernelType, GvCore::DataNumChannels< DataTList >::value - 1>::produceDataChannel( *this, pDataPool, pNewElemAddress, pParentLocInfo, pRequestID, pProcessID );
 
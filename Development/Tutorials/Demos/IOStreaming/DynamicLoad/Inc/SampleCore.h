@@ -63,6 +63,12 @@ class Producer;
 // Custom Shader
 class ShaderKernel;
 
+namespace GvUtils
+{
+	template< typename TDataTypeList >
+	class GvTimeSeriesDataLoader;
+}
+
 /******************************************************************************
  ***************************** TYPE DEFINITION ********************************
  ******************************************************************************/
@@ -70,6 +76,9 @@ class ShaderKernel;
 // Defines the type list representing the content of one voxel
 typedef Loki::TL::MakeTypelist< uchar4 >::Result DataType;
 
+// Defines the loader of time-varying datasets
+typedef GvUtils::GvTimeSeriesDataLoader< DataType > TimeSeriesLoaderType;
+
 // Defines the size of a node tile
 typedef GvCore::StaticRes1D< 2 > NodeRes;
 
@@ -220,6 +229,16 @@ public:
 	 */
 	void setLightPosition( float pX, float pY, float pZ );
 
+	/**
+	 * Start or stop the playback of the time steps of a time-varying dataset
+	 */
+	void toggleTimeSeriesPlayback();
+
+	/**
+	 * Move to the next time step of a time-varying dataset (the first one after the last one)
+	 */
+	void nextTimeSeriesStep();
+
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
 	 **************************************************************************/
@@ -297,6 +316,16 @@ private:
 	 */
 	uint _maxVolTreeDepth;
 
+	/**
+	 * Loader of a time-varying dataset (owned by the producer, NULL for a static dataset)
+	 */
+	TimeSeriesLoaderType* _timeSeriesLoader;
+
+	/**
+	 * Flag to tell wheter or not time steps are played
+	 */
+	bool _isTimeSeriesPlaying;
+
 	/******************************** METHODS *********************************/
 
 };
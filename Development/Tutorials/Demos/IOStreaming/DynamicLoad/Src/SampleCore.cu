@@ -38,6 +38,8 @@
 #include <GvUtils/GvSimplePipeline.h>
 #include <GvUtils/GvSimpleHostShader.h>
 #include <GvUtils/GvDataLoader.h>
+#include <GvUtils/GvSharedBrickLoader.h>
+#include <GvUtils/GvTimeSeriesDataLoader.h>
 #include <GvUtils/GvCommonGraphicsPass.h>
 #include <GvCore/GvError.h>
 #include <GvPerfMon/GvPerformanceMonitor.h>
@@ -52,6 +54,11 @@
 #include <QString>
 #include <QDir>
 
+// STL
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
 /******************************************************************************
  ****************************** NAMESPACE SECTION *****************************
  ******************************************************************************/
@@ -88,6 +95,8 @@ SampleCore::SampleCore()
 ,	_displayOctree( false )
 ,	_displayPerfmon( 0 )
 ,	_maxVolTreeDepth( 16 )
+,	_timeSeriesLoader( NULL )
+,	_isTimeSeriesPlaying( false )
 {
 }
 
@@ -134,10 +143,57 @@ void SampleCore::init()
 	// Producer creation
 	QString dataRepository = QCoreApplication::applicationDirPath() + QDir::separator() + QString( "Data" );
 	QString filename = dataRepository + QDir::separator() + QString( "Voxels" ) + QDir::separator() + QString( "xyzrgb_dragon512_BR8_B1" ) + QDir::separator() + QString( "xyzrgb_dragon.xml" );
-	GvUtils::GvDataLoader< DataType >* dataLoader = new GvUtils::GvDataLoader< DataType >(
+	GvUtils::GvIDataLoader< DataType >* dataLoader = NULL;
+	const char* timeSeriesFilename = getenv( "GV_TIME_SERIES_FILE" );
+	const char* brickServerSocket = getenv( "GV_BRICK_SERVER_SOCKET" );
+	if ( timeSeriesFilename != NULL )
+	{
+		// Time-varying dataset (see GvDataPacker "timeseries" mode), next time steps are decoded in the background
+		TimeSeriesLoaderType* timeSeriesLoader = new TimeSeriesLoaderType( timeSeriesFilename, PipelineType::BrickTileResolution::get(), PipelineType::BrickTileBorderSize );
+		if ( timeSeriesLoader->getNbSteps() > 0 )
+		{
+			_timeSeriesLoader = timeSeriesLoader;
+			dataLoader = timeSeriesLoader;
+		}
+		else
+		{
+			std::cerr << "SampleCore::init() : the time series " << timeSeriesFilename << " can't be used, bricks are read from the dataset files" << std::endl;
+
+			delete timeSeriesLoader;
+		}
+	}
+	else if ( brickServerSocket != NULL )
+	{
+		// Share the host cache of a local brick server (see Tools/GvBrickServer)
+		GvUtils::GvSharedBrickLoader< DataType >* sharedLoader = new GvUtils::GvSharedBrickLoader< DataType >( brickServerSocket );
+
+		// The served dataset must match the brick layout of the pipeline
+		const uint3 brickResolution = sharedLoader->getBrickResolution();
+		const uint3 pipelineBrickResolution = PipelineType::BrickTileResolution::get();
+		if ( sharedLoader->isConnected()
+			&& brickResolution.x == pipelineBrickResolution.x && brickResolution.y == pipelineBrickResolution.y && brickResolution.z == pipelineBrickResolution.z
+			&& sharedLoader->getBorderSize() == PipelineType::BrickTileBorderSize )
+		{
+			// Bricks that can't be acquired from the server are read from the dataset files
+			sharedLoader->setFallbackLoader( new GvUtils::GvDataLoader< DataType >(
+														filename.toStdString(),
+														PipelineType::BrickTileResolution::get(), PipelineType::BrickTileBorderSize, false ) );
+			dataLoader = sharedLoader;
+		}
+		else
+		{
+			std::cerr << "SampleCore::init() : the brick server can't be used (not connected or brick layout mismatch), bricks are read from the dataset files" << std::endl;
+
+			delete sharedLoader;
+		}
+	}
+	if ( dataLoader == NULL )
+	{
+		dataLoader = new GvUtils::GvDataLoader< DataType >(
 														filename.toStdString(),
 														PipelineType::BrickTileResolution::get(), PipelineType::BrickTileBorderSize, true );
 													//	make_uint3( 512 ), BrickRes::get(), BrickBorderSize, false );
+	}
 	ProducerType* producer = new ProducerType( 64 * 1024 * 1024, nodePoolRes.x * nodePoolRes.y * nodePoolRes.z );
 	producer->attachProducer( dataLoader );
 	
@@ -221,6 +277,12 @@ void SampleCore::draw()
 
 	CUDAPM_STOP_EVENT( app_init_frame );
 
+	// Time-varying dataset playback
+	if ( _isTimeSeriesPlaying )
+	{
+		nextTimeSeriesStep();
+	}
+
 	// render the scene into textures
 	_pipeline->execute(modelMatrix, viewMatrix, projectionMatrix, viewport);
 
@@ -465,3 +527,41 @@ void SampleCore::setLightPosition( float pX, float pY, float pZ )
 	float3 lightPosition = make_float3( pX, pY, pZ ) - translation;
 	GV_CUDA_SAFE_CALL( cudaMemcpyToSymbol( cLightPosition, &lightPosition, sizeof( lightPosition ), 0, cudaMemcpyHostToDevice ) );
 }
+
+/******************************************************************************
+ * Start or stop the playback of the time steps of a time-varying dataset
+ ******************************************************************************/
+void SampleCore::toggleTimeSeriesPlayback()
+{
+	if ( _timeSeriesLoader == NULL )
+	{
+		return;
+	}
+
+	_isTimeSeriesPlaying = ! _isTimeSeriesPlaying;
+}
+
+/******************************************************************************
+ * Move to the next time step of a time-varying dataset (the first one after the last one)
+ ******************************************************************************/
+void SampleCore::nextTimeSeriesStep()
+{
+	if ( _timeSeriesLoader == NULL )
+	{
+		return;
+	}
+
+	const unsigned int step = ( _timeSeriesLoader->getStep() + 1 ) % _timeSeriesLoader->getNbSteps();
+	std::vector< GvCore::GvMortonCode::ValueType > changedNodes;
+	if ( ! _timeSeriesLoader->setStep( step, changedNodes ) )
+	{
+		std::cerr << "SampleCore::nextTimeSeriesStep() : unable to move to time step " << step << std::endl;
+
+		_isTimeSeriesPlaying = false;
+
+		return;
+	}
+
+	// Only the nodes that have changed are produced again, the rest of the cache stays resident
+	_pipeline->editCache()->invalidateNodes( changedNodes );
+}
@@ -246,6 +246,16 @@ void SampleViewer::keyPressEvent( QKeyEvent* pEvent )
 			_sampleCore->setLightPosition( 0.75f, 0.75f, 0.75f );
 			break;
 
+		case Qt::Key_P:
+			// Start or stop the playback of a time-varying dataset (see GV_TIME_SERIES_FILE)
+			_sampleCore->toggleTimeSeriesPlayback();
+			break;
+
+		case Qt::Key_N:
+			// Move to the next time step of a time-varying dataset
+			_sampleCore->nextTimeSeriesStep();
+			break;
+
 		default:
 			QGLViewer::keyPressEvent( pEvent );
 			break;
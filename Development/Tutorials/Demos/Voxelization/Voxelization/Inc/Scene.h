@@ -61,19 +61,38 @@
  ******************************************************************************/
 
 /**
- * ...
+ * Octree node of the scene.
+ *
+ * A node references two ranges :
+ * - the "core" range of the index buffer holds the triangles whose centroid lies in the node.
+ *   Triangles are sorted by the Morton code of their centroid, so core ranges
+ *   of all nodes are nested sub-ranges of the same triangle list (no copy).
+ * - the "border" range of the border triangle references (shared by all nodes) holds
+ *   the other triangles intersecting the node (extended by the brick border),
+ *   i.e. triangles straddling node boundaries. The index buffer is never duplicated.
  */
 struct node
 {
 	/**
-	 * ...
+	 * Start index of the core range in the index buffer
 	 */
 	unsigned int first;
 
 	/**
-	 * ...
+	 * Number of indices of the core range (3 per triangle).
+	 * -1 means the node has not been computed.
 	 */
 	int count;
+
+	/**
+	 * Start index of the border range in the border triangle references
+	 */
+	unsigned int borderFirst;
+
+	/**
+	 * Number of triangles of the border range
+	 */
+	int borderCount;
 };
 
 /******************************************************************************
@@ -209,17 +228,68 @@ private:
 	 */
 	unsigned int mIBOLengthMax;
 
+	/**
+	 * Border triangle references shared by all nodes (start index of triangles in the index buffer).
+	 * Nodes reference ranges of this array.
+	 */
+	std::vector< unsigned int > mBorderTriangles;
+
+	/**
+	 * Number of indices of each border triangle (always 3), used to draw a border range in one call
+	 */
+	std::vector< GLsizei > mBorderTriangleCounts;
+
+	/**
+	 * Byte offsets in the index buffer of the border triangles of the drawn node
+	 */
+	mutable std::vector< const GLvoid* > mBorderTriangleOffsets;
+
 	/******************************** METHODS *********************************/
+
+	/**
+	 * Draw the triangles of a node (core and border ranges)
+	 *
+	 * @param pNode the node
+	 */
+	void drawNode( const node& pNode ) const;
 	
 	/**
-	 * ...
+	 * Build the octree of the scene up to the max precomputed depth.
+	 *
+	 * Triangles of the index buffer are first sorted by the Morton code of their centroid,
+	 * then each depth is built in parallel. Border triangles are referenced in a shared array.
+	 *
+	 * @param IBO index buffer
+	 * @param vertices position buffer
 	 */
 	void organizeIBO( std::vector< unsigned int >& IBO, const float* vertices );
 	
 	/**
-	 * ...
+	 * Compute the triangles intersecting a node.
+	 * Candidates are the triangles of its father.
+	 *
+	 * @param d node's depth localization info
+	 * @param locCode node's code localization info
+	 * @param IBO index buffer (sorted by Morton code of triangle centroids)
+	 * @param mortonCodes sorted Morton codes of triangle centroids
+	 * @param vertices position buffer
+	 * @param borderTriangles list of border triangles (start index in the index buffer)
+	 *
+	 * @return the number of triangles intersecting the node
 	 */
-	bool organizeNode( unsigned int d, const uint3& locCode, std::vector< unsigned int >& IBO, const float* vertices );
+	unsigned int organizeNode( unsigned int d, const uint3& locCode, const std::vector< unsigned int >& IBO,
+								const std::vector< unsigned int >& mortonCodes, const float* vertices,
+								std::vector< unsigned int >& borderTriangles );
+
+	/**
+	 * Compute the Morton code of a node (interleaved bits of its localization code)
+	 *
+	 * @param pDepth node's depth localization info
+	 * @param pCode node's code localization info
+	 *
+	 * @return the Morton code
+	 */
+	inline unsigned int getMortonCode( unsigned int pDepth, const uint3& pCode ) const;
 
 	/**
 	 * ...
@@ -239,7 +309,15 @@ private:
 	inline unsigned int getIndex( unsigned int pDepth, const uint3& pCode ) const;
 	
 	/**
-	 * ...
+	 * Test if a triangle intersects a brick (exact separating axis test)
+	 *
+	 * @param brickPos brick position
+	 * @param brickSize brick size
+	 * @param triangleIndex start index of the triangle in the index buffer
+	 * @param IBO index buffer
+	 * @param vertices position buffer
+	 *
+	 * @return a flag telling wheter or not the triangle intersects the brick
 	 */
 	inline bool triangleIntersectBick( const float3& brickPos, 
 								const float3& brickSize, 
@@ -247,7 +325,7 @@ private:
 								const std::vector< unsigned int >& IBO, 
 								const float* vertices );
 	/**
-	 * ...
+	 * Test if a vertex lies in a brick
 	 */
 	inline bool vertexIsInBrick( const float3& brickPos, 
 								const float3& brickSize, 
@@ -63,7 +63,31 @@ inline unsigned int Scene::getIndex( unsigned int pDepth, const uint3& pCode ) c
 }
 
 /******************************************************************************
- * ...
+ * Compute the Morton code of a node (interleaved bits of its localization code)
+ *
+ * @param pDepth node's depth localization info
+ * @param pCode node's code localization info
+ *
+ * @return the Morton code
+ ******************************************************************************/
+inline unsigned int Scene::getMortonCode( unsigned int pDepth, const uint3& pCode ) const
+{
+	unsigned int code = 0;
+	for ( unsigned int bit = 0; bit < pDepth; bit++ )
+	{
+		code |= ( ( pCode.x >> bit ) & 1 ) << ( 3 * bit + 0 );
+		code |= ( ( pCode.y >> bit ) & 1 ) << ( 3 * bit + 1 );
+		code |= ( ( pCode.z >> bit ) & 1 ) << ( 3 * bit + 2 );
+	}
+
+	return code;
+}
+
+/******************************************************************************
+ * Test if a triangle intersects a brick (exact separating axis test)
+ *
+ * Axes are the 3 brick normals, the triangle normal
+ * and the 9 cross products of brick and triangle edges.
  ******************************************************************************/
 inline bool Scene::triangleIntersectBick( const float3& brickPos, 
 										  const float3& brickSize,  
@@ -71,13 +95,58 @@ inline bool Scene::triangleIntersectBick( const float3& brickPos,
 										  const std::vector< unsigned int >& IBO, 
 										  const float* vertices )
 {
-	// We assume here that triangle are much smaller than brick ( at least as small as voxel's brick ) so we simplify the intersection test.
-	// We only test if triangle's vertices are in the bick
-	
-	// Test vertices
-	return vertexIsInBrick( brickPos, brickSize, IBO[ triangleIndex + 0 ], vertices ) || 
-		   vertexIsInBrick( brickPos, brickSize, IBO[ triangleIndex + 1 ], vertices ) ||
-		   vertexIsInBrick( brickPos, brickSize, IBO[ triangleIndex + 2 ], vertices ) ;
+	// Fast accept : a vertex is in the brick
+	if ( vertexIsInBrick( brickPos, brickSize, IBO[ triangleIndex + 0 ], vertices ) || 
+		 vertexIsInBrick( brickPos, brickSize, IBO[ triangleIndex + 1 ], vertices ) ||
+		 vertexIsInBrick( brickPos, brickSize, IBO[ triangleIndex + 2 ], vertices ) )
+	{
+		return true;
+	}
+
+	// Move the triangle so that the brick is centered at origin
+	const float3 h = brickSize * 0.5f;
+	const float3 c = brickPos + h;
+	float3 v[ 3 ];
+	for ( unsigned int k = 0; k < 3; k++ )
+	{
+		const float* p = &vertices[ 3 * IBO[ triangleIndex + k ] ];
+		v[ k ] = make_float3( p[ 0 ], p[ 1 ], p[ 2 ] ) - c;
+	}
+
+	// Brick normals (i.e. triangle bounding box)
+	if ( fminf( fminf( v[ 0 ].x, v[ 1 ].x ), v[ 2 ].x ) > h.x || fmaxf( fmaxf( v[ 0 ].x, v[ 1 ].x ), v[ 2 ].x ) < -h.x ||
+		 fminf( fminf( v[ 0 ].y, v[ 1 ].y ), v[ 2 ].y ) > h.y || fmaxf( fmaxf( v[ 0 ].y, v[ 1 ].y ), v[ 2 ].y ) < -h.y ||
+		 fminf( fminf( v[ 0 ].z, v[ 1 ].z ), v[ 2 ].z ) > h.z || fmaxf( fmaxf( v[ 0 ].z, v[ 1 ].z ), v[ 2 ].z ) < -h.z )
+	{
+		return false;
+	}
+
+	// Triangle normal
+	const float3 e[ 3 ] = { v[ 1 ] - v[ 0 ], v[ 2 ] - v[ 1 ], v[ 0 ] - v[ 2 ] };
+	const float3 n = cross( e[ 0 ], e[ 2 ] );
+	const float r = h.x * fabsf( n.x ) + h.y * fabsf( n.y ) + h.z * fabsf( n.z );
+	if ( fabsf( dot( n, v[ 0 ] ) ) > r )
+	{
+		return false;
+	}
+
+	// Cross products of brick and triangle edges
+	const float3 axes[ 3 ] = { make_float3( 1.f, 0.f, 0.f ), make_float3( 0.f, 1.f, 0.f ), make_float3( 0.f, 0.f, 1.f ) };
+	for ( unsigned int i = 0; i < 3; i++ )
+	for ( unsigned int j = 0; j < 3; j++ )
+	{
+		const float3 a = cross( axes[ i ], e[ j ] );
+		const float p0 = dot( a, v[ 0 ] );
+		const float p1 = dot( a, v[ 1 ] );
+		const float p2 = dot( a, v[ 2 ] );
+		const float radius = h.x * fabsf( a.x ) + h.y * fabsf( a.y ) + h.z * fabsf( a.z );
+		if ( fminf( fminf( p0, p1 ), p2 ) > radius || fmaxf( fmaxf( p0, p1 ), p2 ) < -radius )
+		{
+			return false;
+		}
+	}
+
+	return true;
 }
 
 /******************************************************************************
@@ -41,6 +41,10 @@
 #include <limits>
 #include <cassert>
 
+// STL
+#include <algorithm>
+#include <utility>
+
 // Assimp
 #include <assimp/cimport.h>
 #include <assimp/postprocess.h>
@@ -69,6 +73,26 @@
  */
 static aiLogStream stream;
 
+/**
+ * Split heuristic of the octree build.
+ * A node shares the triangle lists of its father when its own lists would hold
+ * more than this ratio of its father's triangles.
+ */
+static const float cMaxTriangleRatio = 0.5f;
+
+/**
+ * Max number of border triangles of a node.
+ * A node with more border triangles shares the triangle lists of its father.
+ */
+static const unsigned int cMaxBorderTriangles = 16384;
+
+/**
+ * Max number of border triangle references of the octree, relative to the number of triangles.
+ * Once it is reached, nodes share the triangle lists of their father,
+ * so that memory stays linear in the number of triangles.
+ */
+static const float cMaxBorderReferenceRatio = 2.0f;
+
 /******************************************************************************
  ***************************** TYPE DEFINITION ********************************
  ******************************************************************************/
@@ -98,6 +122,8 @@ Scene::Scene( unsigned int pMaxDepth )
 	{
 		mOctree[ i ].first = 0;
 		mOctree[ i ].count = -1;
+		mOctree[ i ].borderFirst = 0;
+		mOctree[ i ].borderCount = 0;
 	}
 }
 
@@ -185,10 +211,8 @@ void Scene::init( char* pSceneFile )
 	unsigned int* count = new unsigned int[ nbVertices ](); // To count the normals, to average
 
 	std::vector< unsigned int > IBO = std::vector< unsigned int >();
-	// Reserve place to store the IBO
-	// We assume that a triangle can intersect 3 brick in the worst case
-	IBO.reserve( 3 * ( 1 + mDepthMaxPrecomputed * 3 ) * mNbTriangle );		// TODO, if too big use several index buffers ?
 	// Resize vector to store the depth lvl 0 
+	// (border triangles of the octree are referenced, not appended)
 	IBO.resize( 3 * mNbTriangle );
 
 	unsigned int offsetIBO = 0;
@@ -350,19 +374,9 @@ void Scene::draw( unsigned int depth ) const
 	int maxNodeIndex = ( powf( 8, depth + 1 ) - 1 ) / (float)7;
 	for ( int i = minNodeIndex; i < maxNodeIndex; i++ )
 	{
-		if ( mOctree[ i ].count != 0 )
+		if ( mOctree[ i ].count > 0 || mOctree[ i ].borderCount > 0 )
 		{
-			// Render VAO
-			glBindVertexArray( mVAO[ 0 ] );
-			glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, mBuffers[ 2 ] );
-			
-			glDrawElements( GL_TRIANGLES,  
-				mOctree[ i ].count, 
-				GL_UNSIGNED_INT,
-				(void*)( sizeof( unsigned int ) * mOctree[ i ].first ) );
-
-			glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
-			glBindVertexArray( 0 );
+			drawNode( mOctree[ i ] );
 		}
 	}
 }
@@ -377,29 +391,55 @@ void Scene::draw( unsigned int pDepth, const uint3& pCode ) const
 {
 	// Compute index of the node in the octree
 	unsigned int i = getIndex( pDepth, pCode );
-	if ( pDepth > mDepthMaxPrecomputed )
+	if ( pDepth > mDepthMaxPrecomputed || mOctree[ i ].count == -1 )
 	{
 		return draw( pDepth - 1, getFather( pCode ) );
 	}
 	else
 	{
-		if ( mOctree[i].count != 0 )
+		if ( mOctree[ i ].count > 0 || mOctree[ i ].borderCount > 0 )
 		{
-			// Render VAO
-			glBindVertexArray( mVAO[ 0 ] );
-			glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, mBuffers[ 2 ] );
-				
-			glDrawElements( GL_TRIANGLES,  
-				mOctree[ i ].count, 
-				GL_UNSIGNED_INT,
-				(void*)( sizeof( unsigned int ) * mOctree[ i ].first ) );
-			
-			glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
-			glBindVertexArray( 0 );
+			drawNode( mOctree[ i ] );
 		}
 	}
 }
 
+/******************************************************************************
+ * Draw the triangles of a node (core and border ranges)
+ *
+ * @param pNode the node
+ ******************************************************************************/
+void Scene::drawNode( const node& pNode ) const
+{
+	// Render VAO
+	glBindVertexArray( mVAO[ 0 ] );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, mBuffers[ 2 ] );
+
+	// Triangles whose centroid lies in the node
+	glDrawElements( GL_TRIANGLES,  
+		pNode.count, 
+		GL_UNSIGNED_INT,
+		BUFFER_OFFSET( sizeof( unsigned int ) * pNode.first ) );
+
+	// Triangles straddling the node boundaries : they are referenced in the index buffer
+	if ( pNode.borderCount > 0 )
+	{
+		mBorderTriangleOffsets.resize( pNode.borderCount );
+		for ( int i = 0; i < pNode.borderCount; i++ )
+		{
+			mBorderTriangleOffsets[ i ] = BUFFER_OFFSET( sizeof( unsigned int ) * mBorderTriangles[ pNode.borderFirst + i ] );
+		}
+		glMultiDrawElements( GL_TRIANGLES,
+			&mBorderTriangleCounts[ 0 ],
+			GL_UNSIGNED_INT,
+			&mBorderTriangleOffsets[ 0 ],
+			pNode.borderCount );
+	}
+
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+	glBindVertexArray( 0 );
+}
+
 /******************************************************************************
  * Test intersection of a node and the mesh, given its localization info (depth and code)
  *
@@ -420,7 +460,7 @@ uint Scene::intersectMesh( unsigned int depth, const uint3& locCode ) const
 	}
 	else
 	{
-		if ( mOctree[ i ].count != 0 )
+		if ( mOctree[ i ].count != 0 || mOctree[ i ].borderCount != 0 )
 		{
 			if ( depth == mDepthMax )
 			{
@@ -440,94 +480,154 @@ uint Scene::intersectMesh( unsigned int depth, const uint3& locCode ) const
 }
 
 /******************************************************************************
- * Fill the index buffer from vertices
+ * Build the octree of the scene up to the max precomputed depth.
+ *
+ * Triangles of the index buffer are first sorted by the Morton code of their centroid,
+ * then each depth is built in parallel. Border triangles are referenced in a shared array.
  *
  * @param pIndices index buffer
  * @param pVertices position buffer
  ******************************************************************************/
 void Scene::organizeIBO( std::vector< unsigned int >& pIndices, const float* pVertices )
 {
-	// Temporary buffer
-	std::list< uint3 >* nodes = new std::list< uint3 >();
-	std::list< uint3 >* nodesNextDepth = new std::list< uint3 >();
+	const unsigned int nbCells = 1 << mDepthMaxPrecomputed;
 
-	unsigned int depth = 0;
+	// Sort triangles by the Morton code of their centroid (at max precomputed depth).
+	// The triangles whose centroid lies in a node are then contiguous at all depths.
+	std::vector< std::pair< unsigned int, unsigned int > > triangleCodes( mNbTriangle );
+	for ( unsigned int i = 0; i < mNbTriangle; i++ )
+	{
+		uint3 cell;
+		unsigned int* cellPtr = &cell.x;
+		for ( unsigned int k = 0; k < 3; k++ )
+		{
+			const float centroid = ( pVertices[ 3 * pIndices[ 3 * i + 0 ] + k ] + pVertices[ 3 * pIndices[ 3 * i + 1 ] + k ] + pVertices[ 3 * pIndices[ 3 * i + 2 ] + k ] ) / 3.f;
+			const int position = static_cast< int >( centroid * nbCells );
+			cellPtr[ k ] = static_cast< unsigned int >( std::min( std::max( position, 0 ), static_cast< int >( nbCells ) - 1 ) );
+		}
+		triangleCodes[ i ] = std::make_pair( getMortonCode( mDepthMaxPrecomputed, cell ), i );
+	}
+	std::sort( triangleCodes.begin(), triangleCodes.end() );
+
+	std::vector< unsigned int > mortonCodes( mNbTriangle );
+	std::vector< unsigned int > sortedIndices( 3 * mNbTriangle );
+	for ( unsigned int i = 0; i < mNbTriangle; i++ )
+	{
+		mortonCodes[ i ] = triangleCodes[ i ].first;
+		sortedIndices[ 3 * i + 0 ] = pIndices[ 3 * triangleCodes[ i ].second + 0 ];
+		sortedIndices[ 3 * i + 1 ] = pIndices[ 3 * triangleCodes[ i ].second + 1 ];
+		sortedIndices[ 3 * i + 2 ] = pIndices[ 3 * triangleCodes[ i ].second + 2 ];
+	}
+	std::vector< std::pair< unsigned int, unsigned int > >().swap( triangleCodes );
+	pIndices.swap( sortedIndices );
+	std::vector< unsigned int >().swap( sortedIndices );
+
+	// The number of border references is capped so that memory stays linear
+	mBorderTriangles.clear();
+	const size_t maxNbBorderTriangles = static_cast< size_t >( cMaxBorderReferenceRatio * mNbTriangle );
 
 	// Init algorithm with first node at depth 0
 	mOctree[ 0 ].first = 0;
-	mOctree[ 0 ].count = mNbTriangle * 3 - 1;	// TODO : only work for triangles primitives...
-
-	// Move on the next depth level
-	depth++;
+	mOctree[ 0 ].count = mNbTriangle * 3;	// TODO : only work for triangles primitives...
+	mOctree[ 0 ].borderFirst = 0;
+	mOctree[ 0 ].borderCount = 0;
 
-	// Initialize node addresses (8 children)
-	// - [ x,y,z ] triplet
-	//
-	// TODO : only work for octrees...
-	nodes->push_back( make_uint3( 0, 0, 0 ) );
-	nodes->push_back( make_uint3( 1, 0, 0 ) );
-	nodes->push_back( make_uint3( 0, 1, 0 ) );
-	nodes->push_back( make_uint3( 1, 1, 0 ) );
-	nodes->push_back( make_uint3( 0, 0, 1 ) );
-	nodes->push_back( make_uint3( 1, 0, 1 ) );
-	nodes->push_back( make_uint3( 0, 1, 1 ) );
-	nodes->push_back( make_uint3( 1, 1, 1 ) );
+	// Nodes to process at current depth
+	std::vector< uint3 > nodes;
+	if ( mNbTriangle > 0 )
+	{
+		nodes.push_back( make_uint3( 0, 0, 0 ) );
+	}
 
 	// Iterate through depth
-	while ( depth <= mDepthMaxPrecomputed )
+	for ( unsigned int depth = 1; depth <= mDepthMaxPrecomputed && ! nodes.empty(); depth++ )
 	{
-		// For each nodes of this depth we organize the index buffer 
-		while ( ! nodes->empty() )
+		// Children of nodes containing triangles
+		//
+		// TODO : only work for octrees...
+		std::vector< uint3 > children;
+		children.reserve( 8 * nodes.size() );
+		for ( size_t i = 0; i < nodes.size(); i++ )
 		{
-			// Retrieve next node to treat it 
-			uint3 currentBrick = nodes->front();
-
-			// Remove first node (reduce size)
-			nodes->pop_front();
-
-			// Check if at least one primitive (i.e. triangle) intersect current node
-			if ( organizeNode( depth, currentBrick, pIndices, pVertices ) )
+			for ( unsigned int k = 0; k < 8; k++ )
 			{
-				// If there are triangles in this node, add its children to node list (8 children)
-				// - [ x,y,z ] triplet
-				//
-				// TODO : only work for octrees...
-				nodesNextDepth->push_back( currentBrick * 2 );
-				nodesNextDepth->push_back( currentBrick * 2 + make_uint3( 1, 0, 0 ) );
-				nodesNextDepth->push_back( currentBrick * 2 + make_uint3( 0, 1, 0 ) );
-				nodesNextDepth->push_back( currentBrick * 2 + make_uint3( 1, 1, 0 ) );
-				nodesNextDepth->push_back( currentBrick * 2 + make_uint3( 0, 0, 1 ) );
-				nodesNextDepth->push_back( currentBrick * 2 + make_uint3( 1, 0, 1 ) );
-				nodesNextDepth->push_back( currentBrick * 2 + make_uint3( 0, 1, 1 ) );
-				nodesNextDepth->push_back( currentBrick * 2 + make_uint3( 1, 1, 1 ) );
+				children.push_back( nodes[ i ] * 2 + make_uint3( k & 1, ( k >> 1 ) & 1, ( k >> 2 ) & 1 ) );
 			}
 		}
+		nodes.clear();
+
+		// Nodes of a given depth are independent : process them in parallel.
+		// The index buffer and the border references are only read during this step.
+		const int nbChildren = static_cast< int >( children.size() );
+		std::vector< unsigned int > nbTriangles( nbChildren );
+		std::vector< std::vector< unsigned int > > borderTriangles( nbChildren );
+#ifdef _OPENMP
+		#pragma omp parallel for schedule( dynamic, 8 )
+#endif
+		for ( int i = 0; i < nbChildren; i++ )
+		{
+			nbTriangles[ i ] = organizeNode( depth, children[ i ], pIndices, mortonCodes, pVertices, borderTriangles[ i ] );
+		}
 
-		// We go on to the next depth level
-		depth++;
+		// Append border triangle references to the shared array
+		for ( int i = 0; i < nbChildren; i++ )
+		{
+			node& currentNode = mOctree[ getIndex( depth, children[ i ] ) ];
+			if ( ! borderTriangles[ i ].empty() )
+			{
+				if ( mBorderTriangles.size() + borderTriangles[ i ].size() <= maxNbBorderTriangles )
+				{
+					currentNode.borderFirst = static_cast< unsigned int >( mBorderTriangles.size() );
+					currentNode.borderCount = static_cast< int >( borderTriangles[ i ].size() );
+					mBorderTriangles.insert( mBorderTriangles.end(), borderTriangles[ i ].begin(), borderTriangles[ i ].end() );
+				}
+				else
+				{
+					// No more references : share the father's lists
+					const node& father = mOctree[ getIndex( depth - 1, getFather( children[ i ] ) ) ];
+					currentNode.first = father.first;
+					currentNode.count = father.count;
+					currentNode.borderFirst = father.borderFirst;
+					currentNode.borderCount = father.borderCount;
+				}
+				std::vector< unsigned int >().swap( borderTriangles[ i ] );
+			}
 
-		// Swap list of nodes
-		std::list< uint3 >* nodesAux = nodes;
-		nodes = nodesNextDepth; // new list of nodes to process
-		nodesNextDepth = nodesAux; // empty list of nodes
+			// If there are triangles in this node, its children will be processed
+			if ( nbTriangles[ i ] > 0 )
+			{
+				nodes.push_back( children[ i ] );
+			}
+		}
 	}
 
-	// Free memory
-	delete nodes;
-	delete nodesNextDepth;
+	// A border range is drawn in one call : each referenced triangle has 3 indices
+	mBorderTriangleCounts.assign( std::min( static_cast< size_t >( cMaxBorderTriangles ), mBorderTriangles.size() ), 3 );
+
+	// LOG
+	std::cout << "Scene : octree built (" << mNbTriangle << " triangles, " << mBorderTriangles.size() << " border references)" << std::endl;
 }
 
 /******************************************************************************
- * ...
+ * Compute the triangles intersecting a node.
+ * Candidates are the triangles of its father.
+ *
+ * A node shares the lists of its father when its own lists would not be
+ * significantly smaller (i.e. large triangles straddling the node)
+ * or when it has too many border triangles : this caps the length of border lists.
  *
  * @param pDepth node's depth localization info
  * @param pCode node's code localization info
- * @param pIndices index buffer
+ * @param pIndices index buffer (sorted by Morton code of triangle centroids)
+ * @param pMortonCodes sorted Morton codes of triangle centroids
  * @param pVertices position buffer
+ * @param pBorderTriangles list of border triangles (start index in the index buffer)
  *
- * @return a flag telling wheter or not at least one primitive (i.e. triangle) intersect the node
+ * @return the number of triangles intersecting the node
  ******************************************************************************/
-bool Scene::organizeNode( unsigned int pDepth, const uint3& pCode, std::vector< unsigned int >& pIndices, const float* pVertices )
+unsigned int Scene::organizeNode( unsigned int pDepth, const uint3& pCode, const std::vector< unsigned int >& pIndices,
+								  const std::vector< unsigned int >& pMortonCodes, const float* pVertices,
+								  std::vector< unsigned int >& pBorderTriangles )
 {
 	// Retrieve brick size and real coordinate and father index
 	//
@@ -536,29 +636,54 @@ bool Scene::organizeNode( unsigned int pDepth, const uint3& pCode, std::vector<
 	float3 brickPos = make_float3( pCode ) / make_float3( 1 << pDepth ) - make_float3( 1.0 / 8.0 ) / make_float3( 1 << pDepth );
 	float3 brickSize = make_float3( 1.0 ) / make_float3( 1 << pDepth ) + make_float3( 2.0 / 8.0 ) / make_float3( 1 << pDepth );
 
-	unsigned int index = getIndex( pDepth, pCode );
-	unsigned int indexFather = getIndex( pDepth - 1, getFather( pCode ) ); 
-	unsigned int count = 0; // Number of triangle that intersect the brick
-	unsigned int begin = pIndices.size();
+	node& currentNode = mOctree[ getIndex( pDepth, pCode ) ];
+	const node& father = mOctree[ getIndex( pDepth - 1, getFather( pCode ) ) ];
+
+	// Core range : triangles whose centroid lies in the node (no test required)
+	const unsigned int shift = 3 * ( mDepthMaxPrecomputed - pDepth );
+	const unsigned int mortonCode = getMortonCode( pDepth, pCode );
+	const unsigned int coreBegin = static_cast< unsigned int >( std::lower_bound( pMortonCodes.begin(), pMortonCodes.end(), mortonCode << shift ) - pMortonCodes.begin() );
+	const unsigned int coreEnd = static_cast< unsigned int >( std::lower_bound( pMortonCodes.begin(), pMortonCodes.end(), ( mortonCode + 1 ) << shift ) - pMortonCodes.begin() );
 
-	// We test for each father's triangle if they intersect this birck
-	for ( unsigned int i = mOctree[ indexFather ].first; i < mOctree[ indexFather ].first + mOctree[ indexFather ].count; i+=3 )
+	// Border triangles : father's triangles that are not in the core range and intersect the node
+	pBorderTriangles.clear();
+	for ( unsigned int i = father.first; i < father.first + father.count; i += 3 )
 	{
-		// Test if triangle intersect node
+		if ( ( i < 3 * coreBegin || i >= 3 * coreEnd ) && triangleIntersectBick( brickPos, brickSize, i, pIndices, pVertices ) )
+		{
+			pBorderTriangles.push_back( i );
+		}
+	}
+	for ( int r = 0; r < father.borderCount; r++ )
+	{
+		const unsigned int i = mBorderTriangles[ father.borderFirst + r ];
 		if ( triangleIntersectBick( brickPos, brickSize, i, pIndices, pVertices ) )
 		{
-			count += 3;
-
-			pIndices.push_back( pIndices[ i ] );
-			pIndices.push_back( pIndices[ i + 1 ] );
-			pIndices.push_back( pIndices[ i + 2 ] );
+			pBorderTriangles.push_back( i );
 		}
 	}
 
-	mOctree[ index ].first = begin;
-	mOctree[ index ].count = count;
+	const unsigned int nbTriangles = ( coreEnd - coreBegin ) + static_cast< unsigned int >( pBorderTriangles.size() );
+	const unsigned int nbFatherTriangles = static_cast< unsigned int >( father.count / 3 + father.borderCount );
+
+	if ( ! pBorderTriangles.empty() && ( nbTriangles > cMaxTriangleRatio * nbFatherTriangles || pBorderTriangles.size() > cMaxBorderTriangles ) )
+	{
+		// Share the father's lists
+		currentNode.first = father.first;
+		currentNode.count = father.count;
+		currentNode.borderFirst = father.borderFirst;
+		currentNode.borderCount = father.borderCount;
+		pBorderTriangles.clear();
+	}
+	else
+	{
+		currentNode.first = 3 * coreBegin;
+		currentNode.count = 3 * ( coreEnd - coreBegin );
+		currentNode.borderFirst = 0;
+		currentNode.borderCount = 0;
+	}
 
-	return ( count > 0 );
+	return nbTriangles;
 }
 
 /******************************************************************************
@@ -39,6 +39,7 @@
 #include <GvCore/StaticRes3D.h>
 #include <GvCore/GvLocalizationInfo.h>
 #include <GvCore/GPUVoxelProducer.h>
+#include <GvStructure/GvProductionInfoKernel.h>
 
 // CUDA
 #include <cuda_runtime.h>
@@ -53,6 +54,19 @@
 __constant__ float cNoiseShellWidthUpperBound;
 __constant__ int cNoiseFillTheShape;
 
+/**
+ * Production info of nodes and bricks
+ *
+ * The recorded value range is the range of the distances tested against the noise shell (see getRGBA()).
+ */
+__constant__ GvStructure::GvProductionInfoKernel cProductionInfo;
+
+/**
+ * Dependency tags of produced nodes and bricks
+ */
+#define PRODUCER_SHELL_WIDTH_DEPENDENCY		0x1U
+#define PRODUCER_FILL_THE_SHAPE_DEPENDENCY	0x2U
+
 /******************************************************************************
  ***************************** TYPE DEFINITION ********************************
  ******************************************************************************/
@@ -228,11 +242,13 @@ private:
 	 *
 	 * @param regionCoords region coordinates
 	 * @param regionDepth region depth
+	 * @param pMinDistance min distance tested against the noise shell the type depends on
+	 * @param pMaxDistance max distance tested against the noise shell the type depends on
 	 *
 	 * @return the type of the region
 	 */
 	__device__
-	inline GPUVoxelProducer::GPUVPRegionInfo getRegionInfo( uint3 regionCoords, uint regionDepth );
+	inline GPUVoxelProducer::GPUVPRegionInfo getRegionInfo( uint3 regionCoords, uint regionDepth, float& pMinDistance, float& pMaxDistance );
 
 };
 
@@ -35,6 +35,9 @@
 // GigaVoxels
 #include <GvStructure/GvNode.h>
 #include <GvUtils/GvNoiseKernel.h>
+
+// System
+#include <cfloat>
 //#include <GvStructure/GvVolumeTree.h>
 
 /******************************************************************************
@@ -52,11 +55,12 @@ texture< float4, cudaTextureType3D, cudaReadModeElementType > volumeTex;
  * @param voxelPosF 3D position in the current brick
  * @param levelRes number of voxels at the current brick resolution
  * @param levelDepth Depth of the current node
+ * @param pTestDistance the distance tested against the noise shell
  *
  * @return computed RGBA color
  ******************************************************************************/
 __device__
-uchar getRGBA( float3 voxelPosF, uint3 levelRes, uint levelDepth )
+uchar getRGBA( float3 voxelPosF, uint3 levelRes, uint levelDepth, float& pTestDistance )
 {
 	// Retrieve "normal" and "distance" from signed distance fied of user's 3D model
 	float4 voxelNormalAndDist = tex3D( volumeTex, voxelPosF.x, voxelPosF.y, voxelPosF.z );
@@ -109,9 +113,28 @@ uchar getRGBA( float3 voxelPosF, uint3 levelRes, uint levelDepth )
 		color = 0;
 	}
 
+	pTestDistance = testDistance;
+
 	return color;
 }
 
+/******************************************************************************
+ * Get the parameters produced data depends on (i.e. its dependency tags)
+ *
+ * @return the dependency tags of produced data
+ ******************************************************************************/
+__device__
+uint getDependencyTags()
+{
+	// Color displacement does not test distances against the noise shell
+	if ( cNoiseFillTheShape == 1 )
+	{
+		return PRODUCER_FILL_THE_SHAPE_DEPENDENCY;
+	}
+
+	return PRODUCER_SHELL_WIDTH_DEPENDENCY | PRODUCER_FILL_THE_SHAPE_DEPENDENCY;
+}
+
 /******************************************************************************
  * Get the normal of distance field + noise
  *
@@ -203,7 +226,9 @@ inline uint ProducerKernel< TDataStructureType >
 		newnode.brickAddress = 0;
 
 		// Call what we call an oracle that will determine the type of the region of the node accordingly
-		GPUVoxelProducer::GPUVPRegionInfo nodeinfo = getRegionInfo( regionCoords, regionDepth );
+		float minDistance;
+		float maxDistance;
+		GPUVoxelProducer::GPUVPRegionInfo nodeinfo = getRegionInfo( regionCoords, regionDepth, minDistance, maxDistance );
 
 		// Now that the type of the region is found, fill the new node information
 		if ( nodeinfo == GPUVoxelProducer::GPUVP_CONSTANT )
@@ -228,6 +253,9 @@ inline uint ProducerKernel< TDataStructureType >
 		// newElemAddress.x + processID : is the adress of the new node in the node pool
 		nodePool.getChannel( Loki::Int2Type< 0 >() ).set( newElemAddress.x + processID, newnode.childAddress );
 		nodePool.getChannel( Loki::Int2Type< 1 >() ).set( newElemAddress.x + processID, newnode.brickAddress );
+
+		// Record the distances the type of the node depends on
+		cProductionInfo.setNodeInfo( newElemAddress.x + processID, minDistance, maxDistance, ( nodeinfo == GPUVoxelProducer::GPUVP_DATA_MAXRES ) ? 0 : getDependencyTags() );
 	}
 
 	return 0;
@@ -315,6 +343,8 @@ inline uint ProducerKernel< TDataStructureType >
 	// One thread process only a subset of the voxels of the brick.
 	//
 	// Iterate through z axis step by step as blockDim.z is equal to 1
+	float minDistance = FLT_MAX;
+	float maxDistance = -FLT_MAX;
 	uint3 elemOffset;
 	for ( elemOffset.z = 0; elemOffset.z < elemSize.z; elemOffset.z += blockDim.z )
 	{
@@ -333,7 +363,10 @@ inline uint ProducerKernel< TDataStructureType >
 					const float3 voxelPosF = brickPosF + voxelPosInBrickF;
 
 					// Compute data
-					const uchar voxelColor = getRGBA( voxelPosF, levelRes, regionDepth.x );
+					float testDistance;
+					const uchar voxelColor = getRGBA( voxelPosF, levelRes, regionDepth.x, testDistance );
+					minDistance = fminf( minDistance, testDistance );
+					maxDistance = fmaxf( maxDistance, testDistance );
 
 					// Compute the new element's address
 					const uint3 destAddress = newElemAddress + locOffset;
@@ -344,6 +377,27 @@ inline uint ProducerKernel< TDataStructureType >
 		}
 	}
 
+	// Record the range of distances tested in the brick
+	if ( cProductionInfo.isEnabled() )
+	{
+		__shared__ float minDistances[ BricksKernelBlockSize::numElements ];
+		__shared__ float maxDistances[ BricksKernelBlockSize::numElements ];
+		const uint threadIndex = threadIdx.x + blockDim.x * ( threadIdx.y + blockDim.y * threadIdx.z );
+		minDistances[ threadIndex ] = minDistance;
+		maxDistances[ threadIndex ] = maxDistance;
+		__syncthreads();
+
+		if ( threadIndex == 0 )
+		{
+			for ( uint i = 1; i < BricksKernelBlockSize::numElements; i++ )
+			{
+				minDistance = fminf( minDistance, minDistances[ i ] );
+				maxDistance = fmaxf( maxDistance, maxDistances[ i ] );
+			}
+			cProductionInfo.setBrickInfo( newElemAddress, minDistance, maxDistance, getDependencyTags() );
+		}
+	}
+
 	return 0;
 }
 
@@ -361,8 +415,13 @@ inline uint ProducerKernel< TDataStructureType >
 template< typename TDataStructureType >
 __device__
 inline GPUVoxelProducer::GPUVPRegionInfo ProducerKernel< TDataStructureType >
-::getRegionInfo( uint3 regionCoords, uint regionDepth )
+::getRegionInfo( uint3 regionCoords, uint regionDepth, float& pMinDistance, float& pMaxDistance )
 {
+	// - an empty region stays empty while the noise shell does not reach its min distance,
+	// - a region with data keeps data while the noise shell reaches the distance of the voxel found
+	pMinDistance = -FLT_MAX;
+	pMaxDistance = FLT_MAX;
+
 	//if (regionDepth <= 4)
 	//return GPUVoxelProducer::GPUVP_DATA;
 
@@ -393,6 +452,7 @@ inline GPUVoxelProducer::GPUVPRegionInfo ProducerKernel< TDataStructureType >
 	uint3 elemOffset;
 
 	bool isEmpty = true;
+	float minDistance = FLT_MAX;
 
 	// Iterate through voxels
 	for ( elemOffset.z = 0; elemOffset.z < elemSize.z && isEmpty; elemOffset.z++ )
@@ -411,10 +471,13 @@ inline GPUVoxelProducer::GPUVPRegionInfo ProducerKernel< TDataStructureType >
 					const float3 voxelPosF = brickPosF + voxelPosInBrickF;
 
 					// Test opacity to determine if there is data
-					const uchar voxelColor = getRGBA( voxelPosF, levelRes, regionDepth );
+					float testDistance;
+					const uchar voxelColor = getRGBA( voxelPosF, levelRes, regionDepth, testDistance );
+					minDistance = fminf( minDistance, testDistance );
 					if ( voxelColor > 0 )
 					{
 						isEmpty = false;
+						pMaxDistance = testDistance;
 
 						// TO DO
 						// - here, we can stop and exit
@@ -431,6 +494,8 @@ inline GPUVoxelProducer::GPUVPRegionInfo ProducerKernel< TDataStructureType >
 
 	if ( isEmpty )
 	{
+		pMinDistance = minDistance;
+
 		return GPUVoxelProducer::GPUVP_CONSTANT;
 	}
 
@@ -66,6 +66,12 @@
 #include <QDir>
 #include <QFileInfo>
 
+// STL
+#include <algorithm>
+
+// System
+#include <cfloat>
+
 /******************************************************************************
  ****************************** NAMESPACE SECTION *****************************
  ******************************************************************************/
@@ -950,13 +956,15 @@ void SampleCore::setNoiseShellWidth( float pValue )
  ******************************************************************************/
 void SampleCore::setNoiseShellWidthUpperBound( float pValue )
 {
+	const float previousValue = _noiseShellWidthUpperBound;
 	_noiseShellWidthUpperBound = pValue;
 
 	// Update device memory
 	GV_CUDA_SAFE_CALL( cudaMemcpyToSymbol( cNoiseShellWidthUpperBound, &_noiseShellWidthUpperBound, sizeof( _noiseShellWidthUpperBound ), 0, cudaMemcpyHostToDevice ) );
 
-	// Clear cache
-	clearCache();
+	// Invalidate the data whose distances lie between the previous and the new noise shell
+	// (distances are tested against half the shell width upper bound, see ProducerKernel)
+	_pipeline->editCache()->invalidateDependentData( 0.5f * std::min( previousValue, pValue ), 0.5f * std::max( previousValue, pValue ), PRODUCER_SHELL_WIDTH_DEPENDENCY );
 }
 
 /******************************************************************************
@@ -1021,8 +1029,8 @@ void SampleCore::setFillTheShape( int pValue )
 	// Update device memory
 	GV_CUDA_SAFE_CALL( cudaMemcpyToSymbol( cNoiseFillTheShape, &_noiseFillTheShape, sizeof( _noiseFillTheShape ), 0, cudaMemcpyHostToDevice ) );
 
-	// Clear cache
-	clearCache();
+	// Invalidate the data : the tested distances change with the way the shape is filled
+	_pipeline->editCache()->invalidateDependentData( -FLT_MAX, FLT_MAX, PRODUCER_FILL_THE_SHAPE_DEPENDENCY );
 }
 
 /******************************************************************************
@@ -1094,6 +1102,12 @@ bool SampleCore::initializePipeline()
 	// Pipeline configuration
 	_maxVolTreeDepth = 6;
 	_pipeline->editDataStructure()->setMaxDepth( _maxVolTreeDepth );
+
+	// Record the production info of nodes and bricks, so that editing noise parameters
+	// only produces again the data that depends on them
+	_pipeline->editCache()->useProductionInfo( true );
+	const GvStructure::GvProductionInfoKernel productionInfo = _pipeline->editCache()->getProductionInfoKernelObject();
+	GV_CUDA_SAFE_CALL( cudaMemcpyToSymbol( cProductionInfo, &productionInfo, sizeof( productionInfo ), 0, cudaMemcpyHostToDevice ) );
 	
 	// Fill the data type list used to store voxels in the data structure
 	GvViewerCore::GvvDataType& dataType = editDataTypes();
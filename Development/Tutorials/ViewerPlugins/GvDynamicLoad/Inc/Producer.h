@@ -37,10 +37,15 @@
 #include <GvCore/Array3DGPULinear.h>
 #include <GvCore/GPUPool.h>
 #include <GvUtils/GvIDataLoader.h>
+#include <GvCore/GvMortonCode.h>
 
 // Project
 #include "ProducerKernel.h"
 
+// STL
+#include <vector>
+#include <utility>
+
 /******************************************************************************
  ************************* DEFINE AND CONSTANT SECTION ************************
  ******************************************************************************/
@@ -229,18 +234,18 @@ protected:
 	uint _maxDepth;
 
 	/**
-	 * Localization depth's list of nodes that producer has to produce
+	 * Localization info list of nodes that producer has to produce,
+	 * packed as Morton keys (code and depth, see GvCore::GvMortonCode)
 	 *
-	 * Requests buffer. (note : suppose integer types)
+	 * Requests buffer.
 	 */
-	GvCore::GvLocalizationInfo::DepthType* _requestListDepth; 
+	GvCore::GvMortonCode::ValueType* _requestListMorton;
 
 	/**
-	 * Localization code's list of nodes that producer has to produce
-	 *
-	 * Requests buffer. (note : suppose integer types)
+	 * Requests sorted by Morton key (key and index in the request list),
+	 * so that the data loader reads regions in a coherent order
 	 */
-	GvCore::GvLocalizationInfo::CodeType* _requestListLoc;
+	std::vector< std::pair< GvCore::GvMortonCode::ValueType, uint > > _requestOrder;
 
 	/**
 	 * Indices cache.
@@ -268,23 +273,29 @@ protected:
 
 	/**
 	 * Prepare nodes info for GPU download.
-	 * Takes a device pointer to the request lists containing depth and localization of the nodes.
+	 * Takes a device pointer to the request list containing the localization info of the nodes (Morton keys).
 	 *
 	 * @param numElements number of elements
-	 * @param d_requestListDepth ...
-	 * @param d_requestListLoc ...
+	 * @param d_requestListMorton list of Morton keys on the DEVICE
 	 */
-	inline void preLoadManagementNodes( uint numElements, GvCore::GvLocalizationInfo::DepthType* d_requestListDepth, GvCore::GvLocalizationInfo::CodeType* d_requestListLoc );
+	inline void preLoadManagementNodes( uint numElements, GvCore::GvMortonCode::ValueType* d_requestListMorton );
 
 	/**
 	 * Prepare date for GPU download.
-	 * Takes a device pointer to the request lists containing depth and localization of the nodes.
+	 * Takes a device pointer to the request list containing the localization info of the nodes (Morton keys).
+	 *
+	 * @param numElements number of elements
+	 * @param d_requestListMorton list of Morton keys on the DEVICE
+	 */
+	inline void preLoadManagementData( uint numElements, GvCore::GvMortonCode::ValueType* d_requestListMorton );
+
+	/**
+	 * Fetch the request list on HOST and sort requests by Morton key
 	 *
-	 * @param numElements ...
-	 * @param d_requestListDepth ...
-	 * @param d_requestListLoc ...
+	 * @param numElements number of elements
+	 * @param d_requestListMorton list of Morton keys on the DEVICE
 	 */
-	inline void preLoadManagementData( uint numElements, GvCore::GvLocalizationInfo::DepthType* d_requestListDepth, GvCore::GvLocalizationInfo::CodeType* d_requestListLoc );
+	inline void fetchRequestList( uint numElements, GvCore::GvMortonCode::ValueType* d_requestListMorton );
 
 	/**************************************************************************
 	 ***************************** PRIVATE SECTION ****************************
@@ -295,18 +306,11 @@ private:
 	/******************************* ATTRIBUTES *******************************/
 
 	/**
-	 * Helper buffer used to retrieve the list of localization code that the producer has to produce.
-	 *
-	 * Data in this temporary buffer is then copied in the HOST producer's _requestListLoc member.
-	 */
-	thrust::device_vector< GvCore::GvLocalizationInfo::CodeType >* d_TempLocalizationCodeList;
-
-	/**
-	 * Helper buffer used to retrieve the list of localization depth that the producer has to produce.
+	 * Helper buffer used to retrieve the list of localization info (Morton keys) that the producer has to produce.
 	 *
-	 * Data in this temporary buffer is then copied in the HOST producer's _requestListDepth member.
+	 * Data in this temporary buffer is then copied in the HOST producer's _requestListMorton member.
 	 */
-	thrust::device_vector< GvCore::GvLocalizationInfo::DepthType >* d_TempLocalizationDepthList;
+	thrust::device_vector< GvCore::GvMortonCode::ValueType >* d_TempMortonList;
 
 	/******************************** METHODS *********************************/
 
@@ -32,6 +32,10 @@
 #include <GvCore/GvIProviderKernel.h>
 #include <GvCore/GvError.h>
 
+// STL
+#include <algorithm>
+#include <iostream>
+
 /******************************************************************************
  ****************************** INLINE DEFINITION *****************************
  ******************************************************************************/
@@ -63,14 +67,13 @@ Producer< TDataStructureType, TDataProductionManager >
 	// Allocate caches in mappable pinned memory
 	_channelsCachesPool	= new DataCachePool( make_uint3( this->_bufferNbVoxels, 1, 1 ), 2 );
 
-	// Localization info initialization (code and depth)
+	// Localization info initialization (code and depth packed in Morton keys)
 	// This is the ones that producer will have to produce
-	_requestListDepth = new GvCore::GvLocalizationInfo::DepthType[ _nbMaxRequests ];
-	_requestListLoc = new GvCore::GvLocalizationInfo::CodeType[ _nbMaxRequests ];
-	// DEVICE temporary buffers used to retrieve localization info.
-	// Data will then be copied in the previous HOST buffers ( _requestListDepth and _requestListLoc) 
-	d_TempLocalizationCodeList	= new thrust::device_vector< GvCore::GvLocalizationInfo::CodeType >( nodesCacheSize );
-	d_TempLocalizationDepthList	= new thrust::device_vector< GvCore::GvLocalizationInfo::DepthType >( nodesCacheSize );
+	_requestListMorton = new GvCore::GvMortonCode::ValueType[ _nbMaxRequests ];
+	_requestOrder.reserve( _nbMaxRequests );
+	// DEVICE temporary buffer used to retrieve localization info.
+	// Data will then be copied in the previous HOST buffer ( _requestListMorton ) 
+	d_TempMortonList = new thrust::device_vector< GvCore::GvMortonCode::ValueType >( nodesCacheSize );
 
 	// TODO fix maxRequestNumber * 8
 	_h_nodesBuffer = new GvCore::Array3D< uint >( dim3( _nbMaxRequests * 8, 1, 1 ), 2 ); // Allocated mappable pinned memory // TODO : check this size limit
@@ -114,10 +117,8 @@ inline void Producer< TDataStructureType, TDataProductionManager >
 	delete _dataLoader;
 
 	delete _channelsCachesPool;
-	delete _requestListDepth;
-	delete _requestListLoc;
-	delete d_TempLocalizationCodeList;
-	delete d_TempLocalizationDepthList;
+	delete[] _requestListMorton;
+	delete d_TempMortonList;
 }
 
 /******************************************************************************
@@ -147,6 +148,14 @@ void Producer< TDataStructureType, TDataProductionManager >
 		_maxDepth = 9;	// Limitation from nodes hashes
 	}
 
+	// Limitation from the localization info encoding (Morton keys)
+	if ( _maxDepth > GvCore::GvMortonCode::getMaxDepth< NodeRes >() )
+	{
+		std::cerr << "Producer::attachProducer : max depth is limited to " << GvCore::GvMortonCode::getMaxDepth< NodeRes >() << std::endl;
+
+		_maxDepth = GvCore::GvMortonCode::getMaxDepth< NodeRes >();
+	}
+
 	// Store a reference on the producer
 	_dataLoader = srcProducer;
 }
@@ -178,8 +187,7 @@ inline void Producer< TDataStructureType, TDataProductionManager >
 	dim3 blockSize( 32, 1, 1 );
 
 	// Retrieve localization info
-	GvCore::GvLocalizationInfo::CodeType* locCodeList = thrust::raw_pointer_cast( &(*d_TempLocalizationCodeList)[ 0 ] );
-	GvCore::GvLocalizationInfo::DepthType* locDepthList = thrust::raw_pointer_cast( &(*d_TempLocalizationDepthList)[ 0 ] );
+	GvCore::GvMortonCode::ValueType* mortonList = thrust::raw_pointer_cast( &(*d_TempMortonList)[ 0 ] );
 
 	// Retrieve elements address lists
 	uint* nodesAddressList = thrust::raw_pointer_cast( &(*pNodesAddressCompactList)[ 0 ] );
@@ -191,19 +199,17 @@ inline void Producer< TDataStructureType, TDataProductionManager >
 		// Prevent too workload
 		uint numRequests = mincc( pNumElems, _nbMaxRequests );
 
-		// Create localization info lists of the node elements to produce (code and depth)
+		// Create localization info list of the node elements to produce (code and depth packed in Morton keys)
 		//
-		// Resulting lists are written into the two following buffers :
-		// - d_TempLocalizationCodeList
-		// - d_TempLocalizationDepthList
-		this->_nodePageTable->createLocalizationLists( numRequests, nodesAddressList, d_TempLocalizationCodeList, d_TempLocalizationDepthList );
+		// Resulting list is written into the d_TempMortonList buffer
+		this->_nodePageTable->createMortonList( numRequests, nodesAddressList, d_TempMortonList );
 
-		// For each node of the lists, thanks to its localization info,
+		// For each node of the list, thanks to its localization info,
 		// an oracle will determine the type the associated 3D region of space
 		// (i.e. max depth reached, containing data, etc...)
 		//
 		// Node info are then written 
-		preLoadManagementNodes( numRequests, locDepthList, locCodeList );
+		preLoadManagementNodes( numRequests, mortonList );
 
 		// Call cache helper to write into cache
 		//
@@ -244,8 +250,7 @@ inline void Producer< TDataStructureType, TDataProductionManager >
 	dim3 blockSize( 16, 8, 1 );
 
 	// Retrieve localization info
-	GvCore::GvLocalizationInfo::CodeType* locCodeList = thrust::raw_pointer_cast( &(*d_TempLocalizationCodeList)[ 0 ] );
-	GvCore::GvLocalizationInfo::DepthType* locDepthList = thrust::raw_pointer_cast( &(*d_TempLocalizationDepthList)[ 0 ] );
+	GvCore::GvMortonCode::ValueType* mortonList = thrust::raw_pointer_cast( &(*d_TempMortonList)[ 0 ] );
 
 	// Retrieve elements address lists
 	uint* nodesAddressList = thrust::raw_pointer_cast( &(*pNodesAddressCompactList)[ 0 ] );
@@ -256,15 +261,15 @@ inline void Producer< TDataStructureType, TDataProductionManager >
 	{
 		uint numRequests = mincc( pNumElems, _nbMaxRequests );
 
-		// Create localization lists (code and depth)
-		this->_dataPageTable->createLocalizationLists( numRequests, nodesAddressList, d_TempLocalizationCodeList, d_TempLocalizationDepthList );
+		// Create localization list (code and depth packed in Morton keys)
+		this->_dataPageTable->createMortonList( numRequests, nodesAddressList, d_TempMortonList );
 
-		// For each brick of the lists, thanks to its localization info,
+		// For each brick of the list, thanks to its localization info,
 		// retrieve the associated brick located in this region of space,
 		// and load its data from HOST disk (or retrieve data from HOST cache).
 		//
 		// Voxels data are then written on the DEVICE
-		preLoadManagementData( numRequests, locDepthList, locCodeList );
+		preLoadManagementData( numRequests, mortonList );
 
 		// Call cache helper to write into cache
 		this->_cacheHelper.template genericWriteIntoCache< BrickFullRes >( numRequests, nodesAddressList, elemAddressList, this->_dataPool, kernelProvider, this->_dataPageTable, blockSize );
@@ -277,26 +282,47 @@ inline void Producer< TDataStructureType, TDataProductionManager >
 }
 
 /******************************************************************************
- * Prepare nodes info for GPU download.
- * Takes a device pointer to the request lists containing depth and localization of the nodes.
+ * Fetch the request list on HOST and sort requests by Morton key
  *
- * @param numElements number of elements to process
- * @param d_requestListDepth list of localization depths on the DEVICE
- * @param d_requestListLoc list of localization codes on the DEVICE
+ * @param numElements number of elements
+ * @param d_requestListMorton list of Morton keys on the DEVICE
  ******************************************************************************/
 template< typename TDataStructureType, typename TDataProductionManager >
 inline void Producer< TDataStructureType, TDataProductionManager >
-::preLoadManagementNodes( uint numElements, GvCore::GvLocalizationInfo::DepthType* d_requestListDepth, GvCore::GvLocalizationInfo::CodeType* d_requestListLoc )
+::fetchRequestList( uint numElements, GvCore::GvMortonCode::ValueType* d_requestListMorton )
 {
 	assert( numElements <= _nbMaxRequests );
 
 	// TODO: use cudaMemcpyAsync
 	//
-	// Fetch on HOST the updated localization info list (code and depth) of all requested elements
+	// Fetch on HOST the updated localization info list (Morton keys) of all requested elements
+	cudaMemcpy( _requestListMorton, d_requestListMorton, numElements * sizeof( GvCore::GvMortonCode::ValueType ), cudaMemcpyDeviceToHost );
+	GV_CHECK_CUDA_ERROR( "fetchRequestList : cudaMemcpy" );
+
+	// Requests are processed in Morton order (coarse levels first, then along a Z-order curve),
+	// results are still written at the index of the request
+	_requestOrder.resize( numElements );
+	for ( uint i = 0; i < numElements; ++i )
+	{
+		_requestOrder[ i ] = std::make_pair( _requestListMorton[ i ], i );
+	}
+	std::sort( _requestOrder.begin(), _requestOrder.end() );
+}
+
+/******************************************************************************
+ * Prepare nodes info for GPU download.
+ * Takes a device pointer to the request list containing the localization info of the nodes (Morton keys).
+ *
+ * @param numElements number of elements to process
+ * @param d_requestListMorton list of Morton keys on the DEVICE
+ ******************************************************************************/
+template< typename TDataStructureType, typename TDataProductionManager >
+inline void Producer< TDataStructureType, TDataProductionManager >
+::preLoadManagementNodes( uint numElements, GvCore::GvMortonCode::ValueType* d_requestListMorton )
+{
+	// Fetch on HOST the localization info list of all requested elements
 	CUDAPM_START_EVENT( gpuProdDynamic_preLoadMgtNodes_fetchRequestList )
-	cudaMemcpy( _requestListDepth, d_requestListDepth, numElements * sizeof( GvCore::GvLocalizationInfo::DepthType ), cudaMemcpyDeviceToHost );
-	cudaMemcpy( _requestListLoc, d_requestListLoc, numElements * sizeof( GvCore::GvLocalizationInfo::CodeType ), cudaMemcpyDeviceToHost );
-	GV_CHECK_CUDA_ERROR( "preLoadManagementNodes : cudaMemcpy" );
+	fetchRequestList( numElements, d_requestListMorton );
 	CUDAPM_STOP_EVENT( gpuProdDynamic_preLoadMgtNodes_fetchRequestList )
 
 	CUDAPM_START_EVENT( gpuProdDynamic_preLoadMgtNodes_dataLoad )
@@ -309,11 +335,15 @@ inline void Producer< TDataStructureType, TDataProductionManager >
 		uint3 brickResWithBorder = BrickRes::get() + make_uint3( 2 * BorderSize );
 
 		// Iterate through elements (i.e. node tiles)
-		for ( uint i = 0; i < numElements; ++i )
+		for ( uint r = 0; r < numElements; ++r )
 		{
 			// Get localization info of current element
-			GvCore::GvLocalizationDepth::ValueType locDepthElem = this->_requestListDepth[ i ].get();// + 1;
-			GvCore::GvLocalizationCode::ValueType locCodeElem = this->_requestListLoc[ i ].get();
+			const uint i = _requestOrder[ r ].second;
+			GvCore::GvLocalizationCode requestLocCode;
+			GvCore::GvLocalizationDepth requestLocDepth;
+			GvCore::GvMortonCode::decodeNode< NodeRes >( _requestOrder[ r ].first, requestLocCode, requestLocDepth );
+			GvCore::GvLocalizationDepth::ValueType locDepthElem = requestLocDepth.get();// + 1;
+			GvCore::GvLocalizationCode::ValueType locCodeElem = requestLocCode.get();
 
 			// Localization code of childs is at the next level
 			uint locDepth = locDepthElem + 1;//+2;
@@ -367,25 +397,18 @@ inline void Producer< TDataStructureType, TDataProductionManager >
 
 /******************************************************************************
  * Prepare date for GPU download.
- * Takes a device pointer to the request lists containing depth and localization of the nodes.
+ * Takes a device pointer to the request list containing the localization info of the nodes (Morton keys).
  *
- * @param numElements ...
- * @param d_requestListDepth ...
- * @param d_requestListLoc ...
+ * @param numElements number of elements to process
+ * @param d_requestListMorton list of Morton keys on the DEVICE
  ******************************************************************************/
 template< typename TDataStructureType, typename TDataProductionManager >
 inline void Producer< TDataStructureType, TDataProductionManager >
-::preLoadManagementData( uint numElements, GvCore::GvLocalizationInfo::DepthType* d_requestListDepth, GvCore::GvLocalizationInfo::CodeType* d_requestListLoc )
+::preLoadManagementData( uint numElements, GvCore::GvMortonCode::ValueType* d_requestListMorton )
 {
-	assert( numElements <= _nbMaxRequests );
-
-	// TODO: use cudaMemcpyAsync
-	//
-	// Fetch on HOST the updated localization info list (code and depth) of all requested elements
+	// Fetch on HOST the localization info list of all requested elements
 	CUDAPM_START_EVENT( gpuProdDynamic_preLoadMgtData_fetchRequestList )
-	cudaMemcpy( _requestListDepth, d_requestListDepth, numElements * sizeof( GvCore::GvLocalizationInfo::DepthType ), cudaMemcpyDeviceToHost );
-	cudaMemcpy( _requestListLoc, d_requestListLoc, numElements * sizeof( GvCore::GvLocalizationInfo::CodeType ), cudaMemcpyDeviceToHost );
-	GV_CHECK_CUDA_ERROR( "preLoadManagementData : cudaMemcpy" );
+	fetchRequestList( numElements, d_requestListMorton );
 	CUDAPM_STOP_EVENT( gpuProdDynamic_preLoadMgtData_fetchRequestList )
 
 	CUDAPM_START_EVENT( gpuProdDynamic_preLoadMgtData_dataLoad )
@@ -400,11 +423,15 @@ inline void Producer< TDataStructureType, TDataProductionManager >
 		CUDAPM_START_EVENT( gpuProdDynamic_preLoadMgtData_dataLoad_elemLoop )
 
 		// Iterate through elements (i.e. brick of voxels)
-		for ( uint i = 0; i < numElements; ++i )
+		for ( uint r = 0; r < numElements; ++r )
 		{
 			// XXX: Fixed depth offset
-			uint locDepth = _requestListDepth[ i ].get();// + 1;
-			uint3 locCode = _requestListLoc[ i ].get();
+			const uint i = _requestOrder[ r ].second;
+			GvCore::GvLocalizationCode requestLocCode;
+			GvCore::GvLocalizationDepth requestLocDepth;
+			GvCore::GvMortonCode::decodeNode< NodeRes >( _requestOrder[ r ].first, requestLocCode, requestLocDepth );
+			uint locDepth = requestLocDepth.get();// + 1;
+			uint3 locCode = requestLocCode.get();
 
 			// Convert localization info to a region of space
 			float3 regionPos;
@@ -140,6 +140,11 @@ private slots:
 	 */
 	void on__shaderGradientStepDoubleSpinBox_valueChanged( double value );
 
+	/**
+	 * Slot called when shader's normal channel check box is toggled
+	 */
+	void on__shaderNormalChannelCheckBox_toggled( bool pChecked );
+
 	/**
 	 * Slot called when shader's full opacity distance value has changed
 	 */
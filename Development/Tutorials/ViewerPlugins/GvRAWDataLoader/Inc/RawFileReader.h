@@ -34,6 +34,9 @@
 // GigaVoxels
 #include "GvVoxelizer/GvIRAWFileReader.h"
 
+// STL
+#include <string>
+
 /******************************************************************************
  ************************* DEFINE AND CONSTANT SECTION ************************
  ******************************************************************************/
@@ -83,6 +86,20 @@ public:
 	 */
 	virtual ~RawFileReader();
 
+	/**
+	 * Load/import the scene, and write the XML descriptor of the generated data structure
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	virtual bool read();
+
+	/**
+	 * Get the file name of the XML descriptor of the generated data structure (read by GvUtils::GvDataLoader)
+	 *
+	 * @return the descriptor file name
+	 */
+	std::string getDescriptorFileName() const;
+
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
 	 **************************************************************************/
@@ -98,6 +115,14 @@ protected:
 	 */
 	virtual bool readData();
 
+	/**
+	 * Write the XML descriptor of the generated data structure :
+	 * the density channel, and the normal channel when a normal encoding is set
+	 *
+	 * @return a flag telling wheter or not it succeeds
+	 */
+	bool writeDescriptorFile() const;
+
 	/**************************************************************************
 	 ***************************** PRIVATE SECTION ****************************
 	 **************************************************************************/
@@ -77,8 +77,9 @@ class ShaderKernel;
  ***************************** TYPE DEFINITION ********************************
  ******************************************************************************/
 
-// Defines the type list representing the content of one voxel
-typedef Loki::TL::MakeTypelist< uchar4 >::Result DataType;
+// Defines the type list representing the content of one voxel :
+// the density (channel 0), and the normal with the gradient magnitude precomputed by the RAW file reader (channel 1)
+typedef Loki::TL::MakeTypelist< uchar4, half4 >::Result DataType;
 
 // Defines the size of a node tile
 typedef GvCore::StaticRes1D< 2 > NodeRes;
@@ -467,6 +468,22 @@ public:
 	 */
 	void setGradientStep( float pValue );
 
+	/**
+	 * Tell wheter or not the shader fetches the precomputed normals (channel 1)
+	 * instead of computing the gradient of the density from six neighbors
+	 *
+	 * @return the flag telling wheter or not the normal channel is used
+	 */
+	bool isNormalChannelUsed() const;
+
+	/**
+	 * Tell wheter or not the shader fetches the precomputed normals (channel 1)
+	 * instead of computing the gradient of the density from six neighbors
+	 *
+	 * @param pFlag the flag telling wheter or not the normal channel is used
+	 */
+	void useNormalChannel( bool pFlag );
+
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
 	 **************************************************************************/
@@ -520,6 +537,11 @@ protected:
 	 */
 	float _gradientStep;
 
+	/**
+	 * Flag telling wheter or not the shader fetches the precomputed normals (channel 1)
+	 */
+	bool _isNormalChannelUsed;
+
 	/******************************** METHODS *********************************/
 
 	/**
@@ -63,6 +63,12 @@ __constant__ float cFullOpacityDistance;
  */
 __constant__ float cGradientStep;
 
+/**
+ * Flag telling wheter or not normals are fetched in the data channel 1,
+ * instead of being computed from the gradient of the density
+ */
+__constant__ bool cUseNormalChannel;
+
 /**
  * Transfer function texture
  */
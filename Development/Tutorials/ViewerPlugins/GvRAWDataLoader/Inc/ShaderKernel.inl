@@ -123,21 +123,31 @@ inline void ShaderKernel::runImpl( const BrickSamplerType& brickSampler, const f
 	{
 		float3 grad = make_float3(0.0f);
 
-		float gradStep = rayStep * cGradientStep;
+		if ( cUseNormalChannel )
+		{
+			// Normals are precomputed in channel 1 (xyz : opposite of the normalized gradient, w : gradient magnitude).
+			// Interpolated normals are normalized below.
+			const float4 normal = brickSampler.template getValue< 1 >( coneAperture );
+			grad = make_float3( -normal.x, -normal.y, -normal.z );
+		}
+		else
+		{
+			float gradStep = rayStep * cGradientStep;
 
-		float4 v0, v1;
+			float4 v0, v1;
 
-		v0 = brickSampler.template getValue< 0 >( coneAperture, make_float3( gradStep, 0.0f, 0.0f) );
-		v1 = brickSampler.template getValue< 0 >( coneAperture, make_float3(-gradStep, 0.0f, 0.0f) );
-		grad.x = v0.w - v1.w;
+			v0 = brickSampler.template getValue< 0 >( coneAperture, make_float3( gradStep, 0.0f, 0.0f) );
+			v1 = brickSampler.template getValue< 0 >( coneAperture, make_float3(-gradStep, 0.0f, 0.0f) );
+			grad.x = v0.w - v1.w;
 
-		v0 = brickSampler.template getValue< 0 >( coneAperture, make_float3(0.0f,  gradStep, 0.0f) );
-		v1 = brickSampler.template getValue< 0 >( coneAperture, make_float3(0.0f, -gradStep, 0.0f) );
-		grad.y = v0.w - v1.w;
+			v0 = brickSampler.template getValue< 0 >( coneAperture, make_float3(0.0f,  gradStep, 0.0f) );
+			v1 = brickSampler.template getValue< 0 >( coneAperture, make_float3(0.0f, -gradStep, 0.0f) );
+			grad.y = v0.w - v1.w;
 
-		v0 = brickSampler.template getValue< 0 >( coneAperture, make_float3(0.0f, 0.0f,  gradStep) );
-		v1 = brickSampler.template getValue< 0 >( coneAperture, make_float3(0.0f, 0.0f, -gradStep) );
-		grad.z = v0.w - v1.w;
+			v0 = brickSampler.template getValue< 0 >( coneAperture, make_float3(0.0f, 0.0f,  gradStep) );
+			v1 = brickSampler.template getValue< 0 >( coneAperture, make_float3(0.0f, 0.0f, -gradStep) );
+			grad.z = v0.w - v1.w;
+		}
 
 		if ( length( grad ) > 0.0f )
 		{
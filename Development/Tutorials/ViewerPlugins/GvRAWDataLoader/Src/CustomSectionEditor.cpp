@@ -120,6 +120,7 @@ void CustomSectionEditor::populate( GvViewerCore::GvvBrowsable* pBrowsable )
 
 		// Shader parameters
 		_shaderGradientStepDoubleSpinBox->setValue( pipeline->getGradientStep() );
+		_shaderNormalChannelCheckBox->setChecked( pipeline->isNormalChannelUsed() );
 		_shaderFullOpacityDistanceDoubleSpinBox->setValue( pipeline->getFullOpacityDistance() );
 		_shaderThresholdDoubleSpinBox->setValue( pipeline->getThreshold() );
 	}
@@ -207,6 +208,23 @@ void CustomSectionEditor::on__shaderGradientStepDoubleSpinBox_valueChanged( doub
 	//----------------------------------------
 }
 
+/******************************************************************************
+ * Slot called when shader's normal channel check box is toggled
+ ******************************************************************************/
+void CustomSectionEditor::on__shaderNormalChannelCheckBox_toggled( bool pChecked )
+{
+	GvvApplication& application = GvvApplication::get();
+	GvvMainWindow* mainWindow = application.getMainWindow();
+	Gvv3DWindow* window3D = mainWindow->get3DWindow();
+	GvvPipelineInterfaceViewer* pipelineViewer = window3D->getPipelineViewer();
+	GvViewerCore::GvvPipelineInterface* pipeline = pipelineViewer->editPipeline();
+
+	SampleCore* sampleCore = dynamic_cast< SampleCore* >( pipeline );
+	assert( sampleCore != NULL );
+
+	sampleCore->useNormalChannel( pChecked );
+}
+
 /******************************************************************************
  * Slot called when shader's full opacity distance value has changed
  ******************************************************************************/
@@ -132,7 +132,7 @@ void GvMyPlugin::initialize()
 	//-----------------------------------------------
 	// PROBLEM :
 	// le dialog semble provoquer un draw() sans qu'il y ait eu un resize donc un init du pipeline => crash OpenGL...
-	QString modelFilename;
+	std::string modelFilename;
 	unsigned int modelResolution;
 	{	// "{" is used to destroy the widget....
 	/*if ( _pipeline != NULL )
@@ -149,14 +149,19 @@ void GvMyPlugin::initialize()
 				{
 					rawFileReader->setFilename( dataLoaderDialog.get3DModelFilename().toLatin1().constData() );
 					rawFileReader->setDataResolution( dataLoaderDialog.get3DModelResolution() );
+
+					// Normals are precomputed in the data channel 1 (see the DataType of the pipeline)
+					rawFileReader->setNormalEncoding( GvVoxelizer::GvDataStructureNormalGenerator::eHalf4 );
 					
 					rawFileReader->read();
+
+					// The pipeline loads the generated data structure through its XML descriptor
+					modelFilename = rawFileReader->getDescriptorFileName();
 				
 					delete rawFileReader;
 					rawFileReader = NULL;
 				}
 				
-				modelFilename = dataLoaderDialog.get3DModelFilename();
 				modelResolution = dataLoaderDialog.get3DModelResolution();
 			}
 	//	}
@@ -177,7 +182,7 @@ void GvMyPlugin::initialize()
 	//-----------------------------------------------
 	if ( _pipeline != NULL )
 	{
-		_pipeline->set3DModelFilename( modelFilename.toLatin1().constData() );
+		_pipeline->set3DModelFilename( modelFilename );
 		_pipeline->set3DModelResolution( modelResolution );
 
 		// TO DO
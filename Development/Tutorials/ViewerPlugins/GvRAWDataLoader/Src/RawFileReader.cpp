@@ -34,10 +34,15 @@
 #include "GvVoxelizer/GvDataStructureIOHandler.h"
 #include "GvVoxelizer/GvDataTypeHandler.h"
 
+// TinyXML
+#include <tinyxml.h>
+
 // System
 #include <cassert>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <vector>
 #include <cmath>
 
 /******************************************************************************
@@ -77,6 +82,100 @@ RawFileReader::~RawFileReader()
 {
 }
 
+/******************************************************************************
+ * Load/import the scene, and write the XML descriptor of the generated data structure
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool RawFileReader::read()
+{
+	const bool result = GvIRAWFileReader::read();
+
+	return writeDescriptorFile() && result;
+}
+
+/******************************************************************************
+ * Get the file name of the XML descriptor of the generated data structure (read by GvUtils::GvDataLoader)
+ *
+ * @return the descriptor file name
+ ******************************************************************************/
+std::string RawFileReader::getDescriptorFileName() const
+{
+	return getFilename() + ".xml";
+}
+
+/******************************************************************************
+ * Write the XML descriptor of the generated data structure :
+ * the density channel, and the normal channel when a normal encoding is set
+ *
+ * @return a flag telling wheter or not it succeeds
+ ******************************************************************************/
+bool RawFileReader::writeDescriptorFile() const
+{
+	// Files are referenced relatively to the descriptor
+	const std::string baseName = getFilename().substr( getFilename().find_last_of( "\\/" ) + 1 );
+	const unsigned int brickWidth = 8;
+	const unsigned int nbLevels = static_cast< unsigned int >( log( static_cast< float >( getDataResolution() / brickWidth ) ) / log( static_cast< float >( 2 ) ) ) + 1;
+
+	// Density channel, and optional normal channel
+	std::vector< GvDataTypeHandler::VoxelDataType > dataTypes;
+	std::vector< std::string > channelNames;
+	dataTypes.push_back( GvDataTypeHandler::gvUCHAR4 );
+	channelNames.push_back( "color" );
+	if ( getNormalEncoding() != GvDataStructureNormalGenerator::eNoNormal )
+	{
+		dataTypes.push_back( GvDataStructureNormalGenerator::getNormalDataType( getNormalEncoding() ) );
+		channelNames.push_back( "normal" );
+	}
+
+	TiXmlDocument document;
+	TiXmlElement* root = new TiXmlElement( "Model" );
+	root->SetAttribute( "name", baseName.c_str() );
+	root->SetAttribute( "directory", "." );
+	root->SetAttribute( "nbLevels", nbLevels );
+
+	// Nodes
+	TiXmlElement* nodeTree = new TiXmlElement( "NodeTree" );
+	for ( unsigned int k = 0; k < nbLevels; k++ )
+	{
+		TiXmlElement* level = new TiXmlElement( "Level" );
+		level->SetAttribute( "id", k );
+		std::ostringstream fileName;
+		fileName << baseName << "_BR" << brickWidth << "_B1_L" << k << ".nodes";
+		level->SetAttribute( "filename", fileName.str().c_str() );
+		nodeTree->LinkEndChild( level );
+	}
+	root->LinkEndChild( nodeTree );
+
+	// Bricks
+	TiXmlElement* brickData = new TiXmlElement( "BrickData" );
+	brickData->SetAttribute( "brickResolution", brickWidth );
+	brickData->SetAttribute( "borderSize", 1 );
+	for ( unsigned int c = 0; c < dataTypes.size(); c++ )
+	{
+		const std::string typeName = GvDataTypeHandler::getTypeName( dataTypes[ c ] );
+		TiXmlElement* channel = new TiXmlElement( "Channel" );
+		channel->SetAttribute( "id", c );
+		channel->SetAttribute( "name", channelNames[ c ].c_str() );
+		channel->SetAttribute( "type", typeName.c_str() );
+		for ( unsigned int k = 0; k < nbLevels; k++ )
+		{
+			TiXmlElement* level = new TiXmlElement( "Level" );
+			level->SetAttribute( "id", k );
+			std::ostringstream fileName;
+			fileName << baseName << "_BR" << brickWidth << "_B1_L" << k << "_C" << c << "_" << typeName << ".bricks";
+			level->SetAttribute( "filename", fileName.str().c_str() );
+			channel->LinkEndChild( level );
+		}
+		brickData->LinkEndChild( channel );
+	}
+	root->LinkEndChild( brickData );
+
+	document.LinkEndChild( root );
+
+	return document.SaveFile( getDescriptorFileName().c_str() );
+}
+
 /******************************************************************************
  * Load/import the scene the scene
  ******************************************************************************/
@@ -122,6 +122,7 @@ SampleCore::SampleCore()
 ,	_threshold( 0.f )
 ,	_fullOpacityDistance( 0.f )
 ,	_gradientStep( 0.f )
+,	_isNormalChannelUsed( false )
 ,	_transferFunction( NULL )
 {
 	// Translation used to position the GigaVoxels data structure
@@ -262,6 +263,7 @@ void SampleCore::init()
 	setThreshold( 0.f );	// no threshold by default
 	setFullOpacityDistance( dataResolution ); // the distance ( 1 / FullOpacityDistance ) is the distance after which opacity is full.
 	setGradientStep( 0.25f );
+	useNormalChannel( true );
 }
 
 /******************************************************************************
@@ -909,6 +911,31 @@ void SampleCore::setGradientStep( float pValue )
 	GV_CUDA_SAFE_CALL( cudaMemcpyToSymbol( cGradientStep, &_gradientStep, sizeof( _gradientStep ), 0, cudaMemcpyHostToDevice ) );
 }
 
+/******************************************************************************
+ * Tell wheter or not the shader fetches the precomputed normals (channel 1)
+ * instead of computing the gradient of the density from six neighbors
+ *
+ * @return the flag telling wheter or not the normal channel is used
+ ******************************************************************************/
+bool SampleCore::isNormalChannelUsed() const
+{
+	return _isNormalChannelUsed;
+}
+
+/******************************************************************************
+ * Tell wheter or not the shader fetches the precomputed normals (channel 1)
+ * instead of computing the gradient of the density from six neighbors
+ *
+ * @param pFlag the flag telling wheter or not the normal channel is used
+ ******************************************************************************/
+void SampleCore::useNormalChannel( bool pFlag )
+{
+	_isNormalChannelUsed = pFlag;
+
+	// Update device memory
+	GV_CUDA_SAFE_CALL( cudaMemcpyToSymbol( cUseNormalChannel, &_isNormalChannelUsed, sizeof( _isNormalChannelUsed ), 0, cudaMemcpyHostToDevice ) );
+}
+
 /******************************************************************************
  * Initialize the transfer function
  *
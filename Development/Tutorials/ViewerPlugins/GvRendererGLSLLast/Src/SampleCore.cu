@@ -1198,8 +1198,8 @@ void SampleCore::set3DModelFilename( const string& pFilename )
 		delete renderer->_proxyGeometry;
 		renderer->_proxyGeometry = NULL;
 
-		// Clear the GigaVoxels cache
-		clearCache();
+		// The GigaVoxels cache is kept : the proxy geometry only provides the depths
+		// where rays start and stop, produced data does not depend on it
 	}
 
 	// Initialize proxy geometry (load the 3D scene)
@@ -693,6 +693,21 @@ public:
 	 */
 	virtual float getProductionTimeLimit() const;
 
+	/**
+	 * Set or unset the flag used to tell whether or not production requests
+	 * are ordered by priority (screen-space error) when they exceed the budget.
+	 *
+	 * @param pFlag the flag value.
+	 */
+	virtual void useRequestPriorities( bool pFlag );
+
+	/**
+	 * Get the flag telling whether or not production requests are ordered by priority.
+	 *
+	 * @return the flag telling whether or not production requests are ordered by priority.
+	 */
+	virtual bool hasRequestPriorities() const;
+
 	/**
 	 * Tell wheter or not pipeline uses programmable shaders
 	 *
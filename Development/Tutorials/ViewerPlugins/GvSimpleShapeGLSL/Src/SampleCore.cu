@@ -1022,6 +1022,27 @@ float SampleCore::getProductionTimeLimit() const
 	return _pipeline->editCache()->getProductionTimeLimit();
 }
 
+/******************************************************************************
+ * Set or unset the flag used to tell whether or not production requests
+ * are ordered by priority (screen-space error) when they exceed the budget.
+ *
+ * @param pFlag the flag value.
+ ******************************************************************************/
+void SampleCore::useRequestPriorities( bool pFlag )
+{
+	_pipeline->editCache()->useRequestPriorities( pFlag );
+}
+
+/******************************************************************************
+ * Get the flag telling whether or not production requests are ordered by priority.
+ *
+ * @return the flag telling whether or not production requests are ordered by priority.
+ ******************************************************************************/
+bool SampleCore::hasRequestPriorities() const
+{
+	return _pipeline->editCache()->hasRequestPriorities();
+}
+
 /******************************************************************************
  * Tell wheter or not pipeline uses programmable shaders
  *
@@ -540,6 +540,14 @@ public:
 	 */
 	virtual void setBrickCacheMemory( unsigned int pValue );
 
+	/**
+	 * Set the node and brick cache memory at once (pools are reallocated only once)
+	 *
+	 * @param pNodeValue the node cache memory
+	 * @param pBrickValue the brick cache memory
+	 */
+	virtual void setCacheMemory( unsigned int pNodeValue, unsigned int pBrickValue );
+
 	/**
 	 * Get the node cache capacity
 	 *
@@ -582,6 +590,20 @@ public:
 	 */
 	virtual unsigned int getCacheNbUnusedBricks() const;
 
+	/**
+	 * Tell wheter or not the nodes cache has exceeded its capacity during last frame
+	 *
+	 * @return a flag telling wheter or not the nodes cache has exceeded its capacity
+	 */
+	virtual bool hasNodeCacheExceededCapacity() const;
+
+	/**
+	 * Tell wheter or not the bricks cache has exceeded its capacity during last frame
+	 *
+	 * @return a flag telling wheter or not the bricks cache has exceeded its capacity
+	 */
+	virtual bool hasBrickCacheExceededCapacity() const;
+
 	/**
 	 * Get the nodes cache usage
 	 *
@@ -863,8 +885,35 @@ private:
 	 */
 	GLint _textureSamplerUniformLocation;
 
+	/**
+	 * Node cache memory (in Mo)
+	 */
+	unsigned int _nodeCacheMemory;
+
+	/**
+	 * Brick cache memory (in Mo)
+	 */
+	unsigned int _brickCacheMemory;
+
 	/******************************** METHODS *********************************/
 
+	/**
+	 * Create the GigaVoxels pipeline and its renderer with the current cache memory
+	 */
+	void createPipeline();
+
+	/**
+	 * Create the renderer of the GigaVoxels pipeline
+	 */
+	void createRenderer();
+
+	/**
+	 * Reallocate the node and brick pools of the GigaVoxels pipeline with the current cache memory.
+	 * Resident nodes and bricks are kept (the most recently used ones if they don't fit),
+	 * the renderer is re-created and renderer and cache settings are kept.
+	 */
+	void resizeCachePools();
+
 };
 
 #endif // !_SAMPLE_CORE_H_
@@ -64,6 +64,9 @@
 #include <QDir>
 #include <QFileInfo>
 
+// STL
+#include <iostream>
+
 /******************************************************************************
  ****************************** NAMESPACE SECTION *****************************
  ******************************************************************************/
@@ -113,6 +116,8 @@ SampleCore::SampleCore()
 ,	_shapeOpacity( 0.f )
 ,	_shaderMaterialProperty( 0.f )
 ,	_textureSamplerUniformLocation( 0 )
+,	_nodeCacheMemory( NODEPOOL_MEMSIZE / ( 1024U * 1024U ) )
+,	_brickCacheMemory( BRICKPOOL_MEMSIZE / ( 1024U * 1024U ) )
 {
 	// Translation used to position the GigaVoxels data structure
 	_translation[ 0 ] = -0.5f;
@@ -176,17 +181,7 @@ void SampleCore::init()
 	}
 
 	// Pipeline creation
-	_pipeline = new PipelineType();
-	ProducerType* producer = new ProducerType();
-	ShaderType* shader = new ShaderType();
-
-	// Pipeline initialization
-	_pipeline->initialize( NODEPOOL_MEMSIZE, BRICKPOOL_MEMSIZE, producer, shader );
-
-	// Renderer initialization
-	_renderer = new RendererType( _pipeline->editDataStructure(), _pipeline->editCache() );
-	assert( _renderer != NULL );
-	_pipeline->addRenderer( _renderer );
+	createPipeline();
 
 	// Pipeline configuration
 	_maxVolTreeDepth = 5;
@@ -276,6 +271,75 @@ void SampleCore::init()
 	glBindVertexArray( 0 );
 }
 
+/******************************************************************************
+ * Create the GigaVoxels pipeline and its renderer with the current cache memory
+ ******************************************************************************/
+void SampleCore::createPipeline()
+{
+	// Pipeline creation
+	_pipeline = new PipelineType();
+	ProducerType* producer = new ProducerType();
+	ShaderType* shader = new ShaderType();
+
+	// Pipeline initialization
+	_pipeline->initialize( static_cast< size_t >( _nodeCacheMemory ) * 1024U * 1024U, static_cast< size_t >( _brickCacheMemory ) * 1024U * 1024U, producer, shader );
+
+	// Renderer initialization
+	createRenderer();
+}
+
+/******************************************************************************
+ * Create the renderer of the GigaVoxels pipeline
+ ******************************************************************************/
+void SampleCore::createRenderer()
+{
+	_renderer = new RendererType( _pipeline->editDataStructure(), _pipeline->editCache() );
+	assert( _renderer != NULL );
+	_pipeline->addRenderer( _renderer );
+}
+
+/******************************************************************************
+ * Reallocate the node and brick pools of the GigaVoxels pipeline with the current cache memory.
+ * Resident nodes and bricks are kept (the most recently used ones if they don't fit),
+ * the renderer is re-created and renderer and cache settings are kept.
+ ******************************************************************************/
+void SampleCore::resizeCachePools()
+{
+	// Store the settings of the current pipeline
+	const unsigned int maxDepth = getRendererMaxDepth();
+	const bool dynamicUpdate = hasDynamicUpdate();
+	const unsigned int maxNbNodeSubdivisions = getCacheMaxNbNodeSubdivisions();
+	const unsigned int maxNbBrickLoads = getCacheMaxNbBrickLoads();
+	const unsigned int cachePolicy = getCachePolicy();
+	const bool priorityOnBricks = _renderer->hasPriorityOnBricks();
+	const uchar4 clearColor = _renderer->getClearColor();
+	const uint4 projectedBBox = _renderer->getProjectedBBox();
+	const float timeBudget = _renderer->getTimeBudget();
+
+	// Reallocate the pools (the pipeline deletes its renderer, it keeps its producer and shader)
+	_renderer->resetGraphicsResources();
+	_renderer = NULL;
+	_pipeline->resizePools( static_cast< size_t >( _nodeCacheMemory ) * 1024U * 1024U, static_cast< size_t >( _brickCacheMemory ) * 1024U * 1024U );
+	createRenderer();
+
+	// Restore settings
+	_pipeline->editDataStructure()->setMaxDepth( maxDepth );
+	setDynamicUpdate( dynamicUpdate );
+	setCacheMaxNbNodeSubdivisions( maxNbNodeSubdivisions );
+	setCacheMaxNbBrickLoads( maxNbBrickLoads );
+	setCachePolicy( cachePolicy );
+	_renderer->setPriorityOnBricks( priorityOnBricks );
+	_renderer->setClearColor( clearColor );
+	_renderer->setProjectedBBox( projectedBBox );
+	_renderer->setTimeBudget( timeBudget );
+
+	// Connect graphics resources to the new renderer
+	resetGraphicsresources();
+
+	// LOG info
+	std::cout << "Cache memory : [ nodes = " << _nodeCacheMemory << " Mo ] [ bricks = " << _brickCacheMemory << " Mo ]" << std::endl;
+}
+
 /******************************************************************************
  * Draw function called of frame
  ******************************************************************************/
@@ -1029,7 +1093,7 @@ void SampleCore::resetGraphicsresources()
  ******************************************************************************/
 unsigned int SampleCore::getNodeCacheMemory() const
 {
-	return NODEPOOL_MEMSIZE / ( 1024U * 1024U );
+	return _nodeCacheMemory;
 }
 
 /******************************************************************************
@@ -1039,6 +1103,7 @@ unsigned int SampleCore::getNodeCacheMemory() const
  ******************************************************************************/
 void SampleCore::setNodeCacheMemory( unsigned int pValue )
 {
+	setCacheMemory( pValue, _brickCacheMemory );
 }
 
 /******************************************************************************
@@ -1048,7 +1113,7 @@ void SampleCore::setNodeCacheMemory( unsigned int pValue )
  ******************************************************************************/
 unsigned int SampleCore::getBrickCacheMemory() const
 {
-	return BRICKPOOL_MEMSIZE / ( 1024U * 1024U );
+	return _brickCacheMemory;
 }
 
 /******************************************************************************
@@ -1058,6 +1123,31 @@ unsigned int SampleCore::getBrickCacheMemory() const
  ******************************************************************************/
 void SampleCore::setBrickCacheMemory( unsigned int pValue )
 {
+	setCacheMemory( _nodeCacheMemory, pValue );
+}
+
+/******************************************************************************
+ * Set the node and brick cache memory at once (pools are reallocated only once)
+ *
+ * @param pNodeValue the node cache memory
+ * @param pBrickValue the brick cache memory
+ ******************************************************************************/
+void SampleCore::setCacheMemory( unsigned int pNodeValue, unsigned int pBrickValue )
+{
+	if ( pNodeValue == 0 || pBrickValue == 0
+		|| ( pNodeValue == _nodeCacheMemory && pBrickValue == _brickCacheMemory ) )
+	{
+		return;
+	}
+
+	_nodeCacheMemory = pNodeValue;
+	_brickCacheMemory = pBrickValue;
+
+	// Re-allocate the pools
+	if ( _pipeline != NULL )
+	{
+		resizeCachePools();
+	}
 }
 
 /******************************************************************************
@@ -1118,6 +1208,26 @@ unsigned int SampleCore::getCacheNbUnusedBricks() const
 	return _pipeline->getCache()->getBricksCacheManager()->getNbUnusedElements();
 }
 
+/******************************************************************************
+ * Tell wheter or not the nodes cache has exceeded its capacity during last frame
+ *
+ * @return a flag telling wheter or not the nodes cache has exceeded its capacity
+ ******************************************************************************/
+bool SampleCore::hasNodeCacheExceededCapacity() const
+{
+	return _pipeline->getCache()->getNodesCacheManager()->hasExceededCapacity();
+}
+
+/******************************************************************************
+ * Tell wheter or not the bricks cache has exceeded its capacity during last frame
+ *
+ * @return a flag telling wheter or not the bricks cache has exceeded its capacity
+ ******************************************************************************/
+bool SampleCore::hasBrickCacheExceededCapacity() const
+{
+	return _pipeline->getCache()->getBricksCacheManager()->hasExceededCapacity();
+}
+
 /******************************************************************************
  * Get the max number of requests of node subdivisions.
  *
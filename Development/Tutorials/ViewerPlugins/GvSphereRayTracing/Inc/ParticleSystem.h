@@ -34,6 +34,9 @@
 // Cuda
 #include <vector_types.h>
 
+// GigaVoxels
+#include <GvUtils/GvParticleSpatialIndex.h>
+
 // STL library
 #include <vector>
 
@@ -88,22 +91,24 @@ public:
 	~ParticleSystem();
 
     /**
-     * Initialise le buffer CPU contenant les positions
+     * Initialise le buffer CPU contenant les positions.
+     * Particles are generated on several threads, each one from its own seed :
+     * a new buffer is generated at each call.
      */
     void initBuf();
 
 	/**
-     * Charge le buffer GPU contenant les positions
+	 * Update the spatial index of the positions (and its GPU buffers).
+	 * Only the cells of the particles that have moved are sorted again and uploaded.
 	 */
-    void loadGPUBuf();
+	void loadGPUBuf();
 
 	/**
-	  * Get the buffer of data (sphere positions and radius)
+	 * Get the spatial index of the particles (sphere positions and radius)
 	 *
-	 * @return the buffer of data (sphere positions and radius)
+	 * @return the spatial index of the particles
 	 */
-	// Array3DGPULinear< float4 >* getGPUBuf();
-	float4* getGPUBuf();
+	const GvUtils::GvParticleSpatialIndex& getSpatialIndex() const;
 
 	/**
 	 * Get the number of particles
@@ -149,6 +154,23 @@ private :
 
 	/****************************** INNER TYPES *******************************/
 
+	/**
+	 * Particles generated by a thread
+	 */
+	struct GenerationTask
+	{
+		/**
+		 * The particle system
+		 */
+		ParticleSystem* _particleSystem;
+
+		/**
+		 * First particle and end of the particles of the task
+		 */
+		unsigned int _first;
+		unsigned int _end;
+	};
+
 	/******************************* ATTRIBUTES *******************************/
 
 	/**
@@ -167,9 +189,9 @@ private :
 	unsigned int _nbParticles;
 
 	/**
-	 * The buffer of data (sphere positions and radius)
+	 * Spatial index of the particles (sphere positions and radius, sorted in GPU memory)
 	 */
-    float4* _d_particleBuffer;
+	GvUtils::GvParticleSpatialIndex _spatialIndex;
     int _bufferSize;
 
     //std::vector<float4> _particleBuffer;
@@ -186,14 +208,50 @@ private :
 	float _sphereRadiusFader;
 	float _fixedSizeSphereRadius;
 
+	/**
+	 * Number of generated buffers (it is part of the seeds of the particles)
+	 */
+	unsigned int _nbGenerations;
+
+	/**
+	 * Number of threads used to generate particles
+	 */
+	unsigned int _nbThreads;
+
 	/******************************** METHODS *********************************/
 
 	/**
 	 * Genere une position aleatoire
 	 *
-	 * @param pSeed ...
+	 * @param pSeed seed of the particle
+	 */
+    float4 genPos( unsigned int pSeed ) const;
+
+	/**
+	 * Generate a range of particles of the buffer
+	 *
+	 * @param pFirst first particle
+	 * @param pEnd end of the particles
+	 */
+	void generateParticles( unsigned int pFirst, unsigned int pEnd );
+
+	/**
+	 * Thread entry point of a generation task
+	 *
+	 * @param pTask the task
+	 *
+	 * @return NULL
+	 */
+	static void* runGenerationTask( void* pTask );
+
+	/**
+	 * Get the next random value of a generator (linear congruential generator)
+	 *
+	 * @param pState the state of the generator
+	 *
+	 * @return a random value in [ 0 ; 1 ]
 	 */
-    float4 genPos( int pSeed );
+	static float getRandom( unsigned int& pState );
 
 };
 
@@ -49,6 +49,12 @@
  ******************************** CLASS USED **********************************
  ******************************************************************************/
 
+// GigaVoxels
+namespace GvUtils
+{
+	class GvParticleSpatialIndex;
+}
+
 // Project
 class ParticleSystem;
 
@@ -178,6 +184,13 @@ public:
 	  */
 	 void updateParticleSystem();
 
+	/**
+	 * Get the spatial index of the spheres
+	 *
+	 * @return the spatial index of the spheres
+	 */
+	const GvUtils::GvParticleSpatialIndex& getSpatialIndex() const;
+
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
 	 **************************************************************************/
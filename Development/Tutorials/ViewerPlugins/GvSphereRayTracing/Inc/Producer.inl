@@ -228,10 +228,24 @@ inline void Producer< TDataStructureType, TDataProductionManager >
     assert( _particleSystem != NULL );
     if ( _particleSystem != NULL )
     {
-        // Re-load spheres buffer
+        // Update the spatial index of the spheres
         _particleSystem->loadGPUBuf();
 
         // Update Kernel Producer info
-        this->_kernelProducer.setPositionBuffer( _particleSystem->getGPUBuf() );
+        this->_kernelProducer.setParticleIndex( _particleSystem->getSpatialIndex().getKernelObject() );
     }
 }
+
+/******************************************************************************
+ * Get the spatial index of the spheres
+ *
+ * @return the spatial index of the spheres
+ ******************************************************************************/
+template< typename TDataStructureType, typename TDataProductionManager >
+inline const GvUtils::GvParticleSpatialIndex& Producer< TDataStructureType, TDataProductionManager >
+::getSpatialIndex() const
+{
+	assert( _particleSystem != NULL );
+
+	return _particleSystem->getSpatialIndex();
+}
@@ -37,6 +37,8 @@
 
 // GigaVoxels
 #include <GvCore/GPUVoxelProducer.h>
+#include <GvUtils/GvParticleSpatialIndexKernel.h>
+#include <GvStructure/GvProductionInfoKernel.h>
 
 // CUDA
 #include <cuda_runtime.h>
@@ -59,6 +61,19 @@ __constant__ bool cMeanSizeOfSpheres;
 __constant__ unsigned int cCoeffAbsoluteSizeCriteria;
 __constant__ float cSphereRadiusFader;
 
+/**
+ * Production info of nodes and bricks
+ *
+ * The recorded value range is the range of the Morton codes of the cells of the spatial index
+ * holding the spheres that may intersect the region (see getCandidateSpheres()).
+ */
+__constant__ GvStructure::GvProductionInfoKernel cProductionInfo;
+
+/**
+ * Dependency tags of produced nodes and bricks
+ */
+#define PRODUCER_SPHERES_DEPENDENCY	0x1U
+
 /**
  * Coefficient used to approximate a brick by a sphere
  *
@@ -207,12 +222,11 @@ public:
 
 
 	/**
-	 * Set the buffer of spheres
+	 * Set the spatial index of the spheres
 	 *
-	 * @param pSpheresBuffer the buffer of spheres (position and radius)
+	 * @param pParticleIndex the spatial index of the spheres (position and radius)
 	 */
-    inline void setPositionBuffer( float4* pSpheresBuffer );
-    //inline void setPositionBuffer( std::vector<float4*> pSpheresBuffer );
+	inline void setParticleIndex( const GvUtils::GvParticleSpatialIndexKernel& pParticleIndex );
 
 
 	/**************************************************************************
@@ -234,11 +248,9 @@ private:
 	/******************************* ATTRIBUTES *******************************/
 
 	/**
-	 * ...
+	 * Spatial index of the spheres (position and radius, sorted on device)
 	 */
-	//GvCore::ArrayKernel3DLinear< float4 > _posBuf;
-    //std::vector<float4*> _posBuf;
-    float4* _posBuf;
+	GvUtils::GvParticleSpatialIndexKernel _particleIndex;
 
 	/**
 	 * Data Structure device-side associated object
@@ -257,11 +269,42 @@ private:
 	 *
 	 * @param regionCoords region coordinates
 	 * @param regionDepth region depth
+	 * @param pCells the Morton codes of the first and the last cell of the spheres the type depends on
 	 *
 	 * @return the type of the region
 	 */
 	__device__
-	inline GPUVoxelProducer::GPUVPRegionInfo getRegionInfo( uint3 regionCoords, uint regionDepth );
+	inline GPUVoxelProducer::GPUVPRegionInfo getRegionInfo( uint3 regionCoords, uint regionDepth, uint2& pCells );
+
+	/**
+	 * Retrieve the ranges of the spheres that may intersect a region.
+	 *
+	 * Spheres are replicated in each region of the min level of resolution to handle :
+	 * they are given in the frame of the region of this level containing the region.
+	 *
+	 * @param pRegionCoords region coordinates
+	 * @param pRegionDepth region depth (must not be lower than the min level of resolution to handle)
+	 * @param pOrigin origin of the frame of the spheres
+	 * @param pScale scale of the frame of the spheres
+	 * @param pRanges the ranges ( index of the first sphere, number of spheres ) of the spheres
+	 * @param pCells the Morton codes of the first and the last cell of the spheres that may intersect the region
+	 *
+	 * @return the number of ranges
+	 */
+	__device__
+	inline uint getCandidateSpheres( const uint3& pRegionCoords, uint pRegionDepth, float3& pOrigin, float& pScale, uint2 pRanges[ 8 ], uint2& pCells ) const;
+
+	/**
+	 * Get a sphere of the spatial index
+	 *
+	 * @param pIndex index of the sphere
+	 * @param pOrigin origin of the frame of the spheres
+	 * @param pScale scale of the frame of the spheres
+	 *
+	 * @return the sphere (position and radius)
+	 */
+	__device__
+	inline float4 getSphere( uint pIndex, const float3& pOrigin, float pScale ) const;
 
 	/**
 	 * Test the intersection between a sphere and a brick
@@ -114,7 +114,8 @@ inline uint ProducerKernel< TDataStructureType >
 		newnode.brickAddress = 0;
 
 		// Call what we call an oracle that will determine the type of the region of the node accordingly
-		GPUVoxelProducer::GPUVPRegionInfo nodeinfo = getRegionInfo( regionCoords, regionDepth );
+		uint2 cells;
+		GPUVoxelProducer::GPUVPRegionInfo nodeinfo = getRegionInfo( regionCoords, regionDepth, cells );
 
 		// Now that the type of the region is found, fill the new node information
 		if ( nodeinfo == GPUVoxelProducer::GPUVP_CONSTANT )
@@ -139,6 +140,11 @@ inline uint ProducerKernel< TDataStructureType >
 		// newElemAddress.x + processID : is the adress of the new node in the node pool
 		nodePool.getChannel( Loki::Int2Type< 0 >() ).set( newElemAddress.x + processID, newnode.childAddress );
 		nodePool.getChannel( Loki::Int2Type< 1 >() ).set( newElemAddress.x + processID, newnode.brickAddress );
+
+		// Record the cells of the spheres the type of the node depends on
+		// (regions above the min level of resolution to handle do not depend on spheres)
+		cProductionInfo.setNodeInfo( newElemAddress.x + processID, static_cast< float >( cells.x ), static_cast< float >( cells.y ),
+									( regionDepth < cMinLevelOfResolutionToHandle ) ? 0 : PRODUCER_SPHERES_DEPENDENCY );
 	}
 
 	return 0;
@@ -180,6 +186,12 @@ inline uint ProducerKernel< TDataStructureType >
 		// ecriture des donnees dans la cache
 		dataPool.template setValue< 0 >( newElemAddress + make_uint3( threadIdx.x, threadIdx.y, threadIdx.z ), make_float4( 0.0f, 0.0f, 0.0f, 0.0f ) );
 
+		// The brick does not depend on spheres
+		if ( threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0 )
+		{
+			cProductionInfo.setBrickInfo( newElemAddress, 0.f, 0.f, 0 );
+		}
+
 		//// Write data in the first two memory addresses
 		//if ( ( threadIdx.x == 0 ) && ( threadIdx.y == 0 ) && ( threadIdx.z == 0 ) )
 		//{
@@ -193,191 +205,81 @@ inline uint ProducerKernel< TDataStructureType >
 	// ------------------------------------------------------
 	else
 	{
-		// Pas bon comme a, car le rendu ne fera pas le ray-tracing pour les sphres
-		// Il ne faut pas faire le return 2 comme a...
-		// Il faut d'abord produire les sphres
-		//
-		//// Test geometric criteria
-		////
-		//// Node subdivision process is stopped if there is no more than a given number of spheres inside
-		//if ( ! isGeometricCriteriaValid( cNbSpheres ) )
-		//{
-		//	return 2;
-		//}
-
 		// Shared Memory declaration
 		// Permet de compter le nombre de spheres dans une brique
 		__shared__ uint sphereCounter;
+
+		// Ranges of the spheres that may intersect the brick, and frame of the spheres
+		__shared__ uint2 candidateRanges[ 8 ];
+		__shared__ uint nbCandidateRanges;
+		__shared__ float3 sphereOrigin;
+		__shared__ float sphereScale;
+
+		const GvCore::GvLocalizationInfo::CodeType parentLocCode = parentLocInfo.locCode;
+		const GvCore::GvLocalizationInfo::DepthType parentLocDepth = parentLocInfo.locDepth;
+
 		if ( threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0 )
 		{
 			sphereCounter = 0;
+			uint2 cells;
+			nbCandidateRanges = getCandidateSpheres( parentLocCode.get(), parentLocDepth.get(), sphereOrigin, sphereScale, candidateRanges, cells );
+
+			// Record the cells of the spheres the brick depends on
+			cProductionInfo.setBrickInfo( newElemAddress, static_cast< float >( cells.x ), static_cast< float >( cells.y ), PRODUCER_SPHERES_DEPENDENCY );
 		}
 		__syncthreads();
 
-		const GvCore::GvLocalizationInfo::CodeType parentLocCode = parentLocInfo.locCode;
-		const GvCore::GvLocalizationInfo::DepthType parentLocDepth = parentLocInfo.locDepth;
-
 		// Brick info
 		const float brickWidth = 1.f / static_cast< float >( 1 << parentLocDepth.get() );
 		const float3 brickPosition = make_float3( parentLocCode.get() ) * brickWidth;
 		const float3 brickCenter = brickPosition + make_float3( 0.5f * brickWidth );
-		const float brickRadius = ( 0.5f * sqrtf( 3.f ) ) * brickWidth;
-
-		//if ( parentLocDepth.get() == 0 )
-		if ( parentLocDepth.get() == cMinLevelOfResolutionToHandle )
-		{
-
-
-			/*
-			// les thread (0,0,0) et (1,0,0) ne vont pas ecrire de position dans le cache
-			// mais renseigner le nombre de spheres et la position de la brique.
-			if(!(threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0) &&
-			!(threadIdx.x == 1 && threadIdx.y == 0 && threadIdx.z == 0)
-			){
-			*/
-			// recupere un indice 1 dimension pour recuperer une position dans le buffer de positions
-			// on enleve 2 car les deux premieres thread ne vont pas lire dans le buffer de positions
-			uint indice = threadIdx.x + ( threadIdx.y * blockDim.x ) + ( threadIdx.z * blockDim.x * blockDim.y );
-
-			if ( indice < cNbSpheres )
-			{
-				// on recupere la position de la sphere
-				//const float4 sphere = _posBuf[ indice ];
-				float4 sphere = _posBuf[ indice ];
-				// Scale
-				sphere.x *= brickWidth;
-				sphere.y *= brickWidth;
-				sphere.z *= brickWidth;
-				// Bias
-				sphere.x += brickPosition.x;
-				sphere.y += brickPosition.y;
-				sphere.z += brickPosition.z;
-
-				// la sphere et la brique s'intersecent
-				if ( intersectBrick( sphere, brickCenter, brickWidth ) )
-				{
-					// on ajoute 2 car les deux premiers elements sont le nombre de spheres et la position de la brique
-					int index = atomicAdd( &sphereCounter, 1 ) + 2;
-					// on remet index sur 3 dimensions
-					uint3 index3D = make_uint3( 0, 0, 0 );
-					index3D.x = index % blockDim.x;
-					index3D.y = ( index / blockDim.x ) % blockDim.y;
-					index3D.z = index / ( blockDim.x * blockDim.y );
-
-					uint3 destinationAddress = newElemAddress + make_uint3( index3D.x, index3D.y, index3D.z );
-
-					// calcul de la position de la sphere dans un repere local a la brique
-					float4 sphereData = make_float4( sphere.x - brickPosition.x, sphere.y - brickPosition.y, sphere.z - brickPosition.z, sphere.w );
-                    sphereData.w *= cSphereRadiusFader;
-
-					// ecriture des donnees dans la cache
-					dataPool.template setValue< 0 >( destinationAddress, sphereData );
-				}
-			}
-
-			// Thread Synchronization
-			__syncthreads();
 
-			// Write data in the first two memory addresses
-			if ( ( threadIdx.x == 0 ) && ( threadIdx.y == 0 ) && ( threadIdx.z == 0 ) )
-			{
-				float4 brickDataInfo = make_float4( blockDim.x, blockDim.y, blockDim.z, sphereCounter );
-				dataPool.template setValue< 0 >( newElemAddress + make_uint3( 0, 0, 0 ), brickDataInfo );
+		// The first two elements of the brick are the number of spheres and the brick position
+		const uint nbThreads = blockDim.x * blockDim.y * blockDim.z;
+		const uint maxNbSpheres = nbThreads - 2;
 
-				float4 brickData = make_float4( brickPosition.x, brickPosition.y, brickPosition.z, brickWidth );
-				dataPool.template setValue< 0 >( newElemAddress + make_uint3( 1, 0, 0 ), brickData );
-			}
-		}
-		else
+		// Threads only test the spheres that may intersect the brick.
+		// Spheres are read from the spatial index at every level : bricks do not depend on the bricks of their parent.
+		const uint threadIndex = threadIdx.x + ( threadIdx.y * blockDim.x ) + ( threadIdx.z * blockDim.x * blockDim.y );
+		for ( uint i = 0; i < nbCandidateRanges; i++ )
 		{
-			// Shared Memory declaration
-			__shared__ GvStructure::GvNode parentNode;
-			__shared__ uint3 parentNodeBrickAdress;
-			__shared__ float4 brickDataInfo;
-			__shared__ float4 brickInfo;
-
-			// Retrieve common values from parent node
-			if ( threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0 )
-			{
-				parentNode.childAddress = 0;
-				parentNode.brickAddress = 0;
-
-				getNodeFather( _dataStructureKernel, parentNode, brickCenter, parentLocDepth.get() - 1 );
-
-				parentNodeBrickAdress = make_uint3( 0, 0, 0 );
-
-				brickDataInfo = make_float4( 0.f, 0.f, 0.f, 0.f );
-				brickInfo = make_float4( 0.f, 0.f, 0.f, 0.f );
-
-				parentNodeBrickAdress = parentNode.getBrickAddress();
-
-				// Retrieve brick resolution (nb of elements in each dimension) and number of spheres
-				brickDataInfo = _dataStructureKernel.template getSampleValueTriLinear< 0 >( make_float3( parentNodeBrickAdress.x, parentNodeBrickAdress.y, parentNodeBrickAdress.z ) * _dataStructureKernel.brickCacheResINV - _dataStructureKernel.brickCacheResINV, 0.5f * _dataStructureKernel.brickCacheResINV );
-
-				// Retrieve brick position and its size
-				brickInfo = _dataStructureKernel.template getSampleValueTriLinear< 0 >( make_float3( parentNodeBrickAdress.x, parentNodeBrickAdress.y, parentNodeBrickAdress.z ) * _dataStructureKernel.brickCacheResINV - _dataStructureKernel.brickCacheResINV, 0.5f * _dataStructureKernel.brickCacheResINV + make_float3( 1.f, 0.f, 0.f ) * _dataStructureKernel.brickCacheResINV );
-			}
-
-			// Thread Synchronization
-			__syncthreads();
-
-			// recupere un indice 1 dimension pour recuperer une position dans le buffer de positions
-			// on enleve 2 car les deux premieres thread ne vont pas lire dans le buffer de positions
-			uint parentNodeSphereIndex = threadIdx.x + ( threadIdx.y * blockDim.x ) + ( threadIdx.z * blockDim.x * blockDim.y );
-
-			if ( parentNodeSphereIndex < brickDataInfo.w/*nb particles in parent node*/ )
+			const uint2 range = candidateRanges[ i ];
+			for ( uint sphereIndex = range.x + threadIndex; sphereIndex < range.x + range.y; sphereIndex += nbThreads )
 			{
-				// Add brick data offset
-				parentNodeSphereIndex += 2;
-
-				uint3 parentNodeSpherePosition = make_uint3( 0, 0, 0 );
-				parentNodeSpherePosition.x = parentNodeSphereIndex % blockDim.x;
-				parentNodeSpherePosition.y = ( parentNodeSphereIndex / blockDim.x ) % blockDim.y;
-				parentNodeSpherePosition.z = parentNodeSphereIndex / ( blockDim.x * blockDim.y );
-
-				// on recupere la position de la sphere dans le parent
-				// Sample data structrure to retrieve sphere data (position and radius)
-				float4 sphere = _dataStructureKernel.template getSampleValueTriLinear< 0 >( make_float3( parentNodeBrickAdress.x, parentNodeBrickAdress.y, parentNodeBrickAdress.z ) * _dataStructureKernel.brickCacheResINV - _dataStructureKernel.brickCacheResINV,
-					0.5f * _dataStructureKernel.brickCacheResINV +  make_float3( parentNodeSpherePosition.x * _dataStructureKernel.brickCacheResINV.x,
-					parentNodeSpherePosition.y * _dataStructureKernel.brickCacheResINV.y,
-					parentNodeSpherePosition.z * _dataStructureKernel.brickCacheResINV.z ) );
-
-				// Need to add parent "brick position"
-				sphere += make_float4( brickInfo.x, brickInfo.y, brickInfo.z, 0.0f /*radius is not mofified !??*/ );
+				const float4 sphere = getSphere( sphereIndex, sphereOrigin, sphereScale );
 
 				// la sphere et la brique s'intersecent
 				if ( intersectBrick( sphere, brickCenter, brickWidth ) )
 				{
-					// on ajoute 2 car les deux premiers elements sont le nombre de spheres et la position de la brique
-					int sphereIndex = atomicAdd( &sphereCounter, 1 ) + 2;
-					// on remet index sur 3 dimensions
-					uint3 spherePosition = make_uint3( 0, 0, 0 );
-					spherePosition.x = sphereIndex % blockDim.x;
-					spherePosition.y = ( sphereIndex / blockDim.x ) % blockDim.y;
-					spherePosition.z = sphereIndex / ( blockDim.x * blockDim.y );
-
-					uint3 destinationAddress = newElemAddress + make_uint3( spherePosition.x, spherePosition.y, spherePosition.z );
+					const uint index = atomicAdd( &sphereCounter, 1 );
+					if ( index < maxNbSpheres )
+					{
+						// on ajoute 2 car les deux premiers elements sont le nombre de spheres et la position de la brique
+						// on remet index sur 3 dimensions
+						const uint brickIndex = index + 2;
+						const uint3 index3D = make_uint3( brickIndex % blockDim.x, ( brickIndex / blockDim.x ) % blockDim.y, brickIndex / ( blockDim.x * blockDim.y ) );
 
-					// calcul de la position de la sphere dans un repere local a la brique
-					float4 sphereData = make_float4( sphere.x - brickPosition.x, sphere.y - brickPosition.y, sphere.z - brickPosition.z, sphere.w );
+						// calcul de la position de la sphere dans un repere local a la brique
+						const float4 sphereData = make_float4( sphere.x - brickPosition.x, sphere.y - brickPosition.y, sphere.z - brickPosition.z, sphere.w );
 
-					// ecriture des donnees dans la cache
-					dataPool.template setValue< 0 >( destinationAddress, sphereData );
+						// ecriture des donnees dans la cache
+						dataPool.template setValue< 0 >( newElemAddress + index3D, sphereData );
+					}
 				}
 			}
+		}
 
-			// Thread Synchronization
-			__syncthreads();
+		// Thread Synchronization
+		__syncthreads();
 
-			// Write data in the first two memory addresses
-			if ( ( threadIdx.x == 0 ) && ( threadIdx.y == 0 ) && ( threadIdx.z == 0 ) )
-			{
-				float4 brickDataInfo = make_float4( blockDim.x, blockDim.y, blockDim.z, sphereCounter );
-				dataPool.template setValue< 0 >( newElemAddress + make_uint3( 0, 0, 0 ), brickDataInfo );
+		// Write data in the first two memory addresses
+		if ( ( threadIdx.x == 0 ) && ( threadIdx.y == 0 ) && ( threadIdx.z == 0 ) )
+		{
+			float4 brickDataInfo = make_float4( blockDim.x, blockDim.y, blockDim.z, min( sphereCounter, maxNbSpheres ) );
+			dataPool.template setValue< 0 >( newElemAddress + make_uint3( 0, 0, 0 ), brickDataInfo );
 
-				float4 brickData = make_float4( brickPosition.x, brickPosition.y, brickPosition.z, brickWidth );
-				dataPool.template setValue< 0 >( newElemAddress + make_uint3( 1, 0, 0 ), brickData );
-			}
+			float4 brickData = make_float4( brickPosition.x, brickPosition.y, brickPosition.z, brickWidth );
+			dataPool.template setValue< 0 >( newElemAddress + make_uint3( 1, 0, 0 ), brickData );
 		}
 	}
 
@@ -386,28 +288,29 @@ inline uint ProducerKernel< TDataStructureType >
 }
 
 /******************************************************************************
- * Set the buffer of spheres
+ * Set the spatial index of the spheres
  *
- * @param pSpheresBuffer the buffer of spheres (position and radius)
+ * @param pParticleIndex the spatial index of the spheres (position and radius)
  ******************************************************************************/
 template< typename TDataStructureType >
 __host__
 inline void ProducerKernel< TDataStructureType >
-::setPositionBuffer( float4* buf )
+::setParticleIndex( const GvUtils::GvParticleSpatialIndexKernel& pParticleIndex )
 {
-    _posBuf = buf;
+	_particleIndex = pParticleIndex;
 }
 
-
-
 /******************************************************************************
  * ...
  ******************************************************************************/
 template< typename TDataStructureType >
 __device__
 inline GPUVoxelProducer::GPUVPRegionInfo ProducerKernel< TDataStructureType >
-::getRegionInfo( uint3 regionCoords, uint regionDepth )
+::getRegionInfo( uint3 regionCoords, uint regionDepth, uint2& pCells )
 {
+	// The type depends on all cells, unless the spheres that may intersect the region are retrieved
+	pCells = make_uint2( 0, 0xFFFFFFFF );
+
 	// Limit the depth.
 	// Currently, 32 is the max depth of the GigaVoxels engine.
 	if ( regionDepth >= 32 )
@@ -420,7 +323,7 @@ inline GPUVoxelProducer::GPUVPRegionInfo ProducerKernel< TDataStructureType >
 		return GPUVoxelProducer::GPUVP_DATA;
 	}
 	else
-    {
+	{
 		//// Test geometric criteria
 		////
 		//// Node subdivision process is stopped if there is no more than a given number of spheres inside
@@ -434,183 +337,141 @@ inline GPUVoxelProducer::GPUVPRegionInfo ProducerKernel< TDataStructureType >
 		const float3 brickPosition = make_float3( regionCoords ) * brickWidth;
 		const float3 brickCenter = brickPosition + make_float3( 0.5f * brickWidth );
 
-		// Au niveau 0, on parcours le tableau de positions	// normalement, ici, on ne rentre jamais pour le produceNode() !!!!!!!
-		//if ( regionDepth == 0 )
-		if ( regionDepth == cMinLevelOfResolutionToHandle )
-		{
-			for ( int i = 0 ; i < cNbSpheres ; ++i )
-			{
-				//const float4 sphere = _posBuf[ i ];
-				float4 sphere = _posBuf[ i ];
-				// Scale
-				sphere.x *= brickWidth;
-				sphere.y *= brickWidth;
-				sphere.z *= brickWidth;
-				// Bias
-				sphere.x += brickPosition.x;
-				sphere.y += brickPosition.y;
-				sphere.z += brickPosition.z;
+		// Retrieve the spheres that may intersect the region from the spatial index
+		uint2 candidateRanges[ 8 ];
+		float3 sphereOrigin;
+		float sphereScale;
+		const uint nbCandidateRanges = getCandidateSpheres( regionCoords, regionDepth, sphereOrigin, sphereScale, candidateRanges, pCells );
 
-				if ( intersectBrick( sphere, brickCenter, brickWidth ) )
-				{
-                    return GPUVoxelProducer::GPUVP_DATA;
-				}
-			}
-		}
-		else
-		{ // sinon, on parcours dans le cache les spheres presentes dans la brique du noeud pere
-
-			// Shared Memory declaration
-			__shared__ GvStructure::GvNode parentNode;
-			if ( threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0 )
-			{
-				parentNode.childAddress = 0;
-				parentNode.brickAddress = 0;
-
-				getNodeFather( _dataStructureKernel, parentNode, brickCenter, regionDepth - 1 );
-			}
-			// Thread Synchronization
-			__syncthreads();
-
-			if ( ! parentNode.hasBrick() )
-			{
-				printf( "Pas de brick PARENT - REGION (%d %d %d) - parentNode %d %d\n", regionCoords.x, regionCoords.y, regionCoords.z, parentNode.childAddress, parentNode.brickAddress ); // ne devrait pas arriver !!!!!!!!!!!!!!!!
-
-				return GPUVoxelProducer::GPUVP_CONSTANT;
-			}
-
-			uint3 parentNodeBrickAdress = parentNode.getBrickAddress();
-			uint parentNodeBrickAdressEncoded = parentNode.getBrickAddressEncoded();
+		// Check criteria only if enabled (and not at the min level of resolution to handle)
+		const bool checkCriteria = ( regionDepth > cMinLevelOfResolutionToHandle ) && ( cGeometricCriteria || cAbsoluteSizeCriteria );
 
-			// brickData contient les dimension de la brique puis le nombre de spheres dans la brique
-			float4 brickDataInfo = _dataStructureKernel.template getSampleValueTriLinear< 0 >( make_float3( parentNodeBrickAdress.x, parentNodeBrickAdress.y, parentNodeBrickAdress.z ) * _dataStructureKernel.brickCacheResINV - _dataStructureKernel.brickCacheResINV, 0.5f * _dataStructureKernel.brickCacheResINV );
+		// Used to count how many spheres are in this brick
+		unsigned int nbSpheresInBrick = 0;
 
-			// recupere la position de la brick dans la brick GigaVoxel ainsi que la taille de la brick
-			float4 brickInfo = _dataStructureKernel.template getSampleValueTriLinear< 0 >( make_float3( parentNodeBrickAdress.x, parentNodeBrickAdress.y, parentNodeBrickAdress.z ) * _dataStructureKernel.brickCacheResINV - _dataStructureKernel.brickCacheResINV, 0.5f * _dataStructureKernel.brickCacheResINV + make_float3( 1.f, 0.f, 0.f ) * _dataStructureKernel.brickCacheResINV );
+		// Used to know the sphere radius maximum
+		float sphereRadiusMax = 0.0f;
 
-            /*
-            if ( threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0 )
-            {
-                printf("taille de la brick : %f\n", brickInfo.w);
-            }
-            */
-			uint nbSphere = static_cast< uint >( brickDataInfo.w );      // nombre de sheres dans la brick
-			uint dimBrickX = static_cast< uint >( brickDataInfo.x );     // dimension sur X de la brick
-			uint dimBrickY = static_cast< uint >( brickDataInfo.y );     // dimension sur Y de la brick
-			//uint dimBrickZ = static_cast< uint >( brickDataInfo.z );     // dimension sur Z de la brick
-
-			//// Test geometric criteria
-			////
-			//// Node subdivision process is stopped if there is no more than a given number of spheres inside
-			//if ( ! isGeometricCriteriaValid( nbSphere ) )
-			//{
-			//	return GPUVoxelProducer::GPUVP_DATA_MAXRES;
-			//}
-
-			// Check criteria only if enabled
-            if ( ! cGeometricCriteria && ! cAbsoluteSizeCriteria )
+		for ( uint i = 0; i < nbCandidateRanges; i++ )
+		{
+			const uint2 range = candidateRanges[ i ];
+			for ( uint sphereIndex = range.x; sphereIndex < range.x + range.y; sphereIndex++ )
 			{
-				// on parcours les positions dans le cache
-				for ( int i = 2 ; i < nbSphere + 2 ; ++i )
-				{
-					// Retrieve sphere index
-					uint3 index3D = make_uint3( 0, 0, 0 );
-					index3D.x = i % dimBrickX;
-					index3D.y = ( i / dimBrickX ) % dimBrickY;
-					index3D.z = i / ( dimBrickX * dimBrickY );
-
-					// Sample data structrure to retrieve sphere data (position and radius)
-					float4 sphere = _dataStructureKernel.template getSampleValueTriLinear< 0 >( make_float3( parentNodeBrickAdress.x, parentNodeBrickAdress.y, parentNodeBrickAdress.z ) * _dataStructureKernel.brickCacheResINV - _dataStructureKernel.brickCacheResINV,
-						0.5f * _dataStructureKernel.brickCacheResINV +  make_float3( index3D.x * _dataStructureKernel.brickCacheResINV.x,
-						index3D.y * _dataStructureKernel.brickCacheResINV.y,
-						index3D.z * _dataStructureKernel.brickCacheResINV.z ) );
-
-					// Need to add parent "brick position"
-					sphere += make_float4( brickInfo.x, brickInfo.y, brickInfo.z, 0.0f /*radius is not mofified !??*/ );
-
-                    //sphere.w *= cSphereRadiusFader;
+				const float4 sphere = getSphere( sphereIndex, sphereOrigin, sphereScale );
 
-					if ( intersectBrick( sphere, brickCenter, brickWidth ) )
-					{
-						//	printf( "- REGION (%d %d %d) - sphere %d/%d : (%f %f %f %f) - brick : (%f %f %f %f)\n", regionCoords.x, regionCoords.y, regionCoords.z, i - 1, nbSphere, sphere.x, sphere.y, sphere.z, sphere.w, brickCenter.x, brickCenter.y, brickCenter.z, brickWidth );
-                        return GPUVoxelProducer::GPUVP_DATA;
-					}
-				}
-			}
-            else
-            {
-				// Used to count how many spheres are in this brick
-				unsigned int nbSpheresInBrick = 0;
-
-                // Used to know the sphere radius maximum
-                float sphereRadiusMax = 0.0f;
-
-				// on parcours les positions dans le cache
-				for ( int i = 2 ; i < nbSphere + 2 ; ++i )
+				if ( intersectBrick( sphere, brickCenter, brickWidth ) )
 				{
-					// Retrieve sphere index
-					uint3 index3D = make_uint3( 0, 0, 0 );
-					index3D.x = i % dimBrickX;
-					index3D.y = ( i / dimBrickX ) % dimBrickY;
-					index3D.z = i / ( dimBrickX * dimBrickY );
-
-					// Sample data structrure to retrieve sphere data (position and radius)
-					float4 sphere = _dataStructureKernel.template getSampleValueTriLinear< 0 >( make_float3( parentNodeBrickAdress.x, parentNodeBrickAdress.y, parentNodeBrickAdress.z ) * _dataStructureKernel.brickCacheResINV - _dataStructureKernel.brickCacheResINV,
-						0.5f * _dataStructureKernel.brickCacheResINV +  make_float3( index3D.x * _dataStructureKernel.brickCacheResINV.x,
-						index3D.y * _dataStructureKernel.brickCacheResINV.y,
-						index3D.z * _dataStructureKernel.brickCacheResINV.z ) );
-
-					// Need to add parent "brick position"
-					sphere += make_float4( brickInfo.x, brickInfo.y, brickInfo.z, 0.0f /*radius is not mofified !??*/ );
-                   // sphere.w *= cSphereRadiusFader;
-
-                    if ( intersectBrick( sphere, brickCenter, brickWidth ) )
+					if ( ! checkCriteria )
 					{
-						//	printf( "- REGION (%d %d %d) - sphere %d/%d : (%f %f %f %f) - brick : (%f %f %f %f)\n", regionCoords.x, regionCoords.y, regionCoords.z, i - 1, nbSphere, sphere.x, sphere.y, sphere.z, sphere.w, brickCenter.x, brickCenter.y, brickCenter.z, brickWidth );
-
-						// Increment sphere counter in current brick
-						nbSpheresInBrick++;
-
-                        if( sphere.w > sphereRadiusMax)
-                        {
-                            sphereRadiusMax = sphere.w;
-                        }
+						return GPUVoxelProducer::GPUVP_DATA;
 					}
-				}
 
-				if ( nbSpheresInBrick == 0 )
-				{
-                    return GPUVoxelProducer::GPUVP_CONSTANT;
-				}
-                if( cGeometricCriteria )
-				{
-                    // Test geometric criteria
-					//
-					// Node subdivision process is stopped if there is no more than a given number of spheres inside
-					if ( ! isGeometricCriteriaValid( nbSpheresInBrick ) )
-					{
-                        return GPUVoxelProducer::GPUVP_DATA_MAXRES;
-					}
+					// Increment sphere counter in current brick
+					nbSpheresInBrick++;
 
+					sphereRadiusMax = fmaxf( sphereRadiusMax, sphere.w );
 				}
-                if( cAbsoluteSizeCriteria )
-                {
-                    if ( ! isAbsoluteSizeCriteriaValid(sphereRadiusMax, brickWidth) )
-                    {
-                        return GPUVoxelProducer::GPUVP_DATA_MAXRES;
-                    }
-                }
-
-                return GPUVoxelProducer::GPUVP_DATA;
-
 			}
+		}
 
+		if ( nbSpheresInBrick == 0 )
+		{
+			return GPUVoxelProducer::GPUVP_CONSTANT;
 		}
+		if ( cGeometricCriteria )
+		{
+			// Test geometric criteria
+			//
+			// Node subdivision process is stopped if there is no more than a given number of spheres inside
+			if ( ! isGeometricCriteriaValid( nbSpheresInBrick ) )
+			{
+				return GPUVoxelProducer::GPUVP_DATA_MAXRES;
+			}
+		}
+		if ( cAbsoluteSizeCriteria )
+		{
+			if ( ! isAbsoluteSizeCriteriaValid( sphereRadiusMax, brickWidth ) )
+			{
+				return GPUVoxelProducer::GPUVP_DATA_MAXRES;
+			}
+		}
+
+		return GPUVoxelProducer::GPUVP_DATA;
 	}
 
     return GPUVoxelProducer::GPUVP_CONSTANT;
 }
 
+/******************************************************************************
+ * Retrieve the ranges of the spheres that may intersect a region.
+ *
+ * Spheres are replicated in each region of the min level of resolution to handle :
+ * they are given in the frame of the region of this level containing the region.
+ *
+ * @param pRegionCoords region coordinates
+ * @param pRegionDepth region depth (must not be lower than the min level of resolution to handle)
+ * @param pOrigin origin of the frame of the spheres
+ * @param pScale scale of the frame of the spheres
+ * @param pRanges the ranges ( index of the first sphere, number of spheres ) of the spheres
+ * @param pCells the Morton codes of the first and the last cell of the spheres that may intersect the region
+ *
+ * @return the number of ranges
+ ******************************************************************************/
+template< typename TDataStructureType >
+__device__
+inline uint ProducerKernel< TDataStructureType >
+::getCandidateSpheres( const uint3& pRegionCoords, uint pRegionDepth, float3& pOrigin, float& pScale, uint2 pRanges[ 8 ], uint2& pCells ) const
+{
+	// Frame of the spheres
+	const uint levelOffset = pRegionDepth - cMinLevelOfResolutionToHandle;
+	const uint3 frameCoords = make_uint3( pRegionCoords.x >> levelOffset, pRegionCoords.y >> levelOffset, pRegionCoords.z >> levelOffset );
+	pScale = 1.f / static_cast< float >( 1 << cMinLevelOfResolutionToHandle );
+	pOrigin = make_float3( frameCoords ) * pScale;
+
+	// Region in the frame of the spheres, enlarged by the radius of the sphere approximating it (see intersectBrick())
+	// and by the max radius of the spheres
+	const uint3 regionCoords = make_uint3( pRegionCoords.x - ( frameCoords.x << levelOffset ), pRegionCoords.y - ( frameCoords.y << levelOffset ), pRegionCoords.z - ( frameCoords.z << levelOffset ) );
+	const float regionWidth = 1.f / static_cast< float >( 1 << levelOffset );
+	const float3 regionCenter = ( make_float3( regionCoords ) + make_float3( 0.5f ) ) * regionWidth;
+	const float extent = regionWidth * cBrickWidth2SphereRadius + _particleIndex._maxRadius * cSphereRadiusFader / pScale;
+	const float3 boxMin = regionCenter - make_float3( extent );
+	const float3 boxMax = regionCenter + make_float3( extent );
+
+	pCells = _particleIndex.getCellRange( boxMin, boxMax );
+
+	return _particleIndex.getCandidateRanges( boxMin, boxMax, pRanges );
+}
+
+/******************************************************************************
+ * Get a sphere of the spatial index
+ *
+ * @param pIndex index of the sphere
+ * @param pOrigin origin of the frame of the spheres
+ * @param pScale scale of the frame of the spheres
+ *
+ * @return the sphere (position and radius)
+ ******************************************************************************/
+template< typename TDataStructureType >
+__device__
+inline float4 ProducerKernel< TDataStructureType >
+::getSphere( uint pIndex, const float3& pOrigin, float pScale ) const
+{
+	float4 sphere = _particleIndex._particles[ pIndex ];
+
+	// Scale
+	sphere.x *= pScale;
+	sphere.y *= pScale;
+	sphere.z *= pScale;
+	// Bias
+	sphere.x += pOrigin.x;
+	sphere.y += pOrigin.y;
+	sphere.z += pOrigin.z;
+	// Radius
+	sphere.w *= cSphereRadiusFader;
+
+	return sphere;
+}
+
 /******************************************************************************
  * Test the intersection between a sphere and a brick
  *
@@ -32,9 +32,14 @@
 
 // STL
 #include <iostream>
+#include <algorithm>
 
 // System
 #include <cstdlib>
+#ifndef WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 // Cuda
 #include <cuda_runtime.h>
@@ -51,6 +56,11 @@
  ************************* DEFINE AND CONSTANT SECTION ************************
  ******************************************************************************/
 
+/**
+ * Min number of particles generated by a thread
+ */
+static const unsigned int cMinNbParticlesPerThread = 4096;
+
 /******************************************************************************
  ***************************** TYPE DEFINITION ********************************
  ******************************************************************************/
@@ -59,6 +69,29 @@
  ***************************** METHOD DEFINITION ******************************
  ******************************************************************************/
 
+namespace
+{
+
+/******************************************************************************
+ * Hash an integer, so that close seeds give uncorrelated generators
+ *
+ * @param pValue the value
+ *
+ * @return the hashed value
+ ******************************************************************************/
+inline unsigned int hash( unsigned int pValue )
+{
+	pValue = ( pValue ^ 61 ) ^ ( pValue >> 16 );
+	pValue *= 9;
+	pValue = pValue ^ ( pValue >> 4 );
+	pValue *= 0x27d4eb2d;
+	pValue = pValue ^ ( pValue >> 15 );
+
+	return pValue;
+}
+
+}
+
 /******************************************************************************
  * Constructor
  ******************************************************************************/
@@ -66,10 +99,18 @@ ParticleSystem::ParticleSystem( const float3& pPoint1, const float3& pPoint2 )
 :	_p1( pPoint1 )
 ,	_p2( pPoint2 )
 ,	_nbParticles( 998 )
-,	_d_particleBuffer( NULL )
+,	_spatialIndex()
+,	_offset( 0 )
 ,	_sphereRadiusFader( 1.f )
 ,	_fixedSizeSphereRadius( 0.f )
+,	_nbGenerations( 0 )
+,	_nbThreads( 1 )
 {
+#ifndef WIN32
+	const long nbProcessors = sysconf( _SC_NPROCESSORS_ONLN );
+	_nbThreads = ( nbProcessors > 0 ) ? static_cast< unsigned int >( nbProcessors ) : 1;
+#endif
+
     _particleBuffer = new float4[_nbParticles];
     initBuf();
 }
@@ -122,67 +163,138 @@ void ParticleSystem::initGPUBuf()
 }
 */
 
+/******************************************************************************
+ * Initialise le buffer CPU contenant les positions.
+ * Particles are generated on several threads, each one from its own seed :
+ * a new buffer is generated at each call.
+ ******************************************************************************/
 void ParticleSystem::initBuf()
 {
+	// Split particles between threads
+	const unsigned int nbTasks = std::max( 1U, std::min( _nbThreads, _nbParticles / cMinNbParticlesPerThread ) );
+	std::vector< GenerationTask > tasks( nbTasks );
+	for ( unsigned int i = 0; i < nbTasks; i++ )
+	{
+		tasks[ i ]._particleSystem = this;
+		tasks[ i ]._first = static_cast< unsigned int >( static_cast< unsigned long long >( _nbParticles ) * i / nbTasks );
+		tasks[ i ]._end = static_cast< unsigned int >( static_cast< unsigned long long >( _nbParticles ) * ( i + 1 ) / nbTasks );
+	}
 
-    for ( unsigned int i = 0; i < _nbParticles; ++i )
-    {
-        // Position (generee aleatoirement)
-        float4 sphere = genPos( rand() );
-        _particleBuffer[i] = sphere;
-    }
+#ifndef WIN32
+	std::vector< pthread_t > threads( nbTasks );
+	std::vector< bool > isThreadCreated( nbTasks, false );
+	for ( unsigned int i = 1; i < nbTasks; i++ )
+	{
+		isThreadCreated[ i ] = ( pthread_create( &threads[ i ], NULL, runGenerationTask, &tasks[ i ] ) == 0 );
+		if ( ! isThreadCreated[ i ] )
+		{
+			runGenerationTask( &tasks[ i ] );
+		}
+	}
 
-    // TO DO
-    // Delete the temporary buffer : part_buf
-    // ...
+	// The first task is run by the calling thread
+	runGenerationTask( &tasks[ 0 ] );
+
+	for ( unsigned int i = 1; i < nbTasks; i++ )
+	{
+		if ( isThreadCreated[ i ] )
+		{
+			pthread_join( threads[ i ], NULL );
+		}
+	}
+#else
+	for ( unsigned int i = 0; i < nbTasks; i++ )
+	{
+		runGenerationTask( &tasks[ i ] );
+	}
+#endif
+
+	_nbGenerations++;
 }
 
-void ParticleSystem::loadGPUBuf(){
+/******************************************************************************
+ * Generate a range of particles of the buffer
+ *
+ * @param pFirst first particle
+ * @param pEnd end of the particles
+ ******************************************************************************/
+void ParticleSystem::generateParticles( unsigned int pFirst, unsigned int pEnd )
+{
+	for ( unsigned int i = pFirst; i < pEnd; i++ )
+	{
+		// Position (generee aleatoirement)
+		_particleBuffer[ i ] = genPos( hash( _nbGenerations * _nbParticles + i ) );
+	}
+}
 
-    if ( _d_particleBuffer != NULL )
-    {
-        GV_CUDA_SAFE_CALL( cudaFree( _d_particleBuffer ) );
-        _d_particleBuffer = NULL;
-    }
-    size_t size = _offset * sizeof( float4 );
+/******************************************************************************
+ * Thread entry point of a generation task
+ *
+ * @param pTask the task
+ *
+ * @return NULL
+ ******************************************************************************/
+void* ParticleSystem::runGenerationTask( void* pTask )
+{
+	const GenerationTask* task = static_cast< const GenerationTask* >( pTask );
+	task->_particleSystem->generateParticles( task->_first, task->_end );
 
-    //_d_particleBuffer = new GvCore::Array3DGPULinear( make_int3( _nbParticles, 1, 1 ), 0 );
-    if ( cudaSuccess != cudaMalloc( &_d_particleBuffer, size ) )
-    {
-        return;
-    }
+	return NULL;
+}
 
-    GV_CUDA_SAFE_CALL( cudaMemcpy( _d_particleBuffer, _particleBuffer, size, cudaMemcpyHostToDevice ) );
+/******************************************************************************
+ * Get the next random value of a generator (linear congruential generator)
+ *
+ * @param pState the state of the generator
+ *
+ * @return a random value in [ 0 ; 1 ]
+ ******************************************************************************/
+float ParticleSystem::getRandom( unsigned int& pState )
+{
+	pState = 1664525U * pState + 1013904223U;
+
+	// The high bits of the state are the most random ones
+	return static_cast< float >( pState >> 8 ) / static_cast< float >( 0xFFFFFF );
+}
 
+/******************************************************************************
+ * Update the spatial index of the positions (and its GPU buffers).
+ * Only the cells of the particles that have moved are sorted again and uploaded.
+ ******************************************************************************/
+void ParticleSystem::loadGPUBuf()
+{
+	const unsigned int nbParticles = std::min( static_cast< unsigned int >( std::max( _offset, 0 ) ), _nbParticles );
 
+	// The index is built again when the number of particles has changed
+	_spatialIndex.update( _particleBuffer, nbParticles );
 }
 
 /******************************************************************************
- * Get the buffer of data (sphere positions and radius)
+ * Get the spatial index of the particles (sphere positions and radius)
  *
- * @return the buffer of data (sphere positions and radius)
+ * @return the spatial index of the particles
  ******************************************************************************/
-float4* ParticleSystem::getGPUBuf()
+const GvUtils::GvParticleSpatialIndex& ParticleSystem::getSpatialIndex() const
 {
-	return _d_particleBuffer;
+	return _spatialIndex;
 }
 
 /******************************************************************************
  * Genere une position aleatoire
  *
- * @param pSeed ...
+ * @param pSeed seed of the particle
  ******************************************************************************/
-float4 ParticleSystem::genPos( int pSeed )
+float4 ParticleSystem::genPos( unsigned int pSeed ) const
 {
     float4 p;
 
-	srand( pSeed );
+	unsigned int state = pSeed;
 
 	float min;	// min de l'interval des valeurs sur l'axe
 	float max;	// max de l'interval des valeurs sur l'axe
 
     // Radius
-    p.w = .005f + static_cast< float >( rand() ) / ( static_cast< float >( RAND_MAX ) / ( 0.02f - 0.005f ) );	// rayon de l'etoile dans [0.005 : 0.02]
+    p.w = .005f + getRandom( state ) * ( 0.02f - 0.005f );	// rayon de l'etoile dans [0.005 : 0.02]
     // Global size gain
     p.w *= _sphereRadiusFader;
 
@@ -197,7 +309,7 @@ float4 ParticleSystem::genPos( int pSeed )
 		min = _p2.x;
 		max = _p1.x;
 	}
-    p.x = (min+p.w+p.w) + (float)rand() / ((float)RAND_MAX / ((max-p.w-p.w)-(min+p.w+p.w)));
+    p.x = (min+p.w+p.w) + getRandom( state ) * ((max-p.w-p.w)-(min+p.w+p.w));
 
     // genere la coordonnee en Y
 	if ( _p1.y < _p2.y )
@@ -210,7 +322,7 @@ float4 ParticleSystem::genPos( int pSeed )
 		min = _p2.y;
 		max = _p1.y;
 	}
-    p.y = (min+p.w+p.w) + (float)rand() / ((float)RAND_MAX / ((max-p.w-p.w)-(min+p.w+p.w)));
+    p.y = (min+p.w+p.w) + getRandom( state ) * ((max-p.w-p.w)-(min+p.w+p.w));
 
     // genere la coordonnee en Z
 	if ( _p1.z < _p2.z )
@@ -223,7 +335,7 @@ float4 ParticleSystem::genPos( int pSeed )
 		min = _p2.z;
 		max = _p1.z;
 	}
-    p.z = (min+p.w+p.w) + (float)rand() / ((float)RAND_MAX / ((max-p.w-p.w)-(min+p.w+p.w)));
+    p.z = (min+p.w+p.w) + getRandom( state ) * ((max-p.w-p.w)-(min+p.w+p.w));
 
 	return p;
 }
@@ -54,6 +54,7 @@
 #include <cstdlib>
 #include <ctime>
 #include <cassert>
+#include <cfloat>
 
 /******************************************************************************
  ****************************** NAMESPACE SECTION *****************************
@@ -181,6 +182,12 @@ void SampleCore::init()
 
 	// Pipeline configuration
 	_pipeline->editDataStructure()->setMaxDepth( _maxVolTreeDepth );
+
+	// Record the production info of nodes and bricks, so that regenerating spheres
+	// only produces again the data that depends on the cells of the regenerated spheres
+	_pipeline->editCache()->useProductionInfo( true );
+	const GvStructure::GvProductionInfoKernel productionInfo = _pipeline->editCache()->getProductionInfoKernelObject();
+	GV_CUDA_SAFE_CALL( cudaMemcpyToSymbol( cProductionInfo, &productionInfo, sizeof( productionInfo ), 0, cudaMemcpyHostToDevice ) );
 	
 	// Custom initialization
 	// Note : this could be done via an XML settings file loaded at initialization
@@ -948,10 +955,25 @@ void SampleCore::setNbSpheresTotal( unsigned int pValue )
  ******************************************************************************/
 void SampleCore::regeneratePositions()
 {
-    _pipeline->editProducer()->generateNewParticleBuffer();
-    
-	// Clear the cache
-    clearCache();
+	// Regions are enlarged by the max radius of the spheres they have been produced with
+	const GvUtils::GvParticleSpatialIndex& spatialIndex = _pipeline->getProducer()->getSpatialIndex();
+	const float previousMaxRadius = spatialIndex.getMaxRadius();
+
+	// Generate the spheres and update their spatial index (only the changed cells are sorted and uploaded)
+	_pipeline->editProducer()->generateNewParticleBuffer();
+
+	// Invalidate the data produced from the cells of the regenerated spheres.
+	// When the max radius grows, spheres may reach regions that have not retrieved their cell : all data depending on spheres is invalidated.
+	unsigned int firstCell = 0;
+	unsigned int lastCell = 0;
+	if ( spatialIndex.getMaxRadius() > previousMaxRadius )
+	{
+		_pipeline->editCache()->invalidateDependentData( -FLT_MAX, FLT_MAX, PRODUCER_SPHERES_DEPENDENCY );
+	}
+	else if ( spatialIndex.getChangedCells( firstCell, lastCell ) )
+	{
+		_pipeline->editCache()->invalidateDependentData( static_cast< float >( firstCell ), static_cast< float >( lastCell ), PRODUCER_SPHERES_DEPENDENCY );
+	}
 }
 
 /******************************************************************************
@@ -1179,8 +1201,7 @@ void SampleCore::setScreenBasedCriteria( bool pFlag )
 	// Update DEVICE memory with "voxel scale"
 	GV_CUDA_SAFE_CALL( cudaMemcpyToSymbol( cScreenBasedCriteria, &_screenBasedCriteria, sizeof( _screenBasedCriteria ), 0, cudaMemcpyHostToDevice ) );
 
-	// Clear the cache
-	clearCache();
+	// The cache is kept : the parameter is only used by the shader
 }
 
 /******************************************************************************
@@ -1275,8 +1296,7 @@ void SampleCore::setScreenSpaceCoeff( unsigned int pValue )
     // Update DEVICE memory with "voxel scale"
     GV_CUDA_SAFE_CALL( cudaMemcpyToSymbol( cScreenSpaceCoeff, &_screenSpaceCoeff, sizeof( _screenSpaceCoeff ), 0, cudaMemcpyHostToDevice ) );
 
-    // Clear the cache
-    clearCache();
+    // The cache is kept : the parameter is only used by the shader
 }
 
 /******************************************************************************
@@ -1330,8 +1350,7 @@ void SampleCore::setShaderUniformColorMode( bool pFlag )
 	// Update DEVICE memory with "voxel scale"
 	GV_CUDA_SAFE_CALL( cudaMemcpyToSymbol( cShaderUseUniformColor, &_shaderUseUniformColor, sizeof( _shaderUseUniformColor ), 0, cudaMemcpyHostToDevice ) );
 
-	// Clear the cache
-	clearCache();
+	// The cache is kept : the parameter is only used by the shader
 }
 
 /******************************************************************************
@@ -80,6 +80,7 @@
 		_vboCacheManager->_dataStructure = this->_dataStructure;
 
 		_vboVolumeTreeCacheKernel._updateBufferArray = this->_dataProductionManagerKernel._updateBufferArray;
+		_vboVolumeTreeCacheKernel._hasRequestPriorities = false;	// requests are not handled by priority
 		_vboVolumeTreeCacheKernel._nodeCacheManager = this->_dataProductionManagerKernel._nodeCacheManager;
 		_vboVolumeTreeCacheKernel._brickCacheManager = this->_dataProductionManagerKernel._brickCacheManager;
 		_vboVolumeTreeCacheKernel._vboCacheManager = this->_vboCacheManager->getKernelObject();